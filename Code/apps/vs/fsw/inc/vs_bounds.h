@@ -0,0 +1,223 @@
+#ifndef _VS_BOUNDS_H_
+#define _VS_BOUNDS_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This file defines a bounds-checking kernel the VS validation
+ * functions can share.  For four table entries at a time, it picks
+ * each entry's range from its parm ID's class, animal or direction,
+ * and checks that both of the entry's bounds lie in that range and are
+ * in order, all in a handful of 4-wide uint32 vector operations.  It
+ * uses SSE2 on x86 hosts, NEON on 64-bit ARM hosts, and plain C
+ * elsewhere or when built with VS_BOUNDS_SCALAR defined.
+ *
+ * The kernel says nothing about whether an entry's parm ID is valid.
+ * An entry with an invalid parm ID gets the animal range if it has
+ * any animal bit set or, with wide parm IDs, if it is above the named
+ * parms but below the wide directions.
+ */
+
+#include <string.h>
+
+#include "vs_tablestruct.h"
+
+/* The vector kernels load entries whole and find each parm ID in the
+ * low byte of its entry's first word, so they need the 12-byte,
+ * little-endian layout.
+ */
+#if !defined(VS_BOUNDS_SCALAR) && defined(__SSE2__)
+#include <emmintrin.h>
+#define VS_BOUNDS_SSE2
+#elif !defined(VS_BOUNDS_SCALAR) && defined(__ARM_NEON) && \
+	defined(__aarch64__) && !defined(__ARM_BIG_ENDIAN)
+#include <arm_neon.h>
+#define VS_BOUNDS_NEON
+#endif
+
+#if defined(VS_BOUNDS_SSE2) || defined(VS_BOUNDS_NEON)
+typedef char VS_bounds_entry_size_check[
+	(sizeof(vs_entry_t) == 12) ? 1 : -1];
+#endif
+
+/* An entry gets the animal range if its parm ID masked with
+ * VS_BOUNDS_CLASS_MASK is nonzero and below VS_BOUNDS_CLASS_LIMIT.
+ */
+#ifdef VS_PARM_WIDE_MIN
+#define VS_BOUNDS_CLASS_MASK  (VS_PARM_ANIMALS | \
+	(((1u << VS_PARM_ID_BITS) - 1) & ~(VS_PARM_WIDE_MIN - 1)))
+#define VS_BOUNDS_CLASS_LIMIT VS_PARM_WIDE_DIRECTION_MIN
+#else
+#define VS_BOUNDS_CLASS_MASK  VS_PARM_ANIMALS
+#endif
+
+
+/* VS_bounds_mask4()
+ *
+ * in:     p_entries - four consecutive table entries
+ * out:    nothing
+ * return: a mask with bit i set if entry i's bounds are valid for its
+ *         parm ID's class: min <= low <= high <= max.
+ *
+ * The vector kernels read the four entries as 48 bytes from
+ * p_entries, so all four must exist.
+ */
+
+static inline uint32
+VS_bounds_mask4(const vs_entry_t *p_entries) {
+
+#if defined(VS_BOUNDS_SSE2)
+	/* Load the four 12-byte entries as three vectors of words and
+	 * deinterleave them into vectors of headers, whose low bytes
+	 * are the parm IDs, low bounds, and high bounds.
+	 */
+	const __m128 a = _mm_castsi128_ps(_mm_loadu_si128(
+		(const __m128i *)p_entries));
+	const __m128 b = _mm_castsi128_ps(_mm_loadu_si128(
+		(const __m128i *)p_entries + 1));
+	const __m128 c = _mm_castsi128_ps(_mm_loadu_si128(
+		(const __m128i *)p_entries + 2));
+	const __m128i hdr = _mm_castps_si128(_mm_shuffle_ps(
+		_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0)),
+		_mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)),
+		_MM_SHUFFLE(2, 0, 2, 0)));
+	const __m128i low = _mm_castps_si128(_mm_shuffle_ps(
+		_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+		_mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+		_MM_SHUFFLE(2, 0, 2, 0)));
+	const __m128i high = _mm_castps_si128(_mm_shuffle_ps(
+		_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+		_mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)),
+		_MM_SHUFFLE(2, 0, 2, 0)));
+
+	/* SSE2 compares only signed 32-bit values; flipping the top bit
+	 * makes signed order match unsigned order.
+	 */
+	const __m128i bias = _mm_set1_epi32((int)0x80000000);
+	const __m128i vl = _mm_xor_si128(low, bias);
+	const __m128i vh = _mm_xor_si128(high, bias);
+	const __m128i class = _mm_and_si128(hdr,
+		_mm_set1_epi32(VS_BOUNDS_CLASS_MASK));
+#ifdef VS_BOUNDS_CLASS_LIMIT
+	const __m128i dir = _mm_or_si128(
+		_mm_cmpeq_epi32(class, _mm_setzero_si128()),
+		_mm_cmpgt_epi32(class,
+			_mm_set1_epi32(VS_BOUNDS_CLASS_LIMIT - 1)));
+#else
+	const __m128i dir = _mm_cmpeq_epi32(class, _mm_setzero_si128());
+#endif
+	const __m128i min = _mm_or_si128(
+		_mm_and_si128(dir, _mm_set1_epi32((int)
+			(VS_PARM_DIRECTION_MIN ^ 0x80000000))),
+		_mm_andnot_si128(dir, _mm_set1_epi32((int)
+			(VS_PARM_ANIMAL_MIN ^ 0x80000000))));
+	const __m128i max = _mm_or_si128(
+		_mm_and_si128(dir, _mm_set1_epi32((int)
+			(VS_PARM_DIRECTION_MAX ^ 0x80000000))),
+		_mm_andnot_si128(dir, _mm_set1_epi32((int)
+			(VS_PARM_ANIMAL_MAX ^ 0x80000000))));
+	const __m128i bad = _mm_or_si128(_mm_or_si128(
+		_mm_cmpgt_epi32(min, vl), _mm_cmpgt_epi32(vl, vh)),
+		_mm_cmpgt_epi32(vh, max));
+
+	return (uint32)(~_mm_movemask_ps(_mm_castsi128_ps(bad)) & 0xF);
+
+#elif defined(VS_BOUNDS_NEON)
+	/* vld3q deinterleaves the four 12-byte entries into vectors of
+	 * headers, whose low bytes are the parm IDs, low bounds, and
+	 * high bounds.
+	 */
+	static const uint32 bits[4] = { 1, 2, 4, 8 };
+	const uint32x4x3_t w = vld3q_u32((const uint32 *)p_entries);
+	const uint32x4_t class = vandq_u32(w.val[0],
+		vdupq_n_u32(VS_BOUNDS_CLASS_MASK));
+#ifdef VS_BOUNDS_CLASS_LIMIT
+	const uint32x4_t dir = vorrq_u32(vceqq_u32(class, vdupq_n_u32(0)),
+		vcgeq_u32(class, vdupq_n_u32(VS_BOUNDS_CLASS_LIMIT)));
+#else
+	const uint32x4_t dir = vceqq_u32(class, vdupq_n_u32(0));
+#endif
+	const uint32x4_t min = vbslq_u32(dir,
+		vdupq_n_u32(VS_PARM_DIRECTION_MIN),
+		vdupq_n_u32(VS_PARM_ANIMAL_MIN));
+	const uint32x4_t max = vbslq_u32(dir,
+		vdupq_n_u32(VS_PARM_DIRECTION_MAX),
+		vdupq_n_u32(VS_PARM_ANIMAL_MAX));
+	const uint32x4_t ok = vandq_u32(vandq_u32(
+		vcleq_u32(min, w.val[1]), vcleq_u32(w.val[1], w.val[2])),
+		vcleq_u32(w.val[2], max));
+
+	return vaddvq_u32(vandq_u32(ok, vld1q_u32(bits)));
+
+#else
+	uint32 mask = 0;
+	uint32 class, min, max, low, high;
+	unsigned int i;
+
+	for (i = 0; i < 4; i++) {
+		class = p_entries[i].parm_id & VS_BOUNDS_CLASS_MASK;
+		low   = p_entries[i].bound_low;
+		high  = p_entries[i].bound_high;
+#ifdef VS_BOUNDS_CLASS_LIMIT
+		if (class && (class < VS_BOUNDS_CLASS_LIMIT)) {
+#else
+		if (class) {
+#endif
+			min = VS_PARM_ANIMAL_MIN;
+			max = VS_PARM_ANIMAL_MAX;
+		} else {
+			min = VS_PARM_DIRECTION_MIN;
+			max = VS_PARM_DIRECTION_MAX;
+		}
+		mask |= (uint32)((min <= low) & (low <= high) &
+			(high <= max)) << i;
+	}
+	return mask;
+#endif
+
+} /* VS_bounds_mask4() */
+
+
+/* VS_bounds_mask()
+ *
+ * in:     p_entries   - table entries to check
+ *         num_entries - number of entries, at most 32
+ * out:    nothing
+ * return: a mask with bit i set if entry i's bounds are valid for its
+ *         parm ID's class, as for VS_bounds_mask4().
+ */
+
+static inline uint32
+VS_bounds_mask(const vs_entry_t *p_entries, unsigned int num_entries) {
+
+	vs_entry_t tail[4];  /* last few entries, padded to four */
+	uint32 mask = 0;
+	unsigned int i;
+
+	for (i = 0; (i + 4) <= num_entries; i += 4)
+		mask |= VS_bounds_mask4(&(p_entries[i])) << i;
+	if (i < num_entries) {
+		memset(tail, 0, sizeof(tail));
+		memcpy(tail, &(p_entries[i]),
+			(num_entries - i) * sizeof(vs_entry_t));
+		mask |= (VS_bounds_mask4(tail) &
+			((1u << (num_entries - i)) - 1)) << i;
+	}
+	return mask;
+
+} /* VS_bounds_mask() */
+
+
+#endif
@@ -0,0 +1,308 @@
+#ifndef _VS_CACHE_H_
+#define _VS_CACHE_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This file defines a small cache of validation results the VS
+ * validation functions can share.  Each of its VS_CACHE_NUM_SLOTS
+ * slots holds a table image, the result its validation returned, and
+ * what that validation sent: its events in order and, for apps built
+ * to report errors in telemetry, its validation report.  Given the
+ * same image again, a validation function can send the same output
+ * and return the same result without validating.
+ *
+ * Slots are found by a hash of the image, but a hit also demands that
+ * the whole image match, so two images that hash alike can't share a
+ * result.  A full cache reuses its least recently used slot.  A
+ * validation that sends more than VS_CACHE_MAX_EVENTS events isn't
+ * cached at all, so the cache stays bounded without ever replaying
+ * part of a validation's output.
+ *
+ * To use it: call VS_cache_lookup() on each image.  On a hit, send
+ * the slot's report, if it has one, and pass the slot to
+ * VS_cache_replay().  On a miss, call VS_cache_begin(), validate the
+ * image, passing each event and report it sends to
+ * VS_cache_record_event() and VS_cache_record_report(), and finish
+ * with VS_cache_end().  Recording calls made when no
+ * validation has begun do nothing, so event paths shared with other
+ * work needn't tell the difference.
+ */
+
+#include <string.h>
+
+#include "cfe.h"
+
+#include "vs_tablestruct.h"
+#include "vs_msgstruct.h"
+
+#ifndef VS_CACHE_NUM_SLOTS
+#define VS_CACHE_NUM_SLOTS  4
+#endif
+#ifndef VS_CACHE_MAX_EVENTS
+#define VS_CACHE_MAX_EVENTS 24    /* enough for most invalid images */
+#endif
+
+typedef struct {
+	uint16 eid;
+	uint16 type;
+	char   text[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH];
+} vs_cache_event_t;
+
+typedef struct {
+	uint32                  stamp;       /* last use, 0 if empty */
+	uint32                  hash;        /* VS_cache_hash() of image */
+	CFE_Status_t            result;      /* validation's return value */
+	uint16                  num_events;  /* events in use in events[] */
+	bool                    has_report;  /* report holds a report? */
+	vs_table_t              image;
+	VS_tlm_report_payload_t report;
+	vs_cache_event_t        events[VS_CACHE_MAX_EVENTS];
+} vs_cache_slot_t;
+
+typedef struct {
+	uint32           clock;        /* stamps slots as they're used */
+	uint32           hash;         /* hash of image last looked up */
+	vs_cache_slot_t *p_recording;  /* slot being recorded, or NULL */
+	bool             overflow;     /* too much output to record? */
+	uint32           hits;
+	uint32           misses;
+	vs_cache_slot_t  slots[VS_CACHE_NUM_SLOTS];
+} vs_cache_t;
+
+
+/* VS_cache_hash()
+ *
+ * in:     p_image - table image to hash
+ * out:    nothing
+ * return: a 32-bit hash of *p_image.
+ *
+ * A Fletcher-style checksum of the image's 32-bit words, run in
+ * VS_CACHE_HASH_LANES independent lanes of adds that compilers can
+ * turn into vector adds, then mixed down to one word.  Any change to
+ * a single word changes the hash.  The hash need only be good enough
+ * to make false matches rare, since a match must also compare the
+ * whole image.  The table is a whole number of 32-bit words, since
+ * every entry is.
+ */
+
+#define VS_CACHE_HASH_LANES 4
+
+static inline uint32
+VS_cache_hash(const vs_table_t *p_image) {
+
+	const uint8 *p_bytes = (const uint8 *)p_image;
+	uint32 words[VS_CACHE_HASH_LANES];  /* next words of image */
+	uint32 sum[VS_CACHE_HASH_LANES] = { 0 };     /* sums of words */
+	uint32 sum2[VS_CACHE_HASH_LANES] = { 0 };    /* sums of sums */
+	uint32 hash = 0x811C9DC5;
+	size_t i;
+	unsigned int k;
+
+	for (i = 0; (i + sizeof(words)) <= sizeof(*p_image);
+		i += sizeof(words)) {
+		memcpy(words, p_bytes + i, sizeof(words));
+		for (k = 0; k < VS_CACHE_HASH_LANES; k++) {
+			sum[k]  += words[k];
+			sum2[k] += sum[k];
+		}
+	}
+	for (k = 0; i < sizeof(*p_image); i += sizeof(words[0]), k++) {
+		memcpy(&(words[k]), p_bytes + i, sizeof(words[0]));
+		sum[k]  += words[k];
+		sum2[k] += sum[k];
+	}
+
+	for (k = 0; k < VS_CACHE_HASH_LANES; k++) {
+		hash = (hash ^ sum[k]) * 0x9E3779B1;
+		hash = (hash ^ sum2[k]) * 0x85EBCA6B;
+	}
+	return hash ^ (hash >> 15);
+
+} /* VS_cache_hash() */
+
+
+/* VS_cache_lookup()
+ *
+ * in:     p_cache - cache to search
+ *         p_image - table image about to be validated
+ * out:    p_cache - hit slot marked most recently used
+ * return: the slot holding *p_image's result, or NULL if none does.
+ */
+
+static inline const vs_cache_slot_t *
+VS_cache_lookup(vs_cache_t *p_cache, const vs_table_t *p_image) {
+
+	vs_cache_slot_t *p_slot;
+	unsigned int i;
+
+	p_cache->hash = VS_cache_hash(p_image);
+	for (i = 0; i < VS_CACHE_NUM_SLOTS; i++) {
+		p_slot = &(p_cache->slots[i]);
+		if (p_slot->stamp && (p_slot->hash == p_cache->hash) &&
+			!memcmp(&(p_slot->image), p_image, sizeof(*p_image))) {
+			p_slot->stamp = ++(p_cache->clock);
+			p_cache->hits++;
+			return p_slot;
+		}
+	}
+	p_cache->misses++;
+	return NULL;
+
+} /* VS_cache_lookup() */
+
+
+/* VS_cache_begin()
+ *
+ * in:     p_cache - cache that just missed on p_image
+ *         p_image - table image about to be validated
+ * out:    p_cache - ready to record p_image's validation
+ * return: nothing
+ *
+ * Takes over an empty or the least recently used slot.  The slot
+ * holds nothing until VS_cache_end() says the recording is whole.
+ */
+
+static inline void
+VS_cache_begin(vs_cache_t *p_cache, const vs_table_t *p_image) {
+
+	vs_cache_slot_t *p_slot = &(p_cache->slots[0]);
+	unsigned int i;
+
+	for (i = 1; i < VS_CACHE_NUM_SLOTS; i++) {
+		if (p_cache->slots[i].stamp < p_slot->stamp)
+			p_slot = &(p_cache->slots[i]);
+	}
+
+	p_slot->stamp      = 0;
+	p_slot->hash       = p_cache->hash;
+	p_slot->num_events = 0;
+	p_slot->has_report = false;
+	memcpy(&(p_slot->image), p_image, sizeof(*p_image));
+	p_cache->p_recording = p_slot;
+	p_cache->overflow    = false;
+
+} /* VS_cache_begin() */
+
+
+/* VS_cache_record_event()
+ *
+ * in:     p_cache - cache recording a validation, or not
+ *         eid     - ID of the event the validation sent
+ *         type    - type of the event the validation sent
+ *         text    - text of the event the validation sent
+ * out:    p_cache - event recorded, if recording
+ * return: nothing
+ */
+
+static inline void
+VS_cache_record_event(vs_cache_t *p_cache, uint16 eid, uint16 type,
+	const char *text) {
+
+	vs_cache_slot_t *p_slot = p_cache->p_recording;
+	vs_cache_event_t *p_event;
+	size_t len;                  /* length of text to record */
+
+	if (!p_slot) return;
+	if (p_slot->num_events == VS_CACHE_MAX_EVENTS) {
+		p_cache->overflow = true;
+		return;
+	}
+
+	len = strlen(text);
+	if (len >= sizeof(p_event->text)) len = sizeof(p_event->text) - 1;
+
+	p_event = &(p_slot->events[p_slot->num_events++]);
+	p_event->eid  = eid;
+	p_event->type = type;
+	memcpy(p_event->text, text, len);
+	p_event->text[len] = '\0';
+
+} /* VS_cache_record_event() */
+
+
+/* VS_cache_record_report()
+ *
+ * in:     p_cache   - cache recording a validation, or not
+ *         p_payload - validation report the validation sent
+ * out:    p_cache   - report recorded, if recording
+ * return: nothing
+ */
+
+static inline void
+VS_cache_record_report(vs_cache_t *p_cache,
+	const VS_tlm_report_payload_t *p_payload) {
+
+	vs_cache_slot_t *p_slot = p_cache->p_recording;
+
+	if (!p_slot) return;
+	memcpy(&(p_slot->report), p_payload, sizeof(*p_payload));
+	p_slot->has_report = true;
+
+} /* VS_cache_record_report() */
+
+
+/* VS_cache_end()
+ *
+ * in:     p_cache - cache recording a validation
+ *         result  - result the validation returns
+ * out:    p_cache - slot holds the validation, unless it sent more
+ *                   than the slot could hold
+ * return: nothing
+ */
+
+static inline void
+VS_cache_end(vs_cache_t *p_cache, CFE_Status_t result) {
+
+	vs_cache_slot_t *p_slot = p_cache->p_recording;
+
+	if (!p_slot) return;
+	if (!p_cache->overflow) {
+		p_slot->result = result;
+		p_slot->stamp  = ++(p_cache->clock);
+	}
+	p_cache->p_recording = NULL;
+
+} /* VS_cache_end() */
+
+
+/* VS_cache_replay()
+ *
+ * in:     p_slot - slot VS_cache_lookup() returned
+ * out:    nothing
+ * return: the recorded validation's result.
+ *
+ * Sends the recorded validation's events, in the same order.  Apps
+ * that report errors in telemetry must first send the recorded
+ * report, if the slot has one, as the validation sent it before its
+ * events.
+ */
+
+static inline CFE_Status_t
+VS_cache_replay(const vs_cache_slot_t *p_slot) {
+
+	uint16 i;
+
+	for (i = 0; i < p_slot->num_events; i++) {
+		CFE_EVS_SendEvent(p_slot->events[i].eid,
+			p_slot->events[i].type, "%s",
+			p_slot->events[i].text);
+	}
+	return p_slot->result;
+
+} /* VS_cache_replay() */
+
+
+#endif
@@ -0,0 +1,182 @@
+#ifndef _VS_CYCLES_H_
+#define _VS_CYCLES_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This file defines the functions the VS apps use to keep the cycle
+ * histogram they dump in a VS_tlm_cycles_t message.  Each app built
+ * with VS_CYCLE_HISTOGRAM reads the cycle counter with VS_cycles_now()
+ * just before its validation function runs and hands the reading to
+ * VS_cycles_record() just after.  Built without it, VS_cycles_now()
+ * is 0 and VS_cycles_record() does nothing, so the compiler drops
+ * both, and the apps pay nothing for the histogram.
+ *
+ * The counter is the CPU's own where the compiler can read it
+ * directly: the time stamp counter on x86 and the virtual counter on
+ * 64-bit Arm.  Elsewhere it is the PSP's free-running timebase.  All
+ * of these tick at least every few tens of nanoseconds on the
+ * processors we fly or test with, fine enough to tell a 200 ns
+ * validation from a 2 us one, and reading them costs tens of cycles
+ * rather than a system call.
+ */
+
+#include <string.h>
+
+#include "cfe.h"
+
+#include "vs_msgstruct.h"
+
+/* Bucket b < VS_CYCLES_SUBBUCKETS counts validations of exactly b
+ * cycles; the rest split each power of two this many ways.
+ */
+#define VS_CYCLES_SUBBUCKETS 4
+
+
+/* VS_cycles_reset()
+ *
+ * in:     nothing
+ * out:    p_hist - zeroed
+ * return: nothing
+ */
+
+static inline void
+VS_cycles_reset(VS_tlm_cycles_payload_t *p_hist) {
+
+	memset(p_hist, 0, sizeof(*p_hist));
+
+} /* VS_cycles_reset() */
+
+
+/* VS_cycles_now()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: the cycle counter, or 0 in builds without
+ *         VS_CYCLE_HISTOGRAM.
+ */
+
+static inline uint64
+VS_cycles_now(void) {
+
+#if !defined(VS_CYCLE_HISTOGRAM)
+	return 0;
+#elif defined(__x86_64__) || defined(__i386__)
+	return (uint64)__builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+	uint64 ticks;
+
+	__asm__ __volatile__ ("isb; mrs %0, cntvct_el0" : "=r" (ticks));
+	return ticks;
+#else
+	uint32 upper, lower;
+
+	CFE_PSP_Get_Timebase(&upper, &lower);
+	return ((uint64)upper << 32) | (uint64)lower;
+#endif
+
+} /* VS_cycles_now() */
+
+
+/* VS_cycles_record()
+ *
+ * in:     p_hist - histogram to update
+ *         start  - cycle count VS_cycles_now() returned
+ * out:    p_hist - updated with this validation
+ * return: nothing
+ *
+ * Call just after the validation function returns.  Validations of
+ * more than a uint32 of cycles count as that long.
+ */
+
+static inline void
+VS_cycles_record(VS_tlm_cycles_payload_t *p_hist, uint64 start) {
+
+#ifdef VS_CYCLE_HISTOGRAM
+	uint64 ticks = VS_cycles_now() - start;
+	uint32 sample = (ticks > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32)ticks;
+	uint32 msb;       /* number of sample's highest set bit */
+	uint32 bucket;
+
+	if (sample < VS_CYCLES_SUBBUCKETS) {
+		bucket = sample;
+	} else {
+		msb = 31 - (uint32)__builtin_clz(sample);
+		bucket = ((msb - 1) * VS_CYCLES_SUBBUCKETS) +
+			((sample >> (msb - 2)) & (VS_CYCLES_SUBBUCKETS - 1));
+	}
+	p_hist->buckets[bucket]++;   /* can roll */
+
+	if (p_hist->count == 0) {
+		p_hist->min_cycles = sample;
+		p_hist->max_cycles = sample;
+	} else {
+		if (sample < p_hist->min_cycles) p_hist->min_cycles = sample;
+		if (sample > p_hist->max_cycles) p_hist->max_cycles = sample;
+	}
+	p_hist->count++;             /* can roll */
+#else
+	(void)p_hist;
+	(void)start;
+#endif
+
+} /* VS_cycles_record() */
+
+
+#ifdef VS_CYCLE_HISTOGRAM
+/* VS_cycles_send()
+ *
+ * in:     p_msg  - message to send the histogram in
+ *         mid    - the app's VS?_TLM_CYCLES_MID
+ *         p_hist - the histogram
+ * out:    p_msg  - holds the histogram and its counter's rate
+ * return: nothing
+ *
+ * The apps call this function to handle their VS?_DUMP_CYCLES_CC
+ * command.  It leaves the histogram as it was; the reset counters
+ * command clears it.
+ */
+
+static inline void
+VS_cycles_send(VS_tlm_cycles_t *p_msg, CFE_SB_MsgId_Atom_t mid,
+	const VS_tlm_cycles_payload_t *p_hist) {
+
+#if defined(__aarch64__)
+	uint64 hz;        /* virtual counter's frequency */
+#endif
+
+	CFE_MSG_Init(CFE_MSG_PTR(p_msg->header), CFE_SB_ValueToMsgId(mid),
+		sizeof(*p_msg));
+	p_msg->payload = *p_hist;
+
+#if defined(__x86_64__) || defined(__i386__)
+	p_msg->payload.source = VS_CYCLES_SOURCE_TSC;
+	p_msg->payload.hz     = 0;   /* not architecturally visible */
+#elif defined(__aarch64__)
+	__asm__ __volatile__ ("mrs %0, cntfrq_el0" : "=r" (hz));
+	p_msg->payload.source = VS_CYCLES_SOURCE_CNTVCT;
+	p_msg->payload.hz     = (uint32)hz;
+#else
+	p_msg->payload.source = VS_CYCLES_SOURCE_TIMEBASE;
+	p_msg->payload.hz     = CFE_PSP_GetTimerTicksPerSecond();
+#endif
+
+	CFE_SB_TimeStampMsg(CFE_MSG_PTR(p_msg->header));
+	CFE_SB_TransmitMsg(CFE_MSG_PTR(p_msg->header), true);
+
+} /* VS_cycles_send() */
+#endif /* VS_CYCLE_HISTOGRAM */
+
+#endif
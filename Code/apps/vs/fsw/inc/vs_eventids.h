@@ -24,8 +24,10 @@
  *
  * Numbering convention:
  *   0x0XYZ is for information events,
- *   0x1XYZ is for general application error events, and
- *   0x2XYZ is for table validation error events.
+ *   0x1XYZ is for general application error events,
+ *   0x2XYZ is for table validation error events, and
+ *   0x8XYZ through 0xFXYZ are for short-format table validation
+ *          error events.
  */
 
 /* Information event IDs */
@@ -33,11 +35,19 @@
 #define VS_CMD_RESET_INF_EID    0x0002 /* received counter reset command */
 #define VS_STARTUP_OK_INF_EID   0x0004 /* app started, intialized OK */
 #define VS_VALIDATION_INF_EID   0x0008 /* table validation statistics */
+#define VS_BATCH_INF_EID        0x0010 /* batch validation results */
+#define VS_ENGINE_INF_EID       0x0020 /* validation engine changed */
+#define VS_STAGE_INF_EID        0x0040 /* image staged or loaded */
+#define VS_SCREEN_INF_EID       0x0080 /* screening results */
+#define VS_PROGRAM_INF_EID      0x0100 /* validation program loaded */
 
 /* Application error IDs not related to table validation */
 #define VS_MSG_BAD_CC_ERR_EID   0x1001 /* received message with invalid CC */
 #define VS_MSG_BAD_MID_ERR_EID  0x1002 /* received message with invalid MID */
 #define VS_PIPE_ERR_EID         0x1004 /* command pipe read error */
+#define VS_CMD_BAD_ARG_ERR_EID  0x1008 /* command has bad length/argument */
+#define VS_STAGE_ERR_EID        0x1010 /* image not staged or not loaded */
+#define VS_PROGRAM_ERR_EID      0x1020 /* validation program not loaded */
 
 /* Error IDs related to table validation. */
 #define VS_TBL_ZERO_ERR_EID     0x2001 /* unused entry not zeroed */
@@ -49,5 +59,36 @@
 #define VS_TBL_EXTRA_ERR_EID    0x2040 /* in-use entry follows unused entry */
 #define VS_TBL_REDEF_ERR_EID    0x2080 /* parm ID used by earlier entry */
 
+/* Apps built with VSA_SHORT_EVENTS or VSC_SHORT_EVENTS send each
+ * table validation error event with a short-format event ID that
+ * holds all its text would have said, and the same fixed text every
+ * time, so that EVS in short format mode loses nothing by dropping
+ * the text.  The ID's top bit is set, the next three number the
+ * VS_TBL_*_ERR_EID's bit, the next four hold the entry's
+ * VS_PARM_NAME_* from vs_parmclass.h, and the low eight hold the
+ * 1-based number of the entry, less 1.  So these apps' tables hold at
+ * most VS_TBL_SHORT_MAX_ENTRIES entries.
+ */
+#define VS_TBL_SHORT_FLAG        0x8000
+#define VS_TBL_SHORT_MAX_ENTRIES 256
+#define VS_TBL_SHORT_TEXT        "Table entry error"
+
+/* The bit number of a VS_TBL_*_ERR_EID, from 0 to 7. */
+#define VS_TBL_ERR_BIT(eid) ((((eid) & 0xF0) ? 4 : 0) | \
+	(((eid) & 0xCC) ? 2 : 0) | (((eid) & 0xAA) ? 1 : 0))
+
+#define VS_TBL_SHORT_EID(eid, name, entry) \
+	((uint16)(VS_TBL_SHORT_FLAG | (VS_TBL_ERR_BIT(eid) << 12) | \
+		(((name) & 0xF) << 8) | (((entry) - 1) & 0xFF)))
+
+/* The VS_TBL_*_ERR_EID, VS_PARM_NAME_*, and 1-based entry number a
+ * short-format event ID holds.
+ */
+#define VS_TBL_SHORT_ERR_EID(short_eid) \
+	((uint16)((VS_TBL_ZERO_ERR_EID & 0xFF00) | \
+		(1u << (((short_eid) >> 12) & 0x7))))
+#define VS_TBL_SHORT_NAME(short_eid)  (((short_eid) >> 8) & 0xF)
+#define VS_TBL_SHORT_ENTRY(short_eid) (((short_eid) & 0xFF) + 1u)
+
 
 #endif
@@ -50,19 +50,33 @@
  * cFS Apps and cFE Services.  Although the CCSDS header suggests that
  * the valid range for Topic IDs is 0x000 to 0x07FF, all the ones I've
  * seen in use are between 0x00 and 0xFF.
+ *
+ * Apps built with their VS?_TBL_NOTIFY option ask TBL to send them a
+ * VS?_TBL_NOTIFY_MID command message whenever their table has a
+ * validation or load pending.
  */
 
 #define VSA_CMD_MID     (0x1800|0x0090)    /* commands from ground */
 #define VSA_SEND_HK_MID (0x1800|0x0091)    /* send housekeeping command */
 #define VSA_TLM_HK_MID  (0x0800|0x0091)    /* housekeeping telemetry */
+#define VSA_TLM_REPORT_MID (0x0800|0x0092) /* validation report telemetry */
+#define VSA_TLM_CYCLES_MID (0x0800|0x0093) /* cycle histogram telemetry */
+#define VSA_TBL_NOTIFY_MID (0x1800|0x0094) /* TBL notification */
 
 #define VSB_CMD_MID     (0x1800|0x00A0)    /* commands from ground */
 #define VSB_SEND_HK_MID (0x1800|0x00A1)    /* send housekeeping command */
 #define VSB_TLM_HK_MID  (0x0800|0x00A1)    /* housekeeping telemetry */
+#define VSB_TLM_CYCLES_MID (0x0800|0x00A3) /* cycle histogram telemetry */
+#define VSB_TBL_NOTIFY_MID (0x1800|0x00A4) /* TBL notification */
 
 #define VSC_CMD_MID     (0x1800|0x00B0)    /* commands from ground */
 #define VSC_SEND_HK_MID (0x1800|0x00B1)    /* send housekeeping command */
 #define VSC_TLM_HK_MID  (0x0800|0x00B1)    /* housekeeping telemetry */
+#define VSC_TLM_REPORT_MID (0x0800|0x00B2) /* validation report telemetry */
+#define VSC_TLM_PROFILE_MID (0x0800|0x00B3) /* Grunt profile telemetry */
+#define VSC_TLM_CYCLES_MID (0x0800|0x00B5) /* cycle histogram telemetry */
+#define VSC_TLM_TRACE_MID  (0x0800|0x00B6) /* Grunt trace telemetry */
+#define VSC_TBL_NOTIFY_MID (0x1800|0x00B4) /* TBL notification */
 
 
 /* These are the app-specific "performance IDs" we pass to
@@ -76,12 +90,30 @@
  *
  * The VS?_ALL_PERF_IDs below cover all app processing.  The
  * VS?_VF_PERF_ID cover only table validation function processing.
+ * The rest mark phases within those, so that a test can see where an
+ * app spends its time:
+ *
+ *   VS?_ALL_PERF_ID          all app processing
+ *     VS?_VF_PERF_ID         table validation function
+ *       VSC_VM_INIT_PERF_ID  resetting the Grunt VM for a run
+ *       VSC_VM_RUN_PERF_ID   executing Grunt instructions
+ *         VSC_VM_FLUSH_PERF_ID  sending an event, to EVS or a sink
+ *     VS?_HK_PERF_ID         transmitting housekeeping telemetry
+ *
+ * VSC's Grunt phases won't fit between VSC_HK_PERF_ID and 63, so
+ * they take 33-35 instead.
  */
 #define VSA_ALL_PERF_ID 40
 #define VSA_VF_PERF_ID  41
+#define VSA_HK_PERF_ID  42
 #define VSB_ALL_PERF_ID 50
 #define VSB_VF_PERF_ID  51
+#define VSB_HK_PERF_ID  52
 #define VSC_ALL_PERF_ID 60
 #define VSC_VF_PERF_ID  61
+#define VSC_HK_PERF_ID  62
+#define VSC_VM_INIT_PERF_ID  33
+#define VSC_VM_RUN_PERF_ID   34
+#define VSC_VM_FLUSH_PERF_ID 35
 
 #endif
@@ -16,16 +16,53 @@
  * permissions and limitations under the License.
  */
 
+/* The validation statistics each VS app reports in housekeeping
+ * telemetry, for the images TBL has asked it to validate since it
+ * started or last reset its counters.  Durations are in nanoseconds,
+ * timed with CFE_PSP_GetTime().  Unlike the 8-bit command counters,
+ * these are 32-bit fields in the flight CPU's byte order; see
+ * vs_vstats.h.
+ */
+typedef struct {
+	uint32 ctr_validations; /* validations run */
+	uint32 ctr_valid;       /* of those, images found valid */
+	uint32 ctr_invalid;     /* of those, images found invalid */
+	uint32 last_ns;         /* duration of the latest validation */
+	uint32 min_ns;          /* shortest duration */
+	uint32 max_ns;          /* longest duration */
+	uint32 ewma_ns;         /* moving average duration */
+} VS_vstats_t;
+
+
+/* The validation engines a VS app can report in housekeeping
+ * telemetry.  VSA and VSB always run C code and report VS_ENGINE_C.
+ * VSC can switch among the others at run time; see vsc_table.c.
+ */
+#define VS_ENGINE_C        0  /* hand-written or generated C code */
+#define VS_ENGINE_GRUNT    1  /* Grunt's fastest engine for the program */
+#define VS_ENGINE_SWITCH   2  /* Grunt's checked switch-dispatch engine */
+#define VS_ENGINE_THREADED 3  /* Grunt's checked threaded engine */
+#define VS_ENGINE_NATIVE   4  /* gruntaot translation of the program */
+#define VS_ENGINE_XMACRO   5  /* grunt_xmacro.h expansion of the program */
+
+
 /* Using 8-bit counters in this housekeeping payload structure serves
  * two purposes:
  *  (1) It matches the traditional counter size used by other cFS apps.
  *  (2) It avoids the moral quandry of net vs. host byte ordering.
  *
+ * The batch counters stay zero unless the app is built with its
+ * VS?_PIPE_BATCH setting above 1; see the app's main loop.
  */
 typedef struct {
 	uint8 ctr_cmd_ok;      /* counts commands processed successfully */
 	uint8 ctr_cmd_error;   /* counts commands not processed due to error */
-	uint8 pad[2];          /* unused; pads struct to 32-bits */
+	uint8 ctr_batched;     /* counts messages drained without blocking */
+	uint8 max_batch;       /* most messages handled in one wake-up */
+	uint8 engine;          /* VS_ENGINE_* validating tables */
+	uint8 staged;          /* images waiting in the staging pool */
+	uint8 pad[2];          /* unused; pads vstats to 32-bits */
+	VS_vstats_t vstats;    /* validation statistics */
 } VS_tlm_hk_payload_t;
 
 typedef struct {
@@ -33,4 +70,116 @@ typedef struct {
 	VS_tlm_hk_payload_t       payload;
 } VS_tlm_hk_t;
 
+
+/* The STAGE ground command every VS app has names a candidate table
+ * file the ground has put on the spacecraft's filesystem.  The app
+ * reads it into the next free slot of its own pool of VS_STAGE_SLOTS
+ * images, in front of TBL's single inactive buffer, and loads the
+ * images waiting there on its next housekeeping cycle, oldest first,
+ * with CFE_TBL_Load(), which validates each as a TBL validation
+ * would and makes it active if it is valid.  So the ground can stage
+ * image N+1 while image N waits or validates, rather than waiting
+ * out a load, validate, and activate for each image.  The staged
+ * field of housekeeping telemetry counts the images waiting.
+ */
+#define VS_STAGE_SLOTS 2
+
+typedef struct {
+	char filename[CFE_MISSION_MAX_PATH_LEN];  /* NUL-terminated */
+} VS_cmd_stage_payload_t;
+
+typedef struct {
+	CFE_MSG_CommandHeader_t header;
+	VS_cmd_stage_payload_t  payload;
+} VS_cmd_stage_t;
+
+
+/* The SCREEN ground command of apps that can screen names a set of
+ * candidate table files, as VSC's VALIDATE_BATCH command does.  The
+ * app reads each one and screens it at once: it decides the verdict
+ * its validation function would, but stops at the first problem and
+ * sends none of that function's events.  A single VS_SCREEN_INF_EID
+ * event reports which images would validate and which files couldn't
+ * be read, as bitmasks indexed by filename position, so the ground
+ * can weed out bad candidates before it stages any.  Unused filenames
+ * should be zeroed.
+ */
+#define VS_SCREEN_MAX_IMAGES 4
+
+typedef struct {
+	uint8 num_images;   /* number of filenames in use, 1 or more */
+	uint8 pad[3];       /* unused; pads filenames to 32-bits */
+	char  filenames[VS_SCREEN_MAX_IMAGES][CFE_MISSION_MAX_PATH_LEN];
+} VS_cmd_screen_payload_t;
+
+typedef struct {
+	CFE_MSG_CommandHeader_t header;
+	VS_cmd_screen_payload_t payload;
+} VS_cmd_screen_t;
+
+
+/* Apps built to report validation errors in telemetry rather than as
+ * one event each send one of these validation report messages per
+ * table image they validate, just before their *_VALIDATION_INF_EID
+ * summary event.  Each record describes one error the event would
+ * have: the (1-based) number of the entry at fault, the raw parm ID
+ * field of that entry, and the *_TBL_*_ERR_EID event ID naming the
+ * problem.  Records appear in the order the events would have.
+ * Errors beyond the first VS_REPORT_MAX_ERRORS are counted in
+ * num_dropped but not recorded.
+ */
+#define VS_REPORT_MAX_ERRORS 32
+
+typedef struct {
+	uint16 entry;          /* 1-based number of the entry at fault */
+	uint16 parm_id;        /* that entry's parm ID field */
+	uint16 eid;            /* *_TBL_*_ERR_EID event ID of the error */
+	uint8  pad[2];         /* unused; pads struct to 32-bits */
+} VS_report_error_t;
+
+typedef struct {
+	uint8 num_errors;      /* records in use in errors[] */
+	uint8 num_dropped;     /* errors that didn't fit in errors[] */
+	uint8 pad[2];          /* unused; pads errors[] to 32-bits */
+	VS_report_error_t errors[VS_REPORT_MAX_ERRORS];
+} VS_tlm_report_payload_t;
+
+typedef struct {
+	CFE_MSG_TelemetryHeader_t header;
+	VS_tlm_report_payload_t   payload;
+} VS_tlm_report_t;
+
+
+/* Apps built with VS_CYCLE_HISTOGRAM count the cycles each validation
+ * TBL asks for takes, on the CPU's cycle counter or the PSP's
+ * free-running timebase, and answer their VS?_DUMP_CYCLES_CC ground
+ * command with one of these messages holding a histogram of them
+ * since they started or last reset their counters; see vs_cycles.h.
+ * Bucket b counts validations of c cycles where c == b for b < 4,
+ * and otherwise where c >> (b / 4 - 1) == 4 + (b % 4): four buckets
+ * per power of two, each a quarter of it wide.  hz is counter ticks
+ * per second, or 0 where the counter's rate can't be read, as on
+ * x86; compare the histogram with the housekeeping vstats then.
+ */
+#define VS_CYCLES_NUM_BUCKETS 124   /* counts up to 2^32 - 1 cycles */
+
+#define VS_CYCLES_SOURCE_TSC      1  /* x86 time stamp counter */
+#define VS_CYCLES_SOURCE_CNTVCT   2  /* Arm virtual counter */
+#define VS_CYCLES_SOURCE_TIMEBASE 3  /* CFE_PSP_Get_Timebase() */
+
+typedef struct {
+	uint8  source;         /* VS_CYCLES_SOURCE_* counting */
+	uint8  pad[3];         /* unused; pads hz to 32-bits */
+	uint32 hz;             /* counter ticks per second, 0 if unknown */
+	uint32 count;          /* validations counted */
+	uint32 min_cycles;     /* shortest validation */
+	uint32 max_cycles;     /* longest validation */
+	uint32 buckets[VS_CYCLES_NUM_BUCKETS];
+} VS_tlm_cycles_payload_t;
+
+typedef struct {
+	CFE_MSG_TelemetryHeader_t header;
+	VS_tlm_cycles_payload_t   payload;
+} VS_tlm_cycles_t;
+
 #endif
@@ -0,0 +1,125 @@
+#ifndef _VS_PARMCLASS_H_
+#define _VS_PARMCLASS_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This file defines the parm ID classification table the VS
+ * validation functions use to classify each entry's parm ID with one
+ * indexed load rather than a chain of compares.  Each row gives a
+ * parm ID's class, the index of its name, and for the animal and
+ * direction classes, the range its bounds must fall in.  VSA looks
+ * rows up with VS_parm_class(), and Grunt's CLASSIFY instruction
+ * pushes them onto the arg stack for VSC's program.
+ *
+ * The table has a row for each of the 256 parm IDs below
+ * VS_PARM_CLASS_NUM_IDS and one more, for every ID past them, that
+ * classifies them as invalid.  In builds with wide parm IDs,
+ * VS_parm_class() classifies the wide ones by range, as
+ * VS_PARM_IS_ANIMAL() and VS_PARM_IS_DIRECTION() do.
+ *
+ * Rows the initializer below leaves out are all zeroes, so the
+ * classes and names both number from invalid at 0.
+ */
+
+#include "vs_tablestruct.h"
+
+/* Parm ID classes. */
+#define VS_PARM_CLASS_INVALID   0
+#define VS_PARM_CLASS_UNUSED    1
+#define VS_PARM_CLASS_ANIMAL    2
+#define VS_PARM_CLASS_DIRECTION 3
+
+/* Parm ID names, in the order the validation functions keep their
+ * name strings in.
+ */
+#define VS_PARM_NAME_INVALID 0
+#define VS_PARM_NAME_UNUSED  1
+#define VS_PARM_NAME_APE     2
+#define VS_PARM_NAME_BAT     3
+#define VS_PARM_NAME_CAT     4
+#define VS_PARM_NAME_DOG     5
+#define VS_PARM_NAME_NORTH   6
+#define VS_PARM_NAME_SOUTH   7
+#define VS_PARM_NAME_EAST    8
+#define VS_PARM_NAME_WEST    9
+#ifdef VS_PARM_WIDE_MIN
+#define VS_PARM_NAME_WIDE_ANIMAL    10
+#define VS_PARM_NAME_WIDE_DIRECTION 11
+#define VS_PARM_NUM_NAMES           12
+#else
+#define VS_PARM_NUM_NAMES           10
+#endif
+
+#define VS_PARM_CLASS_NUM_IDS 256
+
+/* One row of the table, 12 bytes. */
+typedef struct {
+	uint8  kind;     /* VS_PARM_CLASS_* */
+	uint8  name;     /* VS_PARM_NAME_* */
+	uint16 spare;
+	uint32 min;      /* lowest valid bound, if animal or direction */
+	uint32 max;      /* highest valid bound, likewise */
+} vs_parm_class_t;
+
+#define VS_PARM_CLASS_ROW(kind, name, range) \
+	{ VS_PARM_CLASS_##kind, VS_PARM_NAME_##name, 0, \
+	  VS_PARM_##range##_MIN, VS_PARM_##range##_MAX }
+
+static const vs_parm_class_t VS_parm_classes[VS_PARM_CLASS_NUM_IDS + 1] = {
+	[VS_PARM_UNUSED] = { VS_PARM_CLASS_UNUSED, VS_PARM_NAME_UNUSED,
+			     0, 0, 0 },
+	[VS_PARM_APE]    = VS_PARM_CLASS_ROW(ANIMAL, APE, ANIMAL),
+	[VS_PARM_BAT]    = VS_PARM_CLASS_ROW(ANIMAL, BAT, ANIMAL),
+	[VS_PARM_CAT]    = VS_PARM_CLASS_ROW(ANIMAL, CAT, ANIMAL),
+	[VS_PARM_DOG]    = VS_PARM_CLASS_ROW(ANIMAL, DOG, ANIMAL),
+	[VS_PARM_NORTH]  = VS_PARM_CLASS_ROW(DIRECTION, NORTH, DIRECTION),
+	[VS_PARM_SOUTH]  = VS_PARM_CLASS_ROW(DIRECTION, SOUTH, DIRECTION),
+	[VS_PARM_EAST]   = VS_PARM_CLASS_ROW(DIRECTION, EAST, DIRECTION),
+	[VS_PARM_WEST]   = VS_PARM_CLASS_ROW(DIRECTION, WEST, DIRECTION),
+};
+
+#ifdef VS_PARM_WIDE_MIN
+static const vs_parm_class_t VS_parm_wide_classes[2] = {
+	VS_PARM_CLASS_ROW(ANIMAL, WIDE_ANIMAL, ANIMAL),
+	VS_PARM_CLASS_ROW(DIRECTION, WIDE_DIRECTION, DIRECTION),
+};
+#endif
+
+#undef VS_PARM_CLASS_ROW
+
+
+/* VS_parm_class()
+ *
+ * in:     id - parm ID to classify, or any 32-bit number
+ * out:    nothing
+ * return: id's row of the classification table.
+ */
+
+static inline const vs_parm_class_t *
+VS_parm_class(uint32 id) {
+
+#ifdef VS_PARM_WIDE_MIN
+	if ((id >= VS_PARM_WIDE_MIN) && (id < (1u << VS_PARM_ID_BITS)))
+		return &(VS_parm_wide_classes[id >=
+			VS_PARM_WIDE_DIRECTION_MIN]);
+#endif
+	return &(VS_parm_classes[(id < VS_PARM_CLASS_NUM_IDS) ? id :
+		VS_PARM_CLASS_NUM_IDS]);
+
+} /* VS_parm_class() */
+
+
+#endif
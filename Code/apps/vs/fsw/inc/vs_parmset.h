@@ -0,0 +1,103 @@
+#ifndef _VS_PARMSET_H_
+#define _VS_PARMSET_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This file defines a set of parm IDs with one bit for each possible
+ * ID, which the VS validation functions use to find entries that
+ * redefine an earlier entry's parm in time linear in the number of
+ * entries.  Marking or testing an ID costs the same however many
+ * entries came before.
+ *
+ * A set is 32 bytes with the default 8-bit parm IDs and 8 KiB with
+ * 16-bit ones, too big to clear before every validation.  Instead,
+ * start with a zeroed set, typically a static one, and when done call
+ * VS_parmset_clear() with the entries whose IDs were marked.  That
+ * leaves the set zeroed again at a cost linear in the number of
+ * entries rather than in the size of the set.
+ */
+
+#include "vs_tablestruct.h"
+
+#define VS_PARMSET_NUM_WORDS ((1u << VS_PARM_ID_BITS) / 32)
+
+typedef struct {
+	uint32 words[VS_PARMSET_NUM_WORDS];
+} vs_parmset_t;
+
+
+/* VS_parmset_mark()
+ *
+ * in:     p_set - set to add id to
+ *         id    - parm ID to add
+ * out:    p_set - id added
+ * return: 1 if id was already in *p_set, else 0.
+ */
+
+static inline uint32
+VS_parmset_mark(vs_parmset_t *p_set, vs_parm_id_t id) {
+
+	uint32 *p_word = &(p_set->words[id >> 5]);
+	uint32 bit = (uint32)1 << (id & 31);
+	uint32 seen = (*p_word & bit) != 0;
+
+	*p_word |= bit;
+	return seen;
+
+} /* VS_parmset_mark() */
+
+
+/* VS_parmset_unmark()
+ *
+ * in:     p_set - set to remove id from
+ *         id    - parm ID to remove
+ * out:    p_set - id removed
+ * return: nothing
+ *
+ * For sets that persist from one validation to the next, to remove
+ * the parm of an entry that has changed.
+ */
+
+static inline void
+VS_parmset_unmark(vs_parmset_t *p_set, vs_parm_id_t id) {
+
+	p_set->words[id >> 5] &= ~((uint32)1 << (id & 31));
+
+} /* VS_parmset_unmark() */
+
+
+/* VS_parmset_clear()
+ *
+ * in:     p_set       - set holding at most the IDs of p_entries
+ *         p_entries   - entries whose parm IDs may be in *p_set
+ *         num_entries - number of entries
+ * out:    p_set       - zeroed
+ * return: nothing
+ */
+
+static inline void
+VS_parmset_clear(vs_parmset_t *p_set, const vs_entry_t *p_entries,
+	unsigned int num_entries) {
+
+	unsigned int i;
+
+	for (i = 0; i < num_entries; i++)
+		p_set->words[p_entries[i].parm_id >> 5] = 0;
+
+} /* VS_parmset_clear() */
+
+
+#endif
@@ -25,17 +25,47 @@
 /* This file declares a type describing the in-memory format of the
  * app's table and defines some constant values related to its fields.
  *
- * The table contains four parameter configuration entries.  Each
- * entry specifies a low and high bound on the value of an imaginary
- * parameter.  There are eight possible parameters to choose from;
- * four are named for animals, four for cardinal directions.  There is
- * also a special "empty" parameter to indicate an empty table entry.
+ * The table contains VS_TABLE_NUM_ENTRIES parameter configuration
+ * entries, four by default.  Each entry specifies a low and high
+ * bound on the value of an imaginary parameter.  There are eight
+ * named parameters to choose from; four are named for animals, four
+ * for cardinal directions.  There is also a special "empty" parameter
+ * to indicate an empty table entry.
  *
  * The low and high bound values must be drawn from a particular
  * range.  There is one range for animal parameters and another range
  * for direction parameters.
+ *
+ * Builds may define VS_TABLE_NUM_ENTRIES to hold more or fewer
+ * entries, and VS_PARM_ID_BITS as 16 rather than the default 8 to
+ * widen the parm ID field.  Wide parm IDs from VS_PARM_WIDE_MIN
+ * through VS_PARM_WIDE_DIRECTION_MIN - 1 name further animal parms,
+ * and those from VS_PARM_WIDE_DIRECTION_MIN up name further direction
+ * parms, so that a wide table can define many more parms than eight.
+ * Parm IDs below VS_PARM_WIDE_MIN mean the same in both widths.  The
+ * padding shrinks to keep each entry 12 bytes long.
  */
 
+#ifndef VS_TABLE_NUM_ENTRIES
+#define VS_TABLE_NUM_ENTRIES 4
+#endif
+
+#ifndef VS_PARM_ID_BITS
+#define VS_PARM_ID_BITS 8
+#endif
+
+#if VS_PARM_ID_BITS == 8
+typedef uint8 vs_parm_id_t;
+#define VS_ENTRY_PAD_SIZE 3
+#elif VS_PARM_ID_BITS == 16
+typedef uint16 vs_parm_id_t;
+#define VS_ENTRY_PAD_SIZE 2
+#define VS_PARM_WIDE_MIN           0x0100
+#define VS_PARM_WIDE_DIRECTION_MIN 0x8000
+#else
+#error "VS_PARM_ID_BITS must be 8 or 16"
+#endif
+
 #define VS_PARM_UNUSED 0x00
 #define VS_PARM_APE    0x01
 #define VS_PARM_BAT    0x02
@@ -46,20 +76,42 @@
 #define VS_PARM_EAST   0x40
 #define VS_PARM_WEST   0x80
 
+/* The named animal and direction parm IDs. */
+#define VS_PARM_ANIMALS \
+	(VS_PARM_APE | VS_PARM_BAT | VS_PARM_CAT | VS_PARM_DOG)
+#define VS_PARM_DIRECTIONS \
+	(VS_PARM_NORTH | VS_PARM_SOUTH | VS_PARM_EAST | VS_PARM_WEST)
+
 #define VS_PARM_ANIMAL_MIN    0x00000010
 #define VS_PARM_ANIMAL_MAX    0x00001000
 #define VS_PARM_DIRECTION_MIN 0x00010000
 #define VS_PARM_DIRECTION_MAX 0x01000000
 
+/* VS_PARM_IS_ANIMAL(id) and VS_PARM_IS_DIRECTION(id) are true if id
+ * is a valid animal or direction parm ID.  They evaluate id more than
+ * once.
+ */
+#define VS_PARM_IS_NAMED(id, class) \
+	((((id) & (class)) != 0) && (((id) & ((id) - 1)) == 0))
+#if VS_PARM_ID_BITS == 8
+#define VS_PARM_IS_ANIMAL(id)    VS_PARM_IS_NAMED(id, VS_PARM_ANIMALS)
+#define VS_PARM_IS_DIRECTION(id) VS_PARM_IS_NAMED(id, VS_PARM_DIRECTIONS)
+#else
+#define VS_PARM_IS_ANIMAL(id) (((id) < VS_PARM_WIDE_MIN) ? \
+	VS_PARM_IS_NAMED(id, VS_PARM_ANIMALS) : \
+	((id) < VS_PARM_WIDE_DIRECTION_MIN))
+#define VS_PARM_IS_DIRECTION(id) (((id) < VS_PARM_WIDE_MIN) ? \
+	VS_PARM_IS_NAMED(id, VS_PARM_DIRECTIONS) : \
+	((id) >= VS_PARM_WIDE_DIRECTION_MIN))
+#endif
+
 typedef struct {
-	uint8 parm_id;
-	uint8 pad[3];
+	vs_parm_id_t parm_id;
+	uint8 pad[VS_ENTRY_PAD_SIZE];
 	uint32 bound_low;
 	uint32 bound_high;
 } vs_entry_t;
 
-#define VS_TABLE_NUM_ENTRIES 4
-
 typedef struct {
 	vs_entry_t entries[VS_TABLE_NUM_ENTRIES];
 } vs_table_t;
@@ -0,0 +1,121 @@
+#ifndef _VS_VSTATS_H_
+#define _VS_VSTATS_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This file defines the functions the VS apps use to keep the
+ * validation statistics they report in housekeeping telemetry: how
+ * many images TBL asked them to validate, how many of those were
+ * valid, and how long validation took.  Each app times its validation
+ * function with CFE_PSP_GetTime(), calling VS_vstats_start() before
+ * and VS_vstats_record() after.
+ *
+ * The average is an exponentially weighted moving average giving
+ * each new validation a weight of 1/VS_VSTATS_EWMA_WEIGHT, so it
+ * follows changes in validation time within a few dozen validations
+ * and needs no history.
+ */
+
+#include <string.h>
+
+#include "cfe.h"
+
+#include "vs_msgstruct.h"
+
+#define VS_VSTATS_EWMA_WEIGHT 8
+
+
+/* VS_vstats_reset()
+ *
+ * in:     nothing
+ * out:    p_stats - zeroed
+ * return: nothing
+ */
+
+static inline void
+VS_vstats_reset(VS_vstats_t *p_stats) {
+
+	memset(p_stats, 0, sizeof(*p_stats));
+
+} /* VS_vstats_reset() */
+
+
+/* VS_vstats_start()
+ *
+ * in:     nothing
+ * out:    p_start - set to the time now
+ * return: nothing
+ *
+ * Call just before running the validation function.
+ */
+
+static inline void
+VS_vstats_start(OS_time_t *p_start) {
+
+	CFE_PSP_GetTime(p_start);
+
+} /* VS_vstats_start() */
+
+
+/* VS_vstats_record()
+ *
+ * in:     p_stats - statistics to update
+ *         start   - time VS_vstats_start() returned
+ *         result  - the validation function's result
+ * out:    p_stats - updated with this validation
+ * return: nothing
+ *
+ * Call just after the validation function returns.  Durations longer
+ * than a uint32 of nanoseconds, over four seconds, count as that
+ * long.
+ */
+
+static inline void
+VS_vstats_record(VS_vstats_t *p_stats, OS_time_t start,
+	CFE_Status_t result) {
+
+	OS_time_t now;    /* time validation finished */
+	int64 ns;         /* nanoseconds since start */
+	uint32 sample;    /* ns clamped to a uint32 */
+
+	CFE_PSP_GetTime(&now);
+	ns = OS_TimeGetTotalNanoseconds(OS_TimeSubtract(now, start));
+	sample = (ns < 0) ? 0 : ((ns > 0xFFFFFFFF) ? 0xFFFFFFFF :
+		(uint32)ns);
+
+	if (p_stats->ctr_validations == 0) {
+		p_stats->min_ns  = sample;
+		p_stats->max_ns  = sample;
+		p_stats->ewma_ns = sample;
+	} else {
+		if (sample < p_stats->min_ns) p_stats->min_ns = sample;
+		if (sample > p_stats->max_ns) p_stats->max_ns = sample;
+		p_stats->ewma_ns = (uint32)((int64)p_stats->ewma_ns +
+			(((int64)sample - (int64)p_stats->ewma_ns) /
+			VS_VSTATS_EWMA_WEIGHT));
+	}
+	p_stats->last_ns = sample;
+
+	p_stats->ctr_validations++;     /* can roll */
+	if (result == CFE_SUCCESS) {
+		p_stats->ctr_valid++;   /* can roll */
+	} else {
+		p_stats->ctr_invalid++; /* can roll */
+	}
+
+} /* VS_vstats_record() */
+
+#endif
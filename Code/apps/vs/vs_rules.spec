@@ -0,0 +1,96 @@
+# Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+# implied.  See the License for the specific language governing
+# permissions and limitations under the License.
+
+# This file states the V-SPELLS table validation rules of
+# Docs/vsa-vf-spec.md in a form the vsrules generator can read.  From
+# it, vsrules writes VSB's native C validation function,
+# apps/vsb/fsw/src/vsb_rules.h, and a Grunt program VSC can run in
+# place of its hand-written one, apps/vsc/fsw/src/vsvf_rules.gasm.
+# Change the rules here, rebuild the vsb_rules_h and vsvf_rules_gasm
+# targets, and commit the regenerated files along with this one.
+#
+# Comments run from a # to the end of the line.  Words are separated
+# by spaces; quoted strings may hold spaces.  A line that starts with
+# a space or tab continues the directive on the line before.  The
+# directives are:
+#
+#   class NAME MIN MAX        a class of parms, whose bounds must lie
+#                             in MIN through MAX
+#   unused ID NAME            the parm ID of unused entries
+#   parm ID NAME CLASS        a named parm of an existing class
+#   wide CLASS ID NAME        wide parm IDs from ID up to the next
+#                             wide directive's ID, or to the largest
+#                             ID, are of CLASS and print as NAME
+#   unknown NAME              how to print any other parm ID
+#   rule KIND EID COND "TEXT" an error event, for entries of KIND,
+#                             sent if COND holds
+#   summary EID "TEXT"        the information event sent last
+#
+# IDs, bounds, and event IDs are C constant names from the VS
+# headers.  An entry's KIND is unused if its parm ID is the unused
+# one, inuse if its parm ID is of a class, and invalid otherwise.  An
+# unused or inuse entry is valid if none of the rules for its kind
+# hold; an invalid entry never is.  The conditions are:
+#
+#   always              holds for every entry of the kind
+#   nonzero FIELD...    any of the fields is nonzero
+#   outside FIELD       the field lies outside its class's MIN-MAX
+#   greater FIELD FIELD the first field is greater than the second
+#   after_unused        a valid unused entry came before this one
+#   redefines           an in-use entry before this one has its parm
+#
+# where the FIELDs are pad, low, and high, the entry's padding and
+# bounds.  Each entry's events go out in the order the rules appear,
+# entry by entry in table order.  In TEXT, N stands for the entry
+# number, P for the entry's parm name, and, in the summary, V, I, and
+# U for the numbers of valid, invalid, and unused entries.
+
+class animal    VS_PARM_ANIMAL_MIN    VS_PARM_ANIMAL_MAX
+class direction VS_PARM_DIRECTION_MIN VS_PARM_DIRECTION_MAX
+
+unused VS_PARM_UNUSED Unused
+
+parm VS_PARM_APE   Ape   animal
+parm VS_PARM_BAT   Bat   animal
+parm VS_PARM_CAT   Cat   animal
+parm VS_PARM_DOG   Dog   animal
+parm VS_PARM_NORTH North direction
+parm VS_PARM_SOUTH South direction
+parm VS_PARM_EAST  East  direction
+parm VS_PARM_WEST  West  direction
+
+wide animal    VS_PARM_WIDE_MIN           "Wide animal"
+wide direction VS_PARM_WIDE_DIRECTION_MIN "Wide direction"
+
+unknown Invalid
+
+rule invalid VS_TBL_PARM_ERR_EID  always
+	"Table entry N invalid Parm ID"
+rule unused  VS_TBL_ZERO_ERR_EID  nonzero pad low high
+	"Table entry N parm P not zeroed"
+rule inuse   VS_TBL_PAD_ERR_EID   nonzero pad
+	"Table entry N parm P padding not zeroed"
+rule inuse   VS_TBL_LBND_ERR_EID  outside low
+	"Table entry N parm P invalid low bound"
+rule inuse   VS_TBL_HBND_ERR_EID  outside high
+	"Table entry N parm P invalid high bound"
+rule inuse   VS_TBL_ORDER_ERR_EID greater low high
+	"Table entry N parm P invalid bound order"
+rule inuse   VS_TBL_EXTRA_ERR_EID after_unused
+	"Table entry N parm P follows an unused entry"
+rule inuse   VS_TBL_REDEF_ERR_EID redefines
+	"Table entry N parm P redefines earlier entry"
+
+summary VS_VALIDATION_INF_EID
+	"Table image entries: V valid, I invalid, U unused"
@@ -0,0 +1,41 @@
+# Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+# implied.  See the License for the specific language governing
+# permissions and limitations under the License.
+
+# CMake snippet the VS apps and Tbltest include so that they all agree
+# on the layout of the VS table.  Set VS_TABLE_NUM_ENTRIES for tables
+# with more or fewer entries than the default 4, and VS_PARM_ID_BITS
+# to 16 for wide parm IDs.  See vs_tablestruct.h.  VSC's Grunt program
+# handles only the default layout.
+
+set(VS_TABLE_NUM_ENTRIES 4 CACHE STRING "Entries in the VS app tables")
+set(VS_PARM_ID_BITS 8 CACHE STRING "Width of VS table parm IDs, 8 or 16")
+
+add_definitions(-DVS_TABLE_NUM_ENTRIES=${VS_TABLE_NUM_ENTRIES})
+add_definitions(-DVS_PARM_ID_BITS=${VS_PARM_ID_BITS})
+
+# Set VS_CYCLE_HISTOGRAM to have every VS app keep a histogram of the
+# CPU cycles each validation takes and send it on its DUMP_CYCLES
+# command.  See vs_cycles.h.
+option(VS_CYCLE_HISTOGRAM "VS apps keep validation cycle histograms" OFF)
+if (VS_CYCLE_HISTOGRAM)
+  add_definitions(-DVS_CYCLE_HISTOGRAM)
+endif (VS_CYCLE_HISTOGRAM)
+
+# Set VS_BUILTIN_TABLE to have every VS app compile in its default
+# table image from fsw/tables and load it from memory at startup
+# rather than reading its .tbl file from /cf.  The apps still install
+# the .tbl file for the ground to load.  Each app defines
+# VS_BUILTIN_TABLE for its own sources only, so that its table build
+# still makes the .tbl file.
+option(VS_BUILTIN_TABLE "VS apps compile in their default tables" OFF)
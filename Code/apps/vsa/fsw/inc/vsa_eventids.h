@@ -25,11 +25,14 @@
 #define VSA_CMD_RESET_INF_EID    VS_CMD_RESET_INF_EID
 #define VSA_STARTUP_OK_INF_EID   VS_STARTUP_OK_INF_EID
 #define VSA_VALIDATION_INF_EID   VS_VALIDATION_INF_EID
+#define VSA_STAGE_INF_EID        VS_STAGE_INF_EID
+#define VSA_SCREEN_INF_EID       VS_SCREEN_INF_EID
 
 /* Application error IDs not related to table validation */
 #define VSA_MSG_BAD_CC_ERR_EID   VS_MSG_BAD_CC_ERR_EID
 #define VSA_MSG_BAD_MID_ERR_EID  VS_MSG_BAD_MID_ERR_EID
 #define VSA_PIPE_ERR_EID         VS_PIPE_ERR_EID
+#define VSA_STAGE_ERR_EID        VS_STAGE_ERR_EID
 
 /* Error IDs related to table validation. */
 #define VSA_TBL_ZERO_ERR_EID     VS_TBL_ZERO_ERR_EID
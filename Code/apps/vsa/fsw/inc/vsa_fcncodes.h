@@ -20,5 +20,8 @@
 
 #define VSA_NOOP_CC            1
 #define VSA_RESET_COUNTERS_CC  2
+#define VSA_DUMP_CYCLES_CC     6  /* VS_CYCLE_HISTOGRAM builds only */
+#define VSA_STAGE_CC            8  /* payload: VS_cmd_stage_payload_t */
+#define VSA_SCREEN_CC           9  /* payload: VS_cmd_screen_payload_t */
 
 #endif
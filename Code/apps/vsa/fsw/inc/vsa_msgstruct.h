@@ -20,4 +20,6 @@ typedef VS_tlm_hk_payload_t VSA_tlm_hk_payload_t;
 
 typedef VS_tlm_hk_t VSA_tlm_hk_t;
 
+typedef VS_tlm_report_t VSA_tlm_report_t;
+
 #endif
@@ -43,6 +43,11 @@
 #define VSA_PARM_DIRECTION_MIN VS_PARM_DIRECTION_MIN
 #define VSA_PARM_DIRECTION_MAX VS_PARM_DIRECTION_MAX
 
+#define VSA_PARM_IS_ANIMAL(id)    VS_PARM_IS_ANIMAL(id)
+#define VSA_PARM_IS_DIRECTION(id) VS_PARM_IS_DIRECTION(id)
+
+typedef vs_parm_id_t vsa_parm_id_t;
+
 typedef vs_entry_t vsa_entry_t;
 
 #define VSA_TABLE_NUM_ENTRIES VS_TABLE_NUM_ENTRIES
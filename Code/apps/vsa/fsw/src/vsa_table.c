@@ -14,17 +14,64 @@
  */
 
 /*
- * This file defines the app's table validation function.
+ * This file defines the app's table validation function.  It first
+ * checks the whole image for validity without branching on its
+ * contents, and reports problems entry by entry only if that check
+ * fails.
+ *
+ * Built with VSA_REPORT_TLM defined, the validation function reports
+ * the problems it finds in a single validation report telemetry
+ * message instead of one error event each.
+ *
+ * Built with VSA_DELTA_VALIDATION defined, the validation function
+ * remembers the last image it found valid and checks a new image by
+ * rechecking only the entries that differ from it.
+ *
+ * Built with VSA_DEFERRED_EVENTS defined, the validation function
+ * records the problems it finds and sends their error events only
+ * after it stops timing validation.
+ *
+ * Built with VSA_RESULT_CACHE defined, the validation function keeps
+ * the results of the last few images it validated, and answers an
+ * image it has seen before by sending the same events again.
+ *
+ * Built with VSA_PARALLEL_VF defined, the validation function checks
+ * the rules that concern one entry alone on a pool of ES child tasks,
+ * a chunk of entries at a time, then applies the rules that depend on
+ * earlier entries and reports the problems in one sequential pass.
+ *
+ * Built with VSA_SHORT_EVENTS defined, the validation function sends
+ * each error event with the short-format event ID vs_eventids.h
+ * describes, which names the entry, its parm, and the problem, and
+ * formats no text for it.
  *
  */
 
+#include <string.h>
+#if defined(VSA_RESULT_CACHE) || defined(VSA_PARALLEL_VF)
+#include <stdio.h>
+#endif
+#ifdef VSA_RESULT_CACHE
+#include <stdarg.h>
+#endif
+
 #include "cfe.h"
 #include "common_types.h"
 
 #include "vs_ground.h"
 #include "vs_tablestruct.h"
+#include "vs_msgstruct.h"
+#include "vs_vstats.h"
+#include "vs_cycles.h"
+#include "vs_bounds.h"
+#include "vs_parmset.h"
+#include "vs_parmclass.h"
+#ifdef VSA_RESULT_CACHE
+#include "vs_cache.h"
+#endif
 
 #include "vsa_tablestruct.h"
+#include "vsa_msgstruct.h"
 #include "vs_eventids.h"
 #include "vsa_eventids.h"
 #include "vsa_version.h"      /* for VSA_APP_NAME constant */
@@ -34,10 +81,21 @@
 /* ---------- module private definitions and functions ----------- */
 
 /* VSA_table_init() will ask TBL to initialize the table with values
- * loaded from this file.
+ * loaded from this file, or, in builds with VS_BUILTIN_TABLE, from
+ * the same image compiled into the app from VSA_Prm_default.c.
  */
 #define VSA_DEFAULT_TABLE_FILENAME			\
 	"/cf/VSA_" VSA_RAW_TABLE_NAME "_default.tbl"
+#ifdef VS_BUILTIN_TABLE
+extern vsa_table_t vsa_table_default;
+#define VSA_DEFAULT_TABLE_SRC  CFE_TBL_SRC_ADDRESS
+#define VSA_DEFAULT_TABLE      ((const void *)&vsa_table_default)
+#define VSA_DEFAULT_TABLE_NAME "the built-in default table"
+#else
+#define VSA_DEFAULT_TABLE_SRC  CFE_TBL_SRC_FILE
+#define VSA_DEFAULT_TABLE      VSA_DEFAULT_TABLE_FILENAME
+#define VSA_DEFAULT_TABLE_NAME VSA_DEFAULT_TABLE_FILENAME
+#endif
 
 
 /* TBL expects our VSA_table_validate() function to return CFE_SUCCESS
@@ -47,6 +105,163 @@
 #define VSA_TABLE_INVALID_RESULT (~CFE_SUCCESS)
 
 
+#ifdef VSA_REPORT_TLM
+/* The validation report message VSA_table_validate() fills in and
+ * sends for each table image.
+ */
+static VSA_tlm_report_t VSA_report;
+#endif
+
+
+#ifdef VSA_DEFERRED_EVENTS
+#ifdef VSA_REPORT_TLM
+#error "Define at most one of VSA_REPORT_TLM and VSA_DEFERRED_EVENTS"
+#endif
+#ifndef VSA_DEFERRED_MAX_EVENTS
+#define VSA_DEFERRED_MAX_EVENTS 32
+#endif
+/* The error events report_error() has recorded for the image being
+ * validated, in the order it would have sent them.  Each record holds
+ * the (1-based) number of the entry at fault, its parm ID field, and
+ * the event ID naming the problem.  VSA_table_validate() sends them
+ * once it stops timing validation, so that VSA_VF_PERF_ID measures
+ * validation rather than event formatting and transmission, and it
+ * sends at most VSA_DEFERRED_MAX_EVENTS of them per image.
+ */
+static VS_report_error_t VSA_deferred[VSA_DEFERRED_MAX_EVENTS];
+static unsigned int      VSA_num_deferred = 0;
+#endif
+
+
+#ifdef VSA_SHORT_EVENTS
+#ifdef VSA_REPORT_TLM
+#error "Define at most one of VSA_REPORT_TLM and VSA_SHORT_EVENTS"
+#endif
+#if VSA_TABLE_NUM_ENTRIES > VS_TBL_SHORT_MAX_ENTRIES
+#error "VSA_SHORT_EVENTS event IDs can't number this many entries"
+#endif
+#endif
+
+
+/* The parms seen in the image being validated.  Each pass through the
+ * entries leaves it zeroed again when it's done.
+ */
+static vs_parmset_t VSA_parms_seen;
+
+/* True while VSA_table_screen() runs the detailed path, which then
+ * reports nothing and stops at the first invalid entry.
+ */
+static bool VSA_screening = false;
+
+
+#ifdef VSA_PARALLEL_VF
+#ifdef VSA_DELTA_VALIDATION
+#error "Define at most one of VSA_PARALLEL_VF and VSA_DELTA_VALIDATION"
+#endif
+#ifndef VSA_PARALLEL_WORKERS
+#define VSA_PARALLEL_WORKERS 3      /* child tasks besides our own */
+#endif
+#ifndef VSA_PARALLEL_CHUNK
+#define VSA_PARALLEL_CHUNK 128      /* entries a task claims at once */
+#endif
+#ifndef VSA_PARALLEL_PRIORITY
+#define VSA_PARALLEL_PRIORITY 100   /* ES priority of the workers */
+#endif
+#define VSA_PARALLEL_STACK_SIZE 4096
+#define VSA_PARALLEL_NUM_CHUNKS \
+	((VSA_TABLE_NUM_ENTRIES + VSA_PARALLEL_CHUNK - 1) / VSA_PARALLEL_CHUNK)
+
+/* A set of problems with one entry holds the low byte of each of
+ * their VSA_TBL_*_ERR_EIDs.  The bits run from low to high in the
+ * order the detailed path reports an entry's problems in.
+ */
+#define VSA_PROBLEM(eid)     ((uint8)((eid) & 0xFF))
+#define VSA_PROBLEM_EID(bit) \
+	((uint16)((VSA_TBL_ZERO_ERR_EID & 0xFF00) | (bit)))
+
+/* The pool of worker tasks and the state they share.  For each image,
+ * VSA_table_validate() sets VSA_parallel_table, gives VSA_go_sem once
+ * per worker it needs, checks chunks itself, and then takes
+ * VSA_done_sem once per worker it woke.  Every task claims the next
+ * unchecked chunk under VSA_chunk_mutex until none remain, and stores
+ * each entry's problems in VSA_problems[].  VSA_num_workers counts
+ * the workers VSA_table_init() managed to start.
+ */
+static osal_id_t VSA_chunk_mutex;
+static osal_id_t VSA_go_sem;
+static osal_id_t VSA_done_sem;
+static unsigned int VSA_num_workers = 0;
+static const vsa_table_t *VSA_parallel_table;
+static unsigned int VSA_next_chunk;
+static uint8 VSA_problems[VSA_TABLE_NUM_ENTRIES];
+#endif
+
+
+#ifdef VSA_RESULT_CACHE
+/* The results of the last few images validated.  send_event() records
+ * each event it sends for the image being validated.
+ */
+static vs_cache_t VSA_cache;
+
+
+/* send_event()
+ *
+ * in:     eid  - ID of event to send
+ *         type - type of event to send
+ *         spec - printf-style format of event message, then its args
+ * out:    nothing
+ * return: nothing
+ *
+ * Sends an event, as CFE_EVS_SendEvent() does, and records it in
+ * VSA_cache for the image being validated.
+ *
+ */
+
+static void
+send_event(uint16 eid, uint16 type, const char *spec, ...) {
+
+	char text[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH];  /* event message */
+	va_list args;
+
+	va_start(args, spec);
+	vsnprintf(text, sizeof(text), spec, args);
+	va_end(args);
+
+	VS_cache_record_event(&VSA_cache, eid, type, text);
+	CFE_EVS_SendEvent(eid, type, "%s", text);
+
+} /* send_event() */
+#else
+#define send_event CFE_EVS_SendEvent
+#endif
+
+
+#ifdef VSA_DELTA_VALIDATION
+/* What table_is_valid_delta() knows about the last image found valid:
+ * a copy of the image, how many in-use entries it begins with, and
+ * the parms of those entries.  Every entry of that image was valid,
+ * so there's no per-entry validity to keep.  VSA_delta_changed lists
+ * the entries that differ from it in the image being validated.
+ */
+static bool          VSA_delta_have_base = false;
+static vsa_table_t   VSA_delta_base;
+static unsigned int  VSA_delta_num_inuse;
+static vs_parmset_t  VSA_delta_parms;
+static unsigned int  VSA_delta_changed[VSA_TABLE_NUM_ENTRIES];
+#endif
+
+
+#if !defined(VSA_REPORT_TLM) && !defined(VSA_SHORT_EVENTS)
+/* The names of the parms, indexed by VS_PARM_NAME_*. */
+static const char *VSA_parm_names[VS_PARM_NUM_NAMES] = {
+	"Invalid", "Unused", "Ape", "Bat", "Cat", "Dog",
+	"North", "South", "East", "West",
+#ifdef VS_PARM_WIDE_MIN
+	"Wide animal", "Wide direction",
+#endif
+};
+
+
 /* parm_id_to_string()
  *
  * in:     parm_id - numeric parm ID value
@@ -59,24 +274,164 @@
  */
 
 static const char *
-parm_id_to_string(uint8 parm_id) {
-
-	switch (parm_id) {
-	case VSA_PARM_UNUSED: return "Unused";
-	case VSA_PARM_APE:    return "Ape";
-	case VSA_PARM_BAT:    return "Bat";
-	case VSA_PARM_CAT:    return "Cat";
-	case VSA_PARM_DOG:    return "Dog";
-	case VSA_PARM_NORTH:  return "North";
-	case VSA_PARM_SOUTH:  return "South";
-	case VSA_PARM_EAST:   return "East";
-	case VSA_PARM_WEST:   return "West";
-	default:              return "Invalid";
-	}
+parm_id_to_string(vsa_parm_id_t parm_id) {
+
+	return VSA_parm_names[VS_parm_class(parm_id)->name];
 
 } /* parm_id_to_string() */
 
 
+/* problem_text()
+ *
+ * in:     eid - VSA_TBL_*_ERR_EID event ID naming a validity problem
+ * out:    nothing
+ * return: a description of the problem for the event message.
+ *
+ */
+
+static const char *
+problem_text(uint16 eid) {
+
+	switch (eid) {
+	case VSA_TBL_ZERO_ERR_EID:  return "not zeroed";
+	case VSA_TBL_PARM_ERR_EID:  return "invalid Parm ID";
+	case VSA_TBL_PAD_ERR_EID:   return "padding not zeroed";
+	case VSA_TBL_LBND_ERR_EID:  return "invalid low bound";
+	case VSA_TBL_HBND_ERR_EID:  return "invalid high bound";
+	case VSA_TBL_ORDER_ERR_EID: return "invalid bound order";
+	case VSA_TBL_EXTRA_ERR_EID: return "follows an unused entry";
+	case VSA_TBL_REDEF_ERR_EID: return "redefines earlier entry";
+	default:                    return "invalid";
+	}
+
+} /* problem_text() */
+#endif
+
+
+#ifndef VSA_REPORT_TLM
+/* send_error_event()
+ *
+ * in:     entry   - 1-based number of the table entry at fault
+ *         parm_id - that entry's parm ID field
+ *         eid     - VSA_TBL_*_ERR_EID event ID naming the problem
+ * out:    nothing
+ * return: nothing
+ *
+ * Sends the error event describing one validity problem.  Built with
+ * VSA_SHORT_EVENTS, it folds entry, parm, and problem into the
+ * event's ID rather than its text.
+ *
+ */
+
+static void
+send_error_event(unsigned int entry, vsa_parm_id_t parm_id, uint16 eid) {
+
+#ifdef VSA_SHORT_EVENTS
+	send_event(VS_TBL_SHORT_EID(eid, VS_parm_class(parm_id)->name,
+		entry), CFE_EVS_EventType_ERROR, VS_TBL_SHORT_TEXT);
+#else
+	/* Entries with invalid parm IDs have no parm to name. */
+	if (eid == VSA_TBL_PARM_ERR_EID) {
+		send_event(eid, CFE_EVS_EventType_ERROR,
+			"Table entry %u %s", entry, problem_text(eid));
+	} else {
+		send_event(eid, CFE_EVS_EventType_ERROR,
+			"Table entry %u parm %s %s", entry,
+			parm_id_to_string(parm_id), problem_text(eid));
+	}
+#endif
+
+} /* send_error_event() */
+#endif
+
+
+#ifdef VSA_DEFERRED_EVENTS
+/* send_deferred_events()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: nothing
+ *
+ * Sends the error events report_error() recorded for the image just
+ * validated, in the order it recorded them, and empties VSA_deferred
+ * for the next image.
+ *
+ */
+
+static void
+send_deferred_events(void) {
+
+	unsigned int d;              /* indexes VSA_deferred */
+
+	for (d = 0; d < VSA_num_deferred; d++) {
+		send_error_event(VSA_deferred[d].entry,
+			(vsa_parm_id_t)VSA_deferred[d].parm_id,
+			VSA_deferred[d].eid);
+	}
+	VSA_num_deferred = 0;
+
+} /* send_deferred_events() */
+#endif
+
+
+/* report_error()
+ *
+ * in:     p_table - pointer to table image being validated
+ *         i       - index of the table entry at fault
+ *         eid     - VSA_TBL_*_ERR_EID event ID naming the problem
+ * out:    nothing
+ * return: nothing
+ *
+ * Reports one validity problem with the i'th entry of *p_table.
+ * Normally, this means sending an error event.  Built with
+ * VSA_REPORT_TLM, it instead appends a record to the validation
+ * report message VSA_table_validate() will send when it's done.
+ * Built with VSA_DEFERRED_EVENTS, it appends a record to VSA_deferred
+ * for VSA_table_validate() to send as an event once it's done.  While
+ * VSA_table_screen() runs, it reports nothing.
+ *
+ */
+
+static void
+report_error(const vsa_table_t *p_table, unsigned int i, uint16 eid) {
+
+	const vsa_entry_t *p_entry;   /* points to indexed table entry */
+#ifdef VSA_REPORT_TLM
+	VS_tlm_report_payload_t *p_payload = &(VSA_report.payload);
+#endif
+
+	if (VSA_screening) return;
+
+	p_entry = &(p_table->entries[i]);
+
+#ifdef VSA_REPORT_TLM
+	if (p_payload->num_errors < VS_REPORT_MAX_ERRORS) {
+		p_payload->errors[p_payload->num_errors].entry   =
+			(uint16)(i+1);
+		p_payload->errors[p_payload->num_errors].parm_id =
+			p_entry->parm_id;
+		p_payload->errors[p_payload->num_errors].eid     = eid;
+		p_payload->num_errors++;
+	} else if (p_payload->num_dropped < 0xFF) {
+		p_payload->num_dropped++;
+	}
+#elif defined(VSA_DEFERRED_EVENTS)
+	/* Errors beyond the cap go unreported, though the summary event
+	 * still counts their entries as invalid.
+	 */
+	if (VSA_num_deferred < VSA_DEFERRED_MAX_EVENTS) {
+		VSA_deferred[VSA_num_deferred].entry   = (uint16)(i+1);
+		VSA_deferred[VSA_num_deferred].parm_id = p_entry->parm_id;
+		VSA_deferred[VSA_num_deferred].eid     = eid;
+		VSA_num_deferred++;
+	}
+#else
+	send_error_event(i+1, p_entry->parm_id, eid);
+#endif
+
+} /* report_error() */
+
+
 /* pad_is_valid()
  *
  * in:     p_table - pointer to table image to validate
@@ -98,16 +453,16 @@ static bool
 pad_is_valid(const vsa_table_t *p_table, unsigned int i) {
 
 	const vsa_entry_t *p_entry;   /* points to indexed table entry */
+	uint8 pad = 0xFF;             /* the entry's pad bytes combined */
+	unsigned int k;               /* indexes pad bytes */
 
 	p_entry = &(p_table->entries[i]);
 	
-	if ((p_entry->pad[0] & p_entry->pad[1] & p_entry->pad[2]) == 0x00) {
+	for (k = 0; k < sizeof(p_entry->pad); k++) pad &= p_entry->pad[k];
+	if (pad == 0x00) {
 		return true;
 	}
-	CFE_EVS_SendEvent(VSA_TBL_PAD_ERR_EID,
-		CFE_EVS_EventType_ERROR,
-		"Table entry %u parm %s padding not zeroed", (i+1),
-		parm_id_to_string(p_entry->parm_id));
+	report_error(p_table, i, VSA_TBL_PAD_ERR_EID);
 
 	return false;
 
@@ -146,30 +501,21 @@ bounds_are_valid(const vsa_table_t *p_table, unsigned int i,
 
 	if (!((min <= p_entry->bound_low) && (p_entry->bound_low <= max))) {
 
-		CFE_EVS_SendEvent(VSA_TBL_LBND_ERR_EID,
-			CFE_EVS_EventType_ERROR,
-			"Table entry %u parm %s invalid low bound", (i+1),
-			parm_id_to_string(p_entry->parm_id));
+		report_error(p_table, i, VSA_TBL_LBND_ERR_EID);
 		result = false;
 
 	}
 
 	if (!((min <= p_entry->bound_high) && (p_entry->bound_high <= max))) {
 
-		CFE_EVS_SendEvent(VSA_TBL_HBND_ERR_EID,
-			CFE_EVS_EventType_ERROR,
-			"Table entry %u parm %s invalid high bound", (i+1),
-			parm_id_to_string(p_entry->parm_id));
+		report_error(p_table, i, VSA_TBL_HBND_ERR_EID);
 		result = false;
 
 	}
 
 	if (!(p_entry->bound_low <= p_entry->bound_high)) {
 
-		CFE_EVS_SendEvent(VSA_TBL_ORDER_ERR_EID,
-			CFE_EVS_EventType_ERROR,
-			"Table entry %u parm %s invalid bound order", (i+1),
-			parm_id_to_string(p_entry->parm_id));
+		report_error(p_table, i, VSA_TBL_ORDER_ERR_EID);
 		result = false;
 
 	}
@@ -199,15 +545,16 @@ static bool
 unused_entry_is_valid(const vsa_table_t *p_table, unsigned int i) {
 
 	const vsa_entry_t *p_entry;      /* points to indexed table entry */
+	unsigned int k;                  /* indexes pad bytes */
 	
 	p_entry = &(p_table->entries[i]);
 
 	/* Confirm that all fields are zeroed. */
 	do {  /* using do/while/break as poor man's try/catch */
 	
-		if (p_entry->pad[0])     break;
-		if (p_entry->pad[1])     break;
-		if (p_entry->pad[2])     break;
+		for (k = 0; k < sizeof(p_entry->pad); k++)
+			if (p_entry->pad[k]) break;
+		if (k < sizeof(p_entry->pad)) break;
 		if (p_entry->bound_low)  break;
 		if (p_entry->bound_high) break;
 
@@ -215,9 +562,7 @@ unused_entry_is_valid(const vsa_table_t *p_table, unsigned int i) {
 
 	} while (0);
 		
-	CFE_EVS_SendEvent(VSA_TBL_ZERO_ERR_EID, CFE_EVS_EventType_ERROR,
-		"Table entry %u parm %s not zeroed", (i+1),
-		parm_id_to_string(p_entry->parm_id));
+	report_error(p_table, i, VSA_TBL_ZERO_ERR_EID);
 
 	return false;
 	
@@ -229,7 +574,7 @@ unused_entry_is_valid(const vsa_table_t *p_table, unsigned int i) {
  * in:     p_table      - pointer to table image to validate
  *         i            - index of table entry to validate
  *         saw_valid_unused_flag - see below
- *         parms_seen   - bitfield indicating Parm IDs seen earlier.
+ *         redef_flag   - see below
  *         min          - minimum valid bound value
  *         max          - maximum valid bound value
  * out     nothing
@@ -244,9 +589,9 @@ unused_entry_is_valid(const vsa_table_t *p_table, unsigned int i) {
  *   - If one of the earlier entries in the table is a valid unused
  *     entry, the saw_valid_unused_flag parm must be set.  Otherwise,
  *     it must be clear.
- *   - The parms_seen bitvector must indicate which valid parm IDs
- *     have been used in all earlier table entries, whether their
- *     entries turned out to be valid or not.
+ *   - If one of the earlier entries in the table has the same valid
+ *     parm ID, whether that entry turned out to be valid or not, the
+ *     redef_flag parm must be set.  Otherwise, it must be clear.
  *
  * Side effect: This predicate will emit one or more error events if
  * the entry is not valid.
@@ -255,35 +600,23 @@ unused_entry_is_valid(const vsa_table_t *p_table, unsigned int i) {
 
 static bool
 inuse_entry_is_valid(const vsa_table_t *p_table, unsigned int i,
-	bool saw_valid_unused_flag, uint8 parms_seen,
+	bool saw_valid_unused_flag, bool redef_flag,
 	uint32 min, uint32 max) {
 
-	const vsa_entry_t *p_entry;     /* points to indexed table entry */
 	bool result = true;     /* optimistically presume entry is valid */
 	
-	p_entry = &(p_table->entries[i]);
-
 	if (!pad_is_valid(p_table, i))               result = false;
 	if (!bounds_are_valid(p_table, i, min, max)) result = false;
 
 	/* In-use entries that follow an unused entry are a problem. */
 	if (saw_valid_unused_flag) {
-		CFE_EVS_SendEvent(VSA_TBL_EXTRA_ERR_EID,
-			CFE_EVS_EventType_ERROR,
-			"Table entry %u parm %s follows an unused entry",
-			(i+1), parm_id_to_string(p_entry->parm_id));
+		report_error(p_table, i, VSA_TBL_EXTRA_ERR_EID);
 		result = false;
 	}
 
-	/* Entries that reuse a Parm ID used previously are a problem.
-	 * Use the bits in parms_seen to check.  We've carefully
-	 * defined the parm_id constants to enable this tracking.
-	 */
-	if (parms_seen & p_entry->parm_id) {
-		CFE_EVS_SendEvent(VSA_TBL_REDEF_ERR_EID,
-			CFE_EVS_EventType_ERROR,
-			"Table entry %u parm %s redefines earlier entry",
-			(i+1), parm_id_to_string(p_entry->parm_id));
+	/* Entries that reuse a Parm ID used previously are a problem. */
+	if (redef_flag) {
+		report_error(p_table, i, VSA_TBL_REDEF_ERR_EID);
 		result = false;
 	}
 
@@ -291,7 +624,634 @@ inuse_entry_is_valid(const vsa_table_t *p_table, unsigned int i,
 
 } /* inuse_entry_is_valid() */
 
-	
+/* validate_entries()
+ *
+ * in:     p_table         - pointer to table image to validate
+ * out:    p_count_valid   - set to the number of valid entries
+ *         p_count_invalid - set to the number of invalid entries
+ *         p_count_unused  - set to the number of valid unused entries
+ * return: CFE_SUCCESS if *p_table is valid, else
+ *         VSA_TABLE_INVALID_RESULT.
+ *
+ * The detailed path of VSA_table_validate(): validates each entry in
+ * turn with the helper predicates above, which report each problem
+ * they find.  While VSA_table_screen() runs, it stops at the first
+ * invalid entry, leaving the counts short.
+ *
+ */
+
+static CFE_Status_t
+validate_entries(const vsa_table_t *p_table, unsigned int *p_count_valid,
+	unsigned int *p_count_invalid, unsigned int *p_count_unused) {
+
+	unsigned int i;                    /* indexes parm entries in table */
+	vsa_parm_id_t parm_id;  /* Parm ID of current entry for examination */
+	const vs_parm_class_t *p_class;              /* parm_id's class */
+	bool saw_valid_unused_flag = false;     /* saw a valid unused entry */
+	bool inuse_valid;        /* current in-use entry turned out valid */
+	uint32 redefined;  /* 1 if an earlier entry had the same parm ID */
+	CFE_Status_t result = CFE_SUCCESS;   /* optmistically presume valid */
+
+	*p_count_valid = *p_count_invalid = *p_count_unused = 0;
+
+	/* Validate each entry in the table.  VSA_parms_seen
+	 * remembers the parm of each entry with a valid Parm ID.
+	 */
+	for (i = 0; i < VSA_TABLE_NUM_ENTRIES; i++) {
+
+		parm_id = p_table->entries[i].parm_id; 
+		p_class = VS_parm_class(parm_id);
+		if (p_class->kind == VS_PARM_CLASS_UNUSED) {
+			if (unused_entry_is_valid(p_table, i)) {
+				(*p_count_unused)++;
+				saw_valid_unused_flag = true;
+			} else {
+				(*p_count_invalid)++;
+				result = VSA_TABLE_INVALID_RESULT;
+				if (VSA_screening) break;
+			}
+			continue;
+		}
+
+		if (p_class->kind != VS_PARM_CLASS_INVALID) {
+			redefined = VS_parmset_mark(&VSA_parms_seen, parm_id);
+			inuse_valid = inuse_entry_is_valid(p_table, i,
+				saw_valid_unused_flag, redefined,
+				p_class->min, p_class->max);
+		} else {
+			report_error(p_table, i, VSA_TBL_PARM_ERR_EID);
+			inuse_valid = false;
+		}
+
+		if (inuse_valid) {
+			(*p_count_valid)++;
+		} else {
+			(*p_count_invalid)++;
+			result = VSA_TABLE_INVALID_RESULT;
+			if (VSA_screening) break;
+		}
+
+	} /* for all entries in table */
+
+	VS_parmset_clear(&VSA_parms_seen, p_table->entries,
+		VSA_TABLE_NUM_ENTRIES);
+	return result;
+
+} /* validate_entries() */
+
+
+#ifndef VSA_PARALLEL_VF
+/* table_is_valid_quick()
+ *
+ * in:     p_table      - pointer to table image to validate
+ * out:    p_num_unused - set to the number of unused entries if the
+ *                        image is valid, else unchanged
+ * return: true if *p_table is certainly valid, else false.
+ *
+ * A fast path for the common case of a valid image.  It checks every
+ * rule the helper predicates above check, for all entries, using
+ * comparisons whose results are combined as 0/1 values and bitmasks
+ * rather than branched on.  The bounds of up to 32 entries at a time
+ * are checked at once by the vector kernel in vs_bounds.h, and
+ * VSA_parms_seen records the parms seen so far.  It never sends
+ * events.
+ *
+ * It is stricter than the detailed path: it demands padding whose
+ * bytes are all zero.  A false result means only that the caller
+ * must run the detailed path to find and report the problems, if
+ * there are any.
+ *
+ */
+
+static bool
+table_is_valid_quick(const vsa_table_t *p_table, unsigned int *p_num_unused) {
+
+	const vsa_entry_t *p_entry;  /* points to indexed table entry */
+	unsigned int i;              /* indexes parm entries in table */
+	unsigned int k;              /* indexes pad bytes */
+	uint32 parm_id, pad, low, high;
+	uint32 unused;               /* 1 if this entry is unused, else 0 */
+	uint32 id_ok;                /* 1 if a valid in-use parm ID, else 0 */
+	uint32 inuse_ok;             /* 1 if a valid in-use entry, else 0 */
+	uint32 bounds_ok = 0;        /* bit i%32 set if entry i's bounds ok */
+	uint32 bad = 0;              /* nonzero once any entry is invalid */
+	uint32 saw_unused = 0;       /* 1 once we've seen an unused entry */
+	uint32 redefined;            /* 1 if an earlier entry had this parm */
+	unsigned int num_unused = 0;
+
+	for (i = 0; i < VSA_TABLE_NUM_ENTRIES; i++) {
+
+		if ((i % 32) == 0) {
+			bounds_ok = VS_bounds_mask(&(p_table->entries[i]),
+				((VSA_TABLE_NUM_ENTRIES - i) < 32) ?
+				(VSA_TABLE_NUM_ENTRIES - i) : 32);
+		}
+
+		p_entry = &(p_table->entries[i]);
+		parm_id = p_entry->parm_id;
+		for (pad = 0, k = 0; k < sizeof(p_entry->pad); k++)
+			pad |= p_entry->pad[k];
+		low     = p_entry->bound_low;
+		high    = p_entry->bound_high;
+
+		unused = (parm_id == VSA_PARM_UNUSED);
+
+		/* One of the named parms has exactly one parm ID bit set;
+		 * any wide parm ID is valid.
+		 */
+		id_ok = ((parm_id & (parm_id - 1)) == 0);
+#ifdef VS_PARM_WIDE_MIN
+		id_ok |= (parm_id >= VS_PARM_WIDE_MIN);
+#endif
+		redefined = VS_parmset_mark(&VSA_parms_seen,
+			(vsa_parm_id_t)parm_id);
+
+		/* A valid parm ID, padding zeroed, bounds in range and
+		 * in order, no unused entry before it, and no earlier
+		 * entry with the same parm.
+		 */
+		inuse_ok = id_ok & (pad == 0) & ((bounds_ok >> (i % 32)) & 1) &
+			(saw_unused == 0) & (redefined == 0);
+
+		/* An unused entry must be entirely zeroed; any other
+		 * entry must be a valid in-use entry.
+		 */
+		bad |= (unused & ((pad | low | high) != 0)) |
+			((unused ^ 1) & (inuse_ok ^ 1));
+
+		saw_unused |= unused;
+		num_unused += unused;
+	}
+
+	VS_parmset_clear(&VSA_parms_seen, p_table->entries,
+		VSA_TABLE_NUM_ENTRIES);
+	if (bad) return false;
+	*p_num_unused = num_unused;
+	return true;
+
+} /* table_is_valid_quick() */
+#endif
+
+
+#ifdef VSA_PARALLEL_VF
+/* entry_problems()
+ *
+ * in:     p_entry - table entry to check
+ * out:    nothing
+ * return: the set of problems the rules about p_entry alone find
+ *
+ * Checks the ZERO, PARM, PAD, LBND, HBND, and ORDER rules just as the
+ * helper predicates above do, down to pad_is_valid()'s test of the
+ * padding, but reports nothing.  The EXTRA and REDEF rules depend on
+ * earlier entries, so validate_parallel() applies those.  Safe to run
+ * on any task.
+ *
+ */
+
+static uint8
+entry_problems(const vsa_entry_t *p_entry) {
+
+	const vs_parm_class_t *p_class = VS_parm_class(p_entry->parm_id);
+	uint8 pad_all = 0xFF;   /* the entry's pad bytes ANDed */
+	uint8 pad_any = 0x00;   /* the entry's pad bytes ORed */
+	uint32 min = p_class->min;  /* valid bound range for the parm */
+	uint32 max = p_class->max;
+	uint8 problems = 0;
+	unsigned int k;         /* indexes pad bytes */
+
+	for (k = 0; k < sizeof(p_entry->pad); k++) {
+		pad_all &= p_entry->pad[k];
+		pad_any |= p_entry->pad[k];
+	}
+
+	if (p_class->kind == VS_PARM_CLASS_UNUSED) {
+		if (pad_any || p_entry->bound_low || p_entry->bound_high)
+			return VSA_PROBLEM(VSA_TBL_ZERO_ERR_EID);
+		return 0;
+	}
+	if (p_class->kind == VS_PARM_CLASS_INVALID)
+		return VSA_PROBLEM(VSA_TBL_PARM_ERR_EID);
+
+	if (pad_all != 0x00)
+		problems |= VSA_PROBLEM(VSA_TBL_PAD_ERR_EID);
+	if (!((min <= p_entry->bound_low) && (p_entry->bound_low <= max)))
+		problems |= VSA_PROBLEM(VSA_TBL_LBND_ERR_EID);
+	if (!((min <= p_entry->bound_high) && (p_entry->bound_high <= max)))
+		problems |= VSA_PROBLEM(VSA_TBL_HBND_ERR_EID);
+	if (!(p_entry->bound_low <= p_entry->bound_high))
+		problems |= VSA_PROBLEM(VSA_TBL_ORDER_ERR_EID);
+
+	return problems;
+
+} /* entry_problems() */
+
+
+/* check_chunks()
+ *
+ * in:     VSA_parallel_table - image to check
+ * out:    VSA_problems       - problems of each entry in the chunks
+ *                              this task claimed
+ * return: nothing
+ *
+ * Phase one of validate_parallel(), run by every task taking part:
+ * claims unchecked chunks of VSA_parallel_table's entries one at a
+ * time and checks each entry in them, until no chunk remains.
+ *
+ */
+
+static void
+check_chunks(void) {
+
+	const vsa_table_t *p_table = VSA_parallel_table;
+	unsigned int chunk;      /* chunk this task claimed */
+	unsigned int i, end;     /* index entries in the chunk */
+
+	for (;;) {
+		OS_MutSemTake(VSA_chunk_mutex);
+		chunk = VSA_next_chunk++;
+		OS_MutSemGive(VSA_chunk_mutex);
+		if (chunk >= VSA_PARALLEL_NUM_CHUNKS) break;
+
+		i   = chunk * VSA_PARALLEL_CHUNK;
+		end = i + VSA_PARALLEL_CHUNK;
+		if (end > VSA_TABLE_NUM_ENTRIES) end = VSA_TABLE_NUM_ENTRIES;
+		for (; i < end; i++) {
+			VSA_problems[i] =
+				entry_problems(&(p_table->entries[i]));
+		}
+	}
+
+} /* check_chunks() */
+
+
+/* VSA_table_worker()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: nothing
+ *
+ * The main function of each worker task VSA_table_init() starts.
+ * Each time VSA_table_validate() gives VSA_go_sem, one worker checks
+ * chunks alongside it and then gives VSA_done_sem.
+ *
+ */
+
+static void
+VSA_table_worker(void) {
+
+	while (OS_SUCCESS == OS_CountSemTake(VSA_go_sem)) {
+		check_chunks();
+		OS_CountSemGive(VSA_done_sem);
+	}
+
+	CFE_ES_ExitChildTask();
+
+} /* VSA_table_worker() */
+
+
+/* parallel_init()
+ *
+ * in:     nothing
+ * out:    VSA_num_workers - set to the number of workers started
+ * return: nothing
+ *
+ * Creates the semaphores the workers share and starts up to
+ * VSA_PARALLEL_WORKERS of them.  VSA_table_validate() checks every
+ * chunk itself when fewer start, so failing here isn't fatal.
+ *
+ */
+
+static void
+parallel_init(void) {
+
+	CFE_ES_TaskId_t task_id;        /* ID of a worker we started */
+	char name[OS_MAX_API_NAME];     /* name of that worker */
+	int32 result;
+	unsigned int w;
+
+	if ((OS_SUCCESS != (result = OS_MutSemCreate(&VSA_chunk_mutex,
+		"VSA_CHUNK_MUT", 0))) ||
+		(OS_SUCCESS != (result = OS_CountSemCreate(&VSA_go_sem,
+			"VSA_GO_SEM", 0, 0))) ||
+		(OS_SUCCESS != (result = OS_CountSemCreate(&VSA_done_sem,
+			"VSA_DONE_SEM", 0, 0)))) {
+		CFE_ES_WriteToSysLog("%s: OSAL semaphore create returned %d"
+			"; %s will validate on its own task.\n", VSA_APP_NAME,
+			(int)result, VSA_APP_NAME);
+		return;
+	}
+
+	for (w = 0; w < VSA_PARALLEL_WORKERS; w++) {
+		snprintf(name, sizeof(name), "VSA_WORKER_%u", w);
+		if (CFE_SUCCESS != (result = CFE_ES_CreateChildTask(&task_id,
+			name, VSA_table_worker, CFE_ES_TASK_STACK_ALLOCATE,
+			VSA_PARALLEL_STACK_SIZE, VSA_PARALLEL_PRIORITY, 0))) {
+			CFE_ES_WriteToSysLog("%s: CFE_ES_CreateChildTask() "
+				"returned 0x%08X; %s will validate with %u "
+				"workers.\n", VSA_APP_NAME, (unsigned)result,
+				VSA_APP_NAME, w);
+			break;
+		}
+		VSA_num_workers++;
+	}
+
+} /* parallel_init() */
+
+
+/* validate_parallel()
+ *
+ * in:     p_table         - pointer to table image to validate
+ * out:    p_count_valid   - set to the number of valid entries
+ *         p_count_invalid - set to the number of invalid entries
+ *         p_count_unused  - set to the number of valid unused entries
+ * return: CFE_SUCCESS if *p_table is valid, else
+ *         VSA_TABLE_INVALID_RESULT.
+ *
+ * The two-phase path of VSA_table_validate(), which reaches the same
+ * verdict as validate_entries() and reports the same problems in the
+ * same order.  Phase one checks the rules about each entry alone on
+ * the workers and this task at once.  Phase two walks the entries in
+ * order, applies the EXTRA and REDEF rules, which depend on the
+ * entries before, and reports each entry's problems.  Only phase one
+ * grows faster with more workers, but it does nearly all the work.
+ * Workers aren't woken for chunks this task would check anyway.
+ *
+ */
+
+static CFE_Status_t
+validate_parallel(const vsa_table_t *p_table, unsigned int *p_count_valid,
+	unsigned int *p_count_invalid, unsigned int *p_count_unused) {
+
+	unsigned int wake;           /* workers to wake */
+	unsigned int i;              /* indexes workers, entries, problems */
+	vsa_parm_id_t parm_id;       /* Parm ID of current entry */
+	uint8 problems;              /* current entry's problems */
+	bool saw_valid_unused_flag = false;  /* saw a valid unused entry */
+	CFE_Status_t result = CFE_SUCCESS;   /* optmistically presume valid */
+
+	*p_count_valid = *p_count_invalid = *p_count_unused = 0;
+
+	/* Phase one. */
+	VSA_parallel_table = p_table;
+	VSA_next_chunk = 0;
+	wake = VSA_num_workers;
+	if (wake > (VSA_PARALLEL_NUM_CHUNKS - 1))
+		wake = VSA_PARALLEL_NUM_CHUNKS - 1;
+	for (i = 0; i < wake; i++) OS_CountSemGive(VSA_go_sem);
+	check_chunks();
+	for (i = 0; i < wake; i++) OS_CountSemTake(VSA_done_sem);
+
+	/* Phase two.  VSA_parms_seen remembers the parm of each entry
+	 * with a valid Parm ID, as in validate_entries().
+	 */
+	for (i = 0; i < VSA_TABLE_NUM_ENTRIES; i++) {
+
+		parm_id  = p_table->entries[i].parm_id;
+		problems = VSA_problems[i];
+		if (parm_id == VSA_PARM_UNUSED) {
+			if (!problems) saw_valid_unused_flag = true;
+		} else if (!(problems &
+			VSA_PROBLEM(VSA_TBL_PARM_ERR_EID))) {
+			if (saw_valid_unused_flag)
+				problems |= VSA_PROBLEM(VSA_TBL_EXTRA_ERR_EID);
+			if (VS_parmset_mark(&VSA_parms_seen, parm_id))
+				problems |= VSA_PROBLEM(VSA_TBL_REDEF_ERR_EID);
+		}
+
+		if (!problems) {
+			if (parm_id == VSA_PARM_UNUSED) {
+				(*p_count_unused)++;
+			} else {
+				(*p_count_valid)++;
+			}
+			continue;
+		}
+
+		(*p_count_invalid)++;
+		result = VSA_TABLE_INVALID_RESULT;
+		for (; problems; problems &= (uint8)(problems - 1)) {
+			report_error(p_table, i, VSA_PROBLEM_EID(problems &
+				(uint8)-problems));
+		}
+
+	} /* for all entries in table */
+
+	VS_parmset_clear(&VSA_parms_seen, p_table->entries,
+		VSA_TABLE_NUM_ENTRIES);
+	return result;
+
+} /* validate_parallel() */
+#endif
+
+
+#ifdef VSA_DELTA_VALIDATION
+/* entry_is_valid_quick()
+ *
+ * in:     p_entry - table entry to validate
+ * out:    nothing
+ * return: true if *p_entry is certainly valid on its own, else false.
+ *
+ * Checks the rules that concern only the entry itself, as strictly
+ * as table_is_valid_quick() checks them: a valid unused entry is all
+ * zeroes, and a valid in-use entry has a valid parm ID, zeroed
+ * padding, and bounds in range and in order.  It never sends events.
+ *
+ */
+
+static bool
+entry_is_valid_quick(const vsa_entry_t *p_entry) {
+
+	const vs_parm_class_t *p_class = VS_parm_class(p_entry->parm_id);
+	uint32 low     = p_entry->bound_low;
+	uint32 high    = p_entry->bound_high;
+	uint32 pad;
+	unsigned int k;               /* indexes pad bytes */
+
+	for (pad = 0, k = 0; k < sizeof(p_entry->pad); k++)
+		pad |= p_entry->pad[k];
+
+	if (p_class->kind == VS_PARM_CLASS_UNUSED)
+		return ((pad | low | high) == 0);
+	if (p_class->kind == VS_PARM_CLASS_INVALID)
+		return false;
+
+	return ((pad == 0) && (p_class->min <= low) && (low <= high) &&
+		(high <= p_class->max));
+
+} /* entry_is_valid_quick() */
+
+
+/* table_is_valid_delta()
+ *
+ * in:     p_table      - pointer to table image to validate
+ * out:    p_num_unused - set to the number of unused entries if the
+ *                        image is valid, else unchanged
+ * return: true if *p_table is certainly valid, else false.
+ *
+ * A faster path than table_is_valid_quick() for images that differ
+ * from the last image found valid in only a few entries, as most
+ * loads do.  Every unchanged entry passed every rule last time, so it
+ * rechecks each changed entry on its own, and then the rules that
+ * span entries only where the changes could break them:
+ *
+ *   - In-use entries must still come first.  The count of in-use
+ *     entries moves by the changes, and each changed entry must be in
+ *     use exactly if it falls within the new count.  Any entries
+ *     between the old count and the new one must all have changed.
+ *   - No parm may be defined twice.  VSA_delta_parms holds the parms
+ *     of the last valid image; it swaps the changed entries' old
+ *     parms for their new ones, and any new parm already present is
+ *     a redefinition.
+ *
+ * On success it makes *p_table the new last valid image by copying
+ * just the changed entries.  On failure it leaves that image as it
+ * was, and the caller must run the detailed path.  Like
+ * table_is_valid_quick() it is stricter than the detailed path about
+ * padding, and it never sends events.
+ *
+ */
+
+static bool
+table_is_valid_delta(const vsa_table_t *p_table, unsigned int *p_num_unused) {
+
+	const vsa_entry_t *p_new, *p_old;   /* changed entry, new and old */
+	unsigned int i, j;         /* index parm entries in table */
+	unsigned int c;            /* indexes VSA_delta_changed */
+	unsigned int block;        /* number of entries compared at once */
+	unsigned int num_changed = 0;
+	unsigned int num_inuse = VSA_delta_num_inuse;   /* in the new image */
+	unsigned int lo, hi;       /* entries whose use may have flipped */
+	unsigned int num_between = 0;   /* changed entries in [lo, hi) */
+
+	if (!VSA_delta_have_base) return false;
+
+	/* Find the changed entries, skipping runs of identical ones. */
+	for (i = 0; i < VSA_TABLE_NUM_ENTRIES; i += block) {
+		block = ((VSA_TABLE_NUM_ENTRIES - i) < 32) ?
+			(VSA_TABLE_NUM_ENTRIES - i) : 32;
+		if (!memcmp(&(p_table->entries[i]),
+			&(VSA_delta_base.entries[i]),
+			block * sizeof(vsa_entry_t))) continue;
+		for (j = i; j < (i + block); j++) {
+			if (memcmp(&(p_table->entries[j]),
+				&(VSA_delta_base.entries[j]),
+				sizeof(vsa_entry_t)))
+				VSA_delta_changed[num_changed++] = j;
+		}
+	}
+
+	/* Check each changed entry on its own, and count in-use
+	 * entries in the new image.
+	 */
+	for (c = 0; c < num_changed; c++) {
+		p_new = &(p_table->entries[VSA_delta_changed[c]]);
+		p_old = &(VSA_delta_base.entries[VSA_delta_changed[c]]);
+		if (!entry_is_valid_quick(p_new)) return false;
+		if (p_old->parm_id == VSA_PARM_UNUSED) num_inuse++;
+		if (p_new->parm_id == VSA_PARM_UNUSED) num_inuse--;
+	}
+
+	/* In-use entries must still come before all unused ones. */
+	lo = (num_inuse < VSA_delta_num_inuse) ? num_inuse :
+		VSA_delta_num_inuse;
+	hi = (num_inuse < VSA_delta_num_inuse) ? VSA_delta_num_inuse :
+		num_inuse;
+	for (c = 0; c < num_changed; c++) {
+		j = VSA_delta_changed[c];
+		if ((p_table->entries[j].parm_id != VSA_PARM_UNUSED) !=
+			(j < num_inuse)) return false;
+		if ((lo <= j) && (j < hi)) num_between++;
+	}
+	if (num_between != (hi - lo)) return false;
+
+	/* No new parm may already be defined.  Swap the changed
+	 * entries' old parms for their new ones, and put the old ones
+	 * back if we find a redefinition.
+	 */
+	for (c = 0; c < num_changed; c++) {
+		p_old = &(VSA_delta_base.entries[VSA_delta_changed[c]]);
+		if (p_old->parm_id != VSA_PARM_UNUSED)
+			VS_parmset_unmark(&VSA_delta_parms, p_old->parm_id);
+	}
+	for (c = 0; c < num_changed; c++) {
+		p_new = &(p_table->entries[VSA_delta_changed[c]]);
+		if ((p_new->parm_id != VSA_PARM_UNUSED) &&
+			VS_parmset_mark(&VSA_delta_parms, p_new->parm_id))
+			break;
+	}
+	if (c < num_changed) {
+		while (c-- > 0) {
+			p_new = &(p_table->entries[VSA_delta_changed[c]]);
+			if (p_new->parm_id != VSA_PARM_UNUSED)
+				VS_parmset_unmark(&VSA_delta_parms,
+					p_new->parm_id);
+		}
+		for (c = 0; c < num_changed; c++) {
+			p_old = &(VSA_delta_base.entries[
+				VSA_delta_changed[c]]);
+			if (p_old->parm_id != VSA_PARM_UNUSED)
+				(void)VS_parmset_mark(&VSA_delta_parms,
+					p_old->parm_id);
+		}
+		return false;
+	}
+
+	/* Valid.  It's the new last valid image. */
+	for (c = 0; c < num_changed; c++) {
+		VSA_delta_base.entries[VSA_delta_changed[c]] =
+			p_table->entries[VSA_delta_changed[c]];
+	}
+	VSA_delta_num_inuse = num_inuse;
+	*p_num_unused = VSA_TABLE_NUM_ENTRIES - num_inuse;
+	return true;
+
+} /* table_is_valid_delta() */
+
+
+/* delta_rebase()
+ *
+ * in:     p_table    - pointer to table image found valid
+ *         num_unused - number of unused entries in *p_table
+ * out:    nothing
+ * return: nothing
+ *
+ * Makes *p_table the last valid image table_is_valid_delta() diffs
+ * new images against.
+ *
+ */
+
+static void
+delta_rebase(const vsa_table_t *p_table, unsigned int num_unused) {
+
+	unsigned int i;              /* indexes parm entries in table */
+
+	if (VSA_delta_have_base) {
+		VS_parmset_clear(&VSA_delta_parms, VSA_delta_base.entries,
+			VSA_TABLE_NUM_ENTRIES);
+	}
+	memcpy(&VSA_delta_base, p_table, sizeof(VSA_delta_base));
+	VSA_delta_num_inuse = VSA_TABLE_NUM_ENTRIES - num_unused;
+	for (i = 0; i < VSA_delta_num_inuse; i++) {
+		(void)VS_parmset_mark(&VSA_delta_parms,
+			VSA_delta_base.entries[i].parm_id);
+	}
+	VSA_delta_have_base = true;
+
+} /* delta_rebase() */
+#endif
+
+
+/* The statistics VSA_table_validate_timed() keeps on the
+ * validations TBL asks for, for housekeeping telemetry, and the cycle
+ * histogram it keeps on them in VS_CYCLE_HISTOGRAM builds.
+ */
+static VS_vstats_t VSA_vstats;
+static VS_tlm_cycles_payload_t VSA_cycles;
+#ifdef VS_CYCLE_HISTOGRAM
+static VS_tlm_cycles_t VSA_cycles_msg;   /* VSA_table_dump_cycles() */
+#endif
+
+
 /* -------------------- module exported functions ------------------ */
 
 
@@ -321,6 +1281,15 @@ inuse_entry_is_valid(const vsa_table_t *p_table, unsigned int i,
  *       for entry 0 will come first, then those for entry 1, and so
  *       on.  Any events emitted for a given entry will appear in the
  *       order of their VSA_TBL_*_ERR_EID numeric constants.
+ *       Built with VSA_REPORT_TLM, it will instead send a single
+ *       VSA_TLM_REPORT_MID validation report message holding one
+ *       record per problem, in that same order.  It sends this
+ *       message even for valid images, with no records.
+ *       Built with VSA_DEFERRED_EVENTS, it will send the same
+ *       events in the same order, but only once it has finished
+ *       validating, and no more than VSA_DEFERRED_MAX_EVENTS of them.
+ *       Built with VSA_SHORT_EVENTS, it will send the same events
+ *       in the same order, but with short-format event IDs.
  *
  *   (2) It will then use CFE_EVS_SendEvent() to send a
  *       CFE_EVS_EventType_INFORMATION event reporting the number of
@@ -359,94 +1328,186 @@ static CFE_Status_t     /* static b/c fxn is exported by pointer not linker */
 VSA_table_validate(void *TblData) {
 
 	const vsa_table_t *p_table = (const vsa_table_t *)TblData; /* table */
-	unsigned int i;                    /* indexes parm entries in table */
-	uint8 parm_id;    /* holds Parm ID of current entry for examination */
-	bool saw_valid_unused_flag = false;     /* saw a valid unused entry */
-	uint8 parms_seen = 0;  /*  indicates which parms have valid entries */
 	CFE_Status_t result = CFE_SUCCESS;   /* optmistically presume valid */
 	unsigned int count_unused  = 0;    /* number of unused parm entries */
 	unsigned int count_valid   = 0;     /* number of valid parm entries */
 	unsigned int count_invalid = 0;   /* number of invalid parm entries */
+#ifdef VSA_RESULT_CACHE
+	const vs_cache_slot_t *p_slot;   /* cached result for this image */
+#endif
 
 	/* Mark the start of validation function processing for
 	 * performance monitoring.
 	 */
 	CFE_ES_PerfLogEntry(VSA_VF_PERF_ID);
-	
-	/* Validate each entry in the table. */
-	for (i = 0; i < VSA_TABLE_NUM_ENTRIES; i++) {
 
-		parm_id = p_table->entries[i].parm_id; 
-		switch (parm_id) {
-		case VSA_PARM_UNUSED:
-			if (unused_entry_is_valid(p_table, i)) {
-				count_unused++;
-				saw_valid_unused_flag = true;
-			} else {
-				count_invalid++;
-				result = VSA_TABLE_INVALID_RESULT;
-			}
-			break;
-		
-		case VSA_PARM_APE:
-		case VSA_PARM_BAT:
-		case VSA_PARM_CAT:
-		case VSA_PARM_DOG:
-			if (inuse_entry_is_valid(p_table, i,
-				saw_valid_unused_flag, parms_seen,
-				VSA_PARM_ANIMAL_MIN, VSA_PARM_ANIMAL_MAX)) {
-				count_valid++;
-			} else {
-				count_invalid++;
-				result = VSA_TABLE_INVALID_RESULT;
-			}
-			/* remember this entry's parm */
-			parms_seen |= parm_id;
-			break;
-
-		case VSA_PARM_NORTH:
-		case VSA_PARM_SOUTH:
-		case VSA_PARM_EAST:
-		case VSA_PARM_WEST:
-			if (inuse_entry_is_valid(p_table, i,
-				saw_valid_unused_flag, parms_seen,
-				VSA_PARM_DIRECTION_MIN,
-				VSA_PARM_DIRECTION_MAX)) {
-				count_valid++;
-			} else {
-				count_invalid++;
-				result = VSA_TABLE_INVALID_RESULT;
-			}
-			/* remember this entry's parm */
-			parms_seen |= parm_id;
-			break;
-
-		default:
-			CFE_EVS_SendEvent(VSA_TBL_PARM_ERR_EID,
-				CFE_EVS_EventType_ERROR,
-				"Table entry %u invalid Parm ID", (i+1));
-			count_invalid++;
-			result = VSA_TABLE_INVALID_RESULT;
+#ifdef VSA_RESULT_CACHE
+	/* If we've validated this very image lately, send what we sent
+	 * then and return the same result.  Otherwise, record what we
+	 * send this time.
+	 */
+	if (NULL != (p_slot = VS_cache_lookup(&VSA_cache, p_table))) {
+#ifdef VSA_REPORT_TLM
+		if (p_slot->has_report) {
+			memcpy(&(VSA_report.payload), &(p_slot->report),
+				sizeof(VSA_report.payload));
+			CFE_SB_TimeStampMsg(CFE_MSG_PTR(VSA_report.header));
+			CFE_SB_TransmitMsg(CFE_MSG_PTR(VSA_report.header),
+				true);
 		}
+#endif
+#ifdef VSA_DEFERRED_EVENTS
+		CFE_ES_PerfLogExit(VSA_VF_PERF_ID);
+		return VS_cache_replay(p_slot);
+#else
+		result = VS_cache_replay(p_slot);
+		CFE_ES_PerfLogExit(VSA_VF_PERF_ID);
+		return result;
+#endif
+	}
+	VS_cache_begin(&VSA_cache, p_table);
+#endif
 
-	} /* for all entries in table */
+#ifdef VSA_REPORT_TLM
+	memset(&(VSA_report.payload), 0, sizeof(VSA_report.payload));
+#endif
+	
+#ifdef VSA_PARALLEL_VF
+	/* The two-phase path checks every entry as fast as the quick
+	 * check would, so it goes first and last.
+	 */
+	result = validate_parallel(p_table, &count_valid, &count_invalid,
+		&count_unused);
+#else
+	/* Most images are valid, so check for that quickly first.
+	 * Only if the quick check fails do we validate each entry in
+	 * turn, reporting the problems we find.
+	 */
+#ifdef VSA_DELTA_VALIDATION
+	/* Once there's a last valid image to diff against, the delta
+	 * check decides exactly what the quick check would, so a
+	 * failed delta check goes straight to the detailed path.
+	 */
+	if (table_is_valid_delta(p_table, &count_unused)) {
+		count_valid = VSA_TABLE_NUM_ENTRIES - count_unused;
+	} else if (!VSA_delta_have_base &&
+		table_is_valid_quick(p_table, &count_unused)) {
+		count_valid = VSA_TABLE_NUM_ENTRIES - count_unused;
+		delta_rebase(p_table, count_unused);
+	} else {
+#else
+	if (table_is_valid_quick(p_table, &count_unused)) {
+		count_valid = VSA_TABLE_NUM_ENTRIES - count_unused;
+	} else {
+#endif
+		result = validate_entries(p_table, &count_valid,
+			&count_invalid, &count_unused);
+	}
+#endif
 	
+#ifdef VSA_REPORT_TLM
+	/* Send the errors we found ahead of the statistics event. */
+	CFE_SB_TimeStampMsg(CFE_MSG_PTR(VSA_report.header));
+	CFE_SB_TransmitMsg(CFE_MSG_PTR(VSA_report.header), true);
+#ifdef VSA_RESULT_CACHE
+	VS_cache_record_report(&VSA_cache, &(VSA_report.payload));
+#endif
+#endif
+
+#ifdef VSA_DEFERRED_EVENTS
+	/* Mark the stop of validation function processing for
+	 * performance monitoring, and only then send the error events
+	 * we recorded along the way.
+	 */
+	CFE_ES_PerfLogExit(VSA_VF_PERF_ID);
+	send_deferred_events();
+#endif
+
 	/* Send validation function statistics event. */
-	CFE_EVS_SendEvent(VSA_VALIDATION_INF_EID,
+	send_event(VSA_VALIDATION_INF_EID,
 		CFE_EVS_EventType_INFORMATION, "Table image entries: "
 		"%u valid, %u invalid, %u unused",
 		count_valid, count_invalid, count_unused);
 
+#ifdef VSA_RESULT_CACHE
+	VS_cache_end(&VSA_cache, result);
+#endif
+
+#ifndef VSA_DEFERRED_EVENTS
 	/* Mark the stop of validation function processing for
 	 * performance monitoring.
 	 */
 	CFE_ES_PerfLogExit(VSA_VF_PERF_ID);
+#endif
 	
 	return result;
 
 } /* VSA_table_validate() */
 
 
+/* VSA_table_validate_timed()
+ *
+ * in:     TblData - pointer to table image to validate
+ * out:    nothing
+ * return: VSA_table_validate()'s result.
+ *
+ * The validation function we register with TBL.  It runs
+ * VSA_table_validate() and records its result and how long it took
+ * in VSA_vstats, and the cycles it took in VSA_cycles.
+ *
+ */
+
+static CFE_Status_t     /* static b/c fxn is exported by pointer not linker */
+VSA_table_validate_timed(void *TblData) {
+
+	OS_time_t start;       /* when validation began */
+	uint64 cycles;         /* cycle counter when validation began */
+	CFE_Status_t result;   /* VSA_table_validate()'s verdict */
+
+	VS_vstats_start(&start);
+	cycles = VS_cycles_now();
+	result = VSA_table_validate(TblData);
+	VS_cycles_record(&VSA_cycles, cycles);
+	VS_vstats_record(&VSA_vstats, start, result);
+
+	return result;
+
+} /* VSA_table_validate_timed() */
+
+
+/* VSA_table_screen()
+ *
+ * in:     p_image - table image to screen
+ * out:    nothing
+ * return: true if VSA_table_validate() would find the image valid,
+ *         else false.
+ *
+ * The app's SCREEN command calls this function for each image the
+ * ground asks about.  It runs validate_entries() with VSA_screening
+ * set, so it sends no events and stops at the first invalid entry
+ * rather than judging them all.  The verdict is VSA_table_validate()'s
+ * own, down to its treatment of padding.  Screening leaves VSA_vstats
+ * and the validation result cache alone; only TBL's validations
+ * count there.
+ *
+ */
+
+bool
+VSA_table_screen(const vs_table_t *p_image) {
+
+	unsigned int count_valid, count_invalid, count_unused;
+	CFE_Status_t result;
+
+	VSA_screening = true;
+	result = validate_entries(p_image, &count_valid, &count_invalid,
+		&count_unused);
+	VSA_screening = false;
+
+	return (result == CFE_SUCCESS);
+
+} /* VSA_table_screen() */
+
+
 /* VSA_table_init()
  *
  * in:     nothing
@@ -464,22 +1525,38 @@ VSA_table_init(CFE_TBL_Handle_t *p_h_table) {
 
 	CFE_Status_t result;  /* holds error codes returned by functions */
 
+#ifdef VSA_REPORT_TLM
+	/* Initialize our validation report message before TBL first
+	 * calls our validation function.
+	 */
+	CFE_MSG_Init(CFE_MSG_PTR(VSA_report.header),
+		CFE_SB_ValueToMsgId(VSA_TLM_REPORT_MID),
+		sizeof(VSA_tlm_report_t));
+#endif
+
+#ifdef VSA_PARALLEL_VF
+	/* Start our workers before TBL first calls our validation
+	 * function.
+	 */
+	parallel_init();
+#endif
+
 	/* Register our single vsa_table_t table with TBL. */
 	if (CFE_SUCCESS != (result = CFE_TBL_Register(p_h_table,
 		VSA_RAW_TABLE_NAME, sizeof(vsa_table_t), CFE_TBL_OPT_DEFAULT,
-		VSA_table_validate))) {
+		VSA_table_validate_timed))) {
 		CFE_ES_WriteToSysLog("%s: CFE_TBL_Register() returned 0x%08X"
 			"; %s will shutdown.\n", VSA_APP_NAME, result,
 			VSA_APP_NAME);
 		return result;
 	}
 
-	/* Load the default table values from the filesystem. */
+	/* Load the default table values. */
 	if (CFE_SUCCESS != (result = CFE_TBL_Load(*p_h_table,
-		CFE_TBL_SRC_FILE, VSA_DEFAULT_TABLE_FILENAME))) {
+		VSA_DEFAULT_TABLE_SRC, VSA_DEFAULT_TABLE))) {
 		CFE_ES_WriteToSysLog("%s: CFE_TBL_Load() of %s returned 0x%08X"
 			"; %s will shutdown.\n", VSA_APP_NAME,
-			VSA_DEFAULT_TABLE_FILENAME, result,
+			VSA_DEFAULT_TABLE_NAME, result,
 			VSA_APP_NAME);
 		return result;
 	}
@@ -489,3 +1566,61 @@ VSA_table_init(CFE_TBL_Handle_t *p_h_table) {
 } /* VSA_table_init() */
 
 
+/* VSA_table_get_stats()
+ *
+ * in:     nothing
+ * out:    p_stats - set to the validation statistics so far
+ * return: nothing
+ *
+ * The app calls this function to fill in its housekeeping telemetry.
+ *
+ */
+
+void
+VSA_table_get_stats(VS_vstats_t *p_stats) {
+
+	*p_stats = VSA_vstats;
+
+} /* VSA_table_get_stats() */
+
+
+/* VSA_table_reset_stats()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: nothing
+ *
+ * The app calls this function when it resets its counters.
+ *
+ */
+
+void
+VSA_table_reset_stats(void) {
+
+	VS_vstats_reset(&VSA_vstats);
+	VS_cycles_reset(&VSA_cycles);
+
+} /* VSA_table_reset_stats() */
+
+
+#ifdef VS_CYCLE_HISTOGRAM
+/* VSA_table_dump_cycles()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: nothing
+ *
+ * The app calls this function to handle the VSA_DUMP_CYCLES_CC
+ * command.  It sends VSA_cycles in a VSA_TLM_CYCLES_MID message.
+ *
+ */
+
+void
+VSA_table_dump_cycles(void) {
+
+	VS_cycles_send(&VSA_cycles_msg, VSA_TLM_CYCLES_MID, &VSA_cycles);
+
+} /* VSA_table_dump_cycles() */
+#endif
+
+
@@ -16,6 +16,12 @@
  * permissions and limitations under the License.
  */
 
+#include "vs_msgstruct.h"    /* for VS_vstats_t */
+
 CFE_Status_t VSA_table_init(CFE_TBL_Handle_t *);
+void VSA_table_get_stats(VS_vstats_t *);
+void VSA_table_reset_stats(void);
+void VSA_table_dump_cycles(void);
+bool VSA_table_screen(const vs_table_t *);
 
 #endif
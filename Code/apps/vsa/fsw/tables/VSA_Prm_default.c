@@ -20,37 +20,23 @@
  * file into a .tbl table image file, and then installs that .tbl
  * image file in the simulated spacecraft's filesystem.
  *
- * The build system does not include this code in the flight software
- * that runs aboard the spacecraft.
+ * Unless built with VS_BUILTIN_TABLE, the build system does not
+ * include this code in the flight software that runs aboard the
+ * spacecraft.
  */
 
 #include "cfe_tbl_filedef.h"
 #include "vs_tablestruct.h"
 #include "vsa_tablestruct.h"
 
+/* All of the table's VS_TABLE_NUM_ENTRIES entries are unused.  C
+ * zeroes the first entry's padding and all the entries after it,
+ * which is what an unused entry must be.
+ */
 vsa_table_t vsa_table_default = {
 	.entries = {
 		{
-			.parm_id = (unsigned char)VSA_PARM_UNUSED,
-			.pad = { 0x00, 0x00, 0x00 },
-			.bound_low  = 0,
-			.bound_high = 0
-		},
-		{
-			.parm_id = (unsigned char)VSA_PARM_UNUSED,
-			.pad = { 0x00, 0x00, 0x00 },
-			.bound_low  = 0,
-			.bound_high = 0
-		},
-		{
-			.parm_id = (unsigned char)VSA_PARM_UNUSED,
-			.pad = { 0x00, 0x00, 0x00 },
-			.bound_low  = 0,
-			.bound_high = 0
-		},
-		{
-			.parm_id = (unsigned char)VSA_PARM_UNUSED,
-			.pad = { 0x00, 0x00, 0x00 },
+			.parm_id = (vsa_parm_id_t)VSA_PARM_UNUSED,
 			.bound_low  = 0,
 			.bound_high = 0
 		}
@@ -62,6 +48,11 @@ vsa_table_t vsa_table_default = {
  * syncrhonized with the app's VSA_APP_NAME, VSA_RAW_TABLE_NAME, and
  * VSA_DEFAULT_TABLE_FILENAME constants.  Note that the filename here
  * is just the last component; it doesn't start with "/cf/".
+ *
+ * Builds with VS_BUILTIN_TABLE also compile this file into the app,
+ * which needs only vsa_table_default.
  */
+#ifndef VS_BUILTIN_TABLE
 CFE_TBL_FILEDEF(vsa_table_default, VSA_APP.Prm, VSA default empty table,
 	VSA_Prm_default.tbl)
+#endif
@@ -20,5 +20,7 @@
 
 #define VSB_NOOP_CC            1
 #define VSB_RESET_COUNTERS_CC  2
+#define VSB_DUMP_CYCLES_CC     6  /* VS_CYCLE_HISTOGRAM builds only */
+#define VSB_STAGE_CC            8  /* payload: VS_cmd_stage_payload_t */
 
 #endif
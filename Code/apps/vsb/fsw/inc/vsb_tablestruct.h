@@ -43,6 +43,11 @@
 #define VSB_PARM_DIRECTION_MIN VS_PARM_DIRECTION_MIN
 #define VSB_PARM_DIRECTION_MAX VS_PARM_DIRECTION_MAX
 
+#define VSB_PARM_IS_ANIMAL(id)    VS_PARM_IS_ANIMAL(id)
+#define VSB_PARM_IS_DIRECTION(id) VS_PARM_IS_DIRECTION(id)
+
+typedef vs_parm_id_t vsb_parm_id_t;
+
 typedef vs_entry_t vsb_entry_t;
 
 #define VSB_TABLE_NUM_ENTRIES VS_TABLE_NUM_ENTRIES
@@ -0,0 +1,225 @@
+#ifndef _VSB_RULES_H_
+#define _VSB_RULES_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* GENERATED FILE - DO NOT EDIT.
+ *
+ * The vsrules generator generated this file from the validation rules
+ * in vs_rules.spec.  Edit the rules and run vsrules again instead.
+ */
+
+/* This file defines vsb_rules_validate(), a native table validation
+ * function that applies the rules in vs_rules.spec, and the functions
+ * it needs.  It makes one pass over the table, checking every rule
+ * for each entry's kind at once and sending events only for entries
+ * that break some rule.
+ */
+
+#include "cfe.h"
+
+#include "vs_tablestruct.h"
+#include "vs_eventids.h"
+#include "vs_parmset.h"
+
+
+/* The parms of the in-use entries seen in the image being validated.
+ * Each validation leaves it zeroed again when it's done.
+ */
+static vs_parmset_t vsb_rules_parms_seen;
+
+
+/* vsb_rules_parm_name()
+ *
+ * in:     parm_id - numeric parm ID value
+ * out:    nothing
+ * return: the name event messages use for parm_id.
+ */
+
+static const char *
+vsb_rules_parm_name(vs_parm_id_t parm_id) {
+
+#ifdef VS_PARM_WIDE_MIN
+	if (parm_id >= VS_PARM_WIDE_DIRECTION_MIN) return "Wide direction";
+	if (parm_id >= VS_PARM_WIDE_MIN) return "Wide animal";
+#endif
+
+	switch (parm_id) {
+	case VS_PARM_UNUSED: return "Unused";
+	case VS_PARM_APE:    return "Ape";
+	case VS_PARM_BAT:    return "Bat";
+	case VS_PARM_CAT:    return "Cat";
+	case VS_PARM_DOG:    return "Dog";
+	case VS_PARM_NORTH:  return "North";
+	case VS_PARM_SOUTH:  return "South";
+	case VS_PARM_EAST:   return "East";
+	case VS_PARM_WEST:   return "West";
+	default:             return "Invalid";
+	}
+
+} /* vsb_rules_parm_name() */
+
+
+/* vsb_rules_validate()
+ *
+ * in:     p_table - pointer to table image to validate
+ * out:    nothing
+ * return: true if *p_table is valid, else false.
+ *
+ * Sends an error event for each rule each entry breaks, then one
+ * event summing up the entries.
+ */
+
+static bool
+vsb_rules_validate(const vs_table_t *p_table) {
+
+	const vs_entry_t *p_entry;  /* points to indexed table entry */
+	uint32 pad, low, high;      /* the entry's fields */
+	uint32 min, max;            /* range of the entry's class */
+	uint32 caught;              /* bit r set if rule r holds */
+	uint32 saw_unused = 0;      /* 1 once a valid unused entry is seen */
+	uint32 redefined;           /* 1 if an earlier entry had this parm */
+	unsigned int num_valid = 0, num_invalid = 0, num_unused = 0;
+	unsigned int i;             /* indexes table entries */
+	unsigned int k;             /* indexes pad bytes */
+
+	for (i = 0; i < VS_TABLE_NUM_ENTRIES; i++) {
+
+		p_entry = &(p_table->entries[i]);
+		for (pad = 0, k = 0; k < sizeof(p_entry->pad); k++)
+			pad |= p_entry->pad[k];
+		low  = p_entry->bound_low;
+		high = p_entry->bound_high;
+
+		switch (p_entry->parm_id) {
+		case VS_PARM_UNUSED:
+			caught = ((uint32)((pad | low | high) != 0) << 0);
+			if (!caught) {
+				num_unused++;
+				saw_unused = 1;
+				continue;
+			}
+			if (caught & 0x1u)
+				CFE_EVS_SendEvent(VS_TBL_ZERO_ERR_EID,
+					CFE_EVS_EventType_ERROR,
+					"Table entry %u parm Unused not zeroed",
+					(i + 1));
+			num_invalid++;
+			continue;
+		case VS_PARM_APE:
+		case VS_PARM_BAT:
+		case VS_PARM_CAT:
+		case VS_PARM_DOG:
+			min = VS_PARM_ANIMAL_MIN;
+			max = VS_PARM_ANIMAL_MAX;
+			break;
+		case VS_PARM_NORTH:
+		case VS_PARM_SOUTH:
+		case VS_PARM_EAST:
+		case VS_PARM_WEST:
+			min = VS_PARM_DIRECTION_MIN;
+			max = VS_PARM_DIRECTION_MAX;
+			break;
+		default:
+#ifdef VS_PARM_WIDE_MIN
+			if (p_entry->parm_id >= VS_PARM_WIDE_DIRECTION_MIN) {
+				min = VS_PARM_DIRECTION_MIN;
+				max = VS_PARM_DIRECTION_MAX;
+				break;
+			}
+			if (p_entry->parm_id >= VS_PARM_WIDE_MIN) {
+				min = VS_PARM_ANIMAL_MIN;
+				max = VS_PARM_ANIMAL_MAX;
+				break;
+			}
+#endif
+			caught = ((uint32)1 << 0);
+			if (caught & 0x1u)
+				CFE_EVS_SendEvent(VS_TBL_PARM_ERR_EID,
+					CFE_EVS_EventType_ERROR,
+					"Table entry %u invalid Parm ID",
+					(i + 1));
+			num_invalid++;
+			continue;
+		}
+
+		redefined = VS_parmset_mark(&vsb_rules_parms_seen,
+			p_entry->parm_id);
+		caught = ((uint32)(pad != 0) << 0)
+			| ((uint32)((low < min) | (low > max)) << 1)
+			| ((uint32)((high < min) | (high > max)) << 2)
+			| ((uint32)(low > high) << 3)
+			| ((uint32)saw_unused << 4)
+			| ((uint32)redefined << 5);
+		if (!caught) {
+			num_valid++;
+			continue;
+		}
+		if (caught & 0x1u)
+			CFE_EVS_SendEvent(VS_TBL_PAD_ERR_EID,
+				CFE_EVS_EventType_ERROR,
+				"Table entry %u parm %s padding not zeroed",
+				(i + 1),
+				vsb_rules_parm_name(p_entry->parm_id));
+		if (caught & 0x2u)
+			CFE_EVS_SendEvent(VS_TBL_LBND_ERR_EID,
+				CFE_EVS_EventType_ERROR,
+				"Table entry %u parm %s invalid low bound",
+				(i + 1),
+				vsb_rules_parm_name(p_entry->parm_id));
+		if (caught & 0x4u)
+			CFE_EVS_SendEvent(VS_TBL_HBND_ERR_EID,
+				CFE_EVS_EventType_ERROR,
+				"Table entry %u parm %s invalid high bound",
+				(i + 1),
+				vsb_rules_parm_name(p_entry->parm_id));
+		if (caught & 0x8u)
+			CFE_EVS_SendEvent(VS_TBL_ORDER_ERR_EID,
+				CFE_EVS_EventType_ERROR,
+				"Table entry %u parm %s invalid bound order",
+				(i + 1),
+				vsb_rules_parm_name(p_entry->parm_id));
+		if (caught & 0x10u)
+			CFE_EVS_SendEvent(VS_TBL_EXTRA_ERR_EID,
+				CFE_EVS_EventType_ERROR,
+				"Table entry %u parm %s follows an unused entry",
+				(i + 1),
+				vsb_rules_parm_name(p_entry->parm_id));
+		if (caught & 0x20u)
+			CFE_EVS_SendEvent(VS_TBL_REDEF_ERR_EID,
+				CFE_EVS_EventType_ERROR,
+				"Table entry %u parm %s redefines earlier entry",
+				(i + 1),
+				vsb_rules_parm_name(p_entry->parm_id));
+		num_invalid++;
+
+	} /* for all entries in table */
+
+	VS_parmset_clear(&vsb_rules_parms_seen, p_table->entries,
+		VS_TABLE_NUM_ENTRIES);
+	CFE_EVS_SendEvent(VS_VALIDATION_INF_EID,
+		CFE_EVS_EventType_INFORMATION,
+		"Table image entries: %u valid, %u invalid, %u unused",
+		num_valid,
+		num_invalid,
+		num_unused);
+
+	return (num_invalid == 0);
+
+} /* vsb_rules_validate() */
+
+
+#endif
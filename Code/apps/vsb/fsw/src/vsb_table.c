@@ -23,21 +23,36 @@
 
 #include "vs_ground.h"
 #include "vs_tablestruct.h"
+#include "vs_msgstruct.h"
+#include "vs_vstats.h"
+#include "vs_cycles.h"
 
 #include "vsb_tablestruct.h"
 #include "vs_eventids.h"
 #include "vsb_eventids.h"
 #include "vsb_version.h"      /* for VSB_APP_NAME constant */
 #include "vsb_table.h"
+#include "vsb_rules.h"        /* vsrules translation of vs_rules.spec */
 
 
 /* ---------- module private definitions and functions ----------- */
 
 /* VSB_table_init() will ask TBL to initialize the table with values
- * loaded from this file.
+ * loaded from this file, or, in builds with VS_BUILTIN_TABLE, from
+ * the same image compiled into the app from VSB_Prm_default.c.
  */
 #define VSB_DEFAULT_TABLE_FILENAME			\
 	"/cf/VSB_" VSB_RAW_TABLE_NAME "_default.tbl"
+#ifdef VS_BUILTIN_TABLE
+extern vsb_table_t vsb_table_default;
+#define VSB_DEFAULT_TABLE_SRC  CFE_TBL_SRC_ADDRESS
+#define VSB_DEFAULT_TABLE      ((const void *)&vsb_table_default)
+#define VSB_DEFAULT_TABLE_NAME "the built-in default table"
+#else
+#define VSB_DEFAULT_TABLE_SRC  CFE_TBL_SRC_FILE
+#define VSB_DEFAULT_TABLE      VSB_DEFAULT_TABLE_FILENAME
+#define VSB_DEFAULT_TABLE_NAME VSB_DEFAULT_TABLE_FILENAME
+#endif
 
 
 /* TBL expects our VSB_table_validate() function to return CFE_SUCCESS
@@ -47,6 +62,17 @@
 #define VSB_TABLE_INVALID_RESULT (~CFE_SUCCESS)
 
 	
+/* The statistics VSB_table_validate_timed() keeps on the
+ * validations TBL asks for, for housekeeping telemetry, and the cycle
+ * histogram it keeps on them in VS_CYCLE_HISTOGRAM builds.
+ */
+static VS_vstats_t VSB_vstats;
+static VS_tlm_cycles_payload_t VSB_cycles;
+#ifdef VS_CYCLE_HISTOGRAM
+static VS_tlm_cycles_t VSB_cycles_msg;   /* VSB_table_dump_cycles() */
+#endif
+
+
 /* -------------------- module exported functions ------------------ */
 
 
@@ -72,34 +98,19 @@ static CFE_Status_t     /* static b/c fxn is exported by pointer not linker */
 VSB_table_validate(void *TblData) {
 
 	const vsb_table_t *p_table = (const vsb_table_t *)TblData; /* table */
-	CFE_Status_t result = CFE_SUCCESS;   /* optmistically presume valid */
-	unsigned int count_unused  = 0;    /* number of unused parm entries */
-	unsigned int count_valid   = 0;     /* number of valid parm entries */
-	unsigned int count_invalid = 0;   /* number of invalid parm entries */
-	unsigned int i;                         /* index into table entries */
+	CFE_Status_t result;              /* CFE_SUCCESS if image is valid */
 	
 	/* Mark the start of validation function processing for
 	 * performance monitoring.
 	 */
 	CFE_ES_PerfLogEntry(VSB_VF_PERF_ID);
-	
 
-	/*  Here is some wildly incorrect validation logic as an
-	 *  example.  Correct logic might fit nicely here.
+	/* vsb_rules_validate() checks the image against the rules in
+	 * vs_rules.spec, sending an event for each problem it finds
+	 * and then the validation function statistics event.
 	 */
-	for (i = 0; i < VSB_TABLE_NUM_ENTRIES; i++) {
-		if (p_table->entries[ i ].parm_id == VS_PARM_UNUSED) {
-			count_unused++;
-		} else {
-			count_valid++;
-		}
-	}
-	
-	/* Send validation function statistics event. */
-	CFE_EVS_SendEvent(VSB_VALIDATION_INF_EID,
-		CFE_EVS_EventType_INFORMATION, "Table image entries: "
-		"%u valid, %u invalid, %u unused",
-		count_valid, count_invalid, count_unused);
+	result = (vsb_rules_validate(p_table) ? CFE_SUCCESS :
+		VSB_TABLE_INVALID_RESULT);
 
 	/* Mark the stop of validation function processing for
 	 * performance monitoring.
@@ -111,6 +122,36 @@ VSB_table_validate(void *TblData) {
 } /* VSB_table_validate() */
 
 
+/* VSB_table_validate_timed()
+ *
+ * in:     TblData - pointer to table image to validate
+ * out:    nothing
+ * return: VSB_table_validate()'s result.
+ *
+ * The validation function we register with TBL.  It runs
+ * VSB_table_validate() and records its result and how long it took
+ * in VSB_vstats, and the cycles it took in VSB_cycles.
+ *
+ */
+
+static CFE_Status_t     /* static b/c fxn is exported by pointer not linker */
+VSB_table_validate_timed(void *TblData) {
+
+	OS_time_t start;       /* when validation began */
+	uint64 cycles;         /* cycle counter when validation began */
+	CFE_Status_t result;   /* VSB_table_validate()'s verdict */
+
+	VS_vstats_start(&start);
+	cycles = VS_cycles_now();
+	result = VSB_table_validate(TblData);
+	VS_cycles_record(&VSB_cycles, cycles);
+	VS_vstats_record(&VSB_vstats, start, result);
+
+	return result;
+
+} /* VSB_table_validate_timed() */
+
+
 /* VSB_table_init()
  *
  * in:     nothing
@@ -131,19 +172,19 @@ VSB_table_init(CFE_TBL_Handle_t *p_h_table) {
 	/* Register our single vsb_table_t table with TBL. */
 	if (CFE_SUCCESS != (result = CFE_TBL_Register(p_h_table,
 		VSB_RAW_TABLE_NAME, sizeof(vsb_table_t), CFE_TBL_OPT_DEFAULT,
-		VSB_table_validate))) {
+		VSB_table_validate_timed))) {
 		CFE_ES_WriteToSysLog("%s: CFE_TBL_Register() returned 0x%08X"
 			"; %s will shutdown.\n", VSB_APP_NAME, result,
 			VSB_APP_NAME);
 		return result;
 	}
 
-	/* Load the default table values from the filesystem. */
+	/* Load the default table values. */
 	if (CFE_SUCCESS != (result = CFE_TBL_Load(*p_h_table,
-		CFE_TBL_SRC_FILE, VSB_DEFAULT_TABLE_FILENAME))) {
+		VSB_DEFAULT_TABLE_SRC, VSB_DEFAULT_TABLE))) {
 		CFE_ES_WriteToSysLog("%s: CFE_TBL_Load() of %s returned 0x%08X"
 			"; %s will shutdown.\n", VSB_APP_NAME,
-			VSB_DEFAULT_TABLE_FILENAME, result,
+			VSB_DEFAULT_TABLE_NAME, result,
 			VSB_APP_NAME);
 		return result;
 	}
@@ -153,3 +194,61 @@ VSB_table_init(CFE_TBL_Handle_t *p_h_table) {
 } /* VSB_table_init() */
 
 
+/* VSB_table_get_stats()
+ *
+ * in:     nothing
+ * out:    p_stats - set to the validation statistics so far
+ * return: nothing
+ *
+ * The app calls this function to fill in its housekeeping telemetry.
+ *
+ */
+
+void
+VSB_table_get_stats(VS_vstats_t *p_stats) {
+
+	*p_stats = VSB_vstats;
+
+} /* VSB_table_get_stats() */
+
+
+/* VSB_table_reset_stats()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: nothing
+ *
+ * The app calls this function when it resets its counters.
+ *
+ */
+
+void
+VSB_table_reset_stats(void) {
+
+	VS_vstats_reset(&VSB_vstats);
+	VS_cycles_reset(&VSB_cycles);
+
+} /* VSB_table_reset_stats() */
+
+
+#ifdef VS_CYCLE_HISTOGRAM
+/* VSB_table_dump_cycles()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: nothing
+ *
+ * The app calls this function to handle the VSB_DUMP_CYCLES_CC
+ * command.  It sends VSB_cycles in a VSB_TLM_CYCLES_MID message.
+ *
+ */
+
+void
+VSB_table_dump_cycles(void) {
+
+	VS_cycles_send(&VSB_cycles_msg, VSB_TLM_CYCLES_MID, &VSB_cycles);
+
+} /* VSB_table_dump_cycles() */
+#endif
+
+
@@ -16,6 +16,11 @@
  * permissions and limitations under the License.
  */
 
+#include "vs_msgstruct.h"    /* for VS_vstats_t */
+
 CFE_Status_t VSB_table_init(CFE_TBL_Handle_t *);
+void VSB_table_get_stats(VS_vstats_t *);
+void VSB_table_reset_stats(void);
+void VSB_table_dump_cycles(void);
 
 #endif
@@ -20,37 +20,23 @@
  * file into a .tbl table image file, and then installs that .tbl
  * image file in the simulated spacecraft's filesystem.
  *
- * The build system does not include this code in the flight software
- * that runs aboard the spacecraft.
+ * Unless built with VS_BUILTIN_TABLE, the build system does not
+ * include this code in the flight software that runs aboard the
+ * spacecraft.
  */
 
 #include "cfe_tbl_filedef.h"
 #include "vs_tablestruct.h"
 #include "vsb_tablestruct.h"
 
+/* All of the table's VS_TABLE_NUM_ENTRIES entries are unused.  C
+ * zeroes the first entry's padding and all the entries after it,
+ * which is what an unused entry must be.
+ */
 vsb_table_t vsb_table_default = {
 	.entries = {
 		{
-			.parm_id = (unsigned char)VSB_PARM_UNUSED,
-			.pad = { 0x00, 0x00, 0x00 },
-			.bound_low  = 0,
-			.bound_high = 0
-		},
-		{
-			.parm_id = (unsigned char)VSB_PARM_UNUSED,
-			.pad = { 0x00, 0x00, 0x00 },
-			.bound_low  = 0,
-			.bound_high = 0
-		},
-		{
-			.parm_id = (unsigned char)VSB_PARM_UNUSED,
-			.pad = { 0x00, 0x00, 0x00 },
-			.bound_low  = 0,
-			.bound_high = 0
-		},
-		{
-			.parm_id = (unsigned char)VSB_PARM_UNUSED,
-			.pad = { 0x00, 0x00, 0x00 },
+			.parm_id = (vsb_parm_id_t)VSB_PARM_UNUSED,
 			.bound_low  = 0,
 			.bound_high = 0
 		}
@@ -62,6 +48,11 @@ vsb_table_t vsb_table_default = {
  * syncrhonized with the app's VSB_APP_NAME, VSB_RAW_TABLE_NAME, and
  * VSB_DEFAULT_TABLE_FILENAME constants.  Note that the filename here
  * is just the last component; it doesn't start with "/cf/".
+ *
+ * Builds with VS_BUILTIN_TABLE also compile this file into the app,
+ * which needs only vsb_table_default.
  */
+#ifndef VS_BUILTIN_TABLE
 CFE_TBL_FILEDEF(vsb_table_default, VSB_APP.Prm, VSB default empty table,
 	VSB_Prm_default.tbl)
+#endif
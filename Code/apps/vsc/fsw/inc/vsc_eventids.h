@@ -25,11 +25,19 @@
 #define VSC_CMD_RESET_INF_EID    VS_CMD_RESET_INF_EID
 #define VSC_STARTUP_OK_INF_EID   VS_STARTUP_OK_INF_EID
 #define VSC_VALIDATION_INF_EID   VS_VALIDATION_INF_EID
+#define VSC_BATCH_INF_EID        VS_BATCH_INF_EID
+#define VSC_ENGINE_INF_EID       VS_ENGINE_INF_EID
+#define VSC_STAGE_INF_EID        VS_STAGE_INF_EID
+#define VSC_SCREEN_INF_EID       VS_SCREEN_INF_EID
+#define VSC_PROGRAM_INF_EID      VS_PROGRAM_INF_EID
 
 /* Application error IDs not related to table validation */
 #define VSC_MSG_BAD_CC_ERR_EID   VS_MSG_BAD_CC_ERR_EID
 #define VSC_MSG_BAD_MID_ERR_EID  VS_MSG_BAD_MID_ERR_EID
 #define VSC_PIPE_ERR_EID         VS_PIPE_ERR_EID
+#define VSC_CMD_BAD_ARG_ERR_EID  VS_CMD_BAD_ARG_ERR_EID
+#define VSC_STAGE_ERR_EID        VS_STAGE_ERR_EID
+#define VSC_PROGRAM_ERR_EID      VS_PROGRAM_ERR_EID
 
 /* Error IDs related to table validation. */
 #define VSC_TBL_ZERO_ERR_EID     VS_TBL_ZERO_ERR_EID
@@ -20,5 +20,14 @@
 
 #define VSC_NOOP_CC            1
 #define VSC_RESET_COUNTERS_CC  2
+#define VSC_VALIDATE_BATCH_CC  3  /* payload: VSC_cmd_batch_payload_t */
+#define VSC_DUMP_PROFILE_CC    4  /* GRUNT_PROFILE builds only */
+#define VSC_SET_ENGINE_CC      5  /* payload: VSC_cmd_engine_payload_t */
+#define VSC_DUMP_CYCLES_CC     6  /* VS_CYCLE_HISTOGRAM builds only */
+#define VSC_DUMP_TRACE_CC      7  /* GRUNT_TRACE builds only; payload: */
+                                  /*   VSC_cmd_trace_payload_t        */
+#define VSC_STAGE_CC            8  /* payload: VS_cmd_stage_payload_t */
+#define VSC_SCREEN_CC           9  /* payload: VS_cmd_screen_payload_t */
+#define VSC_LOAD_PROGRAM_CC    10  /* payload: VSC_cmd_program_payload_t */
 
 #endif
@@ -20,4 +20,147 @@ typedef VS_tlm_hk_payload_t VSC_tlm_hk_payload_t;
 
 typedef VS_tlm_hk_t VSC_tlm_hk_t;
 
+typedef VS_tlm_report_t VSC_tlm_report_t;
+
+/* The VSC_VALIDATE_BATCH_CC ground command names a set of candidate
+ * table files the ground has staged on the spacecraft's filesystem.
+ * VSC validates them all on its next housekeeping cycle and reports
+ * which are valid in a single event.  Unused filenames should be
+ * zeroed.
+ */
+#define VSC_BATCH_MAX_IMAGES 4
+
+typedef struct {
+	uint8 num_images;   /* number of filenames in use, 1 or more */
+	uint8 pad[3];       /* unused; pads filenames to 32-bits */
+	char  filenames[VSC_BATCH_MAX_IMAGES][CFE_MISSION_MAX_PATH_LEN];
+} VSC_cmd_batch_payload_t;
+
+typedef struct {
+	CFE_MSG_CommandHeader_t header;
+	VSC_cmd_batch_payload_t payload;
+} VSC_cmd_batch_t;
+
+/* The VSC_SET_ENGINE_CC ground command switches the engine VSC
+ * validates tables with to one of the VS_ENGINE_* engines other than
+ * VS_ENGINE_C.  The engine field of VSC's housekeeping telemetry
+ * shows the one in use.
+ */
+typedef struct {
+	uint8 engine;       /* VS_ENGINE_* engine to switch to */
+	uint8 pad[3];       /* unused; pads payload to 32-bits */
+} VSC_cmd_engine_payload_t;
+
+typedef struct {
+	CFE_MSG_CommandHeader_t  header;
+	VSC_cmd_engine_payload_t payload;
+} VSC_cmd_engine_t;
+
+/* The VSC_LOAD_PROGRAM_CC ground command names a file on the
+ * spacecraft's filesystem holding a Grunt validation program in the
+ * serialized format grunt.h describes, such as grunt_serialize
+ * writes.  If the program fits, reads, and verifies, VSC validates
+ * tables with it from then on on its Grunt engines, and switches to
+ * VS_ENGINE_GRUNT.  VSC loads one program per start; restart the app
+ * to go back to its built-in program or to load another.
+ */
+#define VSC_PROGRAM_MAX_BYTES        4096
+#define VSC_PROGRAM_MAX_INSTRUCTIONS 1024
+#define VSC_PROGRAM_MAX_STRINGS      64
+#define VSC_PROGRAM_MAX_STRING_SPACE 2048
+
+typedef struct {
+	char filename[CFE_MISSION_MAX_PATH_LEN];   /* NUL-terminated */
+} VSC_cmd_program_payload_t;
+
+typedef struct {
+	CFE_MSG_CommandHeader_t   header;
+	VSC_cmd_program_payload_t payload;
+} VSC_cmd_program_t;
+
+/* VSC built with GRUNT_PROFILE answers the VSC_DUMP_PROFILE_CC ground
+ * command by sending the execution profile the Grunt interpreter has
+ * kept while running VSC's validation program (see grunt.h) and then
+ * clearing it.  The profile goes out as a series of profile messages,
+ * one for each VSC_PROFILE_PCS_PER_MSG instructions of the program.
+ * Every message in the series carries the same per-opcode totals and
+ * tick histogram; each carries the execution counts of its own run of
+ * program counters.
+ */
+#define VSC_PROFILE_NUM_OPCODES 40    /* GRUNT_PROFILE_NUM_OPCODES */
+#define VSC_PROFILE_NUM_BUCKETS 16    /* GRUNT_PROFILE_NUM_BUCKETS */
+#define VSC_PROFILE_PCS_PER_MSG 128
+
+typedef struct {
+	uint32 count;          /* executions of the opcode */
+	uint32 samples;        /* executions timed */
+	uint32 mean_ticks;     /* mean ticks of the timed executions */
+} VSC_profile_op_t;
+
+typedef struct {
+	uint8  seq;            /* number of this message in the series */
+	uint8  num_msgs;       /* number of messages in the series */
+	uint16 first_pc;       /* program counter of pc_count[0] */
+	uint16 num_pcs;        /* entries in use in pc_count[] */
+	uint16 pad;            /* unused; pads counts to 32-bits */
+	uint32 runs;           /* validation program runs profiled */
+	uint32 instructions;   /* instructions executed */
+	uint32 samples;        /* instructions timed */
+	VSC_profile_op_t ops[VSC_PROFILE_NUM_OPCODES];   /* by opcode */
+	uint32 histogram[VSC_PROFILE_NUM_BUCKETS];  /* [b]: 2^b ticks */
+	uint32 pc_count[VSC_PROFILE_PCS_PER_MSG];   /* executions */
+} VSC_tlm_profile_payload_t;
+
+typedef struct {
+	CFE_MSG_TelemetryHeader_t header;
+	VSC_tlm_profile_payload_t payload;
+} VSC_tlm_profile_t;
+
+/* VSC built with GRUNT_TRACE answers the VSC_DUMP_TRACE_CC ground
+ * command by sending the last num_steps steps of the trace the Grunt
+ * interpreter keeps while running VSC's validation program (see
+ * grunt.h), oldest first, or as many as it has kept if num_steps is
+ * 0 or more than that.  The steps go out as a series of trace
+ * messages of up to VSC_TRACE_STEPS_PER_MSG steps each.  Each step's
+ * type is a Grunt value type (0 Boolean, 1 number, 2 string) whose
+ * payload is in top, VSC_TRACE_EMPTY if the arg stack was empty, or
+ * VSC_TRACE_END for the step that ends a run, whose top holds the
+ * run's status.  The trace keeps running; a later dump may repeat
+ * steps this one sent.
+ */
+#define VSC_TRACE_STEPS_PER_MSG 64
+#define VSC_TRACE_EMPTY         0xFE  /* GRUNT_TRACE_EMPTY */
+#define VSC_TRACE_END           0xFF  /* GRUNT_TRACE_END */
+
+typedef struct {
+	uint16 num_steps;      /* steps to send, 0 for all kept */
+	uint8  pad[2];         /* unused; pads payload to 32-bits */
+} VSC_cmd_trace_payload_t;
+
+typedef struct {
+	CFE_MSG_CommandHeader_t header;
+	VSC_cmd_trace_payload_t payload;
+} VSC_cmd_trace_t;
+
+typedef struct {
+	uint16 pc;             /* program counter of the instruction */
+	uint8  op;             /* its opcode, 0 at VSC_TRACE_END */
+	uint8  type;           /* arg stack top's type, or VSC_TRACE_* */
+	uint32 top;            /* arg stack top's payload, or status */
+} VSC_trace_step_t;
+
+typedef struct {
+	uint8  seq;            /* number of this message in the series */
+	uint8  num_msgs;       /* number of messages in the series */
+	uint16 num_steps;      /* entries in use in steps[] */
+	uint32 first_step;     /* number of steps[0] in the whole trace */
+	uint32 total_steps;    /* steps the interpreter ever traced */
+	VSC_trace_step_t steps[VSC_TRACE_STEPS_PER_MSG];
+} VSC_tlm_trace_payload_t;
+
+typedef struct {
+	CFE_MSG_TelemetryHeader_t header;
+	VSC_tlm_trace_payload_t   payload;
+} VSC_tlm_trace_t;
+
 #endif
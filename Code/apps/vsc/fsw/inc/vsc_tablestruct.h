@@ -43,10 +43,26 @@
 #define VSC_PARM_DIRECTION_MIN VS_PARM_DIRECTION_MIN
 #define VSC_PARM_DIRECTION_MAX VS_PARM_DIRECTION_MAX
 
+#define VSC_PARM_IS_ANIMAL(id)    VS_PARM_IS_ANIMAL(id)
+#define VSC_PARM_IS_DIRECTION(id) VS_PARM_IS_DIRECTION(id)
+
+typedef vs_parm_id_t vsc_parm_id_t;
+
 typedef vs_entry_t vsc_entry_t;
 
 #define VSC_TABLE_NUM_ENTRIES VS_TABLE_NUM_ENTRIES
 
+/* The most Grunt instructions and cycles one validation of a table
+ * image can take on the Grunt interpreter, for budgeting the
+ * housekeeping slot VSC validates in.  gruntasm works them out from
+ * the worst path through VSC's program and tools/GruntAsm/host.costs,
+ * and VSC's build fails if its program can run longer.  The cycles
+ * are x86-64 time stamp counter cycles; see grunt-manual.md for how
+ * to measure costs on other processors.
+ */
+#define VSC_WCET_STEPS  2400
+#define VSC_WCET_CYCLES 160000
+
 typedef vs_table_t vsc_table_t;
 
 
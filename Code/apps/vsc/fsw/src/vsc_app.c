@@ -14,14 +14,18 @@
  */
 
 /*
- * This file defines the VSC App's main entry point, its
- * initialization rountines and runloop.
+ * This file defines the VSC App's main entry point and the handlers
+ * for its batch validation, profile, trace, engine, and program load
+ * commands.  The VS_APP library supplies the initialization routines
+ * and runloop the VS apps share; this file describes the app to it.
  */
 
+#include <string.h>
+
 #include "cfe.h"
 #include "common_types.h"
-#include "osapi.h"
 
+#include "vs_tablestruct.h"
 #include "vs_msgstruct.h"
 #include "vs_ground.h"
 
@@ -32,290 +36,338 @@
 #include "vsc_fcncodes.h"
 #include "vsc_table.h"
 
+#include "vs_app.h"
+
 #define VSC_APP_CMD_PIPE_DEPTH  16  /* Max pending messages before overflow */
 #define VSC_APP_CMD_PIPE_NAME   "VSC_APP_CMD_PIPE"
 
+/* Once a blocking read wakes the app, it polls for and handles up to
+ * VSC_PIPE_BATCH - 1 more pending messages before blocking again.
+ */
+#ifndef VSC_PIPE_BATCH
+#define VSC_PIPE_BATCH 1
+#endif
+
+/* Built with VSC_TBL_NOTIFY, the app has TBL send it a notification
+ * message whenever its table has a validation or load pending, and
+ * manages the table as soon as that message arrives.
+ */
+#ifdef VSC_TBL_NOTIFY
+#define VSC_TBL_NOTIFY_FLAG true
+#else
+#define VSC_TBL_NOTIFY_FLAG false
+#endif
+
+/* Built with VS_CYCLE_HISTOGRAM, the app keeps a histogram of the
+ * cycles each validation takes and sends it on VSC_DUMP_CYCLES_CC.
+ */
+#ifdef VS_CYCLE_HISTOGRAM
+#define VSC_DUMP_CYCLES VSC_table_dump_cycles
+#else
+#define VSC_DUMP_CYCLES NULL
+#endif
+
 
 /* ---------------- Module local state and functions ---------------- */
 
-/* cFS/cFE Apps traditionally bundle the variables that store their
- * runtime state into a struct.  Here's the state struct for this app.
- *
- * cFS/cFE Apps traditionally keep counts of command messages (not)
- * processed correctly so that they can be reported in housekeeping
- * telemetry.  Rather than declaring separate variables to keep these
- * counts and copying their values into a housekeeping telemetry
- * message when it's time to send, we'll simply declare a housekeeping
- * telemetry message structure and keep the counts directly in its
- * fields.
+/* A batch of candidate table files the ground has staged, to validate
+ * on the next housekeeping cycle.
  */
-   
-static struct {
-	CFE_SB_PipeId_t  cmd_pipe;   /* we read commands from this pipe */
-	CFE_TBL_Handle_t h_table;    /* handle to TBL-managed table */
-	VSC_tlm_hk_t     msg_tlm_hk; /* housekeeping telemetry message */
-} VSC_state;
-	
+static bool                    VSC_batch_pending = false;
+static VSC_cmd_batch_payload_t VSC_batch;
 
-static void
-vsc_reset_diagnostic_counters(void) {
-	VSC_state.msg_tlm_hk.payload.ctr_cmd_ok    = 0;
-	VSC_state.msg_tlm_hk.payload.ctr_cmd_error = 0;
-} /* vsc_reset_diagnostic_counters() */	
 
-
-/* VSC_init()
+/* VSC_stage_batch()
  *
- * in:     nothing
- * out:    VSC_state - updated to reflect initialization described below
- * return: CFE_SUCCESS if initialization goes well, otherwise CFE
- *         error codes.
+ * in:     p_cmd_msg - VSC_VALIDATE_BATCH_CC ground command message
+ * out:    VSC_batch - batch staged for validation on the next
+ *                     housekeeping cycle
+ * return: CFE_SUCCESS on success, otherwise VSC_CMD_BAD_ARG_ERR_EID.
  *
- * This function follows the traditional CFS App initialization
- * pattern: it prepares the app to receive ground and housekeeping
- * commands, initializes its table, and fills in the constant fields
- * of its template telemetry message.
+ * Checks the command's length and arguments and, if they are good,
+ * stages its batch of table files.  A batch replaces any earlier
+ * batch still waiting for housekeeping.
  *
+ * Side effect: emits an error telemetry message if it rejects the
+ * command.
  */
 
 static CFE_Status_t
-VSC_init(void) {
-
-	CFE_Status_t result;  /* holds error codes returned by functions */
-
-	/* Initialize our housekeeping telemetry message.  This clears
-	 * the diagnostic counters in its payload area to zero.
-	 *
-	 * Note that we don't need to clear our counters by calling
-	 * our vsa_reset_diagnostic_counters() function here because
-	 * CFE_MSG_Init() zeroes the entire message.
-	 */
-	
-	CFE_MSG_Init(CFE_MSG_PTR(VSC_state.msg_tlm_hk.header),
-		CFE_SB_ValueToMsgId(VSC_TLM_HK_MID),
-		sizeof(VSC_tlm_hk_t));
-
-	/* Register with EVS.  Specify no event filter.  Even though
-	 * we're not specifying a filter, we must specify the
-	 * CFE_EVS_EventFilter_BINARY type or the present EVS
-	 * implementation will report CFE_EVS_UNKNOWN_FILTER.
-	 */
-	if (CFE_SUCCESS != (result = CFE_EVS_Register(NULL, 0,
-		CFE_EVS_EventFilter_BINARY))) {
-		CFE_ES_WriteToSysLog("%s: CFE_EVS_Register() returned 0x%08X"
-			"; %s will shutdown.\n", VSC_APP_NAME, result,
-			VSC_APP_NAME);
-		return result;
+VSC_stage_batch(CFE_MSG_Message_t *p_cmd_msg) {
+
+	const VSC_cmd_batch_payload_t *p_payload =
+		&(((const VSC_cmd_batch_t *)p_cmd_msg)->payload);
+	CFE_MSG_Size_t msg_size;  /* size from message header */
+	uint8 i;
+
+	CFE_MSG_GetSize(p_cmd_msg, &msg_size);
+	if (msg_size != sizeof(VSC_cmd_batch_t)) {
+		CFE_EVS_SendEvent(VSC_CMD_BAD_ARG_ERR_EID,
+			CFE_EVS_EventType_ERROR,
+			"%s: batch command has length %u, expected %u.",
+			VSC_APP_NAME, (unsigned int)msg_size,
+			(unsigned int)sizeof(VSC_cmd_batch_t));
+		return VSC_CMD_BAD_ARG_ERR_EID;
 	}
 
-	/* Create SB pipe for receiving commands. */
-	if (CFE_SUCCESS != (result = CFE_SB_CreatePipe(&VSC_state.cmd_pipe,
-		VSC_APP_CMD_PIPE_DEPTH, VSC_APP_CMD_PIPE_NAME))) {
-		CFE_ES_WriteToSysLog("%s: CFE_SB_CreatePipe() returned 0x%08X"
-			"; %s will shutdown.\n", VSC_APP_NAME, result,
-			VSC_APP_NAME);
-		return result;
+	if ((p_payload->num_images < 1) ||
+		(p_payload->num_images > VSC_BATCH_MAX_IMAGES)) {
+		CFE_EVS_SendEvent(VSC_CMD_BAD_ARG_ERR_EID,
+			CFE_EVS_EventType_ERROR,
+			"%s: batch command names %u files, expected 1 to %u.",
+			VSC_APP_NAME, (unsigned int)p_payload->num_images,
+			(unsigned int)VSC_BATCH_MAX_IMAGES);
+		return VSC_CMD_BAD_ARG_ERR_EID;
 	}
 
-	/* Subscribe to ground command messages. */
-	if (CFE_SUCCESS != (result = CFE_SB_Subscribe(
-		CFE_SB_ValueToMsgId(VSC_CMD_MID), VSC_state.cmd_pipe))) {
-		CFE_ES_WriteToSysLog("%s: CFE_SB_Subscribe() returned 0x%08X"
-			"; %s App will shutdown.\n", VSC_APP_NAME, result,
-			VSC_APP_NAME);
-		return result;
+	/* Using C99 memchr() because POSIX strnlen() isn't available. */
+	for (i = 0; i < p_payload->num_images; i++) {
+		if (!memchr(p_payload->filenames[i], '\0',
+			CFE_MISSION_MAX_PATH_LEN)) {
+			CFE_EVS_SendEvent(VSC_CMD_BAD_ARG_ERR_EID,
+				CFE_EVS_EventType_ERROR,
+				"%s: batch command filename %u "
+				"is not terminated.", VSC_APP_NAME,
+				(unsigned int)i);
+			return VSC_CMD_BAD_ARG_ERR_EID;
+		}
 	}
 
-	/* Subscribe to housekeeping command messages. */
-	if (CFE_SUCCESS != (result = CFE_SB_Subscribe(
-		CFE_SB_ValueToMsgId(VSC_SEND_HK_MID), VSC_state.cmd_pipe))) {
-		CFE_ES_WriteToSysLog("%s: CFE_SB_Subscribe() returned 0x%08X"
-			"; %s will shutdown.\n", VSC_APP_NAME, result,
-			VSC_APP_NAME);
-		return result;
+	VSC_batch = *p_payload;
+	VSC_batch_pending = true;
+	return CFE_SUCCESS;
+
+} /* VSC_stage_batch() */
+
+
+/* VSC_set_engine()
+ *
+ * in:     p_cmd_msg - VSC_SET_ENGINE_CC ground command message
+ * out:    nothing
+ * return: CFE_SUCCESS on success, otherwise VSC_CMD_BAD_ARG_ERR_EID.
+ *
+ * Checks the command's length and switches table validation to the
+ * engine it names, if this build of the app has that engine.
+ *
+ * Side effect: emits an information event naming the new engine, or
+ * an error event if it rejects the command.
+ */
+
+static CFE_Status_t
+VSC_set_engine(CFE_MSG_Message_t *p_cmd_msg) {
+
+	const VSC_cmd_engine_payload_t *p_payload =
+		&(((const VSC_cmd_engine_t *)p_cmd_msg)->payload);
+	CFE_MSG_Size_t msg_size;  /* size from message header */
+
+	CFE_MSG_GetSize(p_cmd_msg, &msg_size);
+	if (msg_size != sizeof(VSC_cmd_engine_t)) {
+		CFE_EVS_SendEvent(VSC_CMD_BAD_ARG_ERR_EID,
+			CFE_EVS_EventType_ERROR,
+			"%s: engine command has length %u, expected %u.",
+			VSC_APP_NAME, (unsigned int)msg_size,
+			(unsigned int)sizeof(VSC_cmd_engine_t));
+		return VSC_CMD_BAD_ARG_ERR_EID;
 	}
 
-	if (CFE_SUCCESS != (result = VSC_table_init(&(VSC_state.h_table)))) {
-		/* No need to CFE_ES_WriteToSysLog() an error message
-		 * here; VSC_table_init() will already have written a
-		 * specific error message to the log.
-		 */
-		return result;
+	if (!VSC_table_set_engine(p_payload->engine)) {
+		CFE_EVS_SendEvent(VSC_CMD_BAD_ARG_ERR_EID,
+			CFE_EVS_EventType_ERROR,
+			"%s: this build has no validation engine %u.",
+			VSC_APP_NAME, (unsigned int)p_payload->engine);
+		return VSC_CMD_BAD_ARG_ERR_EID;
 	}
-	
-	/* Report our successfull initialization. */
-	CFE_EVS_SendEvent(VSC_STARTUP_OK_INF_EID,
-		CFE_EVS_EventType_INFORMATION,
-		"%s initialized, awaiting enable command",
-		VSC_APP_VERSION_STRING);
-	
+
+	CFE_EVS_SendEvent(VSC_ENGINE_INF_EID, CFE_EVS_EventType_INFORMATION,
+		"%s: validating with engine %u.", VSC_APP_NAME,
+		(unsigned int)p_payload->engine);
 	return CFE_SUCCESS;
 
-} /* VSC_init() */
+} /* VSC_set_engine() */
 
 
-/* VSC_process_housekeeping()
+#ifdef GRUNT_TRACE
+
+/* VSC_dump_trace()
  *
- * in:     p_cmd_msg - housekeeping command message to process
+ * in:     p_cmd_msg - VSC_DUMP_TRACE_CC ground command message
  * out:    nothing
- * return: CFE_Success on success, otherwise CFE error codes.
+ * return: CFE_SUCCESS on success, otherwise VSC_CMD_BAD_ARG_ERR_EID.
  *
- * Handle housekeeping commands, including table validation.
+ * Checks the command's length and sends the steps of the Grunt
+ * trace it asks for.
  *
- * This function handles all housekeeping commands, including table
- * validation requests from the CFE Table Service (TBL).  Table
- * validation requests have an interesting control flow:
+ * Side effect: emits an error event if it rejects the command.
+ */
+
+static CFE_Status_t
+VSC_dump_trace(CFE_MSG_Message_t *p_cmd_msg) {
+
+	const VSC_cmd_trace_payload_t *p_payload =
+		&(((const VSC_cmd_trace_t *)p_cmd_msg)->payload);
+	CFE_MSG_Size_t msg_size;  /* size from message header */
+
+	CFE_MSG_GetSize(p_cmd_msg, &msg_size);
+	if (msg_size != sizeof(VSC_cmd_trace_t)) {
+		CFE_EVS_SendEvent(VSC_CMD_BAD_ARG_ERR_EID,
+			CFE_EVS_EventType_ERROR,
+			"%s: trace command has length %u, expected %u.",
+			VSC_APP_NAME, (unsigned int)msg_size,
+			(unsigned int)sizeof(VSC_cmd_trace_t));
+		return VSC_CMD_BAD_ARG_ERR_EID;
+	}
+
+	VSC_table_dump_trace(p_payload->num_steps);
+	return CFE_SUCCESS;
+
+} /* VSC_dump_trace() */
+
+#endif /* GRUNT_TRACE */
+
+
+/* VSC_load_program()
+ *
+ * in:     p_cmd_msg - VSC_LOAD_PROGRAM_CC ground command message
+ * out:    nothing
+ * return: CFE_SUCCESS on success, otherwise VSC_CMD_BAD_ARG_ERR_EID
+ *         or VSC_PROGRAM_ERR_EID.
  *
- * (1) The ground station operator asks TBL to validate a table image.
- * (2) TBL asks the app to validate the image on its next housekeeping
- *     cycle.
- * (3) This function receives TBL's request and uses TBL's
- *     CFE_TBL_Manage() convenience function to handle it.
- * (4) TBL's convenience function ultimately invokes the app's table
- *     validation function to do the actual validation.
+ * Checks the command's length and filename and loads the serialized
+ * Grunt program the file holds in place of the app's own.
  *
- * Side effect: emits a housekeeping telemetry message.
+ * Side effect: emits an error event if it rejects the command; the
+ * load sends its own events.
  */
 
 static CFE_Status_t
-VSC_process_housekeeping(CFE_MSG_Message_t *p_cmd_msg) {
-
-	/* Housekeeping command messages should have length equal to
-	 * sizeof(CFE_MSG_Message_t).  Their command code field isn't
-	 * meaningful; the SCH_LAB app I'm building against sets it to
-	 * 0.  Rather than check for these proper values, I'm
-	 * generously accepting any message with the proper
-	 * send-housekeeping MID.
-	 */
-
-	/* Ask TBL to perform any requested table loads (aka
-	 * "updates") or validations.  Don't bother examining the
-	 * result.  Instead, rely on the error reporting done by
-	 * CFE_TBL_Manage() and our own validation procedure.
-	 */
-	CFE_TBL_Manage(VSC_state.h_table);
-
-	/* Emit a housekeeping telemetry message. */
-	CFE_SB_TimeStampMsg(CFE_MSG_PTR(VSC_state.msg_tlm_hk.header));
-	CFE_SB_TransmitMsg(CFE_MSG_PTR(VSC_state.msg_tlm_hk.header), true);
+VSC_load_program(CFE_MSG_Message_t *p_cmd_msg) {
 
-	return CFE_SUCCESS;
-	
-} /* VSC_process_housekeeping() */
+	const VSC_cmd_program_payload_t *p_payload =
+		&(((const VSC_cmd_program_t *)p_cmd_msg)->payload);
+	CFE_MSG_Size_t msg_size;  /* size from message header */
+
+	CFE_MSG_GetSize(p_cmd_msg, &msg_size);
+	if (msg_size != sizeof(VSC_cmd_program_t)) {
+		CFE_EVS_SendEvent(VSC_CMD_BAD_ARG_ERR_EID,
+			CFE_EVS_EventType_ERROR,
+			"%s: program command has length %u, expected %u.",
+			VSC_APP_NAME, (unsigned int)msg_size,
+			(unsigned int)sizeof(VSC_cmd_program_t));
+		return VSC_CMD_BAD_ARG_ERR_EID;
+	}
+
+	/* Using C99 memchr() because POSIX strnlen() isn't available. */
+	if (!memchr(p_payload->filename, '\0', CFE_MISSION_MAX_PATH_LEN)) {
+		CFE_EVS_SendEvent(VSC_CMD_BAD_ARG_ERR_EID,
+			CFE_EVS_EventType_ERROR,
+			"%s: program command filename is not terminated.",
+			VSC_APP_NAME);
+		return VSC_CMD_BAD_ARG_ERR_EID;
+	}
+
+	return (VSC_table_load_program(p_payload->filename) ?
+		CFE_SUCCESS : VSC_PROGRAM_ERR_EID);
+
+} /* VSC_load_program() */
 
 
 /* VSC_process_ground_command()
  *
  * in:     p_cmd_msg - ground command message to handle
- * out:    VSC_state - may zero command processing statistics counters
- * return: CFE_SUCCESS on success, otherwise VSC_MSG_BAD_CC_ERR_EID.
- *
- * This function handles all commands from the ground station.
+ *         cc        - its command code, neither NOOP nor RESET_COUNTERS
+ * out:    nothing
+ * return: CFE_SUCCESS on success, otherwise VSC_MSG_BAD_CC_ERR_EID or
+ *         VSC_CMD_BAD_ARG_ERR_EID.
  *
- * Side effect: will emit telemetry messages specific to the type of
- * command processed or an error telemetry message for command codes
- * it doesn't support.
+ * The VS_APP library calls this function to handle the ground
+ * commands only VSC understands.  It leaves reporting unknown command
+ * codes to the library.
  */
 
 static CFE_Status_t
-VSC_process_ground_command(CFE_MSG_Message_t *p_cmd_msg) {
-
-	CFE_MSG_FcnCode_t msg_cc;  /* command code from message header */
-
-	/* None of the presently-supported ground command messages
-	 * have payloads; all should have length equal to
-	 * sizeof(CFE_MSG_Message_t).  However, I'm generously
-	 * accepting ground command messages with any length.
-	 */
-	CFE_MSG_GetFcnCode(p_cmd_msg, &msg_cc);
-
-	switch (msg_cc) {
-
-	case VSC_NOOP_CC:
-		/* Per cFS/cFE App tradition, the NOOP command causes
-		 * the app to send telemetry indicating its version.
-		 */
-		CFE_EVS_SendEvent(VSC_CMD_NOOP_INF_EID,
-			CFE_EVS_EventType_INFORMATION,
-			"%s received no-op command.", VSC_APP_VERSION_STRING);
-		return CFE_SUCCESS;
+VSC_process_ground_command(CFE_MSG_Message_t *p_cmd_msg,
+	CFE_MSG_FcnCode_t cc) {
+
+	switch (cc) {
+
+	case VSC_VALIDATE_BATCH_CC:
+		return VSC_stage_batch(p_cmd_msg);
 
-	case VSC_RESET_COUNTERS_CC:
-		vsc_reset_diagnostic_counters();
-		CFE_EVS_SendEvent(VSC_CMD_RESET_INF_EID,
-			CFE_EVS_EventType_INFORMATION,
-			"%s: reset diagnostic counters.", VSC_APP_NAME);
+	case VSC_SET_ENGINE_CC:
+		return VSC_set_engine(p_cmd_msg);
+
+	case VSC_LOAD_PROGRAM_CC:
+		return VSC_load_program(p_cmd_msg);
+
+#ifdef GRUNT_PROFILE
+	case VSC_DUMP_PROFILE_CC:
+		VSC_table_dump_profile();
 		return CFE_SUCCESS;
+#endif
+
+#ifdef GRUNT_TRACE
+	case VSC_DUMP_TRACE_CC:
+		return VSC_dump_trace(p_cmd_msg);
+#endif
 
 	default:
-		CFE_EVS_SendEvent(VSC_MSG_BAD_CC_ERR_EID,
-			CFE_EVS_EventType_ERROR,
-			"%s: received ground command message "
-			"with invalid command code 0x%02X.",
-			VSC_APP_NAME, msg_cc);
 		return VSC_MSG_BAD_CC_ERR_EID;
 	}
-	
+
 } /* VSC_process_ground_command() */
 
 
-/* VSC_process_command()
+/* VSC_process_housekeeping()
  *
- * in:     p_cmd_msg - housekeeping or ground command to handle.
- * out:    VSC_state - increments command processing statistics counters,
- *                     potentially rolling them back to zero on overflow.
+ * in:     p_hk              - housekeeping payload about to go out
+ * out:    VSC_batch_pending - cleared
+ *         p_hk              - engine field set
  * return: nothing
  *
- * This function distinguishes between housekeeping and ground
- * commands and invokes the appropriate handler function.
- * Housekeeping commands are automatic, sent periodically by the CFE
- * Scheduler service (SCH) per its configuration table.  Ground
- * commands come from the human ground station operator.
- *
- * Side effect: will emit an error telemetry message if it sees a
- * message that is neither a ground or housekeeping command.
+ * The VS_APP library calls this function on each housekeeping cycle,
+ * after TBL has handled any validation request.  It validates any
+ * batch of candidate table files the ground staged since the last
+ * housekeeping cycle and reports the engine it validates with.
  */
 
 static void
-VSC_process_command(CFE_MSG_Message_t *p_cmd_msg) {
-
-	CFE_SB_MsgId_t msgid_opaque;  /* MID in some opaque representation */
-	CFE_SB_MsgId_Atom_t msgid;    /* MID in integer representation */
-	CFE_Status_t result;          /* processed OK vs. error code */
-	
-	/* Get the message ID from the command in p_cmd_buf and invoke
-	 * the proper handler function for that kind of message based
-	 * on what we see.
-	 *
-	 */
-	CFE_MSG_GetMsgId(p_cmd_msg, &msgid_opaque);
-	msgid = CFE_SB_MsgIdToValue(msgid_opaque);
-	
-	switch (msgid) {
-
-	case VSC_SEND_HK_MID:
-		result = VSC_process_housekeeping(p_cmd_msg);
-		break;
-
-	case VSC_CMD_MID:
-		result = VSC_process_ground_command(p_cmd_msg);
-		break;
+VSC_process_housekeeping(VS_tlm_hk_payload_t *p_hk) {
 
-	default:
-		result = VSC_MSG_BAD_MID_ERR_EID;
-		CFE_EVS_SendEvent(result, CFE_EVS_EventType_ERROR,
-			"%s: received command message "
-			"with invalid MID 0x%03X.", VSC_APP_NAME, msgid);
+	if (VSC_batch_pending) {
+		VSC_table_validate_batch(&VSC_batch);
+		VSC_batch_pending = false;
 	}
 
-	/* Update diagnostic count of messages (not) handled correctly. */
-	if (result == CFE_SUCCESS) {
-		VSC_state.msg_tlm_hk.payload.ctr_cmd_ok++;    /* can roll */
-	} else {
-		VSC_state.msg_tlm_hk.payload.ctr_cmd_error++; /* can roll */
-	}
-	
-} /* VSC_process_command() */
+	p_hk->engine = VSC_table_get_engine();
+
+} /* VSC_process_housekeeping() */
+
+
+/* What the VS_APP library needs to know to run this app. */
+static const VS_app_config_t VSC_config = {
+	.app_name       = VSC_APP_NAME,
+	.version_string = VSC_APP_VERSION_STRING,
+	.pipe_name      = VSC_APP_CMD_PIPE_NAME,
+	.pipe_depth     = VSC_APP_CMD_PIPE_DEPTH,
+	.pipe_batch     = VSC_PIPE_BATCH,
+	.cmd_mid        = VSC_CMD_MID,
+	.send_hk_mid    = VSC_SEND_HK_MID,
+	.tlm_hk_mid     = VSC_TLM_HK_MID,
+	.tbl_notify     = VSC_TBL_NOTIFY_FLAG,
+	.tbl_notify_mid = VSC_TBL_NOTIFY_MID,
+	.all_perf_id    = VSC_ALL_PERF_ID,
+	.hk_perf_id     = VSC_HK_PERF_ID,
+	.table_init     = VSC_table_init,
+	.get_stats      = VSC_table_get_stats,
+	.reset_stats    = VSC_table_reset_stats,
+	.dump_cycles    = VSC_DUMP_CYCLES,
+	.screen         = VSC_table_screen,
+	.command        = VSC_process_ground_command,
+	.housekeeping   = VSC_process_housekeeping,
+};
+
+/* The app's runtime state. */
+static VS_app_t VSC_app = { .p_config = &VSC_config };
 
 
 /* ---------------- Functions exported by this module ---------------- */
@@ -335,70 +387,6 @@ VSC_process_command(CFE_MSG_Message_t *p_cmd_msg) {
 void
 VSC_Main(void) {
 
-	/* This is the "run status" argument we pass to
-	 * CFE_ES_RunLoop().  We'll begin with it set to
-	 * CFE_ES_RunStatus_APP_RUN, a value that will tell ES we are
-	 * happy and healthy.  If we encounter an unrecoverable error
-	 * we will set it to ES_RunStatus_APP_ERROR.  This will tell
-	 * ES to shut us down the next time we call CFE_ES_RunLoop().
-	 */
-	CFE_ES_RunStatus_Enum_t run_status = CFE_ES_RunStatus_APP_RUN;
-	CFE_SB_Buffer_t *p_cmd_buf; /* SB-provided command buffer */
-	uint32 result;  /* holds error codes returned by functions */
-	
-	/* Mark the start of app-specific processing for performance
-	 * monitoring.
-	 */
-	CFE_ES_PerfLogEntry(VSC_ALL_PERF_ID);
-
-	/* Initialize.  If anything fails, tell CFE_ES_RunLoop() to
-	 * shut us down.
-	 */
-	if (CFE_SUCCESS != VSC_init()) run_status = CFE_ES_RunStatus_APP_ERROR;
-
-	/* Enter the main processing loop and process commands until
-	 * ES tells us to stop.
-	 */
-	while (CFE_ES_RunLoop(&run_status)) {
-
-		/* Mark the start of a pause in app-specific processing
-		 * while we block waiting for SB to give us a command
-		 * to process.
-		 */
-		CFE_ES_PerfLogExit(VSC_ALL_PERF_ID);
-
-		/* Block here until we get the next command. */
-		result = CFE_SB_ReceiveBuffer(&p_cmd_buf, VSC_state.cmd_pipe,
-			CFE_SB_PEND_FOREVER);
-
-		/* Mark the resumption of app-specific processing
-		 * now that we're done waiting for a command.
-		 */
-		CFE_ES_PerfLogEntry(VSC_ALL_PERF_ID);
-
-		/* Process command.  Errors reading from the command
-		 * pipe are unrecoverable; ask ES to shut us down if
-		 * we see one.  Any errors we find in the command
-		 * itself while attempting to process it are
-		 * recoverable and don't merit a shutdown - we'll just
-		 * ignore a malformed command and await the next one.
-		 */
-		if (result == CFE_SUCCESS) {
-			VSC_process_command(&(p_cmd_buf->Msg));
-		} else {
-			CFE_EVS_SendEvent(VSC_PIPE_ERR_EID,
-				CFE_EVS_EventType_ERROR,
-				"VSC: SB pipe read error; "
-				"VSC App will shutdown");
-			run_status = CFE_ES_RunStatus_APP_ERROR;
-		}
-		
-	} /* while we're in the runloop processing commands */
-
-	/* CFE_ES_RunLoop() has told us to shut down.  Mark the final
-	 * end of app-specific processing and exit.
-	 */
-	CFE_ES_PerfLogExit(VSC_ALL_PERF_ID);
-	CFE_ES_ExitApp(run_status);
+	VS_app_Main(&VSC_app);
 
 } /* VSC_Main() */
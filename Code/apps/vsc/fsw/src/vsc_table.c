@@ -14,17 +14,57 @@
  */
 
 /*
- * This file defines the app's table validation function.
+ * This file defines the app's table validation function and its
+ * batch validation of staged candidate table files.
+ *
+ * Built with VSC_REPORT_TLM defined, these functions report the
+ * problems they find in each image in a single validation report
+ * telemetry message instead of one error event each.
+ *
+ * Built with VSC_RESULT_CACHE defined, the validation function keeps
+ * the results of the last few images it validated, and answers an
+ * image it has seen before by sending the same events again without
+ * running the Grunt program.
+ *
+ * Built with VSC_NATIVE_VF defined, the app can also run the native
+ * code the gruntaot translator generated from vsvf.h, and starts out
+ * running it.  Built with VSC_XMACRO_VF defined, it can also run the
+ * native code grunt_xmacro.h expands its Grunt program into as VSC
+ * builds.  VSC_table_set_engine() switches among the engines at run
+ * time; VSC_DEFAULT_ENGINE names the one the app starts with.
+ *
+ * VSC_table_load_program() swaps the built-in Grunt program for one
+ * the ground uplinked in the serialized format grunt.h describes.
+ *
+ * Built with VSC_TWO_PASS_VF defined, the validation function decides
+ * each image with the screening program first, and runs its Grunt
+ * program to render the image's events only if it is invalid.
+ *
+ * Built with VSC_SHORT_EVENTS defined, these functions send each error
+ * event with the short-format event ID vs_eventids.h describes, which
+ * names the entry, its parm, and the problem, in place of the text
+ * the Grunt program renders.
  *
  */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "cfe.h"
 #include "common_types.h"
 
 #include "vs_ground.h"
 #include "vs_tablestruct.h"
+#include "vs_msgstruct.h"
+#include "vs_vstats.h"
+#include "vs_cycles.h"
+#include "vs_parmclass.h"
+#ifdef VSC_RESULT_CACHE
+#include "vs_cache.h"
+#endif
 
 #include "vsc_tablestruct.h"
+#include "vsc_msgstruct.h"
 #include "vs_eventids.h"
 #include "vsc_eventids.h"
 #include "vsc_version.h"      /* for VSC_APP_NAME constant */
@@ -32,15 +72,61 @@
 
 #include "grunt.h"
 #include "grunt_status.h"
+#if defined(VSC_NATIVE_VF) && defined(VSC_RULES_VF)
+#error "VSC_RULES_VF has no gruntaot translation to build VSC_NATIVE_VF from"
+#endif
+#ifdef VSC_RULES_VF
+#include "vsvf_rules.h"       /* program vsrules made from vs_rules.spec */
+#else
 #include "vsvf.h"
+#endif
+#include "vsvf_screen.h"      /* fail-fast program for VSC_SCREEN_CC */
+#if defined(VSC_TWO_PASS_VF) && (defined(GRUNT_PROFILE) || \
+	defined(GRUNT_TRACE))
+#error "VSC_TWO_PASS_VF would mix screening runs into VSC's profile dumps"
+#endif
+#ifdef VSC_NATIVE_VF
+#include "vsvf_native.h"      /* gruntaot translation of vsvf.h */
+#endif
+#ifdef VSC_XMACRO_VF
+#include "vsvf_xmacro.h"      /* grunt_xmacro.h expansion of our program */
+#endif
 
 /* ---------- module private definitions and functions ----------- */
 
+/* vsvf.gasm loops over the default table's four entries and compares
+ * each in-use entry's parm ID with those of the three entries before
+ * it, which it carries along on the arg stack.  Grunt has no memory
+ * to keep a larger set of parm IDs in, so a program can neither find
+ * duplicates among more entries nor do so in linear time.
+ */
+#if (VSC_TABLE_NUM_ENTRIES != 4) || (VS_PARM_ID_BITS != 8)
+#error "VSC's Grunt program validates only 4-entry tables of 8-bit parm IDs"
+#endif
+
+/* VSC_WCET_CYCLES and VSC_WCET_STEPS promise the scheduler that no
+ * validation runs longer than they say; hold the program to them.
+ */
+#if (VSVF_WCET_CYCLES > VSC_WCET_CYCLES) || (VSVF_WCET_STEPS > VSC_WCET_STEPS)
+#error "VSC's Grunt program can run longer than VSC_WCET_CYCLES or _STEPS"
+#endif
+
 /* VSC_table_init() will ask TBL to initialize the table with values
- * loaded from this file.
+ * loaded from this file, or, in builds with VS_BUILTIN_TABLE, from
+ * the same image compiled into the app from VSC_Prm_default.c.
  */
 #define VSC_DEFAULT_TABLE_FILENAME			\
 	"/cf/VSC_" VSC_RAW_TABLE_NAME "_default.tbl"
+#ifdef VS_BUILTIN_TABLE
+extern vsc_table_t vsc_table_default;
+#define VSC_DEFAULT_TABLE_SRC  CFE_TBL_SRC_ADDRESS
+#define VSC_DEFAULT_TABLE      ((const void *)&vsc_table_default)
+#define VSC_DEFAULT_TABLE_NAME "the built-in default table"
+#else
+#define VSC_DEFAULT_TABLE_SRC  CFE_TBL_SRC_FILE
+#define VSC_DEFAULT_TABLE      VSC_DEFAULT_TABLE_FILENAME
+#define VSC_DEFAULT_TABLE_NAME VSC_DEFAULT_TABLE_FILENAME
+#endif
 
 
 /* TBL expects our VSC_table_validate() function to return CFE_SUCCESS
@@ -49,10 +135,448 @@
  */
 #define VSC_TABLE_INVALID_RESULT (~CFE_SUCCESS)
 
+
+/* The full name TBL gives our table, which table files for our table
+ * carry in their headers.
+ */
+#define VSC_TABLE_FULL_NAME VSC_APP_NAME "." VSC_RAW_TABLE_NAME
+
+
+/* The Grunt validation program VSC runs and its string table:
+ * vsvf_program, until VSC_table_load_program() loads one the ground
+ * uplinked.  VSC_prepared is the handle GRUNT_Prepare() gave us for
+ * it, or NULL if it didn't prepare and GRUNT_Run() must run it on
+ * the checked engines.  In builds with VSC_OPTIMIZE_VF, GRUNT_Prepare()
+ * optimizes vsvf_program, too.
+ */
+static const grunt_instruction_t *VSC_program = vsvf_program;
+static grunt_pc_t VSC_num_instructions = VSVF_NUM_INSTRUCTIONS;
+static const char **VSC_strings = vsvf_strings;
+static grunt_string_t VSC_num_strings = VSVF_NUM_STRINGS;
+static const grunt_prepared_t *VSC_prepared = NULL;
+
+#ifdef VSC_OPTIMIZE_VF
+#define VSC_PREPARE_FLAGS GRUNT_PREPARE_OPTIMIZE
+#else
+#define VSC_PREPARE_FLAGS 0
+#endif
+
+
+/* The storage VSC_table_load_program() reads an uplinked program
+ * into.  GRUNT_Prepare() knows programs by where they are, so once
+ * one prepares here, storage and program stay as they are until the
+ * app restarts.
+ */
+static uint8 VSC_load_buffer[VSC_PROGRAM_MAX_BYTES + 1];  /* +1: too big */
+static grunt_instruction_t VSC_loaded_code[VSC_PROGRAM_MAX_INSTRUCTIONS];
+static const char *VSC_loaded_strings[VSC_PROGRAM_MAX_STRINGS];
+static grunt_rep_t VSC_loaded_lengths[VSC_PROGRAM_MAX_STRINGS];
+static char VSC_loaded_space[VSC_PROGRAM_MAX_STRING_SPACE];
+static grunt_serial_program_t VSC_loaded = {
+	VSC_loaded_code, VSC_loaded_strings, VSC_loaded_lengths,
+	VSC_loaded_space, VSC_PROGRAM_MAX_INSTRUCTIONS,
+	VSC_PROGRAM_MAX_STRINGS, VSC_PROGRAM_MAX_STRING_SPACE, 0, 0
+};
+static bool VSC_program_loaded = false;
+
+
+/* The record layout our Grunt validation program reads. */
+static const grunt_record_view_t VSC_record_view = {
+	VSVF_RECORD_OFFSET, VSVF_RECORD_SIZE
+};
+
+
+/* The VS_ENGINE_* engine the app starts with, and the one it runs
+ * now.  Builds without VSC_NATIVE_VF or VSC_XMACRO_VF have only the
+ * Grunt engines.
+ */
+#ifndef VSC_DEFAULT_ENGINE
+#ifdef VSC_NATIVE_VF
+#define VSC_DEFAULT_ENGINE VS_ENGINE_NATIVE
+#else
+#define VSC_DEFAULT_ENGINE VS_ENGINE_GRUNT
+#endif
+#endif
+#if (VSC_DEFAULT_ENGINE == VS_ENGINE_C) || \
+	((VSC_DEFAULT_ENGINE == VS_ENGINE_NATIVE) && \
+		!defined(VSC_NATIVE_VF)) || \
+	((VSC_DEFAULT_ENGINE == VS_ENGINE_XMACRO) && \
+		!defined(VSC_XMACRO_VF))
+#error "VSC_DEFAULT_ENGINE names an engine this build of VSC doesn't have"
+#endif
+
+static uint8 VSC_engine = VSC_DEFAULT_ENGINE;
+
+
+#ifdef GRUNT_PROFILE
+#if (VSC_PROFILE_NUM_OPCODES != GRUNT_PROFILE_NUM_OPCODES) || \
+	(VSC_PROFILE_NUM_BUCKETS != GRUNT_PROFILE_NUM_BUCKETS)
+#error "vsc_msgstruct.h profile sizes don't match grunt.h"
+#endif
+
+/* The pcs of our validation program the interpreter profiles, and
+ * the number of profile messages it takes to send their counts.
+ */
+#define VSC_PROFILE_NUM_PCS ((VSVF_NUM_INSTRUCTIONS < GRUNT_PROFILE_MAX_PC) \
+	? VSVF_NUM_INSTRUCTIONS : GRUNT_PROFILE_MAX_PC)
+#define VSC_PROFILE_NUM_MSGS ((VSC_PROFILE_NUM_PCS + \
+	VSC_PROFILE_PCS_PER_MSG - 1) / VSC_PROFILE_PCS_PER_MSG)
+
+static VSC_tlm_profile_t VSC_profile_msg;  /* VSC_table_dump_profile() */
+#endif
+
+#ifdef GRUNT_TRACE
+#if (VSC_TRACE_EMPTY != GRUNT_TRACE_EMPTY) || \
+	(VSC_TRACE_END != GRUNT_TRACE_END)
+#error "vsc_msgstruct.h trace step types don't match grunt.h"
+#endif
+
+static VSC_tlm_trace_t VSC_trace_msg;  /* VSC_table_dump_trace() */
+#endif
+
+
+#ifdef VSC_RESULT_CACHE
+/* The results of the last few images validated.  Our event sinks
+ * record each event our validation program sends for the image being
+ * validated.
+ */
+static vs_cache_t VSC_cache;
+#endif
+
+
+#if defined(VSC_REPORT_TLM) || defined(VSC_SHORT_EVENTS)
+/* Our validation program's error messages all begin with this
+ * prefix followed by the number of the entry at fault.
+ */
+#define VSC_REPORT_ENTRY_PREFIX "Table entry "
+#endif
+
+
+#ifdef VSC_SHORT_EVENTS
+#ifdef VSC_REPORT_TLM
+#error "Define at most one of VSC_REPORT_TLM and VSC_SHORT_EVENTS"
+#endif
+#if VSC_TABLE_NUM_ENTRIES > VS_TBL_SHORT_MAX_ENTRIES
+#error "VSC_SHORT_EVENTS event IDs can't number this many entries"
+#endif
+#endif
+
+
+#ifdef VSC_REPORT_TLM
+
+/* The validation report message VSC_table_report_event() fills in
+ * and sends for each table image, and the images whose errors it is
+ * recording.  Our validation program ends each image's run with its
+ * VSC_VALIDATION_INF_EID summary event, so the sink steps to the next
+ * image when it sees one.
+ */
+typedef struct {
+	VSC_tlm_report_t   msg;       /* report for the current image */
+	const vsc_table_t *p_images;  /* images being validated */
+	uint16             image;     /* index of the current image */
+} VSC_report_t;
+
+static VSC_report_t VSC_report;
+
+
+/* VSC_table_report_begin()
+ *
+ * in:     p_images - table images about to be validated, in order
+ * out:    VSC_report - ready to record the first image's errors
+ * return: nothing
+ */
+
+static void
+VSC_table_report_begin(const vsc_table_t *p_images) {
+
+	memset(&(VSC_report.msg.payload), 0, sizeof(VSC_report.msg.payload));
+	VSC_report.p_images = p_images;
+	VSC_report.image    = 0;
+
+} /* VSC_table_report_begin() */
+
+
+/* VSC_table_report_event()
+ *
+ * in:     arg        - our VSC_report_t
+ *         event_type - type of event the validation program flushed
+ *         event_id   - ID of event the validation program flushed
+ *         message    - text of event the validation program flushed
+ * out:    nothing
+ * return: nothing
+ *
+ * The Grunt event sink for our validation program.  Records each
+ * error event in the current image's validation report and passes
+ * all other events on to EVS.  Sends the report just before the
+ * VSC_VALIDATION_INF_EID summary event that ends each image's run.
+ */
+
+static void
+VSC_table_report_event(void *arg, grunt_number_t event_type,
+	grunt_number_t event_id, const char *message) {
+
+	VSC_report_t *p_report = (VSC_report_t *)arg;
+	VS_tlm_report_payload_t *p_payload = &(p_report->msg.payload);
+	VS_report_error_t *p_error;
+	unsigned long entry = 0;  /* 1-based entry number, 0 if unknown */
+
+	if (event_type != CFE_EVS_EventType_ERROR) {
+		if (event_id == VSC_VALIDATION_INF_EID) {
+			CFE_SB_TimeStampMsg(CFE_MSG_PTR(p_report->msg.header));
+			CFE_SB_TransmitMsg(CFE_MSG_PTR(p_report->msg.header),
+				true);
+#ifdef VSC_RESULT_CACHE
+			VS_cache_record_report(&VSC_cache, p_payload);
+#endif
+			memset(p_payload, 0, sizeof(*p_payload));
+			p_report->image++;
+		}
+#ifdef VSC_RESULT_CACHE
+		VS_cache_record_event(&VSC_cache, (uint16)event_id,
+			(uint16)event_type, message);
+#endif
+		CFE_EVS_SendEvent((uint16)event_id, (uint16)event_type, "%s",
+			message);
+		return;
+	}
+
+	if (p_payload->num_errors == VS_REPORT_MAX_ERRORS) {
+		if (p_payload->num_dropped < 0xFF) p_payload->num_dropped++;
+		return;
+	}
+
+	if (0 == strncmp(message, VSC_REPORT_ENTRY_PREFIX,
+		strlen(VSC_REPORT_ENTRY_PREFIX))) {
+		entry = strtoul(message + strlen(VSC_REPORT_ENTRY_PREFIX),
+			NULL, 10);
+		if (entry > VSC_TABLE_NUM_ENTRIES) entry = 0;
+	}
+
+	p_error = &(p_payload->errors[p_payload->num_errors++]);
+	p_error->entry   = (uint16)entry;
+	p_error->parm_id = (entry ? p_report->p_images[p_report->image].
+		entries[entry - 1].parm_id : 0);
+	p_error->eid     = (uint16)event_id;
+
+} /* VSC_table_report_event() */
+
+#elif defined(VSC_SHORT_EVENTS)
+
+/* The images VSC_table_short_event() is sending error events for.
+ * As VSC_report_t's does, the sink steps to the next image at each
+ * VSC_VALIDATION_INF_EID summary event.
+ */
+typedef struct {
+	const vsc_table_t *p_images;  /* images being validated */
+	uint16             image;     /* index of the current image */
+} VSC_short_t;
+
+static VSC_short_t VSC_short;
+
+
+/* VSC_table_short_begin()
+ *
+ * in:     p_images - table images about to be validated, in order
+ * out:    VSC_short - ready for the first image's events
+ * return: nothing
+ */
+
+static void
+VSC_table_short_begin(const vsc_table_t *p_images) {
+
+	VSC_short.p_images = p_images;
+	VSC_short.image    = 0;
+
+} /* VSC_table_short_begin() */
+
+
+/* VSC_table_short_event()
+ *
+ * in:     arg        - our VSC_short_t
+ *         event_type - type of event the validation program flushed
+ *         event_id   - ID of event the validation program flushed
+ *         message    - text of event the validation program flushed
+ * out:    nothing
+ * return: nothing
+ *
+ * The Grunt event sink for our validation program.  Sends each table
+ * validation error event with its short-format event ID and
+ * VS_TBL_SHORT_TEXT, taking the entry from the text and its parm
+ * from the image, and passes all other events on to EVS as they are.
+ * An error event whose text names no entry goes as it is, too.
+ */
+
+static void
+VSC_table_short_event(void *arg, grunt_number_t event_type,
+	grunt_number_t event_id, const char *message) {
+
+	VSC_short_t *p_short = (VSC_short_t *)arg;
+	uint16 eid = (uint16)event_id;  /* the ID to send */
+	unsigned long entry = 0;  /* 1-based entry number, 0 if unknown */
+
+	if ((event_type == CFE_EVS_EventType_ERROR) &&
+		((event_id & 0xFF00) == (VSC_TBL_ZERO_ERR_EID & 0xFF00)) &&
+		(0 == strncmp(message, VSC_REPORT_ENTRY_PREFIX,
+			strlen(VSC_REPORT_ENTRY_PREFIX)))) {
+		entry = strtoul(message + strlen(VSC_REPORT_ENTRY_PREFIX),
+			NULL, 10);
+		if (entry > VSC_TABLE_NUM_ENTRIES) entry = 0;
+	}
+	if (entry) {
+		eid = VS_TBL_SHORT_EID(eid, VS_parm_class(p_short->p_images[
+			p_short->image].entries[entry - 1].parm_id)->name,
+			entry);
+		message = VS_TBL_SHORT_TEXT;
+	}
+
+#ifdef VSC_RESULT_CACHE
+	VS_cache_record_event(&VSC_cache, eid, (uint16)event_type, message);
+#endif
+	CFE_EVS_SendEvent(eid, (uint16)event_type, "%s", message);
+
+	if ((event_type != CFE_EVS_EventType_ERROR) &&
+		(event_id == VSC_VALIDATION_INF_EID)) {
+		p_short->image++;
+	}
+
+} /* VSC_table_short_event() */
+
+#elif defined(VSC_RESULT_CACHE)
+
+/* VSC_table_cache_event()
+ *
+ * in:     arg        - unused
+ *         event_type - type of event the validation program flushed
+ *         event_id   - ID of event the validation program flushed
+ *         message    - text of event the validation program flushed
+ * out:    nothing
+ * return: nothing
+ *
+ * The Grunt event sink for our validation program.  Records each
+ * event in VSC_cache for the image being validated and passes it on
+ * to EVS, as the interpreter would have without a sink.
+ */
+
+static void
+VSC_table_cache_event(void *arg, grunt_number_t event_type,
+	grunt_number_t event_id, const char *message) {
+
+	(void)arg;
+	VS_cache_record_event(&VSC_cache, (uint16)event_id,
+		(uint16)event_type, message);
+	CFE_EVS_SendEvent((uint16)event_id, (uint16)event_type, "%s",
+		message);
+
+} /* VSC_table_cache_event() */
+#endif
+
 	
+/* The statistics VSC_table_validate_timed() keeps on the
+ * validations TBL asks for, for housekeeping telemetry, and the cycle
+ * histogram it keeps on them in VS_CYCLE_HISTOGRAM builds.
+ */
+static VS_vstats_t VSC_vstats;
+static VS_tlm_cycles_payload_t VSC_cycles;
+#ifdef VS_CYCLE_HISTOGRAM
+static VS_tlm_cycles_t VSC_cycles_msg;   /* VSC_table_dump_cycles() */
+#endif
+
+
+#ifdef VSC_TWO_PASS_VF
+/* The summary our validation program's EMIT_INFO sends at the end of
+ * every run, which VSC_table_summarize() sends in its place for the
+ * images screening finds valid.
+ */
+static const char *VSC_summary_strings[] = {
+	"Table image entries: % valid, % invalid, % unused"
+};
+
+
+/* VSC_table_summarize()
+ *
+ * in:     p_table - table image the screening program found valid
+ * out:    nothing
+ * return: nothing
+ *
+ * Sends the VSC_VALIDATION_INF_EID summary event our validation
+ * program would have sent for the image, through the library's
+ * default VM as native code does, so that the event sink sees it as
+ * it would the program's.  Every entry of a valid image is valid, so
+ * the summary needs only the count of unused entries.
+ */
+
+static void
+VSC_table_summarize(const vsc_table_t *p_table) {
+
+	grunt_value_t counts[3];  /* unused invalid valid, as EMIT_INFO's */
+	grunt_number_t unused = 0;
+	int i;
+
+	for (i = 0; i < VSC_TABLE_NUM_ENTRIES; i++) {
+		if (p_table->entries[i].parm_id == VS_PARM_UNUSED) unused++;
+	}
+	for (i = 0; i < 3; i++) counts[i].type = gt_num;
+	counts[0].val.num = unused;
+	counts[1].val.num = 0;
+	counts[2].val.num = VSC_TABLE_NUM_ENTRIES - unused;
+
+	GRUNT_NativeInit(VSC_summary_strings, 1);
+	if (0 == GRUNT_NativeFormat(0, counts, 3)) {
+		GRUNT_NativeFlush(CFE_EVS_EventType_INFORMATION,
+			VSC_VALIDATION_INF_EID);
+	}
+
+} /* VSC_table_summarize() */
+#endif
+
+
 /* -------------------- module exported functions ------------------ */
 
 
+/* VSC_table_run()
+ *
+ * in:     p_table - table image to validate
+ * out:    nothing
+ * return: GRUNT_HALT_TRUE if the image is valid, GRUNT_HALT_FALSE or a
+ *         GRUNT_ERROR_* status code if it isn't.
+ *
+ * Runs our validation program over one image on the current engine.
+ * The program sends the image's events as it runs.
+ *
+ * In VSC_TWO_PASS_VF builds, the interpreter engines decide first
+ * with the screening program, which sends nothing, and run the
+ * program only for an image it finds invalid.  A valid image needs
+ * only its summary event, so it skips the program's counting and
+ * formatting.  A program the ground uplinked may decide otherwise
+ * than the screening program, so it always runs.
+ */
+
+static int32
+VSC_table_run(const vsc_table_t *p_table) {
+
+#ifdef VSC_NATIVE_VF
+	if (VSC_engine == VS_ENGINE_NATIVE)
+		return vsvf_native_run(p_table, sizeof(vsc_table_t));
+#endif
+#ifdef VSC_XMACRO_VF
+	if (VSC_engine == VS_ENGINE_XMACRO)
+		return vsvf_xmacro_run(p_table, sizeof(vsc_table_t));
+#endif
+#ifdef VSC_TWO_PASS_VF
+	if (!VSC_program_loaded && VSC_table_screen(p_table)) {
+		VSC_table_summarize(p_table);
+		return GRUNT_HALT_TRUE;
+	}
+#endif
+	if (VSC_prepared)
+		return GRUNT_RunPrepared(VSC_prepared, p_table,
+			sizeof(vsc_table_t));
+	return GRUNT_Run(VSC_program, VSC_num_instructions,
+		p_table, sizeof(vsc_table_t), VSC_strings, VSC_num_strings);
+
+} /* VSC_table_run() */
+
+
 /* VSC_table_validate()
  *
  * in:     TblData - pointer to table image to validate
@@ -76,18 +600,53 @@ VSC_table_validate(void *TblData) {
 
 	const vsc_table_t *p_table = (const vsc_table_t *)TblData; /* table */
 	CFE_Status_t result = VSC_TABLE_INVALID_RESULT;  /* presume invalid */
+#ifdef VSC_RESULT_CACHE
+	const vs_cache_slot_t *p_slot;   /* cached result for this image */
+#endif
 
 	/* Mark the start of validation function processing for
 	 * performance monitoring.
 	 */
 	CFE_ES_PerfLogEntry(VSC_VF_PERF_ID);
+
+#ifdef VSC_RESULT_CACHE
+	/* If we've validated this very image lately, send what we sent
+	 * then and return the same result.  Otherwise, record what we
+	 * send this time.
+	 */
+	if (NULL != (p_slot = VS_cache_lookup(&VSC_cache, p_table))) {
+#ifdef VSC_REPORT_TLM
+		if (p_slot->has_report) {
+			memcpy(&(VSC_report.msg.payload), &(p_slot->report),
+				sizeof(VSC_report.msg.payload));
+			CFE_SB_TimeStampMsg(CFE_MSG_PTR(VSC_report.msg.header));
+			CFE_SB_TransmitMsg(CFE_MSG_PTR(VSC_report.msg.header),
+				true);
+			memset(&(VSC_report.msg.payload), 0,
+				sizeof(VSC_report.msg.payload));
+		}
+#endif
+		result = VS_cache_replay(p_slot);
+		CFE_ES_PerfLogExit(VSC_VF_PERF_ID);
+		return result;
+	}
+	VS_cache_begin(&VSC_cache, p_table);
+#endif
 	
-	if (GRUNT_HALT_TRUE == GRUNT_Run(vsvf_program, VSVF_NUM_INSTRUCTIONS,
-		p_table, sizeof(vsc_table_t),
-		vsvf_strings, VSVF_NUM_STRINGS)) {
+#ifdef VSC_REPORT_TLM
+	VSC_table_report_begin(p_table);
+#elif defined(VSC_SHORT_EVENTS)
+	VSC_table_short_begin(p_table);
+#endif
+
+	if (GRUNT_HALT_TRUE == VSC_table_run(p_table)) {
 		result = CFE_SUCCESS;
 	}
 
+#ifdef VSC_RESULT_CACHE
+	VS_cache_end(&VSC_cache, result);
+#endif
+
 	/* Mark the stop of validation function processing for
 	 * performance monitoring.
 	 */
@@ -98,6 +657,103 @@ VSC_table_validate(void *TblData) {
 } /* VSC_table_validate() */
 
 
+/* VSC_table_validate_timed()
+ *
+ * in:     TblData - pointer to table image to validate
+ * out:    nothing
+ * return: VSC_table_validate()'s result.
+ *
+ * The validation function we register with TBL.  It runs
+ * VSC_table_validate() and records its result and how long it took
+ * in VSC_vstats, and the cycles it took in VSC_cycles.
+ *
+ */
+
+static CFE_Status_t     /* static b/c fxn is exported by pointer not linker */
+VSC_table_validate_timed(void *TblData) {
+
+	OS_time_t start;       /* when validation began */
+	uint64 cycles;         /* cycle counter when validation began */
+	CFE_Status_t result;   /* VSC_table_validate()'s verdict */
+
+	VS_vstats_start(&start);
+	cycles = VS_cycles_now();
+	result = VSC_table_validate(TblData);
+	VS_cycles_record(&VSC_cycles, cycles);
+	VS_vstats_record(&VSC_vstats, start, result);
+
+	return result;
+
+} /* VSC_table_validate_timed() */
+
+
+/* VSC_table_be32()
+ *
+ * in:     big_endian - 32-bit value as stored in big-endian byte order
+ * out:    nothing
+ * return: big_endian in host byte order.
+ */
+
+static uint32
+VSC_table_be32(uint32 big_endian) {
+
+	const uint8 *p = (const uint8 *)&big_endian;
+
+	return (((uint32)p[0] << 24) | ((uint32)p[1] << 16) |
+		((uint32)p[2] << 8) | (uint32)p[3]);
+
+} /* VSC_table_be32() */
+
+
+/* VSC_table_read_image()
+ *
+ * in:     filename - table file to read
+ * out:    p_image  - set to the table image the file holds
+ * return  value                     condition
+ *         -----                     ---------
+ *         CFE_SUCCESS               *p_image holds the file's image
+ *         VSC_TABLE_INVALID_RESULT  can't open file, or it isn't a
+ *                                   whole-table image of our table
+ *
+ * Reads a table file in the same format TBL loads: a cFE file header,
+ * a TBL table file header, and the table image.
+ */
+
+static CFE_Status_t
+VSC_table_read_image(const char *filename, vsc_table_t *p_image) {
+
+	CFE_FS_Header_t    fs_hdr;   /* cFE file header */
+	CFE_TBL_File_Hdr_t tbl_hdr;  /* TBL table file header */
+	osal_id_t fd;                /* open table file */
+	CFE_Status_t result = VSC_TABLE_INVALID_RESULT;  /* presume invalid */
+
+	if (OS_SUCCESS != OS_OpenCreate(&fd, filename, OS_FILE_FLAG_NONE,
+		OS_READ_ONLY))
+		return VSC_TABLE_INVALID_RESULT;
+
+	/* CFE_FS_ReadHeader() converts the cFE file header to host
+	 * byte order for us, but TBL table file headers are always
+	 * big-endian.  We accept only images of our whole table.
+	 */
+	if (((int32)sizeof(fs_hdr) == CFE_FS_ReadHeader(&fs_hdr, fd)) &&
+		(fs_hdr.SubType == CFE_FS_SubType_TBL_IMG) &&
+		((int32)sizeof(tbl_hdr) == OS_read(fd, &tbl_hdr,
+			sizeof(tbl_hdr))) &&
+		(0 == VSC_table_be32(tbl_hdr.Offset)) &&
+		(sizeof(vsc_table_t) == VSC_table_be32(tbl_hdr.NumBytes)) &&
+		(0 == strncmp(tbl_hdr.TableName, VSC_TABLE_FULL_NAME,
+			sizeof(tbl_hdr.TableName))) &&
+		((int32)sizeof(vsc_table_t) == OS_read(fd, p_image,
+			sizeof(vsc_table_t)))) {
+		result = CFE_SUCCESS;
+	}
+
+	OS_close(fd);
+	return result;
+
+} /* VSC_table_read_image() */
+
+
 /* VSC_table_init()
  *
  * in:     nothing
@@ -115,22 +771,91 @@ VSC_table_init(CFE_TBL_Handle_t *p_h_table) {
 
 	CFE_Status_t result;  /* holds error codes returned by functions */
 
+#ifdef VSC_REPORT_TLM
+	/* Collect our validation program's error events into our
+	 * validation report message.  Both the interpreter and native
+	 * code flush events through the library's default VM.
+	 */
+	CFE_MSG_Init(CFE_MSG_PTR(VSC_report.msg.header),
+		CFE_SB_ValueToMsgId(VSC_TLM_REPORT_MID),
+		sizeof(VSC_tlm_report_t));
+	GRUNT_SetEventSink(NULL, VSC_table_report_event, &VSC_report);
+#elif defined(VSC_SHORT_EVENTS)
+	/* Send our validation program's error events in short form. */
+	GRUNT_SetEventSink(NULL, VSC_table_short_event, &VSC_short);
+#elif defined(VSC_RESULT_CACHE)
+	/* Record our validation program's events as they go to EVS. */
+	GRUNT_SetEventSink(NULL, VSC_table_cache_event, NULL);
+#endif
+
+#ifdef GRUNT_PROFILE
+	CFE_MSG_Init(CFE_MSG_PTR(VSC_profile_msg.header),
+		CFE_SB_ValueToMsgId(VSC_TLM_PROFILE_MID),
+		sizeof(VSC_tlm_profile_t));
+#endif
+
+#ifdef GRUNT_TRACE
+	CFE_MSG_Init(CFE_MSG_PTR(VSC_trace_msg.header),
+		CFE_SB_ValueToMsgId(VSC_TLM_TRACE_MID),
+		sizeof(VSC_tlm_trace_t));
+#endif
+
+	/* Our validation program reads the table an entry at a time;
+	 * let the interpreter check each entry's bounds just once.
+	 */
+	GRUNT_SetRecordView(NULL, &VSC_record_view);
+
+	/* Spare the interpreter a strlen() on every string it outputs. */
+	GRUNT_SetStringLengths(NULL, vsvf_strings, vsvf_string_lengths);
+
+	/* Let tests see how validation divides its time between
+	 * setting up the VM, running our program, and sending events.
+	 */
+	GRUNT_SetPerfIDs(NULL, VSC_VM_INIT_PERF_ID, VSC_VM_RUN_PERF_ID,
+		VSC_VM_FLUSH_PERF_ID);
+
+	/* Prepare our Grunt validation function once, before TBL
+	 * first calls it, so that every validation runs it on the
+	 * interpreter's fastest engine for it without looking anything
+	 * up.  A program that fails to prepare still runs correctly on
+	 * the checked engines, so this isn't fatal.
+	 */
+	if (CFE_SUCCESS != (result = GRUNT_Prepare(vsvf_program,
+		VSVF_NUM_INSTRUCTIONS, vsvf_strings, VSVF_NUM_STRINGS,
+		VSC_PREPARE_FLAGS, &VSC_prepared))) {
+		CFE_ES_WriteToSysLog("%s: GRUNT_Prepare() returned 0x%08X"
+			"; %s will use checked validation.\n", VSC_APP_NAME,
+			result, VSC_APP_NAME);
+	}
+	if (CFE_SUCCESS != (result = GRUNT_Verify(vsvf_screen_program,
+		VSVF_SCREEN_NUM_INSTRUCTIONS, VSVF_SCREEN_NUM_STRINGS))) {
+		CFE_ES_WriteToSysLog("%s: GRUNT_Verify() returned 0x%08X"
+			"; %s will use checked screening.\n", VSC_APP_NAME,
+			result, VSC_APP_NAME);
+	}
+
+	/* Select our starting engine before TBL first calls our
+	 * validation function.  The checks above VSC_engine make sure
+	 * this build has it.
+	 */
+	(void)VSC_table_set_engine(VSC_engine);
+
 	/* Register our single vsc_table_t table with TBL. */
 	if (CFE_SUCCESS != (result = CFE_TBL_Register(p_h_table,
 		VSC_RAW_TABLE_NAME, sizeof(vsc_table_t), CFE_TBL_OPT_DEFAULT,
-		VSC_table_validate))) {
+		VSC_table_validate_timed))) {
 		CFE_ES_WriteToSysLog("%s: CFE_TBL_Register() returned 0x%08X"
 			"; %s will shutdown.\n", VSC_APP_NAME, result,
 			VSC_APP_NAME);
 		return result;
 	}
 
-	/* Load the default table values from the filesystem. */
+	/* Load the default table values. */
 	if (CFE_SUCCESS != (result = CFE_TBL_Load(*p_h_table,
-		CFE_TBL_SRC_FILE, VSC_DEFAULT_TABLE_FILENAME))) {
+		VSC_DEFAULT_TABLE_SRC, VSC_DEFAULT_TABLE))) {
 		CFE_ES_WriteToSysLog("%s: CFE_TBL_Load() of %s returned 0x%08X"
 			"; %s will shutdown.\n", VSC_APP_NAME,
-			VSC_DEFAULT_TABLE_FILENAME, result,
+			VSC_DEFAULT_TABLE_NAME, result,
 			VSC_APP_NAME);
 		return result;
 	}
@@ -140,3 +865,457 @@ VSC_table_init(CFE_TBL_Handle_t *p_h_table) {
 } /* VSC_table_init() */
 
 
+/* VSC_table_get_stats()
+ *
+ * in:     nothing
+ * out:    p_stats - set to the validation statistics so far
+ * return: nothing
+ *
+ * The app calls this function to fill in its housekeeping telemetry.
+ *
+ */
+
+void
+VSC_table_get_stats(VS_vstats_t *p_stats) {
+
+	*p_stats = VSC_vstats;
+
+} /* VSC_table_get_stats() */
+
+
+/* VSC_table_reset_stats()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: nothing
+ *
+ * The app calls this function when it resets its counters.
+ *
+ */
+
+void
+VSC_table_reset_stats(void) {
+
+	VS_vstats_reset(&VSC_vstats);
+	VS_cycles_reset(&VSC_cycles);
+
+} /* VSC_table_reset_stats() */
+
+
+#ifdef VS_CYCLE_HISTOGRAM
+/* VSC_table_dump_cycles()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: nothing
+ *
+ * The app calls this function to handle the VSC_DUMP_CYCLES_CC
+ * command.  It sends VSC_cycles in a VSC_TLM_CYCLES_MID message.
+ *
+ */
+
+void
+VSC_table_dump_cycles(void) {
+
+	VS_cycles_send(&VSC_cycles_msg, VSC_TLM_CYCLES_MID, &VSC_cycles);
+
+} /* VSC_table_dump_cycles() */
+#endif
+
+
+/* VSC_table_set_engine()
+ *
+ * in:     engine - VS_ENGINE_* engine to validate tables with
+ * out:    VSC_engine - set to engine, if this build has it
+ * return: true if this build has engine, false if it doesn't.
+ *
+ * The app calls this function to switch engines on ground command.
+ * Every engine validates a table identically; they differ only in
+ * how fast they do it.  VS_ENGINE_GRUNT runs our program on the
+ * fastest engine the Grunt library has for it, VS_ENGINE_SWITCH and
+ * VS_ENGINE_THREADED on its checked engines, VS_ENGINE_NATIVE, in
+ * VSC_NATIVE_VF builds only, runs its gruntaot translation, and
+ * VS_ENGINE_XMACRO, in VSC_XMACRO_VF builds only, its grunt_xmacro.h
+ * expansion.
+ */
+
+bool
+VSC_table_set_engine(uint8 engine) {
+
+	switch (engine) {
+	case VS_ENGINE_GRUNT:
+		GRUNT_SetEngine(NULL, GRUNT_ENGINE_AUTO);
+		break;
+	case VS_ENGINE_SWITCH:
+		GRUNT_SetEngine(NULL, GRUNT_ENGINE_SWITCH);
+		break;
+	case VS_ENGINE_THREADED:
+		GRUNT_SetEngine(NULL, GRUNT_ENGINE_THREADED);
+		break;
+#ifdef VSC_NATIVE_VF
+	case VS_ENGINE_NATIVE:
+		break;
+#endif
+#ifdef VSC_XMACRO_VF
+	case VS_ENGINE_XMACRO:
+		break;
+#endif
+	default:
+		return false;
+	}
+
+	VSC_engine = engine;
+	return true;
+
+} /* VSC_table_set_engine() */
+
+
+/* VSC_table_get_engine()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: the VS_ENGINE_* engine the app validates tables with.
+ *
+ * The app calls this function to fill in its housekeeping telemetry.
+ *
+ */
+
+uint8
+VSC_table_get_engine(void) {
+
+	return VSC_engine;
+
+} /* VSC_table_get_engine() */
+
+
+/* VSC_table_validate_batch()
+ *
+ * in:     p_batch - names of staged candidate table files to validate
+ * out:    nothing
+ * return: nothing
+ *
+ * The app's housekeeping function calls this function to validate a
+ * batch of candidate table files the ground staged with the
+ * VSC_VALIDATE_BATCH_CC command.  It reads each file and runs our
+ * validation function over all of the images it could read in a
+ * single GRUNT_RunBatch() call.  Each invalid image produces the
+ * same events or validation report TBL validation would.  Finally, a single
+ * VSC_BATCH_INF_EID event reports which images are valid and which
+ * files couldn't be read as bitmasks indexed by filename position.
+ *
+ * The caller must have checked that p_batch->num_images is between
+ * 1 and VSC_BATCH_MAX_IMAGES and that each filename in use is
+ * NUL-terminated.
+ */
+
+void
+VSC_table_validate_batch(const VSC_cmd_batch_payload_t *p_batch) {
+
+	static vsc_table_t images[VSC_BATCH_MAX_IMAGES];  /* images read */
+	uint8 index[VSC_BATCH_MAX_IMAGES];   /* filename index of images[i] */
+	int32 results[VSC_BATCH_MAX_IMAGES]; /* validation status of images */
+	uint16 num_read = 0;                 /* # images read into images[] */
+	uint8 valid_mask = 0;                /* bit i set if file i is valid */
+	uint8 unreadable_mask = 0;           /* bit i set if can't read i */
+	uint16 i;
+
+	for (i = 0; i < p_batch->num_images; i++) {
+		if (CFE_SUCCESS == VSC_table_read_image(
+			p_batch->filenames[i], &(images[num_read]))) {
+			index[num_read++] = (uint8)i;
+		} else {
+			unreadable_mask |= (uint8)(1 << i);
+		}
+	}
+
+#ifdef VSC_REPORT_TLM
+	VSC_table_report_begin(images);
+#elif defined(VSC_SHORT_EVENTS)
+	VSC_table_short_begin(images);
+#endif
+
+	if ((VSC_engine == VS_ENGINE_NATIVE) ||
+		(VSC_engine == VS_ENGINE_XMACRO)) {
+		for (i = 0; i < num_read; i++)
+			results[i] = VSC_table_run(&(images[i]));
+	} else if (VSC_prepared) {
+		for (i = 0; i < num_read; i++)
+			results[i] = GRUNT_RunPrepared(VSC_prepared,
+				&(images[i]), sizeof(vsc_table_t));
+	} else {
+		GRUNT_RunBatch(VSC_program, VSC_num_instructions, images,
+			sizeof(vsc_table_t), num_read, VSC_strings,
+			VSC_num_strings, results);
+	}
+
+	for (i = 0; i < num_read; i++) {
+		if (results[i] == GRUNT_HALT_TRUE)
+			valid_mask |= (uint8)(1 << index[i]);
+	}
+
+	CFE_EVS_SendEvent(VSC_BATCH_INF_EID, CFE_EVS_EventType_INFORMATION,
+		"%s: batch of %u files: valid mask 0x%02X, "
+		"unreadable mask 0x%02X.", VSC_APP_NAME,
+		(unsigned int)p_batch->num_images, (unsigned int)valid_mask,
+		(unsigned int)unreadable_mask);
+
+} /* VSC_table_validate_batch() */
+
+
+/* VSC_table_screen()
+ *
+ * in:     p_image - table image to screen
+ * out:    nothing
+ * return: true if our validation program would find the image valid,
+ *         else false.
+ *
+ * The app's SCREEN command calls this function for each image the
+ * ground asks about.  Rather than our validation program, it runs
+ * vsvf_screen.gasm, which reaches the same verdict but sends no
+ * events and halts at the first problem it finds, so a bad image
+ * costs only the steps up to its first invalid entry.  It runs on
+ * the interpreter whatever VSC_engine says, and it leaves VSC_vstats
+ * and the validation result cache alone.
+ */
+
+bool
+VSC_table_screen(const vs_table_t *p_image) {
+
+	return (GRUNT_HALT_TRUE == GRUNT_Run(vsvf_screen_program,
+		VSVF_SCREEN_NUM_INSTRUCTIONS, p_image, sizeof(vsc_table_t),
+		vsvf_screen_strings, VSVF_SCREEN_NUM_STRINGS));
+
+} /* VSC_table_screen() */
+
+
+/* VSC_table_load_program()
+ *
+ * in:     filename - file holding a serialized Grunt program
+ * out:    VSC_program, VSC_strings, and their counts - set to the
+ *                    program and its string table, if it loads
+ *         VSC_prepared - the loaded program's handle, if it loads
+ *         VSC_engine - VS_ENGINE_GRUNT, if it loads
+ * return: true if the program loaded, else false.
+ *
+ * The app calls this function to handle the VSC_LOAD_PROGRAM_CC
+ * command.  It reads the file, decodes the serialized program it
+ * holds, and prepares the program once, here, so that every later
+ * validation runs it on the fastest engine the Grunt library has for
+ * it.  A program that doesn't verify doesn't load: unlike our
+ * built-in program, nobody has checked it before flight.  The
+ * program must read tables as our built-in program does, since the
+ * interpreter keeps the same record view.  The SCREEN command and
+ * the native engines keep running the code built into the app.
+ *
+ * Side effect: emits an information event describing the program
+ * loaded, or an error event saying why it didn't load.
+ */
+
+bool
+VSC_table_load_program(const char *filename) {
+
+	osal_id_t fd;        /* open program file */
+	uint32 size = 0;     /* bytes read into VSC_load_buffer[] */
+	int32 count;         /* bytes one OS_read() returned */
+	int32 result;
+
+	/* GRUNT_Prepare() would keep running the first program it
+	 * prepared here in place of any we read in over it.
+	 */
+	if (VSC_program_loaded) {
+		CFE_EVS_SendEvent(VSC_PROGRAM_ERR_EID,
+			CFE_EVS_EventType_ERROR,
+			"%s: a program is loaded already; restart to load %s.",
+			VSC_APP_NAME, filename);
+		return false;
+	}
+
+	if (OS_SUCCESS != OS_OpenCreate(&fd, filename, OS_FILE_FLAG_NONE,
+		OS_READ_ONLY)) {
+		CFE_EVS_SendEvent(VSC_PROGRAM_ERR_EID,
+			CFE_EVS_EventType_ERROR, "%s: can't open %s.",
+			VSC_APP_NAME, filename);
+		return false;
+	}
+	while ((size < sizeof(VSC_load_buffer)) && (0 < (count = OS_read(fd,
+		&(VSC_load_buffer[size]), sizeof(VSC_load_buffer) - size))))
+		size += (uint32)count;
+	OS_close(fd);
+
+	if (size > VSC_PROGRAM_MAX_BYTES) {
+		CFE_EVS_SendEvent(VSC_PROGRAM_ERR_EID,
+			CFE_EVS_EventType_ERROR,
+			"%s: %s is longer than %u bytes.", VSC_APP_NAME,
+			filename, (unsigned int)VSC_PROGRAM_MAX_BYTES);
+		return false;
+	}
+
+	if (CFE_SUCCESS != (result = GRUNT_Deserialize(VSC_load_buffer,
+		size, &VSC_loaded))) {
+		CFE_EVS_SendEvent(VSC_PROGRAM_ERR_EID,
+			CFE_EVS_EventType_ERROR,
+			"%s: can't decode %s: status 0x%02X.", VSC_APP_NAME,
+			filename, (unsigned int)result);
+		return false;
+	}
+
+	if (CFE_SUCCESS != (result = GRUNT_Prepare(VSC_loaded.code,
+		VSC_loaded.num_instructions, VSC_loaded.strings,
+		VSC_loaded.num_strings, 0, &VSC_prepared))) {
+		CFE_EVS_SendEvent(VSC_PROGRAM_ERR_EID,
+			CFE_EVS_EventType_ERROR,
+			"%s: program in %s failed verification: status 0x%02X.",
+			VSC_APP_NAME, filename, (unsigned int)result);
+		return false;
+	}
+
+	VSC_program          = VSC_loaded.code;
+	VSC_num_instructions = VSC_loaded.num_instructions;
+	VSC_strings          = VSC_loaded.strings;
+	VSC_num_strings      = VSC_loaded.num_strings;
+	VSC_program_loaded   = true;
+	(void)VSC_table_set_engine(VS_ENGINE_GRUNT);
+
+#ifdef VSC_RESULT_CACHE
+	/* The new program may not agree with what the old one said. */
+	memset(&VSC_cache, 0, sizeof(VSC_cache));
+#endif
+
+	CFE_EVS_SendEvent(VSC_PROGRAM_INF_EID, CFE_EVS_EventType_INFORMATION,
+		"%s: loaded %s: %u instructions, %u strings in %lu bytes.",
+		VSC_APP_NAME, filename,
+		(unsigned int)VSC_loaded.num_instructions,
+		(unsigned int)VSC_loaded.num_strings, (unsigned long)size);
+	return true;
+
+} /* VSC_table_load_program() */
+
+
+
+
+#ifdef GRUNT_PROFILE
+
+/* VSC_table_dump_profile()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: nothing
+ *
+ * The app calls this function to handle the VSC_DUMP_PROFILE_CC
+ * command.  It sends the interpreter's profile of our validation
+ * program as the series of VSC_TLM_PROFILE_MID messages described in
+ * vsc_msgstruct.h, then clears the profile so the next dump covers
+ * only the validations in between.  Table validation, batch
+ * validation, and this function all run in the app's main task, so
+ * the profile can't change while we copy it.
+ */
+
+void
+VSC_table_dump_profile(void) {
+
+	const grunt_profile_t *p_profile = GRUNT_GetProfile(NULL);
+	VSC_tlm_profile_payload_t *p_payload = &(VSC_profile_msg.payload);
+	uint16 first;   /* first pc of the current message */
+	uint16 i;
+
+	memset(p_payload, 0, sizeof(*p_payload));
+	p_payload->num_msgs     = VSC_PROFILE_NUM_MSGS;
+	p_payload->runs         = p_profile->runs;
+	p_payload->instructions = p_profile->instructions;
+	p_payload->samples      = p_profile->samples;
+	for (i = 0; i < VSC_PROFILE_NUM_OPCODES; i++) {
+		p_payload->ops[i].count   = p_profile->op_count[i];
+		p_payload->ops[i].samples = p_profile->op_samples[i];
+		if (p_profile->op_samples[i]) {
+			p_payload->ops[i].mean_ticks = (uint32)
+				(p_profile->op_ticks[i] /
+				 p_profile->op_samples[i]);
+		}
+	}
+	for (i = 0; i < VSC_PROFILE_NUM_BUCKETS; i++)
+		p_payload->histogram[i] = p_profile->histogram[i];
+
+	for (first = 0; first < VSC_PROFILE_NUM_PCS;
+		first += VSC_PROFILE_PCS_PER_MSG) {
+		p_payload->first_pc = first;
+		p_payload->num_pcs  = ((VSC_PROFILE_NUM_PCS - first) <
+			VSC_PROFILE_PCS_PER_MSG) ? (VSC_PROFILE_NUM_PCS - first)
+			: VSC_PROFILE_PCS_PER_MSG;
+		memset(p_payload->pc_count, 0, sizeof(p_payload->pc_count));
+		for (i = 0; i < p_payload->num_pcs; i++)
+			p_payload->pc_count[i] = p_profile->pc_count[first + i];
+
+		CFE_SB_TimeStampMsg(CFE_MSG_PTR(VSC_profile_msg.header));
+		CFE_SB_TransmitMsg(CFE_MSG_PTR(VSC_profile_msg.header), true);
+		p_payload->seq++;
+	}
+
+	GRUNT_ResetProfile(NULL);
+
+} /* VSC_table_dump_profile() */
+
+#endif /* GRUNT_PROFILE */
+
+
+#ifdef GRUNT_TRACE
+
+/* VSC_table_dump_trace()
+ *
+ * in:     num_steps - number of the trace's latest steps to send, or
+ *                     0 for all it keeps
+ * out:    nothing
+ * return: nothing
+ *
+ * The app calls this function to handle the VSC_DUMP_TRACE_CC
+ * command.  It sends the latest steps of the interpreter's trace of
+ * our validation program, oldest first, as the series of
+ * VSC_TLM_TRACE_MID messages described in vsc_msgstruct.h.  As with
+ * the profile, nothing else runs our program while we copy them.
+ */
+
+void
+VSC_table_dump_trace(uint16 num_steps) {
+
+	const grunt_trace_t *p_trace = GRUNT_GetTrace(NULL);
+	VSC_tlm_trace_payload_t *p_payload = &(VSC_trace_msg.payload);
+	const grunt_trace_step_t *p_step;
+	uint32 kept;    /* steps the ring still holds */
+	uint32 step;    /* number of the next step to send */
+	uint16 i;
+
+	kept = ((p_trace->steps < GRUNT_TRACE_SIZE) ? p_trace->steps :
+		GRUNT_TRACE_SIZE);
+	if ((num_steps == 0) || (num_steps > kept)) num_steps = (uint16)kept;
+
+	/* An empty trace still goes out, as one message of no steps. */
+	memset(p_payload, 0, sizeof(*p_payload));
+	p_payload->num_msgs    = (uint8)(num_steps ? ((num_steps +
+		VSC_TRACE_STEPS_PER_MSG - 1) / VSC_TRACE_STEPS_PER_MSG) : 1);
+	p_payload->total_steps = p_trace->steps;
+
+	step = p_trace->steps - num_steps;
+	do {
+		p_payload->first_step = step;
+		p_payload->num_steps  = ((p_trace->steps - step) <
+			VSC_TRACE_STEPS_PER_MSG) ?
+			(uint16)(p_trace->steps - step) :
+			VSC_TRACE_STEPS_PER_MSG;
+		memset(p_payload->steps, 0, sizeof(p_payload->steps));
+		for (i = 0; i < p_payload->num_steps; i++) {
+			p_step = &(p_trace->ring[(step + i) &
+				(GRUNT_TRACE_SIZE - 1)]);
+			p_payload->steps[i].pc   = p_step->pc;
+			p_payload->steps[i].op   = p_step->op;
+			p_payload->steps[i].type = p_step->type;
+			p_payload->steps[i].top  = p_step->top;
+		}
+
+		CFE_SB_TimeStampMsg(CFE_MSG_PTR(VSC_trace_msg.header));
+		CFE_SB_TransmitMsg(CFE_MSG_PTR(VSC_trace_msg.header), true);
+		p_payload->seq++;
+		step += p_payload->num_steps;
+	} while (step < p_trace->steps);
+
+} /* VSC_table_dump_trace() */
+
+#endif /* GRUNT_TRACE */
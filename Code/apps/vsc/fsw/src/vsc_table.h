@@ -16,6 +16,22 @@
  * permissions and limitations under the License.
  */
 
+#include "vs_msgstruct.h"    /* for VS_vstats_t */
+
 CFE_Status_t VSC_table_init(CFE_TBL_Handle_t *);
+void VSC_table_get_stats(VS_vstats_t *);
+void VSC_table_reset_stats(void);
+void VSC_table_dump_cycles(void);
+bool VSC_table_set_engine(uint8);
+uint8 VSC_table_get_engine(void);
+void VSC_table_validate_batch(const VSC_cmd_batch_payload_t *);
+bool VSC_table_screen(const vs_table_t *);
+bool VSC_table_load_program(const char *);
+#ifdef GRUNT_PROFILE
+void VSC_table_dump_profile(void);
+#endif
+#ifdef GRUNT_TRACE
+void VSC_table_dump_trace(uint16);
+#endif
 
 #endif
@@ -0,0 +1,1494 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* GENERATED FILE - DO NOT EDIT.
+ *
+ * The gruntaot translator generated this file from the Grunt program
+ * in vsvf.h.  Edit the program and run gruntaot again instead.
+ */
+
+#include "cfe.h"
+
+#include "grunt.h"
+#include "grunt_status.h"
+
+typedef struct {
+	grunt_value_t stack[GRUNT_STACK_SIZE];  /* arg stack */
+	int arg_count;           /* count of elements on arg stack */
+	int ctl_count;           /* count of control stack slots in use */
+	const char *input;       /* the input data queue */
+	grunt_rep_t input_size;  /* size of input data in bytes */
+	grunt_rep_t head_index;  /* index of next char to dequeue */
+	grunt_pc_t error_pc;     /* pc of instruction that failed */
+} gn_vm_t;
+
+
+static inline int
+gn_fail(gn_vm_t *p_vm, int status, grunt_pc_t pc) {
+	p_vm->error_pc = pc;
+	return status;
+}
+
+
+static inline int
+gn_push(gn_vm_t *p_vm, const grunt_value_t *p_v) {
+	if ((p_vm->arg_count + p_vm->ctl_count + 1) > GRUNT_STACK_SIZE)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	p_vm->stack[p_vm->arg_count++] = *p_v;
+	return 0;
+}
+
+
+static inline int
+gn_push_bool(gn_vm_t *p_vm, grunt_boolean_t b) {
+	grunt_value_t v;
+	v.type = gt_bool;
+	v.val.b = b;
+	return gn_push(p_vm, &v);
+}
+
+
+static inline int
+gn_push_num(gn_vm_t *p_vm, grunt_number_t num) {
+	grunt_value_t v;
+	v.type = gt_num;
+	v.val.num = num;
+	return gn_push(p_vm, &v);
+}
+
+
+static inline int
+gn_push_str(gn_vm_t *p_vm, grunt_string_t str) {
+	grunt_value_t v;
+	v.type = gt_str;
+	v.val.str = str;
+	return gn_push(p_vm, &v);
+}
+
+
+static inline int
+gn_pop(gn_vm_t *p_vm, grunt_value_t *p_v) {
+	if (p_vm->arg_count == 0) return GRUNT_ERROR_OUTOFBOUNDS;
+	*p_v = p_vm->stack[--p_vm->arg_count];
+	return 0;
+}
+
+
+static inline int
+gn_pop_type(gn_vm_t *p_vm, grunt_value_t *p_v, grunt_value_type_t t) {
+	if (p_vm->arg_count == 0) return GRUNT_ERROR_OUTOFBOUNDS;
+	*p_v = p_vm->stack[--p_vm->arg_count];
+	if (p_v->type != t) return GRUNT_ERROR_INVALIDARGUMENT;
+	return 0;
+}
+
+
+static inline int
+gn_add_sub(gn_vm_t *p_vm, bool add_flag) {
+	grunt_value_t a, b;
+	int status;
+	if ((status = gn_pop_type(p_vm, &b, gt_num))) return status;
+	if ((status = gn_pop_type(p_vm, &a, gt_num))) return status;
+	if (add_flag) {
+		if (b.val.num > (GRUNT_NUM_MAX - a.val.num))
+			return GRUNT_ERROR_OUTOFBOUNDS;
+		a.val.num += b.val.num;
+	} else {
+		if (a.val.num < b.val.num) return GRUNT_ERROR_OUTOFBOUNDS;
+		a.val.num -= b.val.num;
+	}
+	return gn_push(p_vm, &a);
+}
+
+
+static inline int
+gn_and_or(gn_vm_t *p_vm, grunt_rep_t n, bool and_flag) {
+	grunt_value_t a, b;
+	grunt_rep_t i;
+	int status;
+	if ((status = gn_pop_type(p_vm, &a, gt_bool))) return status;
+	for (i = 1; i < n; i++) {
+		if ((status = gn_pop_type(p_vm, &b, gt_bool))) return status;
+		a.val.b = (and_flag ? a.val.b && b.val.b : a.val.b || b.val.b);
+	}
+	return gn_push(p_vm, &a);
+}
+
+
+static inline int
+gn_eq(gn_vm_t *p_vm, grunt_rep_t n) {
+	grunt_value_t a, b;
+	grunt_rep_t i;
+	bool equal_flag = true;
+	int status;
+	if ((status = gn_pop_type(p_vm, &a, gt_num))) return status;
+	for (i = 1; i < n; i++) {
+		if ((status = gn_pop_type(p_vm, &b, gt_num))) return status;
+		if (a.val.num != b.val.num) equal_flag = false;
+	}
+	return gn_push_bool(p_vm, equal_flag);
+}
+
+
+static inline int
+gn_lt_gt(gn_vm_t *p_vm, bool lt_flag) {
+	grunt_value_t a, b;
+	int status;
+	if ((status = gn_pop_type(p_vm, &b, gt_num))) return status;
+	if ((status = gn_pop_type(p_vm, &a, gt_num))) return status;
+	return gn_push_bool(p_vm, (lt_flag ? a.val.num < b.val.num :
+		a.val.num > b.val.num));
+}
+
+
+static inline int
+gn_not(gn_vm_t *p_vm) {
+	grunt_value_t a;
+	int status;
+	if ((status = gn_pop_type(p_vm, &a, gt_bool))) return status;
+	return gn_push_bool(p_vm, !a.val.b);
+}
+
+
+static inline int
+gn_dup(gn_vm_t *p_vm, grunt_rep_t n) {
+	if (p_vm->arg_count < n) return GRUNT_ERROR_OUTOFBOUNDS;
+	if ((p_vm->arg_count + p_vm->ctl_count + n) > GRUNT_STACK_SIZE)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	memcpy(&(p_vm->stack[p_vm->arg_count]),
+		&(p_vm->stack[p_vm->arg_count - n]), (n * sizeof(grunt_value_t)));
+	p_vm->arg_count += n;
+	return 0;
+}
+
+
+static inline int
+gn_roll(gn_vm_t *p_vm, grunt_rep_t n) {
+	grunt_value_t temp;
+	if (p_vm->arg_count < n) return GRUNT_ERROR_OUTOFBOUNDS;
+	temp = p_vm->stack[p_vm->arg_count - 1];
+	memmove(&(p_vm->stack[p_vm->arg_count - n + 1]),
+		&(p_vm->stack[p_vm->arg_count - n]),
+		((n - 1) * sizeof(grunt_value_t)));
+	p_vm->stack[p_vm->arg_count - n] = temp;
+	return 0;
+}
+
+
+static inline int
+gn_pop_n(gn_vm_t *p_vm, grunt_rep_t n) {
+	if (p_vm->arg_count < n) {
+		p_vm->arg_count = 0;  /* interpreter pops what it can */
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	}
+	p_vm->arg_count -= n;
+	return 0;
+}
+
+
+static inline int
+gn_input(gn_vm_t *p_vm, grunt_rep_t n) {
+	uint32 u32;
+	uint16 u16;
+	uint8  u8;
+	if (!p_vm->input) return GRUNT_ERROR_INTERPRETERBUG;
+	if ((p_vm->head_index + n) > p_vm->input_size)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	switch (n) {
+	case 4:
+		memcpy(&u32, &(p_vm->input[p_vm->head_index]), 4);
+		p_vm->head_index += 4;
+		return gn_push_num(p_vm, u32);
+	case 2:
+		memcpy(&u16, &(p_vm->input[p_vm->head_index]), 2);
+		p_vm->head_index += 2;
+		return gn_push_num(p_vm, u16);
+	default:
+		memcpy(&u8, &(p_vm->input[p_vm->head_index]), 1);
+		p_vm->head_index += 1;
+		return gn_push_num(p_vm, u8);
+	}
+}
+
+
+static inline int
+gn_inputrec(gn_vm_t *p_vm, grunt_rep_t layout, grunt_rep_t size) {
+	grunt_rep_t w;
+	int status;
+	if (!p_vm->input) return GRUNT_ERROR_INTERPRETERBUG;
+	if ((p_vm->head_index + size) > p_vm->input_size)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	for (; layout; layout >>= 2) {
+		w = (((layout & 3) == 3) ? 4 : (layout & 3));
+		if ((status = gn_input(p_vm, w))) return status;
+	}
+	return 0;
+}
+
+
+static inline int
+gn_inputz(gn_vm_t *p_vm, grunt_rep_t n) {
+	uint8 any = 0;
+	if (!p_vm->input) return GRUNT_ERROR_INTERPRETERBUG;
+	if ((p_vm->head_index + n) > p_vm->input_size)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	while (n--) any |= (uint8)p_vm->input[p_vm->head_index++];
+	return gn_push_bool(p_vm, (any == 0));
+}
+
+
+static inline int
+gn_rewind(gn_vm_t *p_vm, grunt_rep_t n) {
+	if (n > p_vm->head_index) return GRUNT_ERROR_OUTOFBOUNDS;
+	p_vm->head_index = (n ? p_vm->head_index - n : 0);
+	return 0;
+}
+
+
+static inline int
+gn_output(gn_vm_t *p_vm) {
+	grunt_value_t a;
+	int status;
+	if ((status = gn_pop(p_vm, &a))) return status;
+	return GRUNT_NativeOutput(&a);
+}
+
+
+static inline int
+gn_format(gn_vm_t *p_vm, grunt_rep_t n) {
+	grunt_value_t t, v[GRUNT_FORMAT_MAX_VALUES];
+	int i, status;
+	if ((status = gn_pop_type(p_vm, &t, gt_str))) return status;
+	for (i = n - 1; i >= 0; i--) {
+		if ((status = gn_pop(p_vm, &(v[i])))) return status;
+	}
+	return GRUNT_NativeFormat(t.val.str, v, n);
+}
+
+
+static inline int
+gn_classify(gn_vm_t *p_vm, grunt_rep_t names) {
+	grunt_value_t row[4];
+	int i, status;
+	if ((status = gn_pop_type(p_vm, &(row[0]), gt_num))) return status;
+	if ((status = GRUNT_NativeClassify(row, row[0].val.num, names)))
+		return status;
+	for (i = 0; i < 4; i++) {
+		if ((status = gn_push(p_vm, &(row[i])))) return status;
+	}
+	return 0;
+}
+
+
+static inline int
+gn_flush(gn_vm_t *p_vm) {
+	grunt_value_t a, b;
+	int status;
+	if ((status = gn_pop_type(p_vm, &a, gt_num))) return status;
+	if ((status = gn_pop_type(p_vm, &b, gt_num))) return status;
+	GRUNT_NativeFlush(a.val.num, b.val.num);
+	return 0;
+}
+
+
+static inline int
+gn_halt(gn_vm_t *p_vm) {
+	grunt_value_t a;
+	int status;
+	if ((status = gn_pop_type(p_vm, &a, gt_bool))) return status;
+	return (a.val.b ? GRUNT_HALT_TRUE : GRUNT_HALT_FALSE);
+}
+
+
+static inline int
+gn_test(gn_vm_t *p_vm, bool *p_b) {
+	grunt_value_t a;
+	int status;
+	if ((status = gn_pop_type(p_vm, &a, gt_bool))) return status;
+	*p_b = a.val.b;
+	return 0;
+}
+
+
+static inline int
+gn_call(gn_vm_t *p_vm) {
+	if ((p_vm->arg_count + p_vm->ctl_count + 1) > GRUNT_STACK_SIZE)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	p_vm->ctl_count++;
+	return 0;
+}
+
+
+static inline int
+gn_return(gn_vm_t *p_vm) {
+	if (p_vm->ctl_count == 0) return GRUNT_ERROR_OUTOFBOUNDS;
+	p_vm->ctl_count--;
+	return 0;
+}
+
+
+static inline int
+gn_repeat(gn_vm_t *p_vm) {
+	if ((p_vm->arg_count + p_vm->ctl_count + 2) > GRUNT_STACK_SIZE)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	p_vm->ctl_count += 2;
+	return 0;
+}
+
+
+#include "vsvf_native.h"
+
+static const char *vsvf_native_strings[] = {
+	"Table image entries: % valid, % invalid, % unused",  /* s0 */
+	"Table entry % parm %%",  /* s1 */
+	"Table entry % invalid Parm ID",  /* s2 */
+	" not zeroed",  /* s3 */
+	" padding not zeroed",  /* s4 */
+	" invalid low bound",  /* s5 */
+	" invalid high bound",  /* s6 */
+	" invalid bound order",  /* s7 */
+	" follows an unused entry",  /* s8 */
+	" redefines earlier entry",  /* s9 */
+	"Unknown",  /* s10 */
+	"Unused",  /* s11 */
+	"Ape",  /* s12 */
+	"Bat",  /* s13 */
+	"Cat",  /* s14 */
+	"Dog",  /* s15 */
+	"North",  /* s16 */
+	"South",  /* s17 */
+	"East",  /* s18 */
+	"West",  /* s19 */
+};
+
+
+static int vsvf_native_pc0(gn_vm_t *);
+static int vsvf_native_pc23(gn_vm_t *);
+static int vsvf_native_pc64(gn_vm_t *);
+static int vsvf_native_pc67(gn_vm_t *);
+static int vsvf_native_pc80(gn_vm_t *);
+static int vsvf_native_pc106(gn_vm_t *);
+static int vsvf_native_pc120(gn_vm_t *);
+static int vsvf_native_pc151(gn_vm_t *);
+static int vsvf_native_pc166(gn_vm_t *);
+static int vsvf_native_pc179(gn_vm_t *);
+static int vsvf_native_pc194(gn_vm_t *);
+static int vsvf_native_pc220(gn_vm_t *);
+static int vsvf_native_pc224(gn_vm_t *);
+static int vsvf_native_pc230(gn_vm_t *);
+static int vsvf_native_pc235(gn_vm_t *);
+static int vsvf_native_pc242(gn_vm_t *);
+static int vsvf_native_pc249(gn_vm_t *);
+static int vsvf_native_pc255(gn_vm_t *);
+static int vsvf_native_pc261(gn_vm_t *);
+
+
+static int
+vsvf_native_pc0(gn_vm_t *p_vm) {
+
+	int status;
+	grunt_number_t loop6;
+
+	/* 0: PUSHN 0x00000000 */
+	if ((status = gn_push_num(p_vm, 0x00000000U)))
+		return gn_fail(p_vm, status, 0);
+	/* 1: PUSHN 0x00000000 */
+	if ((status = gn_push_num(p_vm, 0x00000000U)))
+		return gn_fail(p_vm, status, 1);
+	/* 2: PUSHN 0x00000000 */
+	if ((status = gn_push_num(p_vm, 0x00000000U)))
+		return gn_fail(p_vm, status, 2);
+	/* 3: PUSHN 0x00000000 */
+	if ((status = gn_push_num(p_vm, 0x00000000U)))
+		return gn_fail(p_vm, status, 3);
+	/* 4: PUSHN 0x00000000 */
+	if ((status = gn_push_num(p_vm, 0x00000000U)))
+		return gn_fail(p_vm, status, 4);
+	/* 5: PUSHN 0x00000001 */
+	if ((status = gn_push_num(p_vm, 0x00000001U)))
+		return gn_fail(p_vm, status, 5);
+	/* 6: REPEAT 4 */
+	if ((status = gn_repeat(p_vm)))
+		return gn_fail(p_vm, status, 6);
+	loop6 = 4U;
+pc7:
+	/* 7: DUP 3 */
+	if ((status = gn_dup(p_vm, 3)))
+		return gn_fail(p_vm, status, 7);
+	/* 8: ROLL 9 */
+	if ((status = gn_roll(p_vm, 9)))
+		return gn_fail(p_vm, status, 8);
+	/* 9: ROLL 9 */
+	if ((status = gn_roll(p_vm, 9)))
+		return gn_fail(p_vm, status, 9);
+	/* 10: ROLL 9 */
+	if ((status = gn_roll(p_vm, 9)))
+		return gn_fail(p_vm, status, 10);
+	/* 11: CALL 23 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 11);
+	if ((status = vsvf_native_pc23(p_vm))) return status;
+	/* 12: ROLL 4 */
+	if ((status = gn_roll(p_vm, 4)))
+		return gn_fail(p_vm, status, 12);
+	/* 13: ROLL 6 */
+	if ((status = gn_roll(p_vm, 6)))
+		return gn_fail(p_vm, status, 13);
+	/* 14: ROLL 6 */
+	if ((status = gn_roll(p_vm, 6)))
+		return gn_fail(p_vm, status, 14);
+	/* 15: PUSHN 0x00000001 */
+	if ((status = gn_push_num(p_vm, 0x00000001U)))
+		return gn_fail(p_vm, status, 15);
+	/* 16: ADD */
+	if ((status = gn_add_sub(p_vm, true)))
+		return gn_fail(p_vm, status, 16);
+	/* 17: END */
+	if (--loop6) goto pc7;
+	p_vm->ctl_count -= 2;
+	/* 18: POP 4 */
+	if ((status = gn_pop_n(p_vm, 4)))
+		return gn_fail(p_vm, status, 18);
+	/* 19: CALL 235 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 19);
+	if ((status = vsvf_native_pc235(p_vm))) return status;
+	/* 20: CALL 242 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 20);
+	if ((status = vsvf_native_pc242(p_vm))) return status;
+	/* 21: CALL 249 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 21);
+	if ((status = vsvf_native_pc249(p_vm))) return status;
+	/* 22: HALT */
+	if ((status = gn_halt(p_vm)) > GRUNT_HALT_FALSE)
+		return gn_fail(p_vm, status, 22);
+	return status;
+
+} /* vsvf_native_pc0() */
+
+
+static int
+vsvf_native_pc23(gn_vm_t *p_vm) {
+
+	int status;
+	bool taken;
+
+	/* 23: INPUT 1 */
+	if ((status = gn_input(p_vm, 1)))
+		return gn_fail(p_vm, status, 23);
+	/* 24: DUP 1 */
+	if ((status = gn_dup(p_vm, 1)))
+		return gn_fail(p_vm, status, 24);
+	/* 25: ROLL 6 */
+	if ((status = gn_roll(p_vm, 6)))
+		return gn_fail(p_vm, status, 25);
+	/* 26: DUP 1 */
+	if ((status = gn_dup(p_vm, 1)))
+		return gn_fail(p_vm, status, 26);
+	/* 27: CALL 64 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 27);
+	if ((status = vsvf_native_pc64(p_vm))) return status;
+	/* 28: NOT */
+	if ((status = gn_not(p_vm)))
+		return gn_fail(p_vm, status, 28);
+	/* 29: JMPIF 9 */
+	if ((status = gn_test(p_vm, &taken)))
+		return gn_fail(p_vm, status, 29);
+	if (taken) goto pc38;
+	/* 30: ROLL 5 */
+	if ((status = gn_roll(p_vm, 5)))
+		return gn_fail(p_vm, status, 30);
+	/* 31: ROLL 5 */
+	if ((status = gn_roll(p_vm, 5)))
+		return gn_fail(p_vm, status, 31);
+	/* 32: POP 3 */
+	if ((status = gn_pop_n(p_vm, 3)))
+		return gn_fail(p_vm, status, 32);
+	/* 33: CALL 67 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 33);
+	if ((status = vsvf_native_pc67(p_vm))) return status;
+	/* 34: JMPIF 2 */
+	if ((status = gn_test(p_vm, &taken)))
+		return gn_fail(p_vm, status, 34);
+	if (taken) goto pc36;
+	/* 35: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 35);
+	return 0;
+pc36:
+	/* 36: CALL 224 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 36);
+	if ((status = vsvf_native_pc224(p_vm))) return status;
+	/* 37: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 37);
+	return 0;
+pc38:
+	/* 38: ROLL 8 */
+	if ((status = gn_roll(p_vm, 8)))
+		return gn_fail(p_vm, status, 38);
+	/* 39: ROLL 8 */
+	if ((status = gn_roll(p_vm, 8)))
+		return gn_fail(p_vm, status, 39);
+	/* 40: ROLL 8 */
+	if ((status = gn_roll(p_vm, 8)))
+		return gn_fail(p_vm, status, 40);
+	/* 41: ROLL 8 */
+	if ((status = gn_roll(p_vm, 8)))
+		return gn_fail(p_vm, status, 41);
+	/* 42: ROLL 8 */
+	if ((status = gn_roll(p_vm, 8)))
+		return gn_fail(p_vm, status, 42);
+	/* 43: ROLL 8 */
+	if ((status = gn_roll(p_vm, 8)))
+		return gn_fail(p_vm, status, 43);
+	/* 44: ROLL 8 */
+	if ((status = gn_roll(p_vm, 8)))
+		return gn_fail(p_vm, status, 44);
+	/* 45: DUP 1 */
+	if ((status = gn_dup(p_vm, 1)))
+		return gn_fail(p_vm, status, 45);
+	/* 46: ROLL 9 */
+	if ((status = gn_roll(p_vm, 9)))
+		return gn_fail(p_vm, status, 46);
+	/* 47: ROLL 3 */
+	if ((status = gn_roll(p_vm, 3)))
+		return gn_fail(p_vm, status, 47);
+	/* 48: DUP 1 */
+	if ((status = gn_dup(p_vm, 1)))
+		return gn_fail(p_vm, status, 48);
+	/* 49: CLASSIFY s10 */
+	if ((status = gn_classify(p_vm, 10)))
+		return gn_fail(p_vm, status, 49);
+	/* 50: PUSHN 0x00000000 */
+	if ((status = gn_push_num(p_vm, 0x00000000U)))
+		return gn_fail(p_vm, status, 50);
+	/* 51: EQ 2 */
+	if ((status = gn_eq(p_vm, 2)))
+		return gn_fail(p_vm, status, 51);
+	/* 52: JMPIF 7 */
+	if ((status = gn_test(p_vm, &taken)))
+		return gn_fail(p_vm, status, 52);
+	if (taken) goto pc59;
+	/* 53: POP 1 */
+	if ((status = gn_pop_n(p_vm, 1)))
+		return gn_fail(p_vm, status, 53);
+	/* 54: CALL 80 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 54);
+	if ((status = vsvf_native_pc80(p_vm))) return status;
+	/* 55: JMPIF 2 */
+	if ((status = gn_test(p_vm, &taken)))
+		return gn_fail(p_vm, status, 55);
+	if (taken) goto pc57;
+	/* 56: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 56);
+	return 0;
+pc57:
+	/* 57: CALL 230 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 57);
+	if ((status = vsvf_native_pc230(p_vm))) return status;
+	/* 58: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 58);
+	return 0;
+pc59:
+	/* 59: POP 4 */
+	if ((status = gn_pop_n(p_vm, 4)))
+		return gn_fail(p_vm, status, 59);
+	/* 60: ROLL 5 */
+	if ((status = gn_roll(p_vm, 5)))
+		return gn_fail(p_vm, status, 60);
+	/* 61: POP 4 */
+	if ((status = gn_pop_n(p_vm, 4)))
+		return gn_fail(p_vm, status, 61);
+	/* 62: CALL 220 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 62);
+	if ((status = vsvf_native_pc220(p_vm))) return status;
+	/* 63: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 63);
+	return 0;
+
+} /* vsvf_native_pc23() */
+
+
+static int
+vsvf_native_pc64(gn_vm_t *p_vm) {
+
+	int status;
+
+	/* 64: PUSHN 0x00000000 */
+	if ((status = gn_push_num(p_vm, 0x00000000U)))
+		return gn_fail(p_vm, status, 64);
+	/* 65: EQ 2 */
+	if ((status = gn_eq(p_vm, 2)))
+		return gn_fail(p_vm, status, 65);
+	/* 66: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 66);
+	return 0;
+
+} /* vsvf_native_pc64() */
+
+
+static int
+vsvf_native_pc67(gn_vm_t *p_vm) {
+
+	int status;
+	bool taken;
+
+	/* 67: INPUTZ 11 */
+	if ((status = gn_inputz(p_vm, 11)))
+		return gn_fail(p_vm, status, 67);
+	/* 68: JMPIF 9 */
+	if ((status = gn_test(p_vm, &taken)))
+		return gn_fail(p_vm, status, 68);
+	if (taken) goto pc77;
+	/* 69: ROLL 2 */
+	if ((status = gn_roll(p_vm, 2)))
+		return gn_fail(p_vm, status, 69);
+	/* 70: PUSHN 0x00002001 */
+	if ((status = gn_push_num(p_vm, 0x00002001U)))
+		return gn_fail(p_vm, status, 70);
+	/* 71: ROLL 3 */
+	if ((status = gn_roll(p_vm, 3)))
+		return gn_fail(p_vm, status, 71);
+	/* 72: PUSHS s3 */
+	if ((status = gn_push_str(p_vm, 3)))
+		return gn_fail(p_vm, status, 72);
+	/* 73: ROLL 3 */
+	if ((status = gn_roll(p_vm, 3)))
+		return gn_fail(p_vm, status, 73);
+	/* 74: CALL 261 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 74);
+	if ((status = vsvf_native_pc261(p_vm))) return status;
+	/* 75: PUSHB false */
+	if ((status = gn_push_bool(p_vm, false)))
+		return gn_fail(p_vm, status, 75);
+	/* 76: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 76);
+	return 0;
+pc77:
+	/* 77: POP 2 */
+	if ((status = gn_pop_n(p_vm, 2)))
+		return gn_fail(p_vm, status, 77);
+	/* 78: PUSHB true */
+	if ((status = gn_push_bool(p_vm, true)))
+		return gn_fail(p_vm, status, 78);
+	/* 79: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 79);
+	return 0;
+
+} /* vsvf_native_pc67() */
+
+
+static int
+vsvf_native_pc80(gn_vm_t *p_vm) {
+
+	int status;
+
+	/* 80: ROLL 8 */
+	if ((status = gn_roll(p_vm, 8)))
+		return gn_fail(p_vm, status, 80);
+	/* 81: ROLL 8 */
+	if ((status = gn_roll(p_vm, 8)))
+		return gn_fail(p_vm, status, 81);
+	/* 82: DUP 2 */
+	if ((status = gn_dup(p_vm, 2)))
+		return gn_fail(p_vm, status, 82);
+	/* 83: CALL 106 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 83);
+	if ((status = vsvf_native_pc106(p_vm))) return status;
+	/* 84: ROLL 9 */
+	if ((status = gn_roll(p_vm, 9)))
+		return gn_fail(p_vm, status, 84);
+	/* 85: DUP 2 */
+	if ((status = gn_dup(p_vm, 2)))
+		return gn_fail(p_vm, status, 85);
+	/* 86: ROLL 10 */
+	if ((status = gn_roll(p_vm, 10)))
+		return gn_fail(p_vm, status, 86);
+	/* 87: ROLL 10 */
+	if ((status = gn_roll(p_vm, 10)))
+		return gn_fail(p_vm, status, 87);
+	/* 88: ROLL 10 */
+	if ((status = gn_roll(p_vm, 10)))
+		return gn_fail(p_vm, status, 88);
+	/* 89: ROLL 10 */
+	if ((status = gn_roll(p_vm, 10)))
+		return gn_fail(p_vm, status, 89);
+	/* 90: ROLL 10 */
+	if ((status = gn_roll(p_vm, 10)))
+		return gn_fail(p_vm, status, 90);
+	/* 91: ROLL 10 */
+	if ((status = gn_roll(p_vm, 10)))
+		return gn_fail(p_vm, status, 91);
+	/* 92: ROLL 10 */
+	if ((status = gn_roll(p_vm, 10)))
+		return gn_fail(p_vm, status, 92);
+	/* 93: ROLL 10 */
+	if ((status = gn_roll(p_vm, 10)))
+		return gn_fail(p_vm, status, 93);
+	/* 94: CALL 120 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 94);
+	if ((status = vsvf_native_pc120(p_vm))) return status;
+	/* 95: ROLL 7 */
+	if ((status = gn_roll(p_vm, 7)))
+		return gn_fail(p_vm, status, 95);
+	/* 96: DUP 2 */
+	if ((status = gn_dup(p_vm, 2)))
+		return gn_fail(p_vm, status, 96);
+	/* 97: ROLL 5 */
+	if ((status = gn_roll(p_vm, 5)))
+		return gn_fail(p_vm, status, 97);
+	/* 98: ROLL 5 */
+	if ((status = gn_roll(p_vm, 5)))
+		return gn_fail(p_vm, status, 98);
+	/* 99: ROLL 3 */
+	if ((status = gn_roll(p_vm, 3)))
+		return gn_fail(p_vm, status, 99);
+	/* 100: ROLL 3 */
+	if ((status = gn_roll(p_vm, 3)))
+		return gn_fail(p_vm, status, 100);
+	/* 101: CALL 179 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 101);
+	if ((status = vsvf_native_pc179(p_vm))) return status;
+	/* 102: ROLL 7 */
+	if ((status = gn_roll(p_vm, 7)))
+		return gn_fail(p_vm, status, 102);
+	/* 103: CALL 194 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 103);
+	if ((status = vsvf_native_pc194(p_vm))) return status;
+	/* 104: AND 4 */
+	if ((status = gn_and_or(p_vm, 4, true)))
+		return gn_fail(p_vm, status, 104);
+	/* 105: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 105);
+	return 0;
+
+} /* vsvf_native_pc80() */
+
+
+static int
+vsvf_native_pc106(gn_vm_t *p_vm) {
+
+	int status;
+	bool taken;
+
+	/* 106: INPUTZ 3 */
+	if ((status = gn_inputz(p_vm, 3)))
+		return gn_fail(p_vm, status, 106);
+	/* 107: NOT */
+	if ((status = gn_not(p_vm)))
+		return gn_fail(p_vm, status, 107);
+	/* 108: JMPIF 4 */
+	if ((status = gn_test(p_vm, &taken)))
+		return gn_fail(p_vm, status, 108);
+	if (taken) goto pc112;
+	/* 109: POP 2 */
+	if ((status = gn_pop_n(p_vm, 2)))
+		return gn_fail(p_vm, status, 109);
+	/* 110: PUSHB true */
+	if ((status = gn_push_bool(p_vm, true)))
+		return gn_fail(p_vm, status, 110);
+	/* 111: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 111);
+	return 0;
+pc112:
+	/* 112: ROLL 2 */
+	if ((status = gn_roll(p_vm, 2)))
+		return gn_fail(p_vm, status, 112);
+	/* 113: PUSHN 0x00002004 */
+	if ((status = gn_push_num(p_vm, 0x00002004U)))
+		return gn_fail(p_vm, status, 113);
+	/* 114: ROLL 3 */
+	if ((status = gn_roll(p_vm, 3)))
+		return gn_fail(p_vm, status, 114);
+	/* 115: PUSHS s4 */
+	if ((status = gn_push_str(p_vm, 4)))
+		return gn_fail(p_vm, status, 115);
+	/* 116: ROLL 3 */
+	if ((status = gn_roll(p_vm, 3)))
+		return gn_fail(p_vm, status, 116);
+	/* 117: CALL 261 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 117);
+	if ((status = vsvf_native_pc261(p_vm))) return status;
+	/* 118: PUSHB false */
+	if ((status = gn_push_bool(p_vm, false)))
+		return gn_fail(p_vm, status, 118);
+	/* 119: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 119);
+	return 0;
+
+} /* vsvf_native_pc106() */
+
+
+static int
+vsvf_native_pc120(gn_vm_t *p_vm) {
+
+	int status;
+
+	/* 120: DUP 4 */
+	if ((status = gn_dup(p_vm, 4)))
+		return gn_fail(p_vm, status, 120);
+	/* 121: INPUT 4 */
+	if ((status = gn_input(p_vm, 4)))
+		return gn_fail(p_vm, status, 121);
+	/* 122: DUP 1 */
+	if ((status = gn_dup(p_vm, 1)))
+		return gn_fail(p_vm, status, 122);
+	/* 123: ROLL 10 */
+	if ((status = gn_roll(p_vm, 10)))
+		return gn_fail(p_vm, status, 123);
+	/* 124: PUSHN 0x00002008 */
+	if ((status = gn_push_num(p_vm, 0x00002008U)))
+		return gn_fail(p_vm, status, 124);
+	/* 125: ROLL 6 */
+	if ((status = gn_roll(p_vm, 6)))
+		return gn_fail(p_vm, status, 125);
+	/* 126: PUSHS s5 */
+	if ((status = gn_push_str(p_vm, 5)))
+		return gn_fail(p_vm, status, 126);
+	/* 127: ROLL 6 */
+	if ((status = gn_roll(p_vm, 6)))
+		return gn_fail(p_vm, status, 127);
+	/* 128: CALL 151 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 128);
+	if ((status = vsvf_native_pc151(p_vm))) return status;
+	/* 129: ROLL 6 */
+	if ((status = gn_roll(p_vm, 6)))
+		return gn_fail(p_vm, status, 129);
+	/* 130: ROLL 4 */
+	if ((status = gn_roll(p_vm, 4)))
+		return gn_fail(p_vm, status, 130);
+	/* 131: ROLL 4 */
+	if ((status = gn_roll(p_vm, 4)))
+		return gn_fail(p_vm, status, 131);
+	/* 132: DUP 2 */
+	if ((status = gn_dup(p_vm, 2)))
+		return gn_fail(p_vm, status, 132);
+	/* 133: ROLL 6 */
+	if ((status = gn_roll(p_vm, 6)))
+		return gn_fail(p_vm, status, 133);
+	/* 134: ROLL 6 */
+	if ((status = gn_roll(p_vm, 6)))
+		return gn_fail(p_vm, status, 134);
+	/* 135: ROLL 6 */
+	if ((status = gn_roll(p_vm, 6)))
+		return gn_fail(p_vm, status, 135);
+	/* 136: ROLL 6 */
+	if ((status = gn_roll(p_vm, 6)))
+		return gn_fail(p_vm, status, 136);
+	/* 137: INPUT 4 */
+	if ((status = gn_input(p_vm, 4)))
+		return gn_fail(p_vm, status, 137);
+	/* 138: DUP 1 */
+	if ((status = gn_dup(p_vm, 1)))
+		return gn_fail(p_vm, status, 138);
+	/* 139: ROLL 9 */
+	if ((status = gn_roll(p_vm, 9)))
+		return gn_fail(p_vm, status, 139);
+	/* 140: PUSHN 0x00002010 */
+	if ((status = gn_push_num(p_vm, 0x00002010U)))
+		return gn_fail(p_vm, status, 140);
+	/* 141: ROLL 6 */
+	if ((status = gn_roll(p_vm, 6)))
+		return gn_fail(p_vm, status, 141);
+	/* 142: PUSHS s6 */
+	if ((status = gn_push_str(p_vm, 6)))
+		return gn_fail(p_vm, status, 142);
+	/* 143: ROLL 6 */
+	if ((status = gn_roll(p_vm, 6)))
+		return gn_fail(p_vm, status, 143);
+	/* 144: CALL 151 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 144);
+	if ((status = vsvf_native_pc151(p_vm))) return status;
+	/* 145: ROLL 6 */
+	if ((status = gn_roll(p_vm, 6)))
+		return gn_fail(p_vm, status, 145);
+	/* 146: ROLL 4 */
+	if ((status = gn_roll(p_vm, 4)))
+		return gn_fail(p_vm, status, 146);
+	/* 147: ROLL 4 */
+	if ((status = gn_roll(p_vm, 4)))
+		return gn_fail(p_vm, status, 147);
+	/* 148: CALL 166 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 148);
+	if ((status = vsvf_native_pc166(p_vm))) return status;
+	/* 149: AND 3 */
+	if ((status = gn_and_or(p_vm, 3, true)))
+		return gn_fail(p_vm, status, 149);
+	/* 150: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 150);
+	return 0;
+
+} /* vsvf_native_pc120() */
+
+
+static int
+vsvf_native_pc151(gn_vm_t *p_vm) {
+
+	int status;
+	bool taken;
+
+	/* 151: DUP 1 */
+	if ((status = gn_dup(p_vm, 1)))
+		return gn_fail(p_vm, status, 151);
+	/* 152: ROLL 4 */
+	if ((status = gn_roll(p_vm, 4)))
+		return gn_fail(p_vm, status, 152);
+	/* 153: ROLL 2 */
+	if ((status = gn_roll(p_vm, 2)))
+		return gn_fail(p_vm, status, 153);
+	/* 154: LT */
+	if ((status = gn_lt_gt(p_vm, true)))
+		return gn_fail(p_vm, status, 154);
+	/* 155: ROLL 3 */
+	if ((status = gn_roll(p_vm, 3)))
+		return gn_fail(p_vm, status, 155);
+	/* 156: GT */
+	if ((status = gn_lt_gt(p_vm, false)))
+		return gn_fail(p_vm, status, 156);
+	/* 157: OR 2 */
+	if ((status = gn_and_or(p_vm, 2, false)))
+		return gn_fail(p_vm, status, 157);
+	/* 158: JMPIF 4 */
+	if ((status = gn_test(p_vm, &taken)))
+		return gn_fail(p_vm, status, 158);
+	if (taken) goto pc162;
+	/* 159: POP 4 */
+	if ((status = gn_pop_n(p_vm, 4)))
+		return gn_fail(p_vm, status, 159);
+	/* 160: PUSHB true */
+	if ((status = gn_push_bool(p_vm, true)))
+		return gn_fail(p_vm, status, 160);
+	/* 161: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 161);
+	return 0;
+pc162:
+	/* 162: ROLL 2 */
+	if ((status = gn_roll(p_vm, 2)))
+		return gn_fail(p_vm, status, 162);
+	/* 163: CALL 261 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 163);
+	if ((status = vsvf_native_pc261(p_vm))) return status;
+	/* 164: PUSHB false */
+	if ((status = gn_push_bool(p_vm, false)))
+		return gn_fail(p_vm, status, 164);
+	/* 165: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 165);
+	return 0;
+
+} /* vsvf_native_pc151() */
+
+
+static int
+vsvf_native_pc166(gn_vm_t *p_vm) {
+
+	int status;
+	bool taken;
+
+	/* 166: LT */
+	if ((status = gn_lt_gt(p_vm, true)))
+		return gn_fail(p_vm, status, 166);
+	/* 167: JMPIF 4 */
+	if ((status = gn_test(p_vm, &taken)))
+		return gn_fail(p_vm, status, 167);
+	if (taken) goto pc171;
+	/* 168: POP 2 */
+	if ((status = gn_pop_n(p_vm, 2)))
+		return gn_fail(p_vm, status, 168);
+	/* 169: PUSHB true */
+	if ((status = gn_push_bool(p_vm, true)))
+		return gn_fail(p_vm, status, 169);
+	/* 170: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 170);
+	return 0;
+pc171:
+	/* 171: ROLL 2 */
+	if ((status = gn_roll(p_vm, 2)))
+		return gn_fail(p_vm, status, 171);
+	/* 172: PUSHS s7 */
+	if ((status = gn_push_str(p_vm, 7)))
+		return gn_fail(p_vm, status, 172);
+	/* 173: ROLL 3 */
+	if ((status = gn_roll(p_vm, 3)))
+		return gn_fail(p_vm, status, 173);
+	/* 174: PUSHN 0x00002020 */
+	if ((status = gn_push_num(p_vm, 0x00002020U)))
+		return gn_fail(p_vm, status, 174);
+	/* 175: ROLL 4 */
+	if ((status = gn_roll(p_vm, 4)))
+		return gn_fail(p_vm, status, 175);
+	/* 176: CALL 261 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 176);
+	if ((status = vsvf_native_pc261(p_vm))) return status;
+	/* 177: PUSHB false */
+	if ((status = gn_push_bool(p_vm, false)))
+		return gn_fail(p_vm, status, 177);
+	/* 178: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 178);
+	return 0;
+
+} /* vsvf_native_pc166() */
+
+
+static int
+vsvf_native_pc179(gn_vm_t *p_vm) {
+
+	int status;
+	bool taken;
+
+	/* 179: PUSHN 0x00000000 */
+	if ((status = gn_push_num(p_vm, 0x00000000U)))
+		return gn_fail(p_vm, status, 179);
+	/* 180: EQ 2 */
+	if ((status = gn_eq(p_vm, 2)))
+		return gn_fail(p_vm, status, 180);
+	/* 181: NOT */
+	if ((status = gn_not(p_vm)))
+		return gn_fail(p_vm, status, 181);
+	/* 182: JMPIF 4 */
+	if ((status = gn_test(p_vm, &taken)))
+		return gn_fail(p_vm, status, 182);
+	if (taken) goto pc186;
+	/* 183: POP 2 */
+	if ((status = gn_pop_n(p_vm, 2)))
+		return gn_fail(p_vm, status, 183);
+	/* 184: PUSHB true */
+	if ((status = gn_push_bool(p_vm, true)))
+		return gn_fail(p_vm, status, 184);
+	/* 185: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 185);
+	return 0;
+pc186:
+	/* 186: ROLL 2 */
+	if ((status = gn_roll(p_vm, 2)))
+		return gn_fail(p_vm, status, 186);
+	/* 187: PUSHS s8 */
+	if ((status = gn_push_str(p_vm, 8)))
+		return gn_fail(p_vm, status, 187);
+	/* 188: ROLL 3 */
+	if ((status = gn_roll(p_vm, 3)))
+		return gn_fail(p_vm, status, 188);
+	/* 189: PUSHN 0x00002040 */
+	if ((status = gn_push_num(p_vm, 0x00002040U)))
+		return gn_fail(p_vm, status, 189);
+	/* 190: ROLL 4 */
+	if ((status = gn_roll(p_vm, 4)))
+		return gn_fail(p_vm, status, 190);
+	/* 191: CALL 261 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 191);
+	if ((status = vsvf_native_pc261(p_vm))) return status;
+	/* 192: PUSHB false */
+	if ((status = gn_push_bool(p_vm, false)))
+		return gn_fail(p_vm, status, 192);
+	/* 193: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 193);
+	return 0;
+
+} /* vsvf_native_pc179() */
+
+
+static int
+vsvf_native_pc194(gn_vm_t *p_vm) {
+
+	int status;
+	bool taken;
+
+	/* 194: DUP 1 */
+	if ((status = gn_dup(p_vm, 1)))
+		return gn_fail(p_vm, status, 194);
+	/* 195: ROLL 5 */
+	if ((status = gn_roll(p_vm, 5)))
+		return gn_fail(p_vm, status, 195);
+	/* 196: DUP 1 */
+	if ((status = gn_dup(p_vm, 1)))
+		return gn_fail(p_vm, status, 196);
+	/* 197: ROLL 4 */
+	if ((status = gn_roll(p_vm, 4)))
+		return gn_fail(p_vm, status, 197);
+	/* 198: DUP 1 */
+	if ((status = gn_dup(p_vm, 1)))
+		return gn_fail(p_vm, status, 198);
+	/* 199: ROLL 3 */
+	if ((status = gn_roll(p_vm, 3)))
+		return gn_fail(p_vm, status, 199);
+	/* 200: ROLL 8 */
+	if ((status = gn_roll(p_vm, 8)))
+		return gn_fail(p_vm, status, 200);
+	/* 201: ROLL 8 */
+	if ((status = gn_roll(p_vm, 8)))
+		return gn_fail(p_vm, status, 201);
+	/* 202: EQ 2 */
+	if ((status = gn_eq(p_vm, 2)))
+		return gn_fail(p_vm, status, 202);
+	/* 203: ROLL 5 */
+	if ((status = gn_roll(p_vm, 5)))
+		return gn_fail(p_vm, status, 203);
+	/* 204: EQ 2 */
+	if ((status = gn_eq(p_vm, 2)))
+		return gn_fail(p_vm, status, 204);
+	/* 205: ROLL 3 */
+	if ((status = gn_roll(p_vm, 3)))
+		return gn_fail(p_vm, status, 205);
+	/* 206: EQ 2 */
+	if ((status = gn_eq(p_vm, 2)))
+		return gn_fail(p_vm, status, 206);
+	/* 207: OR 3 */
+	if ((status = gn_and_or(p_vm, 3, false)))
+		return gn_fail(p_vm, status, 207);
+	/* 208: JMPIF 4 */
+	if ((status = gn_test(p_vm, &taken)))
+		return gn_fail(p_vm, status, 208);
+	if (taken) goto pc212;
+	/* 209: POP 2 */
+	if ((status = gn_pop_n(p_vm, 2)))
+		return gn_fail(p_vm, status, 209);
+	/* 210: PUSHB true */
+	if ((status = gn_push_bool(p_vm, true)))
+		return gn_fail(p_vm, status, 210);
+	/* 211: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 211);
+	return 0;
+pc212:
+	/* 212: ROLL 2 */
+	if ((status = gn_roll(p_vm, 2)))
+		return gn_fail(p_vm, status, 212);
+	/* 213: PUSHS s9 */
+	if ((status = gn_push_str(p_vm, 9)))
+		return gn_fail(p_vm, status, 213);
+	/* 214: ROLL 3 */
+	if ((status = gn_roll(p_vm, 3)))
+		return gn_fail(p_vm, status, 214);
+	/* 215: PUSHN 0x00002080 */
+	if ((status = gn_push_num(p_vm, 0x00002080U)))
+		return gn_fail(p_vm, status, 215);
+	/* 216: ROLL 4 */
+	if ((status = gn_roll(p_vm, 4)))
+		return gn_fail(p_vm, status, 216);
+	/* 217: CALL 261 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 217);
+	if ((status = vsvf_native_pc261(p_vm))) return status;
+	/* 218: PUSHB false */
+	if ((status = gn_push_bool(p_vm, false)))
+		return gn_fail(p_vm, status, 218);
+	/* 219: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 219);
+	return 0;
+
+} /* vsvf_native_pc194() */
+
+
+static int
+vsvf_native_pc220(gn_vm_t *p_vm) {
+
+	int status;
+
+	/* 220: INPUTREC 0x00F9 */
+	if ((status = gn_inputrec(p_vm, 0x00F9, 11)))
+		return gn_fail(p_vm, status, 220);
+	/* 221: POP 4 */
+	if ((status = gn_pop_n(p_vm, 4)))
+		return gn_fail(p_vm, status, 221);
+	/* 222: CALL 255 */
+	if ((status = gn_call(p_vm)))
+		return gn_fail(p_vm, status, 222);
+	if ((status = vsvf_native_pc255(p_vm))) return status;
+	/* 223: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 223);
+	return 0;
+
+} /* vsvf_native_pc220() */
+
+
+static int
+vsvf_native_pc224(gn_vm_t *p_vm) {
+
+	int status;
+
+	/* 224: ROLL 3 */
+	if ((status = gn_roll(p_vm, 3)))
+		return gn_fail(p_vm, status, 224);
+	/* 225: ROLL 3 */
+	if ((status = gn_roll(p_vm, 3)))
+		return gn_fail(p_vm, status, 225);
+	/* 226: PUSHN 0x00000001 */
+	if ((status = gn_push_num(p_vm, 0x00000001U)))
+		return gn_fail(p_vm, status, 226);
+	/* 227: ADD */
+	if ((status = gn_add_sub(p_vm, true)))
+		return gn_fail(p_vm, status, 227);
+	/* 228: ROLL 3 */
+	if ((status = gn_roll(p_vm, 3)))
+		return gn_fail(p_vm, status, 228);
+	/* 229: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 229);
+	return 0;
+
+} /* vsvf_native_pc224() */
+
+
+static int
+vsvf_native_pc230(gn_vm_t *p_vm) {
+
+	int status;
+
+	/* 230: ROLL 2 */
+	if ((status = gn_roll(p_vm, 2)))
+		return gn_fail(p_vm, status, 230);
+	/* 231: PUSHN 0x00000001 */
+	if ((status = gn_push_num(p_vm, 0x00000001U)))
+		return gn_fail(p_vm, status, 231);
+	/* 232: ADD */
+	if ((status = gn_add_sub(p_vm, true)))
+		return gn_fail(p_vm, status, 232);
+	/* 233: ROLL 2 */
+	if ((status = gn_roll(p_vm, 2)))
+		return gn_fail(p_vm, status, 233);
+	/* 234: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 234);
+	return 0;
+
+} /* vsvf_native_pc230() */
+
+
+static int
+vsvf_native_pc235(gn_vm_t *p_vm) {
+
+	int status;
+
+	/* 235: DUP 2 */
+	if ((status = gn_dup(p_vm, 2)))
+		return gn_fail(p_vm, status, 235);
+	/* 236: ADD */
+	if ((status = gn_add_sub(p_vm, true)))
+		return gn_fail(p_vm, status, 236);
+	/* 237: PUSHN 0x00000004 */
+	if ((status = gn_push_num(p_vm, 0x00000004U)))
+		return gn_fail(p_vm, status, 237);
+	/* 238: ROLL 2 */
+	if ((status = gn_roll(p_vm, 2)))
+		return gn_fail(p_vm, status, 238);
+	/* 239: SUB */
+	if ((status = gn_add_sub(p_vm, false)))
+		return gn_fail(p_vm, status, 239);
+	/* 240: ROLL 2 */
+	if ((status = gn_roll(p_vm, 2)))
+		return gn_fail(p_vm, status, 240);
+	/* 241: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 241);
+	return 0;
+
+} /* vsvf_native_pc235() */
+
+
+static int
+vsvf_native_pc242(gn_vm_t *p_vm) {
+
+	int status;
+
+	/* 242: ROLL 2 */
+	if ((status = gn_roll(p_vm, 2)))
+		return gn_fail(p_vm, status, 242);
+	/* 243: DUP 1 */
+	if ((status = gn_dup(p_vm, 1)))
+		return gn_fail(p_vm, status, 243);
+	/* 244: PUSHN 0x00000000 */
+	if ((status = gn_push_num(p_vm, 0x00000000U)))
+		return gn_fail(p_vm, status, 244);
+	/* 245: EQ 2 */
+	if ((status = gn_eq(p_vm, 2)))
+		return gn_fail(p_vm, status, 245);
+	/* 246: ROLL 4 */
+	if ((status = gn_roll(p_vm, 4)))
+		return gn_fail(p_vm, status, 246);
+	/* 247: ROLL 2 */
+	if ((status = gn_roll(p_vm, 2)))
+		return gn_fail(p_vm, status, 247);
+	/* 248: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 248);
+	return 0;
+
+} /* vsvf_native_pc242() */
+
+
+static int
+vsvf_native_pc249(gn_vm_t *p_vm) {
+
+	int status;
+
+	/* 249: PUSHS s0 */
+	if ((status = gn_push_str(p_vm, 0)))
+		return gn_fail(p_vm, status, 249);
+	/* 250: FORMAT 3 */
+	if ((status = gn_format(p_vm, 3)))
+		return gn_fail(p_vm, status, 250);
+	/* 251: PUSHN 0x00000008 */
+	if ((status = gn_push_num(p_vm, 0x00000008U)))
+		return gn_fail(p_vm, status, 251);
+	/* 252: PUSHN 0x00000002 */
+	if ((status = gn_push_num(p_vm, 0x00000002U)))
+		return gn_fail(p_vm, status, 252);
+	/* 253: FLUSH */
+	if ((status = gn_flush(p_vm)))
+		return gn_fail(p_vm, status, 253);
+	/* 254: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 254);
+	return 0;
+
+} /* vsvf_native_pc249() */
+
+
+static int
+vsvf_native_pc255(gn_vm_t *p_vm) {
+
+	int status;
+
+	/* 255: PUSHS s2 */
+	if ((status = gn_push_str(p_vm, 2)))
+		return gn_fail(p_vm, status, 255);
+	/* 256: FORMAT 1 */
+	if ((status = gn_format(p_vm, 1)))
+		return gn_fail(p_vm, status, 256);
+	/* 257: PUSHN 0x00002002 */
+	if ((status = gn_push_num(p_vm, 0x00002002U)))
+		return gn_fail(p_vm, status, 257);
+	/* 258: PUSHN 0x00000003 */
+	if ((status = gn_push_num(p_vm, 0x00000003U)))
+		return gn_fail(p_vm, status, 258);
+	/* 259: FLUSH */
+	if ((status = gn_flush(p_vm)))
+		return gn_fail(p_vm, status, 259);
+	/* 260: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 260);
+	return 0;
+
+} /* vsvf_native_pc255() */
+
+
+static int
+vsvf_native_pc261(gn_vm_t *p_vm) {
+
+	int status;
+
+	/* 261: ROLL 2 */
+	if ((status = gn_roll(p_vm, 2)))
+		return gn_fail(p_vm, status, 261);
+	/* 262: CLASSIFY s10 */
+	if ((status = gn_classify(p_vm, 10)))
+		return gn_fail(p_vm, status, 262);
+	/* 263: POP 1 */
+	if ((status = gn_pop_n(p_vm, 1)))
+		return gn_fail(p_vm, status, 263);
+	/* 264: ROLL 3 */
+	if ((status = gn_roll(p_vm, 3)))
+		return gn_fail(p_vm, status, 264);
+	/* 265: POP 2 */
+	if ((status = gn_pop_n(p_vm, 2)))
+		return gn_fail(p_vm, status, 265);
+	/* 266: ROLL 2 */
+	if ((status = gn_roll(p_vm, 2)))
+		return gn_fail(p_vm, status, 266);
+	/* 267: PUSHS s1 */
+	if ((status = gn_push_str(p_vm, 1)))
+		return gn_fail(p_vm, status, 267);
+	/* 268: FORMAT 3 */
+	if ((status = gn_format(p_vm, 3)))
+		return gn_fail(p_vm, status, 268);
+	/* 269: PUSHN 0x00000003 */
+	if ((status = gn_push_num(p_vm, 0x00000003U)))
+		return gn_fail(p_vm, status, 269);
+	/* 270: FLUSH */
+	if ((status = gn_flush(p_vm)))
+		return gn_fail(p_vm, status, 270);
+	/* 271: RETURN */
+	if ((status = gn_return(p_vm)))
+		return gn_fail(p_vm, status, 271);
+	return 0;
+
+} /* vsvf_native_pc261() */
+
+
+int32
+vsvf_native_run(const void *p_data, grunt_rep_t data_size) {
+
+	gn_vm_t vm;
+	int status;
+
+	vm.arg_count  = 0;
+	vm.ctl_count  = 0;
+	vm.input      = (const char *)p_data;
+	vm.input_size = data_size;
+	vm.head_index = 0;
+	vm.error_pc   = 0;
+	GRUNT_NativeInit(vsvf_native_strings, 20);
+
+	status = vsvf_native_pc0(&vm);
+
+	/* A RETURN with an empty control stack fails above, so
+	 * the main routine never returns 0.
+	 */
+	if (status == 0) status = GRUNT_ERROR_INTERPRETERBUG;
+
+	if (!((status == GRUNT_HALT_TRUE)||(status == GRUNT_HALT_FALSE)))
+		GRUNT_NativeError(status, vm.error_pc);
+
+	return status;
+
+} /* vsvf_native_run() */
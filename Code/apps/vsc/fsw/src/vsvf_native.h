@@ -0,0 +1,27 @@
+#ifndef _VSVF_NATIVE_H_
+#define _VSVF_NATIVE_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* GENERATED FILE - DO NOT EDIT.
+ *
+ * The gruntaot translator generated this file from the Grunt program
+ * in vsvf.h.  Edit the program and run gruntaot again instead.
+ */
+
+int32 vsvf_native_run(const void *, grunt_rep_t);
+
+#endif
@@ -0,0 +1,887 @@
+#if !defined(_VSVF_H_) || defined(GRUNT_XMACRO_EXPAND)
+#ifndef GRUNT_XMACRO_EXPAND
+#define _VSVF_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* GENERATED FILE - DO NOT EDIT.
+ *
+ * The gruntasm assembler generated this file from the Grunt assembly
+ * source in vsvf_rules.gasm.  Edit the source and run gruntasm again instead.
+ *
+ * Including this file again with GRUNT_XMACRO_EXPAND defined yields
+ * only the program's instructions, for grunt_xmacro.h to expand into
+ * C statements.
+ */
+
+/* This file contains a Grunt implementation of the V-SPELLS table
+ * validation rules in vs_rules.spec.  The program checks each of the
+ * default table's 4 entries in turn, evaluating the rules for the
+ * entry's kind in order and sending an event for each one that holds.
+ * Then it sends a summary event and halts with true if the table is
+ * valid.
+ */
+
+static const char *vsvf_strings[] = {
+	"Table entry ",           /* 0 S_TABLE_ENTRY */
+	" invalid Parm ID",       /* 1 S_INVALID_PARM_ID */
+	" parm Unused not zeroed", /* 2 S_PARM_UNUSED_NOT_ZERO */
+	" parm ",                 /* 3 S_PARM */
+	" padding not zeroed",    /* 4 S_PADDING_NOT_ZEROED */
+	" invalid low bound",     /* 5 S_INVALID_LOW_BOUND */
+	" invalid high bound",    /* 6 S_INVALID_HIGH_BOUND */
+	" invalid bound order",   /* 7 S_INVALID_BOUND_ORDER */
+	" follows an unused entry", /* 8 S_FOLLOWS_AN_UNUSED_EN */
+	" redefines earlier entry", /* 9 S_REDEFINES_EARLIER_EN */
+	"Table image entries: ",  /* 10 S_TABLE_IMAGE_ENTRIES */
+	" valid, ",               /* 11 S_VALID */
+	" invalid, ",             /* 12 S_INVALID */
+	" unused",                /* 13 S_UNUSED */
+	"Unused",                 /* 14 S_UNUSED_2 */
+	"Ape",                    /* 15 S_APE */
+	"Bat",                    /* 16 S_BAT */
+	"Cat",                    /* 17 S_CAT */
+	"Dog",                    /* 18 S_DOG */
+	"North",                  /* 19 S_NORTH */
+	"South",                  /* 20 S_SOUTH */
+	"East",                   /* 21 S_EAST */
+	"West",                   /* 22 S_WEST */
+	"Invalid",                /* 23 S_INVALID_2 */
+};
+#define VSVF_NUM_STRINGS 24
+
+static const grunt_rep_t vsvf_string_lengths[] = {
+	12,                       /* 0 S_TABLE_ENTRY */
+	16,                       /* 1 S_INVALID_PARM_ID */
+	23,                       /* 2 S_PARM_UNUSED_NOT_ZERO */
+	6,                        /* 3 S_PARM */
+	19,                       /* 4 S_PADDING_NOT_ZEROED */
+	18,                       /* 5 S_INVALID_LOW_BOUND */
+	19,                       /* 6 S_INVALID_HIGH_BOUND */
+	20,                       /* 7 S_INVALID_BOUND_ORDER */
+	24,                       /* 8 S_FOLLOWS_AN_UNUSED_EN */
+	24,                       /* 9 S_REDEFINES_EARLIER_EN */
+	21,                       /* 10 S_TABLE_IMAGE_ENTRIES */
+	8,                        /* 11 S_VALID */
+	10,                       /* 12 S_INVALID */
+	7,                        /* 13 S_UNUSED */
+	6,                        /* 14 S_UNUSED_2 */
+	3,                        /* 15 S_APE */
+	3,                        /* 16 S_BAT */
+	3,                        /* 17 S_CAT */
+	3,                        /* 18 S_DOG */
+	5,                        /* 19 S_NORTH */
+	5,                        /* 20 S_SOUTH */
+	4,                        /* 21 S_EAST */
+	4,                        /* 22 S_WEST */
+	7,                        /* 23 S_INVALID_2 */
+};
+
+/* The program reads each entry's parm ID, pad, and bounds in turn. */
+#define VSVF_RECORD_OFFSET 0
+#define VSVF_RECORD_SIZE   12
+
+#define MAIN                     0
+#define CHECK_ENTRY              64
+#define IS_ANIMAL                89
+#define IS_DIRECTION             105
+#define CHECK_INVALID            121
+#define CHECK_UNUSED             128
+#define CHECK_ANIMAL             156
+#define CHECK_DIRECTION          255
+#define EMIT_VS_TBL_PARM_ERR     354
+#define EMIT_VS_TBL_ZERO_ERR     363
+#define EMIT_VS_TBL_PAD_ERR      372
+#define EMIT_VS_TBL_LBND_ERR     385
+#define EMIT_VS_TBL_HBND_ERR     398
+#define EMIT_VS_TBL_ORDER_ERR    411
+#define EMIT_VS_TBL_EXTRA_ERR    424
+#define EMIT_VS_TBL_REDEF_ERR    437
+#define EMIT_SUMMARY             450
+#define PARM_TO_STR              465
+#define VSVF_NUM_INSTRUCTIONS 540
+
+/* The most instructions one run of the program executes, and the
+ * most cycles it takes at the costs in host.costs.
+ */
+#define VSVF_WCET_STEPS  2139
+#define VSVF_WCET_CYCLES 157429
+
+static const grunt_instruction_t vsvf_program[] = {
+#endif /* GRUNT_XMACRO_EXPAND */
+
+	/* MAIN:
+	 * -- valid?
+	 *
+	 * The entry point of the program.  It checks each entry in turn,
+	 * keeping the parm ID of each, p1 p2 and so on, beneath u and v,
+	 * the counts of valid unused and valid in-use entries so far.
+	 */
+
+	/* Start with no valid entries. */
+	PUSHN(0),               /* -- u */
+	PUSHN(0),               /* -- u v */
+
+	/* Entry 1. */
+	INPUT(1),               /* -- u v p */
+	PUSHB(false),           /* -- u v p r */
+	PUSHN(1),               /* -- u v p r e */
+	CALL(CHECK_ENTRY),      /* -- */
+
+	/* Entry 2. */
+	INPUT(1),               /* -- p1 u v p */
+	DUP(1),                 /* -- p1 u v p p */
+	DUP(5),                 /* -- p1 u v p p p1 u v p p */
+	POP(4),                 /* -- p1 u v p p p1 */
+	EQ(2),                  /* -- p1 u v p r */
+	PUSHN(2),               /* -- p1 u v p r e */
+	CALL(CHECK_ENTRY),      /* -- p1 */
+
+	/* Entry 3. */
+	INPUT(1),               /* -- p1 p2 u v p */
+	DUP(1),                 /* -- p1 p2 u v p p */
+	DUP(6),                 /* -- p1 p2 u v p p p1 p2 u v p p */
+	POP(5),                 /* -- p1 p2 u v p p p1 */
+	EQ(2),                  /* -- p1 p2 u v p r */
+	DUP(2),                 /* -- p1 p2 u v p r p r */
+	POP(1),                 /* -- p1 p2 u v p r p */
+	DUP(6),                 /* -- p1 p2 u v p r p p2 u v p r p */
+	POP(5),                 /* -- p1 p2 u v p r p p2 */
+	EQ(2),                  /* -- p1 p2 u v p r r */
+	OR(2),                  /* -- p1 p2 u v p r */
+	PUSHN(3),               /* -- p1 p2 u v p r e */
+	CALL(CHECK_ENTRY),      /* -- p1 p2 */
+
+	/* Entry 4. */
+	INPUT(1),               /* -- p1 p2 p3 u v p */
+	DUP(1),                 /* -- p1 p2 p3 u v p p */
+	DUP(7),                 /* -- p1 p2 p3 u v p p p1 p2 p3 u v p p */
+	POP(6),                 /* -- p1 p2 p3 u v p p p1 */
+	EQ(2),                  /* -- p1 p2 p3 u v p r */
+	DUP(2),                 /* -- p1 p2 p3 u v p r p r */
+	POP(1),                 /* -- p1 p2 p3 u v p r p */
+	DUP(7),                 /* -- p1 p2 p3 u v p r p p2 p3 u v p r p */
+	POP(6),                 /* -- p1 p2 p3 u v p r p p2 */
+	EQ(2),                  /* -- p1 p2 p3 u v p r r */
+	DUP(3),                 /* -- p1 p2 p3 u v p r r p r r */
+	POP(2),                 /* -- p1 p2 p3 u v p r r p */
+	DUP(7),                 /* -- p1 p2 p3 u v p r r p p3 u v p r r p */
+	POP(6),                 /* -- p1 p2 p3 u v p r r p p3 */
+	EQ(2),                  /* -- p1 p2 p3 u v p r r r */
+	OR(3),                  /* -- p1 p2 p3 u v p r */
+	PUSHN(4),               /* -- p1 p2 p3 u v p r e */
+	CALL(CHECK_ENTRY),      /* -- p1 p2 p3 */
+
+	/* Count the invalid entries and send the summary event. */
+	DUP(2),                 /* -- p1 p2 p3 p4 u v u v */
+	POP(1),                 /* -- p1 p2 p3 p4 u v u */
+	DUP(2),                 /* -- p1 p2 p3 p4 u v u v u */
+	POP(1),                 /* -- p1 p2 p3 p4 u v u v */
+	ADD,                    /* -- p1 p2 p3 p4 u v u+v */
+	PUSHN(4),               /* -- p1 p2 p3 p4 u v u+v n */
+	ROLL(2),                /* -- p1 p2 p3 p4 u v n u+v */
+	SUB,                    /* -- p1 p2 p3 p4 u v i */
+	DUP(3),                 /* -- p1 p2 p3 p4 u v i u v i */
+	POP(2),                 /* -- p1 p2 p3 p4 u v i u */
+	DUP(2),                 /* -- p1 p2 p3 p4 u v i u i u */
+	POP(1),                 /* -- p1 p2 p3 p4 u v i u i */
+	DUP(4),                 /* -- p1 p2 p3 p4 u v i u i v i u i */
+	POP(3),                 /* -- p1 p2 p3 p4 u v i u i v */
+	CALL(EMIT_SUMMARY),     /* -- p1 p2 p3 p4 u v i */
+
+	/* The table is valid if no entry is invalid. */
+	PUSHN(0),               /* -- p1 p2 p3 p4 u v i 0 */
+	EQ(2),                  /* -- p1 p2 p3 p4 u v valid? */
+	ROLL(7),                /* -- valid? p1 p2 p3 p4 u v */
+	POP(6),                 /* -- valid? */
+	HALT,
+
+
+	/* CHECK_ENTRY:
+	 * u v p r e -- p u v
+	 *
+	 * Reads the rest of entry e, whose parm ID is p, then checks it
+	 * with the subroutine for its kind and class.  r is true if
+	 * an earlier entry has parm ID p.
+	 */
+	INPUT(1),               /* -- u v p r e pa */
+	INPUT(2),               /* -- u v p r e pa pb */
+	INPUT(4),               /* -- u v p r e pa pb lo */
+	INPUT(4),               /* -- u v p r e pa pb lo hi */
+	DUP(7),                 /* -- u v p r e pa pb lo hi p r e pa pb lo hi */
+	POP(6),                 /* -- u v p r e pa pb lo hi p */
+	PUSHN(VS_PARM_UNUSED),  /* -- u v p r e pa pb lo hi p U */
+	EQ(2),                  /* -- u v p r e pa pb lo hi unused? */
+	JMPIF(11),              /* -- u v p r e pa pb lo hi */
+	DUP(7),                 /* -- u v p r e pa pb lo hi p r e pa pb lo hi */
+	POP(6),                 /* -- u v p r e pa pb lo hi p */
+	CALL(IS_ANIMAL),        /* -- u v p r e pa pb lo hi animal? */
+	JMPIF(9),               /* -- u v p r e pa pb lo hi */
+	DUP(7),                 /* -- u v p r e pa pb lo hi p r e pa pb lo hi */
+	POP(6),                 /* -- u v p r e pa pb lo hi p */
+	CALL(IS_DIRECTION),     /* -- u v p r e pa pb lo hi direction? */
+	JMPIF(7),               /* -- u v p r e pa pb lo hi */
+	CALL(CHECK_INVALID),    /* -- */
+	RETURN,
+
+	/* unused: */
+	CALL(CHECK_UNUSED),     /* -- */
+	RETURN,
+
+	/* animal: */
+	CALL(CHECK_ANIMAL),     /* -- */
+	RETURN,
+
+	/* direction: */
+	CALL(CHECK_DIRECTION),  /* -- */
+	RETURN,
+
+
+	/* IS_ANIMAL:
+	 * parmid -- animal?
+	 */
+	DUP(1),                 /* -- parmid parmid */
+	PUSHN(VS_PARM_APE),     /* -- parmid parmid id */
+	EQ(2),                  /* -- parmid Ape? */
+	ROLL(2),                /* -- Ape? parmid */
+	DUP(1),                 /* -- Ape? parmid parmid */
+	PUSHN(VS_PARM_BAT),     /* -- Ape? parmid parmid id */
+	EQ(2),                  /* -- Ape? parmid Bat? */
+	ROLL(2),                /* -- Ape? Bat? parmid */
+	DUP(1),                 /* -- Ape? Bat? parmid parmid */
+	PUSHN(VS_PARM_CAT),     /* -- Ape? Bat? parmid parmid id */
+	EQ(2),                  /* -- Ape? Bat? parmid Cat? */
+	ROLL(2),                /* -- Ape? Bat? Cat? parmid */
+	PUSHN(VS_PARM_DOG),     /* -- Ape? Bat? Cat? parmid id */
+	EQ(2),                  /* -- Ape? Bat? Cat? Dog? */
+	OR(4),                  /* -- animal? */
+	RETURN,
+
+
+	/* IS_DIRECTION:
+	 * parmid -- direction?
+	 */
+	DUP(1),                 /* -- parmid parmid */
+	PUSHN(VS_PARM_NORTH),   /* -- parmid parmid id */
+	EQ(2),                  /* -- parmid North? */
+	ROLL(2),                /* -- North? parmid */
+	DUP(1),                 /* -- North? parmid parmid */
+	PUSHN(VS_PARM_SOUTH),   /* -- North? parmid parmid id */
+	EQ(2),                  /* -- North? parmid South? */
+	ROLL(2),                /* -- North? South? parmid */
+	DUP(1),                 /* -- North? South? parmid parmid */
+	PUSHN(VS_PARM_EAST),    /* -- North? South? parmid parmid id */
+	EQ(2),                  /* -- North? South? parmid East? */
+	ROLL(2),                /* -- North? South? East? parmid */
+	PUSHN(VS_PARM_WEST),    /* -- North? South? East? parmid id */
+	EQ(2),                  /* -- North? South? East? West? */
+	OR(4),                  /* -- direction? */
+	RETURN,
+
+
+	/* CHECK_INVALID:
+	 * u v p r e pa pb lo hi -- p u v
+	 *
+	 * Checks entry e, whose parm ID is invalid.
+	 */
+
+	/* VS_TBL_PARM_ERR_EID */
+	PUSHB(true),            /* -- u v p r e pa pb lo hi c */
+	DUP(6),                 /* -- u v p r e pa pb lo hi c e pa pb lo hi c */
+	POP(5),                 /* -- u v p r e pa pb lo hi c e */
+	CALL(EMIT_VS_TBL_PARM_ERR), /* -- u v p r e pa pb lo hi c */
+
+	/* Drop the fields and count the entry if it's valid. */
+	POP(7),                 /* -- u v p */
+	ROLL(3),                /* -- p u v */
+	RETURN,
+
+
+	/* CHECK_UNUSED:
+	 * u v p r e pa pb lo hi -- p u v
+	 *
+	 * Checks entry e, whose parm ID is VS_PARM_UNUSED.
+	 */
+
+	/* VS_TBL_ZERO_ERR_EID */
+	DUP(4),                 /* -- u v p r e pa pb lo hi pa pb lo hi */
+	POP(3),                 /* -- u v p r e pa pb lo hi pa */
+	DUP(4),                 /* -- u v p r e pa pb lo hi pa pb lo hi pa */
+	POP(3),                 /* -- u v p r e pa pb lo hi pa pb */
+	DUP(4),                 /* -- u v p r e pa pb lo hi pa pb lo hi pa pb */
+	POP(3),                 /* -- u v p r e pa pb lo hi pa pb lo */
+	DUP(4), /* -- u v p r e pa pb lo hi pa pb lo hi pa pb lo */
+	POP(3),                 /* -- u v p r e pa pb lo hi pa pb lo hi */
+	PUSHN(0),               /* -- u v p r e pa pb lo hi pa pb lo hi 0 */
+	EQ(5),                  /* -- u v p r e pa pb lo hi z */
+	NOT,                    /* -- u v p r e pa pb lo hi c */
+	DUP(1),                 /* -- u v p r e pa pb lo hi c c */
+	NOT,                    /* -- u v p r e pa pb lo hi c !c */
+	JMPIF(4),               /* -- u v p r e pa pb lo hi c */
+	DUP(6),                 /* -- u v p r e pa pb lo hi c e pa pb lo hi c */
+	POP(5),                 /* -- u v p r e pa pb lo hi c e */
+	CALL(EMIT_VS_TBL_ZERO_ERR), /* -- u v p r e pa pb lo hi c */
+
+	/* not_2: */
+	/* Drop the fields and count the entry if it's valid. */
+	ROLL(7),                /* -- u v p bad r e pa pb lo hi */
+	POP(6),                 /* -- u v p bad */
+	ROLL(2),                /* -- u v bad p */
+	ROLL(4),                /* -- p u v bad */
+	JMPIF(6),               /* -- p u v */
+	ROLL(2),                /* -- p v u */
+	PUSHN(1),               /* -- p v u 1 */
+	ADD,                    /* -- p v u */
+	ROLL(2),                /* -- p u v */
+	RETURN,
+
+	/* invalid: */
+	RETURN,
+
+
+	/* CHECK_ANIMAL:
+	 * u v p r e pa pb lo hi -- p u v
+	 *
+	 * Checks entry e, whose parm ID is of class animal.
+	 */
+
+	/* VS_TBL_PAD_ERR_EID */
+	DUP(4),                 /* -- u v p r e pa pb lo hi pa pb lo hi */
+	POP(3),                 /* -- u v p r e pa pb lo hi pa */
+	DUP(4),                 /* -- u v p r e pa pb lo hi pa pb lo hi pa */
+	POP(3),                 /* -- u v p r e pa pb lo hi pa pb */
+	PUSHN(0),               /* -- u v p r e pa pb lo hi pa pb 0 */
+	EQ(3),                  /* -- u v p r e pa pb lo hi z */
+	NOT,                    /* -- u v p r e pa pb lo hi c */
+	DUP(1),                 /* -- u v p r e pa pb lo hi c c */
+	NOT,                    /* -- u v p r e pa pb lo hi c !c */
+	JMPIF(6),               /* -- u v p r e pa pb lo hi c */
+	DUP(8), /* -- u v p r e pa pb lo hi c p r e pa pb lo hi c */
+	POP(7),                 /* -- u v p r e pa pb lo hi c p */
+	DUP(7), /* -- u v p r e pa pb lo hi c p e pa pb lo hi c p */
+	POP(6),                 /* -- u v p r e pa pb lo hi c p e */
+	CALL(EMIT_VS_TBL_PAD_ERR), /* -- u v p r e pa pb lo hi c */
+
+	/* not_3: */
+	/* VS_TBL_LBND_ERR_EID */
+	DUP(3),                 /* -- u v p r e pa pb lo hi bad lo hi bad */
+	POP(2),                 /* -- u v p r e pa pb lo hi bad lo */
+	PUSHN(VS_PARM_ANIMAL_MIN), /* -- u v p r e pa pb lo hi bad lo min */
+	LT,                     /* -- u v p r e pa pb lo hi bad lt */
+	DUP(4), /* -- u v p r e pa pb lo hi bad lt lo hi bad lt */
+	POP(3),                 /* -- u v p r e pa pb lo hi bad lt lo */
+	PUSHN(VS_PARM_ANIMAL_MAX), /* -- u v p r e pa pb lo hi bad lt lo max */
+	GT,                     /* -- u v p r e pa pb lo hi bad lt gt */
+	OR(2),                  /* -- u v p r e pa pb lo hi bad c */
+	DUP(1),                 /* -- u v p r e pa pb lo hi bad c c */
+	NOT,                    /* -- u v p r e pa pb lo hi bad c !c */
+	JMPIF(6),               /* -- u v p r e pa pb lo hi bad c */
+	DUP(9), /* -- u v p r e pa pb lo hi bad c p r e pa pb lo hi bad c */
+	POP(8),                 /* -- u v p r e pa pb lo hi bad c p */
+	DUP(8), /* -- u v p r e pa pb lo hi bad c p e pa pb lo hi bad c p */
+	POP(7),                 /* -- u v p r e pa pb lo hi bad c p e */
+	CALL(EMIT_VS_TBL_LBND_ERR), /* -- u v p r e pa pb lo hi bad c */
+	/* not_4: */
+	OR(2),                  /* -- u v p r e pa pb lo hi bad */
+
+	/* VS_TBL_HBND_ERR_EID */
+	DUP(2),                 /* -- u v p r e pa pb lo hi bad hi bad */
+	POP(1),                 /* -- u v p r e pa pb lo hi bad hi */
+	PUSHN(VS_PARM_ANIMAL_MIN), /* -- u v p r e pa pb lo hi bad hi min */
+	LT,                     /* -- u v p r e pa pb lo hi bad lt */
+	DUP(3),                 /* -- u v p r e pa pb lo hi bad lt hi bad lt */
+	POP(2),                 /* -- u v p r e pa pb lo hi bad lt hi */
+	PUSHN(VS_PARM_ANIMAL_MAX), /* -- u v p r e pa pb lo hi bad lt hi max */
+	GT,                     /* -- u v p r e pa pb lo hi bad lt gt */
+	OR(2),                  /* -- u v p r e pa pb lo hi bad c */
+	DUP(1),                 /* -- u v p r e pa pb lo hi bad c c */
+	NOT,                    /* -- u v p r e pa pb lo hi bad c !c */
+	JMPIF(6),               /* -- u v p r e pa pb lo hi bad c */
+	DUP(9), /* -- u v p r e pa pb lo hi bad c p r e pa pb lo hi bad c */
+	POP(8),                 /* -- u v p r e pa pb lo hi bad c p */
+	DUP(8), /* -- u v p r e pa pb lo hi bad c p e pa pb lo hi bad c p */
+	POP(7),                 /* -- u v p r e pa pb lo hi bad c p e */
+	CALL(EMIT_VS_TBL_HBND_ERR), /* -- u v p r e pa pb lo hi bad c */
+	/* not_5: */
+	OR(2),                  /* -- u v p r e pa pb lo hi bad */
+
+	/* VS_TBL_ORDER_ERR_EID */
+	DUP(3),                 /* -- u v p r e pa pb lo hi bad lo hi bad */
+	POP(2),                 /* -- u v p r e pa pb lo hi bad lo */
+	DUP(3),                 /* -- u v p r e pa pb lo hi bad lo hi bad lo */
+	POP(2),                 /* -- u v p r e pa pb lo hi bad lo hi */
+	GT,                     /* -- u v p r e pa pb lo hi bad c */
+	DUP(1),                 /* -- u v p r e pa pb lo hi bad c c */
+	NOT,                    /* -- u v p r e pa pb lo hi bad c !c */
+	JMPIF(6),               /* -- u v p r e pa pb lo hi bad c */
+	DUP(9), /* -- u v p r e pa pb lo hi bad c p r e pa pb lo hi bad c */
+	POP(8),                 /* -- u v p r e pa pb lo hi bad c p */
+	DUP(8), /* -- u v p r e pa pb lo hi bad c p e pa pb lo hi bad c p */
+	POP(7),                 /* -- u v p r e pa pb lo hi bad c p e */
+	CALL(EMIT_VS_TBL_ORDER_ERR), /* -- u v p r e pa pb lo hi bad c */
+	/* not_6: */
+	OR(2),                  /* -- u v p r e pa pb lo hi bad */
+
+	/* VS_TBL_EXTRA_ERR_EID */
+	DUP(10), /* -- u v p r e pa pb lo hi bad u v p r e pa pb lo hi bad */
+	POP(9),                 /* -- u v p r e pa pb lo hi bad u */
+	PUSHN(0),               /* -- u v p r e pa pb lo hi bad u 0 */
+	EQ(2),                  /* -- u v p r e pa pb lo hi bad z */
+	NOT,                    /* -- u v p r e pa pb lo hi bad c */
+	DUP(1),                 /* -- u v p r e pa pb lo hi bad c c */
+	NOT,                    /* -- u v p r e pa pb lo hi bad c !c */
+	JMPIF(6),               /* -- u v p r e pa pb lo hi bad c */
+	DUP(9), /* -- u v p r e pa pb lo hi bad c p r e pa pb lo hi bad c */
+	POP(8),                 /* -- u v p r e pa pb lo hi bad c p */
+	DUP(8), /* -- u v p r e pa pb lo hi bad c p e pa pb lo hi bad c p */
+	POP(7),                 /* -- u v p r e pa pb lo hi bad c p e */
+	CALL(EMIT_VS_TBL_EXTRA_ERR), /* -- u v p r e pa pb lo hi bad c */
+	/* not_7: */
+	OR(2),                  /* -- u v p r e pa pb lo hi bad */
+
+	/* VS_TBL_REDEF_ERR_EID */
+	DUP(7), /* -- u v p r e pa pb lo hi bad r e pa pb lo hi bad */
+	POP(6),                 /* -- u v p r e pa pb lo hi bad r */
+	DUP(1),                 /* -- u v p r e pa pb lo hi bad c c */
+	NOT,                    /* -- u v p r e pa pb lo hi bad c !c */
+	JMPIF(6),               /* -- u v p r e pa pb lo hi bad c */
+	DUP(9), /* -- u v p r e pa pb lo hi bad c p r e pa pb lo hi bad c */
+	POP(8),                 /* -- u v p r e pa pb lo hi bad c p */
+	DUP(8), /* -- u v p r e pa pb lo hi bad c p e pa pb lo hi bad c p */
+	POP(7),                 /* -- u v p r e pa pb lo hi bad c p e */
+	CALL(EMIT_VS_TBL_REDEF_ERR), /* -- u v p r e pa pb lo hi bad c */
+	/* not_8: */
+	OR(2),                  /* -- u v p r e pa pb lo hi bad */
+
+	/* Drop the fields and count the entry if it's valid. */
+	ROLL(7),                /* -- u v p bad r e pa pb lo hi */
+	POP(6),                 /* -- u v p bad */
+	ROLL(2),                /* -- u v bad p */
+	ROLL(4),                /* -- p u v bad */
+	JMPIF(4),               /* -- p u v */
+	PUSHN(1),               /* -- p u v 1 */
+	ADD,                    /* -- p u v */
+	RETURN,
+
+	/* invalid: */
+	RETURN,
+
+
+	/* CHECK_DIRECTION:
+	 * u v p r e pa pb lo hi -- p u v
+	 *
+	 * Checks entry e, whose parm ID is of class direction.
+	 */
+
+	/* VS_TBL_PAD_ERR_EID */
+	DUP(4),                 /* -- u v p r e pa pb lo hi pa pb lo hi */
+	POP(3),                 /* -- u v p r e pa pb lo hi pa */
+	DUP(4),                 /* -- u v p r e pa pb lo hi pa pb lo hi pa */
+	POP(3),                 /* -- u v p r e pa pb lo hi pa pb */
+	PUSHN(0),               /* -- u v p r e pa pb lo hi pa pb 0 */
+	EQ(3),                  /* -- u v p r e pa pb lo hi z */
+	NOT,                    /* -- u v p r e pa pb lo hi c */
+	DUP(1),                 /* -- u v p r e pa pb lo hi c c */
+	NOT,                    /* -- u v p r e pa pb lo hi c !c */
+	JMPIF(6),               /* -- u v p r e pa pb lo hi c */
+	DUP(8), /* -- u v p r e pa pb lo hi c p r e pa pb lo hi c */
+	POP(7),                 /* -- u v p r e pa pb lo hi c p */
+	DUP(7), /* -- u v p r e pa pb lo hi c p e pa pb lo hi c p */
+	POP(6),                 /* -- u v p r e pa pb lo hi c p e */
+	CALL(EMIT_VS_TBL_PAD_ERR), /* -- u v p r e pa pb lo hi c */
+
+	/* not_3: */
+	/* VS_TBL_LBND_ERR_EID */
+	DUP(3),                 /* -- u v p r e pa pb lo hi bad lo hi bad */
+	POP(2),                 /* -- u v p r e pa pb lo hi bad lo */
+	PUSHN(VS_PARM_DIRECTION_MIN), /* -- u v p r e pa pb lo hi bad lo min */
+	LT,                     /* -- u v p r e pa pb lo hi bad lt */
+	DUP(4), /* -- u v p r e pa pb lo hi bad lt lo hi bad lt */
+	POP(3),                 /* -- u v p r e pa pb lo hi bad lt lo */
+	PUSHN(VS_PARM_DIRECTION_MAX),
+		/* -- u v p r e pa pb lo hi bad lt lo max */
+	GT,                     /* -- u v p r e pa pb lo hi bad lt gt */
+	OR(2),                  /* -- u v p r e pa pb lo hi bad c */
+	DUP(1),                 /* -- u v p r e pa pb lo hi bad c c */
+	NOT,                    /* -- u v p r e pa pb lo hi bad c !c */
+	JMPIF(6),               /* -- u v p r e pa pb lo hi bad c */
+	DUP(9), /* -- u v p r e pa pb lo hi bad c p r e pa pb lo hi bad c */
+	POP(8),                 /* -- u v p r e pa pb lo hi bad c p */
+	DUP(8), /* -- u v p r e pa pb lo hi bad c p e pa pb lo hi bad c p */
+	POP(7),                 /* -- u v p r e pa pb lo hi bad c p e */
+	CALL(EMIT_VS_TBL_LBND_ERR), /* -- u v p r e pa pb lo hi bad c */
+	/* not_4: */
+	OR(2),                  /* -- u v p r e pa pb lo hi bad */
+
+	/* VS_TBL_HBND_ERR_EID */
+	DUP(2),                 /* -- u v p r e pa pb lo hi bad hi bad */
+	POP(1),                 /* -- u v p r e pa pb lo hi bad hi */
+	PUSHN(VS_PARM_DIRECTION_MIN), /* -- u v p r e pa pb lo hi bad hi min */
+	LT,                     /* -- u v p r e pa pb lo hi bad lt */
+	DUP(3),                 /* -- u v p r e pa pb lo hi bad lt hi bad lt */
+	POP(2),                 /* -- u v p r e pa pb lo hi bad lt hi */
+	PUSHN(VS_PARM_DIRECTION_MAX),
+		/* -- u v p r e pa pb lo hi bad lt hi max */
+	GT,                     /* -- u v p r e pa pb lo hi bad lt gt */
+	OR(2),                  /* -- u v p r e pa pb lo hi bad c */
+	DUP(1),                 /* -- u v p r e pa pb lo hi bad c c */
+	NOT,                    /* -- u v p r e pa pb lo hi bad c !c */
+	JMPIF(6),               /* -- u v p r e pa pb lo hi bad c */
+	DUP(9), /* -- u v p r e pa pb lo hi bad c p r e pa pb lo hi bad c */
+	POP(8),                 /* -- u v p r e pa pb lo hi bad c p */
+	DUP(8), /* -- u v p r e pa pb lo hi bad c p e pa pb lo hi bad c p */
+	POP(7),                 /* -- u v p r e pa pb lo hi bad c p e */
+	CALL(EMIT_VS_TBL_HBND_ERR), /* -- u v p r e pa pb lo hi bad c */
+	/* not_5: */
+	OR(2),                  /* -- u v p r e pa pb lo hi bad */
+
+	/* VS_TBL_ORDER_ERR_EID */
+	DUP(3),                 /* -- u v p r e pa pb lo hi bad lo hi bad */
+	POP(2),                 /* -- u v p r e pa pb lo hi bad lo */
+	DUP(3),                 /* -- u v p r e pa pb lo hi bad lo hi bad lo */
+	POP(2),                 /* -- u v p r e pa pb lo hi bad lo hi */
+	GT,                     /* -- u v p r e pa pb lo hi bad c */
+	DUP(1),                 /* -- u v p r e pa pb lo hi bad c c */
+	NOT,                    /* -- u v p r e pa pb lo hi bad c !c */
+	JMPIF(6),               /* -- u v p r e pa pb lo hi bad c */
+	DUP(9), /* -- u v p r e pa pb lo hi bad c p r e pa pb lo hi bad c */
+	POP(8),                 /* -- u v p r e pa pb lo hi bad c p */
+	DUP(8), /* -- u v p r e pa pb lo hi bad c p e pa pb lo hi bad c p */
+	POP(7),                 /* -- u v p r e pa pb lo hi bad c p e */
+	CALL(EMIT_VS_TBL_ORDER_ERR), /* -- u v p r e pa pb lo hi bad c */
+	/* not_6: */
+	OR(2),                  /* -- u v p r e pa pb lo hi bad */
+
+	/* VS_TBL_EXTRA_ERR_EID */
+	DUP(10), /* -- u v p r e pa pb lo hi bad u v p r e pa pb lo hi bad */
+	POP(9),                 /* -- u v p r e pa pb lo hi bad u */
+	PUSHN(0),               /* -- u v p r e pa pb lo hi bad u 0 */
+	EQ(2),                  /* -- u v p r e pa pb lo hi bad z */
+	NOT,                    /* -- u v p r e pa pb lo hi bad c */
+	DUP(1),                 /* -- u v p r e pa pb lo hi bad c c */
+	NOT,                    /* -- u v p r e pa pb lo hi bad c !c */
+	JMPIF(6),               /* -- u v p r e pa pb lo hi bad c */
+	DUP(9), /* -- u v p r e pa pb lo hi bad c p r e pa pb lo hi bad c */
+	POP(8),                 /* -- u v p r e pa pb lo hi bad c p */
+	DUP(8), /* -- u v p r e pa pb lo hi bad c p e pa pb lo hi bad c p */
+	POP(7),                 /* -- u v p r e pa pb lo hi bad c p e */
+	CALL(EMIT_VS_TBL_EXTRA_ERR), /* -- u v p r e pa pb lo hi bad c */
+	/* not_7: */
+	OR(2),                  /* -- u v p r e pa pb lo hi bad */
+
+	/* VS_TBL_REDEF_ERR_EID */
+	DUP(7), /* -- u v p r e pa pb lo hi bad r e pa pb lo hi bad */
+	POP(6),                 /* -- u v p r e pa pb lo hi bad r */
+	DUP(1),                 /* -- u v p r e pa pb lo hi bad c c */
+	NOT,                    /* -- u v p r e pa pb lo hi bad c !c */
+	JMPIF(6),               /* -- u v p r e pa pb lo hi bad c */
+	DUP(9), /* -- u v p r e pa pb lo hi bad c p r e pa pb lo hi bad c */
+	POP(8),                 /* -- u v p r e pa pb lo hi bad c p */
+	DUP(8), /* -- u v p r e pa pb lo hi bad c p e pa pb lo hi bad c p */
+	POP(7),                 /* -- u v p r e pa pb lo hi bad c p e */
+	CALL(EMIT_VS_TBL_REDEF_ERR), /* -- u v p r e pa pb lo hi bad c */
+	/* not_8: */
+	OR(2),                  /* -- u v p r e pa pb lo hi bad */
+
+	/* Drop the fields and count the entry if it's valid. */
+	ROLL(7),                /* -- u v p bad r e pa pb lo hi */
+	POP(6),                 /* -- u v p bad */
+	ROLL(2),                /* -- u v bad p */
+	ROLL(4),                /* -- p u v bad */
+	JMPIF(4),               /* -- p u v */
+	PUSHN(1),               /* -- p u v 1 */
+	ADD,                    /* -- p u v */
+	RETURN,
+
+	/* invalid: */
+	RETURN,
+
+
+	/* EMIT_VS_TBL_PARM_ERR:
+	 * e --
+	 *
+	 * Sends VS_TBL_PARM_ERR_EID: "Table entry N invalid Parm ID"
+	 */
+	PUSHS(0),               /* -- e str */
+	OUTPUT,                 /* -- e */
+	OUTPUT,                 /* -- */
+	PUSHS(1),               /* -- str */
+	OUTPUT,                 /* -- */
+	PUSHN(VS_TBL_PARM_ERR_EID), /* -- eid */
+	PUSHN(CFE_EVS_EventType_ERROR), /* -- eid etype */
+	FLUSH,                  /* -- */
+	RETURN,
+
+
+	/* EMIT_VS_TBL_ZERO_ERR:
+	 * e --
+	 *
+	 * Sends VS_TBL_ZERO_ERR_EID: "Table entry N parm P not zeroed"
+	 */
+	PUSHS(0),               /* -- e str */
+	OUTPUT,                 /* -- e */
+	OUTPUT,                 /* -- */
+	PUSHS(2),               /* -- str */
+	OUTPUT,                 /* -- */
+	PUSHN(VS_TBL_ZERO_ERR_EID), /* -- eid */
+	PUSHN(CFE_EVS_EventType_ERROR), /* -- eid etype */
+	FLUSH,                  /* -- */
+	RETURN,
+
+
+	/* EMIT_VS_TBL_PAD_ERR:
+	 * p e --
+	 *
+	 * Sends VS_TBL_PAD_ERR_EID: "Table entry N parm P padding not zeroed"
+	 */
+	PUSHS(0),               /* -- p e str */
+	OUTPUT,                 /* -- p e */
+	OUTPUT,                 /* -- p */
+	PUSHS(3),               /* -- p str */
+	OUTPUT,                 /* -- p */
+	CALL(PARM_TO_STR),      /* -- ps */
+	OUTPUT,                 /* -- */
+	PUSHS(4),               /* -- str */
+	OUTPUT,                 /* -- */
+	PUSHN(VS_TBL_PAD_ERR_EID), /* -- eid */
+	PUSHN(CFE_EVS_EventType_ERROR), /* -- eid etype */
+	FLUSH,                  /* -- */
+	RETURN,
+
+
+	/* EMIT_VS_TBL_LBND_ERR:
+	 * p e --
+	 *
+	 * Sends VS_TBL_LBND_ERR_EID: "Table entry N parm P invalid low bound"
+	 */
+	PUSHS(0),               /* -- p e str */
+	OUTPUT,                 /* -- p e */
+	OUTPUT,                 /* -- p */
+	PUSHS(3),               /* -- p str */
+	OUTPUT,                 /* -- p */
+	CALL(PARM_TO_STR),      /* -- ps */
+	OUTPUT,                 /* -- */
+	PUSHS(5),               /* -- str */
+	OUTPUT,                 /* -- */
+	PUSHN(VS_TBL_LBND_ERR_EID), /* -- eid */
+	PUSHN(CFE_EVS_EventType_ERROR), /* -- eid etype */
+	FLUSH,                  /* -- */
+	RETURN,
+
+
+	/* EMIT_VS_TBL_HBND_ERR:
+	 * p e --
+	 *
+	 * Sends VS_TBL_HBND_ERR_EID: "Table entry N parm P invalid high bound"
+	 */
+	PUSHS(0),               /* -- p e str */
+	OUTPUT,                 /* -- p e */
+	OUTPUT,                 /* -- p */
+	PUSHS(3),               /* -- p str */
+	OUTPUT,                 /* -- p */
+	CALL(PARM_TO_STR),      /* -- ps */
+	OUTPUT,                 /* -- */
+	PUSHS(6),               /* -- str */
+	OUTPUT,                 /* -- */
+	PUSHN(VS_TBL_HBND_ERR_EID), /* -- eid */
+	PUSHN(CFE_EVS_EventType_ERROR), /* -- eid etype */
+	FLUSH,                  /* -- */
+	RETURN,
+
+
+	/* EMIT_VS_TBL_ORDER_ERR:
+	 * p e --
+	 *
+	 * Sends VS_TBL_ORDER_ERR_EID: "Table entry N parm P invalid bound order"
+	 */
+	PUSHS(0),               /* -- p e str */
+	OUTPUT,                 /* -- p e */
+	OUTPUT,                 /* -- p */
+	PUSHS(3),               /* -- p str */
+	OUTPUT,                 /* -- p */
+	CALL(PARM_TO_STR),      /* -- ps */
+	OUTPUT,                 /* -- */
+	PUSHS(7),               /* -- str */
+	OUTPUT,                 /* -- */
+	PUSHN(VS_TBL_ORDER_ERR_EID), /* -- eid */
+	PUSHN(CFE_EVS_EventType_ERROR), /* -- eid etype */
+	FLUSH,                  /* -- */
+	RETURN,
+
+
+	/* EMIT_VS_TBL_EXTRA_ERR:
+	 * p e --
+	 *
+	 * Sends VS_TBL_EXTRA_ERR_EID: "Table entry N parm P follows an unused entry"
+	 */
+	PUSHS(0),               /* -- p e str */
+	OUTPUT,                 /* -- p e */
+	OUTPUT,                 /* -- p */
+	PUSHS(3),               /* -- p str */
+	OUTPUT,                 /* -- p */
+	CALL(PARM_TO_STR),      /* -- ps */
+	OUTPUT,                 /* -- */
+	PUSHS(8),               /* -- str */
+	OUTPUT,                 /* -- */
+	PUSHN(VS_TBL_EXTRA_ERR_EID), /* -- eid */
+	PUSHN(CFE_EVS_EventType_ERROR), /* -- eid etype */
+	FLUSH,                  /* -- */
+	RETURN,
+
+
+	/* EMIT_VS_TBL_REDEF_ERR:
+	 * p e --
+	 *
+	 * Sends VS_TBL_REDEF_ERR_EID: "Table entry N parm P redefines earlier entry"
+	 */
+	PUSHS(0),               /* -- p e str */
+	OUTPUT,                 /* -- p e */
+	OUTPUT,                 /* -- p */
+	PUSHS(3),               /* -- p str */
+	OUTPUT,                 /* -- p */
+	CALL(PARM_TO_STR),      /* -- ps */
+	OUTPUT,                 /* -- */
+	PUSHS(9),               /* -- str */
+	OUTPUT,                 /* -- */
+	PUSHN(VS_TBL_REDEF_ERR_EID), /* -- eid */
+	PUSHN(CFE_EVS_EventType_ERROR), /* -- eid etype */
+	FLUSH,                  /* -- */
+	RETURN,
+
+
+	/* EMIT_SUMMARY:
+	 * u i v --
+	 *
+	 * Sends VS_VALIDATION_INF_EID: "Table image entries: V valid, I invalid, U unused"
+	 */
+	PUSHS(10),              /* -- u i v str */
+	OUTPUT,                 /* -- u i v */
+	OUTPUT,                 /* -- u i */
+	PUSHS(11),              /* -- u i str */
+	OUTPUT,                 /* -- u i */
+	OUTPUT,                 /* -- u */
+	PUSHS(12),              /* -- u str */
+	OUTPUT,                 /* -- u */
+	OUTPUT,                 /* -- */
+	PUSHS(13),              /* -- str */
+	OUTPUT,                 /* -- */
+	PUSHN(VS_VALIDATION_INF_EID), /* -- eid */
+	PUSHN(CFE_EVS_EventType_INFORMATION), /* -- eid etype */
+	FLUSH,                  /* -- */
+	RETURN,
+
+
+	/* PARM_TO_STR:
+	 * parmid -- parmstring
+	 */
+	DUP(1),                 /* -- parmid parmid */
+	PUSHN(VS_PARM_UNUSED),  /* -- parmid parmid code */
+	EQ(2),                  /* -- parmid equal? */
+	NOT,                    /* -- parmid not-equal? */
+	JMPIF(4),               /* -- parmid */
+	POP(1),                 /* -- */
+	PUSHS(14),              /* -- string */
+	RETURN,
+
+	/* not_unused: */
+	DUP(1),                 /* -- parmid parmid */
+	PUSHN(VS_PARM_APE),     /* -- parmid parmid code */
+	EQ(2),                  /* -- parmid equal? */
+	NOT,                    /* -- parmid not-equal? */
+	JMPIF(4),               /* -- parmid */
+	POP(1),                 /* -- */
+	PUSHS(15),              /* -- string */
+	RETURN,
+
+	/* not_ape: */
+	DUP(1),                 /* -- parmid parmid */
+	PUSHN(VS_PARM_BAT),     /* -- parmid parmid code */
+	EQ(2),                  /* -- parmid equal? */
+	NOT,                    /* -- parmid not-equal? */
+	JMPIF(4),               /* -- parmid */
+	POP(1),                 /* -- */
+	PUSHS(16),              /* -- string */
+	RETURN,
+
+	/* not_bat: */
+	DUP(1),                 /* -- parmid parmid */
+	PUSHN(VS_PARM_CAT),     /* -- parmid parmid code */
+	EQ(2),                  /* -- parmid equal? */
+	NOT,                    /* -- parmid not-equal? */
+	JMPIF(4),               /* -- parmid */
+	POP(1),                 /* -- */
+	PUSHS(17),              /* -- string */
+	RETURN,
+
+	/* not_cat: */
+	DUP(1),                 /* -- parmid parmid */
+	PUSHN(VS_PARM_DOG),     /* -- parmid parmid code */
+	EQ(2),                  /* -- parmid equal? */
+	NOT,                    /* -- parmid not-equal? */
+	JMPIF(4),               /* -- parmid */
+	POP(1),                 /* -- */
+	PUSHS(18),              /* -- string */
+	RETURN,
+
+	/* not_dog: */
+	DUP(1),                 /* -- parmid parmid */
+	PUSHN(VS_PARM_NORTH),   /* -- parmid parmid code */
+	EQ(2),                  /* -- parmid equal? */
+	NOT,                    /* -- parmid not-equal? */
+	JMPIF(4),               /* -- parmid */
+	POP(1),                 /* -- */
+	PUSHS(19),              /* -- string */
+	RETURN,
+
+	/* not_north: */
+	DUP(1),                 /* -- parmid parmid */
+	PUSHN(VS_PARM_SOUTH),   /* -- parmid parmid code */
+	EQ(2),                  /* -- parmid equal? */
+	NOT,                    /* -- parmid not-equal? */
+	JMPIF(4),               /* -- parmid */
+	POP(1),                 /* -- */
+	PUSHS(20),              /* -- string */
+	RETURN,
+
+	/* not_south: */
+	DUP(1),                 /* -- parmid parmid */
+	PUSHN(VS_PARM_EAST),    /* -- parmid parmid code */
+	EQ(2),                  /* -- parmid equal? */
+	NOT,                    /* -- parmid not-equal? */
+	JMPIF(4),               /* -- parmid */
+	POP(1),                 /* -- */
+	PUSHS(21),              /* -- string */
+	RETURN,
+
+	/* not_east: */
+	DUP(1),                 /* -- parmid parmid */
+	PUSHN(VS_PARM_WEST),    /* -- parmid parmid code */
+	EQ(2),                  /* -- parmid equal? */
+	NOT,                    /* -- parmid not-equal? */
+	JMPIF(4),               /* -- parmid */
+	POP(1),                 /* -- */
+	PUSHS(22),              /* -- string */
+	RETURN,
+
+	/* not_west: */
+	POP(1),                 /* -- */
+	PUSHS(23),              /* -- string */
+	RETURN,
+#ifndef GRUNT_XMACRO_EXPAND
+};
+#endif
+
+#endif
@@ -0,0 +1,266 @@
+#if !defined(_VSVF_SCREEN_H_) || defined(GRUNT_XMACRO_EXPAND)
+#ifndef GRUNT_XMACRO_EXPAND
+#define _VSVF_SCREEN_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* GENERATED FILE - DO NOT EDIT.
+ *
+ * The gruntasm assembler generated this file from the Grunt assembly
+ * source in vsvf_screen.gasm.  Edit the source and run gruntasm again instead.
+ *
+ * Including this file again with GRUNT_XMACRO_EXPAND defined yields
+ * only the program's instructions, for grunt_xmacro.h to expand into
+ * C statements.
+ */
+static const char *vsvf_screen_strings[] = {
+	NULL,   /* C has no empty arrays */
+};
+#define VSVF_SCREEN_NUM_STRINGS 0
+
+static const grunt_rep_t vsvf_screen_string_lengths[] = {
+	0,      /* C has no empty arrays */
+};
+
+/* The screening program decides the same valid? result as vsvf.gasm
+ * for every table image, but it says nothing about why.  It sends no
+ * events and halts False at the first problem it finds, so rejecting
+ * a bad image costs only the instructions up to that problem.  The
+ * VSC_SCREEN_CC command runs it to pre-screen candidate images.
+ *
+ * Because it halts at the first invalid entry, every entry before the
+ * one it is checking is valid.  That spares it vsvf.gasm's counts:
+ * an in-use entry is invalid after an unused entry exactly when one
+ * of the saved Parm IDs before it is VS_PARM_UNUSED.  The saved Parm
+ * IDs start out as 255, which names no parm, rather than as
+ * VS_PARM_UNUSED.
+ */
+
+/* The program reads each entry's parm ID, pad, and bounds in turn. */
+#define VSVF_SCREEN_RECORD_OFFSET 0
+#define VSVF_SCREEN_RECORD_SIZE   12
+
+#define SCREEN_MAIN              0
+#define SCREEN_ENTRY             9
+#define SCREEN_PRIOR             36
+#define SCREEN_PARMID            47
+#define SCREEN_INUSE             62
+#define SCREEN_ANIMAL            84
+#define SCREEN_DIRECTION         100
+#define VSVF_SCREEN_NUM_INSTRUCTIONS 116
+
+/* The most instructions one run of the program executes, and the
+ * most cycles it takes at the costs in host.costs.
+ */
+#define VSVF_SCREEN_WCET_STEPS  447
+#define VSVF_SCREEN_WCET_CYCLES 28532
+
+static const grunt_instruction_t vsvf_screen_program[] = {
+#endif /* GRUNT_XMACRO_EXPAND */
+
+	/* SCREEN_MAIN:
+	 * -- valid?
+	 *
+	 * Screen each of the four entries.  SCREEN_ENTRY halts the
+	 * program if it finds a problem, so reaching the end of the
+	 * loop means the image is valid.  The loop's state is the
+	 * Parm IDs of the three entries before this one, s1 s2 s3.
+	 */
+	PUSHN(255),             /* -- saved-parmid-1 */
+	PUSHN(255),             /* -- s1 saved-parmid-2 */
+	PUSHN(255),             /* -- s1 s2 saved-parmid-3 */
+	REPEAT(4),              /* -- s1 s2 s3 */
+	CALL(SCREEN_ENTRY),     /* -- s2 s3 p */
+	END,                    /* -- s1 s2 s3 */
+
+	POP(3),                 /* -- */
+	PUSHB(true),            /* -- valid? */
+	HALT,
+
+
+	/* SCREEN_ENTRY:
+	 * saved-parmid-1 saved-parmid-2 saved-parmid-3 --
+	 * saved-parmid-2 saved-parmid-3 parmid
+	 *
+	 * Reads one entry and halts False if it is invalid.  Otherwise,
+	 * shifts its Parm ID into the saved ones.
+	 */
+	INPUT(1),               /* -- s1 s2 s3 p */
+	DUP(1),                 /* -- s1 s2 s3 p p */
+	PUSHN(VS_PARM_UNUSED),  /* -- s1 s2 s3 p p U */
+	EQ(2),                  /* -- s1 s2 s3 p unused? */
+	NOT,                    /* -- s1 s2 s3 p not-unused? */
+	JMPIF(9),               /* -- s1 s2 s3 p */
+
+	/* An unused entry must be all zeroes. */
+	INPUTZ(11),             /* -- s1 s2 s3 p zeroed? */
+	NOT,                    /* -- s1 s2 s3 p not-zeroed? */
+	JMPIF(17),              /* -- s1 s2 s3 p */
+	ROLL(4),                /* -- p s1 s2 s3 */
+	ROLL(4),                /* -- s3 p s1 s2 */
+	ROLL(4),                /* -- s2 s3 p s1 */
+	POP(1),                 /* -- s2 s3 p */
+	RETURN,
+
+	/* inuse: */
+	/* An in-use entry may follow neither an unused entry nor an
+	 * entry with the same Parm ID.
+	 */
+	DUP(4),                 /* -- s1 s2 s3 p s1 s2 s3 p */
+	CALL(SCREEN_PRIOR),     /* -- s1 s2 s3 p s1 s2 p */
+	CALL(SCREEN_PRIOR),     /* -- s1 s2 s3 p s1 p */
+	CALL(SCREEN_PRIOR),     /* -- s1 s2 s3 p p */
+
+	/* Its pad and bounds must suit its kind of Parm ID. */
+	CALL(SCREEN_PARMID),    /* -- s1 s2 s3 p max min */
+	CALL(SCREEN_INUSE),     /* -- s1 s2 s3 p */
+	ROLL(4),                /* -- p s1 s2 s3 */
+	ROLL(4),                /* -- s3 p s1 s2 */
+	ROLL(4),                /* -- s2 s3 p s1 */
+	POP(1),                 /* -- s2 s3 p */
+	RETURN,
+
+	/* invalid: */
+	PUSHB(false),           /* -- s1 s2 s3 p valid? */
+	HALT,
+
+
+	/* SCREEN_PRIOR:
+	 * saved-parmid parmid -- parmid
+	 *
+	 * Halts False if the saved Parm ID of an earlier entry is this
+	 * entry's Parm ID or VS_PARM_UNUSED.
+	 */
+	DUP(2),                 /* -- s p s p */
+	EQ(2),                  /* -- s p redef? */
+	ROLL(3),                /* -- redef? s p */
+	ROLL(3),                /* -- p redef? s */
+	PUSHN(VS_PARM_UNUSED),  /* -- p redef? s U */
+	EQ(2),                  /* -- p redef? extra? */
+	OR(2),                  /* -- p invalid? */
+	JMPIF(2),               /* -- p */
+	RETURN,
+
+	/* invalid: */
+	PUSHB(false),           /* -- p valid? */
+	HALT,
+
+
+	/* SCREEN_PARMID:
+	 * parmid -- max min
+	 *
+	 * Halts False unless the Parm ID names an animal or direction
+	 * parm, and returns the bounds for its kind.
+	 */
+	DUP(1),                 /* -- p p */
+	CALL(SCREEN_ANIMAL),    /* -- p animal? */
+	JMPIF(7),               /* -- p */
+	CALL(SCREEN_DIRECTION), /* -- direction? */
+	NOT,                    /* -- not-direction? */
+	JMPIF(8),               /* -- */
+	PUSHN(VS_PARM_DIRECTION_MAX), /* -- max */
+	PUSHN(VS_PARM_DIRECTION_MIN), /* -- max min */
+	RETURN,
+
+	/* animal: */
+	POP(1),                 /* -- */
+	PUSHN(VS_PARM_ANIMAL_MAX), /* -- max */
+	PUSHN(VS_PARM_ANIMAL_MIN), /* -- max min */
+	RETURN,
+
+	/* invalid: */
+	PUSHB(false),           /* -- valid? */
+	HALT,
+
+
+	/* SCREEN_INUSE:
+	 * max min --
+	 *
+	 * Reads an in-use entry's pad and bounds and halts False unless
+	 * the pad is zeroed and min <= lbnd <= hbnd <= max.  Those three
+	 * comparisons imply vsvf.gasm's range checks on both bounds.
+	 */
+	INPUTZ(3),              /* -- max min zeroed? */
+	NOT,                    /* -- max min not-zeroed? */
+	JMPIF(18),              /* -- max min */
+	INPUT(4),               /* -- max min l */
+	DUP(1),                 /* -- max min l l */
+	ROLL(3),                /* -- max l min l */
+	ROLL(2),                /* -- max l l min */
+	LT,                     /* -- max l l<min? */
+	JMPIF(12),              /* -- max l */
+	INPUT(4),               /* -- max l h */
+	DUP(1),                 /* -- max l h h */
+	ROLL(4),                /* -- h max l h */
+	ROLL(2),                /* -- h max h l */
+	LT,                     /* -- h max h<l? */
+	JMPIF(6),               /* -- h max */
+	DUP(2),                 /* -- h max h max */
+	GT,                     /* -- h max h>max? */
+	JMPIF(3),               /* -- h max */
+	POP(2),                 /* -- */
+	RETURN,
+
+	/* invalid: */
+	PUSHB(false),           /* -- max ... valid? */
+	HALT,
+
+
+	/* SCREEN_ANIMAL:
+	 * parmid -- animal?
+	 */
+	DUP(1),                 /* -- parmid parmid */
+	PUSHN(VS_PARM_APE),     /* -- parmid parmid A */
+	EQ(2),                  /* -- parmid A? */
+	ROLL(2),                /* -- A? parmid */
+	DUP(1),                 /* -- A? parmid parmid */
+	PUSHN(VS_PARM_BAT),     /* -- A? parmid parmid B */
+	EQ(2),                  /* -- A? parmid B? */
+	ROLL(2),                /* -- A? B? parmid */
+	DUP(1),                 /* -- A? B? parmid parmid */
+	PUSHN(VS_PARM_CAT),     /* -- A? B? parmid parmid C */
+	EQ(2),                  /* -- A? B? parmid C? */
+	ROLL(2),                /* -- A? B? C? parmid */
+	PUSHN(VS_PARM_DOG),     /* -- A? B? C? parmid D */
+	EQ(2),                  /* -- A? B? C? D? */
+	OR(4),                  /* -- animal? */
+	RETURN,
+
+
+	/* SCREEN_DIRECTION:
+	 * parmid -- direction?
+	 */
+	DUP(1),                 /* -- parmid parmid */
+	PUSHN(VS_PARM_NORTH),   /* -- parmid parmid N */
+	EQ(2),                  /* -- parmid N? */
+	ROLL(2),                /* -- N? parmid */
+	DUP(1),                 /* -- N? parmid parmid */
+	PUSHN(VS_PARM_SOUTH),   /* -- N? parmid parmid S */
+	EQ(2),                  /* -- N? parmid S? */
+	ROLL(2),                /* -- N? S? parmid */
+	DUP(1),                 /* -- N? S? parmid parmid */
+	PUSHN(VS_PARM_EAST),    /* -- N? S? parmid parmid E */
+	EQ(2),                  /* -- N? S? parmid E? */
+	ROLL(2),                /* -- N? S? E? parmid */
+	PUSHN(VS_PARM_WEST),    /* -- N? S? E? parmid W */
+	EQ(2),                  /* -- N? S? E? W? */
+	OR(4),                  /* -- direction? */
+	RETURN,
+#ifndef GRUNT_XMACRO_EXPAND
+};
+#endif
+
+#endif
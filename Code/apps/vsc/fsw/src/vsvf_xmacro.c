@@ -0,0 +1,70 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This file compiles VSC's Grunt validation program, vsvf.h or, in
+ * VSC_RULES_VF builds, vsvf_rules.h, into native code.  grunt_xmacro.h
+ * expands the program header's instructions into the body of
+ * vsvf_xmacro_run(), so the C compiler specializes Grunt's semantics
+ * to this one program when VSC builds, with no translator and no
+ * generated C to keep in step with the program.
+ *
+ */
+
+#include <string.h>
+
+#include "cfe.h"
+
+#include "vs_tablestruct.h"   /* for VS_PARM_* constants */
+#include "vs_parmclass.h"     /* for VS_PARM_CLASS_* constants */
+#include "vs_eventids.h"      /* for VS event ID constants */
+
+#include "grunt.h"
+#include "grunt_status.h"
+#ifdef VSC_RULES_VF
+#include "vsvf_rules.h"
+#define VSVF_XMACRO_PROGRAM "vsvf_rules.h"
+#else
+#include "vsvf.h"
+#define VSVF_XMACRO_PROGRAM "vsvf.h"
+#endif
+#include "grunt_xmacro.h"     /* must follow the program's first include */
+
+#include "vsvf_xmacro.h"
+
+
+/* vsvf_xmacro_run()
+ *
+ * in:     p_data    - the table image to validate
+ *         data_size - size of the image in bytes
+ * out:    nothing
+ * return: GRUNT_HALT_TRUE, GRUNT_HALT_FALSE, or a GRUNT_ERROR_*
+ *         status, as GRUNT_Run() would return for the same program.
+ *
+ * Runs VSC's validation program on the image.  It sends its output
+ * and reports its errors through the GRUNT_Native*() functions.
+ */
+
+int32
+vsvf_xmacro_run(const void *p_data, grunt_rep_t data_size) {
+
+	GRUNT_XMACRO_BEGIN(p_data, data_size,
+		vsvf_program, VSVF_NUM_INSTRUCTIONS,
+		vsvf_strings, VSVF_NUM_STRINGS);
+#define GRUNT_XMACRO_EXPAND
+#include VSVF_XMACRO_PROGRAM
+#undef GRUNT_XMACRO_EXPAND
+	GRUNT_XMACRO_END(VSVF_NUM_INSTRUCTIONS);
+
+} /* vsvf_xmacro_run() */
@@ -0,0 +1,25 @@
+#ifndef _VSVF_XMACRO_H_
+#define _VSVF_XMACRO_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* vsvf_xmacro.c compiles VSC's Grunt validation program into native
+ * code by expanding its instructions with grunt_xmacro.h.
+ */
+
+int32 vsvf_xmacro_run(const void *, grunt_rep_t);
+
+#endif
@@ -0,0 +1,274 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module implements the cFS stand-ins declared in stub/cfe.h.
+ * They do only what the benchmark needs: events are counted rather
+ * than sent, so formatting and I/O stay out of the measurements, and
+ * CFE_TBL_Register() keeps the validation function it's given so the
+ * benchmark can call VSA_table_validate() just as TBL would.  For
+ * vs_diff, events can also be captured, formatted, for comparison.
+ * There are no table files on the host, so OS_OpenCreate() fails.
+ * ES child tasks are POSIX threads, and OSAL semaphores are POSIX
+ * mutexes and semaphores, so VSA built with VSA_PARALLEL_VF runs its
+ * workers for real.
+ */
+
+#define _POSIX_C_SOURCE 200112L    /* for pthreads and semaphores */
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdarg.h>
+
+#include "cfe.h"
+
+#include "bench_stubs.h"
+
+uint32 bench_num_events = 0;
+CFE_TBL_CallbackFuncPtr_t bench_validate = NULL;
+bool bench_capture = false;
+bench_event_t bench_events[BENCH_MAX_EVENTS];
+
+/* Each OSAL semaphore ID is 1 + its index in the array of its kind.
+ * The bench creates only a few of each.
+ */
+#define BENCH_MAX_SEMS 8
+static pthread_mutex_t bench_mutexes[BENCH_MAX_SEMS];
+static sem_t bench_count_sems[BENCH_MAX_SEMS];
+static unsigned int bench_num_mutexes = 0;
+static unsigned int bench_num_count_sems = 0;
+
+
+CFE_Status_t
+CFE_EVS_SendEvent(uint16 event_id, uint16 event_type, const char *spec,
+	...) {
+
+	bench_event_t *p_event;
+	va_list args;
+
+	if (bench_capture && (bench_num_events < BENCH_MAX_EVENTS)) {
+		p_event = &(bench_events[bench_num_events]);
+		p_event->event_id   = event_id;
+		p_event->event_type = event_type;
+		va_start(args, spec);
+		vsnprintf(p_event->message, sizeof(p_event->message), spec,
+			args);
+		va_end(args);
+	}
+	bench_num_events++;
+	return CFE_SUCCESS;
+
+} /* CFE_EVS_SendEvent() */
+
+
+void
+CFE_ES_PerfLogEntry(uint32 marker) {
+	(void)marker;
+} /* CFE_ES_PerfLogEntry() */
+
+
+void
+CFE_ES_PerfLogExit(uint32 marker) {
+	(void)marker;
+} /* CFE_ES_PerfLogExit() */
+
+
+/* The VS apps time each validation for their housekeeping statistics;
+ * a clock that stands still keeps those clock reads out of the
+ * benchmark's own measurements.
+ */
+void
+CFE_PSP_GetTime(OS_time_t *p_time) {
+	p_time->ticks = 0;
+} /* CFE_PSP_GetTime() */
+
+
+int32
+CFE_ES_WriteToSysLog(const char *spec, ...) {
+
+	va_list args;
+
+	va_start(args, spec);
+	vfprintf(stderr, spec, args);
+	va_end(args);
+	return CFE_SUCCESS;
+
+} /* CFE_ES_WriteToSysLog() */
+
+
+/* bench_task_main()
+ *
+ * The POSIX thread main function that runs an ES child task's main
+ * function.
+ */
+static void *
+bench_task_main(void *p_arg) {
+
+	CFE_ES_ChildTaskMainFuncPtr_t main_func;
+
+	memcpy(&main_func, &p_arg, sizeof(main_func));
+	main_func();
+	return NULL;
+
+} /* bench_task_main() */
+
+
+CFE_Status_t
+CFE_ES_CreateChildTask(CFE_ES_TaskId_t *p_id, const char *name,
+	CFE_ES_ChildTaskMainFuncPtr_t main_func, void *p_stack,
+	size_t stack_size, uint16 priority, uint32 flags) {
+
+	static CFE_ES_TaskId_t next_id = 1;
+	pthread_t thread;
+	void *p_arg;
+
+	(void)name;
+	(void)p_stack;
+	(void)stack_size;
+	(void)priority;
+	(void)flags;
+	memcpy(&p_arg, &main_func, sizeof(p_arg));
+	if (pthread_create(&thread, NULL, bench_task_main, p_arg))
+		return -1;   /* CFE_ES_ERR_CHILD_TASK_CREATE */
+	pthread_detach(thread);
+	*p_id = next_id++;
+	return CFE_SUCCESS;
+
+} /* CFE_ES_CreateChildTask() */
+
+
+void
+CFE_ES_ExitChildTask(void) {
+	pthread_exit(NULL);
+} /* CFE_ES_ExitChildTask() */
+
+
+int32
+OS_MutSemCreate(osal_id_t *p_id, const char *name, uint32 options) {
+
+	(void)name;
+	(void)options;
+	if ((bench_num_mutexes >= BENCH_MAX_SEMS) ||
+		pthread_mutex_init(&(bench_mutexes[bench_num_mutexes]), NULL))
+		return -1;   /* OS_ERROR */
+	*p_id = ++bench_num_mutexes;
+	return OS_SUCCESS;
+
+} /* OS_MutSemCreate() */
+
+
+int32
+OS_MutSemTake(osal_id_t id) {
+	return pthread_mutex_lock(&(bench_mutexes[id - 1])) ? -1 : OS_SUCCESS;
+} /* OS_MutSemTake() */
+
+
+int32
+OS_MutSemGive(osal_id_t id) {
+	return pthread_mutex_unlock(&(bench_mutexes[id - 1])) ? -1 :
+		OS_SUCCESS;
+} /* OS_MutSemGive() */
+
+
+int32
+OS_CountSemCreate(osal_id_t *p_id, const char *name, uint32 initial,
+	uint32 options) {
+
+	(void)name;
+	(void)options;
+	if ((bench_num_count_sems >= BENCH_MAX_SEMS) ||
+		sem_init(&(bench_count_sems[bench_num_count_sems]), 0, initial))
+		return -1;   /* OS_ERROR */
+	*p_id = ++bench_num_count_sems;
+	return OS_SUCCESS;
+
+} /* OS_CountSemCreate() */
+
+
+int32
+OS_CountSemTake(osal_id_t id) {
+	return sem_wait(&(bench_count_sems[id - 1])) ? -1 : OS_SUCCESS;
+} /* OS_CountSemTake() */
+
+
+int32
+OS_CountSemGive(osal_id_t id) {
+	return sem_post(&(bench_count_sems[id - 1])) ? -1 : OS_SUCCESS;
+} /* OS_CountSemGive() */
+
+
+int32
+OS_OpenCreate(osal_id_t *p_id, const char *path, int32 flags,
+	int32 access) {
+
+	(void)p_id;
+	(void)path;
+	(void)flags;
+	(void)access;
+	return -1;   /* OS_ERROR */
+
+} /* OS_OpenCreate() */
+
+
+int32
+OS_read(osal_id_t id, void *p_buf, size_t len) {
+
+	(void)id;
+	(void)p_buf;
+	(void)len;
+	return -1;   /* OS_ERROR */
+
+} /* OS_read() */
+
+
+int32
+OS_close(osal_id_t id) {
+	(void)id;
+	return OS_SUCCESS;
+} /* OS_close() */
+
+
+int32
+CFE_FS_ReadHeader(CFE_FS_Header_t *p_hdr, osal_id_t id) {
+
+	(void)p_hdr;
+	(void)id;
+	return -1;   /* OS_ERROR */
+
+} /* CFE_FS_ReadHeader() */
+
+
+CFE_Status_t
+CFE_TBL_Register(CFE_TBL_Handle_t *p_handle, const char *name,
+	size_t size, uint16 options, CFE_TBL_CallbackFuncPtr_t validate) {
+
+	(void)name;
+	(void)size;
+	(void)options;
+	*p_handle = 0;
+	bench_validate = validate;
+	return CFE_SUCCESS;
+
+} /* CFE_TBL_Register() */
+
+
+CFE_Status_t
+CFE_TBL_Load(CFE_TBL_Handle_t handle, int source, const void *p_source) {
+
+	(void)handle;
+	(void)source;
+	(void)p_source;
+	return CFE_SUCCESS;
+
+} /* CFE_TBL_Load() */
@@ -0,0 +1,39 @@
+#ifndef _BENCH_STUBS_H_
+#define _BENCH_STUBS_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* What the cFS stand-ins in bench_stubs.c record for the benchmark. */
+
+#define BENCH_MAX_EVENTS 32   /* events captured per validation */
+
+typedef struct {
+	uint16 event_id;
+	uint16 event_type;
+	char   message[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH];
+} bench_event_t;
+
+extern uint32 bench_num_events;    /* events sent so far */
+extern CFE_TBL_CallbackFuncPtr_t bench_validate;  /* last registered */
+
+/* With bench_capture set, CFE_EVS_SendEvent() also records the first
+ * BENCH_MAX_EVENTS events it's given since bench_num_events was last
+ * zeroed.
+ */
+extern bool bench_capture;
+extern bench_event_t bench_events[BENCH_MAX_EVENTS];
+
+#endif
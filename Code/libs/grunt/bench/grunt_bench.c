@@ -0,0 +1,845 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* grunt_bench is a host-side micro-benchmark of the Grunt interpreter.
+ * It links the Grunt library, the VSA app's native validation
+ * function, the gruntaot translation of vsvf.h, and vsvf.h's
+ * grunt_xmacro.h expansion against the cFS stand-ins in stub/, and
+ * times each of them validating a corpus of valid and invalid table
+ * images, with no cFS, UDP, or perf log in the way.  For each engine
+ * it reports the time per validation and, for the Grunt engines, the
+ * Grunt instructions per validation and the cycles each instruction
+ * costs on average.  With --corpus FILE,
+ * it times the images of a corpus vs_corpus_gen wrote, in place,
+ * instead of its own, after checking the checked interpreter against
+ * the verdicts and events the corpus expects.  With --json FILE, it
+ * also times each pass over the images on its own and writes each
+ * engine's median, 99th percentile, and mean time per validation to
+ * FILE for vs_bench_compare.  Built with GRUNT_PROFILE and given
+ * --costs FILE, it writes the mean ticks the profile measured for
+ * each opcode to FILE as a gruntasm -c cost file, and given --pcs
+ * FILE, the executions of each program counter as a gruntasm -p
+ * layout profile.
+ *
+ * Usage: grunt_bench [--corpus FILE] [--json FILE] [--costs FILE]
+ *                    [--pcs FILE] [iterations]
+ */
+
+#define _POSIX_C_SOURCE 199309L    /* for clock_gettime() */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>             /* for __rdtsc() */
+#define BENCH_HAVE_TSC
+#endif
+
+#include "cfe.h"
+
+#include "vs_eventids.h"
+#include "vs_tablestruct.h"
+#include "vs_parmclass.h"
+#include "vsa_table.h"
+
+#include "grunt.h"
+#include "grunt_status.h"
+
+#include "vsvf_native.h"
+#include "vsvf_xmacro.h"
+#include "vsvf.h"
+
+#include "bench_stubs.h"
+#include "vs_bench_json.h"
+#include "vs_corpus.h"
+
+#define BENCH_DEFAULT_ITERATIONS 1000000UL
+
+/* The corpus: one image for each outcome the validation functions
+ * distinguish.
+ */
+#define UNUSED        { VS_PARM_UNUSED, { 0, 0, 0 }, 0, 0 }
+#define ANIMAL(p)     { (p), { 0, 0, 0 }, VS_PARM_ANIMAL_MIN, \
+			VS_PARM_ANIMAL_MAX }
+#define DIRECTION(p)  { (p), { 0, 0, 0 }, VS_PARM_DIRECTION_MIN, \
+			VS_PARM_DIRECTION_MAX }
+
+typedef struct {
+	const char *name;
+	vs_table_t  image;
+} bench_image_t;
+
+static const bench_image_t corpus[] = {
+	{ "all unused",          {{ UNUSED, UNUSED, UNUSED, UNUSED }} },
+	{ "four in use",         {{ ANIMAL(VS_PARM_APE), ANIMAL(VS_PARM_DOG),
+		DIRECTION(VS_PARM_NORTH), DIRECTION(VS_PARM_WEST) }} },
+	{ "two in use",          {{ ANIMAL(VS_PARM_BAT),
+		DIRECTION(VS_PARM_EAST), UNUSED, UNUSED }} },
+	{ "invalid parm ID",     {{ ANIMAL(VS_PARM_APE),
+		{ 0x03, { 0, 0, 0 }, VS_PARM_ANIMAL_MIN, VS_PARM_ANIMAL_MAX },
+		UNUSED, UNUSED }} },
+	{ "pad not zeroed",      {{
+		{ VS_PARM_CAT, { 0, 1, 0 }, VS_PARM_ANIMAL_MIN,
+			VS_PARM_ANIMAL_MAX },
+		UNUSED, UNUSED, UNUSED }} },
+	{ "low bound range",     {{
+		{ VS_PARM_SOUTH, { 0, 0, 0 }, VS_PARM_ANIMAL_MIN,
+			VS_PARM_DIRECTION_MAX },
+		UNUSED, UNUSED, UNUSED }} },
+	{ "bound order",         {{
+		{ VS_PARM_DOG, { 0, 0, 0 }, VS_PARM_ANIMAL_MAX,
+			VS_PARM_ANIMAL_MIN },
+		UNUSED, UNUSED, UNUSED }} },
+	{ "redefinition",        {{ ANIMAL(VS_PARM_APE), ANIMAL(VS_PARM_APE),
+		UNUSED, UNUSED }} },
+	{ "in use after unused", {{ UNUSED, ANIMAL(VS_PARM_BAT),
+		UNUSED, UNUSED }} },
+	{ "unused not zeroed",   {{ { VS_PARM_UNUSED, { 0, 0, 0 }, 1, 0 },
+		UNUSED, UNUSED, UNUSED }} },
+};
+#define BENCH_NUM_IMAGES (sizeof(corpus) / sizeof(corpus[0]))
+
+/* The images the benchmark runs: the corpus above, copied to
+ * builtin[], or with --corpus those of a corpus file, where they lie.
+ */
+static vs_table_t builtin[BENCH_NUM_IMAGES];
+static const vs_table_t *images = builtin;
+static uint32 num_images = BENCH_NUM_IMAGES;
+static vs_corpus_t file_corpus;
+static const vs_corpus_expect_t *expect = NULL;   /* with --corpus */
+
+/* Each engine validates one image and says whether it was valid. */
+typedef bool (*bench_run_t)(const vs_table_t *);
+
+static grunt_vm_t bench_vm;               /* too big for the stack */
+static grunt_packed_t bench_code[VSVF_NUM_INSTRUCTIONS];
+static grunt_number_t bench_pool[VSVF_NUM_INSTRUCTIONS];
+static grunt_packed_program_t bench_packed = {
+	bench_code, bench_pool, VSVF_NUM_INSTRUCTIONS, 0,
+	VSVF_NUM_INSTRUCTIONS, 0
+};
+static const grunt_prepared_t *bench_prepared = NULL;
+static volatile uint32 bench_sink;        /* keeps results live */
+
+/* With --json, each engine's result, and the time of each pass over
+ * the images as measure() times it.
+ */
+static const char *json_path = NULL;
+static vs_bench_result_t json_results[VS_BENCH_MAX_RESULTS];
+static int num_json_results = 0;
+static uint64 *pass_ns = NULL;
+
+static const char *costs_path = NULL;    /* with --costs */
+static const char *pcs_path = NULL;      /* with --pcs */
+
+
+/* -------------------------- engines ----------------------------- */
+
+static bool
+run_vsa(const vs_table_t *p_image) {
+	return (CFE_SUCCESS == bench_validate((void *)p_image));
+} /* run_vsa() */
+
+
+static bool
+run_native(const vs_table_t *p_image) {
+	return (GRUNT_HALT_TRUE == vsvf_native_run(p_image,
+		sizeof(*p_image)));
+} /* run_native() */
+
+
+static bool
+run_xmacro(const vs_table_t *p_image) {
+	return (GRUNT_HALT_TRUE == vsvf_xmacro_run(p_image,
+		sizeof(*p_image)));
+} /* run_xmacro() */
+
+
+static bool
+run_grunt(const vs_table_t *p_image) {
+	return (GRUNT_HALT_TRUE == GRUNT_RunCtx(&bench_vm, vsvf_program,
+		VSVF_NUM_INSTRUCTIONS, p_image, sizeof(*p_image),
+		vsvf_strings, VSVF_NUM_STRINGS));
+} /* run_grunt() */
+
+
+static bool
+run_packed(const vs_table_t *p_image) {
+	return (GRUNT_HALT_TRUE == GRUNT_RunPacked(&bench_packed, p_image,
+		sizeof(*p_image), vsvf_strings, VSVF_NUM_STRINGS));
+} /* run_packed() */
+
+
+static bool
+run_prepared(const vs_table_t *p_image) {
+	return (GRUNT_HALT_TRUE == GRUNT_RunPrepared(bench_prepared,
+		p_image, sizeof(*p_image)));
+} /* run_prepared() */
+
+
+/* ------------------------- measurement -------------------------- */
+
+static uint64
+now_ns(void) {
+
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64)ts.tv_sec * 1000000000ULL) + (uint64)ts.tv_nsec;
+
+} /* now_ns() */
+
+
+static uint64
+now_cycles(void) {
+#ifdef BENCH_HAVE_TSC
+	return (uint64)__rdtsc();
+#else
+	return 0;
+#endif
+} /* now_cycles() */
+
+
+/* compare_ns()
+ *
+ * qsort() comparison function for uint64 times.
+ */
+
+static int
+compare_ns(const void *p_a, const void *p_b) {
+
+	uint64 a = *(const uint64 *)p_a;
+	uint64 b = *(const uint64 *)p_b;
+
+	return ((a > b) - (a < b));
+
+} /* compare_ns() */
+
+
+/* record()
+ *
+ * in:     name   - engine name
+ *         rounds - passes over the images in pass_ns[]
+ * out:    pass_ns      - sorted
+ *         json_results - gain the engine's result
+ * return: nothing
+ *
+ * The percentiles are nearest-rank, over the passes, each divided by
+ * the number of images in a pass.
+ */
+
+static void
+record(const char *name, unsigned long rounds) {
+
+	vs_bench_result_t *p_result = &(json_results[num_json_results++]);
+	double total = 0.0;
+	unsigned long r;
+
+	qsort(pass_ns, rounds, sizeof(pass_ns[0]), compare_ns);
+	for (r = 0; r < rounds; r++) total += (double)pass_ns[r];
+
+	snprintf(p_result->name, sizeof(p_result->name), "grunt_bench.%s",
+		name);
+	snprintf(p_result->unit, sizeof(p_result->unit), "ns");
+	p_result->count = (uint32)(rounds * num_images);
+	p_result->p50   = (double)pass_ns[((rounds * 50 + 99) / 100) - 1] /
+		(double)num_images;
+	p_result->p99   = (double)pass_ns[((rounds * 99 + 99) / 100) - 1] /
+		(double)num_images;
+	p_result->mean  = total / (double)(rounds * num_images);
+
+} /* record() */
+
+
+/* image_name()
+ *
+ * in:     i - index of an image
+ * out:    nothing
+ * return: its name, for messages.
+ */
+
+static const char *
+image_name(uint32 i) {
+
+	static char name[32];
+
+	if (!expect) return corpus[i].name;
+	snprintf(name, sizeof(name), "corpus image %u", (unsigned)i);
+	return name;
+
+} /* image_name() */
+
+
+/* check_corpus()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: number of corpus file images on which the checked
+ *         interpreter departs from the verdict and events expected.
+ *
+ * check() holds every other Grunt engine to the checked interpreter,
+ * so this holds them all to the corpus.
+ */
+
+static int
+check_corpus(void) {
+
+	uint32 i, e;
+	bool valid;
+	int errors = 0;
+
+	bench_capture = true;
+	for (i = 0; i < num_images; i++) {
+		bench_num_events = 0;
+		valid = run_grunt(&(images[i]));
+		for (e = 0; (e < bench_num_events) &&
+			(e < VS_CORPUS_MAX_EVENTS) && (e < BENCH_MAX_EVENTS);
+			e++) {
+			if ((bench_events[e].event_id !=
+					expect[i].events[e].event_id) ||
+				(bench_events[e].event_type !=
+					expect[i].events[e].event_type))
+				break;
+		}
+		if ((valid != (bool)expect[i].valid) ||
+			(bench_num_events != expect[i].num_events) ||
+			((e < bench_num_events) && (e < VS_CORPUS_MAX_EVENTS) &&
+			(e < BENCH_MAX_EVENTS))) {
+			fprintf(stderr, "checked departs from the corpus on "
+				"%s\n", image_name(i));
+			errors++;
+		}
+	}
+	bench_capture = false;
+	return errors;
+
+} /* check_corpus() */
+
+
+/* check()
+ *
+ * in:     name - engine name, for messages
+ *         run  - engine to check
+ * out:    nothing
+ * return: number of images on which the engine disagrees with the
+ *         checked interpreter.
+ *
+ * Before timing an engine, makes sure it reaches the same verdict and
+ * sends the same number of events as the checked interpreter running
+ * vsvf_program[] on every image, so the benchmark never times a broken
+ * engine.  VSA's validation function is not checked: it is the
+ * hand-written baseline, flaws and all.
+ */
+
+static int
+check(const char *name, bench_run_t run) {
+
+	unsigned int i;
+	uint32 events;          /* events the checked interpreter sent */
+	bool valid;             /* checked interpreter's verdict */
+	int errors = 0;
+
+	for (i = 0; i < num_images; i++) {
+		bench_num_events = 0;
+		valid  = run_grunt(&(images[i]));
+		events = bench_num_events;
+		bench_num_events = 0;
+		if ((run(&(images[i])) != valid) ||
+			(bench_num_events != events)) {
+			fprintf(stderr, "%s disagrees with checked on "
+				"image \"%s\"\n", name, image_name(i));
+			errors++;
+		}
+	}
+	return errors;
+
+} /* check() */
+
+
+/* measure()
+ *
+ * in:     name         - engine name, for the report
+ *         run          - engine to time
+ *         iterations   - number of validations to time
+ *         instructions - Grunt instructions per validation, or 0 for
+ *                        engines that don't run Grunt instructions
+ * out:    nothing
+ * return: nothing
+ *
+ * Times iterations validations, cycling through the corpus, and
+ * prints one line of the report.  With --json, also times each pass
+ * on its own and records the engine's result.
+ */
+
+static void
+measure(const char *name, bench_run_t run, unsigned long iterations,
+	double instructions) {
+
+	unsigned long rounds = (iterations + num_images - 1) / num_images;
+	unsigned long r;
+	unsigned int i;
+	uint64 start_ns, stop_ns, start_cycles, stop_cycles;
+	uint32 valid = 0;
+	double validations = (double)rounds * (double)num_images;
+	double ns, cycles;
+
+	/* Warm the caches and the threaded engine's handler table. */
+	for (i = 0; i < num_images; i++) valid += run(&(images[i]));
+
+	start_ns     = now_ns();
+	start_cycles = now_cycles();
+	for (r = 0; r < rounds; r++) {
+		if (pass_ns) pass_ns[r] = now_ns();
+		for (i = 0; i < num_images; i++)
+			valid += run(&(images[i]));
+		if (pass_ns) pass_ns[r] = now_ns() - pass_ns[r];
+	}
+	stop_cycles = now_cycles();
+	stop_ns     = now_ns();
+	bench_sink  = valid;
+
+	ns     = (double)(stop_ns - start_ns) / validations;
+	cycles = (double)(stop_cycles - start_cycles) / validations;
+
+	printf("%-10s %14.1f", name, ns);
+	if (instructions > 0) {
+		printf(" %16.1f", instructions);
+	} else {
+		printf(" %16s", "-");
+	}
+#ifdef BENCH_HAVE_TSC
+	printf(" %17.0f", cycles);
+	if (instructions > 0) {
+		printf(" %12.2f\n", cycles / instructions);
+	} else {
+		printf(" %12s\n", "-");
+	}
+#else
+	(void)cycles;
+	printf(" %17s %12s\n", "-", "-");
+#endif
+
+	if (pass_ns) record(name, rounds);
+
+} /* measure() */
+
+
+/* count_instructions()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: average Grunt instructions per validation over the corpus,
+ *         or 0 if the library doesn't count them.
+ *
+ * Prints each built-in image's verdict, event count, and instruction
+ * count, and VSA's verdict for comparison; a corpus file's images are
+ * too many to list.  Must run before GRUNT_Verify(), since only the
+ * checked engines count.
+ */
+
+static double
+count_instructions(void) {
+
+	unsigned int i;
+	uint32 count;
+	uint32 total = 0;
+	bool valid;
+
+	if (!expect) {
+		printf("%-20s %7s %7s %13s %7s\n", "image", "valid",
+			"events", "instructions", "vsa");
+	}
+	for (i = 0; i < num_images; i++) {
+		bench_num_events = 0;
+		valid = run_grunt(&(images[i]));
+#ifdef GRUNT_COUNT_INSTRUCTIONS
+		count = GRUNT_GetInstructionCount(&bench_vm);
+#else
+		count = 0;
+#endif
+		total += count;
+		if (expect) continue;
+		printf("%-20s %7s %7u %13u", corpus[i].name,
+			(valid ? "yes" : "no"), (unsigned)bench_num_events,
+			(unsigned)count);
+		printf(" %7s\n", (run_vsa(&(images[i])) ? "yes" : "no"));
+	}
+	if (!expect) printf("\n");
+	return (double)total / (double)num_images;
+
+} /* count_instructions() */
+
+
+#if defined(GRUNT_PROFILE) || defined(GRUNT_TRACE)
+
+static const char *op_names[] = {
+	[GRUNT_OP_ADD]    = "ADD",    [GRUNT_OP_AND]      = "AND",
+	[GRUNT_OP_CALL]   = "CALL",   [GRUNT_OP_DUP]      = "DUP",
+	[GRUNT_OP_EQ]     = "EQ",     [GRUNT_OP_FLUSH]    = "FLUSH",
+	[GRUNT_OP_GT]     = "GT",     [GRUNT_OP_HALT]     = "HALT",
+	[GRUNT_OP_JMPIF]  = "JMPIF",  [GRUNT_OP_LT]       = "LT",
+	[GRUNT_OP_NOT]    = "NOT",    [GRUNT_OP_OR]       = "OR",
+	[GRUNT_OP_OUTPUT] = "OUTPUT", [GRUNT_OP_POP]      = "POP",
+	[GRUNT_OP_PUSHB]  = "PUSHB",  [GRUNT_OP_PUSHN]    = "PUSHN",
+	[GRUNT_OP_PUSHS]  = "PUSHS",  [GRUNT_OP_INPUT]    = "INPUT",
+	[GRUNT_OP_RETURN] = "RETURN", [GRUNT_OP_REWIND]   = "REWIND",
+	[GRUNT_OP_ROLL]   = "ROLL",   [GRUNT_OP_SUB]      = "SUB",
+	[GRUNT_OP_EQN]    = "EQN",    [GRUNT_OP_DUPEQN]   = "DUPEQN",
+	[GRUNT_OP_NOTJMPIF] = "NOTJMPIF",
+	[GRUNT_OP_INPUTLTN] = "INPUTLTN",
+	[GRUNT_OP_INPUTGTN] = "INPUTGTN",
+	[GRUNT_OP_LOOKUP]   = "LOOKUP",
+	[GRUNT_OP_SWITCH]   = "SWITCH",
+	[GRUNT_OP_REPEAT]   = "REPEAT",
+	[GRUNT_OP_END]      = "END",
+	[GRUNT_OP_INPUTREC] = "INPUTREC",
+	[GRUNT_OP_INPUTZ]   = "INPUTZ",
+	[GRUNT_OP_FORMAT]   = "FORMAT",
+	[GRUNT_OP_CLASSIFY] = "CLASSIFY",
+};
+
+#define BENCH_NUM_OP_NAMES (sizeof(op_names) / sizeof(op_names[0]))
+#define BENCH_OP_NAME(op) ((((op) < BENCH_NUM_OP_NAMES) && op_names[op]) \
+	? op_names[op] : "?")
+
+#endif /* GRUNT_PROFILE || GRUNT_TRACE */
+
+
+#ifdef GRUNT_PROFILE
+
+#define BENCH_PROFILE_VALIDATIONS 10000   /* at least, to profile */
+
+
+/* write_pcs()
+ *
+ * in:     path      - name of the layout profile to write
+ *         p_profile - profile of vsvf_program[] over the corpus
+ * out:    nothing
+ * return: 0 on success, else -1.
+ *
+ * Writes the gruntasm -p layout profile: a line giving the program's
+ * instruction count and the FNV-1a hash of its opcodes, by which
+ * gruntasm checks the profile against the source it assembles, and
+ * the number of runs profiled, followed by the executions of each pc
+ * that ran.
+ */
+
+static int
+write_pcs(const char *path, const grunt_profile_t *p_profile) {
+
+	uint32 hash = 2166136261u;    /* FNV-1a offset basis */
+	grunt_pc_t pc;
+	FILE *out;
+
+	if (!(out = fopen(path, "w"))) {
+		perror(path);
+		return -1;
+	}
+	for (pc = 0; pc < VSVF_NUM_INSTRUCTIONS; pc++)
+		hash = (hash ^ (uint32)vsvf_program[pc].op) * 16777619u;
+
+	fprintf(out, "; Executions of each pc of vsvf_program[] on the "
+		"checked interpreter,\n; measured by grunt_bench --pcs over "
+		"%u images.\n", (unsigned)num_images);
+	fprintf(out, "program %u 0x%08X %lu\n",
+		(unsigned)VSVF_NUM_INSTRUCTIONS, (unsigned)hash,
+		(unsigned long)p_profile->runs);
+	for (pc = 0; (pc < VSVF_NUM_INSTRUCTIONS) &&
+		(pc < GRUNT_PROFILE_MAX_PC); pc++) {
+		if (p_profile->pc_count[pc]) {
+			fprintf(out, "%u %lu\n", (unsigned)pc,
+				(unsigned long)p_profile->pc_count[pc]);
+		}
+	}
+	if (fclose(out)) {
+		perror(path);
+		return -1;
+	}
+	return 0;
+
+} /* write_pcs() */
+
+
+/* print_profile()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: nothing
+ *
+ * Profiles as many whole passes over the corpus as make at least
+ * BENCH_PROFILE_VALIDATIONS validations on the checked interpreter
+ * and prints, for each opcode that ran, its executions
+ * per validation, its share of all executions, and the mean ticks of
+ * its sampled executions, followed by the tick histogram.  With
+ * --costs, also writes each sampled opcode's mean ticks, rounded up,
+ * to the cost file.  With --pcs, also writes the layout profile.
+ */
+
+static int
+print_profile(void) {
+
+	const grunt_profile_t *p_profile = GRUNT_GetProfile(&bench_vm);
+	unsigned int rounds = (BENCH_PROFILE_VALIDATIONS + num_images - 1) /
+		num_images;
+	unsigned int r, i, op, b;
+	FILE *costs = NULL;
+
+	if (costs_path && !(costs = fopen(costs_path, "w"))) {
+		perror(costs_path);
+		return -1;
+	}
+	if (costs) {
+		fprintf(costs, "; Mean ticks of each Grunt opcode on the "
+			"checked interpreter,\n; measured by grunt_bench "
+			"--costs over %u images.\n",
+			(unsigned)num_images);
+	}
+
+	GRUNT_ResetProfile(&bench_vm);
+	for (r = 0; r < rounds; r++) {
+		for (i = 0; i < num_images; i++)
+			bench_sink = run_grunt(&(images[i]));
+	}
+
+	printf("%-10s %11s %7s %11s\n", "opcode", "per valid.", "share",
+		"mean ticks");
+	for (op = 0; op < GRUNT_PROFILE_NUM_OPCODES; op++) {
+		if (!p_profile->op_count[op]) continue;
+		printf("%-10s %11.1f %6.1f%%", BENCH_OP_NAME(op),
+			(double)p_profile->op_count[op] /
+			(double)p_profile->runs, 100.0 *
+			(double)p_profile->op_count[op] /
+			(double)p_profile->instructions);
+		if (p_profile->op_samples[op]) {
+			printf(" %11.1f\n", (double)p_profile->op_ticks[op] /
+				(double)p_profile->op_samples[op]);
+			if (costs) {
+				fprintf(costs, "%-10s %lu\n",
+					BENCH_OP_NAME(op), (unsigned long)
+					((p_profile->op_ticks[op] +
+					p_profile->op_samples[op] - 1) /
+					p_profile->op_samples[op]));
+			}
+		} else {
+			printf(" %11s\n", "-");
+		}
+	}
+	printf("\n%-10s %11s\n", "ticks", "samples");
+	for (b = 0; b < GRUNT_PROFILE_NUM_BUCKETS; b++) {
+		if (!p_profile->histogram[b]) continue;
+		printf("%-10lu %11u\n", (1UL << b),
+			(unsigned)p_profile->histogram[b]);
+	}
+	printf("\n");
+
+	if (costs && fclose(costs)) {
+		perror(costs_path);
+		return -1;
+	}
+	return (pcs_path ? write_pcs(pcs_path, p_profile) : 0);
+
+} /* print_profile() */
+
+#endif /* GRUNT_PROFILE */
+
+
+#ifdef GRUNT_TRACE
+
+/* print_trace()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: nothing
+ *
+ * Validates the last image on the checked interpreter and prints the
+ * steps the VM's trace kept of it, oldest first, as a replay of a
+ * VSC trace dump would show them.
+ */
+
+static void
+print_trace(void) {
+
+	static const char *type_names[] = { "bool", "num", "str", "pc" };
+	const grunt_trace_t *p_trace = GRUNT_GetTrace(&bench_vm);
+	const grunt_trace_step_t *p_step;
+	uint32 first, n;
+
+	GRUNT_ResetTrace(&bench_vm);
+	bench_sink = run_grunt(&(images[num_images - 1]));
+
+	first = ((p_trace->steps > GRUNT_TRACE_SIZE) ?
+		(p_trace->steps - GRUNT_TRACE_SIZE) : 0);
+	printf("last %u of %u steps validating image %u\n",
+		(unsigned)(p_trace->steps - first), (unsigned)p_trace->steps,
+		(unsigned)(num_images - 1));
+	printf("%6s %-10s %s\n", "pc", "opcode", "top");
+	for (n = first; n < p_trace->steps; n++) {
+		p_step = &(p_trace->ring[n & (GRUNT_TRACE_SIZE - 1)]);
+		if (p_step->type == GRUNT_TRACE_END) {
+			printf("%6u %-10s 0x%08X\n", (unsigned)p_step->pc,
+				"(end)", (unsigned)p_step->top);
+		} else if (p_step->type == GRUNT_TRACE_EMPTY) {
+			printf("%6u %-10s -\n", (unsigned)p_step->pc,
+				BENCH_OP_NAME(p_step->op));
+		} else {
+			printf("%6u %-10s %s %u\n", (unsigned)p_step->pc,
+				BENCH_OP_NAME(p_step->op),
+				((p_step->type < 4) ?
+				type_names[p_step->type] : "?"),
+				(unsigned)p_step->top);
+		}
+	}
+	printf("\n");
+
+} /* print_trace() */
+
+#endif /* GRUNT_TRACE */
+
+
+int
+main(int argc, char *argv[]) {
+
+	CFE_TBL_Handle_t handle;
+	grunt_record_view_t view = { VSVF_RECORD_OFFSET, VSVF_RECORD_SIZE };
+	unsigned long iterations = BENCH_DEFAULT_ITERATIONS;
+	double instructions;
+	int errors = 0;
+	int arg;                     /* of iteration count, if any */
+	const char *corpus_path = NULL;
+	uint32 i;
+
+	for (arg = 1; (arg + 1) < argc; arg += 2) {
+		if (!strcmp(argv[arg], "--corpus")) {
+			corpus_path = argv[arg + 1];
+		} else if (!strcmp(argv[arg], "--json")) {
+			json_path = argv[arg + 1];
+		} else if (!strcmp(argv[arg], "--costs")) {
+			costs_path = argv[arg + 1];
+		} else if (!strcmp(argv[arg], "--pcs")) {
+			pcs_path = argv[arg + 1];
+		} else {
+			break;
+		}
+	}
+	if (argc > arg + 1) {
+		fprintf(stderr, "Usage:\n\tgrunt_bench [--corpus FILE] "
+			"[--json FILE] [--costs FILE] [--pcs FILE] "
+			"[iterations]\n");
+		return -1;
+	}
+#ifndef GRUNT_PROFILE
+	if (costs_path || pcs_path) {
+		fprintf(stderr, "grunt_bench: --costs and --pcs need a build "
+			"with GRUNT_PROFILE\n");
+		return -1;
+	}
+#endif
+	if ((argc == arg + 1) &&
+		!(iterations = strtoul(argv[arg], NULL, 10))) {
+		fprintf(stderr, "grunt_bench: bad iteration count %s\n",
+			argv[arg]);
+		return -1;
+	}
+
+	if (!corpus_path) {
+		for (i = 0; i < BENCH_NUM_IMAGES; i++)
+			builtin[i] = corpus[i].image;
+	} else if (vs_corpus_map(corpus_path, &file_corpus)) {
+		return -1;
+	} else if (!file_corpus.num_images) {
+		fprintf(stderr, "grunt_bench: %s has no images\n",
+			corpus_path);
+		return -1;
+	} else {
+		images     = file_corpus.images;
+		expect     = file_corpus.expect;
+		num_images = file_corpus.num_images;
+	}
+
+	if (json_path && (NULL == (pass_ns = malloc(((iterations +
+		num_images - 1) / num_images) * sizeof(pass_ns[0]))))) {
+		perror("grunt_bench: no memory for pass times");
+		return -1;
+	}
+
+	/* Set up each engine as its app would. */
+	if ((CFE_SUCCESS != VSA_table_init(&handle)) || !bench_validate) {
+		fprintf(stderr, "grunt_bench: VSA_table_init() failed\n");
+		return -1;
+	}
+	GRUNT_Init();
+	GRUNT_InitCtx(&bench_vm);
+	GRUNT_SetRecordView(&bench_vm, &view);
+	GRUNT_SetStringLengths(NULL, vsvf_strings, vsvf_string_lengths);
+	GRUNT_SetStringLengths(&bench_vm, vsvf_strings, vsvf_string_lengths);
+	if (CFE_SUCCESS != GRUNT_Pack(vsvf_program, VSVF_NUM_INSTRUCTIONS,
+		&bench_packed)) {
+		fprintf(stderr, "grunt_bench: GRUNT_Pack() failed\n");
+		return -1;
+	}
+
+	instructions = count_instructions();
+#ifdef GRUNT_PROFILE
+	if (print_profile()) return -1;
+#endif
+#ifdef GRUNT_TRACE
+	print_trace();
+#endif
+	if (expect) errors += check_corpus();
+	errors += check("aot", run_native);
+	errors += check("xmacro", run_xmacro);
+	errors += check("packed", run_packed);
+	if (errors) return -1;
+
+	printf("%lu validations per engine over %u images\n", iterations,
+		(unsigned)num_images);
+	printf("%-10s %14s %16s %17s %12s\n", "engine", "ns/validation",
+		"instr/validation", "cycles/validation", "cycles/instr");
+	measure("vsa", run_vsa, iterations, 0);
+	measure("aot", run_native, iterations, 0);
+	measure("xmacro", run_xmacro, iterations, 0);
+	measure("checked", run_grunt, iterations, instructions);
+	measure("packed", run_packed, iterations, instructions);
+
+	/* From here on, GRUNT_RunCtx() runs vsvf_program[] on the
+	 * verified engines.
+	 */
+	if (CFE_SUCCESS != GRUNT_Verify(vsvf_program, VSVF_NUM_INSTRUCTIONS,
+		VSVF_NUM_STRINGS)) {
+		fprintf(stderr, "grunt_bench: GRUNT_Verify() failed\n");
+		return -1;
+	}
+	if (check("verified", run_grunt)) return -1;
+	measure("verified", run_grunt, iterations, instructions);
+
+	/* The prepared program is the optimized one, so it runs fewer
+	 * instructions than count_instructions() counted.
+	 */
+	if (CFE_SUCCESS != GRUNT_Prepare(vsvf_program, VSVF_NUM_INSTRUCTIONS,
+		vsvf_strings, VSVF_NUM_STRINGS, GRUNT_PREPARE_OPTIMIZE,
+		&bench_prepared)) {
+		fprintf(stderr, "grunt_bench: GRUNT_Prepare() failed\n");
+		return -1;
+	}
+	if (check("prepared", run_prepared)) return -1;
+	measure("prepared", run_prepared, iterations, 0);
+
+	if (json_path && vs_bench_write(json_path, json_results,
+		num_json_results))
+		return -1;
+	return 0;
+
+} /* main() */
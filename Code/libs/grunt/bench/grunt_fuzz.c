@@ -0,0 +1,528 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* grunt_fuzz is a differential fuzzing target for the Grunt library.
+ * It decodes each input it is given into a Grunt program, a record
+ * view, and an input image, runs the program on the checked switch
+ * engine, and checks that every other engine the build has reaches
+ * the same status with the same events: the threaded engine, the
+ * checked packed engine GRUNT_RunPacked() uses, and, if GRUNT_Verify()
+ * accepts the program, the verified engines and the JIT.  The
+ * program GRUNT_Optimize() makes of a verified program must reach the
+ * same status too, and, if the original halted, flush the same
+ * events.  On a divergence it prints the program and both results
+ * and aborts, so the fuzzer keeps the input.
+ *
+ * Built with GRUNT_FUZZ_LIBFUZZER, it is a libFuzzer target.
+ * Otherwise it runs each FILE it is given, or its standard input, as
+ * one input, as AFL and crash replays want, or with --random N, N
+ * inputs of its own.
+ *
+ * Usage: grunt_fuzz [FILE...]
+ *        grunt_fuzz --random N [SEED]
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cfe.h"
+
+#include "grunt.h"
+#include "grunt_status.h"
+#include "vs_parmclass.h"
+
+#include "bench_stubs.h"
+
+/* The input encoding: a byte giving the number of instructions, a
+ * byte giving the record view, 4 bytes for each instruction, and
+ * then the input image.  Each instruction's first byte picks its
+ * opcode, its second its flags, and its last two its argument.
+ * Opcodes past GRUNT_OP_CLASSIFY and the superinstructions, which only
+ * packed code may hold, exercise the engines' rejection of invalid
+ * opcodes.
+ */
+#define FUZZ_MAX_INSTRUCTIONS 48
+#define FUZZ_MAX_IMAGE        64
+#define FUZZ_MAX_REPEATS      3      /* loops per program, to bound runs */
+#define FUZZ_MAX_EVENTS       16     /* events kept per result */
+#define FUZZ_NUM_OPCODES      (GRUNT_OP_CLASSIFY + 2)
+#define FUZZ_FLAG_WIDE        0x40   /* argument takes all 16 bits */
+#define FUZZ_FLAG_BADTYPE     0x80   /* literal takes type from flags */
+
+static const char *fuzz_strings[] = {
+	"",
+	"%",
+	"% of %",
+	"%%%%",
+	"a message long enough that a few OUTPUTs of it fill the "
+		"output queue past its end",
+	/* CLASSIFY's names, the last of them at string 14. */
+	"Invalid", "Unused", "Ape", "Bat", "Cat", "Dog",
+	"North", "South", "East", "West",
+};
+#define FUZZ_NUM_STRINGS \
+	((grunt_string_t)(sizeof(fuzz_strings) / sizeof(fuzz_strings[0])))
+
+typedef struct {
+	grunt_number_t type;
+	grunt_number_t id;
+	char           message[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH];
+} fuzz_event_t;
+
+typedef struct {
+	int32        status;
+	uint32       num_events;              /* all events flushed */
+	fuzz_event_t events[FUZZ_MAX_EVENTS]; /* the first of them */
+} fuzz_result_t;
+
+static grunt_instruction_t program[FUZZ_MAX_INSTRUCTIONS];
+static grunt_pc_t num_instructions;
+static grunt_record_view_t view;
+static uint8 image[FUZZ_MAX_IMAGE];
+static grunt_rep_t image_size;
+
+static grunt_vm_t fuzz_vm;
+static fuzz_result_t *p_sunk;   /* result the sink fills */
+
+
+/* sink()
+ *
+ * in:     arg     - unused
+ *         type    - event type
+ *         id      - event ID
+ *         message - flushed message
+ * out:    *p_sunk - event counted, and kept if there is room
+ * return: nothing
+ */
+
+static void
+sink(void *arg, grunt_number_t type, grunt_number_t id,
+	const char *message) {
+
+	fuzz_event_t *p_event;
+
+	(void)arg;
+	if (p_sunk->num_events < FUZZ_MAX_EVENTS) {
+		p_event = &(p_sunk->events[p_sunk->num_events]);
+		p_event->type = type;
+		p_event->id   = id;
+		strncpy(p_event->message, message,
+			sizeof(p_event->message) - 1);
+		p_event->message[sizeof(p_event->message) - 1] = '\0';
+	}
+	p_sunk->num_events++;
+
+} /* sink() */
+
+
+/* decode()
+ *
+ * in:     data - fuzzer input
+ *         size - bytes of data
+ * out:    program, num_instructions, view, image, image_size
+ * return: nothing
+ *
+ * Every input decodes to something, so the fuzzer never wastes its
+ * mutations on inputs the target throws away.
+ */
+
+static void
+decode(const uint8 *data, size_t size) {
+
+	const uint8 *p;
+	grunt_instruction_t *p_i;
+	grunt_pc_t pc;
+	size_t header;           /* header bytes present */
+	unsigned int repeats = 0;
+	uint8 flags;
+	uint16 arg;
+
+	memset(program, 0, sizeof(program));
+	header = ((size < 2) ? size : 2);
+	num_instructions = ((size < 2) ? 0 :
+		(data[0] % (FUZZ_MAX_INSTRUCTIONS + 1)));
+	if (num_instructions > ((size - header) / 4))
+		num_instructions = (grunt_pc_t)((size - header) / 4);
+	view.offset = ((size < 2) ? 0 : (data[1] & 0x0F));
+	view.size   = ((size < 2) ? 0 : (data[1] >> 4));
+
+	for (pc = 0; pc < num_instructions; pc++) {
+		p     = &(data[2 + (4 * pc)]);
+		p_i   = &(program[pc]);
+		flags = p[1];
+		arg   = (uint16)(p[2] | (p[3] << 8));
+
+		p_i->op = (grunt_opcode_t)(p[0] % FUZZ_NUM_OPCODES);
+		switch (p_i->op) {
+		case GRUNT_OP_PUSHB:
+			p_i->arg.lit.type  = gt_bool;
+			p_i->arg.lit.val.b = (arg & 1);
+			break;
+		case GRUNT_OP_PUSHN:
+			p_i->arg.lit.type    = gt_num;
+			p_i->arg.lit.val.num = ((flags & FUZZ_FLAG_WIDE) ?
+				((grunt_number_t)arg << 16) | arg : arg);
+			break;
+		case GRUNT_OP_PUSHS:
+			p_i->arg.lit.type    = gt_str;
+			p_i->arg.lit.val.str = ((flags & FUZZ_FLAG_WIDE) ?
+				arg : (arg % (FUZZ_NUM_STRINGS + 1)));
+			break;
+		case GRUNT_OP_CALL:
+			/* fall through */
+		case GRUNT_OP_JMPIF:
+			p_i->arg.lit.type   = gt_pc;
+			p_i->arg.lit.val.pc = ((flags & FUZZ_FLAG_WIDE) ?
+				arg : (arg % (num_instructions + 1)));
+			break;
+		case GRUNT_OP_CLASSIFY:
+			/* Mostly name runs that fit the table, some that
+			 * run one past its end.
+			 */
+			p_i->arg.rep = ((flags & FUZZ_FLAG_WIDE) ? arg :
+				(arg % (FUZZ_NUM_STRINGS -
+				VS_PARM_NUM_NAMES + 2)));
+			break;
+		case GRUNT_OP_REPEAT:
+			/* Nested loops multiply; bound the run time. */
+			if (repeats++ < FUZZ_MAX_REPEATS) {
+				p_i->arg.rep = (arg % 16);
+			} else {
+				p_i->op = GRUNT_OP_END;
+			}
+			break;
+		default:
+			p_i->arg.rep = ((flags & FUZZ_FLAG_WIDE) ? arg :
+				(arg % 8));
+		}
+		if ((flags & FUZZ_FLAG_BADTYPE) && ((p_i->op == GRUNT_OP_PUSHB)
+			|| (p_i->op == GRUNT_OP_PUSHN) ||
+			(p_i->op == GRUNT_OP_PUSHS) ||
+			(p_i->op == GRUNT_OP_CALL) ||
+			(p_i->op == GRUNT_OP_JMPIF))) {
+			p_i->arg.lit.type = (grunt_value_type_t)(flags & 0x07);
+			if (p_i->arg.lit.type == gt_bool) {
+				p_i->arg.lit.val.num = 0;  /* a valid bool */
+				p_i->arg.lit.val.b   = (arg & 1);
+			}
+		}
+	}
+
+	p = &(data[header + (4 * (size_t)num_instructions)]);
+	image_size = (grunt_rep_t)((size - (size_t)(p - data)) <
+		FUZZ_MAX_IMAGE ? (size - (size_t)(p - data)) : FUZZ_MAX_IMAGE);
+	memcpy(image, p, image_size);
+
+} /* decode() */
+
+
+/* run()
+ *
+ * in:     code   - program to run
+ *         count  - instructions in code
+ *         engine - engine to pin a fresh VM to
+ * out:    *p_r   - the run's status and events
+ * return: nothing
+ */
+
+static void
+run(const grunt_instruction_t *code, grunt_pc_t count,
+	grunt_engine_t engine, fuzz_result_t *p_r) {
+
+	GRUNT_InitCtx(&fuzz_vm);  /* forgets the threaded engine's table */
+	GRUNT_SetEventSink(&fuzz_vm, sink, NULL);
+	GRUNT_SetRecordView(&fuzz_vm, &view);
+	GRUNT_SetEngine(&fuzz_vm, engine);
+
+	p_sunk = p_r;
+	p_r->num_events = 0;
+	p_r->status = GRUNT_RunCtx(&fuzz_vm, code, count, image,
+		image_size, fuzz_strings, FUZZ_NUM_STRINGS);
+
+} /* run() */
+
+
+/* same()
+ *
+ * in:     p_a, p_b - two results for the same input
+ *         events   - whether the events must match too
+ * out:    nothing
+ * return: true if the results match
+ */
+
+static bool
+same(const fuzz_result_t *p_a, const fuzz_result_t *p_b, bool events) {
+
+	uint32 i;
+
+	if (p_a->status != p_b->status) return false;
+	if (!events) return true;
+	if (p_a->num_events != p_b->num_events) return false;
+	for (i = 0; (i < p_a->num_events) && (i < FUZZ_MAX_EVENTS); i++) {
+		if ((p_a->events[i].type != p_b->events[i].type) ||
+			(p_a->events[i].id != p_b->events[i].id) ||
+			strcmp(p_a->events[i].message,
+				p_b->events[i].message))
+			return false;
+	}
+	return true;
+
+} /* same() */
+
+
+/* print_result()
+ *
+ * in:     name - engine that produced p_r
+ *         p_r  - result to print
+ * out:    the result, on stderr
+ * return: nothing
+ */
+
+static void
+print_result(const char *name, const fuzz_result_t *p_r) {
+
+	uint32 i;
+
+	fprintf(stderr, "  %s: status 0x%02x, %u events\n", name,
+		(unsigned)p_r->status, (unsigned)p_r->num_events);
+	for (i = 0; (i < p_r->num_events) && (i < FUZZ_MAX_EVENTS); i++)
+		fprintf(stderr, "    type %u id %u \"%s\"\n",
+			(unsigned)p_r->events[i].type,
+			(unsigned)p_r->events[i].id, p_r->events[i].message);
+
+} /* print_result() */
+
+
+/* diverged()
+ *
+ * in:     name   - engine that diverged
+ *         p_ref  - the switch engine's result
+ *         p_r    - the diverging engine's result
+ * out:    the program, its input, and both results, on stderr
+ * return: never; aborts
+ */
+
+static void
+diverged(const char *name, const fuzz_result_t *p_ref,
+	const fuzz_result_t *p_r) {
+
+	const grunt_instruction_t *p_i;
+	grunt_pc_t pc;
+	grunt_rep_t i;
+
+	fprintf(stderr, "grunt_fuzz: %s diverged from the switch engine "
+		"on this %u-instruction program:\n", name,
+		(unsigned)num_instructions);
+	for (pc = 0; pc < num_instructions; pc++) {
+		p_i = &(program[pc]);
+		fprintf(stderr, "  %3u: op 0x%02x rep %5u type %d val %u\n",
+			(unsigned)pc, (unsigned)p_i->op,
+			(unsigned)p_i->arg.rep, (int)p_i->arg.lit.type,
+			(unsigned)p_i->arg.lit.val.num);
+	}
+	fprintf(stderr, "  record view %u+%u, %u-byte image:",
+		(unsigned)view.offset, (unsigned)view.size,
+		(unsigned)image_size);
+	for (i = 0; i < image_size; i++)
+		fprintf(stderr, " %02x", image[i]);
+	fprintf(stderr, "\n");
+	print_result("switch", p_ref);
+	print_result(name, p_r);
+	abort();
+
+} /* diverged() */
+
+
+/* fuzz_one()
+ *
+ * in:     data - fuzzer input
+ *         size - bytes of data
+ * out:    nothing
+ * return: nothing; aborts if the engines diverge
+ */
+
+static void
+fuzz_one(const uint8 *data, size_t size) {
+
+	static bool initialized = false;
+	static grunt_packed_t packed_code[FUZZ_MAX_INSTRUCTIONS];
+	static grunt_number_t packed_pool[FUZZ_MAX_INSTRUCTIONS];
+	static grunt_instruction_t optimized_code[4 * FUZZ_MAX_INSTRUCTIONS];
+	grunt_packed_program_t packed = { packed_code, packed_pool,
+		FUZZ_MAX_INSTRUCTIONS, 0, FUZZ_MAX_INSTRUCTIONS, 0 };
+	grunt_optimized_program_t optimized = { optimized_code, NULL,
+		(4 * FUZZ_MAX_INSTRUCTIONS), 0, 0 };
+	fuzz_result_t ref, r;
+
+	if (!initialized) {
+		/* The checked engines report errors on stdout. */
+		if (!freopen("/dev/null", "w", stdout)) abort();
+		GRUNT_Init();
+		initialized = true;
+	}
+
+	decode(data, size);
+	run(program, num_instructions, GRUNT_ENGINE_SWITCH, &ref);
+
+	run(program, num_instructions, GRUNT_ENGINE_THREADED, &r);
+	if (!same(&ref, &r, true)) diverged("threaded", &ref, &r);
+
+	if (CFE_SUCCESS == GRUNT_Pack(program, num_instructions, &packed)) {
+		GRUNT_SetEventSink(NULL, sink, NULL);
+		GRUNT_SetRecordView(NULL, &view);
+		p_sunk = &r;
+		r.num_events = 0;
+		r.status = GRUNT_RunPacked(&packed, image, image_size,
+			fuzz_strings, FUZZ_NUM_STRINGS);
+		if (!same(&ref, &r, true)) diverged("packed", &ref, &r);
+	}
+
+	/* Each input's program lives in the same array, which
+	 * GRUNT_Verify() would otherwise take for the last one.
+	 */
+	GRUNT_ForgetVerified();
+	if (CFE_SUCCESS != GRUNT_Verify(program, num_instructions,
+		FUZZ_NUM_STRINGS))
+		return;
+	run(program, num_instructions, GRUNT_ENGINE_AUTO, &r);
+	if (!same(&ref, &r, true)) diverged("verified", &ref, &r);
+
+	if (CFE_SUCCESS != GRUNT_Optimize(program, num_instructions,
+		FUZZ_NUM_STRINGS, &optimized))
+		return;
+	run(optimized.code, optimized.num_instructions, GRUNT_ENGINE_SWITCH,
+		&r);
+	if (!same(&ref, &r, ((ref.status == GRUNT_HALT_TRUE) ||
+		(ref.status == GRUNT_HALT_FALSE))))
+		diverged("optimized", &ref, &r);
+
+} /* fuzz_one() */
+
+
+int
+LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+
+	fuzz_one(data, size);
+	return 0;
+
+} /* LLVMFuzzerTestOneInput() */
+
+
+#ifndef GRUNT_FUZZ_LIBFUZZER
+
+/* fuzz_file()
+ *
+ * in:     fp   - open input to run
+ *         name - its name, for error messages
+ * out:    nothing
+ * return: 0 on success, else -1
+ */
+
+static int
+fuzz_file(FILE *fp, const char *name) {
+
+	uint8 data[2 + (4 * FUZZ_MAX_INSTRUCTIONS) + FUZZ_MAX_IMAGE];
+	size_t size;
+
+	size = fread(data, 1, sizeof(data), fp);
+	if (ferror(fp)) {
+		fprintf(stderr, "grunt_fuzz: can't read %s\n", name);
+		return -1;
+	}
+	fuzz_one(data, size);
+	return 0;
+
+} /* fuzz_file() */
+
+
+/* random_input()
+ *
+ * in:     nothing
+ * out:    data - a random input
+ * return: bytes of data
+ *
+ * Programs of random bytes seldom verify, so most of these programs
+ * are short runs of valid opcodes with small arguments that end in a
+ * PUSHB and a HALT, and only some take random flags.
+ */
+
+static size_t
+random_input(uint8 *data) {
+
+	grunt_pc_t n = (grunt_pc_t)(1 + (rand() % 12));  /* body length */
+	grunt_pc_t pc;
+	grunt_rep_t i, image_bytes = (grunt_rep_t)(rand() % FUZZ_MAX_IMAGE);
+	uint8 *p;
+
+	data[0] = (uint8)(n + 2);
+	data[1] = (uint8)rand();
+	for (pc = 0; pc < n + 2; pc++) {
+		p = &(data[2 + (4 * pc)]);
+		p[0] = (uint8)(1 + (rand() % GRUNT_OP_CLASSIFY));
+		p[1] = (uint8)((rand() % 8) ? 0 : rand());
+		p[2] = (uint8)(rand() % 4);
+		p[3] = 0;
+	}
+	p[-4] = GRUNT_OP_PUSHB;
+	p[0]  = GRUNT_OP_HALT;
+	p[-3] = p[1] = 0;
+	p += 4;
+	for (i = 0; i < image_bytes; i++) *p++ = (uint8)rand();
+
+	return (size_t)(p - data);
+
+} /* random_input() */
+
+
+int
+main(int argc, char *argv[]) {
+
+	uint8 data[2 + (4 * FUZZ_MAX_INSTRUCTIONS) + FUZZ_MAX_IMAGE];
+	unsigned long n, i;
+	FILE *fp;
+	int arg;
+
+	if ((argc > 2) && !strcmp(argv[1], "--random")) {
+		if ((argc > 4) || !(n = strtoul(argv[2], NULL, 10))) {
+			fprintf(stderr, "Usage:\n\tgrunt_fuzz [FILE...]\n"
+				"\tgrunt_fuzz --random N [SEED]\n");
+			return -1;
+		}
+		srand((argc == 4) ?
+			(unsigned int)strtoul(argv[3], NULL, 10) : 1);
+		for (i = 0; i < n; i++)
+			fuzz_one(data, random_input(data));
+		fprintf(stderr, "grunt_fuzz: %lu inputs, no divergences\n",
+			n);
+		return 0;
+	}
+
+	if (argc == 1) return fuzz_file(stdin, "standard input");
+	for (arg = 1; arg < argc; arg++) {
+		if (NULL == (fp = fopen(argv[arg], "rb"))) {
+			perror(argv[arg]);
+			return -1;
+		}
+		if (fuzz_file(fp, argv[arg])) {
+			fclose(fp);
+			return -1;
+		}
+		fclose(fp);
+	}
+	return 0;
+
+} /* main() */
+
+#endif /* GRUNT_FUZZ_LIBFUZZER */
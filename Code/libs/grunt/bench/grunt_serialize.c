@@ -0,0 +1,201 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/* grunt_serialize writes VSC's validation program in the serialized
+ * format described in grunt.h, for the ground to uplink and load with
+ * VSC_LOAD_PROGRAM_CC.  It serializes the program VSC builds in: the
+ * one in vsvf.h or, built with VSC_RULES_VF, in vsvf_rules.h.  It
+ * compiles with the C constants the program's PUSHNs name, which
+ * gruntasm can't evaluate.  With -O it serializes the program
+ * GRUNT_Optimize() makes of it instead.
+ *
+ * Before writing the file it reads the program back as VSC would and
+ * checks that the copy matches and verifies.
+ *
+ * Usage: grunt_serialize [-O] FILE
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cfe.h"
+
+#include "vs_tablestruct.h"   /* for VS_PARM_* constants */
+#include "vs_parmclass.h"     /* for VS_PARM_CLASS_* constants */
+#include "vs_eventids.h"      /* for VS event ID constants */
+
+#include "grunt.h"
+#include "grunt_status.h"
+#ifdef VSC_RULES_VF
+#include "vsvf_rules.h"
+#else
+#include "vsvf.h"
+#endif
+
+#define SERIAL_MAX_BYTES       8192
+#define SERIAL_MAX_STRING_SPACE 4096
+
+static uint8 serial[SERIAL_MAX_BYTES];
+static grunt_instruction_t optimized_code[VSVF_NUM_INSTRUCTIONS];
+static grunt_instruction_t copy_code[VSVF_NUM_INSTRUCTIONS];
+static const char *copy_strings[VSVF_NUM_STRINGS];
+static grunt_rep_t copy_lengths[VSVF_NUM_STRINGS];
+static char copy_space[SERIAL_MAX_STRING_SPACE];
+
+
+/* same_program()
+ *
+ * in:     program          - original program
+ *         p_copy           - program read back from its serialization
+ *         num_instructions - number of instructions in program
+ * out:    nothing
+ * return: true if the copy and its string table match the original.
+ */
+
+static bool
+same_program(const grunt_instruction_t *program,
+	const grunt_serial_program_t *p_copy, grunt_pc_t num_instructions) {
+
+	const grunt_instruction_t *p_a, *p_b;
+	grunt_pc_t pc;
+	grunt_string_t s;
+
+	if ((p_copy->num_instructions != num_instructions) ||
+		(p_copy->num_strings != VSVF_NUM_STRINGS))
+		return false;
+
+	for (pc = 0; pc < num_instructions; pc++) {
+		p_a = &(program[pc]);
+		p_b = &(p_copy->code[pc]);
+		if (p_a->op != p_b->op) return false;
+		switch (p_a->op) {
+		case GRUNT_OP_CALL:
+		case GRUNT_OP_JMPIF:
+			if (p_a->arg.lit.val.pc != p_b->arg.lit.val.pc)
+				return false;
+			break;
+		case GRUNT_OP_PUSHB:
+			if (p_a->arg.lit.val.b != p_b->arg.lit.val.b)
+				return false;
+			break;
+		case GRUNT_OP_PUSHN:
+			if (p_a->arg.lit.val.num != p_b->arg.lit.val.num)
+				return false;
+			break;
+		case GRUNT_OP_PUSHS:
+			if (p_a->arg.lit.val.str != p_b->arg.lit.val.str)
+				return false;
+			break;
+		default:
+			if (p_a->arg.rep != p_b->arg.rep) return false;
+			break;
+		}
+	}
+
+	for (s = 0; s < VSVF_NUM_STRINGS; s++) {
+		if (strcmp(vsvf_strings[s], p_copy->strings[s]) ||
+			(vsvf_string_lengths[s] != p_copy->string_lengths[s]))
+			return false;
+	}
+	return true;
+
+} /* same_program() */
+
+
+int
+main(int argc, char *argv[]) {
+
+	grunt_optimized_program_t optimized = {
+		optimized_code, NULL, VSVF_NUM_INSTRUCTIONS, 0, 0
+	};
+	grunt_serial_program_t copy = {
+		copy_code, copy_strings, copy_lengths, copy_space,
+		VSVF_NUM_INSTRUCTIONS, VSVF_NUM_STRINGS,
+		SERIAL_MAX_STRING_SPACE, 0, 0
+	};
+	const grunt_instruction_t *program = vsvf_program;
+	grunt_pc_t num_instructions = VSVF_NUM_INSTRUCTIONS;
+	bool optimize = false;
+	uint32 size;
+	int32 status;
+	FILE *out;
+
+	if ((argc == 3) && !strcmp(argv[1], "-O")) {
+		optimize = true;
+		argv++;
+		argc--;
+	}
+	if (argc != 2) {
+		fprintf(stderr, "Usage: grunt_serialize [-O] FILE\n");
+		return 1;
+	}
+
+	GRUNT_Init();
+
+	if (optimize) {
+		if (CFE_SUCCESS != (status = GRUNT_Optimize(vsvf_program,
+			VSVF_NUM_INSTRUCTIONS, VSVF_NUM_STRINGS,
+			&optimized))) {
+			fprintf(stderr, "GRUNT_Optimize() returned 0x%08X\n",
+				(unsigned int)status);
+			return 1;
+		}
+		program          = optimized.code;
+		num_instructions = optimized.num_instructions;
+	}
+
+	if (CFE_SUCCESS != (status = GRUNT_Serialize(program,
+		num_instructions, vsvf_strings, VSVF_NUM_STRINGS, serial,
+		sizeof(serial), &size))) {
+		fprintf(stderr, "GRUNT_Serialize() returned 0x%08X\n",
+			(unsigned int)status);
+		return 1;
+	}
+
+	if (CFE_SUCCESS != (status = GRUNT_Deserialize(serial, size,
+		&copy))) {
+		fprintf(stderr, "GRUNT_Deserialize() returned 0x%08X\n",
+			(unsigned int)status);
+		return 1;
+	}
+	if (!same_program(program, &copy, num_instructions)) {
+		fprintf(stderr, "program read back differs\n");
+		return 1;
+	}
+	if (CFE_SUCCESS != (status = GRUNT_Verify(copy.code,
+		copy.num_instructions, copy.num_strings))) {
+		fprintf(stderr, "GRUNT_Verify() returned 0x%08X\n",
+			(unsigned int)status);
+		return 1;
+	}
+
+	if (!(out = fopen(argv[1], "wb"))) {
+		perror(argv[1]);
+		return 1;
+	}
+	if (fwrite(serial, 1, size, out) != size) {
+		perror(argv[1]);
+		fclose(out);
+		return 1;
+	}
+	fclose(out);
+
+	printf("%s: %u instructions, %u strings in %lu bytes\n", argv[1],
+		(unsigned int)num_instructions, (unsigned int)VSVF_NUM_STRINGS,
+		(unsigned long)size);
+	return 0;
+
+} /* main() */
@@ -0,0 +1,137 @@
+#ifndef _CFE_H_
+#define _CFE_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* Stand-ins for the few cFS and OSAL declarations the Grunt library,
+ * the VSA and VSC validation functions, and the gruntaot translation
+ * of vsvf.h use, so the Grunt benchmark can link them on a host
+ * without cFS.  The values match cFS draco-rc5 where the code depends on
+ * them; bench_stubs.c implements the functions.
+ */
+
+#include <stdio.h>
+#include <string.h>   /* the real cfe.h brings these in too */
+
+#include "common_types.h"
+
+typedef int32 CFE_Status_t;
+
+#define CFE_SUCCESS ((CFE_Status_t)0)
+#define OS_SUCCESS  0
+
+#define OS_printf printf
+
+#define CFE_MISSION_MAX_PATH_LEN 64
+
+/* EVS */
+#define CFE_MISSION_EVS_MAX_MESSAGE_LENGTH 122
+
+#define CFE_EVS_EventType_DEBUG       1
+#define CFE_EVS_EventType_INFORMATION 2
+#define CFE_EVS_EventType_ERROR       3
+#define CFE_EVS_EventType_CRITICAL    4
+
+CFE_Status_t CFE_EVS_SendEvent(uint16, uint16, const char *, ...);
+
+/* ES */
+void  CFE_ES_PerfLogEntry(uint32);
+void  CFE_ES_PerfLogExit(uint32);
+int32 CFE_ES_WriteToSysLog(const char *, ...);
+
+typedef uint32 CFE_ES_TaskId_t;
+typedef void (*CFE_ES_ChildTaskMainFuncPtr_t)(void);
+
+#define CFE_ES_TASK_STACK_ALLOCATE NULL
+
+CFE_Status_t CFE_ES_CreateChildTask(CFE_ES_TaskId_t *, const char *,
+	CFE_ES_ChildTaskMainFuncPtr_t, void *, size_t, uint16, uint32);
+void CFE_ES_ExitChildTask(void);
+
+/* OSAL */
+#define OS_MAX_API_NAME 20
+
+int32 OS_MutSemCreate(osal_id_t *, const char *, uint32);
+int32 OS_MutSemTake(osal_id_t);
+int32 OS_MutSemGive(osal_id_t);
+int32 OS_CountSemCreate(osal_id_t *, const char *, uint32, uint32);
+int32 OS_CountSemTake(osal_id_t);
+int32 OS_CountSemGive(osal_id_t);
+
+typedef struct {
+	int64 ticks;          /* 100 ns ticks, as in OSAL */
+} OS_time_t;
+
+static inline OS_time_t
+OS_TimeSubtract(OS_time_t time1, OS_time_t time2) {
+	OS_time_t result = { time1.ticks - time2.ticks };
+	return result;
+}
+
+static inline int64
+OS_TimeGetTotalNanoseconds(OS_time_t tm) {
+	return tm.ticks * 100;
+}
+
+#define OS_FILE_FLAG_NONE 0
+#define OS_READ_ONLY      0
+
+int32 OS_OpenCreate(osal_id_t *, const char *, int32, int32);
+int32 OS_read(osal_id_t, void *, size_t);
+int32 OS_close(osal_id_t);
+
+/* PSP */
+void CFE_PSP_GetTime(OS_time_t *);
+
+/* FS: only the file header field VSC's table file reader checks. */
+#define CFE_FS_SubType_TBL_IMG 8
+
+typedef struct {
+	uint32 SubType;
+} CFE_FS_Header_t;
+
+int32 CFE_FS_ReadHeader(CFE_FS_Header_t *, osal_id_t);
+
+/* SB and MSG: only the message types the VS headers name. */
+typedef struct {
+	uint8 bytes[16];
+} CFE_MSG_TelemetryHeader_t;
+
+typedef struct {
+	uint8 bytes[8];
+} CFE_MSG_CommandHeader_t;
+
+/* TBL */
+typedef int16 CFE_TBL_Handle_t;
+typedef int32 (*CFE_TBL_CallbackFuncPtr_t)(void *);
+
+#define CFE_TBL_OPT_DEFAULT 0
+#define CFE_TBL_SRC_FILE    0
+
+#define CFE_MISSION_TBL_MAX_FULL_NAME_LEN 40
+
+typedef struct {
+	uint32 Reserved;
+	uint32 Offset;
+	uint32 NumBytes;
+	char   TableName[CFE_MISSION_TBL_MAX_FULL_NAME_LEN];
+} CFE_TBL_File_Hdr_t;
+
+CFE_Status_t CFE_TBL_Register(CFE_TBL_Handle_t *, const char *, size_t,
+			      uint16, CFE_TBL_CallbackFuncPtr_t);
+CFE_Status_t CFE_TBL_Load(CFE_TBL_Handle_t, int, const void *);
+
+#endif
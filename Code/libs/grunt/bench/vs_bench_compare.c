@@ -0,0 +1,232 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/* vs_bench_compare holds a build's benchmark results to a baseline.
+ * It reads the results files grunt_bench --json and TBLtest --json
+ * wrote, and for each result the baseline also has, prints how far
+ * its median and 99th percentile moved.  It fails if either rose by
+ * more than the threshold percent, 20 by default.  It also prints
+ * each result's ratio to VSA's result from the same program, now and
+ * in the baseline, since the gap between VSA's native validation and
+ * VSC's Grunt validation is what the challenge measures.  With --out
+ * FILE, it writes the results it read, merged, to FILE; copying that
+ * file over baseline.json makes it the new baseline.
+ *
+ * Usage: vs_bench_compare [--threshold PCT] [--out FILE] BASELINE
+ *            RESULTS...
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cfe.h"
+
+#include "vs_bench_json.h"
+
+#define COMPARE_DEFAULT_THRESHOLD 20.0   /* percent */
+
+static vs_bench_result_t baseline[VS_BENCH_MAX_RESULTS];
+static vs_bench_result_t results[VS_BENCH_MAX_RESULTS];
+static int num_baseline, num_results;
+
+
+/* find()
+ *
+ * in:     set  - results to look in
+ *         num  - number of results in set
+ *         name - name of result to find
+ * out:    nothing
+ * return: the result in set with that name, or NULL.
+ */
+
+static const vs_bench_result_t *
+find(const vs_bench_result_t *set, int num, const char *name) {
+
+	int i;
+
+	for (i = 0; i < num; i++) {
+		if (!strcmp(set[i].name, name)) return &(set[i]);
+	}
+	return NULL;
+
+} /* find() */
+
+
+/* merge()
+ *
+ * in:     path    - results file to read
+ *         results - results so far
+ * out:    results - the file's results added, each replacing any
+ *                   earlier result of the same name
+ * return: 0 on success, else -1 after printing why to stderr.
+ */
+
+static int
+merge(const char *path) {
+
+	vs_bench_result_t in_file[VS_BENCH_MAX_RESULTS];
+	int num_read, i, j;
+
+	if (-1 == (num_read = vs_bench_read(path, in_file,
+		VS_BENCH_MAX_RESULTS)))
+		return -1;
+	for (i = 0; i < num_read; i++) {
+		for (j = 0; (j < num_results) &&
+			strcmp(results[j].name, in_file[i].name); j++);
+		if (j == VS_BENCH_MAX_RESULTS) {
+			fprintf(stderr, "vs_bench_compare: more than %d "
+				"results\n", VS_BENCH_MAX_RESULTS);
+			return -1;
+		}
+		results[j] = in_file[i];
+		if (j == num_results) num_results++;
+	}
+	return 0;
+
+} /* merge() */
+
+
+/* change()
+ *
+ * in:     now  - a measurement
+ *         then - the baseline's measurement
+ * out:    nothing
+ * return: how far now is above then, in percent of then; 0 if then is.
+ */
+
+static double
+change(double now, double then) {
+
+	return ((then > 0.0) ? (100.0 * (now - then) / then) : 0.0);
+
+} /* change() */
+
+
+/* vsa_ratio()
+ *
+ * in:     set    - results to look in
+ *         num    - number of results in set
+ *         p_mine - a result in set
+ * out:    nothing
+ * return: the ratio of p_mine's median to that of the VSA result from
+ *         the same program, or 0 if set has none.
+ */
+
+static double
+vsa_ratio(const vs_bench_result_t *set, int num,
+	const vs_bench_result_t *p_mine) {
+
+	const vs_bench_result_t *p_vsa;
+	char name[VS_BENCH_NAME_LEN];
+	const char *dot;
+
+	if (NULL == (dot = strchr(p_mine->name, '.'))) return 0.0;
+	snprintf(name, sizeof(name), "%.*s.vsa",
+		(int)(dot - p_mine->name), p_mine->name);
+	if ((NULL == (p_vsa = find(set, num, name))) ||
+		(p_vsa == p_mine) || (p_vsa->p50 <= 0.0))
+		return 0.0;
+	return p_mine->p50 / p_vsa->p50;
+
+} /* vsa_ratio() */
+
+
+int
+main(int argc, char *argv[]) {
+
+	const vs_bench_result_t *p_now, *p_then;
+	double threshold = COMPARE_DEFAULT_THRESHOLD;
+	double p50, p99, ratio_now, ratio_then;
+	const char *out_path = NULL;
+	int regressions = 0;
+	int i;
+	char *end;
+
+	for (i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--threshold") && ((i + 1) < argc)) {
+			threshold = strtod(argv[++i], &end);
+			if (*end || (threshold < 0.0)) break;
+		} else if (!strcmp(argv[i], "--out") && ((i + 1) < argc)) {
+			out_path = argv[++i];
+		} else {
+			break;
+		}
+	}
+	if ((argc - i) < 2) {
+		fprintf(stderr, "Usage:\n\tvs_bench_compare [--threshold PCT] "
+			"[--out FILE] BASELINE RESULTS...\n");
+		return -1;
+	}
+	if (-1 == (num_baseline = vs_bench_read(argv[i], baseline,
+		VS_BENCH_MAX_RESULTS)))
+		return -1;
+	for (i++; i < argc; i++) {
+		if (merge(argv[i])) return -1;
+	}
+
+	printf("%-24s %5s %10s %8s %10s %8s\n", "result", "unit", "p50",
+		"change", "p99", "change");
+	for (i = 0; i < num_results; i++) {
+		p_now = &(results[i]);
+		printf("%-24s %5s %10.1f", p_now->name, p_now->unit,
+			p_now->p50);
+		if (NULL == (p_then = find(baseline, num_baseline,
+			p_now->name))) {
+			printf(" %8s %10.1f %8s  new\n", "-", p_now->p99, "-");
+			continue;
+		}
+		p50 = change(p_now->p50, p_then->p50);
+		p99 = change(p_now->p99, p_then->p99);
+		printf(" %+7.1f%% %10.1f %+7.1f%%", p50, p_now->p99, p99);
+		if ((p50 > threshold) || (p99 > threshold)) {
+			printf("  REGRESSED\n");
+			regressions++;
+		} else {
+			printf("\n");
+		}
+	}
+	for (i = 0; i < num_baseline; i++) {
+		if (!find(results, num_results, baseline[i].name))
+			printf("%-24s not measured\n", baseline[i].name);
+	}
+
+	/* The gap to VSA, by median, now and then. */
+	for (i = 0; i < num_results; i++) {
+		p_now = &(results[i]);
+		if (0.0 == (ratio_now = vsa_ratio(results, num_results,
+			p_now)))
+			continue;
+		printf("gap: %s is %.2fx vsa", p_now->name, ratio_now);
+		p_then = find(baseline, num_baseline, p_now->name);
+		if (p_then && (0.0 != (ratio_then = vsa_ratio(baseline,
+			num_baseline, p_then)))) {
+			printf(", %.2fx in the baseline", ratio_then);
+		}
+		printf("\n");
+	}
+
+	if (out_path && vs_bench_write(out_path, results, num_results))
+		return -1;
+
+	if (regressions) {
+		printf("%d of %d results regressed more than %.1f%%.\n",
+			regressions, num_results, threshold);
+		return 1;
+	}
+	printf("No result regressed more than %.1f%%.\n", threshold);
+	return 0;
+
+} /* main() */
@@ -0,0 +1,126 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/* This module reads and writes the benchmark results files described
+ * in vs_bench_json.h.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cfe.h"
+
+#include "vs_bench_json.h"
+
+
+/* ------------------- module exported functions -------------------- */
+
+/* vs_bench_read()
+ *
+ * in:     path        - name of results file
+ *         max_results - room in results[]
+ * out:    results     - the file's results, in file order
+ * return: the number of results read, else -1 after printing why to
+ *         stderr.
+ */
+
+int
+vs_bench_read(const char *path, vs_bench_result_t *results,
+	int max_results) {
+
+	vs_bench_result_t *p_result;
+	char line[256];
+	FILE *p_file;
+	unsigned version = 0;    /* 0 until the file says */
+	int num_results = 0;
+
+	if (NULL == (p_file = fopen(path, "r"))) {
+		perror(path);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), p_file)) {
+		if (1 == sscanf(line, " \"version\": %u", &version)) continue;
+		if (!strstr(line, "\"name\"")) continue;
+		if (num_results == max_results) {
+			fprintf(stderr, "%s: more than %d results\n", path,
+				max_results);
+			num_results = -1;
+			break;
+		}
+		p_result = &(results[num_results]);
+		memset(p_result, 0, sizeof(*p_result));
+		if (6 != sscanf(line, " { \"name\": \"%31[^\"]\", "
+			"\"unit\": \"%7[^\"]\", \"count\": %u, \"p50\": %lf, "
+			"\"p99\": %lf, \"mean\": %lf }", p_result->name,
+			p_result->unit, &(p_result->count), &(p_result->p50),
+			&(p_result->p99), &(p_result->mean))) {
+			fprintf(stderr, "%s: bad result: %s", path, line);
+			num_results = -1;
+			break;
+		}
+		num_results++;
+	}
+	fclose(p_file);
+
+	if ((num_results != -1) && (version != VS_BENCH_VERSION)) {
+		fprintf(stderr, "%s: not a version %u results file\n", path,
+			(unsigned)VS_BENCH_VERSION);
+		num_results = -1;
+	}
+	return num_results;
+
+} /* vs_bench_read() */
+
+
+/* vs_bench_write()
+ *
+ * in:     path        - name of results file to write
+ *         results     - the results
+ *         num_results - number of results
+ * out:    results file - written
+ * return: 0 on success, else -1 after printing why to stderr.
+ */
+
+int
+vs_bench_write(const char *path, const vs_bench_result_t *results,
+	int num_results) {
+
+	FILE *p_file;
+	int i;
+
+	if (NULL == (p_file = fopen(path, "w"))) {
+		perror(path);
+		return -1;
+	}
+	fprintf(p_file, "{\n  \"format\": \"vs_bench\",\n"
+		"  \"version\": %u,\n  \"results\": [\n",
+		(unsigned)VS_BENCH_VERSION);
+	for (i = 0; i < num_results; i++) {
+		fprintf(p_file, "    { \"name\": \"%s\", \"unit\": \"%s\", "
+			"\"count\": %u, \"p50\": %.1f, \"p99\": %.1f, "
+			"\"mean\": %.1f }%s\n", results[i].name,
+			results[i].unit, (unsigned)results[i].count,
+			results[i].p50, results[i].p99, results[i].mean,
+			((i + 1) < num_results) ? "," : "");
+	}
+	fprintf(p_file, "  ]\n}\n");
+	if (fclose(p_file)) {
+		perror(path);
+		return -1;
+	}
+	return 0;
+
+} /* vs_bench_write() */
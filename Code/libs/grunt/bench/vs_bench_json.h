@@ -0,0 +1,61 @@
+#ifndef _VS_BENCH_JSON_H_
+#define _VS_BENCH_JSON_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* Benchmark results files: grunt_bench --json and TBLtest --json each
+ * write one, and vs_bench_compare merges them and holds them to the
+ * checked-in baseline.json, so that a build's VSA and VSC timings can
+ * be compared with those of an earlier build.
+ *
+ * A results file is JSON, written one result to a line so that
+ * vs_bench_read() can read it back without a JSON parser.  Here the
+ * result's line is wrapped to fit:
+ *
+ *   {
+ *     "format": "vs_bench",
+ *     "version": 1,
+ *     "results": [
+ *       { "name": "grunt_bench.vsa", "unit": "ns", "count": 100000,
+ *         "p50": 10.2, "p99": 13.9, "mean": 10.4 },
+ *       ...
+ *     ]
+ *   }
+ *
+ * Readers reject files of any other version.  A result's name is the
+ * program that measured it, a dot, and what it measured; "vsa" names
+ * VSA's validation function, the one whose timings the others are
+ * compared to.
+ */
+
+#define VS_BENCH_VERSION     1
+#define VS_BENCH_NAME_LEN    32    /* longest name, with its NUL */
+#define VS_BENCH_UNIT_LEN    8     /* longest unit, with its NUL */
+#define VS_BENCH_MAX_RESULTS 32    /* most results in one file */
+
+typedef struct {
+	char   name[VS_BENCH_NAME_LEN];
+	char   unit[VS_BENCH_UNIT_LEN];   /* "ns", "us", or "ticks" */
+	uint32 count;                     /* samples measured */
+	double p50;
+	double p99;
+	double mean;
+} vs_bench_result_t;
+
+int vs_bench_read(const char *, vs_bench_result_t *, int);
+int vs_bench_write(const char *, const vs_bench_result_t *, int);
+
+#endif
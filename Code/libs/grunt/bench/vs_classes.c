@@ -0,0 +1,142 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/* This module enumerates the class space described in vs_classes.h. */
+
+#include <string.h>
+
+#include "cfe.h"
+
+#include "vs_tablestruct.h"
+
+#include "vs_classes.h"
+
+
+/* ----------------- module private functions and state ------------- */
+
+static const uint8 parm_ids[] = {
+	VS_PARM_UNUSED,
+	VS_PARM_APE, VS_PARM_BAT, VS_PARM_CAT, VS_PARM_DOG,
+	VS_PARM_NORTH, VS_PARM_SOUTH, VS_PARM_EAST, VS_PARM_WEST,
+	(VS_PARM_APE | VS_PARM_BAT), (VS_PARM_APE | VS_PARM_NORTH), 0xFF,
+};
+#define NUM_PARMS (sizeof(parm_ids) / sizeof(parm_ids[0]))
+
+/* Zeroed, one byte set, bytes that share no bits, and all bits set. */
+static const uint8 pads[][3] = {
+	{ 0x00, 0x00, 0x00 }, { 0x00, 0x42, 0x00 },
+	{ 0x01, 0x02, 0x04 }, { 0xFF, 0xFF, 0xFF },
+};
+#define NUM_PADS (sizeof(pads) / sizeof(pads[0]))
+
+static const uint32 bounds[] = {
+	0,
+	VS_PARM_ANIMAL_MIN - 1,    VS_PARM_ANIMAL_MIN,
+	VS_PARM_ANIMAL_MAX,        VS_PARM_ANIMAL_MAX + 1,
+	VS_PARM_DIRECTION_MIN - 1, VS_PARM_DIRECTION_MIN,
+	VS_PARM_DIRECTION_MAX,     VS_PARM_DIRECTION_MAX + 1,
+	0xFFFFFFFF,
+};
+#define NUM_BOUNDS (sizeof(bounds) / sizeof(bounds[0]))
+
+#define NUM_CLASSES (NUM_PARMS * NUM_PADS * NUM_BOUNDS * NUM_BOUNDS)
+
+
+/* set_class()
+ *
+ * in:     p_entry - entry to set
+ *         c       - entry class, 0 to NUM_CLASSES - 1
+ * out:    p_entry - set to a member of class c
+ * return: nothing
+ */
+
+static void
+set_class(vs_entry_t *p_entry, unsigned long c) {
+
+	p_entry->bound_high = bounds[c % NUM_BOUNDS];
+	c /= NUM_BOUNDS;
+	p_entry->bound_low  = bounds[c % NUM_BOUNDS];
+	c /= NUM_BOUNDS;
+	memcpy(p_entry->pad, pads[c % NUM_PADS], sizeof(p_entry->pad));
+	c /= NUM_PADS;
+	p_entry->parm_id    = parm_ids[c];
+
+} /* set_class() */
+
+
+/* ------------------- module exported functions -------------------- */
+
+void
+vs_classes_single(vs_next_image_t next) {
+
+	unsigned long c;
+	unsigned int i;
+
+	for (i = 0; i < VS_TABLE_NUM_ENTRIES; i++) {
+		for (c = 0; c < NUM_CLASSES; c++)
+			set_class(&(next()->entries[i]), c);
+	}
+
+} /* vs_classes_single() */
+
+
+void
+vs_classes_parms(vs_next_image_t next) {
+
+	vs_table_t *p_image;
+	unsigned long n, combo;
+	unsigned int i;
+	uint8 parm_id;
+
+	for (n = 0; n < NUM_PARMS * NUM_PARMS * NUM_PARMS * NUM_PARMS; n++) {
+		p_image = next();
+		for (combo = n, i = 0; i < VS_TABLE_NUM_ENTRIES; i++) {
+			parm_id = parm_ids[combo % NUM_PARMS];
+			combo /= NUM_PARMS;
+			p_image->entries[i].parm_id = parm_id;
+			if (parm_id == VS_PARM_UNUSED) continue;
+			if (parm_id < VS_PARM_NORTH) {
+				p_image->entries[i].bound_low  =
+					VS_PARM_ANIMAL_MIN;
+				p_image->entries[i].bound_high =
+					VS_PARM_ANIMAL_MAX;
+			} else {
+				p_image->entries[i].bound_low  =
+					VS_PARM_DIRECTION_MIN;
+				p_image->entries[i].bound_high =
+					VS_PARM_DIRECTION_MAX;
+			}
+		}
+	}
+
+} /* vs_classes_parms() */
+
+
+void
+vs_classes_pairs(vs_next_image_t next) {
+
+	vs_table_t *p_image;
+	unsigned long c0, c1;
+
+	for (c0 = 0; c0 < NUM_CLASSES; c0++) {
+		for (c1 = 0; c1 < NUM_CLASSES; c1++) {
+			p_image = next();
+			set_class(&(p_image->entries[0]), c0);
+			set_class(&(p_image->entries[1]), c1);
+		}
+	}
+
+} /* vs_classes_pairs() */
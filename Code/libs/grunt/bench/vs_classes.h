@@ -0,0 +1,43 @@
+#ifndef _VS_CLASSES_H_
+#define _VS_CLASSES_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* The class space of table images vs_diff enumerates and vs_corpus_gen
+ * writes to a corpus.  An entry's class is its parm ID, its padding,
+ * and the class of each of its bounds: both edges of both parm ranges,
+ * one past each edge, zero, and the largest uint32.  The phases are:
+ *
+ *   single - every entry class at every entry position, the other
+ *            entries unused.
+ *   parms  - every combination of parm IDs across all four entries,
+ *            each entry's padding zeroed and its bounds the full
+ *            range of its parm, so that the validators disagree only
+ *            if they track unused and redefined entries differently.
+ *   pairs  - every combination of entry classes in the first two
+ *            entries, the others unused.
+ *
+ * Each phase gets every image it sets from next, which must return a
+ * zeroed image.
+ */
+
+typedef vs_table_t *(*vs_next_image_t)(void);
+
+void vs_classes_single(vs_next_image_t);
+void vs_classes_parms(vs_next_image_t);
+void vs_classes_pairs(vs_next_image_t);
+
+#endif
@@ -0,0 +1,197 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/* This module reads and writes the golden-image corpus files described
+ * in vs_corpus.h.  Readers map the whole file read-only and use it in
+ * place; nothing is copied or converted.
+ */
+
+#define _POSIX_C_SOURCE 200112L    /* for mmap() and fstat() */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cfe.h"
+
+#include "vs_tablestruct.h"
+
+#include "vs_corpus.h"
+
+
+/* ----------------- module private functions and state ------------- */
+
+/* corpus_fits()
+ *
+ * in:     p_header - header of a mapped corpus file
+ *         size     - size of the file
+ * out:    nothing
+ * return: true if the header is one this build reads and it describes
+ *         arrays that lie within the file, else false.
+ */
+
+static bool
+corpus_fits(const vs_corpus_header_t *p_header, size_t size) {
+
+	uint64 images_end, expect_end;
+
+	if ((p_header->magic       != VS_CORPUS_MAGIC) ||
+		(p_header->version     != VS_CORPUS_VERSION) ||
+		(p_header->num_entries != VS_TABLE_NUM_ENTRIES) ||
+		(p_header->image_size  != sizeof(vs_table_t)) ||
+		(p_header->expect_size != sizeof(vs_corpus_expect_t)))
+		return false;
+
+	/* The arrays must be aligned for their members, too. */
+	if ((p_header->images_offset % sizeof(uint32)) ||
+		(p_header->expect_offset % sizeof(uint32)))
+		return false;
+
+	images_end = (uint64)p_header->images_offset +
+		((uint64)p_header->num_images * sizeof(vs_table_t));
+	expect_end = (uint64)p_header->expect_offset +
+		((uint64)p_header->num_images * sizeof(vs_corpus_expect_t));
+	return ((p_header->images_offset >= sizeof(*p_header)) &&
+		(p_header->expect_offset >= sizeof(*p_header)) &&
+		(images_end <= size) && (expect_end <= size));
+
+} /* corpus_fits() */
+
+
+/* ------------------- module exported functions -------------------- */
+
+/* vs_corpus_map()
+ *
+ * in:     path     - name of corpus file
+ * out:    p_corpus - the mapped corpus, if successful
+ * return: 0 on success, else -1 after printing why to stderr.
+ */
+
+int
+vs_corpus_map(const char *path, vs_corpus_t *p_corpus) {
+
+	struct stat st;
+	void *p_map;
+	int fd;
+
+	if (-1 == (fd = open(path, O_RDONLY))) {
+		perror(path);
+		return -1;
+	}
+	if (-1 == fstat(fd, &st)) {
+		perror(path);
+		close(fd);
+		return -1;
+	}
+	if ((size_t)st.st_size < sizeof(vs_corpus_header_t)) {
+		fprintf(stderr, "%s: too short for a corpus\n", path);
+		close(fd);
+		return -1;
+	}
+	p_map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd,
+		0);
+	close(fd);    /* the mapping outlives it */
+	if (p_map == MAP_FAILED) {
+		perror(path);
+		return -1;
+	}
+	if (!corpus_fits((const vs_corpus_header_t *)p_map,
+		(size_t)st.st_size)) {
+		fprintf(stderr, "%s: not a corpus of %u-entry tables from "
+			"this build\n", path, (unsigned)VS_TABLE_NUM_ENTRIES);
+		munmap(p_map, (size_t)st.st_size);
+		return -1;
+	}
+
+	p_corpus->p_header   = (const vs_corpus_header_t *)p_map;
+	p_corpus->images     = (const vs_table_t *)((const char *)p_map +
+		p_corpus->p_header->images_offset);
+	p_corpus->expect     = (const vs_corpus_expect_t *)
+		((const char *)p_map + p_corpus->p_header->expect_offset);
+	p_corpus->num_images = p_corpus->p_header->num_images;
+	p_corpus->size       = (size_t)st.st_size;
+	return 0;
+
+} /* vs_corpus_map() */
+
+
+/* vs_corpus_unmap()
+ *
+ * in:     p_corpus - a corpus vs_corpus_map() mapped
+ * out:    p_corpus - unmapped and emptied
+ * return: nothing
+ */
+
+void
+vs_corpus_unmap(vs_corpus_t *p_corpus) {
+
+	if (p_corpus->p_header) {
+		munmap((void *)p_corpus->p_header, p_corpus->size);
+	}
+	memset(p_corpus, 0, sizeof(*p_corpus));
+
+} /* vs_corpus_unmap() */
+
+
+/* vs_corpus_write()
+ *
+ * in:     path       - name of corpus file to write
+ *         images     - the images
+ *         expect     - what a correct validator does with each
+ *         num_images - number of images
+ * out:    corpus file - written
+ * return: 0 on success, else -1 after printing why to stderr.
+ */
+
+int
+vs_corpus_write(const char *path, const vs_table_t *images,
+	const vs_corpus_expect_t *expect, uint32 num_images) {
+
+	vs_corpus_header_t header;
+	FILE *p_file;
+	int status = -1;
+
+	memset(&header, 0, sizeof(header));
+	header.magic         = VS_CORPUS_MAGIC;
+	header.version       = VS_CORPUS_VERSION;
+	header.num_entries   = VS_TABLE_NUM_ENTRIES;
+	header.image_size    = sizeof(vs_table_t);
+	header.expect_size   = sizeof(vs_corpus_expect_t);
+	header.num_images    = num_images;
+	header.images_offset = sizeof(header);
+	header.expect_offset = sizeof(header) +
+		(num_images * sizeof(vs_table_t));
+
+	if (NULL == (p_file = fopen(path, "wb"))) {
+		perror(path);
+		return -1;
+	}
+	do {
+		if (1 != fwrite(&header, sizeof(header), 1, p_file)) break;
+		if (num_images != fwrite(images, sizeof(vs_table_t),
+			num_images, p_file)) break;
+		if (num_images != fwrite(expect, sizeof(vs_corpus_expect_t),
+			num_images, p_file)) break;
+		status = 0;
+	} while (0);
+	if (fclose(p_file)) status = -1;
+	if (status) perror(path);
+	return status;
+
+} /* vs_corpus_write() */
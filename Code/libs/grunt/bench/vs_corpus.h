@@ -0,0 +1,81 @@
+#ifndef _VS_CORPUS_H_
+#define _VS_CORPUS_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/* A golden-image corpus: table images with the verdict and events
+ * expected of each, which vs_corpus_gen writes once and grunt_bench,
+ * vs_diff, and TBLtest's soak test then read in place, so that every
+ * benchmark runs the same images and none needs its own generator.
+ *
+ * A corpus file is a vs_corpus_header_t, then num_images vs_table_t
+ * images packed end to end at images_offset, then one
+ * vs_corpus_expect_t per image at expect_offset.  Keeping the images
+ * apart from their expectations lets readers mmap() the file and
+ * validate straight from images[], just as they would from an array
+ * of their own.  All fields are in host byte order, as the table
+ * files TBLtest writes are; readers reject files whose magic,
+ * version, or sizes don't match their own build.
+ */
+
+#define VS_CORPUS_MAGIC   0x56534350   /* "VSCP" in host byte order */
+#define VS_CORPUS_VERSION 1
+
+/* Events kept per image.  Images may make a validator send more; the
+ * corpus records how many, but only the first VS_CORPUS_MAX_EVENTS.
+ */
+#define VS_CORPUS_MAX_EVENTS 8
+
+typedef struct {
+	uint32 magic;           /* VS_CORPUS_MAGIC */
+	uint32 version;         /* VS_CORPUS_VERSION */
+	uint32 num_entries;     /* VS_TABLE_NUM_ENTRIES of the images */
+	uint32 image_size;      /* sizeof(vs_table_t) */
+	uint32 expect_size;     /* sizeof(vs_corpus_expect_t) */
+	uint32 num_images;
+	uint32 images_offset;   /* bytes from start of file */
+	uint32 expect_offset;   /* bytes from start of file */
+} vs_corpus_header_t;
+
+typedef struct {
+	uint16 event_id;
+	uint16 event_type;
+} vs_corpus_event_t;
+
+/* What a correct validator does with one image. */
+typedef struct {
+	uint8  valid;           /* verdict */
+	uint8  spare;
+	uint16 num_events;      /* events sent, perhaps more than kept */
+	vs_corpus_event_t events[VS_CORPUS_MAX_EVENTS];
+} vs_corpus_expect_t;
+
+/* A corpus file mapped into memory. */
+typedef struct {
+	const vs_corpus_header_t *p_header;
+	const vs_table_t         *images;
+	const vs_corpus_expect_t *expect;
+	uint32 num_images;
+	size_t size;            /* of the mapping */
+} vs_corpus_t;
+
+int  vs_corpus_map(const char *, vs_corpus_t *);
+void vs_corpus_unmap(vs_corpus_t *);
+int  vs_corpus_write(const char *, const vs_table_t *,
+	const vs_corpus_expect_t *, uint32);
+
+#endif
@@ -0,0 +1,166 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/* vs_corpus_gen writes the golden-image corpus that grunt_bench,
+ * vs_diff, and TBLtest's soak test read with --corpus: every image in
+ * vs_diff's single and parms phases, which between them make every
+ * VS_TBL_*_ERR_EID event, each with the verdict and events expected
+ * of it.  The expectations come from VSB_table_validate(), the native
+ * code vsrules generated from apps/vs/vs_rules.spec, the rules every
+ * VS app is meant to follow.  VSA's are not golden; it has flaws
+ * vs_diff exists to show.
+ *
+ * Usage: vs_corpus_gen FILE
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cfe.h"
+
+#include "vs_tablestruct.h"
+#include "vs_msgstruct.h"    /* for vsb_table.h */
+#include "vsb_table.h"
+
+#include "vs_classes.h"
+#include "vs_corpus.h"
+
+#include "bench_stubs.h"
+
+#define GEN_MAX_KINDS 32
+
+static vs_table_t *images = NULL;
+static uint32 num_images = 0, max_images = 0;
+
+/* Images counted by the first event expected of them. */
+static struct {
+	uint16 event_id;
+	bool   valid;
+	unsigned long count;
+} kinds[GEN_MAX_KINDS];
+static unsigned int num_kinds = 0;
+
+
+/* next_image()
+ *
+ * in:     images - images so far
+ * out:    images - a new zeroed image added, grown if need be
+ * return: the new image.
+ */
+
+static vs_table_t *
+next_image(void) {
+
+	vs_table_t *p_grown;
+
+	if (num_images == max_images) {
+		max_images = (max_images ? 2 * max_images : 4096);
+		if (NULL == (p_grown = realloc(images,
+			max_images * sizeof(vs_table_t)))) {
+			perror("vs_corpus_gen: no memory for images");
+			exit(-1);
+		}
+		images = p_grown;
+	}
+	memset(&(images[num_images]), 0, sizeof(images[num_images]));
+	return &(images[num_images++]);
+
+} /* next_image() */
+
+
+/* expect()
+ *
+ * in:     validate - the reference validation function
+ *         p_image  - image to validate
+ * out:    p_expect - what it did
+ *         kinds    - the image counted
+ * return: nothing
+ */
+
+static void
+expect(CFE_TBL_CallbackFuncPtr_t validate, const vs_table_t *p_image,
+	vs_corpus_expect_t *p_expect) {
+
+	uint16 first;
+	uint32 i;
+
+	memset(p_expect, 0, sizeof(*p_expect));
+	bench_num_events = 0;
+	p_expect->valid = (CFE_SUCCESS == validate((void *)p_image));
+	p_expect->num_events = (uint16)bench_num_events;
+	for (i = 0; (i < bench_num_events) && (i < VS_CORPUS_MAX_EVENTS);
+		i++) {
+		p_expect->events[i].event_id   = bench_events[i].event_id;
+		p_expect->events[i].event_type = bench_events[i].event_type;
+	}
+
+	first = (bench_num_events ? bench_events[0].event_id : 0);
+	for (i = 0; i < num_kinds; i++) {
+		if ((kinds[i].event_id == first) &&
+			(kinds[i].valid == p_expect->valid))
+			break;
+	}
+	if (i == num_kinds) {
+		if (num_kinds == GEN_MAX_KINDS) return;
+		kinds[num_kinds].event_id = first;
+		kinds[num_kinds].valid    = p_expect->valid;
+		kinds[num_kinds++].count  = 0;
+	}
+	kinds[i].count++;
+
+} /* expect() */
+
+
+int
+main(int argc, char *argv[]) {
+
+	CFE_TBL_Handle_t handle;
+	vs_corpus_expect_t *p_expect;
+	uint32 i;
+
+	if (argc != 2) {
+		fprintf(stderr, "Usage:\n\tvs_corpus_gen FILE\n");
+		return -1;
+	}
+	if ((CFE_SUCCESS != VSB_table_init(&handle)) || !bench_validate) {
+		fprintf(stderr, "vs_corpus_gen: VSB_table_init() failed\n");
+		return -1;
+	}
+
+	vs_classes_single(next_image);
+	vs_classes_parms(next_image);
+	if (NULL == (p_expect = malloc(num_images * sizeof(*p_expect)))) {
+		perror("vs_corpus_gen: no memory for expectations");
+		return -1;
+	}
+	bench_capture = true;
+	for (i = 0; i < num_images; i++)
+		expect(bench_validate, &(images[i]), &(p_expect[i]));
+	bench_capture = false;
+
+	if (vs_corpus_write(argv[1], images, p_expect, num_images))
+		return -1;
+
+	for (i = 0; i < num_kinds; i++) {
+		printf("CORPUS: %8lu %-7s first EID 0x%04X\n",
+			kinds[i].count, (kinds[i].valid ? "valid" : "invalid"),
+			(unsigned)kinds[i].event_id);
+	}
+	printf("CORPUS: wrote %u %u-entry images to %s.\n",
+		(unsigned)num_images, (unsigned)VS_TABLE_NUM_ENTRIES, argv[1]);
+	return 0;
+
+} /* main() */
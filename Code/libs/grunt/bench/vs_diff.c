@@ -0,0 +1,537 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* vs_diff is a host-side differential test of VSC's Grunt validation
+ * program against VSA's hand-written C validation function, which it
+ * is meant to match event for event.  It links VSA_table_validate()
+ * and VSC_table_validate() against the cFS stand-ins in stub/, runs
+ * both on every table image in an enumerated class space, and
+ * reports each image on which they reach different verdicts or send
+ * different events, along with how long each took per validation.
+ * With --vsb, it checks VSC against VSB_table_validate(), the native
+ * code vsrules generated from apps/vs/vs_rules.spec, instead of VSA.
+ * With --engine E, VSC validates with VS_ENGINE_* engine number E, as
+ * it would after a VSC_SET_ENGINE_CC command, rather than the engine
+ * it starts with.  On every image it also checks that VSC's screening
+ * function, and VSA's unless --vsb, reach their validation function's
+ * verdict without sending any events.
+ *
+ * vs_diff enumerates the single and parms phases of the class space
+ * described in vs_classes.h, and with --pairs the pairs phase too.
+ * With --corpus FILE, it runs the images of a corpus vs_corpus_gen
+ * wrote instead, in place, and also counts the images on which VSC
+ * departs from the verdict and events the corpus expects.
+ *
+ * Usage: vs_diff [--pairs | --corpus FILE] [--vsb] [--engine E]
+ *                [--show N]
+ */
+
+#define _POSIX_C_SOURCE 199309L    /* for clock_gettime() */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "cfe.h"
+
+#include "vs_tablestruct.h"
+#include "vs_msgstruct.h"
+#include "vsc_msgstruct.h"    /* for vsc_table.h */
+#include "vsa_table.h"
+#include "vsb_table.h"
+#include "vsc_table.h"
+
+#include "grunt.h"
+
+#include "bench_stubs.h"
+#include "vs_classes.h"
+#include "vs_corpus.h"
+
+#define DIFF_DEFAULT_SHOW 10      /* divergences to print in full */
+#define DIFF_BLOCK_SIZE   1024    /* images compared, then timed */
+
+/* What one validator did with one image. */
+typedef struct {
+	bool          valid;
+	uint32        num_events;
+	bench_event_t events[BENCH_MAX_EVENTS];
+} diff_result_t;
+
+typedef struct {
+	const char *name;
+	unsigned long images;
+	unsigned long divergences;
+} diff_phase_t;
+
+/* Divergences counted by the event IDs the validators first differ
+ * on, 0 meaning one sent no event there.
+ */
+typedef struct {
+	uint16 vsa_eid;
+	uint16 vsc_eid;
+	unsigned long count;
+} diff_kind_t;
+
+#define DIFF_MAX_KINDS 32
+
+/* vsa_validate is VSA's validation function, or VSB's with --vsb;
+ * ref names it in the report.
+ */
+static CFE_TBL_CallbackFuncPtr_t vsa_validate, vsc_validate;
+static const char *ref = "vsa";
+
+static vs_table_t block[DIFF_BLOCK_SIZE];   /* images not yet run */
+static unsigned int block_len = 0;
+static diff_phase_t *p_phase;               /* phase block is from */
+static unsigned long show = DIFF_DEFAULT_SHOW;
+static unsigned long shown = 0;
+static uint64 vsa_ns = 0, vsc_ns = 0;       /* total time validating */
+static volatile uint32 diff_sink;           /* keeps results live */
+static diff_kind_t kinds[DIFF_MAX_KINDS];
+static unsigned int num_kinds = 0;
+static vs_corpus_t corpus;                  /* with --corpus */
+static unsigned long departures = 0;        /* from corpus's results */
+static unsigned long misscreens = 0;        /* screen verdicts missed */
+
+
+static uint64
+now_ns(void) {
+
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64)ts.tv_sec * 1000000000ULL) + (uint64)ts.tv_nsec;
+
+} /* now_ns() */
+
+
+/* run()
+ *
+ * in:     validate - validation function to run
+ *         p_image  - image to validate
+ * out:    p_result - its verdict and events
+ * return: nothing
+ */
+
+static void
+run(CFE_TBL_CallbackFuncPtr_t validate, const vs_table_t *p_image,
+	diff_result_t *p_result) {
+
+	bench_num_events = 0;
+	p_result->valid = (CFE_SUCCESS == validate((void *)p_image));
+	p_result->num_events = bench_num_events;
+	memcpy(p_result->events, bench_events, sizeof(bench_events));
+
+} /* run() */
+
+
+/* screens()
+ *
+ * in:     screen  - screening function to run
+ *         p_image - image to screen
+ *         valid   - the verdict its validation function reached
+ * out:    nothing
+ * return: true if the screening function reached the same verdict
+ *         and sent no events, else false.
+ */
+
+static bool
+screens(bool (*screen)(const vs_table_t *), const vs_table_t *p_image,
+	bool valid) {
+
+	bench_num_events = 0;
+	return ((screen(p_image) == valid) && (bench_num_events == 0));
+
+} /* screens() */
+
+
+/* first_difference()
+ *
+ * in:     p_a, p_b - two validators' results for the same image
+ * out:    nothing
+ * return: index of the first event they differ on, their number of
+ *         events if only their verdicts differ, or -1 if they reached
+ *         the same verdict with the same events.
+ */
+
+static int
+first_difference(const diff_result_t *p_a, const diff_result_t *p_b) {
+
+	uint32 i;
+
+	for (i = 0; (i < p_a->num_events) && (i < p_b->num_events) &&
+		(i < BENCH_MAX_EVENTS); i++) {
+		if ((p_a->events[i].event_id != p_b->events[i].event_id) ||
+			(p_a->events[i].event_type !=
+				p_b->events[i].event_type) ||
+			strcmp(p_a->events[i].message,
+				p_b->events[i].message))
+			return (int)i;
+	}
+	if ((p_a->num_events != p_b->num_events) ||
+		(p_a->valid != p_b->valid))
+		return (int)i;
+	return -1;
+
+} /* first_difference() */
+
+
+/* tally()
+ *
+ * in:     p_vsa, p_vsc - the validators' results for an image they
+ *                        disagree on
+ *         i            - index of the first event they differ on
+ * out:    kinds        - the kind of divergence counted
+ * return: nothing
+ *
+ * Counts divergences by the pair of event IDs the validators first
+ * differ on, so that many images failing for one reason read as one
+ * line in the summary.
+ */
+
+static void
+tally(const diff_result_t *p_vsa, const diff_result_t *p_vsc, int i) {
+
+	uint16 vsa_eid = ((uint32)i < p_vsa->num_events) ?
+		p_vsa->events[i].event_id : 0;
+	uint16 vsc_eid = ((uint32)i < p_vsc->num_events) ?
+		p_vsc->events[i].event_id : 0;
+	unsigned int k;
+
+	for (k = 0; k < num_kinds; k++) {
+		if ((kinds[k].vsa_eid == vsa_eid) &&
+			(kinds[k].vsc_eid == vsc_eid))
+			break;
+	}
+	if (k == num_kinds) {
+		if (num_kinds == DIFF_MAX_KINDS) return;
+		kinds[num_kinds].vsa_eid = vsa_eid;
+		kinds[num_kinds].vsc_eid = vsc_eid;
+		kinds[num_kinds++].count = 0;
+	}
+	kinds[k].count++;
+
+} /* tally() */
+
+
+/* print_result()
+ *
+ * in:     name     - validator name
+ *         p_result - its result
+ * out:    nothing
+ * return: nothing
+ */
+
+static void
+print_result(const char *name, const diff_result_t *p_result) {
+
+	uint32 i;
+
+	printf("  %s: %s, %u events\n", name,
+		(p_result->valid ? "valid" : "invalid"),
+		(unsigned)p_result->num_events);
+	for (i = 0; (i < p_result->num_events) && (i < BENCH_MAX_EVENTS);
+		i++) {
+		printf("    %3u/%u %s\n",
+			(unsigned)p_result->events[i].event_id,
+			(unsigned)p_result->events[i].event_type,
+			p_result->events[i].message);
+	}
+
+} /* print_result() */
+
+
+/* print_divergence()
+ *
+ * in:     p_image - image the validators disagree on
+ *         p_vsa   - VSA's result
+ *         p_vsc   - VSC's result
+ * out:    nothing
+ * return: nothing
+ */
+
+static void
+print_divergence(const vs_table_t *p_image, const diff_result_t *p_vsa,
+	const diff_result_t *p_vsc) {
+
+	const vs_entry_t *p_entry;
+	unsigned int i;
+
+	printf("DIFF: %s image:\n", p_phase->name);
+	for (i = 0; i < VS_TABLE_NUM_ENTRIES; i++) {
+		p_entry = &(p_image->entries[i]);
+		printf("  entry %u: parm 0x%02X pad %02X %02X %02X "
+			"bounds 0x%08X 0x%08X\n", i + 1,
+			(unsigned)p_entry->parm_id, (unsigned)p_entry->pad[0],
+			(unsigned)p_entry->pad[1], (unsigned)p_entry->pad[2],
+			(unsigned)p_entry->bound_low,
+			(unsigned)p_entry->bound_high);
+	}
+	print_result(ref, p_vsa);
+	print_result("vsc", p_vsc);
+
+} /* print_divergence() */
+
+
+/* departs()
+ *
+ * in:     p_result - a validator's result for a corpus image
+ *         p_expect - what the corpus expects of that image
+ * out:    nothing
+ * return: true if the validator reached a different verdict or sent
+ *         different events than expected, else false.
+ */
+
+static bool
+departs(const diff_result_t *p_result, const vs_corpus_expect_t *p_expect) {
+
+	uint32 i;
+
+	if ((p_result->valid != (bool)p_expect->valid) ||
+		(p_result->num_events != p_expect->num_events))
+		return true;
+	for (i = 0; (i < p_result->num_events) &&
+		(i < VS_CORPUS_MAX_EVENTS) && (i < BENCH_MAX_EVENTS); i++) {
+		if ((p_result->events[i].event_id !=
+				p_expect->events[i].event_id) ||
+			(p_result->events[i].event_type !=
+				p_expect->events[i].event_type))
+			return true;
+	}
+	return false;
+
+} /* departs() */
+
+
+/* run_block()
+ *
+ * in:     images - images to run
+ *         expect - what a corpus expects of each, or NULL
+ *         n      - number of images
+ * out:    nothing
+ * return: nothing
+ *
+ * Compares the validators on every image, capturing their events,
+ * then times each over all the images without capturing so that
+ * formatting the captures doesn't count against either.
+ */
+
+static void
+run_block(const vs_table_t *images, const vs_corpus_expect_t *expect,
+	unsigned int n) {
+
+	static diff_result_t vsa, vsc;   /* too big for the stack */
+	uint32 valid = 0;
+	uint64 start;
+	unsigned int i;
+	int e;
+
+	bench_capture = true;
+	for (i = 0; i < n; i++) {
+		run(vsa_validate, &(images[i]), &vsa);
+		run(vsc_validate, &(images[i]), &vsc);
+		if (expect && departs(&vsc, &(expect[i]))) departures++;
+		if (!screens(VSC_table_screen, &(images[i]), vsc.valid) ||
+			(strcmp(ref, "vsb") && !screens(VSA_table_screen,
+				&(images[i]), vsa.valid)))
+			misscreens++;
+		if (-1 == (e = first_difference(&vsa, &vsc))) continue;
+		tally(&vsa, &vsc, e);
+		p_phase->divergences++;
+		if (shown++ < show) print_divergence(&(images[i]), &vsa, &vsc);
+	}
+	bench_capture = false;
+
+	start = now_ns();
+	for (i = 0; i < n; i++)
+		valid += (CFE_SUCCESS == vsa_validate((void *)&(images[i])));
+	vsa_ns += now_ns() - start;
+
+	start = now_ns();
+	for (i = 0; i < n; i++)
+		valid += (CFE_SUCCESS == vsc_validate((void *)&(images[i])));
+	vsc_ns += now_ns() - start;
+
+	diff_sink = valid;
+	p_phase->images += n;
+
+} /* run_block() */
+
+
+/* flush()
+ *
+ * in:     block - images to run
+ * out:    block - emptied
+ * return: nothing
+ */
+
+static void
+flush(void) {
+
+	run_block(block, NULL, block_len);
+	block_len = 0;
+
+} /* flush() */
+
+
+/* next_image()
+ *
+ * in:     block - images not yet run
+ * out:    block - a new zeroed image added, earlier ones run if full
+ * return: the new image.
+ */
+
+static vs_table_t *
+next_image(void) {
+
+	if (block_len == DIFF_BLOCK_SIZE) flush();
+	memset(&(block[block_len]), 0, sizeof(block[block_len]));
+	return &(block[block_len++]);
+
+} /* next_image() */
+
+
+/* run_corpus()
+ *
+ * in:     corpus - a mapped corpus
+ * out:    nothing
+ * return: nothing
+ *
+ * Runs the corpus's images where they lie in the mapping, a block at
+ * a time, as the other phases run theirs.
+ */
+
+static void
+run_corpus(void) {
+
+	uint32 i, n;
+
+	for (i = 0; i < corpus.num_images; i += n) {
+		n = corpus.num_images - i;
+		if (n > DIFF_BLOCK_SIZE) n = DIFF_BLOCK_SIZE;
+		run_block(&(corpus.images[i]), &(corpus.expect[i]), n);
+	}
+
+} /* run_corpus() */
+
+
+int
+main(int argc, char *argv[]) {
+
+	diff_phase_t phases[] = {
+		{ "single", 0, 0 }, { "parms", 0, 0 }, { "pairs", 0, 0 },
+		{ "corpus", 0, 0 },
+	};
+	void (*phase_fns[])(vs_next_image_t) = {
+		vs_classes_single, vs_classes_parms, vs_classes_pairs, NULL,
+	};
+	unsigned int first_phase = 0;
+	unsigned int num_phases = 2;   /* pairs only with --pairs */
+	const char *corpus_path = NULL;
+	CFE_TBL_Handle_t handle;
+	unsigned long images = 0, divergences = 0;
+	unsigned long engine = 0;      /* 0 (VS_ENGINE_C) for VSC's default */
+	unsigned int i;
+	char *end;
+
+	for (i = 1; i < (unsigned int)argc; i++) {
+		if (!strcmp(argv[i], "--pairs") && !corpus_path) {
+			num_phases = 3;
+		} else if (!strcmp(argv[i], "--corpus") &&
+			((i + 1) < (unsigned int)argc) && (num_phases == 2)) {
+			corpus_path = argv[++i];
+			first_phase = 3;
+			num_phases  = 4;   /* the corpus phase alone */
+		} else if (!strcmp(argv[i], "--vsb")) {
+			ref = "vsb";
+		} else if (!strcmp(argv[i], "--engine") &&
+			((i + 1) < (unsigned int)argc)) {
+			engine = strtoul(argv[++i], &end, 10);
+			if (*end || (engine == VS_ENGINE_C)) break;
+		} else if (!strcmp(argv[i], "--show") &&
+			((i + 1) < (unsigned int)argc)) {
+			show = strtoul(argv[++i], &end, 10);
+			if (*end) break;
+		} else {
+			break;
+		}
+	}
+	if (i < (unsigned int)argc) {
+		fprintf(stderr, "Usage:\n\tvs_diff [--pairs | --corpus FILE] "
+			"[--vsb] [--engine E] [--show N]\n");
+		return -1;
+	}
+	if (corpus_path && vs_corpus_map(corpus_path, &corpus)) return -1;
+
+	/* Set up each validation function as its app would. */
+	GRUNT_Init();
+	if ((CFE_SUCCESS != (strcmp(ref, "vsb") ? VSA_table_init(&handle) :
+		VSB_table_init(&handle))) || !bench_validate) {
+		fprintf(stderr, "vs_diff: %s table init failed\n", ref);
+		return -1;
+	}
+	vsa_validate   = bench_validate;
+	bench_validate = NULL;
+	if ((CFE_SUCCESS != VSC_table_init(&handle)) || !bench_validate) {
+		fprintf(stderr, "vs_diff: VSC_table_init() failed\n");
+		return -1;
+	}
+	vsc_validate = bench_validate;
+	if (engine && ((engine > 0xFF) ||
+		!VSC_table_set_engine((uint8)engine))) {
+		fprintf(stderr, "vs_diff: VSC has no engine %lu\n", engine);
+		return -1;
+	}
+
+	for (i = first_phase; i < num_phases; i++) {
+		p_phase = &(phases[i]);
+		if (phase_fns[i]) {
+			phase_fns[i](next_image);
+			flush();
+		} else {
+			run_corpus();
+		}
+		printf("DIFF: %-6s %10lu images, %8lu divergences\n",
+			p_phase->name, p_phase->images, p_phase->divergences);
+		images      += p_phase->images;
+		divergences += p_phase->divergences;
+	}
+	if (divergences > show) {
+		printf("DIFF: printed %lu of %lu divergences in full.\n",
+			show, divergences);
+	}
+	for (i = 0; i < num_kinds; i++) {
+		printf("DIFF: %8lu first differ at %s EID %u, vsc EID %u\n",
+			kinds[i].count, ref, (unsigned)kinds[i].vsa_eid,
+			(unsigned)kinds[i].vsc_eid);
+	}
+
+	printf("DIFF: %lu images, %lu divergences.\n", images, divergences);
+	printf("DIFF: %s %.1f ns/validation, vsc %.1f ns/validation, "
+		"vsc/%s %.2f\n", ref, (double)vsa_ns / (double)images,
+		(double)vsc_ns / (double)images, ref,
+		(vsa_ns ? (double)vsc_ns / (double)vsa_ns : 0.0));
+
+	if (corpus_path) {
+		printf("DIFF: vsc departs from %s on %lu images.\n",
+			corpus_path, departures);
+		vs_corpus_unmap(&corpus);
+	}
+	printf("DIFF: screening misses the verdict on %lu images.\n",
+		misscreens);
+
+	return ((divergences || departures || misscreens) ? 1 : 0);
+
+} /* main() */
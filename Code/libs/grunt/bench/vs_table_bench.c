@@ -0,0 +1,256 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* vs_table_bench times the VSA and VSB apps' validation functions on
+ * tables of whatever size it's built for.  The build makes one copy
+ * for each of 4, 64, and 512 entries, so that comparing their times
+ * per entry shows how validation scales with table size.  It also
+ * makes copies of each built with VSA_DELTA_VALIDATION, which should
+ * spend far less time on images that change little, and with
+ * VSA_RESULT_CACHE, which should spend little on any image it has
+ * seen, and with VSA_PARALLEL_VF, which should spend less on big
+ * tables given idle cores.  Each image is validated over and over, so
+ * the cache always hits.  Tables of more than eight entries need the
+ * wide parm IDs to define a different parm in every entry.  VSC's
+ * Grunt program handles only the default four-entry table, so it
+ * isn't timed here.
+ *
+ * Usage: vs_table_bench [entries]
+ *
+ * where entries is the number of table entries to validate in all,
+ * for each image and app; the default is BENCH_DEFAULT_ENTRIES.
+ */
+
+#define _POSIX_C_SOURCE 199309L    /* for clock_gettime() */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "cfe.h"
+
+#include "vs_tablestruct.h"
+#include "vsa_table.h"
+#include "vsb_table.h"
+
+#include "bench_stubs.h"
+
+#if (VS_TABLE_NUM_ENTRIES > 8) && !defined(VS_PARM_WIDE_MIN)
+#error "vs_table_bench needs wide parm IDs for tables of over 8 entries"
+#endif
+
+#define BENCH_DEFAULT_ENTRIES 100000000UL
+
+/* The images to time.  One turns out invalid because its last entry
+ * redefines its first's parm, which sends VSA down its detailed path.
+ * Each image is timed alternating with its alt image, so that the
+ * one-change image shows the cost of a load that changes one entry.
+ */
+typedef enum {
+	bi_unused,      /* all entries unused */
+	bi_half,        /* first half in use, rest unused */
+	bi_full,        /* all entries in use */
+	bi_redef,       /* all in use, last redefines the first's parm */
+	bi_one,         /* all in use, middle entry's high bound lowered */
+	BENCH_NUM_IMAGES
+} bench_image_id_t;
+
+static const struct {
+	const char      *name;
+	bool             valid;
+	bench_image_id_t alt;
+} bench_image_info[BENCH_NUM_IMAGES] = {
+	{ "all unused",   true,  bi_unused },
+	{ "half in use",  true,  bi_half   },
+	{ "all in use",   true,  bi_full   },
+	{ "redefinition", false, bi_redef  },
+	{ "one change",   true,  bi_full   },
+};
+
+static const vs_parm_id_t named_parms[] = {
+	VS_PARM_APE, VS_PARM_NORTH, VS_PARM_BAT, VS_PARM_SOUTH,
+	VS_PARM_CAT, VS_PARM_EAST, VS_PARM_DOG, VS_PARM_WEST,
+};
+
+static vs_table_t bench_images[BENCH_NUM_IMAGES];
+static volatile uint32 bench_sink;        /* keeps results live */
+
+
+/* bench_set_entry()
+ *
+ * in:     p_image - image to fill in
+ *         i       - index of entry to put in use
+ * out:    p_image - i'th entry defines a parm, with valid bounds
+ * return: nothing
+ *
+ * Gives each entry index its own parm, alternating between animals
+ * and directions.
+ */
+
+static void
+bench_set_entry(vs_table_t *p_image, unsigned int i) {
+
+	vs_entry_t *p_entry = &(p_image->entries[i]);
+
+#ifdef VS_PARM_WIDE_MIN
+	if (i >= (sizeof(named_parms) / sizeof(named_parms[0]))) {
+		p_entry->parm_id = (vs_parm_id_t)((i % 2) ?
+			(VS_PARM_WIDE_DIRECTION_MIN + (i / 2)) :
+			(VS_PARM_WIDE_MIN + (i / 2)));
+	} else
+#endif
+	p_entry->parm_id = named_parms[i];
+
+	if (VS_PARM_IS_ANIMAL(p_entry->parm_id)) {
+		p_entry->bound_low  = VS_PARM_ANIMAL_MIN;
+		p_entry->bound_high = VS_PARM_ANIMAL_MAX;
+	} else {
+		p_entry->bound_low  = VS_PARM_DIRECTION_MIN;
+		p_entry->bound_high = VS_PARM_DIRECTION_MAX;
+	}
+
+} /* bench_set_entry() */
+
+
+static uint64
+now_ns(void) {
+
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64)ts.tv_sec * 1000000000ULL) + (uint64)ts.tv_nsec;
+
+} /* now_ns() */
+
+
+/* measure()
+ *
+ * in:     validate    - validation function to time
+ *         p_image     - image to validate
+ *         p_alt       - image to validate every other time
+ *         validations - number of validations to time
+ * out:    nothing
+ * return: nanoseconds per validation.
+ */
+
+static double
+measure(CFE_TBL_CallbackFuncPtr_t validate, const vs_table_t *p_image,
+	const vs_table_t *p_alt, unsigned long validations) {
+
+	const vs_table_t *p_images[2] = { p_image, p_alt };
+	unsigned long v;
+	uint64 start_ns, stop_ns;
+	uint32 valid = 0;
+
+	valid += (CFE_SUCCESS == validate((void *)p_alt));    /* warm up */
+
+	start_ns = now_ns();
+	for (v = 0; v < validations; v++)
+		valid += (CFE_SUCCESS == validate((void *)p_images[v & 1]));
+	stop_ns = now_ns();
+	bench_sink = valid;
+
+	return (double)(stop_ns - start_ns) / (double)validations;
+
+} /* measure() */
+
+
+int
+main(int argc, char *argv[]) {
+
+	CFE_TBL_Handle_t handle;
+	CFE_TBL_CallbackFuncPtr_t vsa_validate, vsb_validate;
+	unsigned long entries = BENCH_DEFAULT_ENTRIES;
+	unsigned long validations;
+	vs_entry_t *p_entry;
+	unsigned int i;
+	double vsa_ns, vsb_ns;
+
+	if (argc > 2) {
+		fprintf(stderr, "Usage:\n\tvs_table_bench [entries]\n");
+		return -1;
+	}
+	if ((argc == 2) && !(entries = strtoul(argv[1], NULL, 10))) {
+		fprintf(stderr, "vs_table_bench: bad entry count %s\n",
+			argv[1]);
+		return -1;
+	}
+	validations = (entries + VS_TABLE_NUM_ENTRIES - 1) /
+		VS_TABLE_NUM_ENTRIES;
+
+	/* Capture each app's validation function as it registers. */
+	if ((CFE_SUCCESS != VSA_table_init(&handle)) || !bench_validate) {
+		fprintf(stderr, "vs_table_bench: VSA_table_init() failed\n");
+		return -1;
+	}
+	vsa_validate   = bench_validate;
+	bench_validate = NULL;
+	if ((CFE_SUCCESS != VSB_table_init(&handle)) || !bench_validate) {
+		fprintf(stderr, "vs_table_bench: VSB_table_init() failed\n");
+		return -1;
+	}
+	vsb_validate = bench_validate;
+
+	memset(bench_images, 0, sizeof(bench_images));
+	for (i = 0; i < VS_TABLE_NUM_ENTRIES; i++) {
+		if (i < (VS_TABLE_NUM_ENTRIES / 2))
+			bench_set_entry(&(bench_images[bi_half]), i);
+		bench_set_entry(&(bench_images[bi_full]), i);
+		bench_set_entry(&(bench_images[bi_redef]), i);
+		bench_set_entry(&(bench_images[bi_one]), i);
+	}
+	bench_images[bi_redef].entries[VS_TABLE_NUM_ENTRIES - 1] =
+		bench_images[bi_redef].entries[0];
+	p_entry = &(bench_images[bi_one].entries[VS_TABLE_NUM_ENTRIES / 2]);
+	p_entry->bound_high = p_entry->bound_low;
+
+	/* Don't time VSA reaching the wrong verdict. */
+	for (i = 0; i < BENCH_NUM_IMAGES; i++) {
+		if ((CFE_SUCCESS == vsa_validate(&(bench_images[i]))) !=
+			bench_image_info[i].valid) {
+			fprintf(stderr, "vs_table_bench: VSA misjudges image "
+				"\"%s\"\n", bench_image_info[i].name);
+			return -1;
+		}
+	}
+
+	printf("%u entries, %u-bit parm IDs, %lu validations per image%s\n",
+		(unsigned)VS_TABLE_NUM_ENTRIES, (unsigned)VS_PARM_ID_BITS,
+		validations,
+#if defined(VSA_DELTA_VALIDATION)
+		", VSA delta validation"
+#elif defined(VSA_RESULT_CACHE)
+		", VSA result cache"
+#elif defined(VSA_PARALLEL_VF)
+		", VSA parallel validation"
+#else
+		""
+#endif
+		);
+	printf("%-14s %14s %14s %14s\n", "image", "vsa ns/valid.",
+		"vsa ns/entry", "vsb ns/valid.");
+	for (i = 0; i < BENCH_NUM_IMAGES; i++) {
+		vsa_ns = measure(vsa_validate, &(bench_images[i]),
+			&(bench_images[bench_image_info[i].alt]), validations);
+		vsb_ns = measure(vsb_validate, &(bench_images[i]),
+			&(bench_images[bench_image_info[i].alt]), validations);
+		printf("%-14s %14.1f %14.2f %14.1f\n",
+			bench_image_info[i].name, vsa_ns,
+			vsa_ns / VS_TABLE_NUM_ENTRIES, vsb_ns);
+	}
+
+	return 0;
+
+} /* main() */
@@ -26,6 +26,7 @@ typedef uint16 grunt_pc_t;
 
 #define GRUNT_NUM_MAX UINT32_MAX
 #define GRUNT_PC_MAX  UINT16_MAX
+#define GRUNT_STRING_MAX UINT16_MAX
 
 typedef enum {
 	gt_bool,
@@ -34,14 +35,22 @@ typedef enum {
 	gt_pc,
 } grunt_value_type_t;
 
+/* GRUNT_TYPE_BIT(t) is type t's bit in a set of types, so that one
+ * mask test checks a value against several types.
+ */
+#define GRUNT_TYPE_BIT(t) (1u << (t))
+
+/* A value without its type. */
+typedef union {
+	grunt_boolean_t  b;
+	grunt_number_t num;
+	grunt_string_t str;
+	grunt_pc_t      pc;
+} grunt_payload_t;
+
 typedef struct {
 	grunt_value_type_t  type;
-	union {
-		grunt_boolean_t  b;
-		grunt_number_t num;
-		grunt_string_t str;
-		grunt_pc_t      pc;
-	} val;
+	grunt_payload_t     val;
 } grunt_value_t;
 
 /* Some Grunt instructions require a repitition count argument.
@@ -54,6 +63,11 @@ typedef struct {
 typedef uint16 grunt_rep_t;        /* repetition count */
 #define GRUNT_REP_MAX UINT16_MAX   /* maximum possible repetition count */
 
+/* The arg and control stacks share a single array of this many
+ * elements.  The unit tests assume GRUNT_STACK_SIZE is an even number.
+ */
+#define GRUNT_STACK_SIZE (2*16)      /* max number of elements on stack */
+
 /* Grunt opcodes */
 #define GRUNT_OP_ADD     0x01   /* ADD    no literal   */
 #define GRUNT_OP_AND     0x02   /* AND    repititions  */
@@ -118,10 +132,514 @@ typedef struct {
 #define ROLL(r)   { .op = GRUNT_OP_ROLL, .arg.rep = (r) }
 #define SUB       { .op = GRUNT_OP_SUB }
 
+/* The packed instruction encoding.  Programs written with the macros
+ * above occupy a full grunt_instruction_t per instruction.
+ * GRUNT_Pack() loads such a program into this denser form, one 32-bit
+ * word per instruction:
+ *
+ *   bits  0-7   opcode
+ *   bits  8-15  literal type tag (literal instructions only)
+ *   bits 16-31  repetition count, or literal value
+ *
+ * Number literals too big for 16 bits live in a side pool of 32-bit
+ * numbers; their tag has GRUNT_PACKED_POOLED set and their operand
+ * is an index into the pool.  In the copies of programs GRUNT_Verify()
+ * keeps, the tag of each OUTPUT and FORMAT holds the types the
+ * verifier proved it takes, since the engine that runs them keeps no
+ * types of its own.
+ */
+typedef uint32 grunt_packed_t;
+
+#define GRUNT_PACKED_OP(w)      ((grunt_opcode_t)((w) & 0xFF))
+#define GRUNT_PACKED_TAG(w)     ((uint8)(((w) >> 8) & 0xFF))
+#define GRUNT_PACKED_OPERAND(w) ((uint16)((w) >> 16))
+#define GRUNT_PACKED_WORD(op, tag, operand) \
+	((grunt_packed_t)(op) | ((grunt_packed_t)(tag) << 8) | \
+	 ((grunt_packed_t)(operand) << 16))
+
+#define GRUNT_PACKED_POOLED   0x80   /* operand indexes literal pool */
+#define GRUNT_PACKED_BADTYPE  0x7F   /* literal had an invalid type */
+
+/* Superinstructions.  GRUNT_Pack() rewrites the opcode of the first
+ * word of each of these common sequences to one of these opcodes,
+ * keeping that word's tag and operand.  It leaves the rest of the
+ * sequence's words alone, so jumps into the middle of a sequence
+ * still work and every instruction keeps its program counter.  These
+ * opcodes appear only in packed code; GRUNT_Run() treats them as
+ * invalid.
+ */
+#define GRUNT_OP_EQN      0x17   /* PUSHN n; EQ(r)              */
+#define GRUNT_OP_DUPEQN   0x18   /* DUP(1); PUSHN n; EQ(2)      */
+#define GRUNT_OP_NOTJMPIF 0x19   /* NOT; JMPIF l                */
+#define GRUNT_OP_INPUTLTN 0x1A   /* INPUT(r); PUSHN n; LT       */
+#define GRUNT_OP_INPUTGTN 0x1B   /* INPUT(r); PUSHN n; GT       */
+
+/* LOOKUP and SWITCH are the instructions that span several elements
+ * of a program.  "LOOKUP(n)" is followed by a table of n key/string
+ * pairs, each a PUSHN(k) and a PUSHS(s), and then a PUSHS(d).  It
+ * pops a number and pushes the string s of the first pair whose key
+ * k equals it, or d if none does, then continues after the table.
+ * The table's instructions run as themselves only if a JMPIF or CALL
+ * lands on them.  GRUNT_Optimize() turns chains of compare-and-branch
+ * into LOOKUPs.
+ */
+#define GRUNT_OP_LOOKUP   0x1C   /* LOOKUP repetitions, then table */
+
+#define LOOKUP(r) { .op = GRUNT_OP_LOOKUP, .arg.rep = (r) }
+
+/* SWITCH likewise carries a table, of n JMPIF(l) entries after
+ * "SWITCH(n)".  It pops a number X; if X is less than n it jumps
+ * to the target of entry X, l instructions past that entry, and
+ * otherwise continues after the table.  Entries may jump as little as
+ * 1, to the next instruction.  SWITCH dispatches on a dense range of
+ * keys in constant time where a chain of compare-and-branch takes
+ * time linear in the number of keys.
+ */
+#define GRUNT_OP_SWITCH   0x1D   /* SWITCH repetitions, then table */
+
+#define SWITCH(r) { .op = GRUNT_OP_SWITCH, .arg.rep = (r) }
+
+/* REPEAT and END bracket a loop body, which may hold further loops.
+ * "REPEAT(n)" runs the instructions up to its matching END n times,
+ * n at least 1.  REPEAT pushes the pc of the body and the count of
+ * runs left onto the control stack, two slots; END spends one run and
+ * jumps back to the body until none are left, then pops both.  The
+ * count is a literal that no instruction can raise, so loops keep
+ * Grunt's termination guarantee.  A body may CALL routines and HALT,
+ * but not RETURN, and the verifier rejects jumps into or out of one.
+ */
+#define GRUNT_OP_REPEAT   0x1E   /* REPEAT repetitions */
+#define GRUNT_OP_END      0x1F   /* end of loop body */
+
+#define REPEAT(r) { .op = GRUNT_OP_REPEAT, .arg.rep = (r) }
+#define END       { .op = GRUNT_OP_END }
+
+/* INPUTREC and INPUTZ read many bytes of input in one instruction.
+ * "INPUTREC(layout)" reads a record of up to GRUNT_INPUTREC_MAX_FIELDS
+ * numbers and pushes each in turn, as that many INPUTs would.  Each
+ * 2-bit group of layout, from the low bits up, gives the width of a
+ * field: 1, 2, or 3 for 1, 2, or 4 bytes; the first group of 0 ends
+ * the record.  "INPUTZ(n)" reads n bytes and pushes TRUE if
+ * they are all zero.  Each checks the bounds of the whole read once,
+ * before it reads anything.
+ */
+#define GRUNT_OP_INPUTREC 0x20   /* INPUTREC layout */
+#define GRUNT_OP_INPUTZ   0x21   /* INPUTZ   repetitions */
+
+#define GRUNT_INPUTREC_MAX_FIELDS 8
+
+/* The layout bits of field i of width w bytes, and the width in
+ * bytes of field i of layout l, 0 past the last field.
+ */
+#define GRUNT_INPUTREC_FIELD(i, w) \
+	((grunt_rep_t)((((w) == 4) ? 3 : (w)) << (2 * (i))))
+#define GRUNT_INPUTREC_WIDTH(l, i) \
+	(((((l) >> (2 * (i))) & 3) == 3) ? 4 : (((l) >> (2 * (i))) & 3))
+
+#define INPUTREC(l) { .op = GRUNT_OP_INPUTREC, .arg.rep = (l) }
+#define INPUTZ(r)   { .op = GRUNT_OP_INPUTZ, .arg.rep = (r) }
+
+/* FORMAT builds a whole message from a template in one instruction.
+ * "FORMAT(n)" pops a string, the template, and then a value for each
+ * of the n '%' placeholders in it, in turn.  It appends the template
+ * to the output queue with each placeholder replaced by its value,
+ * formatted as OUTPUT would format it, so "PUSHS(t); FORMAT(2)" with
+ * t = "% of %" does the work of "OUTPUT; PUSHS(" of "); OUTPUT;
+ * OUTPUT" in one step.  n may be at most GRUNT_FORMAT_MAX_VALUES, so
+ * that 2 bits for each value's type fit in one byte.  A template with
+ * other than n placeholders is an error, and FORMAT leaves the output
+ * queue unchanged if the whole message won't fit.
+ */
+#define GRUNT_OP_FORMAT   0x22   /* FORMAT repetitions */
+
+#define GRUNT_FORMAT_MAX_VALUES 4
+
+#define FORMAT(r)   { .op = GRUNT_OP_FORMAT, .arg.rep = (r) }
+
+/* CLASSIFY looks a number up in the VS parm ID classification table
+ * of vs_parmclass.h, in one step where a chain of compares takes
+ * one per class.  "CLASSIFY(s)" pops a number X and pushes X's
+ * row: the highest and then the lowest valid bound, as numbers, the
+ * string naming X, and on top X's class, a VS_PARM_CLASS_* number.
+ * The names are the VS_PARM_NUM_NAMES strings numbered from s, in
+ * VS_PARM_NAME_* order, so a program must hold them all.
+ */
+#define GRUNT_OP_CLASSIFY 0x23   /* CLASSIFY first name string */
+
+#define CLASSIFY(s) { .op = GRUNT_OP_CLASSIFY, .arg.rep = (s) }
+
+/* A packed program and the caller-supplied storage that holds it. */
+typedef struct {
+	grunt_packed_t *code;             /* one word per instruction */
+	grunt_number_t *pool;             /* 32-bit number literals */
+	grunt_pc_t      max_instructions; /* capacity of code[] */
+	grunt_pc_t      num_instructions; /* instructions in code[] */
+	uint16          max_literals;     /* capacity of pool[] */
+	uint16          num_literals;     /* literals in pool[] */
+} grunt_packed_program_t;
+
+/* An optimized program and the caller-supplied storage that holds it.
+ * GRUNT_Optimize() sets origin[pc] to the pc of the instruction in
+ * the original program that code[pc] came from, with
+ * GRUNT_OPTIMIZE_REWRITTEN set if the optimizer changed it or made it
+ * up rather than copying it, and GRUNT_OPTIMIZE_INLINED set if it is
+ * a copy of a leaf subroutine's instruction standing in place of a
+ * CALL.  origin may be NULL.  Callers set flags:
+ * GRUNT_OPTIMIZE_SYMBOLIC says number literals are names, not values,
+ * so the optimizer folds only comparisons of a literal with itself,
+ * as gruntasm needs for C constants it can't evaluate.
+ */
+#define GRUNT_OPTIMIZE_SYMBOLIC   0x01
+#define GRUNT_OPTIMIZE_REWRITTEN  0x8000
+#define GRUNT_OPTIMIZE_INLINED    0x4000
+
+typedef struct {
+	grunt_instruction_t *code;             /* optimized instructions */
+	grunt_pc_t          *origin;           /* source of each, or NULL */
+	grunt_pc_t           max_instructions; /* capacity of code[] */
+	grunt_pc_t           num_instructions; /* instructions in code[] */
+	uint32               flags;            /* GRUNT_OPTIMIZE_* */
+} grunt_optimized_program_t;
+
+/* The serialized program format.  GRUNT_Serialize() writes a program
+ * and its string table as a byte string the ground can uplink, and
+ * GRUNT_Deserialize() reads one back.  All multi-byte fields are
+ * big-endian.
+ *
+ *   header   'G', 'R', version 1, a reserved 0 byte, the number of
+ *            instructions (16 bits), and the number of strings (16)
+ *   code     each instruction as an opcode byte, holding the opcode
+ *            in bits 0-5, 0 in bit 6, and in bit 7 whether an
+ *            operand follows as a varint; no operand means 0
+ *   strings  each string as a varint length and its bytes, no NUL
+ *   trailer  CRC-32 (as zlib's) of every byte before it
+ *
+ * A varint holds a number 7 bits per byte, low bits first, with the
+ * top bit set in every byte but the last.  An instruction's operand
+ * is its repetition count or, for CALL, JMPIF, PUSHB, PUSHN, and
+ * PUSHS, the value of its literal, whose type its opcode implies.
+ * Most instructions take one or two bytes.
+ */
+#define GRUNT_SERIAL_MAGIC0      'G'
+#define GRUNT_SERIAL_MAGIC1      'R'
+#define GRUNT_SERIAL_VERSION     1
+#define GRUNT_SERIAL_HEADER_SIZE 8
+#define GRUNT_SERIAL_CRC_SIZE    4
+#define GRUNT_SERIAL_OP_MASK     0x3F   /* opcode bits */
+#define GRUNT_SERIAL_RESERVED    0x40   /* must be 0 */
+#define GRUNT_SERIAL_OPERAND     0x80   /* operand follows */
+
+/* A deserialized program and the caller-supplied storage that holds
+ * it and its string table.  strings[s] points into string_space[],
+ * which needs room for every string and its NUL.
+ */
+typedef struct {
+	grunt_instruction_t *code;             /* instructions */
+	const char         **strings;          /* string table */
+	grunt_rep_t         *string_lengths;   /* strlen() of each */
+	char                *string_space;     /* the strings' bytes */
+	grunt_pc_t           max_instructions; /* capacity of code[] */
+	grunt_string_t       max_strings;      /* of strings[], lengths[] */
+	uint32               max_string_space; /* of string_space[] */
+	grunt_pc_t           num_instructions; /* instructions in code[] */
+	grunt_string_t       num_strings;      /* strings in strings[] */
+} grunt_serial_program_t;
+
+/* The state of one Grunt virtual machine.  GRUNT_Run() uses a
+ * single machine the library owns, so only one task may call it at a
+ * time.  Tasks that want to run Grunt programs concurrently can each
+ * keep their own grunt_vm_t and call GRUNT_RunCtx() instead.  The
+ * fields the interpreter touches on every instruction come first, so
+ * they share as few cache lines as possible; the threaded engine's
+ * handler table, consulted once per instruction, comes last.
+ * Callers should treat the fields as private to the interpreter.
+ */
+#define GRUNT_OUTPUT_QUEUE_SIZE         CFE_MISSION_EVS_MAX_MESSAGE_LENGTH
+#define GRUNT_THREADED_MAX_INSTRUCTIONS 1024
+
+/* A record view tells the input queue that a program reads its
+ * input as a run of fixed-size records beginning at a given offset,
+ * such as the entries of a table.  The input queue then checks each
+ * record's bounds once, when the program starts reading it, rather
+ * than on each INPUT.  A view changes only how fast INPUT runs, not
+ * what it does.  A size of 0 means no view.
+ */
+typedef struct {
+	grunt_rep_t offset;   /* offset of the first record in the input */
+	grunt_rep_t size;     /* size of each record in bytes */
+} grunt_record_view_t;
+
+/* The engines GRUNT_SetEngine() can have a VM run programs on.  By
+ * default, a VM runs each program on the fastest engine that can run
+ * it: the register machine or verified stack engine for programs
+ * GRUNT_Verify() has accepted, and the threaded engine, where the
+ * compiler supports it, for the rest.  The others pin the VM to one
+ * checked engine for every program, so callers can compare engines
+ * in the same build.  Builds without the threaded engine run
+ * GRUNT_ENGINE_THREADED requests on the switch engine.
+ */
+typedef enum {
+	GRUNT_ENGINE_AUTO,
+	GRUNT_ENGINE_SWITCH,
+	GRUNT_ENGINE_THREADED,
+} grunt_engine_t;
+
+/* An event sink receives the events a VM's program flushes instead of
+ * EVS.  It gets the sink argument given to GRUNT_SetEventSink(), the
+ * event type, the event ID, and the flushed message.
+ */
+typedef void (*grunt_event_sink_t)(void *, grunt_number_t, grunt_number_t,
+				   const char *);
+
+/* Builds that define GRUNT_PROFILE keep an execution profile in each
+ * VM: how many times each opcode and each program counter executed,
+ * and the cost in clock ticks of one instruction in every
+ * GRUNT_PROFILE_SAMPLE_PERIOD, totalled by opcode and histogrammed by
+ * the log2 of the tick count.  Ticks are time stamp counter cycles on
+ * x86 and PSP timebase ticks elsewhere.  Profiles accumulate across
+ * runs until GRUNT_ResetProfile().
+ */
+#ifdef GRUNT_PROFILE
+#define GRUNT_PROFILE_NUM_OPCODES   40    /* opcodes 0 through 39 */
+#define GRUNT_PROFILE_MAX_PC        1024  /* pcs counted */
+#define GRUNT_PROFILE_NUM_BUCKETS   16    /* histogram buckets */
+#define GRUNT_PROFILE_SAMPLE_PERIOD 16    /* instructions per sample */
+
+typedef struct {
+	uint32 runs;                  /* programs run */
+	uint32 instructions;          /* instructions executed */
+	uint32 samples;               /* instructions timed */
+	uint32 op_count[GRUNT_PROFILE_NUM_OPCODES];    /* executions */
+	uint32 op_samples[GRUNT_PROFILE_NUM_OPCODES];  /* of those, timed */
+	uint64 op_ticks[GRUNT_PROFILE_NUM_OPCODES];    /* total timed ticks */
+	uint32 histogram[GRUNT_PROFILE_NUM_BUCKETS];   /* [b]: 2^b ticks */
+	uint32 pc_count[GRUNT_PROFILE_MAX_PC];         /* executions */
+	uint16 countdown;             /* instructions to the next sample */
+} grunt_profile_t;
+#endif
+
+/* Builds that define GRUNT_TRACE keep the last GRUNT_TRACE_SIZE steps
+ * each VM took in a ring, for replay on the ground.  Each instruction
+ * the checked engines dispatch records its program counter, its
+ * opcode, and the type and payload of the arg stack's top element as
+ * it began, widened to 32 bits.  Each run ends with a GRUNT_TRACE_END
+ * step recording the pc at which it stopped and its status.  Traces
+ * accumulate across runs until GRUNT_ResetTrace().
+ */
+#ifdef GRUNT_TRACE
+#define GRUNT_TRACE_SIZE  256    /* steps kept; a power of 2 */
+#define GRUNT_TRACE_EMPTY 0xFE   /* type: the arg stack was empty */
+#define GRUNT_TRACE_END   0xFF   /* type: run ended; top holds status */
+
+typedef struct {
+	grunt_pc_t pc;                /* instruction's program counter */
+	uint8      op;                /* its opcode, 0 at GRUNT_TRACE_END */
+	uint8      type;              /* grunt_value_type_t or GRUNT_TRACE_* */
+	uint32     top;               /* arg stack top's payload, or status */
+} grunt_trace_step_t;
+
+typedef struct {
+	uint32 steps;                 /* steps ever recorded */
+	grunt_trace_step_t ring[GRUNT_TRACE_SIZE];  /* [steps % size] next */
+} grunt_trace_t;
+#endif
+
+typedef struct {
+	grunt_pc_t    pc;               /* the program counter */
+#ifdef GRUNT_COUNT_INSTRUCTIONS
+	uint32        instruction_count; /* see GRUNT_GetInstructionCount() */
+#endif
+	grunt_value_t ra;               /* register, often an accumulator */
+	grunt_value_t rb;               /* register, often a bounce variable */
+
+	/* The arg and control stacks; see grunt_stack.c.  Slot i's type
+	 * is stack_type[i] and its payload stack_val[i].
+	 */
+	int           argument_count;
+	int           control_count;
+	uint8         stack_type[GRUNT_STACK_SIZE];
+	grunt_payload_t stack_val[GRUNT_STACK_SIZE];
+
+	/* The input queue; see grunt_input.c. */
+	const char   *input_queue;
+	grunt_rep_t   input_queue_size;
+	grunt_rep_t   head_index;
+	grunt_record_view_t record_view;
+	grunt_rep_t   record_left;      /* checked bytes left in record */
+
+	/* The output queue; see grunt_output.c. */
+	const char  **string_table;
+	grunt_rep_t   num_strings;
+	const grunt_rep_t *string_lengths;  /* of string_table, or NULL */
+	const char  **lengths_table;   /* see GRUNT_SetStringLengths() */
+	const grunt_rep_t *lengths;
+	grunt_rep_t   tail_index;
+	char          output_queue[GRUNT_OUTPUT_QUEUE_SIZE];
+	grunt_event_sink_t event_sink;  /* NULL: flush to EVS */
+	void         *event_sink_arg;
+
+	grunt_engine_t engine;          /* see GRUNT_SetEngine() */
+
+	/* The perf IDs to mark each phase of a run with, or 0 to mark
+	 * none; see GRUNT_SetPerfIDs().
+	 */
+	uint32        perf_init_id;     /* resetting the VM */
+	uint32        perf_run_id;      /* executing instructions */
+	uint32        perf_flush_id;    /* flushing an event */
+
+	/* The threaded engine's handler table; see grunt.c. */
+	const grunt_instruction_t *threaded_program;
+	grunt_pc_t    threaded_count;
+	const void   *threaded[GRUNT_THREADED_MAX_INSTRUCTIONS + 1];
+
+#ifdef GRUNT_PROFILE
+	grunt_profile_t profile;        /* see grunt_profile.c */
+#endif
+#ifdef GRUNT_TRACE
+	grunt_trace_t trace;            /* see grunt_trace.c */
+#endif
+} grunt_vm_t;
+
 int32 GRUNT_Init(void);
 
+void  GRUNT_InitCtx(grunt_vm_t *);
+
+/* GRUNT_SetEventSink() redirects a VM's flushed events to a callback;
+ * a NULL VM selects the one GRUNT_Run() and native code use.
+ */
+void  GRUNT_SetEventSink(grunt_vm_t *, grunt_event_sink_t, void *);
+
+/* GRUNT_SetRecordView() gives a VM's input queue a record view; a
+ * NULL VM selects the one GRUNT_Run() uses.
+ */
+void  GRUNT_SetRecordView(grunt_vm_t *, const grunt_record_view_t *);
+
+/* GRUNT_SetStringLengths() gives a VM the precomputed lengths of a
+ * string table's strings; a NULL VM selects the one GRUNT_Run() and
+ * native code use.
+ */
+void  GRUNT_SetStringLengths(grunt_vm_t *, const char **,
+			     const grunt_rep_t *);
+
+/* GRUNT_SetEngine() chooses the engine a VM runs programs on; a NULL
+ * VM selects the one GRUNT_Run() and GRUNT_RunBatch() use.
+ */
+void  GRUNT_SetEngine(grunt_vm_t *, grunt_engine_t);
+
+/* GRUNT_SetPerfIDs() has a VM mark the phases of its runs with ES
+ * perf IDs; a NULL VM selects the one GRUNT_Run(), GRUNT_RunBatch(),
+ * GRUNT_RunPacked(), and native code use.
+ */
+void  GRUNT_SetPerfIDs(grunt_vm_t *, uint32, uint32, uint32);
+
 int32 GRUNT_Run(const grunt_instruction_t *, grunt_pc_t,
 		const void *, grunt_rep_t,
 		const char **, grunt_string_t);
 
+int32 GRUNT_RunCtx(grunt_vm_t *, const grunt_instruction_t *, grunt_pc_t,
+		   const void *, grunt_rep_t,
+		   const char **, grunt_string_t);
+
+/* GRUNT_RunBatch() runs one program over several input images laid
+ * out back-to-back, each of the same size, and stores each run's
+ * status in the result vector.
+ */
+int32 GRUNT_RunBatch(const grunt_instruction_t *, grunt_pc_t,
+		     const void *, grunt_rep_t, uint16,
+		     const char **, grunt_string_t, int32 *);
+
+/* GRUNT_Verify() proves a program free of the run-time errors that
+ * don't depend on its input.  Once it accepts a program, GRUNT_Run()
+ * runs that program on a faster engine that skips those checks.
+ */
+int32 GRUNT_Verify(const grunt_instruction_t *, grunt_pc_t, grunt_string_t);
+
+int32 GRUNT_Pack(const grunt_instruction_t *, grunt_pc_t,
+		 grunt_packed_program_t *);
+
+/* GRUNT_Optimize() rewrites a program GRUNT_Verify() would accept
+ * into a smaller, faster one that produces the same output and result
+ * for every input.  Run-time errors may be reported at other pcs.
+ */
+int32 GRUNT_Optimize(const grunt_instruction_t *, grunt_pc_t,
+		     grunt_string_t, grunt_optimized_program_t *);
+
+int32 GRUNT_RunPacked(const grunt_packed_program_t *,
+		      const void *, grunt_rep_t,
+		      const char **, grunt_string_t);
+
+/* GRUNT_Prepare() does once, for a program and its string table, the
+ * verifying, optimizing, and measuring GRUNT_Run() would otherwise
+ * look up or redo on every run, and returns a handle to the result.
+ * GRUNT_RunPrepared() runs a prepared program on the VM GRUNT_Run()
+ * uses.  Given GRUNT_PREPARE_OPTIMIZE, GRUNT_Prepare() runs
+ * GRUNT_Optimize()'s rewrite of the program in its place.
+ */
+#define GRUNT_PREPARE_OPTIMIZE 0x01
+
+typedef struct grunt_prepared grunt_prepared_t;
+
+int32 GRUNT_Prepare(const grunt_instruction_t *, grunt_pc_t,
+		    const char **, grunt_string_t, uint32,
+		    const grunt_prepared_t **);
+
+int32 GRUNT_RunPrepared(const grunt_prepared_t *, const void *,
+			grunt_rep_t);
+
+/* GRUNT_Serialize() and GRUNT_Deserialize() write and read the
+ * serialized program format described above.  Neither verifies the
+ * program; loaders should GRUNT_Verify() what they read.
+ */
+int32 GRUNT_Serialize(const grunt_instruction_t *, grunt_pc_t,
+		      const char **, grunt_string_t,
+		      uint8 *, uint32, uint32 *);
+
+int32 GRUNT_Deserialize(const uint8 *, uint32, grunt_serial_program_t *);
+
+/* Builds that define GRUNT_COUNT_INSTRUCTIONS count the instructions
+ * each run of an unverified program executes, for benchmarks; a NULL
+ * VM selects the one GRUNT_Run() uses.
+ */
+#ifdef GRUNT_COUNT_INSTRUCTIONS
+uint32 GRUNT_GetInstructionCount(const grunt_vm_t *);
+#endif
+
+/* Builds that define GRUNT_PROFILE run every program on the checked
+ * switch engine and profile each instruction; a NULL VM selects the
+ * one GRUNT_Run(), GRUNT_RunBatch(), and GRUNT_RunPacked() use.
+ */
+#ifdef GRUNT_PROFILE
+const grunt_profile_t *GRUNT_GetProfile(const grunt_vm_t *);
+void  GRUNT_ResetProfile(grunt_vm_t *);
+#endif
+
+/* Builds that define GRUNT_TRACE run every program on the checked
+ * switch engine and trace each step; a NULL VM selects the one
+ * GRUNT_Run(), GRUNT_RunBatch(), and GRUNT_RunPacked() use.
+ */
+#ifdef GRUNT_TRACE
+const grunt_trace_t *GRUNT_GetTrace(const grunt_vm_t *);
+void  GRUNT_ResetTrace(grunt_vm_t *);
+#endif
+
+/* Builds that define GRUNT_FUZZ can make the library forget the
+ * programs GRUNT_Verify() has accepted, so that a fuzzer can verify
+ * any number of programs in one process.
+ */
+#ifdef GRUNT_FUZZ
+void  GRUNT_ForgetVerified(void);
+#endif
+
+/* Native code generated from Grunt programs by the gruntaot
+ * translator keeps its own stacks and input queue, but it shares the
+ * interpreter's output queue and error reporting through these calls.
+ */
+void  GRUNT_NativeInit(const char **, grunt_string_t);
+int32 GRUNT_NativeOutput(const grunt_value_t *);
+int32 GRUNT_NativeFormat(grunt_string_t, const grunt_value_t *,
+			 grunt_rep_t);
+void  GRUNT_NativeFlush(grunt_number_t, grunt_number_t);
+int32 GRUNT_NativeClassify(grunt_value_t *, grunt_number_t, grunt_rep_t);
+void  GRUNT_NativeError(int32, grunt_pc_t);
+
 #endif
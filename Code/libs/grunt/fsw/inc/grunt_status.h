@@ -44,4 +44,9 @@
 #define GRUNT_ERROR_NOPROGRAM         0x16  /* PC beyond end of program */
 #define GRUNT_ERROR_OUTOFBOUNDS       0x17  /* stack, buffer over/underflow */
 
+/* GRUNT_Deserialize() uses this error code for byte strings that
+ * aren't well-formed serialized programs (see grunt.h).
+ */
+#define GRUNT_ERROR_BADSERIAL         0x18  /* bad serialized program */
+
 #endif
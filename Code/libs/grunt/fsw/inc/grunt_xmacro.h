@@ -0,0 +1,664 @@
+#ifndef _GRUNT_XMACRO_H_
+#define _GRUNT_XMACRO_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* Compile-time expansion of Grunt programs into C.
+ *
+ * A program header gruntasm generates, such as vsvf.h, spells its
+ * instructions with grunt.h's convenience macros.  This header
+ * redefines those macros so that each instruction expands into the
+ * C statements that execute it rather than into an initializer.
+ * Including the program header a second time with GRUNT_XMACRO_EXPAND
+ * defined, between GRUNT_XMACRO_BEGIN() and GRUNT_XMACRO_END(), makes
+ * the body of a C function that runs the program:
+ *
+ *	#include "vsvf.h"
+ *	#include "grunt_xmacro.h"
+ *
+ *	int32
+ *	vsvf_xmacro_run(const void *p_data, grunt_rep_t data_size) {
+ *		GRUNT_XMACRO_BEGIN(p_data, data_size,
+ *			vsvf_program, VSVF_NUM_INSTRUCTIONS,
+ *			vsvf_strings, VSVF_NUM_STRINGS);
+ *	#define GRUNT_XMACRO_EXPAND
+ *	#include "vsvf.h"
+ *	#undef GRUNT_XMACRO_EXPAND
+ *		GRUNT_XMACRO_END(VSVF_NUM_INSTRUCTIONS);
+ *	}
+ *
+ * The function returns what GRUNT_Run() would and reports output and
+ * errors through the GRUNT_Native*() functions, like gruntaot's
+ * translations.  Unlike them, it needs no translator and no generated
+ * C file: the checked-in program header is its only source, so the
+ * two can never disagree.
+ *
+ * Each instruction becomes one case of a switch on the program
+ * counter, numbered with __COUNTER__, so straight-line code falls
+ * from one instruction to the next, literals fold into the code that
+ * uses them, and JMPIF, CALL, RETURN, and END re-enter the switch at
+ * their targets.  The interpreter's literal and NOLOOPS checks become
+ * constant conditions the compiler discards for well-formed programs.
+ * A LOOKUP or SWITCH can't see the table entries that follow it,
+ * which expand into cases of their own, so it reads its table from the
+ * program's instruction array and then jumps to its target.
+ *
+ * The redefined macros replace grunt.h's, so a file that includes
+ * this header must not also build instruction arrays with them after
+ * it.  __COUNTER__ must be left alone between GRUNT_XMACRO_BEGIN()
+ * and GRUNT_XMACRO_END(); GRUNT_XMACRO_END() fails to compile if the
+ * count of instructions it saw doesn't match the program's.
+ */
+
+#include "grunt.h"
+#include "grunt_status.h"
+
+typedef struct {
+	grunt_value_t stack[GRUNT_STACK_SIZE];  /* arg stack */
+	grunt_value_t ctl[GRUNT_STACK_SIZE];    /* control stack */
+	int arg_count;           /* count of elements on arg stack */
+	int ctl_count;           /* count of elements on ctl[] */
+	const char *input;       /* the input data queue */
+	grunt_rep_t input_size;  /* size of input data in bytes */
+	grunt_rep_t head_index;  /* index of next char to dequeue */
+} gx_vm_t;
+
+
+static inline int
+gx_push(gx_vm_t *p_vm, const grunt_value_t *p_v) {
+	if ((p_vm->arg_count + p_vm->ctl_count + 1) > GRUNT_STACK_SIZE)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	p_vm->stack[p_vm->arg_count++] = *p_v;
+	return 0;
+}
+
+
+static inline int
+gx_push_bool(gx_vm_t *p_vm, grunt_boolean_t b) {
+	grunt_value_t v;
+	v.type = gt_bool;
+	v.val.b = b;
+	return gx_push(p_vm, &v);
+}
+
+
+static inline int
+gx_push_num(gx_vm_t *p_vm, grunt_number_t num) {
+	grunt_value_t v;
+	v.type = gt_num;
+	v.val.num = num;
+	return gx_push(p_vm, &v);
+}
+
+
+static inline int
+gx_push_str(gx_vm_t *p_vm, grunt_string_t str) {
+	grunt_value_t v;
+	v.type = gt_str;
+	v.val.str = str;
+	return gx_push(p_vm, &v);
+}
+
+
+static inline int
+gx_pop(gx_vm_t *p_vm, grunt_value_t *p_v) {
+	if (p_vm->arg_count == 0) return GRUNT_ERROR_OUTOFBOUNDS;
+	*p_v = p_vm->stack[--p_vm->arg_count];
+	return 0;
+}
+
+
+static inline int
+gx_pop_type(gx_vm_t *p_vm, grunt_value_t *p_v, grunt_value_type_t t) {
+	if (p_vm->arg_count == 0) return GRUNT_ERROR_OUTOFBOUNDS;
+	*p_v = p_vm->stack[--p_vm->arg_count];
+	if (p_v->type != t) return GRUNT_ERROR_INVALIDARGUMENT;
+	return 0;
+}
+
+
+static inline int
+gx_add_sub(gx_vm_t *p_vm, bool add_flag) {
+	grunt_value_t a, b;
+	int status;
+	if ((status = gx_pop_type(p_vm, &b, gt_num))) return status;
+	if ((status = gx_pop_type(p_vm, &a, gt_num))) return status;
+	if (add_flag) {
+		if (b.val.num > (GRUNT_NUM_MAX - a.val.num))
+			return GRUNT_ERROR_OUTOFBOUNDS;
+		a.val.num += b.val.num;
+	} else {
+		if (a.val.num < b.val.num) return GRUNT_ERROR_OUTOFBOUNDS;
+		a.val.num -= b.val.num;
+	}
+	return gx_push(p_vm, &a);
+}
+
+
+static inline int
+gx_and_or(gx_vm_t *p_vm, grunt_rep_t n, bool and_flag) {
+	grunt_value_t a, b;
+	grunt_rep_t i;
+	int status;
+	if ((status = gx_pop_type(p_vm, &a, gt_bool))) return status;
+	for (i = 1; i < n; i++) {
+		if ((status = gx_pop_type(p_vm, &b, gt_bool))) return status;
+		a.val.b = (and_flag ? a.val.b && b.val.b : a.val.b || b.val.b);
+	}
+	return gx_push(p_vm, &a);
+}
+
+
+static inline int
+gx_eq(gx_vm_t *p_vm, grunt_rep_t n) {
+	grunt_value_t a, b;
+	grunt_rep_t i;
+	bool equal_flag = true;
+	int status;
+	if ((status = gx_pop_type(p_vm, &a, gt_num))) return status;
+	for (i = 1; i < n; i++) {
+		if ((status = gx_pop_type(p_vm, &b, gt_num))) return status;
+		if (a.val.num != b.val.num) equal_flag = false;
+	}
+	return gx_push_bool(p_vm, equal_flag);
+}
+
+
+static inline int
+gx_lt_gt(gx_vm_t *p_vm, bool lt_flag) {
+	grunt_value_t a, b;
+	int status;
+	if ((status = gx_pop_type(p_vm, &b, gt_num))) return status;
+	if ((status = gx_pop_type(p_vm, &a, gt_num))) return status;
+	return gx_push_bool(p_vm, (lt_flag ? a.val.num < b.val.num :
+		a.val.num > b.val.num));
+}
+
+
+static inline int
+gx_not(gx_vm_t *p_vm) {
+	grunt_value_t a;
+	int status;
+	if ((status = gx_pop_type(p_vm, &a, gt_bool))) return status;
+	return gx_push_bool(p_vm, !a.val.b);
+}
+
+
+static inline int
+gx_dup(gx_vm_t *p_vm, grunt_rep_t n) {
+	if (p_vm->arg_count < n) return GRUNT_ERROR_OUTOFBOUNDS;
+	if ((p_vm->arg_count + p_vm->ctl_count + n) > GRUNT_STACK_SIZE)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	memcpy(&(p_vm->stack[p_vm->arg_count]),
+		&(p_vm->stack[p_vm->arg_count - n]),
+		(n * sizeof(grunt_value_t)));
+	p_vm->arg_count += n;
+	return 0;
+}
+
+
+static inline int
+gx_roll(gx_vm_t *p_vm, grunt_rep_t n) {
+	grunt_value_t temp;
+	if (p_vm->arg_count < n) return GRUNT_ERROR_OUTOFBOUNDS;
+	temp = p_vm->stack[p_vm->arg_count - 1];
+	memmove(&(p_vm->stack[p_vm->arg_count - n + 1]),
+		&(p_vm->stack[p_vm->arg_count - n]),
+		((n - 1) * sizeof(grunt_value_t)));
+	p_vm->stack[p_vm->arg_count - n] = temp;
+	return 0;
+}
+
+
+static inline int
+gx_pop_n(gx_vm_t *p_vm, grunt_rep_t n) {
+	if (p_vm->arg_count < n) {
+		p_vm->arg_count = 0;  /* interpreter pops what it can */
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	}
+	p_vm->arg_count -= n;
+	return 0;
+}
+
+
+static inline int
+gx_input(gx_vm_t *p_vm, grunt_rep_t n) {
+	uint32 u32;
+	uint16 u16;
+	uint8  u8;
+	if (!p_vm->input) return GRUNT_ERROR_INTERPRETERBUG;
+	if ((p_vm->head_index + n) > p_vm->input_size)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	switch (n) {
+	case 4:
+		memcpy(&u32, &(p_vm->input[p_vm->head_index]), 4);
+		p_vm->head_index += 4;
+		return gx_push_num(p_vm, u32);
+	case 2:
+		memcpy(&u16, &(p_vm->input[p_vm->head_index]), 2);
+		p_vm->head_index += 2;
+		return gx_push_num(p_vm, u16);
+	default:
+		memcpy(&u8, &(p_vm->input[p_vm->head_index]), 1);
+		p_vm->head_index += 1;
+		return gx_push_num(p_vm, u8);
+	}
+}
+
+
+static inline int
+gx_inputrec(gx_vm_t *p_vm, grunt_rep_t layout) {
+	uint32 size = 0;
+	int n, i, status;
+	for (n = 0; (n < GRUNT_INPUTREC_MAX_FIELDS) &&
+		GRUNT_INPUTREC_WIDTH(layout, n); n++)
+		size += GRUNT_INPUTREC_WIDTH(layout, n);
+	if (!n || ((n < GRUNT_INPUTREC_MAX_FIELDS) && (layout >> (2 * n))))
+		return GRUNT_ERROR_INVALIDLITERAL;
+	if (!p_vm->input) return GRUNT_ERROR_INTERPRETERBUG;
+	if ((p_vm->head_index + size) > p_vm->input_size)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	for (i = 0; i < n; i++) {
+		if ((status = gx_input(p_vm, GRUNT_INPUTREC_WIDTH(layout, i))))
+			return status;
+	}
+	return 0;
+}
+
+
+static inline int
+gx_inputz(gx_vm_t *p_vm, grunt_rep_t n) {
+	uint8 any = 0;
+	if (!p_vm->input) return GRUNT_ERROR_INTERPRETERBUG;
+	if ((p_vm->head_index + n) > p_vm->input_size)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	while (n--) any |= (uint8)p_vm->input[p_vm->head_index++];
+	return gx_push_bool(p_vm, (any == 0));
+}
+
+
+static inline int
+gx_rewind(gx_vm_t *p_vm, grunt_rep_t n) {
+	if (n > p_vm->head_index) return GRUNT_ERROR_OUTOFBOUNDS;
+	p_vm->head_index = (n ? p_vm->head_index - n : 0);
+	return 0;
+}
+
+
+static inline int
+gx_output(gx_vm_t *p_vm) {
+	grunt_value_t a;
+	int status;
+	if ((status = gx_pop(p_vm, &a))) return status;
+	return GRUNT_NativeOutput(&a);
+}
+
+
+static inline int
+gx_format(gx_vm_t *p_vm, grunt_rep_t n) {
+	grunt_value_t t, v[GRUNT_FORMAT_MAX_VALUES];
+	int i, status;
+	if (n > GRUNT_FORMAT_MAX_VALUES) return GRUNT_ERROR_INVALIDLITERAL;
+	if ((status = gx_pop_type(p_vm, &t, gt_str))) return status;
+	for (i = n - 1; i >= 0; i--) {
+		if ((status = gx_pop(p_vm, &(v[i])))) return status;
+	}
+	return GRUNT_NativeFormat(t.val.str, v, n);
+}
+
+
+static inline int
+gx_classify(gx_vm_t *p_vm, grunt_rep_t names) {
+	grunt_value_t row[4];
+	int i, status;
+	if ((status = gx_pop_type(p_vm, &(row[0]), gt_num))) return status;
+	if ((status = GRUNT_NativeClassify(row, row[0].val.num, names)))
+		return status;
+	for (i = 0; i < 4; i++) {
+		if ((status = gx_push(p_vm, &(row[i])))) return status;
+	}
+	return 0;
+}
+
+
+static inline int
+gx_flush(gx_vm_t *p_vm) {
+	grunt_value_t a, b;
+	int status;
+	if ((status = gx_pop_type(p_vm, &a, gt_num))) return status;
+	if ((status = gx_pop_type(p_vm, &b, gt_num))) return status;
+	GRUNT_NativeFlush(a.val.num, b.val.num);
+	return 0;
+}
+
+
+static inline int
+gx_halt(gx_vm_t *p_vm) {
+	grunt_value_t a;
+	int status;
+	if ((status = gx_pop_type(p_vm, &a, gt_bool))) return status;
+	return (a.val.b ? GRUNT_HALT_TRUE : GRUNT_HALT_FALSE);
+}
+
+
+static inline int
+gx_test(gx_vm_t *p_vm, bool *p_b) {
+	grunt_value_t a;
+	int status;
+	if ((status = gx_pop_type(p_vm, &a, gt_bool))) return status;
+	*p_b = a.val.b;
+	return 0;
+}
+
+
+static inline int
+gx_ctl_push(gx_vm_t *p_vm, grunt_value_type_t t, uint32 val) {
+	if ((p_vm->arg_count + p_vm->ctl_count + 1) > GRUNT_STACK_SIZE)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	p_vm->ctl[p_vm->ctl_count].type = t;
+	if (t == gt_pc) {
+		p_vm->ctl[p_vm->ctl_count].val.pc = (grunt_pc_t)val;
+	} else {
+		p_vm->ctl[p_vm->ctl_count].val.num = val;
+	}
+	p_vm->ctl_count++;
+	return 0;
+}
+
+
+static inline int
+gx_call(gx_vm_t *p_vm, grunt_pc_t return_pc) {
+	return gx_ctl_push(p_vm, gt_pc, return_pc);
+}
+
+
+static inline int
+gx_return(gx_vm_t *p_vm, grunt_pc_t *p_pc) {
+	if (p_vm->ctl_count == 0) return GRUNT_ERROR_OUTOFBOUNDS;
+	if (p_vm->ctl[--p_vm->ctl_count].type != gt_pc)
+		return GRUNT_ERROR_INVALIDARGUMENT;   /* a loop's count */
+	*p_pc = p_vm->ctl[p_vm->ctl_count].val.pc;
+	return 0;
+}
+
+
+static inline int
+gx_repeat(gx_vm_t *p_vm, grunt_rep_t reps, grunt_pc_t body_pc) {
+	int status;
+	if (reps < 1) return GRUNT_ERROR_INVALIDLITERAL;
+	if ((status = gx_ctl_push(p_vm, gt_pc, body_pc))) return status;
+	return gx_ctl_push(p_vm, gt_num, reps);
+}
+
+
+static inline int
+gx_end(gx_vm_t *p_vm, grunt_pc_t next_pc, grunt_pc_t *p_pc) {
+	grunt_value_t *p_count;
+	if (p_vm->ctl_count == 0) return GRUNT_ERROR_OUTOFBOUNDS;
+	p_count = &(p_vm->ctl[p_vm->ctl_count - 1]);
+	if (p_count->type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
+	if (p_vm->ctl_count < 2) return GRUNT_ERROR_OUTOFBOUNDS;
+	if (--p_count->val.num) {
+		*p_pc = p_count[-1].val.pc;   /* back to the body */
+	} else {
+		p_vm->ctl_count -= 2;
+		*p_pc = next_pc;
+	}
+	return 0;
+}
+
+
+static inline int
+gx_lookup(gx_vm_t *p_vm, const grunt_instruction_t *program,
+	grunt_pc_t num_instructions, grunt_pc_t pc, grunt_rep_t reps) {
+	const grunt_instruction_t *p_table = &(program[pc + 1]);
+	uint32 last = 2 * (uint32)reps;
+	uint32 i;
+	grunt_value_t key;
+	int status;
+	if (reps < 1) return GRUNT_ERROR_INVALIDLITERAL;
+	if (!((uint32)(num_instructions - (pc + 1)) > last))
+		return GRUNT_ERROR_NOPROGRAM;
+	for (i = 0; i <= last; i++) {
+		if ((i & 1) || (i == last)) {
+			if ((p_table[i].op != GRUNT_OP_PUSHS) ||
+				(p_table[i].arg.lit.type != gt_str))
+				return GRUNT_ERROR_INVALIDLITERAL;
+		} else if ((p_table[i].op != GRUNT_OP_PUSHN) ||
+			(p_table[i].arg.lit.type != gt_num)) {
+			return GRUNT_ERROR_INVALIDLITERAL;
+		}
+	}
+	if ((status = gx_pop_type(p_vm, &key, gt_num))) return status;
+	for (i = 0; i < last; i += 2) {
+		if (p_table[i].arg.lit.val.num == key.val.num) break;
+	}
+	return gx_push(p_vm, &(p_table[(i < last) ? i + 1 : last].arg.lit));
+}
+
+
+static inline int
+gx_switch(gx_vm_t *p_vm, const grunt_instruction_t *program,
+	grunt_pc_t num_instructions, grunt_pc_t pc, grunt_rep_t reps,
+	grunt_pc_t *p_pc) {
+	const grunt_instruction_t *p_table = &(program[pc + 1]);
+	uint32 i;
+	grunt_value_t key;
+	int status;
+	if (reps < 1) return GRUNT_ERROR_INVALIDLITERAL;
+	if ((uint32)(num_instructions - (pc + 1)) < reps)
+		return GRUNT_ERROR_NOPROGRAM;
+	for (i = 0; i < reps; i++) {
+		if ((p_table[i].op != GRUNT_OP_JMPIF) ||
+			(p_table[i].arg.lit.type != gt_pc) ||
+			(p_table[i].arg.lit.val.pc < 1))
+			return GRUNT_ERROR_INVALIDLITERAL;
+		if (p_table[i].arg.lit.val.pc > (GRUNT_PC_MAX - (pc + 1 + i)))
+			return GRUNT_ERROR_NOPROGRAM;
+	}
+	if ((status = gx_pop_type(p_vm, &key, gt_num))) return status;
+	*p_pc = (grunt_pc_t)(pc + 1 + ((key.val.num < reps) ?
+		(key.val.num + p_table[key.val.num].arg.lit.val.pc) : reps));
+	return 0;
+}
+
+
+/* Every instruction expands to "(void)0; case <pc>: <statements>
+ * (void)0", so that the commas that separate initializers in the
+ * program header become harmless comma operators.  Its pc is the
+ * __COUNTER__ value it expanded with, less the one GRUNT_XMACRO_BEGIN()
+ * started from.  Falling from one case into the next is the point, so
+ * we quiet the compilers that warn about it.
+ */
+#if defined(__GNUC__) && (__GNUC__ >= 7)
+#define GX_DIAG_PUSH _Pragma("GCC diagnostic push") \
+	_Pragma("GCC diagnostic ignored \"-Wimplicit-fallthrough\"")
+#define GX_DIAG_POP  _Pragma("GCC diagnostic pop")
+#else
+#define GX_DIAG_PUSH
+#define GX_DIAG_POP
+#endif
+
+#define GX_PC(k)   ((grunt_pc_t)((k) - gx_base))
+#define GX_CASE(k) (void)0; case ((k) - gx_base):
+#define GX_FAIL(k, s) \
+	do { gx_status = (s); gx_error_pc = GX_PC(k); goto gx_done; } \
+	while (0)
+#define GX_TRY(k, op) \
+	do { if ((gx_status = (op))) { gx_error_pc = GX_PC(k); \
+		goto gx_done; } } while (0)
+#define GX_GOTO(pc) do { gx_pc = (pc); goto gx_dispatch; } while (0)
+
+#define GX_STEP(k, op) GX_CASE(k) GX_TRY(k, op); (void)0
+
+#define GX_JMPIF(k, l) GX_CASE(k) \
+	GX_TRY(k, (((l) < 2) ? GRUNT_ERROR_INVALIDLITERAL : \
+		gx_test(&gx_vm, &gx_taken))); \
+	if (gx_taken) { \
+		if ((l) > (GRUNT_PC_MAX - (GX_PC(k) + 1))) \
+			GX_FAIL(k, GRUNT_ERROR_NOPROGRAM); \
+		GX_GOTO(GX_PC(k) + (l)); \
+	} (void)0
+
+#define GX_CALL(k, sub) GX_CASE(k) \
+	GX_TRY(k, (((sub) < (GX_PC(k) + 1)) ? GRUNT_ERROR_NOLOOPS : \
+		gx_call(&gx_vm, GX_PC(k) + 1))); \
+	GX_GOTO(sub); (void)0
+
+#define GX_RETURN(k) GX_CASE(k) \
+	GX_TRY(k, gx_return(&gx_vm, &gx_pc)); \
+	goto gx_dispatch; (void)0
+
+#define GX_REPEAT(k, r) \
+	GX_STEP(k, gx_repeat(&gx_vm, (r), GX_PC(k) + 1))
+
+#define GX_END(k) GX_CASE(k) \
+	GX_TRY(k, gx_end(&gx_vm, GX_PC(k) + 1, &gx_pc)); \
+	goto gx_dispatch; (void)0
+
+#define GX_LOOKUP(k, r) GX_CASE(k) \
+	GX_TRY(k, gx_lookup(&gx_vm, gx_program, gx_num_instructions, \
+		GX_PC(k), (r))); \
+	GX_GOTO(GX_PC(k) + (2 * (r)) + 2); (void)0
+
+#define GX_SWITCH(k, r) GX_CASE(k) \
+	GX_TRY(k, gx_switch(&gx_vm, gx_program, gx_num_instructions, \
+		GX_PC(k), (r), &gx_pc)); \
+	goto gx_dispatch; (void)0
+
+#define GX_HALT(k) GX_CASE(k) \
+	if ((gx_status = gx_halt(&gx_vm)) > GRUNT_HALT_FALSE) \
+		gx_error_pc = GX_PC(k); \
+	goto gx_done; (void)0
+
+#define GX_REP(k, r, min, op) \
+	GX_STEP(k, (((r) < (min)) ? GRUNT_ERROR_INVALIDLITERAL : (op)))
+
+#define GX_INPUT(k, r) \
+	GX_STEP(k, ((((r) != 4) && ((r) != 2) && ((r) != 1)) ? \
+		GRUNT_ERROR_INVALIDLITERAL : gx_input(&gx_vm, (r))))
+
+#undef ADD
+#undef AND
+#undef CALL
+#undef CLASSIFY
+#undef DUP
+#undef END
+#undef EQ
+#undef FLUSH
+#undef FORMAT
+#undef GT
+#undef HALT
+#undef INPUT
+#undef INPUTREC
+#undef INPUTZ
+#undef JMPIF
+#undef LOOKUP
+#undef LT
+#undef NOT
+#undef OR
+#undef OUTPUT
+#undef POP
+#undef PUSHB
+#undef PUSHN
+#undef PUSHS
+#undef REPEAT
+#undef RETURN
+#undef REWIND
+#undef ROLL
+#undef SUB
+#undef SWITCH
+
+#define ADD       GX_STEP(__COUNTER__, gx_add_sub(&gx_vm, true))
+#define AND(r)    GX_REP(__COUNTER__, (r), 2, gx_and_or(&gx_vm, (r), true))
+#define CALL(sub) GX_CALL(__COUNTER__, (sub))
+#define CLASSIFY(s) GX_STEP(__COUNTER__, gx_classify(&gx_vm, (s)))
+#define DUP(r)    GX_REP(__COUNTER__, (r), 1, gx_dup(&gx_vm, (r)))
+#define END       GX_END(__COUNTER__)
+#define EQ(r)     GX_REP(__COUNTER__, (r), 2, gx_eq(&gx_vm, (r)))
+#define FLUSH     GX_STEP(__COUNTER__, gx_flush(&gx_vm))
+#define FORMAT(r) GX_STEP(__COUNTER__, gx_format(&gx_vm, (r)))
+#define GT        GX_STEP(__COUNTER__, gx_lt_gt(&gx_vm, false))
+#define HALT      GX_HALT(__COUNTER__)
+#define INPUT(r)  GX_INPUT(__COUNTER__, (r))
+#define INPUTREC(l) GX_STEP(__COUNTER__, gx_inputrec(&gx_vm, (l)))
+#define INPUTZ(r) GX_REP(__COUNTER__, (r), 1, gx_inputz(&gx_vm, (r)))
+#define JMPIF(l)  GX_JMPIF(__COUNTER__, (l))
+#define LOOKUP(r) GX_LOOKUP(__COUNTER__, (r))
+#define LT        GX_STEP(__COUNTER__, gx_lt_gt(&gx_vm, true))
+#define NOT       GX_STEP(__COUNTER__, gx_not(&gx_vm))
+#define OR(r)     GX_REP(__COUNTER__, (r), 2, gx_and_or(&gx_vm, (r), false))
+#define OUTPUT    GX_STEP(__COUNTER__, gx_output(&gx_vm))
+#define POP(r)    GX_REP(__COUNTER__, (r), 1, gx_pop_n(&gx_vm, (r)))
+#define PUSHB(tf) GX_STEP(__COUNTER__, gx_push_bool(&gx_vm, (tf)))
+#define PUSHN(n)  GX_STEP(__COUNTER__, gx_push_num(&gx_vm, (n)))
+#define PUSHS(s)  GX_STEP(__COUNTER__, gx_push_str(&gx_vm, (s)))
+#define REPEAT(r) GX_REPEAT(__COUNTER__, (r))
+#define RETURN    GX_RETURN(__COUNTER__)
+#define REWIND(r) GX_STEP(__COUNTER__, gx_rewind(&gx_vm, (r)))
+#define ROLL(r)   GX_REP(__COUNTER__, (r), 2, gx_roll(&gx_vm, (r)))
+#define SUB       GX_STEP(__COUNTER__, gx_add_sub(&gx_vm, false))
+#define SWITCH(r) GX_SWITCH(__COUNTER__, (r))
+
+/* GRUNT_XMACRO_BEGIN() declares the run's state, points it at the
+ * input data, the program's instructions, which only LOOKUPs and
+ * SWITCHes read, and the program's strings, and opens the switch the
+ * instructions become cases of.  GRUNT_XMACRO_END() turns falling off
+ * the end of the program or jumping past it into NOPROGRAM, closes the
+ * switch, reports errors, and returns the run's status.
+ */
+#define GRUNT_XMACRO_BEGIN(p_data, data_size, program, num_instructions, \
+	strings, num_strings) \
+	gx_vm_t gx_vm; \
+	const grunt_instruction_t *gx_program = (program); \
+	grunt_pc_t gx_num_instructions = (num_instructions); \
+	grunt_pc_t gx_pc = 0; \
+	grunt_pc_t gx_error_pc = 0; \
+	int32 gx_status = GRUNT_ERROR_INTERPRETERBUG; \
+	bool gx_taken = false; \
+	enum { gx_base = __COUNTER__ + 1 }; \
+	gx_vm.arg_count  = 0; \
+	gx_vm.ctl_count  = 0; \
+	gx_vm.input      = (const char *)(p_data); \
+	gx_vm.input_size = (data_size); \
+	gx_vm.head_index = 0; \
+	GRUNT_NativeInit((strings), (num_strings)); \
+	(void)gx_taken; \
+	(void)gx_program; \
+	(void)gx_num_instructions; \
+	GX_DIAG_PUSH \
+	goto gx_dispatch; \
+gx_dispatch: \
+	switch (gx_pc) { \
+	default: \
+		GX_FAIL(gx_base + gx_pc, GRUNT_ERROR_NOPROGRAM); \
+	(void)0
+
+#define GRUNT_XMACRO_END(num_instructions) \
+	(void)0; \
+	gx_pc = (num_instructions); \
+	goto gx_dispatch; \
+	} \
+gx_done: \
+	GX_DIAG_POP \
+	{ enum { gx_count_ok = 1 / \
+		((__COUNTER__ - gx_base) == (num_instructions)) }; } \
+	if (!((gx_status == GRUNT_HALT_TRUE) || \
+		(gx_status == GRUNT_HALT_FALSE))) \
+		GRUNT_NativeError(gx_status, gx_error_pc); \
+	return gx_status
+
+#endif
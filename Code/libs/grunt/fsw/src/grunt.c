@@ -21,6 +21,7 @@
 #include "grunt.h"
 #include "grunt_status.h"
 
+#include "grunt_vm.h"
 #include "grunt_stack.h"
 #include "grunt_input.h"
 #include "grunt_output.h"
@@ -29,73 +30,203 @@
 #include "grunt_vm_logic.h"
 #include "grunt_vm_arithmetic.h"
 #include "grunt_vm_io.h"
+#include "grunt_pack.h"
+#include "grunt_verify.h"
+#include "grunt_optimize.h"
+#include "grunt_vm_verified.h"
+#include "grunt_lower.h"
+#include "grunt_jit.h"
+#include "grunt_vm_register.h"
+#include "grunt_profile.h"
+#include "grunt_trace.h"
 
-static grunt_value_t g_ra;  /* register, often an accumulator */
-static grunt_value_t g_rb;  /* register, often a bounce variable */
+/* The VM GRUNT_Run() and GRUNT_RunPacked() use.  Tasks that run
+ * Grunt programs concurrently bring their own to GRUNT_RunCtx().
+ */
+static grunt_vm_t g_vm;
+
+/* The programs GRUNT_Verify() has accepted.  GRUNT_Run() and
+ * GRUNT_RunCtx() run each as JIT-compiled machine code if it has some,
+ * on the register machine core if it has a lowering, or on the
+ * verified stack engine if its packed copy is typed; they run all
+ * others on the checked engines.  Only GRUNT_JIT builds compile machine code.
+ * GRUNT_Verify() keeps the lowered and packed copies of the programs
+ * these engines run in the storage below, which it hands out in order
+ * and never reclaims but in GRUNT_FUZZ builds' GRUNT_ForgetVerified().
+ *
+ * Runs don't lock: GRUNT_Verify() fills in an entry completely before
+ * it counts it in g_num_verified, and never changes it afterward.
+ * GRUNT_Verify() and GRUNT_Optimize() run under g_verify_mutex, since
+ * the verifier, the lowering, and the optimizer work in file-static
+ * scratch storage.
+ */
+#define GRUNT_VERIFIED_MAX_PROGRAMS     4
+#define GRUNT_VERIFIED_MAX_INSTRUCTIONS 1024
+#define GRUNT_VERIFIED_MAX_LITERALS     64
+#define GRUNT_LOWERED_MAX_INSTRUCTIONS  2048
 
-static grunt_pc_t    g_pc;  /* the program counter */
+typedef struct {
+	const grunt_instruction_t *program;
+	grunt_pc_t                 num_instructions;
+	grunt_string_t             num_strings;
+	grunt_packed_program_t     packed;
+	grunt_lowered_program_t    lowered;
+	bool                       is_lowered;  /* lowered holds a lowering? */
+	bool                       is_typed;    /* packed has OUTPUT types? */
+	grunt_jit_code_t           jit;         /* compiled lowering, if any */
+} grunt_verified_t;
+
+static grunt_verified_t g_verified[GRUNT_VERIFIED_MAX_PROGRAMS];
+static int              g_num_verified;  /* entries in g_verified[] */
+static osal_id_t        g_verify_mutex;
+
+static grunt_packed_t g_verified_code[GRUNT_VERIFIED_MAX_INSTRUCTIONS];
+static grunt_number_t g_verified_pool[GRUNT_VERIFIED_MAX_LITERALS];
+static grunt_reg_instruction_t g_lowered_code[GRUNT_LOWERED_MAX_INSTRUCTIONS];
+static uint16 g_verified_code_used;     /* of g_verified_code[] */
+static uint16 g_verified_pool_used;     /* of g_verified_pool[] */
+static uint16 g_lowered_code_used;      /* of g_lowered_code[] */
+static uint8  g_verified_types[GRUNT_VERIFIED_MAX_INSTRUCTIONS];  /* scratch */
+
+/* The programs GRUNT_Prepare() has prepared, each with the optimized
+ * copy it made, if it made one, its verified copies, and the lengths
+ * of its strings.  GRUNT_Prepare() keeps the optimized copies and the
+ * lengths in the storage below, which it hands out in order under
+ * g_verify_mutex and never reclaims but in GRUNT_FUZZ builds'
+ * GRUNT_ForgetVerified().  As with g_verified[], it fills in an entry
+ * completely before it counts it in g_num_prepared.
+ */
+#define GRUNT_PREPARED_MAX_PROGRAMS     4
+#define GRUNT_PREPARED_MAX_INSTRUCTIONS 1024
+#define GRUNT_PREPARED_MAX_STRINGS      128
+
+struct grunt_prepared {
+	const grunt_instruction_t *program;   /* optimized copy, or as given */
+	grunt_pc_t                 num_instructions;
+	const char               **string_table;
+	grunt_string_t             num_strings;
+	const grunt_rep_t         *string_lengths;
+	const grunt_verified_t    *p_v;       /* program's, or NULL */
+};
+
+static grunt_prepared_t g_prepared[GRUNT_PREPARED_MAX_PROGRAMS];
+static int              g_num_prepared;  /* entries in g_prepared[] */
+
+static grunt_instruction_t g_prepared_code[GRUNT_PREPARED_MAX_INSTRUCTIONS];
+static grunt_rep_t    g_prepared_lengths[GRUNT_PREPARED_MAX_STRINGS];
+static uint16 g_prepared_code_used;     /* of g_prepared_code[] */
+static uint16 g_prepared_lengths_used;  /* of g_prepared_lengths[] */
+
+/* The interpreter has two instruction dispatch engines: a portable
+ * one that dispatches through a switch statement, and a faster
+ * direct-threaded one that relies on the labels-as-values extension
+ * GCC and Clang provide.  We use the threaded engine when the
+ * compiler supports it, unless the build defines
+ * GRUNT_SWITCH_DISPATCH to ask for the portable engine.  Profiling
+ * and tracing builds use the portable engine too, so that every
+ * instruction goes through the observed grunt_vm_step().
+ */
+#if defined(__GNUC__) && !defined(GRUNT_SWITCH_DISPATCH) && \
+	!defined(GRUNT_PROFILE) && !defined(GRUNT_TRACE)
+#define GRUNT_THREADED_DISPATCH
+#endif
 
 
 /* -------------------- local functions ---------------------------- */
 
+/* grunt_vm_step()
+ *
+ * in:     p_vm             - VM to run the instruction on
+ *         p_i              - instruction at p_vm->pc
+ *         num_instructions - number of instructions in the program
+ * out:    p_vm             - the instruction's effects
+ * return: 0, or the instruction's HALT or GRUNT_ERROR_* status.
+ *
+ * A LOOKUP or SWITCH reads its table from the instructions after p_i,
+ * so for these p_i must point into the program itself rather than at
+ * a copy.
+ */
+
 static int
-grunt_vm_step(const grunt_instruction_t *p_i) {
+grunt_vm_step(grunt_vm_t *p_vm, const grunt_instruction_t *p_i,
+	grunt_pc_t num_instructions) {
 
 	/* Increment program counter so that the next fetch will get
 	 * the next instruction in sequence unless the current
-	 * instruction is a CALL, JMPIF, or RETURN.  These
+	 * instruction is a CALL, END, JMPIF, or RETURN.  These
 	 * instructions may reset the program counter to some other
 	 * target.  Note that p_i points to the current instruction;
 	 * this increment (and potential subsequent reset) will impact
 	 * the *next* instruction fetch.
 	 */
-	g_pc++;
+	p_vm->pc++;
+#ifdef GRUNT_COUNT_INSTRUCTIONS
+	p_vm->instruction_count++;
+#endif
 
 	switch (p_i->op) {
 	case GRUNT_OP_ADD:
-		return grunt_vm_add_sub(&g_ra, &g_rb, true);
+		return grunt_vm_add_sub(p_vm, true);
 	case GRUNT_OP_AND:
-		return grunt_vm_and_or(&g_ra, &g_rb, p_i->arg.rep, true);
+		return grunt_vm_and_or(p_vm, p_i->arg.rep, true);
 	case GRUNT_OP_CALL:
-		return grunt_vm_call(&g_ra, &g_pc, &(p_i->arg.lit));
+		return grunt_vm_call(p_vm, &(p_i->arg.lit));
+	case GRUNT_OP_CLASSIFY:
+		return grunt_vm_classify(p_vm, p_i->arg.rep);
 	case GRUNT_OP_DUP:
-		return grunt_vm_dup(p_i->arg.rep);
+		return grunt_vm_dup(p_vm, p_i->arg.rep);
+	case GRUNT_OP_END:
+		return grunt_vm_end(p_vm);
 	case GRUNT_OP_EQ:
-		return grunt_vm_eq(&g_ra, &g_rb, p_i->arg.rep);
+		return grunt_vm_eq(p_vm, p_i->arg.rep);
 	case GRUNT_OP_FLUSH:
-		return grunt_vm_flush(&g_ra, &g_rb);
+		return grunt_vm_flush(p_vm);
+	case GRUNT_OP_FORMAT:
+		return grunt_vm_format(p_vm, p_i->arg.rep);
 	case GRUNT_OP_GT:
-		return grunt_vm_lt_gt(&g_ra, &g_rb, false);
+		return grunt_vm_lt_gt(p_vm, false);
 	case GRUNT_OP_HALT:
-		return grunt_vm_halt(&g_ra);
+		return grunt_vm_halt(p_vm);
 	case GRUNT_OP_INPUT:
-		return grunt_vm_input(&g_ra, p_i->arg.rep);
+		return grunt_vm_input(p_vm, p_i->arg.rep);
+	case GRUNT_OP_INPUTREC:
+		return grunt_vm_inputrec(p_vm, p_i->arg.rep);
+	case GRUNT_OP_INPUTZ:
+		return grunt_vm_inputz(p_vm, p_i->arg.rep);
 	case GRUNT_OP_JMPIF:
-		return grunt_vm_jmpif(&g_ra, &g_pc, &(p_i->arg.lit));
+		return grunt_vm_jmpif(p_vm, &(p_i->arg.lit));
+	case GRUNT_OP_LOOKUP:
+		return grunt_vm_lookup(p_vm, p_i + 1, NULL, num_instructions,
+			p_i->arg.rep);
 	case GRUNT_OP_LT:
-		return grunt_vm_lt_gt(&g_ra, &g_rb, true);
+		return grunt_vm_lt_gt(p_vm, true);
 	case GRUNT_OP_NOT:
-		return grunt_vm_not(&g_ra);
+		return grunt_vm_not(p_vm);
 	case GRUNT_OP_OUTPUT:
-		return grunt_vm_output(&g_ra);
+		return grunt_vm_output(p_vm);
 	case GRUNT_OP_OR:
-		return grunt_vm_and_or(&g_ra, &g_rb, p_i->arg.rep, false);
+		return grunt_vm_and_or(p_vm, p_i->arg.rep, false);
 	case GRUNT_OP_POP:
-		return grunt_vm_pop(&g_ra, p_i->arg.rep);
+		return grunt_vm_pop(p_vm, p_i->arg.rep);
 	case GRUNT_OP_PUSHB:
-		return grunt_vm_pushb(&(p_i->arg.lit));
+		return grunt_vm_pushb(p_vm, &(p_i->arg.lit));
 	case GRUNT_OP_PUSHN:
-		return grunt_vm_pushn(&(p_i->arg.lit));
+		return grunt_vm_pushn(p_vm, &(p_i->arg.lit));
 	case GRUNT_OP_PUSHS:
-		return grunt_vm_pushs(&(p_i->arg.lit));
+		return grunt_vm_pushs(p_vm, &(p_i->arg.lit));
+	case GRUNT_OP_REPEAT:
+		return grunt_vm_repeat(p_vm, p_i->arg.rep);
 	case GRUNT_OP_RETURN:
-		return grunt_vm_return(&g_ra, &g_pc);
+		return grunt_vm_return(p_vm);
 	case GRUNT_OP_REWIND:
-		return grunt_vm_rewind(p_i->arg.rep);
+		return grunt_vm_rewind(p_vm, p_i->arg.rep);
 	case GRUNT_OP_ROLL:
-		return grunt_vm_roll(p_i->arg.rep);
+		return grunt_vm_roll(p_vm, p_i->arg.rep);
 	case GRUNT_OP_SUB:
-		return grunt_vm_add_sub(&g_ra, &g_rb, false);
+		return grunt_vm_add_sub(p_vm, false);
+	case GRUNT_OP_SWITCH:
+		return grunt_vm_switch(p_vm, p_i + 1, NULL, num_instructions,
+			p_i->arg.rep);
 	}
 
 	return GRUNT_ERROR_INVALIDOPCODE;
@@ -103,6 +234,470 @@ grunt_vm_step(const grunt_instruction_t *p_i) {
 } /* grunt_vm_step() */
 
 
+#if defined(GRUNT_PROFILE) || defined(GRUNT_TRACE)
+
+static int grunt_vm_step_fused(grunt_vm_t *, const grunt_packed_program_t *,
+	const grunt_instruction_t *);
+
+/* grunt_vm_step_observed()
+ *
+ * in:     p_vm     - VM to run the instruction on
+ *         p_packed - packed program holding the instruction, if it is
+ *                    a superinstruction, LOOKUP, or SWITCH, else NULL
+ *         p_i      - instruction at p_vm->pc
+ *         num_instructions - number of instructions in the program
+ * out:    p_vm     - as grunt_vm_step() or grunt_vm_step_fused()
+ *                    leaves it, with the instruction profiled,
+ *                    traced, or both, as the build asks
+ * return: grunt_vm_step()'s or grunt_vm_step_fused()'s status.
+ */
+
+static int
+grunt_vm_step_observed(grunt_vm_t *p_vm, const grunt_packed_program_t *p_packed,
+	const grunt_instruction_t *p_i, grunt_pc_t num_instructions) {
+
+	grunt_pc_t pc = p_vm->pc;  /* before the step moves it */
+#ifdef GRUNT_PROFILE
+	uint32 start;              /* tick count, if timed */
+	bool timed;
+#endif
+	int status;
+
+#ifdef GRUNT_TRACE
+	grunt_trace_step(p_vm, pc, p_i->op);
+#endif
+#ifdef GRUNT_PROFILE
+	timed  = grunt_profile_begin(p_vm, &start);
+#endif
+	status = (p_packed ? grunt_vm_step_fused(p_vm, p_packed, p_i) :
+		grunt_vm_step(p_vm, p_i, num_instructions));
+#ifdef GRUNT_PROFILE
+	grunt_profile_end(p_vm, pc, p_i->op, timed, start);
+#else
+	(void)pc;
+#endif
+
+	return status;
+
+} /* grunt_vm_step_observed() */
+
+#define GRUNT_VM_STEP(p_vm, p_i, n) \
+	grunt_vm_step_observed((p_vm), NULL, (p_i), (n))
+#define GRUNT_VM_STEP_FUSED(p_vm, p_packed, p_i) \
+	grunt_vm_step_observed((p_vm), (p_packed), (p_i), \
+		(p_packed)->num_instructions)
+#else
+#define GRUNT_VM_STEP       grunt_vm_step
+#define GRUNT_VM_STEP_FUSED grunt_vm_step_fused
+#endif /* GRUNT_PROFILE || GRUNT_TRACE */
+
+
+/* grunt_vm_run_switch()
+ *
+ * in:     p_vm             - VM to run program on
+ *         program          - Grunt program to run
+ *         num_instructions - number of instructions in program
+ * out:    *p_current       - program counter of the last instruction
+ *                            fetched, for error reporting
+ * return: GRUNT_HALT_TRUE/FALSE or a GRUNT_ERROR_* status code.
+ *
+ * The portable dispatch engine: fetches each instruction and
+ * dispatches it through the switch in grunt_vm_step().
+ */
+
+static int
+grunt_vm_run_switch(grunt_vm_t *p_vm, const grunt_instruction_t *program,
+	grunt_pc_t num_instructions, grunt_pc_t *p_current) {
+
+	int status;
+
+	/* This is the interpreter's main loop.  It interprets
+	 * instructions until we reach a HALT or an error.
+	 *
+	 * Analysts seeking to reason about Grunt's termination
+	 * behavior should note that Grunt's termination guarantee
+	 * argument is based on its monotonically increasting program
+	 * counter rather than on the bounds of this loop.  Only END
+	 * moves it backward, and only as many times as its REPEAT's
+	 * literal count allows.
+	 */
+	do {
+		*p_current = p_vm->pc;  /* save for error reporting */
+		
+		/* If we're about to try to execute an instruction
+		 * beyond the end of the Grunt program, report an
+		 * error and halt.  This condition can happen if we
+		 * are passed a zero-length program or if the program
+		 * counter runs off the end of the program before it
+		 * hits a HALT instruction.
+		 */
+		if (!(p_vm->pc < num_instructions)) {
+			status = GRUNT_ERROR_NOPROGRAM;
+			break;
+		}
+		
+	} while (!(status = GRUNT_VM_STEP(p_vm, &(program[p_vm->pc]),
+		num_instructions)));
+
+	return status;
+
+} /* grunt_vm_run_switch() */
+
+
+/* grunt_vm_step_fused()
+ *
+ * in:     p_vm     - VM to run the superinstruction on
+ *         p_packed - packed Grunt program
+ *         p_i      - unpacked instruction at p_vm->pc with an opcode
+ *                    past GRUNT_OP_SUB and before GRUNT_OP_REPEAT
+ * out:    p_vm->pc - next instruction to fetch; on error, one past
+ *                    the instruction in the sequence that failed
+ * return: the status the sequence's instructions would have returned
+ *         had grunt_vm_step() run them one at a time.
+ *
+ * Runs a superinstruction GRUNT_Pack() fused.  The words after the
+ * first in its sequence still hold their own instructions, so we
+ * unpack their arguments from there.  LOOKUPs and SWITCHes come here
+ * too, since their tables are likewise words of the packed program.
+ */
+
+static int
+grunt_vm_step_fused(grunt_vm_t *p_vm, const grunt_packed_program_t *p_packed,
+	const grunt_instruction_t *p_i) {
+
+	grunt_instruction_t next;  /* second instruction in sequence */
+	grunt_pc_t length = grunt_pack_fused_length(p_i->op);
+
+	p_vm->pc++;
+
+	if (p_i->op == GRUNT_OP_LOOKUP) {
+#ifdef GRUNT_COUNT_INSTRUCTIONS
+		p_vm->instruction_count++;
+#endif
+		return grunt_vm_lookup(p_vm, NULL, p_packed,
+			p_packed->num_instructions, p_i->arg.rep);
+	}
+	if (p_i->op == GRUNT_OP_SWITCH) {
+#ifdef GRUNT_COUNT_INSTRUCTIONS
+		p_vm->instruction_count++;
+#endif
+		return grunt_vm_switch(p_vm, NULL, p_packed,
+			p_packed->num_instructions, p_i->arg.rep);
+	}
+
+	/* GRUNT_Pack() never fuses a sequence that runs off the end
+	 * of the program, but GRUNT_RunPacked() may be handed code
+	 * packed some other way.
+	 */
+	if ((length == 0) ||
+		((p_packed->num_instructions - (p_vm->pc - 1)) < length))
+		return GRUNT_ERROR_INVALIDOPCODE;
+
+	grunt_pack_decode(p_packed, p_vm->pc, &next);
+#ifdef GRUNT_COUNT_INSTRUCTIONS
+	p_vm->instruction_count += length;
+#endif
+
+	switch (p_i->op) {
+	case GRUNT_OP_EQN:
+		return grunt_vm_eqn(p_vm, &(p_i->arg.lit), next.arg.rep);
+	case GRUNT_OP_DUPEQN:
+		return grunt_vm_dup_eqn(p_vm, &(next.arg.lit));
+	case GRUNT_OP_NOTJMPIF:
+		return grunt_vm_not_jmpif(p_vm, &(next.arg.lit));
+	case GRUNT_OP_INPUTLTN:
+		return grunt_vm_input_lt_gt(p_vm, p_i->arg.rep,
+			&(next.arg.lit), true);
+	case GRUNT_OP_INPUTGTN:
+		return grunt_vm_input_lt_gt(p_vm, p_i->arg.rep,
+			&(next.arg.lit), false);
+	}
+
+	return GRUNT_ERROR_INVALIDOPCODE;
+
+} /* grunt_vm_step_fused() */
+
+
+/* grunt_vm_run_packed()
+ *
+ * in:     p_vm       - VM to run program on
+ *         p_packed   - packed Grunt program to run
+ * out:    *p_current - program counter of the last instruction
+ *                      fetched, for error reporting
+ * return: GRUNT_HALT_TRUE/FALSE or a GRUNT_ERROR_* status code.
+ *
+ * The checked engine for packed programs: unpacks each instruction as
+ * it fetches it and dispatches it through grunt_vm_step(), so it
+ * produces the same results as the switch engine.  It runs each
+ * superinstruction with a single dispatch, and blames any error on
+ * the instruction within the sequence that failed.  LOOKUPs and
+ * SWITCHes, which read the words after their own, run through
+ * grunt_vm_step_fused() too.  REPEAT and END don't, so they run
+ * through grunt_vm_step() like the base instructions.
+ */
+
+static int
+grunt_vm_run_packed(grunt_vm_t *p_vm, const grunt_packed_program_t *p_packed,
+	grunt_pc_t *p_current) {
+
+	grunt_instruction_t instruction;  /* current unpacked instruction */
+	int status;
+
+	/* As in grunt_vm_run_switch(), termination rests on the
+	 * program counter, which only END moves backward.
+	 */
+	for (;;) {
+		*p_current = p_vm->pc;  /* save for error reporting */
+		
+		if (!(p_vm->pc < p_packed->num_instructions)) {
+			status = GRUNT_ERROR_NOPROGRAM;
+			break;
+		}
+		grunt_pack_decode(p_packed, p_vm->pc, &instruction);
+
+		if ((instruction.op > GRUNT_OP_SUB) &&
+			(instruction.op < GRUNT_OP_REPEAT)) {
+			if ((status = GRUNT_VM_STEP_FUSED(p_vm, p_packed,
+				&instruction))) {
+				*p_current = p_vm->pc - 1;
+				break;
+			}
+		} else if ((status = GRUNT_VM_STEP(p_vm, &instruction,
+			p_packed->num_instructions))) {
+			break;
+		}
+	}
+
+	return status;
+
+} /* grunt_vm_run_packed() */
+
+
+#ifdef GRUNT_THREADED_DISPATCH
+
+/* The threaded dispatch engine keeps, in each VM, a table containing
+ * one handler address for each instruction of the program that VM
+ * most recently ran, plus one trailing entry for the (invalid)
+ * instruction fetch just past its end.  It rebuilds the table only
+ * when asked to run a different program.  Like the programs
+ * themselves, the table is constant once built, so this engine
+ * expects programs to be constant arrays, as vsvf_program[] is.
+ * Programs too long for the table run on the switch engine instead.
+ */
+
+/* The cFS build asks for -pedantic, which objects to labels-as-values. */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+
+
+/* grunt_vm_run_threaded()
+ *
+ * in:     p_vm             - VM to run program on
+ *         program          - Grunt program to run
+ *         num_instructions - number of instructions in program
+ * out:    *p_current       - program counter of the last instruction
+ *                            fetched, for error reporting
+ * return: GRUNT_HALT_TRUE/FALSE or a GRUNT_ERROR_* status code.
+ *
+ * A direct-threaded dispatch engine built on the GCC labels-as-values
+ * extension.  Each handler jumps straight to the handler of the next
+ * instruction rather than returning to a central loop and switch.
+ * The handlers call the same grunt_vm_*() functions grunt_vm_step()
+ * calls, so both engines produce identical results.
+ *
+ * The trailing table entry sends sequential execution off the end of
+ * the program to the NOPROGRAM handler, so sequential instructions
+ * need no fetch bounds check.  Only CALL, END, JMPIF, LOOKUP, RETURN,
+ * and SWITCH can move the program counter elsewhere, so only they
+ * check it.
+ */
+
+static int
+grunt_vm_run_threaded(grunt_vm_t *p_vm, const grunt_instruction_t *program,
+	grunt_pc_t num_instructions, grunt_pc_t *p_current) {
+
+	const void **threaded = p_vm->threaded;  /* handler table */
+	grunt_pc_t pc;
+	int status;
+
+/* Fetch the next instruction and jump to its handler. */
+#ifdef GRUNT_COUNT_INSTRUCTIONS
+#define GRUNT_DISPATCH() do {			\
+		*p_current = p_vm->pc;		\
+		p_vm->instruction_count++;	\
+		goto *(threaded[p_vm->pc++]);	\
+	} while (0)
+#else
+#define GRUNT_DISPATCH() do {			\
+		*p_current = p_vm->pc;		\
+		goto *(threaded[p_vm->pc++]);	\
+	} while (0)
+#endif
+
+/* Finish the current instruction, failing on error status. */
+#define GRUNT_NEXT(handler_call) do {			\
+		if ((status = (handler_call))) goto done;	\
+		GRUNT_DISPATCH();				\
+	} while (0)
+
+/* Like GRUNT_NEXT(), but for instructions that may set the pc. */
+#define GRUNT_NEXT_CONTROL(handler_call) do {		\
+		if ((status = (handler_call))) goto done;	\
+		if (!(p_vm->pc < num_instructions))		\
+			goto op_noprogram_at_pc;		\
+		GRUNT_DISPATCH();				\
+	} while (0)
+
+	if (num_instructions > GRUNT_THREADED_MAX_INSTRUCTIONS)
+		return grunt_vm_run_switch(p_vm, program, num_instructions,
+			p_current);
+
+	/* Pre-decode the program into the handler address table if
+	 * we haven't already.
+	 */
+	if ((program != p_vm->threaded_program) ||
+		(num_instructions != p_vm->threaded_count)) {
+
+		for (pc = 0; pc < num_instructions; pc++) {
+			switch (program[pc].op) {
+			case GRUNT_OP_ADD:    threaded[pc] = &&op_add;    break;
+			case GRUNT_OP_AND:    threaded[pc] = &&op_and;    break;
+			case GRUNT_OP_CALL:   threaded[pc] = &&op_call;   break;
+			case GRUNT_OP_CLASSIFY:
+				threaded[pc] = &&op_classify;
+				break;
+			case GRUNT_OP_DUP:    threaded[pc] = &&op_dup;    break;
+			case GRUNT_OP_END:    threaded[pc] = &&op_end;    break;
+			case GRUNT_OP_EQ:     threaded[pc] = &&op_eq;     break;
+			case GRUNT_OP_FLUSH:  threaded[pc] = &&op_flush;  break;
+			case GRUNT_OP_FORMAT: threaded[pc] = &&op_format; break;
+			case GRUNT_OP_GT:     threaded[pc] = &&op_gt;     break;
+			case GRUNT_OP_HALT:   threaded[pc] = &&op_halt;   break;
+			case GRUNT_OP_INPUT:  threaded[pc] = &&op_input;  break;
+			case GRUNT_OP_INPUTREC:
+				threaded[pc] = &&op_inputrec;
+				break;
+			case GRUNT_OP_INPUTZ: threaded[pc] = &&op_inputz; break;
+			case GRUNT_OP_JMPIF:  threaded[pc] = &&op_jmpif;  break;
+			case GRUNT_OP_LOOKUP: threaded[pc] = &&op_lookup; break;
+			case GRUNT_OP_LT:     threaded[pc] = &&op_lt;     break;
+			case GRUNT_OP_NOT:    threaded[pc] = &&op_not;    break;
+			case GRUNT_OP_OUTPUT: threaded[pc] = &&op_output; break;
+			case GRUNT_OP_OR:     threaded[pc] = &&op_or;     break;
+			case GRUNT_OP_POP:    threaded[pc] = &&op_pop;    break;
+			case GRUNT_OP_PUSHB:  threaded[pc] = &&op_pushb;  break;
+			case GRUNT_OP_PUSHN:  threaded[pc] = &&op_pushn;  break;
+			case GRUNT_OP_PUSHS:  threaded[pc] = &&op_pushs;  break;
+			case GRUNT_OP_REPEAT: threaded[pc] = &&op_repeat; break;
+			case GRUNT_OP_RETURN: threaded[pc] = &&op_return; break;
+			case GRUNT_OP_REWIND: threaded[pc] = &&op_rewind; break;
+			case GRUNT_OP_ROLL:   threaded[pc] = &&op_roll;   break;
+			case GRUNT_OP_SUB:    threaded[pc] = &&op_sub;    break;
+			case GRUNT_OP_SWITCH: threaded[pc] = &&op_switch; break;
+			default:              threaded[pc] = &&op_invalid;
+			}
+		}
+		threaded[num_instructions] = &&op_noprogram;
+		p_vm->threaded_program = program;
+		p_vm->threaded_count   = num_instructions;
+	}
+
+	/* Start at pc 0.  Our argument for termination is the same
+	 * as the switch engine's: it rests on the program counter,
+	 * which only END moves backward.
+	 */
+	GRUNT_DISPATCH();
+
+op_add:
+	GRUNT_NEXT(grunt_vm_add_sub(p_vm, true));
+op_and:
+	GRUNT_NEXT(grunt_vm_and_or(p_vm, program[*p_current].arg.rep, true));
+op_call:
+	GRUNT_NEXT_CONTROL(grunt_vm_call(p_vm,
+		&(program[*p_current].arg.lit)));
+op_classify:
+	GRUNT_NEXT(grunt_vm_classify(p_vm, program[*p_current].arg.rep));
+op_dup:
+	GRUNT_NEXT(grunt_vm_dup(p_vm, program[*p_current].arg.rep));
+op_end:
+	GRUNT_NEXT_CONTROL(grunt_vm_end(p_vm));
+op_eq:
+	GRUNT_NEXT(grunt_vm_eq(p_vm, program[*p_current].arg.rep));
+op_flush:
+	GRUNT_NEXT(grunt_vm_flush(p_vm));
+op_format:
+	GRUNT_NEXT(grunt_vm_format(p_vm, program[*p_current].arg.rep));
+op_gt:
+	GRUNT_NEXT(grunt_vm_lt_gt(p_vm, false));
+op_halt:
+	status = grunt_vm_halt(p_vm);
+	goto done;
+op_input:
+	GRUNT_NEXT(grunt_vm_input(p_vm, program[*p_current].arg.rep));
+op_inputrec:
+	GRUNT_NEXT(grunt_vm_inputrec(p_vm, program[*p_current].arg.rep));
+op_inputz:
+	GRUNT_NEXT(grunt_vm_inputz(p_vm, program[*p_current].arg.rep));
+op_jmpif:
+	GRUNT_NEXT_CONTROL(grunt_vm_jmpif(p_vm,
+		&(program[*p_current].arg.lit)));
+op_lookup:
+	GRUNT_NEXT_CONTROL(grunt_vm_lookup(p_vm, &(program[p_vm->pc]), NULL,
+		num_instructions, program[*p_current].arg.rep));
+op_lt:
+	GRUNT_NEXT(grunt_vm_lt_gt(p_vm, true));
+op_not:
+	GRUNT_NEXT(grunt_vm_not(p_vm));
+op_output:
+	GRUNT_NEXT(grunt_vm_output(p_vm));
+op_or:
+	GRUNT_NEXT(grunt_vm_and_or(p_vm, program[*p_current].arg.rep, false));
+op_pop:
+	GRUNT_NEXT(grunt_vm_pop(p_vm, program[*p_current].arg.rep));
+op_pushb:
+	GRUNT_NEXT(grunt_vm_pushb(p_vm, &(program[*p_current].arg.lit)));
+op_pushn:
+	GRUNT_NEXT(grunt_vm_pushn(p_vm, &(program[*p_current].arg.lit)));
+op_pushs:
+	GRUNT_NEXT(grunt_vm_pushs(p_vm, &(program[*p_current].arg.lit)));
+op_repeat:
+	GRUNT_NEXT(grunt_vm_repeat(p_vm, program[*p_current].arg.rep));
+op_return:
+	GRUNT_NEXT_CONTROL(grunt_vm_return(p_vm));
+op_rewind:
+	GRUNT_NEXT(grunt_vm_rewind(p_vm, program[*p_current].arg.rep));
+op_roll:
+	GRUNT_NEXT(grunt_vm_roll(p_vm, program[*p_current].arg.rep));
+op_sub:
+	GRUNT_NEXT(grunt_vm_add_sub(p_vm, false));
+op_switch:
+	GRUNT_NEXT_CONTROL(grunt_vm_switch(p_vm, &(program[p_vm->pc]), NULL,
+		num_instructions, program[*p_current].arg.rep));
+op_invalid:
+	status = GRUNT_ERROR_INVALIDOPCODE;
+	goto done;
+op_noprogram_at_pc:
+	/* A CALL, END, JMPIF, LOOKUP, RETURN, or SWITCH moved the pc off
+	 * the end of the program.  Report the pc of the fetch that would have
+	 * failed.
+	 */
+	*p_current = p_vm->pc;
+op_noprogram:
+	status = GRUNT_ERROR_NOPROGRAM;
+done:
+	return status;
+
+#undef GRUNT_NEXT_CONTROL
+#undef GRUNT_NEXT
+#undef GRUNT_DISPATCH
+
+} /* grunt_vm_run_threaded() */
+
+#pragma GCC diagnostic pop
+
+#endif /* GRUNT_THREADED_DISPATCH */
+
+
 /* This routine reports runtime errors and interpreter bugs
  * encountered by the Grunt program.  Ideally, once you've debugged
  * your Grunt program, you won't get any of these.
@@ -139,6 +734,9 @@ grunt_vm_error(int status, grunt_pc_t pc) {
 	case GRUNT_ERROR_OUTOFBOUNDS:
 		msg = "out of bounds";
 		break;
+	case GRUNT_ERROR_BADSERIAL:
+		msg = "bad serialized program";
+		break;
 	default:
 		msg = "unknown error";
 	}
@@ -149,17 +747,323 @@ grunt_vm_error(int status, grunt_pc_t pc) {
 
 
 void
-grunt_vm_init(void) {
-	g_pc = 0;  /* 0 is the index of the first instruction in Grunt. */
+grunt_vm_init(grunt_vm_t *p_vm) {
+	p_vm->pc = 0;  /* 0 is the index of the first instruction in Grunt. */
+#ifdef GRUNT_COUNT_INSTRUCTIONS
+	p_vm->instruction_count = 0;
+#endif
 } /* grunt_vm_init() */
 
 
+grunt_vm_t *
+grunt_vm_default(void) {
+	return &g_vm;
+} /* grunt_vm_default() */
+
+
+/* grunt_vm_find_verified()
+ *
+ * in:     program          - Grunt program to look up
+ *         num_instructions - number of instructions in program
+ *         num_strings      - number of strings in program's string table
+ * out:    nothing
+ * return: program's entry in g_verified[], or NULL if GRUNT_Verify()
+ *         hasn't accepted it.
+ */
+
+static const grunt_verified_t *
+grunt_vm_find_verified(const grunt_instruction_t *program,
+	grunt_pc_t num_instructions, grunt_string_t num_strings) {
+
+	int count = g_num_verified;  /* entries [0, count) are complete */
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if ((g_verified[i].program == program) &&
+			(g_verified[i].num_instructions == num_instructions) &&
+			(g_verified[i].num_strings == num_strings))
+			return &(g_verified[i]);
+	}
+
+	return NULL;
+
+} /* grunt_vm_find_verified() */
+
+
+/* grunt_vm_load_verified()
+ *
+ * in:     program          - Grunt program to verify
+ *         num_instructions - number of instructions in program
+ *         num_strings      - number of strings in program's string table
+ * out:    g_verified[]     - new entry for program, if it verifies and
+ *                            there is room to keep it
+ * return: CFE_SUCCESS if the program verifies, else a GRUNT_ERROR_* code.
+ *
+ * Does GRUNT_Verify()'s work.  The caller must hold g_verify_mutex.
+ */
+
+static int32
+grunt_vm_load_verified(const grunt_instruction_t *program,
+	grunt_pc_t num_instructions, grunt_string_t num_strings) {
+
+	grunt_verified_t *p_v;  /* the new entry */
+	grunt_pc_t error_pc;    /* for error reporting */
+	int status;
+
+	/* Programs are constant, so one verification is enough. */
+	if (grunt_vm_find_verified(program, num_instructions, num_strings))
+		return CFE_SUCCESS;
+
+	if ((status = grunt_verify_program(program, num_instructions,
+		num_strings, ((num_instructions > GRUNT_VERIFIED_MAX_INSTRUCTIONS) ?
+			NULL : g_verified_types), &error_pc))) {
+		grunt_vm_error(status, error_pc);
+		return status;
+	}
+
+	if (!(g_num_verified < GRUNT_VERIFIED_MAX_PROGRAMS))
+		return CFE_SUCCESS;  /* verified, but no entry to keep it in */
+
+	/* Pack and lower the program into whatever storage earlier
+	 * entries left unused.
+	 */
+	p_v = &(g_verified[g_num_verified]);
+	p_v->packed.code             = &(g_verified_code[g_verified_code_used]);
+	p_v->packed.pool             = &(g_verified_pool[g_verified_pool_used]);
+	p_v->packed.max_instructions = (GRUNT_VERIFIED_MAX_INSTRUCTIONS -
+		g_verified_code_used);
+	p_v->packed.max_literals     = (GRUNT_VERIFIED_MAX_LITERALS -
+		g_verified_pool_used);
+	if (CFE_SUCCESS != GRUNT_Pack(program, num_instructions,
+		&(p_v->packed)))
+		return CFE_SUCCESS;  /* verified, but too big to pack */
+	p_v->is_typed = (0 == grunt_pack_type(&(p_v->packed),
+		g_verified_types));
+
+	p_v->lowered.code             = &(g_lowered_code[g_lowered_code_used]);
+	p_v->lowered.max_instructions = (GRUNT_LOWERED_MAX_INSTRUCTIONS -
+		g_lowered_code_used);
+	p_v->is_lowered = (0 == grunt_lower_program(program,
+		num_instructions, g_verified_types, &(p_v->lowered)));
+
+	g_verified_code_used += p_v->packed.num_instructions;
+	g_verified_pool_used += p_v->packed.num_literals;
+	if (p_v->is_lowered)
+		g_lowered_code_used += p_v->lowered.num_instructions;
+
+	p_v->jit.code = NULL;
+#ifdef GRUNT_JIT
+	if (p_v->is_lowered)
+		(void)grunt_jit_compile(&(p_v->lowered), &(p_v->jit));
+#endif
+
+	/* Publish the entry last, once it is complete. */
+	p_v->program          = program;
+	p_v->num_instructions = num_instructions;
+	p_v->num_strings      = num_strings;
+	g_num_verified++;
+	return CFE_SUCCESS;
+
+} /* grunt_vm_load_verified() */
+
+
+/* grunt_vm_prepare()
+ *
+ * in:     program          - Grunt program to prepare
+ *         num_instructions - number of instructions in program
+ *         string_table     - the program's table of constant strings
+ *         num_strings      - the number of strings in string_table
+ *         flags            - GRUNT_PREPARE_* flags
+ * out:    g_prepared[]     - new entry for program, if it verifies
+ *         *pp_prepared     - that entry
+ * return: CFE_SUCCESS if the program verifies, else a GRUNT_ERROR_* code.
+ *
+ * Does GRUNT_Prepare()'s work.  The caller must hold g_verify_mutex.
+ */
+
+static int32
+grunt_vm_prepare(const grunt_instruction_t *program,
+	grunt_pc_t num_instructions, const char *string_table[],
+	grunt_string_t num_strings, uint32 flags,
+	const grunt_prepared_t **pp_prepared) {
+
+	grunt_prepared_t *p_p;                 /* the new entry */
+	grunt_optimized_program_t optimized;   /* in g_prepared_code[] */
+	grunt_string_t s;
+	int32 status;
+
+	if (!(g_num_prepared < GRUNT_PREPARED_MAX_PROGRAMS) ||
+		(num_strings > (GRUNT_PREPARED_MAX_STRINGS -
+			g_prepared_lengths_used)))
+		return GRUNT_ERROR_OUTOFBOUNDS;
+
+	p_p = &(g_prepared[g_num_prepared]);
+	p_p->program          = program;
+	p_p->num_instructions = num_instructions;
+
+	/* Run the optimized copy if there is room for it.  Programs
+	 * that don't verify fail to optimize, and fail again below.
+	 */
+	if (flags & GRUNT_PREPARE_OPTIMIZE) {
+		optimized.code             =
+			&(g_prepared_code[g_prepared_code_used]);
+		optimized.origin           = NULL;
+		optimized.max_instructions = (GRUNT_PREPARED_MAX_INSTRUCTIONS -
+			g_prepared_code_used);
+		optimized.num_instructions = 0;
+		optimized.flags            = 0;
+		if (0 == grunt_optimize_program(program, num_instructions,
+			num_strings, &optimized)) {
+			p_p->program          = optimized.code;
+			p_p->num_instructions = optimized.num_instructions;
+		}
+	}
+
+	if ((status = grunt_vm_load_verified(p_p->program,
+		p_p->num_instructions, num_strings)))
+		return status;
+	p_p->p_v = grunt_vm_find_verified(p_p->program,
+		p_p->num_instructions, num_strings);
+
+	for (s = 0; s < num_strings; s++) {
+		g_prepared_lengths[g_prepared_lengths_used + s] =
+			(grunt_rep_t)strlen(string_table[s]);
+	}
+	p_p->string_table   = string_table;
+	p_p->num_strings    = num_strings;
+	p_p->string_lengths = &(g_prepared_lengths[g_prepared_lengths_used]);
+
+	if (p_p->program != program)
+		g_prepared_code_used += p_p->num_instructions;
+	g_prepared_lengths_used += num_strings;
+
+	/* Publish the entry last, once it is complete. */
+	g_num_prepared++;
+	*pp_prepared = p_p;
+	return CFE_SUCCESS;
+
+} /* grunt_vm_prepare() */
+
+
+/* grunt_vm_reset()
+ *
+ * in:     p_vm         - VM to reset
+ *         p_data       - data for the program's input queue
+ *         data_size    - size of p_data in bytes
+ *         string_table - the program's table of constant strings
+ *         num_strings  - the number of strings in string_table
+ * out:    *p_vm        - ready to run a program from its first
+ *                        instruction
+ * return: nothing
+ *
+ * Marks the reset with p_vm's perf_init_id, if it has one.
+ */
+
+static void
+grunt_vm_reset(grunt_vm_t *p_vm, const void *p_data, grunt_rep_t data_size,
+	const char *string_table[], grunt_string_t num_strings) {
+
+	if (p_vm->perf_init_id) CFE_ES_PerfLogEntry(p_vm->perf_init_id);
+
+	grunt_stack_init(p_vm);
+	grunt_input_init(p_vm, p_data, data_size);
+	grunt_output_init(p_vm, string_table, num_strings);
+	grunt_vm_init(p_vm);
+
+	if (p_vm->perf_init_id) CFE_ES_PerfLogExit(p_vm->perf_init_id);
+
+} /* grunt_vm_reset() */
+
+
+/* grunt_vm_run_program()
+ *
+ * in:     p_vm             - VM to run program on, freshly reset
+ *         p_v              - program's verified copies, or NULL
+ *         program          - Grunt program to run
+ *         num_instructions - number of instructions in program
+ * out:    *p_vm            - state left by the run
+ * return: GRUNT_HALT_TRUE/FALSE or a GRUNT_ERROR_* status code.
+ *
+ * Runs program on the fastest engine that can run it, or on the
+ * checked engine GRUNT_SetEngine() pinned the VM to.  Marks the run
+ * with p_vm's perf_run_id, if it has one.
+ */
+
+static int
+grunt_vm_run_program(grunt_vm_t *p_vm, const grunt_verified_t *p_v,
+	const grunt_instruction_t *program, grunt_pc_t num_instructions) {
+
+	grunt_pc_t current_instruction;  /* for error reporting */
+	int status;
+
+#ifdef GRUNT_PROFILE
+	p_vm->profile.runs++;
+	p_v = NULL;  /* profile the program itself, on the switch engine */
+#endif
+#ifdef GRUNT_TRACE
+	p_v = NULL;  /* trace the program itself, on the switch engine */
+#endif
+
+	if (p_vm->engine != GRUNT_ENGINE_AUTO)
+		p_v = NULL;  /* run the program itself, on a checked engine */
+
+	if (p_vm->perf_run_id) CFE_ES_PerfLogEntry(p_vm->perf_run_id);
+	if (p_v && p_v->jit.code) {
+		status = grunt_jit_run(p_vm, &(p_v->jit),
+			&current_instruction);
+	} else if (p_v && (p_v->is_lowered || p_v->is_typed)) {
+		status = (p_v->is_lowered ?
+			grunt_vm_run_register(p_vm, &(p_v->lowered),
+				&current_instruction) :
+			grunt_vm_run_verified(p_vm, &(p_v->packed),
+				&current_instruction));
+	} else {
+#ifdef GRUNT_THREADED_DISPATCH
+		status = ((p_vm->engine == GRUNT_ENGINE_SWITCH) ?
+			grunt_vm_run_switch(p_vm, program, num_instructions,
+				&current_instruction) :
+			grunt_vm_run_threaded(p_vm, program, num_instructions,
+				&current_instruction));
+#else
+		status = grunt_vm_run_switch(p_vm, program, num_instructions,
+			&current_instruction);
+#endif
+	}
+	if (p_vm->perf_run_id) CFE_ES_PerfLogExit(p_vm->perf_run_id);
+
+	/* If we reach here, the run loop terminated because
+	 *   (A) the Grunt program reached a HALT instruction,
+	 *   (B) the Grunt program had a run-time error, or
+	 *   (C) our interpreter has a bug.
+	 * Emit a debug message for cases B and C and return a status
+	 * code indicating what happened.
+	 */
+#ifdef GRUNT_TRACE
+	grunt_trace_end(p_vm, current_instruction, status);
+#endif
+	if (!((status == GRUNT_HALT_TRUE)||(status == GRUNT_HALT_FALSE)))
+		grunt_vm_error(status, current_instruction);
+
+	return status;
+
+} /* grunt_vm_run_program() */
+
+
 /* --------------------- exported functions -------------------- */
 
 int32
 GRUNT_Init(void) {
 
-	grunt_vm_init();
+	int32 status;
+
+	if (OS_SUCCESS != (status = OS_MutSemCreate(&g_verify_mutex,
+		"GRUNT_VERIFY", 0))) {
+		OS_printf("%s: OS_MutSemCreate() returned %d\n",
+			GRUNT_VERSION_STRING, (int)status);
+		return status;
+	}
+
+	GRUNT_InitCtx(&g_vm);
 	
 	/* Report our successfull initialization. */
 	OS_printf("%s initialized\n", GRUNT_VERSION_STRING);
@@ -169,56 +1073,597 @@ GRUNT_Init(void) {
 } /* GRUNT_Init() */
 
 
+/* GRUNT_InitCtx()
+ *
+ * in:     p_vm - VM to initialize
+ * out:    *p_vm - ready for GRUNT_RunCtx()
+ * return: nothing
+ *
+ * Callers must initialize each grunt_vm_t they keep once, before
+ * they first pass it to GRUNT_RunCtx().
+ */
+
+void
+GRUNT_InitCtx(grunt_vm_t *p_vm) {
+
+	memset(p_vm, 0, sizeof(*p_vm));  /* empties the threaded table */
+	grunt_vm_init(p_vm);
+
+} /* GRUNT_InitCtx() */
+
+
+/* GRUNT_SetEventSink()
+ *
+ * in:     p_vm - VM whose events to redirect, or NULL for the VM
+ *                GRUNT_Run(), GRUNT_RunBatch(), and native code use
+ *         sink - function to receive events, or NULL to restore EVS
+ *         arg  - argument to pass to sink
+ * out:    *p_vm - sink installed
+ * return: nothing
+ *
+ * Once installed, sink receives every event the VM's programs flush
+ * in place of CFE_EVS_SendEvent().  The message it receives is valid
+ * only until sink returns.  Callers collecting events into a report
+ * can use this to keep an invalid table from flooding the event
+ * stream.  The sink persists across runs and GRUNT_InitCtx() clears
+ * it.
+ */
+
+void
+GRUNT_SetEventSink(grunt_vm_t *p_vm, grunt_event_sink_t sink, void *arg) {
+
+	if (p_vm == NULL) p_vm = &g_vm;
+
+	p_vm->event_sink     = sink;
+	p_vm->event_sink_arg = arg;
+
+} /* GRUNT_SetEventSink() */
+
+
+/* GRUNT_SetEngine()
+ *
+ * in:     p_vm   - VM to set the engine of, or NULL for the VM
+ *                  GRUNT_Run() and GRUNT_RunBatch() use
+ *         engine - engine to run the VM's programs on
+ * out:    *p_vm  - engine set
+ * return: nothing
+ *
+ * Every engine produces the same results; only their speed differs.
+ * The choice persists across runs and GRUNT_InitCtx() restores
+ * GRUNT_ENGINE_AUTO.  Profiling and tracing builds run every program
+ * on the switch engine whatever the choice.
+ */
+
+void
+GRUNT_SetEngine(grunt_vm_t *p_vm, grunt_engine_t engine) {
+
+	if (p_vm == NULL) p_vm = &g_vm;
+
+	p_vm->engine = engine;
+
+} /* GRUNT_SetEngine() */
+
+
+/* GRUNT_SetPerfIDs()
+ *
+ * in:     p_vm     - VM whose runs to mark, or NULL for the VM
+ *                    GRUNT_Run(), GRUNT_RunBatch(), GRUNT_RunPacked(),
+ *                    and native code use
+ *         init_id  - perf ID to mark resetting the VM with, or 0
+ *         run_id   - perf ID to mark executing instructions with, or 0
+ *         flush_id - perf ID to mark flushing an event with, or 0
+ * out:    *p_vm    - perf IDs set
+ * return: nothing
+ *
+ * With these set, the CFE_ES_PerfLogEntry/Exit() pairs the VM logs
+ * let a test separate the time a validation function spends setting
+ * the VM up, interpreting its program, and sending events.  Every
+ * flush happens within a run, so its time is part of the run's, too.
+ * Native code resets only the output queue, which it marks as init,
+ * and runs no instructions the VM could mark.  The IDs persist across
+ * runs and GRUNT_InitCtx() clears them.
+ */
+
+void
+GRUNT_SetPerfIDs(grunt_vm_t *p_vm, uint32 init_id, uint32 run_id,
+	uint32 flush_id) {
+
+	if (p_vm == NULL) p_vm = &g_vm;
+
+	p_vm->perf_init_id  = init_id;
+	p_vm->perf_run_id   = run_id;
+	p_vm->perf_flush_id = flush_id;
+
+} /* GRUNT_SetPerfIDs() */
+
+
+/* GRUNT_SetStringLengths()
+ *
+ * in:     p_vm         - VM to give the lengths to, or NULL for the VM
+ *                        GRUNT_Run(), GRUNT_RunBatch(), and native code
+ *                        use
+ *         string_table - string table the lengths describe
+ *         lengths      - lengths[i] is strlen(string_table[i]), or NULL
+ *                        to have the VM measure strings as it outputs
+ *                        them
+ * out:    *p_vm        - lengths installed
+ * return: nothing
+ *
+ * The VM uses the lengths only while it runs programs with
+ * string_table, and measures the strings of other tables itself.
+ * gruntasm writes each program's lengths alongside its string table.
+ * The lengths persist across runs and GRUNT_InitCtx() clears them.
+ */
+
+void
+GRUNT_SetStringLengths(grunt_vm_t *p_vm, const char *string_table[],
+	const grunt_rep_t *lengths) {
+
+	if (p_vm == NULL) p_vm = &g_vm;
+
+	p_vm->lengths_table  = (lengths ? string_table : NULL);
+	p_vm->lengths        = lengths;
+	p_vm->string_lengths = NULL;  /* until the next run starts */
+
+} /* GRUNT_SetStringLengths() */
+
+
+/* GRUNT_SetRecordView()
+ *
+ * in:     p_vm   - VM whose input queue gets the view, or NULL for the
+ *                  VM GRUNT_Run() and GRUNT_RunBatch() use
+ *         p_view - record layout of the VM's programs' input, or NULL
+ *                  to remove the view
+ * out:    *p_vm  - view installed
+ * return: nothing
+ *
+ * Programs run on the VM read just as they would without the view,
+ * but reads that fall within a record already checked skip the input
+ * queue's per-read checks.  The view persists across runs and
+ * GRUNT_InitCtx() clears it.
+ */
+
+void
+GRUNT_SetRecordView(grunt_vm_t *p_vm, const grunt_record_view_t *p_view) {
+
+	if (p_vm == NULL) p_vm = &g_vm;
+
+	if (p_view) {
+		p_vm->record_view = *p_view;
+	} else {
+		p_vm->record_view.offset = 0;
+		p_vm->record_view.size   = 0;
+	}
+	p_vm->record_left = 0;
+
+} /* GRUNT_SetRecordView() */
+
+
+/* GRUNT_Verify()
+ *
+ * in:     program          - Grunt program to verify
+ *         num_instructions - number of instructions in program
+ *         num_strings      - number of strings in program's string table
+ * out:    nothing
+ * return: CFE_SUCCESS if the program verifies, else a GRUNT_ERROR_* code.
+ *
+ * Verifies that program can have no run-time errors other than those
+ * that depend on its input data.  If it verifies, subsequent calls to
+ * GRUNT_Run() or GRUNT_RunCtx() with the same program,
+ * num_instructions, and num_strings use the register machine core on
+ * a lowered copy of the program, or, if the program has no lowering,
+ * the verified stack engine on a packed copy.  GRUNT_JIT builds on
+ * hosts the JIT supports compile the lowered copy into machine code
+ * and run that instead.  If it does not verify, this
+ * function emits a debug message naming the first problem, just as
+ * GRUNT_Run() would, and GRUNT_Run() continues to run it on the
+ * checked engines.  Verified programs too large to pack, or that
+ * arrive after GRUNT_VERIFIED_MAX_PROGRAMS others or after the others
+ * have used up the storage for copies, still run on the checked
+ * engines.  Like the threaded engine, the verified engine expects
+ * programs to be constant arrays.
+ *
+ * Tasks may call this function concurrently, but should verify a
+ * program before any task runs it, as VSC does during its
+ * initialization.
+ */
+
+int32
+GRUNT_Verify(const grunt_instruction_t *program, grunt_pc_t num_instructions,
+	grunt_string_t num_strings) {
+
+	int32 status;
+
+	OS_MutSemTake(g_verify_mutex);
+	status = grunt_vm_load_verified(program, num_instructions,
+		num_strings);
+	OS_MutSemGive(g_verify_mutex);
+
+	return status;
+
+} /* GRUNT_Verify() */
+
+
+/* GRUNT_Optimize()
+ *
+ * in:     program          - Grunt program to optimize
+ *         num_instructions - number of instructions in program
+ *         num_strings      - number of strings in program's string table
+ *         p_optimized      - storage for the optimized program
+ * out:    *p_optimized     - optimized program, origin of each instruction
+ * return: GRUNT_OK or a GRUNT_ERROR_* status code.
+ *
+ * Rewrites a program GRUNT_Verify() accepts into one that produces
+ * the same output and result for every input but executes fewer
+ * instructions.  It removes instructions no run can reach, folds
+ * operations on literals, threads jumps, turns chains of
+ * compare-and-branch cases into LOOKUPs, and inlines calls of small
+ * leaf subroutines where the program still fits in p_optimized.  The
+ * optimized program uses the same string table.  Runs that fail with
+ * an error still fail, but may report it at another pc; origin[] maps
+ * each optimized pc back to the pc it came from.  Returns the
+ * verifier's status for programs that do not verify, and
+ * GRUNT_ERROR_OUTOFBOUNDS if the optimized program does not fit in
+ * p_optimized.
+ *
+ * Tasks may call this function concurrently.
+ */
+
+int32
+GRUNT_Optimize(const grunt_instruction_t *program,
+	grunt_pc_t num_instructions, grunt_string_t num_strings,
+	grunt_optimized_program_t *p_optimized) {
+
+	int32 status;
+
+	OS_MutSemTake(g_verify_mutex);
+	status = grunt_optimize_program(program, num_instructions,
+		num_strings, p_optimized);
+	OS_MutSemGive(g_verify_mutex);
+
+	return status;
+
+} /* GRUNT_Optimize() */
+
+
+/* GRUNT_Prepare()
+ *
+ * in:     program          - Grunt program to prepare
+ *         num_instructions - number of instructions in program
+ *         string_table     - the program's table of constant strings
+ *         num_strings      - the number of strings in string_table
+ *         flags            - GRUNT_PREPARE_* flags
+ * out:    *pp_prepared     - handle for GRUNT_RunPrepared(), if the
+ *                            program verifies
+ * return: CFE_SUCCESS if the program verifies, else a GRUNT_ERROR_* code.
+ *
+ * Does once all the work GRUNT_Run() would otherwise look up or redo
+ * on every run: it optimizes the program, given
+ * GRUNT_PREPARE_OPTIMIZE and room for the copy, verifies it, packs,
+ * types, and lowers it as GRUNT_Verify() does, and measures each of
+ * its strings.  Programs that don't verify don't prepare; this
+ * function emits a debug message naming the first problem, just as
+ * GRUNT_Verify() would.  It returns GRUNT_ERROR_OUTOFBOUNDS after
+ * GRUNT_PREPARED_MAX_PROGRAMS others, or once the others have used up
+ * the storage for string lengths.  A program too big to keep verified
+ * copies of still prepares, and runs on the checked engines.  The
+ * program and string table, like those GRUNT_Verify() accepts, must
+ * stay as they are for as long as the handle is in use.
+ *
+ * Tasks may call this function concurrently, but should prepare a
+ * program before any task runs it, as VSC does during its
+ * initialization.
+ */
+
+int32
+GRUNT_Prepare(const grunt_instruction_t *program, grunt_pc_t num_instructions,
+	const char *string_table[], grunt_string_t num_strings, uint32 flags,
+	const grunt_prepared_t **pp_prepared) {
+
+	int32 status;
+
+	OS_MutSemTake(g_verify_mutex);
+	status = grunt_vm_prepare(program, num_instructions, string_table,
+		num_strings, flags, pp_prepared);
+	OS_MutSemGive(g_verify_mutex);
+
+	return status;
+
+} /* GRUNT_Prepare() */
+
+
 int32
 GRUNT_Run(const grunt_instruction_t *program, grunt_pc_t num_instructions,
 	const void *p_data, grunt_rep_t data_size,
 	const char *string_table[], grunt_string_t num_strings) {
 
-	grunt_pc_t current_instruction;
-	int status = 0;
+	return GRUNT_RunCtx(&g_vm, program, num_instructions, p_data,
+		data_size, string_table, num_strings);
+
+} /* GRUNT_Run() */
+
+
+/* GRUNT_RunCtx()
+ *
+ * in:     p_vm             - VM to run program on
+ *         program          - Grunt program to run
+ *         num_instructions - number of instructions in program
+ *         p_data           - data for the program's input queue
+ *         data_size        - size of p_data in bytes
+ *         string_table     - the program's table of constant strings
+ *         num_strings      - the number of strings in string_table
+ * out:    *p_vm            - state left by the run
+ * return: GRUNT_HALT_TRUE/FALSE or a GRUNT_ERROR_* status code.
+ *
+ * Works exactly as GRUNT_Run() does, but on the caller's VM rather
+ * than the library's.  Runs on different VMs share nothing the
+ * interpreter writes, so tasks may make them concurrently.
+ */
+
+int32
+GRUNT_RunCtx(grunt_vm_t *p_vm, const grunt_instruction_t *program,
+	grunt_pc_t num_instructions, const void *p_data, grunt_rep_t data_size,
+	const char *string_table[], grunt_string_t num_strings) {
 
 	/* Initialize the VM to run the indicated Grunt program. */
-	grunt_stack_init();
-	grunt_input_init(p_data, data_size);
-	grunt_output_init(string_table, num_strings);
-	grunt_vm_init();
-	
-	/* This is the interpreter's main loop.  It interprets
-	 * instructions until we reach a HALT or an error.
-	 *
-	 * Analysts seeking to reason about Grunt's termination
-	 * behavior should note that Grunt's termination guarantee
-	 * argument is based on its monotonically increasting program
-	 * counter rather than on the bounds of this loop.
-	 */
-	do {
-		current_instruction = g_pc;  /* save for error reporting */
-		
-		/* If we're about to try to execute an instruction
-		 * beyond the end of the Grunt program, report an
-		 * error and halt.  This condition can happen if we
-		 * are passed a zero-length program or if the program
-		 * counter runs off the end of the program before it
-		 * hits a HALT instruction.
-		 */
-		if (!(g_pc < num_instructions)) {
-			status = GRUNT_ERROR_NOPROGRAM;
-			break;
-		}
-		
-	} while (!(status = grunt_vm_step(&(program[g_pc])))); 
+	grunt_vm_reset(p_vm, p_data, data_size, string_table, num_strings);
 
-	/* If we reach here, the run loop terminated because
-	 *   (A) the Grunt program reached a HALT instruction,
-	 *   (B) the Grunt program had a run-time error, or
-	 *   (C) our interpreter has a bug.
-	 * Emit a debug message for cases B and C and return a status
-	 * code indicating what happened.
+	return grunt_vm_run_program(p_vm, grunt_vm_find_verified(program,
+		num_instructions, num_strings), program, num_instructions);
+
+} /* GRUNT_RunCtx() */
+
+
+/* GRUNT_RunBatch()
+ *
+ * in:     program          - Grunt program to run
+ *         num_instructions - number of instructions in program
+ *         p_images         - num_images input images, back-to-back
+ *         image_size       - size of each image in bytes
+ *         num_images       - number of images at p_images
+ *         string_table     - the program's table of constant strings
+ *         num_strings      - the number of strings in string_table
+ * out:    results          - results[i] set to the status GRUNT_Run()
+ *                            would have returned for image i
+ * return: the number of images for which program halted true.
+ *
+ * Runs program over each image in turn on the VM GRUNT_Run() uses,
+ * just as num_images calls to GRUNT_Run() would, with the same
+ * events and debug messages.  It looks up the engine to use only
+ * once for the whole batch, and the threaded engine's decoded table
+ * carries over from one image to the next.
+ */
+
+int32
+GRUNT_RunBatch(const grunt_instruction_t *program, grunt_pc_t num_instructions,
+	const void *p_images, grunt_rep_t image_size, uint16 num_images,
+	const char *string_table[], grunt_string_t num_strings,
+	int32 results[]) {
+
+	const grunt_verified_t *p_v;         /* program's verified copies */
+	const uint8 *p_image = p_images;     /* current image */
+	int32 num_valid = 0;                 /* count of GRUNT_HALT_TRUEs */
+	uint16 i;
+
+	p_v = grunt_vm_find_verified(program, num_instructions, num_strings);
+
+	for (i = 0; i < num_images; i++) {
+		grunt_vm_reset(&g_vm, p_image, image_size, string_table,
+			num_strings);
+		results[i] = grunt_vm_run_program(&g_vm, p_v, program,
+			num_instructions);
+		if (results[i] == GRUNT_HALT_TRUE) num_valid++;
+		p_image += image_size;
+	}
+
+	return num_valid;
+
+} /* GRUNT_RunBatch() */
+
+
+/* GRUNT_RunPrepared()
+ *
+ * in:     p_prepared - handle GRUNT_Prepare() returned
+ *         p_data     - data for the program's input queue
+ *         data_size  - size of p_data in bytes
+ * out:    nothing
+ * return: GRUNT_HALT_TRUE/FALSE or a GRUNT_ERROR_* status code.
+ *
+ * Works as GRUNT_Run() does on the prepared program and its string
+ * table, with the same events and debug messages, on the same VM,
+ * but without looking up the program's verified copies or the
+ * lengths of its strings.  If GRUNT_Prepare() optimized the program,
+ * run-time errors may be reported at other pcs.
+ */
+
+int32
+GRUNT_RunPrepared(const grunt_prepared_t *p_prepared, const void *p_data,
+	grunt_rep_t data_size) {
+
+	grunt_vm_reset(&g_vm, p_data, data_size, p_prepared->string_table,
+		p_prepared->num_strings);
+	g_vm.string_lengths = p_prepared->string_lengths;
+
+	return grunt_vm_run_program(&g_vm, p_prepared->p_v,
+		p_prepared->program, p_prepared->num_instructions);
+
+} /* GRUNT_RunPrepared() */
+
+
+int32
+GRUNT_RunPacked(const grunt_packed_program_t *p_packed,
+	const void *p_data, grunt_rep_t data_size,
+	const char *string_table[], grunt_string_t num_strings) {
+
+	grunt_pc_t current_instruction;  /* for error reporting */
+	int status;
+
+	/* Initialize the VM to run the indicated Grunt program. */
+	grunt_vm_reset(&g_vm, p_data, data_size, string_table, num_strings);
+#ifdef GRUNT_PROFILE
+	g_vm.profile.runs++;
+#endif
+
+	if (g_vm.perf_run_id) CFE_ES_PerfLogEntry(g_vm.perf_run_id);
+	status = grunt_vm_run_packed(&g_vm, p_packed, &current_instruction);
+	if (g_vm.perf_run_id) CFE_ES_PerfLogExit(g_vm.perf_run_id);
+#ifdef GRUNT_TRACE
+	grunt_trace_end(&g_vm, current_instruction, status);
+#endif
+
+	/* Report run-time errors and interpreter bugs as GRUNT_Run()
+	 * does.
 	 */
 	if (!((status == GRUNT_HALT_TRUE)||(status == GRUNT_HALT_FALSE)))
 		grunt_vm_error(status, current_instruction);
 
 	return status;
 
-} /* GRUNT_Run() */
+} /* GRUNT_RunPacked() */
+
+
+#ifdef GRUNT_COUNT_INSTRUCTIONS
+
+/* GRUNT_GetInstructionCount()
+ *
+ * in:     p_vm - VM to query, or NULL for the one GRUNT_Run() uses
+ * out:    nothing
+ * return: number of instructions the checked engines executed during
+ *         the VM's most recent run.
+ *
+ * Only builds that define GRUNT_COUNT_INSTRUCTIONS count, and only
+ * the checked engines count, so a count describes the program and its
+ * input rather than the engine that ran it.  Runs of verified
+ * programs leave the count at 0.
+ */
+
+uint32
+GRUNT_GetInstructionCount(const grunt_vm_t *p_vm) {
+
+	return (p_vm ? p_vm : &g_vm)->instruction_count;
+
+} /* GRUNT_GetInstructionCount() */
+
+#endif /* GRUNT_COUNT_INSTRUCTIONS */
+
+
+#ifdef GRUNT_PROFILE
+
+/* GRUNT_GetProfile()
+ *
+ * in:     p_vm - VM to query, or NULL for the one GRUNT_Run(),
+ *                GRUNT_RunBatch(), and GRUNT_RunPacked() use
+ * out:    nothing
+ * return: the VM's execution profile, accumulated over all its runs
+ *         since GRUNT_InitCtx() or GRUNT_ResetProfile().
+ *
+ * The profile keeps changing as the VM runs programs, so callers
+ * should read it only between runs.
+ */
+
+const grunt_profile_t *
+GRUNT_GetProfile(const grunt_vm_t *p_vm) {
+
+	return &((p_vm ? p_vm : &g_vm)->profile);
+
+} /* GRUNT_GetProfile() */
+
+
+/* GRUNT_ResetProfile()
+ *
+ * in:     p_vm - VM whose profile to clear, or NULL for the one
+ *                GRUNT_Run() uses
+ * out:    p_vm->profile - zeroed
+ * return: nothing
+ */
+
+void
+GRUNT_ResetProfile(grunt_vm_t *p_vm) {
+
+	if (p_vm == NULL) p_vm = &g_vm;
+
+	memset(&(p_vm->profile), 0, sizeof(p_vm->profile));
+
+} /* GRUNT_ResetProfile() */
+
+#endif /* GRUNT_PROFILE */
+
+
+#ifdef GRUNT_TRACE
+
+/* GRUNT_GetTrace()
+ *
+ * in:     p_vm - VM to query, or NULL for the one GRUNT_Run(),
+ *                GRUNT_RunBatch(), and GRUNT_RunPacked() use
+ * out:    nothing
+ * return: the VM's execution trace: its last GRUNT_TRACE_SIZE steps
+ *         since GRUNT_InitCtx() or GRUNT_ResetTrace(), or as many as
+ *         it has taken.
+ *
+ * The trace keeps changing as the VM runs programs, so callers
+ * should read it only between runs.
+ */
+
+const grunt_trace_t *
+GRUNT_GetTrace(const grunt_vm_t *p_vm) {
+
+	return &((p_vm ? p_vm : &g_vm)->trace);
+
+} /* GRUNT_GetTrace() */
+
+
+/* GRUNT_ResetTrace()
+ *
+ * in:     p_vm - VM whose trace to clear, or NULL for the one
+ *                GRUNT_Run() uses
+ * out:    p_vm->trace - zeroed
+ * return: nothing
+ */
+
+void
+GRUNT_ResetTrace(grunt_vm_t *p_vm) {
+
+	if (p_vm == NULL) p_vm = &g_vm;
+
+	memset(&(p_vm->trace), 0, sizeof(p_vm->trace));
+
+} /* GRUNT_ResetTrace() */
+
+#endif /* GRUNT_TRACE */
+
+
+#ifdef GRUNT_FUZZ
+
+/* GRUNT_ForgetVerified()
+ *
+ * in:     nothing
+ * out:    g_verified[] - emptied, with the storage for its copies
+ *         g_prepared[] - likewise
+ * return: nothing
+ *
+ * Afterward GRUNT_Run() runs every program on the checked engines
+ * again, until GRUNT_Verify() accepts programs anew.  No task may be
+ * running a program while its caller forgets them, nor use a handle
+ * GRUNT_Prepare() returned before.
+ */
+
+void
+GRUNT_ForgetVerified(void) {
+
+	int i;
+
+	OS_MutSemTake(g_verify_mutex);
+	for (i = 0; i < g_num_verified; i++)
+		grunt_jit_release(&(g_verified[i].jit));
+	g_num_verified       = 0;
+	g_verified_code_used = 0;
+	g_verified_pool_used = 0;
+	g_lowered_code_used  = 0;
+	g_num_prepared          = 0;
+	g_prepared_code_used    = 0;
+	g_prepared_lengths_used = 0;
+	OS_MutSemGive(g_verify_mutex);
+
+} /* GRUNT_ForgetVerified() */
 
+#endif /* GRUNT_FUZZ */
@@ -31,22 +31,78 @@
  * implementations separate despite their both being queues since this
  * input queue is dequeue-only and the output queue is enqueue-only.
  */
-static const char *g_input_queue      = 0;  /* the input data queue */
-static grunt_rep_t g_input_queue_size = 0;  /* size of input data in bytes */
-static grunt_rep_t g_head_index       = 0;  /* index of next char to dequeue */
+/* Each grunt_vm_t holds its own input queue: input_queue is the
+ * input data, input_queue_size its size in bytes, and head_index the
+ * index of the next char to dequeue.
+ *
+ * A VM may also have a record view (see GRUNT_SetRecordView()).  When
+ * a read starts at the beginning of a record that lies wholly within
+ * the input, the queue checks that record's bounds once and sets
+ * record_left to its size.  Reads that fit within record_left then
+ * skip the initialization and bounds checks.  Any rewind clears
+ * record_left, since it may move the head out of the record.
+ *
+ * The queue hands back bare payloads.  INPUT and INPUTREC always read
+ * numbers and INPUTZ a Boolean, so the checked engines tag what they
+ * push themselves and the verified engines, which keep no types, don't.
+ */
+
+
+/* grunt_input_read()
+ *
+ * in:     p_head - first char of the number to read
+ *         n      - width of the number in bytes: 1, 2, or 4
+ * out:    p_v    - set to the number read
+ * return: value                        condition
+ *         -------------                ---------------
+ *         GRUNT_ERROR_INVALIDLITERAL   n is not 1, 2, or 4
+ *         0                            Success
+ *
+ * Reads in host byte order.  Table images carry no alignment
+ * guarantees, so reads go through memcpy() rather than casts; that's
+ * well-defined on strict-alignment CPUs and compiles to single loads
+ * on CPUs that allow unaligned access.
+ */
+
+static int
+grunt_input_read(grunt_payload_t *p_v, const char *p_head, grunt_rep_t n) {
+
+	uint32_t u32;
+	uint16_t u16;
+
+	switch (n) {
+	case 4:
+		memcpy(&u32, p_head, sizeof(u32));
+		p_v->num = u32;
+		break;
+	case 2:
+		memcpy(&u16, p_head, sizeof(u16));
+		p_v->num = u16;
+		break;
+	case 1:
+		p_v->num = *((const uint8_t *)p_head);
+		break;
+	default:
+		return GRUNT_ERROR_INVALIDLITERAL;
+	}
+
+	return 0;       /* OK! */
+
+} /* grunt_input_read() */
 
 
 int
-grunt_input_rewind(grunt_rep_t n) {
+grunt_input_rewind(grunt_vm_t *p_vm, grunt_rep_t n) {
 
 	/* Make sure we don't rewind past the start of the queue */
-	if (n > g_head_index) return GRUNT_ERROR_OUTOFBOUNDS;
+	if (n > p_vm->head_index) return GRUNT_ERROR_OUTOFBOUNDS;
 	
 	if (n == 0) {
-		g_head_index = 0;   /* REWIND 0 means rewind to start */
+		p_vm->head_index = 0;   /* REWIND 0 means rewind to start */
 	} else {
-		g_head_index -= n;  /* REWIND >0 means rewind by that much */
+		p_vm->head_index -= n;  /* REWIND >0 rewinds by that much */
 	}
+	p_vm->record_left = 0;
 
 	return 0;   /* OK! */
 	
@@ -54,48 +110,156 @@ grunt_input_rewind(grunt_rep_t n) {
 
 
 void
-grunt_input_init(const void *p_data, grunt_rep_t size) {
+grunt_input_init(grunt_vm_t *p_vm, const void *p_data, grunt_rep_t size) {
 
-	g_input_queue = (const char *)p_data;
-	g_input_queue_size = size;
-	grunt_input_rewind(0);
+	p_vm->input_queue = (const char *)p_data;
+	p_vm->input_queue_size = size;
+	grunt_input_rewind(p_vm, 0);   /* also clears record_left */
 	
 } /* grunt_input_init() */
 
 
-int
-grunt_input_dequeue(grunt_value_t *p_v, grunt_rep_t n) {
+/* grunt_input_take()
+ *
+ * in:     p_vm   - VM whose input queue to read
+ *         n      - number of bytes to take, at least 1
+ * out:    p_head - set to the first of the n bytes taken
+ * return: value                        condition
+ *         -------------                ---------------
+ *         GRUNT_ERROR_INTERPRETERBUG   input queue not initialized
+ *         GRUNT_ERROR_OUTOFBOUNDS      fewer than n bytes are left
+ *         0                            Success
+ *
+ * Checks the bounds of all n bytes at once, and consumes them.
+ */
+
+static int
+grunt_input_take(grunt_vm_t *p_vm, const char **p_head, grunt_rep_t n) {
+
+	const grunt_record_view_t *p_view = &(p_vm->record_view);
+
+	/* Fast path: the read lies within a record we've checked. */
+	if (n <= p_vm->record_left) {
+		*p_head = &(p_vm->input_queue[p_vm->head_index]);
+		p_vm->head_index  += n;
+		p_vm->record_left -= n;
+		return 0;       /* OK! */
+	}
 
 	/* Make sure we've been initialized. */
-	if (!g_input_queue) return GRUNT_ERROR_INTERPRETERBUG;
+	if (!p_vm->input_queue) return GRUNT_ERROR_INTERPRETERBUG;
+
+	/* Avoid reading off the end of the input data queue. */
+	if (((uint32)p_vm->head_index + n) > p_vm->input_queue_size)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+
+	/* If this read begins a record that lies wholly within the
+	 * input, check the rest of the record now.
+	 */
+	p_vm->record_left = 0;
+	if (p_view->size && (p_vm->head_index >= p_view->offset) &&
+		(((p_vm->head_index - p_view->offset) % p_view->size) == 0) &&
+		((p_vm->head_index + p_view->size) <= p_vm->input_queue_size) &&
+		(n <= p_view->size)) {
+		p_vm->record_left = p_view->size - n;
+	}
+
+	*p_head = &(p_vm->input_queue[p_vm->head_index]);
+	p_vm->head_index += n;  /* we've consumed n bytes of input */
+	return 0;       /* OK! */
+
+} /* grunt_input_take() */
+
+
+int
+grunt_input_dequeue(grunt_vm_t *p_vm, grunt_payload_t *p_v, grunt_rep_t n) {
+
+	const char *p_head;
+	int status;
+
+	/* Fast path: the read lies within a record we've checked. */
+	if (n <= p_vm->record_left) {
+		if ((status = grunt_input_read(p_v,
+			&(p_vm->input_queue[p_vm->head_index]), n)))
+			return status;
+		p_vm->head_index  += n;
+		p_vm->record_left -= n;
+		return 0;       /* OK! */
+	}
 
 	/* Grunt allows only 1-, 2-, or 4-byte reads.  Rule out this
 	 * error condition before checking the bounds.
 	 */
 	if (!((n == 1)||(n == 2)||(n == 4))) return GRUNT_ERROR_INVALIDLITERAL;
-	
-	/* Avoid reading off the end of the input data queue. */
-	if ((g_head_index + n) > g_input_queue_size)
-		return GRUNT_ERROR_OUTOFBOUNDS;
+
+	if ((status = grunt_input_take(p_vm, &p_head, n))) return status;
 
 	/* Read a number of the specified size. */
-	p_v->type = gt_num;
-	
-	switch (n) {
-	case 4:
-		p_v->val.num = *((uint32_t *)(&(g_input_queue[g_head_index])));
-		break;
-	case 2:
-		p_v->val.num = *((uint16_t *)(&(g_input_queue[g_head_index])));
-		break;
-	case 1:
-		p_v->val.num = *((uint8_t *)(&(g_input_queue[g_head_index])));
-		break;
-	default:
-		return GRUNT_ERROR_INTERPRETERBUG; /* checked this above */
+	return grunt_input_read(p_v, p_head, n);   /* n checked above */
+
+} /* grunt_input_dequeue() */
+
+
+/* grunt_input_fields()
+ *
+ * in:     layout - an INPUTREC layout, as described in grunt.h
+ * out:    p_size - set to the size of the record in bytes
+ * return: the number of fields in the record, or 0 if layout is
+ *         invalid: it has no fields, or bits past its last field.
+ */
+
+int
+grunt_input_fields(grunt_rep_t layout, grunt_rep_t *p_size) {
+
+	int i, w;
+
+	*p_size = 0;
+	for (i = 0; i < GRUNT_INPUTREC_MAX_FIELDS; i++) {
+		if (!(w = GRUNT_INPUTREC_WIDTH(layout, i))) break;
+		*p_size += w;
 	}
+	if ((i == 0) || (i < GRUNT_INPUTREC_MAX_FIELDS &&
+		(layout >> (2 * i))))
+		return 0;
+	return i;
+
+} /* grunt_input_fields() */
+
+
+int
+grunt_input_record(grunt_vm_t *p_vm, grunt_payload_t *p_fields, int *p_n,
+	grunt_rep_t layout) {
+
+	const char *p_head;
+	grunt_rep_t size;
+	int status, i, w;
+
+	if (!(*p_n = grunt_input_fields(layout, &size)))
+		return GRUNT_ERROR_INVALIDLITERAL;
+	if ((status = grunt_input_take(p_vm, &p_head, size))) return status;
 
-	g_head_index += n;  /* we've consumed n bytes of input */
+	for (i = 0; i < *p_n; i++) {
+		w = GRUNT_INPUTREC_WIDTH(layout, i);
+		grunt_input_read(&(p_fields[i]), p_head, (grunt_rep_t)w);
+		p_head += w;
+	}
 	return 0;       /* OK! */
 
-} /* grunt_input_dequeue() */
+} /* grunt_input_record() */
+
+
+int
+grunt_input_zero(grunt_vm_t *p_vm, grunt_payload_t *p_v, grunt_rep_t n) {
+
+	const char *p_head;
+	char any = 0;
+	int status;
+
+	if (n == 0) return GRUNT_ERROR_INVALIDLITERAL;
+	if ((status = grunt_input_take(p_vm, &p_head, n))) return status;
+
+	while (n--) any |= *(p_head++);
+	p_v->b = (any == 0);
+	return 0;       /* OK! */
+
+} /* grunt_input_zero() */
@@ -16,8 +16,11 @@
  * permissions and limitations under the License.
  */
 
-int  grunt_input_rewind(grunt_rep_t);
-void grunt_input_init(const void *, grunt_rep_t);
-int  grunt_input_dequeue(grunt_value_t *, grunt_rep_t);
+int  grunt_input_rewind(grunt_vm_t *, grunt_rep_t);
+void grunt_input_init(grunt_vm_t *, const void *, grunt_rep_t);
+int  grunt_input_dequeue(grunt_vm_t *, grunt_payload_t *, grunt_rep_t);
+int  grunt_input_fields(grunt_rep_t, grunt_rep_t *);
+int  grunt_input_record(grunt_vm_t *, grunt_payload_t *, int *, grunt_rep_t);
+int  grunt_input_zero(grunt_vm_t *, grunt_payload_t *, grunt_rep_t);
 
 #endif
@@ -0,0 +1,881 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module implements the JIT, which compiles the register machine
+ * form of a verified Grunt program (see grunt_lower.h) into x86-64
+ * machine code at GRUNT_Verify() time.  Ground and simulation builds
+ * on x86-64 hosts define GRUNT_JIT to have GRUNT_Run() run verified
+ * programs this way; flight builds leave it undefined and run them on
+ * the register machine core instead.
+ *
+ * The compiled code is one function in a buffer of its own, mapped
+ * writable while we fill it and executable, and no longer writable,
+ * afterward.  It keeps the register machine's frame pointer in rbx,
+ * the VM in r12, and the caller's error pc pointer in r13, and
+ * addresses each register as a displacement from rbx.  Each lowered
+ * routine becomes native code that the CALLs of its callers reach
+ * with native call instructions, so the native stack is the control
+ * stack; it holds each loop's count too.  A TAILCALL that moves the
+ * frame pointer needs a native call to move it back afterward, so
+ * only the others become jumps.  Every register machine
+ * instruction works in eax and ecx, and we remember which register
+ * eax last held so that the common case of an instruction consuming
+ * the previous one's result reads it from eax rather than memory.
+ * Input and output go through grunt_input.c and grunt_output.c,
+ * called as C functions.
+ *
+ * Like the register machine core, the compiled code performs only the
+ * checks that depend on the input data, and reports their failure
+ * with the same status codes and program counter values.  It relies
+ * on Boolean registers holding exactly 0 or 1, which the lowering
+ * pass guarantees.  Programs it can't compile, because they don't fit
+ * in GRUNT_JIT_MAX_CODE bytes or the host won't map executable
+ * memory, run on the register machine core as before.
+ */
+
+#define _DEFAULT_SOURCE    /* for MAP_ANONYMOUS */
+
+#include "cfe.h"
+
+#include "grunt_status.h"
+#include "grunt.h"
+#include "grunt_input.h"
+#include "grunt_output.h"
+#include "grunt_lower.h"
+#include "grunt_vm_register.h"
+#include "grunt_jit.h"
+
+#ifdef GRUNT_JIT_X86_64
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/* The biggest program we compile, in lowered instructions and in
+ * bytes of machine code.  The worst case is 30-some bytes of code per
+ * instruction.
+ */
+#define GRUNT_JIT_MAX_INSTRUCTIONS 2048
+#define GRUNT_JIT_MAX_CODE         (64*1024)
+
+/* x86-64 register numbers, as ModRM encodes them. */
+#define JIT_EAX 0
+#define JIT_ECX 1
+#define JIT_EDX 2
+#define JIT_EBX 3
+#define JIT_ESI 6
+
+#define JIT_NO_REG 127   /* eax holds no register machine register */
+
+/* The compiled function: file is the register file, p_vm the VM whose
+ * input and output queues to use, and p_current where to store the
+ * pc of a failing instruction.
+ */
+typedef int (*grunt_jit_fn_t)(grunt_reg_t *file, grunt_vm_t *p_vm,
+	grunt_pc_t *p_current);
+
+/* The compiler's state.  GRUNT_Verify() serializes compilations. */
+static uint8  *g_buf;        /* code being generated */
+static uint32  g_len;        /* bytes of it so far */
+static bool    g_overflow;   /* ran out of room in g_buf? */
+static int     g_cached;     /* register eax holds, or JIT_NO_REG */
+
+static uint32 g_offset[GRUNT_JIT_MAX_INSTRUCTIONS];  /* code of each */
+static bool   g_is_target[GRUNT_JIT_MAX_INSTRUCTIONS];  /* jumped to? */
+static bool   g_is_entry[GRUNT_JIT_MAX_INSTRUCTIONS];   /* called? */
+
+/* rel32 fields to patch once all the code is in place: jumps and
+ * calls to lowered instructions, jumps to the epilogue, and jumps
+ * to error exits that record a failing pc and, if status isn't 0,
+ * load status into eax.
+ */
+static struct {
+	uint32 at;        /* offset of rel32 field */
+	uint16 target;    /* lowered instruction */
+} g_jumps[GRUNT_JIT_MAX_INSTRUCTIONS + 1];
+static int g_num_jumps;
+
+static uint32 g_exits[GRUNT_JIT_MAX_INSTRUCTIONS];
+static int    g_num_exits;
+
+static struct {
+	uint32     at;
+	grunt_pc_t pc;
+	int        status;
+} g_fails[GRUNT_JIT_MAX_INSTRUCTIONS];
+static int g_num_fails;
+
+
+/* ------------------- module local functions -------------------- */
+
+static void
+jit_byte(uint8 b) {
+
+	if (g_len < GRUNT_JIT_MAX_CODE) {
+		g_buf[g_len++] = b;
+	} else {
+		g_overflow = true;
+	}
+
+} /* jit_byte() */
+
+
+static void
+jit_u32(uint32 u) {
+
+	jit_byte((uint8)u);
+	jit_byte((uint8)(u >> 8));
+	jit_byte((uint8)(u >> 16));
+	jit_byte((uint8)(u >> 24));
+
+} /* jit_u32() */
+
+
+static void
+jit_patch(uint32 at, uint32 target) {
+
+	uint32 rel = target - (at + 4);
+
+	g_buf[at]     = (uint8)rel;
+	g_buf[at + 1] = (uint8)(rel >> 8);
+	g_buf[at + 2] = (uint8)(rel >> 16);
+	g_buf[at + 3] = (uint8)(rel >> 24);
+
+} /* jit_patch() */
+
+
+/* jit_mem()
+ *
+ * in:     reg - x86-64 register for the ModRM reg field
+ *         r   - register machine register
+ * out:    g_buf - ModRM byte and displacement appended
+ * return: nothing
+ *
+ * Encodes the operand [rbx + 4*r], the register machine register r
+ * of the current frame.
+ */
+
+static void
+jit_mem(int reg, int r) {
+
+	int32 disp = 4 * r;
+
+	if ((disp >= -128) && (disp <= 127)) {
+		jit_byte((uint8)(0x40 | (reg << 3) | JIT_EBX));
+		jit_byte((uint8)disp);
+	} else {
+		jit_byte((uint8)(0x80 | (reg << 3) | JIT_EBX));
+		jit_u32((uint32)disp);
+	}
+
+} /* jit_mem() */
+
+
+/* jit_load()
+ *
+ * in:     reg - JIT_EAX, JIT_ECX, JIT_EDX, or JIT_ESI
+ *         r   - register machine register to load into it
+ * out:    g_buf - code appended
+ * return: nothing
+ *
+ * Loads r into reg, from eax if eax holds it.  Doesn't change eax.
+ */
+
+static void
+jit_load(int reg, int r) {
+
+	if (r == g_cached) {
+		if (reg == JIT_EAX) return;
+		jit_byte(0x89);                           /* mov reg, eax */
+		jit_byte((uint8)(0xC0 | (JIT_EAX << 3) | reg));
+		return;
+	}
+	jit_byte(0x8B);                                   /* mov reg, r */
+	jit_mem(reg, r);
+	if (reg == JIT_EAX) g_cached = r;
+
+} /* jit_load() */
+
+
+/* jit_load_pair()
+ *
+ * in:     a, b - register machine registers
+ * out:    g_buf - code to load a into eax and b into ecx appended
+ * return: nothing
+ */
+
+static void
+jit_load_pair(int a, int b) {
+
+	if ((b == g_cached) && (a != b)) {
+		jit_load(JIT_ECX, b);
+		jit_load(JIT_EAX, a);
+	} else {
+		jit_load(JIT_EAX, a);
+		jit_load(JIT_ECX, b);
+	}
+
+} /* jit_load_pair() */
+
+
+/* jit_store()
+ *
+ * in:     d - register machine register
+ * out:    g_buf - code to store eax into d appended
+ * return: nothing
+ */
+
+static void
+jit_store(int d) {
+
+	jit_byte(0x89);                                   /* mov d, eax */
+	jit_mem(JIT_EAX, d);
+	g_cached = d;
+
+} /* jit_store() */
+
+
+/* jit_setcc()
+ *
+ * in:     cc - x86 condition code
+ * out:    g_buf - code to set eax to 1 if cc holds, else 0, appended
+ * return: nothing
+ */
+
+static void
+jit_setcc(uint8 cc) {
+
+	jit_byte(0x0F);                                   /* setcc al */
+	jit_byte((uint8)(0x90 | cc));
+	jit_byte(0xC0);
+	jit_byte(0x0F);                                   /* movzx eax, al */
+	jit_byte(0xB6);
+	jit_byte(0xC0);
+
+} /* jit_setcc() */
+
+
+/* jit_fail_if()
+ *
+ * in:     cc     - x86 condition code
+ *         pc     - Grunt pc of the instruction being compiled
+ *         status - GRUNT_ERROR_* code, or 0 if eax holds the status
+ * out:    g_buf  - conditional jump to an error exit appended
+ * return: nothing
+ */
+
+static void
+jit_fail_if(uint8 cc, grunt_pc_t pc, int status) {
+
+	jit_byte(0x0F);                                   /* jcc rel32 */
+	jit_byte((uint8)(0x80 | cc));
+	g_fails[g_num_fails].at     = g_len;
+	g_fails[g_num_fails].pc     = pc;
+	g_fails[g_num_fails].status = status;
+	g_num_fails++;
+	jit_u32(0);
+
+} /* jit_fail_if() */
+
+
+/* jit_call_helper()
+ *
+ * in:     fn      - address of C function to call
+ *         pc      - Grunt pc of the instruction being compiled
+ *         checked - does fn return a status?
+ * out:    g_buf   - code appended
+ * return: nothing
+ *
+ * Calls fn with the VM as its first argument and whatever the caller
+ * already loaded into esi and edx as the others.  If fn is checked
+ * and returns a nonzero status, fails with that status at pc.
+ */
+
+static void
+jit_call_helper(uintptr_t fn, grunt_pc_t pc, bool checked) {
+
+	int i;
+
+	jit_byte(0x4C); jit_byte(0x89); jit_byte(0xE7);  /* mov rdi, r12 */
+	jit_byte(0x48); jit_byte(0xB8);                  /* mov rax, fn */
+	for (i = 0; i < 8; i++) jit_byte((uint8)(fn >> (8 * i)));
+	jit_byte(0xFF); jit_byte(0xD0);                  /* call rax */
+	g_cached = JIT_NO_REG;
+	if (checked) {
+		jit_byte(0x85); jit_byte(0xC0);          /* test eax, eax */
+		jit_fail_if(0x05, pc, 0);                /* jnz fail */
+	}
+
+} /* jit_call_helper() */
+
+
+/* grunt_jit_input()
+ *
+ * Runs INPUT for the compiled code, storing the value in *p_d.
+ */
+
+static int
+grunt_jit_input(grunt_vm_t *p_vm, grunt_reg_t *p_d, uint32 size) {
+
+	grunt_payload_t value;
+	int status;
+
+	if ((status = grunt_input_dequeue(p_vm, &value, (grunt_rep_t)size)))
+		return status;
+	*p_d = value.num;
+	return 0;
+
+} /* grunt_jit_input() */
+
+
+/* grunt_jit_inputrec()
+ *
+ * Runs INPUTREC for the compiled code, storing the fields in p_d[].
+ */
+
+static int
+grunt_jit_inputrec(grunt_vm_t *p_vm, grunt_reg_t *p_d, uint32 layout) {
+
+	grunt_payload_t fields[GRUNT_INPUTREC_MAX_FIELDS];
+	int status, n, k;
+
+	if ((status = grunt_input_record(p_vm, fields, &n,
+		(grunt_rep_t)layout)))
+		return status;
+	for (k = 0; k < n; k++) p_d[k] = fields[k].num;
+	return 0;
+
+} /* grunt_jit_inputrec() */
+
+
+/* grunt_jit_inputz()
+ *
+ * Runs INPUTZ for the compiled code, storing the result in *p_d.
+ */
+
+static int
+grunt_jit_inputz(grunt_vm_t *p_vm, grunt_reg_t *p_d, uint32 size) {
+
+	grunt_payload_t value;
+	int status;
+
+	if ((status = grunt_input_zero(p_vm, &value, (grunt_rep_t)size)))
+		return status;
+	*p_d = value.b;
+	return 0;
+
+} /* grunt_jit_inputz() */
+
+
+/* jit_instruction()
+ *
+ * in:     p_ri - register machine instruction to compile
+ * out:    g_buf - its code appended
+ * return: 0 on success, else GRUNT_ERROR_INTERPRETERBUG for an
+ *         opcode we can't compile.
+ */
+
+static int
+jit_instruction(const grunt_reg_instruction_t *p_ri) {
+
+	const grunt_reg_instruction_t *p_t;  /* a LOOKUP or SWITCH entry */
+	uint32 k;
+
+	switch (p_ri->op) {
+	case GRUNT_ROP_LDI:
+		jit_byte(0xB8);                           /* mov eax, imm */
+		jit_u32(p_ri->imm);
+		jit_store(p_ri->d);
+		break;
+	case GRUNT_ROP_MOV:
+		jit_load(JIT_EAX, p_ri->a);
+		jit_store(p_ri->d);
+		break;
+	case GRUNT_ROP_ADD:
+	case GRUNT_ROP_SUB:
+		jit_load_pair(p_ri->a, p_ri->b);
+		jit_byte((p_ri->op == GRUNT_ROP_ADD) ? 0x01 : 0x29);
+		jit_byte(0xC8);                           /* add/sub eax, ecx */
+		jit_fail_if(0x02, p_ri->pc, GRUNT_ERROR_OUTOFBOUNDS);  /* jc */
+		jit_store(p_ri->d);
+		break;
+	case GRUNT_ROP_AND:
+	case GRUNT_ROP_OR:
+		jit_load_pair(p_ri->a, p_ri->b);
+		jit_byte((p_ri->op == GRUNT_ROP_AND) ? 0x21 : 0x09);
+		jit_byte(0xC8);                           /* and/or eax, ecx */
+		jit_store(p_ri->d);
+		break;
+	case GRUNT_ROP_EQ:
+	case GRUNT_ROP_LT:
+		jit_load_pair(p_ri->a, p_ri->b);
+		jit_byte(0x39); jit_byte(0xC8);           /* cmp eax, ecx */
+		jit_setcc((p_ri->op == GRUNT_ROP_EQ) ? 0x04 : 0x02);  /* e/b */
+		jit_store(p_ri->d);
+		break;
+	case GRUNT_ROP_NOT:
+		jit_load(JIT_EAX, p_ri->a);
+		jit_byte(0x85); jit_byte(0xC0);           /* test eax, eax */
+		jit_setcc(0x04);                          /* sete */
+		jit_store(p_ri->d);
+		break;
+	case GRUNT_ROP_INPUT:
+	case GRUNT_ROP_INPUTREC:
+	case GRUNT_ROP_INPUTZ:
+		jit_byte(0x48); jit_byte(0x8D);           /* lea rsi, d */
+		jit_mem(JIT_ESI, p_ri->d);
+		jit_byte(0xBA);                           /* mov edx, imm */
+		jit_u32(p_ri->imm);
+		jit_call_helper(((p_ri->op == GRUNT_ROP_INPUT) ?
+			(uintptr_t)&grunt_jit_input :
+			(p_ri->op == GRUNT_ROP_INPUTREC) ?
+			(uintptr_t)&grunt_jit_inputrec :
+			(uintptr_t)&grunt_jit_inputz), p_ri->pc, true);
+		break;
+	case GRUNT_ROP_CLASSIFY:
+		jit_byte(0x48); jit_byte(0x8D);           /* lea rsi, d */
+		jit_mem(JIT_ESI, p_ri->d);
+		jit_byte(0xBA);                           /* mov edx, imm */
+		jit_u32(p_ri->imm);
+		jit_call_helper((uintptr_t)&grunt_vm_register_classify,
+			p_ri->pc, false);
+		break;
+	case GRUNT_ROP_REWIND:
+		jit_byte(0xBE);                           /* mov esi, imm */
+		jit_u32(p_ri->imm);
+		jit_call_helper((uintptr_t)&grunt_input_rewind, p_ri->pc,
+			true);
+		break;
+	case GRUNT_ROP_OUTB:
+		jit_load(JIT_ESI, p_ri->a);
+		jit_call_helper((uintptr_t)&grunt_output_enqueue_boolean,
+			p_ri->pc, true);
+		break;
+	case GRUNT_ROP_OUTN:
+		jit_load(JIT_ESI, p_ri->a);
+		jit_call_helper((uintptr_t)&grunt_output_enqueue_number,
+			p_ri->pc, true);
+		break;
+	case GRUNT_ROP_OUTS:
+		jit_load(JIT_ESI, p_ri->a);
+		jit_call_helper((uintptr_t)&grunt_output_enqueue_string,
+			p_ri->pc, true);
+		break;
+	case GRUNT_ROP_FORMAT:
+		jit_byte(0x48); jit_byte(0x8D);           /* lea rsi, a */
+		jit_mem(JIT_ESI, p_ri->a);
+		jit_byte(0xBA);                           /* mov edx, imm */
+		jit_u32(p_ri->imm);
+		jit_call_helper((uintptr_t)&grunt_vm_register_format,
+			p_ri->pc, true);
+		break;
+	case GRUNT_ROP_FLUSH:
+		jit_load(JIT_ESI, p_ri->a);
+		jit_load(JIT_EDX, p_ri->b);
+		jit_call_helper((uintptr_t)&grunt_output_flush, p_ri->pc,
+			false);
+		break;
+	case GRUNT_ROP_HALT:
+		/* 2 - 1 is GRUNT_HALT_TRUE, 2 - 0 GRUNT_HALT_FALSE. */
+		jit_load(JIT_EAX, p_ri->a);
+		jit_byte(0xF7); jit_byte(0xD8);           /* neg eax */
+		jit_byte(0x83); jit_byte(0xC0);           /* add eax, 2 */
+		jit_byte(GRUNT_HALT_FALSE);
+		jit_byte(0xE9);                           /* jmp epilogue */
+		g_exits[g_num_exits++] = g_len;
+		jit_u32(0);
+		break;
+	case GRUNT_ROP_JMPIF:
+		jit_load(JIT_EAX, p_ri->a);
+		jit_byte(0x85); jit_byte(0xC0);           /* test eax, eax */
+		jit_byte(0x0F); jit_byte(0x85);           /* jnz target */
+		g_jumps[g_num_jumps].at     = g_len;
+		g_jumps[g_num_jumps].target = (uint16)p_ri->imm;
+		g_num_jumps++;
+		jit_u32(0);
+		break;
+	case GRUNT_ROP_TAILCALL:
+		/* Callers put rbx back themselves after each call, so
+		 * only a tail call that leaves rbx alone can jump.
+		 */
+		if (!p_ri->a) {
+			jit_byte(0x48); jit_byte(0x83);   /* add rsp, 8 */
+			jit_byte(0xC4); jit_byte(0x08);
+			jit_byte(0xE9);                   /* jmp target */
+			g_jumps[g_num_jumps].at     = g_len;
+			g_jumps[g_num_jumps].target = (uint16)p_ri->imm;
+			g_num_jumps++;
+			jit_u32(0);
+			break;
+		}
+		/* Others are a CALL and a RET; fall through. */
+	case GRUNT_ROP_CALL:
+		if (p_ri->a) {
+			jit_byte(0x48); jit_byte(0x8D);   /* lea rbx, a */
+			jit_mem(JIT_EBX, p_ri->a);
+		}
+		jit_byte(0xE8);                           /* call target */
+		g_jumps[g_num_jumps].at     = g_len;
+		g_jumps[g_num_jumps].target = (uint16)p_ri->imm;
+		g_num_jumps++;
+		jit_u32(0);
+		if (p_ri->a) {
+			jit_byte(0x48); jit_byte(0x8D);   /* lea rbx, -a */
+			jit_mem(JIT_EBX, -p_ri->a);
+		}
+		g_cached = JIT_NO_REG;
+		if (p_ri->op == GRUNT_ROP_TAILCALL) {
+			jit_byte(0x48); jit_byte(0x83);   /* add rsp, 8 */
+			jit_byte(0xC4); jit_byte(0x08);
+			jit_byte(0xC3);                   /* ret */
+		}
+		break;
+	case GRUNT_ROP_RET:
+		jit_byte(0x48); jit_byte(0x83);           /* add rsp, 8 */
+		jit_byte(0xC4); jit_byte(0x08);
+		jit_byte(0xC3);                           /* ret */
+		break;
+	case GRUNT_ROP_LOOP:
+		/* The count takes 16 bytes of native stack, keeping rsp
+		 * aligned for the C calls in the body.
+		 */
+		jit_byte(0x48); jit_byte(0x83);           /* sub rsp, 16 */
+		jit_byte(0xEC); jit_byte(0x10);
+		jit_byte(0xC7); jit_byte(0x04);           /* mov dword [rsp], */
+		jit_byte(0x24); jit_u32(p_ri->imm);       /*   imm */
+		break;
+	case GRUNT_ROP_NEXT:
+		jit_byte(0xFF); jit_byte(0x0C);           /* dec dword [rsp] */
+		jit_byte(0x24);
+		jit_byte(0x0F); jit_byte(0x85);           /* jnz body */
+		g_jumps[g_num_jumps].at     = g_len;
+		g_jumps[g_num_jumps].target = (uint16)p_ri->imm;
+		g_num_jumps++;
+		jit_u32(0);
+		jit_byte(0x48); jit_byte(0x83);           /* add rsp, 16 */
+		jit_byte(0xC4); jit_byte(0x10);
+		break;
+	case GRUNT_ROP_LOOKUP:
+		/* Start from the default string and let each key, last
+		 * to first, replace it on a match, so the first match
+		 * wins.
+		 */
+		for (p_t = p_ri + 1; p_t->op == GRUNT_ROP_CASE; p_t += 2)
+			;
+		jit_load(JIT_ECX, p_ri->a);
+		jit_byte(0xB8);                           /* mov eax, default */
+		jit_u32(p_t->imm);
+		while (p_t > (p_ri + 1)) {
+			p_t -= 2;
+			jit_byte(0x81); jit_byte(0xF9);   /* cmp ecx, key */
+			jit_u32(p_t->imm);
+			jit_byte(0xBA);                   /* mov edx, value */
+			jit_u32(p_t[1].imm);
+			jit_byte(0x0F); jit_byte(0x44);   /* cmove eax, edx */
+			jit_byte(0xC2);
+		}
+		jit_store(p_ri->d);
+		jit_byte(0xE9);                           /* jmp target */
+		g_jumps[g_num_jumps].at     = g_len;
+		g_jumps[g_num_jumps].target = (uint16)p_ri->imm;
+		g_num_jumps++;
+		jit_u32(0);
+		break;
+	case GRUNT_ROP_SWITCH:
+		/* Keys past the table go to the default.  The others
+		 * index a table of rel32s placed right after the jump,
+		 * each relative to the end of its own entry as a jmp's
+		 * would be, so the table patches like any other jump.
+		 * It starts the 14 bytes of code after the lea past it.
+		 */
+		p_t = p_ri + 1;
+		jit_load(JIT_ECX, p_ri->a);
+		jit_byte(0x81); jit_byte(0xF9);           /* cmp ecx, imm */
+		jit_u32(p_ri->imm);
+		jit_byte(0x0F); jit_byte(0x83);           /* jae default */
+		g_jumps[g_num_jumps].at     = g_len;
+		g_jumps[g_num_jumps].target = (uint16)p_t[p_ri->imm].imm;
+		g_num_jumps++;
+		jit_u32(0);
+		jit_byte(0x48); jit_byte(0x8D);           /* lea rdx, table */
+		jit_byte(0x15); jit_u32(14);
+		jit_byte(0x48); jit_byte(0x8D);           /* lea rdx, */
+		jit_byte(0x54); jit_byte(0x8A);           /*   [rdx+4*rcx+4] */
+		jit_byte(0x04);
+		jit_byte(0x48); jit_byte(0x63);           /* movsxd rax, */
+		jit_byte(0x42); jit_byte(0xFC);           /*   [rdx-4] */
+		jit_byte(0x48); jit_byte(0x01);           /* add rax, rdx */
+		jit_byte(0xD0);
+		jit_byte(0xFF); jit_byte(0xE0);           /* jmp rax */
+		for (k = 0; k < p_ri->imm; k++) {
+			g_jumps[g_num_jumps].at     = g_len;
+			g_jumps[g_num_jumps].target = (uint16)p_t[k].imm;
+			g_num_jumps++;
+			jit_u32(0);
+		}
+		g_cached = JIT_NO_REG;
+		break;
+	case GRUNT_ROP_CASE:
+	case GRUNT_ROP_VALUE:
+		break;   /* a LOOKUP's or SWITCH's table, never executed */
+	default:
+		return GRUNT_ERROR_INTERPRETERBUG;  /* lowering bug */
+	}
+
+	return 0;
+
+} /* jit_instruction() */
+
+
+/* jit_generate()
+ *
+ * in:     p_lowered - lowered program to compile
+ * out:    g_buf     - the program's code
+ *         g_len     - its size
+ * return: 0 on success, else a GRUNT_ERROR_* code.
+ *
+ * The prologue saves the registers the code uses and enters the main
+ * routine with rsp 16-byte aligned, as C calls require.  Each routine
+ * a CALL enters restores that alignment, which the call's return
+ * address upset, and undoes it on RET.  HALT and the error exits jump
+ * to the epilogue, which unwinds from any call depth by restoring the
+ * rsp the prologue saved in r14.
+ */
+
+static int
+jit_generate(const grunt_lowered_program_t *p_lowered) {
+
+	static const uint8 prologue[] = {
+		0x53,                     /* push rbx */
+		0x41, 0x54,               /* push r12 */
+		0x41, 0x55,               /* push r13 */
+		0x41, 0x56,               /* push r14 */
+		0x48, 0x83, 0xEC, 0x08,   /* sub rsp, 8 */
+		0x48, 0x89, 0xFB,         /* mov rbx, rdi */
+		0x49, 0x89, 0xF4,         /* mov r12, rsi */
+		0x49, 0x89, 0xD5,         /* mov r13, rdx */
+		0x49, 0x89, 0xE6,         /* mov r14, rsp */
+	};
+	static const uint8 epilogue[] = {
+		0x4C, 0x89, 0xF4,         /* mov rsp, r14 */
+		0x48, 0x83, 0xC4, 0x08,   /* add rsp, 8 */
+		0x41, 0x5E,               /* pop r14 */
+		0x41, 0x5D,               /* pop r13 */
+		0x41, 0x5C,               /* pop r12 */
+		0x5B,                     /* pop rbx */
+		0xC3,                     /* ret */
+	};
+	const grunt_reg_instruction_t *p_ri;
+	uint32 epilogue_at;   /* offset of epilogue */
+	uint32 k;
+	uint16 i;
+	int j;
+	int status;
+
+	if (p_lowered->num_instructions > GRUNT_JIT_MAX_INSTRUCTIONS)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+
+	g_len = 0;
+	g_overflow  = false;
+	g_num_jumps = 0;
+	g_num_exits = 0;
+	g_num_fails = 0;
+
+	/* Find the jump targets, where eax may hold anything, and the
+	 * routine entry points.
+	 */
+	memset(g_is_target, 0, sizeof(g_is_target));
+	memset(g_is_entry, 0, sizeof(g_is_entry));
+	for (i = 0; i < p_lowered->num_instructions; i++) {
+		p_ri = &(p_lowered->code[i]);
+		if (p_ri->op == GRUNT_ROP_SWITCH) {
+			for (k = 1; k <= (p_ri->imm + 1); k++) {
+				if (p_ri[k].imm < p_lowered->num_instructions)
+					g_is_target[p_ri[k].imm] = true;
+			}
+		}
+		if (p_ri->imm >= p_lowered->num_instructions) continue;
+		if ((p_ri->op == GRUNT_ROP_JMPIF) ||
+			(p_ri->op == GRUNT_ROP_LOOKUP) ||
+			(p_ri->op == GRUNT_ROP_NEXT))
+			g_is_target[p_ri->imm] = true;
+		if ((p_ri->op == GRUNT_ROP_CALL) ||
+			(p_ri->op == GRUNT_ROP_TAILCALL))
+			g_is_entry[p_ri->imm] = true;
+	}
+
+	for (j = 0; j < (int)sizeof(prologue); j++) jit_byte(prologue[j]);
+	jit_byte(0xE9);                                   /* jmp start */
+	g_jumps[g_num_jumps].at     = g_len;
+	g_jumps[g_num_jumps].target = p_lowered->start;
+	g_num_jumps++;
+	jit_u32(0);
+
+	/* Only straight-line code may assume what eax holds. */
+	g_cached = JIT_NO_REG;
+	for (i = 0; i < p_lowered->num_instructions; i++) {
+		g_offset[i] = g_len;
+		if (g_is_target[i] || g_is_entry[i] ||
+			(i == p_lowered->start))
+			g_cached = JIT_NO_REG;
+		if (g_is_entry[i]) {
+			jit_byte(0x48); jit_byte(0x83);   /* sub rsp, 8 */
+			jit_byte(0xEC); jit_byte(0x08);
+		}
+		if ((status = jit_instruction(&(p_lowered->code[i]))))
+			return status;
+	}
+
+	epilogue_at = g_len;
+	for (j = 0; j < (int)sizeof(epilogue); j++) jit_byte(epilogue[j]);
+
+	for (j = 0; j < g_num_fails; j++) {
+		if (g_overflow) break;
+		jit_patch(g_fails[j].at, g_len);
+		jit_byte(0x66); jit_byte(0x41);   /* mov word [r13], pc */
+		jit_byte(0xC7); jit_byte(0x45); jit_byte(0x00);
+		jit_byte((uint8)g_fails[j].pc);
+		jit_byte((uint8)(g_fails[j].pc >> 8));
+		if (g_fails[j].status) {
+			jit_byte(0xB8);                   /* mov eax, status */
+			jit_u32((uint32)g_fails[j].status);
+		}
+		jit_byte(0xE9);                           /* jmp epilogue */
+		jit_u32(epilogue_at - (g_len + 4));
+	}
+
+	if (g_overflow) return GRUNT_ERROR_OUTOFBOUNDS;
+
+	for (j = 0; j < g_num_jumps; j++) {
+		if (g_jumps[j].target >= p_lowered->num_instructions)
+			return GRUNT_ERROR_INTERPRETERBUG;
+		jit_patch(g_jumps[j].at, g_offset[g_jumps[j].target]);
+	}
+	for (j = 0; j < g_num_exits; j++)
+		jit_patch(g_exits[j], epilogue_at);
+
+	return 0;
+
+} /* jit_generate() */
+
+#endif /* GRUNT_JIT_X86_64 */
+
+
+/* ------------------- module exported functions -------------------- */
+
+
+/* grunt_jit_compile()
+ *
+ * in:     p_lowered - lowered form of a verified program
+ * out:    *p_jit    - the program's compiled code, or code NULL if
+ *                     it has none
+ * return: 0 on success, else a GRUNT_ERROR_* code explaining why the
+ *         program has no compiled code.
+ *
+ * GRUNT_Verify() calls this function, under its mutex, for each
+ * program it lowers.  The code lives as long as the program's entry
+ * among the verified programs, which is forever but in GRUNT_FUZZ
+ * builds.
+ */
+
+int
+grunt_jit_compile(const grunt_lowered_program_t *p_lowered,
+	grunt_jit_code_t *p_jit) {
+
+#ifdef GRUNT_JIT_X86_64
+	void *p_map;
+	int status;
+
+	p_jit->code = NULL;
+	p_jit->size = 0;
+
+	p_map = mmap(NULL, GRUNT_JIT_MAX_CODE, (PROT_READ | PROT_WRITE),
+		(MAP_PRIVATE | MAP_ANONYMOUS), -1, 0);
+	if (p_map == MAP_FAILED) return GRUNT_ERROR_OUTOFBOUNDS;
+
+	g_buf = (uint8 *)p_map;
+	if ((status = jit_generate(p_lowered)) ||
+		mprotect(p_map, GRUNT_JIT_MAX_CODE, (PROT_READ | PROT_EXEC))) {
+		(void)munmap(p_map, GRUNT_JIT_MAX_CODE);
+		return (status ? status : GRUNT_ERROR_OUTOFBOUNDS);
+	}
+
+	p_jit->code = (const uint8 *)p_map;
+	p_jit->size = g_len;
+	return 0;
+#else
+	(void)p_lowered;
+	p_jit->code = NULL;
+	p_jit->size = 0;
+	return GRUNT_ERROR_INVALIDOPCODE;  /* no code generator here */
+#endif
+
+} /* grunt_jit_compile() */
+
+
+/* grunt_jit_run()
+ *
+ * in:     p_vm       - VM whose input and output queues to use
+ *         p_jit      - compiled program to run
+ * out:    *p_current - program counter of the Grunt instruction that
+ *                      failed, for error reporting
+ * return: GRUNT_HALT_TRUE/FALSE or a GRUNT_ERROR_* status code.
+ */
+
+int
+grunt_jit_run(grunt_vm_t *p_vm, const grunt_jit_code_t *p_jit,
+	grunt_pc_t *p_current) {
+
+#ifdef GRUNT_JIT_X86_64
+	grunt_reg_t file[GRUNT_LOWER_NUM_REGISTERS];  /* the registers */
+	grunt_jit_fn_t fn = (grunt_jit_fn_t)(uintptr_t)p_jit->code;
+
+	return fn(file, p_vm, p_current);
+#else
+	(void)p_vm;
+	(void)p_jit;
+	*p_current = 0;
+	return GRUNT_ERROR_INTERPRETERBUG;  /* never compiled anything */
+#endif
+
+} /* grunt_jit_run() */
+
+
+#ifdef GRUNT_FUZZ
+
+/* grunt_jit_release()
+ *
+ * in:     p_jit  - compiled code grunt_jit_compile() made, or none
+ * out:    *p_jit - code NULL, its memory unmapped
+ * return: nothing
+ *
+ * GRUNT_ForgetVerified() calls this function for each program it
+ * forgets.
+ */
+
+void
+grunt_jit_release(grunt_jit_code_t *p_jit) {
+
+#ifdef GRUNT_JIT_X86_64
+	if (p_jit->code)
+		(void)munmap((void *)(uintptr_t)p_jit->code,
+			GRUNT_JIT_MAX_CODE);
+#endif
+	p_jit->code = NULL;
+	p_jit->size = 0;
+
+} /* grunt_jit_release() */
+
+#endif /* GRUNT_FUZZ */
@@ -0,0 +1,39 @@
+#ifndef _GRUNT_JIT_H_
+#define _GRUNT_JIT_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* The JIT compiles the lowered form of verified programs into host
+ * machine code; see grunt_jit.c.  It has a code generator only for
+ * x86-64 Unix hosts, and only builds that define GRUNT_JIT use it.
+ */
+#if defined(GRUNT_JIT) && defined(__x86_64__) && defined(__unix__)
+#define GRUNT_JIT_X86_64
+#endif
+
+/* A program's compiled code, or NULL if it has none. */
+typedef struct {
+	const uint8 *code;
+	uint32       size;   /* bytes of code */
+} grunt_jit_code_t;
+
+int grunt_jit_compile(const grunt_lowered_program_t *, grunt_jit_code_t *);
+int grunt_jit_run(grunt_vm_t *, const grunt_jit_code_t *, grunt_pc_t *);
+#ifdef GRUNT_FUZZ
+void grunt_jit_release(grunt_jit_code_t *);
+#endif
+
+#endif
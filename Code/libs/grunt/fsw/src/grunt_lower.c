@@ -0,0 +1,780 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module implements the lowering pass that turns a verified
+ * Grunt stack program into a program for the register machine
+ * described in grunt_lower.h.
+ *
+ * The pass lowers each Grunt routine once, callees before callers, by
+ * walking it the same way the verifier does and following both paths
+ * of every JMPIF.  It keeps a map from each arg stack slot to the
+ * register holding that slot's value.  DUP, POP, and ROLL only change
+ * the map, so they produce no register machine instructions at all.
+ * Every other instruction reads its arguments from the registers the
+ * map names and writes its result to a free register.
+ *
+ * The map can differ on the two paths into a JMPIF target, and the
+ * code on either side of a CALL or RETURN must agree on where each
+ * slot lives.  So at those points the pass brings the map into a
+ * canonical form, with slot i in register i, by emitting MOVs.  A
+ * LOOKUP is, to the pass, a JMPIF that is always taken to the
+ * instruction after its table, and a SWITCH one JMPIF that is always
+ * taken to each of its targets.  A loop body is a join too, of the
+ * path in from its REPEAT and the path back from its END, so the
+ * pass canonicalizes at both.  INPUTREC writes its fields to
+ * consecutive registers, so the pass canonicalizes before it too,
+ * freeing the registers above the depth.  FORMAT reads its template
+ * and values from consecutive registers, and CLASSIFY writes its row
+ * to them, so the pass canonicalizes before those as well.  A CALL
+ * just before a RETURN becomes a TAILCALL, which saves no control
+ * stack entry, so the callee's RET goes straight back to the
+ * caller's caller.
+ *
+ * The pass takes the type each OUTPUT outputs, and the types of each
+ * FORMAT's values, from the verifier, which also tells it which
+ * instructions are reachable.  It refuses to lower a program that
+ * OUTPUTs or FORMATs values of different types from the same
+ * instruction, or whose lowered form doesn't fit in the caller's
+ * storage.  Such programs still run on the verified stack
+ * engine.
+ *
+ * Run this pass only on programs GRUNT_Verify() has accepted; it
+ * relies on the properties the verifier proved.
+ */
+
+#include "cfe.h"
+
+#include "grunt_status.h"
+#include "grunt.h"
+#include "grunt_verify.h"
+#include "grunt_lower.h"
+
+/* The state of the arg stack during lowering: its depth relative to
+ * its depth on entry to the routine being lowered, and the register
+ * holding each slot.  Slots run from -GRUNT_STACK_SIZE, the deepest
+ * a routine could possibly reach into its caller's slots, up to
+ * depth - 1.
+ */
+typedef struct {
+	int  depth;
+	int8 reg[2*GRUNT_STACK_SIZE];
+} grunt_lower_state_t;
+
+#define SLOT(p_s, s) ((p_s)->reg[(s) + GRUNT_STACK_SIZE])
+
+/* JMPIFs, LOOKUPs, and SWITCH table entries waiting for the pass to
+ * reach their targets.  They all leave the map canonical, so only the
+ * depth needs saving.
+ */
+#define GRUNT_LOWER_MAX_PENDING 64
+static struct {
+	grunt_pc_t target;    /* Grunt pc of JMPIF target */
+	uint16     index;     /* lowered instruction to patch */
+	int        depth;
+} g_pending[GRUNT_LOWER_MAX_PENDING];
+static int g_pending_count;
+
+/* The routines: their Grunt entry points, where their lowered code
+ * starts, and how they change the depth of the arg stack.
+ */
+#define GRUNT_LOWER_MAX_ROUTINES 64
+static struct {
+	grunt_pc_t entry;
+	uint16     start;
+	bool       returns;   /* does any path RETURN? */
+	int        net;       /* arg stack depth change on RETURN */
+} g_routines[GRUNT_LOWER_MAX_ROUTINES];
+static int g_routine_count;
+
+/* The loops open at the current pc of the routine being lowered:
+ * the Grunt pc of each one's END, and the lowered instruction that
+ * starts its body.
+ */
+static struct {
+	grunt_pc_t end;
+	uint16     body;
+} g_loops[GRUNT_STACK_SIZE];
+static int g_loop_count;
+
+/* Marks routine entry points. */
+#define GRUNT_LOWER_MAX_PROGRAM 1024
+static bool g_is_entry[GRUNT_LOWER_MAX_PROGRAM];
+
+static const grunt_instruction_t *g_program;  /* program to lower */
+static grunt_pc_t g_num_instructions;         /* its length */
+static const uint8 *g_top_types;              /* from the verifier */
+static grunt_lowered_program_t *g_lowered;    /* where to put result */
+
+
+/* ------------------- module local functions -------------------- */
+
+/* lower_find_routines()
+ *
+ * in:     nothing
+ * out:    g_is_entry - true for each routine entry point
+ * return: nothing
+ *
+ * The routines are the main routine at pc 0 and the targets of the
+ * CALLs the verifier reached.
+ */
+
+static void
+lower_find_routines(void) {
+
+	grunt_pc_t pc;
+
+	memset(g_is_entry, 0, g_num_instructions * sizeof(bool));
+	g_is_entry[0] = true;
+
+	for (pc = 0; pc < g_num_instructions; pc++) {
+		if ((g_top_types[pc] != GT_UNSEEN) &&
+			(g_program[pc].op == GRUNT_OP_CALL))
+			g_is_entry[g_program[pc].arg.lit.val.pc] = true;
+	}
+
+} /* lower_find_routines() */
+
+
+/* lower_emit()
+ *
+ * in:     op, d, a, b, imm - the register machine instruction
+ *         pc               - Grunt pc it came from
+ * out:    g_lowered        - instruction appended
+ * return: GRUNT_ERROR_OUTOFBOUNDS if g_lowered is full, else 0.
+ */
+
+static int
+lower_emit(uint8 op, int d, int a, int b, uint32 imm, grunt_pc_t pc) {
+
+	grunt_reg_instruction_t *p_ri;
+
+	if (!(g_lowered->num_instructions < g_lowered->max_instructions))
+		return GRUNT_ERROR_OUTOFBOUNDS;
+
+	p_ri = &(g_lowered->code[g_lowered->num_instructions++]);
+	p_ri->op  = op;
+	p_ri->d   = (int8)d;
+	p_ri->a   = (int8)a;
+	p_ri->b   = (int8)b;
+	p_ri->imm = imm;
+	p_ri->pc  = pc;
+	return 0;  /* OK! */
+
+} /* lower_emit() */
+
+
+/* lower_reg_used()
+ *
+ * in:     p_s  - lowering state
+ *         reg  - register
+ * out:    nothing
+ * return: true if some slot on the arg stack maps to reg.
+ */
+
+static bool
+lower_reg_used(const grunt_lower_state_t *p_s, int reg) {
+
+	int s;
+
+	for (s = -GRUNT_STACK_SIZE; s < p_s->depth; s++) {
+		if (SLOT(p_s, s) == reg) return true;
+	}
+	return false;
+
+} /* lower_reg_used() */
+
+
+/* lower_alloc()
+ *
+ * in:     p_s       - lowering state
+ *         p_exclude - registers that must not be chosen
+ *         n_exclude - number of registers in p_exclude
+ * out:    nothing
+ * return: a register no slot maps to and not in p_exclude.
+ *
+ * Chooses the lowest such register at or above the depth of the arg
+ * stack, preferring register p_s->depth, the canonical register of
+ * the next slot pushed, so that canonicalization needs fewer MOVs.
+ * At most GRUNT_STACK_SIZE slots can map to registers at or above the
+ * depth, and callers never exclude more than two registers those
+ * slots don't already use, so the search never goes more than
+ * GRUNT_STACK_SIZE + 2 above the depth.
+ */
+
+static int
+lower_alloc(const grunt_lower_state_t *p_s, const int8 *p_exclude,
+	int n_exclude) {
+
+	int reg, i;
+
+	for (reg = p_s->depth; ; reg++) {
+		for (i = 0; i < n_exclude; i++) {
+			if (p_exclude[i] == reg) break;
+		}
+		if ((i == n_exclude) && !lower_reg_used(p_s, reg)) return reg;
+	}
+
+} /* lower_alloc() */
+
+
+/* lower_canonicalize()
+ *
+ * in:     p_s - lowering state
+ *         pc  - Grunt pc to blame for the MOVs
+ * out:    p_s - every slot s maps to register s
+ * return: GRUNT_ERROR_OUTOFBOUNDS if g_lowered is full, else 0.
+ *
+ * Emits the MOVs that bring the map into canonical form.  A MOV into
+ * register s must wait until no slot still needs the value in
+ * register s.  When every remaining MOV is waiting on another, they
+ * form a cycle; we break it by moving one of the values to a free
+ * register.
+ */
+
+static int
+lower_canonicalize(grunt_lower_state_t *p_s, grunt_pc_t pc) {
+
+	bool pending;    /* some slot is not yet canonical */
+	bool progress;   /* we emitted a MOV this pass */
+	int s, t, free_reg;
+	int status;
+
+	for (;;) {
+
+		pending  = false;
+		progress = false;
+
+		for (s = -GRUNT_STACK_SIZE; s < p_s->depth; s++) {
+			if (SLOT(p_s, s) == s) continue;
+			pending = true;
+			if (lower_reg_used(p_s, s)) continue;  /* wait */
+			if ((status = lower_emit(GRUNT_ROP_MOV, s,
+				SLOT(p_s, s), 0, 0, pc)))
+				return status;
+			SLOT(p_s, s) = (int8)s;
+			progress = true;
+		}
+
+		if (!pending) return 0;  /* OK! */
+		if (progress) continue;
+
+		/* Every remaining MOV waits on another.  Move the
+		 * value in the first waiting slot's canonical register
+		 * out of the way.
+		 */
+		for (s = -GRUNT_STACK_SIZE; SLOT(p_s, s) == s; s++)
+			;
+		free_reg = lower_alloc(p_s, NULL, 0);
+		if ((status = lower_emit(GRUNT_ROP_MOV, free_reg, s, 0, 0, pc)))
+			return status;
+		for (t = -GRUNT_STACK_SIZE; t < p_s->depth; t++) {
+			if (SLOT(p_s, t) == s) SLOT(p_s, t) = (int8)free_reg;
+		}
+	}
+
+} /* lower_canonicalize() */
+
+
+/* lower_reset()
+ *
+ * in:     p_s   - lowering state
+ *         depth - arg stack depth
+ * out:    p_s   - canonical map at depth
+ * return: nothing
+ */
+
+static void
+lower_reset(grunt_lower_state_t *p_s, int depth) {
+
+	int s;
+
+	p_s->depth = depth;
+	for (s = -GRUNT_STACK_SIZE; s < GRUNT_STACK_SIZE; s++)
+		SLOT(p_s, s) = (int8)s;
+
+} /* lower_reset() */
+
+
+/* lower_push()
+ *
+ * in:     p_s - lowering state
+ *         reg - register holding new top slot
+ * out:    p_s - slot pushed
+ * return: nothing
+ */
+
+static void
+lower_push(grunt_lower_state_t *p_s, int reg) {
+
+	SLOT(p_s, p_s->depth) = (int8)reg;
+	p_s->depth++;
+
+} /* lower_push() */
+
+
+/* lower_routine()
+ *
+ * in:     r         - index of routine in g_routines to lower
+ * out:    g_routines[r] - start, returns, and net filled in
+ *         g_lowered     - the routine's lowered instructions appended
+ * return: 0 on success, else a GRUNT_ERROR_* code explaining why
+ *         the program has no lowering.
+ */
+
+static int
+lower_routine(int r) {
+
+	const grunt_instruction_t *p_i;
+	const grunt_instruction_t *p_table;  /* a LOOKUP's table */
+	grunt_lower_state_t cur;       /* state at current pc */
+	int8 src[GRUNT_STACK_SIZE + 1];  /* popped arg registers, + temp */
+	bool live = true;              /* is current pc reachable? */
+	bool canonical;                /* have we canonicalized cur here? */
+	grunt_pc_t pc;
+	grunt_rep_t n, k;
+	uint8 rop;
+	int d, t, callee;
+	int i;
+	int status;
+
+	g_routines[r].start   = g_lowered->num_instructions;
+	g_routines[r].returns = false;
+	g_pending_count = 0;
+	g_loop_count    = 0;
+	lower_reset(&cur, 0);
+
+	for (pc = g_routines[r].entry; pc < g_num_instructions; pc++) {
+
+		/* Land the JMPIFs that target this pc. */
+		canonical = false;
+		for (i = 0; i < g_pending_count; i++) {
+			if (g_pending[i].target != pc) continue;
+			if (live && !canonical) {
+				if ((status = lower_canonicalize(&cur, pc)))
+					return status;
+			} else if (!live) {
+				lower_reset(&cur, g_pending[i].depth);
+			}
+			live = true;
+			canonical = true;
+			g_lowered->code[g_pending[i].index].imm =
+				g_lowered->num_instructions;
+			g_pending[i--] = g_pending[--g_pending_count];
+		}
+
+		if (!live) {
+			if (g_pending_count == 0) break;  /* done */
+			continue;   /* unreachable */
+		}
+
+		p_i = &(g_program[pc]);
+		status = 0;
+
+		/* We rely on the verifier having checked this. */
+		if (g_top_types[pc] == GT_UNSEEN)
+			return GRUNT_ERROR_INTERPRETERBUG;
+
+		switch (p_i->op) {
+		case GRUNT_OP_ADD:
+		case GRUNT_OP_SUB:
+		case GRUNT_OP_GT:
+		case GRUNT_OP_LT:
+			src[1] = SLOT(&cur, --cur.depth);   /* top */
+			src[0] = SLOT(&cur, --cur.depth);   /* below top */
+			d = lower_alloc(&cur, NULL, 0);
+			switch (p_i->op) {
+			case GRUNT_OP_ADD:
+				status = lower_emit(GRUNT_ROP_ADD, d, src[0],
+					src[1], 0, pc);
+				break;
+			case GRUNT_OP_SUB:
+				status = lower_emit(GRUNT_ROP_SUB, d, src[0],
+					src[1], 0, pc);
+				break;
+			case GRUNT_OP_LT:
+				status = lower_emit(GRUNT_ROP_LT, d, src[0],
+					src[1], 0, pc);
+				break;
+			default:  /* GT: a > b is b < a */
+				status = lower_emit(GRUNT_ROP_LT, d, src[1],
+					src[0], 0, pc);
+				break;
+			}
+			lower_push(&cur, d);
+			break;
+		case GRUNT_OP_AND:
+		case GRUNT_OP_OR:
+		case GRUNT_OP_EQ:
+			/* src[0] is the top; EQ compares it to each of
+			 * the others.  With more than two arguments, the
+			 * accumulator t must not overwrite an argument we
+			 * haven't read yet.
+			 */
+			n = p_i->arg.rep;
+			for (k = 0; k < n; k++) src[k] = SLOT(&cur, --cur.depth);
+			t = ((n == 2) ? lower_alloc(&cur, NULL, 0) :
+				lower_alloc(&cur, src, n));
+			if (p_i->op == GRUNT_OP_EQ) {
+				status = lower_emit(GRUNT_ROP_EQ, t, src[0],
+					src[1], 0, pc);
+				src[n] = (int8)t;
+				for (k = 2; !status && (k < n); k++) {
+					d = lower_alloc(&cur, src, n + 1);
+					if (!(status = lower_emit(GRUNT_ROP_EQ,
+						d, src[0], src[k], 0, pc)))
+						status = lower_emit(
+							GRUNT_ROP_AND, t, t,
+							d, 0, pc);
+				}
+			} else {
+				rop = ((p_i->op == GRUNT_OP_AND) ?
+					GRUNT_ROP_AND : GRUNT_ROP_OR);
+				status = lower_emit(rop, t, src[0], src[1],
+					0, pc);
+				for (k = 2; !status && (k < n); k++)
+					status = lower_emit(rop, t, t, src[k],
+						0, pc);
+			}
+			lower_push(&cur, t);
+			break;
+		case GRUNT_OP_NOT:
+			src[0] = SLOT(&cur, --cur.depth);
+			d = lower_alloc(&cur, NULL, 0);
+			status = lower_emit(GRUNT_ROP_NOT, d, src[0], 0, 0, pc);
+			lower_push(&cur, d);
+			break;
+		case GRUNT_OP_DUP:
+			n = p_i->arg.rep;
+			for (k = 0; k < n; k++)
+				lower_push(&cur, SLOT(&cur, cur.depth - n));
+			break;
+		case GRUNT_OP_POP:
+			cur.depth -= p_i->arg.rep;
+			break;
+		case GRUNT_OP_ROLL:
+			n = p_i->arg.rep;
+			d = SLOT(&cur, cur.depth - 1);
+			for (k = 1; k < n; k++) {
+				SLOT(&cur, cur.depth - k) =
+					SLOT(&cur, cur.depth - k - 1);
+			}
+			SLOT(&cur, cur.depth - n) = (int8)d;
+			break;
+		case GRUNT_OP_PUSHB:
+		case GRUNT_OP_PUSHN:
+		case GRUNT_OP_PUSHS:
+			d = lower_alloc(&cur, NULL, 0);
+			status = lower_emit(GRUNT_ROP_LDI, d, 0, 0,
+				((p_i->op == GRUNT_OP_PUSHB) ?
+					(p_i->arg.lit.val.b ? 1 : 0) :
+				 (p_i->op == GRUNT_OP_PUSHN) ?
+					p_i->arg.lit.val.num :
+					p_i->arg.lit.val.str), pc);
+			lower_push(&cur, d);
+			break;
+		case GRUNT_OP_INPUT:
+			d = lower_alloc(&cur, NULL, 0);
+			status = lower_emit(GRUNT_ROP_INPUT, d, 0, 0,
+				p_i->arg.rep, pc);
+			lower_push(&cur, d);
+			break;
+		case GRUNT_OP_INPUTREC:
+			if ((status = lower_canonicalize(&cur, pc))) break;
+			d = cur.depth;
+			if ((status = lower_emit(GRUNT_ROP_INPUTREC, d, 0, 0,
+				p_i->arg.rep, pc)))
+				break;
+			for (k = 0; (k < GRUNT_INPUTREC_MAX_FIELDS) &&
+				GRUNT_INPUTREC_WIDTH(p_i->arg.rep, k); k++)
+				lower_push(&cur, d + k);
+			break;
+		case GRUNT_OP_CLASSIFY:
+			if ((status = lower_canonicalize(&cur, pc))) break;
+			d = --cur.depth;
+			if ((status = lower_emit(GRUNT_ROP_CLASSIFY, d, d, 0,
+				p_i->arg.rep, pc)))
+				break;
+			for (k = 0; k < 4; k++)
+				lower_push(&cur, d + k);
+			break;
+		case GRUNT_OP_INPUTZ:
+			d = lower_alloc(&cur, NULL, 0);
+			status = lower_emit(GRUNT_ROP_INPUTZ, d, 0, 0,
+				p_i->arg.rep, pc);
+			lower_push(&cur, d);
+			break;
+		case GRUNT_OP_REWIND:
+			status = lower_emit(GRUNT_ROP_REWIND, 0, 0, 0,
+				p_i->arg.rep, pc);
+			break;
+		case GRUNT_OP_OUTPUT:
+			switch (g_top_types[pc]) {
+			case gt_bool:
+				rop = GRUNT_ROP_OUTB;
+				break;
+			case gt_num:
+				rop = GRUNT_ROP_OUTN;
+				break;
+			case gt_str:
+				rop = GRUNT_ROP_OUTS;
+				break;
+			default:
+				/* Type differs between paths. */
+				return GRUNT_ERROR_INVALIDARGUMENT;
+			}
+			cur.depth--;
+			status = lower_emit(rop, 0, SLOT(&cur, cur.depth), 0,
+				0, pc);
+			break;
+		case GRUNT_OP_FORMAT:
+			if (g_top_types[pc] == GT_ANY) {
+				/* Types differ between paths. */
+				return GRUNT_ERROR_INVALIDARGUMENT;
+			}
+			if ((status = lower_canonicalize(&cur, pc))) break;
+			cur.depth -= p_i->arg.rep + 1;
+			status = lower_emit(GRUNT_ROP_FORMAT, 0, cur.depth, 0,
+				GRUNT_LOWER_FORMAT(p_i->arg.rep,
+				g_top_types[pc]), pc);
+			break;
+		case GRUNT_OP_FLUSH:
+			/* Event ID on top, event type below it. */
+			cur.depth -= 2;
+			status = lower_emit(GRUNT_ROP_FLUSH, 0,
+				SLOT(&cur, cur.depth + 1),
+				SLOT(&cur, cur.depth), 0, pc);
+			break;
+		case GRUNT_OP_HALT:
+			cur.depth--;
+			status = lower_emit(GRUNT_ROP_HALT, 0,
+				SLOT(&cur, cur.depth), 0, 0, pc);
+			live = false;
+			break;
+		case GRUNT_OP_JMPIF:
+			/* Canonicalize with the condition still on the
+			 * stack so the MOVs can't clobber it.
+			 */
+			if (g_pending_count == GRUNT_LOWER_MAX_PENDING)
+				return GRUNT_ERROR_OUTOFBOUNDS;
+			if ((status = lower_canonicalize(&cur, pc))) break;
+			cur.depth--;
+			if ((status = lower_emit(GRUNT_ROP_JMPIF, 0,
+				cur.depth, 0, 0, pc)))
+				break;
+			g_pending[g_pending_count].target =
+				pc + p_i->arg.lit.val.pc;
+			g_pending[g_pending_count].index =
+				g_lowered->num_instructions - 1;
+			g_pending[g_pending_count].depth = cur.depth;
+			g_pending_count++;
+			break;
+		case GRUNT_OP_LOOKUP:
+			/* Once the map is canonical, the key and its
+			 * string share the top slot's register, so no
+			 * MOVs need run between the LOOKUP and its
+			 * target.
+			 */
+			if (g_pending_count == GRUNT_LOWER_MAX_PENDING)
+				return GRUNT_ERROR_OUTOFBOUNDS;
+			if ((status = lower_canonicalize(&cur, pc))) break;
+			n = p_i->arg.rep;
+			d = cur.depth - 1;
+			if ((status = lower_emit(GRUNT_ROP_LOOKUP, d, d, 0, 0,
+				pc)))
+				break;
+			g_pending[g_pending_count].target = pc + (2 * n) + 2;
+			g_pending[g_pending_count].index =
+				g_lowered->num_instructions - 1;
+			g_pending[g_pending_count].depth = cur.depth;
+			g_pending_count++;
+			p_table = &(g_program[pc + 1]);
+			for (k = 0; !status && (k < n); k++) {
+				if (!(status = lower_emit(GRUNT_ROP_CASE, 0, 0,
+					0, p_table[2 * k].arg.lit.val.num, pc)))
+					status = lower_emit(GRUNT_ROP_VALUE, 0,
+						0, 0, p_table[(2 * k) +
+							1].arg.lit.val.str, pc);
+			}
+			if (!status)
+				status = lower_emit(GRUNT_ROP_VALUE, 0, 0, 0,
+					p_table[2 * n].arg.lit.val.str, pc);
+			live = false;
+			break;
+		case GRUNT_OP_SWITCH:
+			/* As for JMPIF, canonicalize with the key still
+			 * on the stack.  Each VALUE in the table waits
+			 * for its target, the default last.
+			 */
+			n = p_i->arg.rep;
+			if ((g_pending_count + n + 1) > GRUNT_LOWER_MAX_PENDING)
+				return GRUNT_ERROR_OUTOFBOUNDS;
+			if ((status = lower_canonicalize(&cur, pc))) break;
+			cur.depth--;
+			if ((status = lower_emit(GRUNT_ROP_SWITCH, 0,
+				cur.depth, 0, n, pc)))
+				break;
+			p_table = &(g_program[pc + 1]);
+			for (k = 0; !status && (k <= n); k++) {
+				if ((status = lower_emit(GRUNT_ROP_VALUE, 0, 0,
+					0, 0, pc)))
+					break;
+				g_pending[g_pending_count].target = pc + 1 + k;
+				if (k < n) g_pending[g_pending_count].target +=
+					p_table[k].arg.lit.val.pc;
+				g_pending[g_pending_count].index =
+					g_lowered->num_instructions - 1;
+				g_pending[g_pending_count].depth = cur.depth;
+				g_pending_count++;
+			}
+			live = false;
+			break;
+		case GRUNT_OP_CALL:
+			/* Callees have larger entry points, so we've
+			 * already lowered this one.
+			 */
+			for (callee = 0; callee < r; callee++) {
+				if (g_routines[callee].entry ==
+					p_i->arg.lit.val.pc) break;
+			}
+			if (callee == r) return GRUNT_ERROR_INTERPRETERBUG;
+			if ((status = lower_canonicalize(&cur, pc))) break;
+			if (((pc + 1) < g_num_instructions) &&
+				(g_program[pc + 1].op == GRUNT_OP_RETURN)) {
+				/* A tail call.  The verifier has proved the
+				 * control stack entry it saves could never
+				 * have overflowed it.
+				 */
+				status = lower_emit(GRUNT_ROP_TAILCALL, 0,
+					cur.depth, 0, g_routines[callee].start,
+					pc);
+				if (g_routines[callee].returns) {
+					g_routines[r].returns = true;
+					g_routines[r].net = cur.depth +
+						g_routines[callee].net;
+				}
+				live = false;
+				break;
+			}
+			if ((status = lower_emit(GRUNT_ROP_CALL, 0, cur.depth,
+				0, g_routines[callee].start, pc)))
+				break;
+			/* The callee leaves its results canonical. */
+			live = g_routines[callee].returns;
+			lower_reset(&cur, cur.depth + g_routines[callee].net);
+			break;
+		case GRUNT_OP_REPEAT:
+			if (g_loop_count == GRUNT_STACK_SIZE)
+				return GRUNT_ERROR_OUTOFBOUNDS;
+			if ((status = lower_canonicalize(&cur, pc))) break;
+			if ((status = lower_emit(GRUNT_ROP_LOOP, 0, 0, 0,
+				p_i->arg.rep, pc)))
+				break;
+			g_loops[g_loop_count].end = grunt_verify_loop_end(
+				g_program, g_num_instructions, pc);
+			g_loops[g_loop_count].body =
+				g_lowered->num_instructions;
+			g_loop_count++;
+			break;
+		case GRUNT_OP_END:
+			/* Loops whose END no path reached are still open
+			 * inside this one.
+			 */
+			while (g_loop_count &&
+				(g_loops[g_loop_count - 1].end != pc))
+				g_loop_count--;
+			if (!g_loop_count) return GRUNT_ERROR_INTERPRETERBUG;
+			if ((status = lower_canonicalize(&cur, pc))) break;
+			status = lower_emit(GRUNT_ROP_NEXT, 0, 0, 0,
+				g_loops[--g_loop_count].body, pc);
+			break;
+		case GRUNT_OP_RETURN:
+			if ((status = lower_canonicalize(&cur, pc))) break;
+			status = lower_emit(GRUNT_ROP_RET, 0, 0, 0, 0, pc);
+			g_routines[r].returns = true;
+			g_routines[r].net     = cur.depth;
+			live = false;
+			break;
+		default:
+			return GRUNT_ERROR_INVALIDOPCODE;  /* not verified */
+		}
+
+		if (status) return status;
+	}
+
+	/* Verified code never runs off the end of the program. */
+	if (live) return GRUNT_ERROR_NOPROGRAM;
+
+	return 0;  /* OK! */
+
+} /* lower_routine() */
+
+
+/* ------------------- module exported functions -------------------- */
+
+/* grunt_lower_program()
+ *
+ * in:     program          - verified Grunt program to lower
+ *         num_instructions - number of instructions in program
+ *         top_types        - type on top of the arg stack at each
+ *                            pc, from the verifier
+ *         p_lowered        - code[] and its capacity
+ * out:    p_lowered        - holds the lowered program
+ * return: 0 on success, else a GRUNT_ERROR_* code explaining why
+ *         the program has no lowering.
+ */
+
+int
+grunt_lower_program(const grunt_instruction_t *program,
+	grunt_pc_t num_instructions, const uint8 *top_types,
+	grunt_lowered_program_t *p_lowered) {
+
+	grunt_pc_t pc;
+	int status = 0;
+
+	p_lowered->num_instructions = 0;
+	if (num_instructions > GRUNT_LOWER_MAX_PROGRAM)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+
+	g_program          = program;
+	g_num_instructions = num_instructions;
+	g_top_types        = top_types;
+	g_lowered          = p_lowered;
+	g_routine_count    = 0;
+
+	lower_find_routines();
+
+	/* Lower callees before their callers.  Since CALLs go forward,
+	 * that means in decreasing entry point order.
+	 */
+	for (pc = num_instructions; pc-- > 0; ) {
+		if (!g_is_entry[pc]) continue;
+		if (g_routine_count == GRUNT_LOWER_MAX_ROUTINES) {
+			status = GRUNT_ERROR_OUTOFBOUNDS;
+			break;
+		}
+		g_routines[g_routine_count].entry = pc;
+		if ((status = lower_routine(g_routine_count++))) break;
+	}
+
+	if (status) {
+		p_lowered->num_instructions = 0;
+		return status;
+	}
+
+	/* The main routine, at pc 0, is the last one we lowered. */
+	p_lowered->start = g_routines[g_routine_count - 1].start;
+	return 0;  /* OK! */
+
+} /* grunt_lower_program() */
@@ -0,0 +1,112 @@
+#ifndef _GRUNT_LOWER_H_
+#define _GRUNT_LOWER_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* The register machine.  The lowering pass in grunt_lower.c turns a
+ * verified Grunt stack program into a program for this machine, and
+ * grunt_vm_register.c runs it.  The machine has a fixed file of
+ * untyped 32-bit registers; the lowering pass resolves all types
+ * ahead of time.
+ *
+ * Instructions name registers relative to a frame pointer.  Each
+ * Grunt routine becomes one register machine routine whose register
+ * i holds arg stack slot i counted from the depth of the arg stack
+ * when the routine was called, so negative registers hold the
+ * routine's arguments.  CALL moves the frame pointer up to the
+ * caller's depth, so the same code serves every call site.
+ */
+typedef uint32 grunt_reg_t;
+
+/* The frame pointer never rises above GRUNT_STACK_SIZE, and the
+ * lowering pass never uses a register more than GRUNT_STACK_SIZE + 2
+ * above any frame's arg stack depth.
+ */
+#define GRUNT_LOWER_NUM_REGISTERS (3*GRUNT_STACK_SIZE)
+
+/* Register machine opcodes.  A LOOKUP's table follows it as data the
+ * machine never executes: a CASE and a VALUE for each key and string,
+ * in order, then a VALUE holding the default string.  A SWITCH's
+ * table is imm VALUEs holding the index of each entry's target, then
+ * a VALUE holding the index of the default target.  A TAILCALL is a
+ * CALL whose callee returns straight to its caller's caller.
+ */
+#define GRUNT_ROP_LDI     0x01   /* r[d] = imm                      */
+#define GRUNT_ROP_MOV     0x02   /* r[d] = r[a]                     */
+#define GRUNT_ROP_ADD     0x03   /* r[d] = r[a] + r[b], checked     */
+#define GRUNT_ROP_SUB     0x04   /* r[d] = r[a] - r[b], checked     */
+#define GRUNT_ROP_AND     0x05   /* r[d] = r[a] && r[b]             */
+#define GRUNT_ROP_OR      0x06   /* r[d] = r[a] || r[b]             */
+#define GRUNT_ROP_EQ      0x07   /* r[d] = (r[a] == r[b])           */
+#define GRUNT_ROP_LT      0x08   /* r[d] = (r[a] < r[b])            */
+#define GRUNT_ROP_NOT     0x09   /* r[d] = !r[a]                    */
+#define GRUNT_ROP_INPUT   0x0A   /* r[d] = next imm-byte input      */
+#define GRUNT_ROP_REWIND  0x0B   /* rewind input imm bytes          */
+#define GRUNT_ROP_OUTB    0x0C   /* output Boolean r[a]             */
+#define GRUNT_ROP_OUTN    0x0D   /* output number r[a]              */
+#define GRUNT_ROP_OUTS    0x0E   /* output string r[a]              */
+#define GRUNT_ROP_FLUSH   0x0F   /* flush event ID r[a], type r[b]  */
+#define GRUNT_ROP_HALT    0x10   /* halt with result r[a]           */
+#define GRUNT_ROP_JMPIF   0x11   /* if r[a], go to instruction imm  */
+#define GRUNT_ROP_CALL    0x12   /* call imm with frame pointer + a */
+#define GRUNT_ROP_RET     0x13   /* return to caller                */
+#define GRUNT_ROP_LOOKUP  0x14   /* r[d] = table[r[a]]; go to imm   */
+#define GRUNT_ROP_CASE    0x15   /* table: key imm, value in next   */
+#define GRUNT_ROP_VALUE   0x16   /* table: value imm                */
+#define GRUNT_ROP_SWITCH  0x17   /* go to table[min(r[a], imm)]     */
+#define GRUNT_ROP_LOOP    0x18   /* push loop count imm             */
+#define GRUNT_ROP_NEXT    0x19   /* if --count, go to imm, else pop */
+#define GRUNT_ROP_INPUTREC 0x1A  /* r[d], r[d+1]... = record imm    */
+#define GRUNT_ROP_INPUTZ  0x1B   /* r[d] = next imm bytes all zero  */
+#define GRUNT_ROP_FORMAT  0x1C   /* output template r[a+n], values  */
+                                 /*   r[a+n-1] down to r[a]         */
+#define GRUNT_ROP_TAILCALL 0x1D  /* go to imm with frame pointer + a */
+#define GRUNT_ROP_CLASSIFY 0x1E  /* r[d]..r[d+3] = class row of r[d], */
+                                 /*   names from string imm         */
+
+/* A FORMAT's imm holds its number of values n in the low 8 bits and
+ * the types the verifier found for them (see grunt_verify.h) above.
+ */
+#define GRUNT_LOWER_FORMAT(n, types) ((uint32)(n) | ((uint32)(types) << 8))
+#define GRUNT_LOWER_FORMAT_N(imm)     ((grunt_rep_t)((imm) & 0xFF))
+#define GRUNT_LOWER_FORMAT_TYPES(imm) ((uint8)((imm) >> 8))
+
+/* A register machine instruction.  pc is the program counter of the
+ * Grunt instruction it came from, for error reporting.
+ */
+typedef struct {
+	uint8       op;
+	int8        d;
+	int8        a;
+	int8        b;
+	uint32      imm;
+	grunt_pc_t  pc;
+} grunt_reg_instruction_t;
+
+/* A lowered program and the storage that holds it.  Execution begins
+ * at code[start].
+ */
+typedef struct {
+	grunt_reg_instruction_t *code;
+	uint16 max_instructions;
+	uint16 num_instructions;
+	uint16 start;
+} grunt_lowered_program_t;
+
+int grunt_lower_program(const grunt_instruction_t *, grunt_pc_t,
+	const uint8 *, grunt_lowered_program_t *);
+
+#endif
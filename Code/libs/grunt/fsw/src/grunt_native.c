@@ -0,0 +1,182 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module provides the few services native code generated from
+ * Grunt programs by the gruntaot translator can't easily provide for
+ * itself.  The generated code evaluates Grunt instructions directly
+ * on its own private stacks and input queue, but it builds and
+ * flushes its event messages through the output queue of the VM
+ * GRUNT_Run() uses and reports its run-time errors through the
+ * interpreter's error reporting routine.  Sharing these routines ensures the generated
+ * code produces exactly the same events and debug messages as the
+ * interpreter would for the same program.
+ */
+
+#include "cfe.h"
+
+#include "grunt.h"
+#include "grunt_status.h"
+#include "grunt_output.h"
+#include "grunt_vm.h"
+#include "grunt_vm_stack.h"
+#include "vs_parmclass.h"
+
+
+/* GRUNT_NativeInit()
+ *
+ * in:     string_table - the Grunt program's table of constant strings
+ *         num_strings  - the number of strings in string_table
+ * out:    nothing
+ * return: nothing
+ *
+ * Generated code calls this routine before it runs to reset the
+ * output queue, in the same way GRUNT_Run() does for interpreted
+ * programs, and marks the reset with the VM's perf_init_id, if it has
+ * one.
+ */
+
+void
+GRUNT_NativeInit(const char *string_table[], grunt_string_t num_strings) {
+
+	grunt_vm_t *p_vm = grunt_vm_default();  /* GRUNT_Run()'s VM */
+
+	if (p_vm->perf_init_id) CFE_ES_PerfLogEntry(p_vm->perf_init_id);
+	grunt_output_init(p_vm, string_table, num_strings);
+	if (p_vm->perf_init_id) CFE_ES_PerfLogExit(p_vm->perf_init_id);
+
+} /* GRUNT_NativeInit() */
+
+
+/* GRUNT_NativeOutput()
+ *
+ * in:     p_v - value to append to the output queue
+ * out:    nothing
+ * return: value        condition
+ *         ------       ---------------
+ *         GRUNT_ERROR_INVALIDARGUMENT - can't output gt_pc values
+ *         0                           - success
+ *         Plus grunt_output_enqueue_*() error codes.
+ *
+ * Performs the output queue half of the OUTPUT instruction on behalf
+ * of generated code.  The generated code has already popped p_v off
+ * of its arg stack.
+ */
+
+int32
+GRUNT_NativeOutput(const grunt_value_t *p_v) {
+
+	grunt_vm_t *p_vm = grunt_vm_default();  /* GRUNT_Run()'s VM */
+
+	switch (p_v->type) {
+	case gt_bool:
+		return grunt_output_enqueue_boolean(p_vm, p_v->val.b);
+	case gt_num:
+		return grunt_output_enqueue_number(p_vm, p_v->val.num);
+	case gt_str:
+		return grunt_output_enqueue_string(p_vm, p_v->val.str);
+	default:
+		/* You can't output elements of type gt_pc. */
+		return GRUNT_ERROR_INVALIDARGUMENT;
+	}
+
+} /* GRUNT_NativeOutput() */
+
+
+/* GRUNT_NativeFormat()
+ *
+ * in:     fmt    - string table index of the template FORMAT popped
+ *         values - the values FORMAT popped after it, bottom first
+ *         n      - number of values
+ * out:    nothing
+ * return: grunt_output_enqueue_format()'s status.
+ *
+ * Performs the output queue half of the FORMAT instruction on behalf
+ * of generated code, which has already popped the template and its
+ * values off of its arg stack.
+ */
+
+int32
+GRUNT_NativeFormat(grunt_string_t fmt, const grunt_value_t *values,
+	grunt_rep_t n) {
+
+	return grunt_output_enqueue_format(grunt_vm_default(), fmt, values,
+		n);
+
+} /* GRUNT_NativeFormat() */
+
+
+/* GRUNT_NativeClassify()
+ *
+ * in:     key   - the number CLASSIFY popped
+ *         names - CLASSIFY's first name string
+ * out:    p_row - key's row, the four values CLASSIFY pushes, bottom
+ *                 first
+ * return: 0, or GRUNT_ERROR_INVALIDLITERAL if the names run past the
+ *         last string number.
+ *
+ * Looks the row up on behalf of generated code, so that it shares
+ * the interpreter's copy of the table.
+ */
+
+int32
+GRUNT_NativeClassify(grunt_value_t *p_row, grunt_number_t key,
+	grunt_rep_t names) {
+
+	if (names > (GRUNT_STRING_MAX - (VS_PARM_NUM_NAMES - 1)))
+		return GRUNT_ERROR_INVALIDLITERAL;
+
+	grunt_classify_typed(p_row, key, names);
+	return 0;
+
+} /* GRUNT_NativeClassify() */
+
+
+/* GRUNT_NativeFlush()
+ *
+ * in:     ra - the first value FLUSH popped off the arg stack
+ *         rb - the second value FLUSH popped off the arg stack
+ * out:    nothing
+ * return: nothing
+ *
+ * Performs the output queue half of the FLUSH instruction on behalf
+ * of generated code.  Takes its arguments in the same order as the
+ * interpreter's FLUSH implementation passes them to the output queue.
+ */
+
+void
+GRUNT_NativeFlush(grunt_number_t ra, grunt_number_t rb) {
+
+	grunt_output_flush(grunt_vm_default(), ra, rb);
+
+} /* GRUNT_NativeFlush() */
+
+
+/* GRUNT_NativeError()
+ *
+ * in:     status - Grunt status code describing the run-time error
+ *         pc     - program counter of the instruction that failed
+ * out:    nothing
+ * return: nothing
+ *
+ * Emits the same debug message the interpreter emits when a Grunt
+ * program has a run-time error.
+ */
+
+void
+GRUNT_NativeError(int32 status, grunt_pc_t pc) {
+
+	grunt_vm_error(status, pc);
+
+} /* GRUNT_NativeError() */
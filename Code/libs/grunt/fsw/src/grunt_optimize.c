@@ -0,0 +1,967 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module implements the Grunt optimizer.  It rewrites a verified
+ * Grunt program into a smaller one that produces the same output and
+ * result for every input, in passes, until a pass finds nothing more
+ * to do.  Each pass
+ *
+ *   1. removes the instructions no run can reach, by the verifier's
+ *      reckoning or by our own, which knows that "PUSHB true; JMPIF"
+ *      always jumps,
+ *   2. rewrites short sequences of instructions that stay within a
+ *      basic block: literals pushed and then popped, DUPed, or ROLLed
+ *      are simply pushed where they end up, comparisons, arithmetic,
+ *      and logic on literals become the literal result, NOT pairs
+ *      and ROLL(2) pairs vanish, JMPIFs on literals become nothing
+ *      or go straight to where an unconditional jump at their target
+ *      would send them,
+ *      LOOKUPs of literal keys become their strings, SWITCHes on
+ *      literal keys become jumps to their targets, and chains of
+ *      compare-and-branch cases like vsvf_rules.h's PARM_TO_STR
+ *      become a
+ *      single LOOKUP, and
+ *   3. squeezes out the instructions the first two steps removed,
+ *      pointing each jump and call at the instruction that now stands
+ *      where its target did, and
+ *   4. replaces each CALL of a small leaf subroutine, one of at most
+ *      GRUNT_OPTIMIZE_INLINE_MAX straight-line instructions and a
+ *      RETURN, with a copy of those instructions, as long as the
+ *      program still fits in the caller's storage.  A subroutine no
+ *      one calls any more goes in the next pass's step 1.
+ *
+ * The optimizer verifies the program it starts with and the one each
+ * pass produces, and gives up rather than return a program the
+ * verifier rejects.  The programs differ only in the pc at which a
+ * run that fails on its input, out of input data or overflowing a
+ * number, reports its error.  Inlining leaves the control stack
+ * shallower, but the verifier has already proved that the original
+ * never overflows it.
+ *
+ * The optimizer works in file-static scratch storage, as the verifier
+ * does, so callers must serialize calls as GRUNT_Optimize() does.
+ */
+
+#include <string.h>
+
+#include "cfe.h"
+
+#include "grunt_status.h"
+#include "grunt.h"
+#include "grunt_verify.h"
+#include "grunt_optimize.h"
+
+#define GRUNT_OPTIMIZE_MAX_INSTRUCTIONS 1024
+#define GRUNT_OPTIMIZE_MAX_PASSES       16
+#define GRUNT_OPTIMIZE_INLINE_MAX       6    /* leaf body instructions */
+
+/* Each case of a compare-and-branch chain is 8 instructions:
+ *
+ *	DUP(1), PUSHN(k), EQ(2), NOT, JMPIF(8), POP(1), PUSHS(s), RETURN
+ *
+ * and the chain ends with a default of POP(1), PUSHS(d), RETURN.
+ */
+#define CHAIN_CASE_LEN 8
+
+/* The program being optimized and what we know about it.  g_refs[]
+ * counts the JMPIFs, CALLs, LOOKUPs, and SWITCHes that go to each
+ * instruction; a rewrite may not span an instruction something else
+ * goes to.  A SWITCH's entries are JMPIFs, and count as such, and the
+ * END that jumps back to each loop body counts too.
+ */
+static grunt_instruction_t g_code[GRUNT_OPTIMIZE_MAX_INSTRUCTIONS];
+static grunt_pc_t g_origin[GRUNT_OPTIMIZE_MAX_INSTRUCTIONS];
+static uint8      g_types[GRUNT_OPTIMIZE_MAX_INSTRUCTIONS];  /* verifier */
+static uint16     g_refs[GRUNT_OPTIMIZE_MAX_INSTRUCTIONS];
+static bool       g_table[GRUNT_OPTIMIZE_MAX_INSTRUCTIONS];  /* entries */
+static bool       g_reached[GRUNT_OPTIMIZE_MAX_INSTRUCTIONS];
+static bool       g_dead[GRUNT_OPTIMIZE_MAX_INSTRUCTIONS];   /* to remove */
+static grunt_pc_t g_map[GRUNT_OPTIMIZE_MAX_INSTRUCTIONS + 1]; /* old->new */
+static grunt_pc_t g_num_instructions;
+static grunt_pc_t g_capacity;   /* most instructions inlining may leave */
+static bool       g_symbolic;   /* number literals are only names? */
+static bool       g_changed;    /* has this pass changed anything? */
+
+/* Step 4 builds the program with its leaf calls inlined here.
+ * g_inline[pc] is the length of the body to copy in place of the CALL
+ * at pc, or 0 to keep the instruction.
+ */
+static grunt_instruction_t g_new_code[GRUNT_OPTIMIZE_MAX_INSTRUCTIONS];
+static grunt_pc_t g_new_origin[GRUNT_OPTIMIZE_MAX_INSTRUCTIONS];
+static uint8      g_inline[GRUNT_OPTIMIZE_MAX_INSTRUCTIONS];
+
+
+/* ------------------- module local functions -------------------- */
+
+/* opt_target()
+ *
+ * in:     pc       - pc of an instruction
+ * out:    p_target - where it may send control other than pc + 1
+ * return: true if the instruction is a JMPIF, CALL, LOOKUP, or SWITCH.
+ *
+ * A SWITCH's target here is its default; its entries have their own.
+ */
+
+static bool
+opt_target(grunt_pc_t pc, grunt_pc_t *p_target) {
+
+	const grunt_instruction_t *p_i = &(g_code[pc]);
+
+	switch (p_i->op) {
+	case GRUNT_OP_JMPIF:
+		*p_target = (grunt_pc_t)(pc + p_i->arg.lit.val.pc);
+		return true;
+	case GRUNT_OP_CALL:
+		*p_target = p_i->arg.lit.val.pc;
+		return true;
+	case GRUNT_OP_LOOKUP:
+		*p_target = (grunt_pc_t)(pc + (2 * p_i->arg.rep) + 2);
+		return true;
+	case GRUNT_OP_SWITCH:
+		*p_target = (grunt_pc_t)(pc + p_i->arg.rep + 1);
+		return true;
+	default:
+		return false;
+	}
+
+} /* opt_target() */
+
+
+/* opt_table_length()
+ *
+ * in:     pc - pc of an instruction
+ * out:    nothing
+ * return: the number of table entries following it: 0 unless it is a
+ *         LOOKUP or SWITCH.
+ */
+
+static uint32
+opt_table_length(grunt_pc_t pc) {
+
+	switch (g_code[pc].op) {
+	case GRUNT_OP_LOOKUP:
+		return (2 * (uint32)g_code[pc].arg.rep) + 1;
+	case GRUNT_OP_SWITCH:
+		return g_code[pc].arg.rep;
+	default:
+		return 0;
+	}
+
+} /* opt_table_length() */
+
+
+/* opt_scan()
+ *
+ * in:     g_code[] - the program
+ * out:    g_refs[], g_table[] - filled in
+ * return: nothing
+ *
+ * The verifier checks only the instructions it reaches, so the
+ * targets and tables of the others may lie past the end of the
+ * program.  Those count for nothing.
+ */
+
+static void
+opt_scan(void) {
+
+	grunt_pc_t pc, target;
+	uint32 i, last;
+
+	memset(g_refs, 0, sizeof(g_refs));
+	memset(g_table, 0, sizeof(g_table));
+
+	for (pc = 0; pc < g_num_instructions; pc++) {
+		if ((g_code[pc].op == GRUNT_OP_REPEAT) &&
+			((pc + 1) < g_num_instructions))
+			g_refs[pc + 1]++;
+		if (!opt_target(pc, &target)) continue;
+		if (target < g_num_instructions) g_refs[target]++;
+		if (g_table[pc]) continue;   /* a SWITCH's entry */
+		last = opt_table_length(pc);
+		for (i = 1; (i <= last) && ((pc + i) < g_num_instructions);
+			i++)
+			g_table[pc + i] = true;
+	}
+
+} /* opt_scan() */
+
+
+/* opt_kill()
+ *
+ * in:     pc - pc of an instruction to remove
+ * out:    g_dead[pc] - set
+ *         g_refs[]   - no longer counts what pc went to
+ * return: nothing
+ */
+
+static void
+opt_kill(grunt_pc_t pc) {
+
+	grunt_pc_t target;
+
+	if (opt_target(pc, &target)) g_refs[target]--;
+	g_dead[pc] = true;
+	g_changed  = true;
+
+} /* opt_kill() */
+
+
+/* opt_rewrite()
+ *
+ * in:     pc  - pc of an instruction to replace
+ *         op  - the new instruction's opcode: a PUSH, a JMPIF, or one
+ *               that takes a repetition count
+ *         val - its literal or repetition count
+ * out:    g_code[pc], g_origin[pc] - the new instruction
+ * return: nothing
+ */
+
+static void
+opt_rewrite(grunt_pc_t pc, grunt_opcode_t op, grunt_number_t val) {
+
+	grunt_instruction_t *p_i = &(g_code[pc]);
+
+	memset(p_i, 0, sizeof(*p_i));
+	p_i->op = op;
+	switch (op) {
+	case GRUNT_OP_PUSHB:
+		p_i->arg.lit.type  = gt_bool;
+		p_i->arg.lit.val.b = (val != 0);
+		break;
+	case GRUNT_OP_PUSHN:
+		p_i->arg.lit.type    = gt_num;
+		p_i->arg.lit.val.num = val;
+		break;
+	case GRUNT_OP_PUSHS:
+		p_i->arg.lit.type    = gt_str;
+		p_i->arg.lit.val.str = (grunt_string_t)val;
+		break;
+	case GRUNT_OP_JMPIF:
+		p_i->arg.lit.type   = gt_pc;
+		p_i->arg.lit.val.pc = (grunt_pc_t)val;
+		break;
+	default:
+		p_i->arg.rep = (grunt_rep_t)val;
+		break;
+	}
+	g_origin[pc] |= GRUNT_OPTIMIZE_REWRITTEN;
+	g_changed = true;
+
+} /* opt_rewrite() */
+
+
+/* opt_plain()
+ *
+ * in:     pc - first instruction of a sequence
+ *         n  - length of the sequence
+ * out:    nothing
+ * return: true if the sequence is within the program, holds no
+ *         removed instructions or table entries, and nothing goes to
+ *         any of its instructions but the first.
+ */
+
+static bool
+opt_plain(grunt_pc_t pc, grunt_pc_t n) {
+
+	grunt_pc_t i;
+
+	if ((uint32)pc + n > g_num_instructions) return false;
+	for (i = 0; i < n; i++) {
+		if (g_dead[pc + i] || g_table[pc + i]) return false;
+		if (i && g_refs[pc + i]) return false;
+	}
+	return true;
+
+} /* opt_plain() */
+
+
+/* opt_is_push()
+ *
+ * in:     pc - pc of an instruction
+ * out:    nothing
+ * return: true if it pushes a literal.
+ */
+
+static bool
+opt_is_push(grunt_pc_t pc) {
+
+	return ((g_code[pc].op == GRUNT_OP_PUSHB) ||
+		(g_code[pc].op == GRUNT_OP_PUSHN) ||
+		(g_code[pc].op == GRUNT_OP_PUSHS));
+
+} /* opt_is_push() */
+
+
+/* opt_reach()
+ *
+ * in:     g_code[], g_refs[], g_table[], g_types[] - the program
+ * out:    g_dead[] - set for every instruction no run reaches
+ * return: nothing
+ *
+ * Since all Grunt control transfers go forward, one pass in program
+ * counter order finds every instruction reachable from pc 0, as in
+ * the gruntaot translator.  A LOOKUP's or SWITCH's table is reachable
+ * only if something jumps into it, but it stays as long as its LOOKUP
+ * or SWITCH does.  Likewise a loop's END stays as long as its REPEAT
+ * does, even if every path through the body HALTs.  END's jump back
+ * goes to its body, which its REPEAT reaches anyway.
+ */
+
+static void
+opt_reach(void) {
+
+	const grunt_instruction_t *p_i;
+	grunt_pc_t n = g_num_instructions;
+	grunt_pc_t pc, target;
+	bool always;   /* a JMPIF that always jumps? */
+	uint32 i, last;
+
+	memset(g_reached, 0, sizeof(g_reached));
+	g_reached[0] = true;
+
+	for (pc = 0; pc < n; pc++) {
+
+		if (!g_reached[pc]) continue;
+		p_i = &(g_code[pc]);
+
+		switch (p_i->op) {
+		case GRUNT_OP_HALT:
+		case GRUNT_OP_RETURN:
+			break;
+		case GRUNT_OP_JMPIF:
+			(void)opt_target(pc, &target);
+			g_reached[target] = true;
+			always = ((pc > 0) && !g_refs[pc] &&
+				(g_code[pc - 1].op == GRUNT_OP_PUSHB) &&
+				g_code[pc - 1].arg.lit.val.b);
+			if (!always && ((pc + 1) < n)) g_reached[pc + 1] = true;
+			break;
+		case GRUNT_OP_CALL:
+		case GRUNT_OP_LOOKUP:
+			(void)opt_target(pc, &target);
+			g_reached[target] = true;
+			if ((p_i->op == GRUNT_OP_CALL) && ((pc + 1) < n))
+				g_reached[pc + 1] = true;
+			break;
+		case GRUNT_OP_SWITCH:
+			(void)opt_target(pc, &target);
+			g_reached[target] = true;
+			for (i = 1; i <= p_i->arg.rep; i++) {
+				(void)opt_target(pc + i, &target);
+				g_reached[target] = true;
+			}
+			break;
+		default:
+			if ((pc + 1) < n) g_reached[pc + 1] = true;
+			break;
+		}
+	}
+
+	for (pc = 0; pc < n; pc++)
+		g_dead[pc] = (!g_reached[pc] || (g_types[pc] == GT_UNSEEN));
+
+	for (pc = 0; pc < n; pc++) {
+		if (g_dead[pc]) continue;
+		last = opt_table_length(pc);
+		for (i = 1; i <= last; i++)
+			g_dead[pc + i] = false;   /* keep the table */
+		if (g_code[pc].op == GRUNT_OP_REPEAT) {
+			target = grunt_verify_loop_end(g_code, n, pc);
+			if (target) g_dead[target] = false;
+		}
+	}
+
+	for (pc = 0; pc < n; pc++) {
+		if (g_dead[pc]) g_changed = true;
+	}
+
+} /* opt_reach() */
+
+
+/* opt_compact()
+ *
+ * in:     g_code[], g_dead[] - the program, with instructions to remove
+ * out:    g_code[], g_origin[] - the program without them
+ * return: nothing
+ *
+ * A jump or call to a removed instruction goes to the next one that
+ * remains instead.  The optimizer removes only instructions that no
+ * run reaches or that do nothing on every path through them, so the
+ * next one is where such runs would have gone anyway.  A JMPIF that
+ * would then go to the very next instruction can only POP its
+ * Boolean, unless it is a SWITCH's entry, which may.
+ */
+
+static void
+opt_compact(void) {
+
+	grunt_instruction_t *p_i;
+	grunt_pc_t old, new = 0;
+	grunt_pc_t target;
+
+	for (old = 0; old < g_num_instructions; old++) {
+		g_map[old] = new;
+		if (!g_dead[old]) new++;
+	}
+	g_map[g_num_instructions] = new;
+
+	for (old = 0; old < g_num_instructions; old++) {
+		if (g_dead[old]) continue;
+		p_i = &(g_code[old]);
+		if (p_i->op == GRUNT_OP_JMPIF) {
+			(void)opt_target(old, &target);
+			p_i->arg.lit.val.pc = (grunt_pc_t)(g_map[target] -
+				g_map[old]);
+			if ((p_i->arg.lit.val.pc == 1) && !g_table[old])
+				opt_rewrite(old, GRUNT_OP_POP, 1);
+		} else if (p_i->op == GRUNT_OP_CALL) {
+			p_i->arg.lit.val.pc = g_map[p_i->arg.lit.val.pc];
+		}
+		g_code[g_map[old]]   = *p_i;
+		g_origin[g_map[old]] = g_origin[old];
+	}
+
+	g_num_instructions = new;
+	memset(g_dead, 0, sizeof(g_dead));
+
+} /* opt_compact() */
+
+
+/* opt_chain_case()
+ *
+ * in:     pc - pc of an instruction
+ * out:    nothing
+ * return: true if a compare-and-branch case starts at pc.
+ */
+
+static bool
+opt_chain_case(grunt_pc_t pc) {
+
+	const grunt_instruction_t *p_i = &(g_code[pc]);
+
+	return (opt_plain(pc, CHAIN_CASE_LEN) &&
+		(p_i[0].op == GRUNT_OP_DUP)    && (p_i[0].arg.rep == 1) &&
+		(p_i[1].op == GRUNT_OP_PUSHN)  &&
+		(p_i[2].op == GRUNT_OP_EQ)     && (p_i[2].arg.rep == 2) &&
+		(p_i[3].op == GRUNT_OP_NOT)    &&
+		(p_i[4].op == GRUNT_OP_JMPIF)  &&
+		(p_i[4].arg.lit.val.pc == CHAIN_CASE_LEN - 4) &&
+		(p_i[5].op == GRUNT_OP_POP)    && (p_i[5].arg.rep == 1) &&
+		(p_i[6].op == GRUNT_OP_PUSHS)  &&
+		(p_i[7].op == GRUNT_OP_RETURN));
+
+} /* opt_chain_case() */
+
+
+/* opt_chain()
+ *
+ * in:     pc - pc of an instruction
+ * out:    g_code[] - a chain starting at pc replaced by a LOOKUP
+ * return: number of instructions the chain held, or 0 if none starts
+ *         at pc.
+ *
+ * Only the first case may have other instructions going to it; each
+ * later case and the default may be reached only from the case before.
+ * The LOOKUP's table, followed by the default's RETURN, takes the
+ * chain's place:
+ *
+ *	LOOKUP(n), PUSHN(k1), PUSHS(s1), ..., PUSHS(d), RETURN
+ */
+
+static grunt_pc_t
+opt_chain(grunt_pc_t pc) {
+
+	grunt_pc_t end = pc;   /* pc of the default */
+	grunt_pc_t cases = 0, i;
+
+	while (opt_chain_case(end) && ((end == pc) || (g_refs[end] == 1)) &&
+		(cases < GRUNT_REP_MAX)) {
+		end += CHAIN_CASE_LEN;
+		cases++;
+	}
+	if ((cases < 2) || !opt_plain(end, 3) || (g_refs[end] != 1) ||
+		(g_code[end].op != GRUNT_OP_POP) ||
+		(g_code[end].arg.rep != 1) ||
+		(g_code[end + 1].op != GRUNT_OP_PUSHS) ||
+		(g_code[end + 2].op != GRUNT_OP_RETURN))
+		return 0;
+
+	/* Each entry moves down from a higher pc, so none is
+	 * overwritten before we copy it.
+	 */
+	for (i = 0; i < cases; i++) {
+		g_code[pc + 1 + (2 * i)] =
+			g_code[pc + (CHAIN_CASE_LEN * i) + 1];
+		g_origin[pc + 1 + (2 * i)] =
+			g_origin[pc + (CHAIN_CASE_LEN * i) + 1];
+		g_code[pc + 2 + (2 * i)] =
+			g_code[pc + (CHAIN_CASE_LEN * i) + 6];
+		g_origin[pc + 2 + (2 * i)] =
+			g_origin[pc + (CHAIN_CASE_LEN * i) + 6];
+	}
+	for (i = 1; i < 3; i++) {
+		g_code[pc + (2 * cases) + i]   = g_code[end + i];
+		g_origin[pc + (2 * cases) + i] = g_origin[end + i];
+	}
+	opt_rewrite(pc, GRUNT_OP_LOOKUP, cases);
+
+	for (i = pc + 1; i < end + 3; i++) {
+		g_refs[i]  = 0;
+		g_table[i] = (i < (pc + (2 * cases) + 2));
+		g_dead[i]  = (i > (pc + (2 * cases) + 2));
+	}
+	g_refs[pc + (2 * cases) + 2] = 1;   /* the LOOKUP's */
+
+	return (grunt_pc_t)(end + 3 - pc);
+
+} /* opt_chain() */
+
+
+/* opt_fold()
+ *
+ * in:     pc - pc of the first of m literal pushes
+ *         m  - number of pushes, followed by the instruction to fold
+ * out:    g_code[] - the pushes and instruction rewritten, if we can
+ * return: true if we rewrote them.
+ *
+ * Handles the rewrites that consume literals.  Only the last k of the
+ * pushes, those the instruction takes as arguments, change.
+ */
+
+static bool
+opt_fold(grunt_pc_t pc, grunt_pc_t m) {
+
+	const grunt_instruction_t *p_o = &(g_code[pc + m]);
+	const grunt_instruction_t *p_l;   /* one of the pushes */
+	grunt_instruction_t temp;
+	grunt_pc_t s;            /* first push the instruction consumes */
+	grunt_pc_t k, i, target;
+	grunt_pc_t dflt;         /* a SWITCH's default target */
+	grunt_pc_t origin;
+	grunt_number_t a, b;
+	grunt_boolean_t result;
+	uint32 last;
+
+	switch (p_o->op) {
+	case GRUNT_OP_POP:
+		k = ((p_o->arg.rep < m) ? p_o->arg.rep : m);
+		for (i = pc + m - k; i < pc + m; i++) opt_kill(i);
+		if (k == p_o->arg.rep) {
+			opt_kill(pc + m);
+		} else {
+			opt_rewrite(pc + m, GRUNT_OP_POP,
+				p_o->arg.rep - k);
+		}
+		return true;
+	case GRUNT_OP_DUP:
+		if (p_o->arg.rep != 1) return false;
+		g_code[pc + m]   = g_code[pc + m - 1];
+		g_origin[pc + m] = g_origin[pc + m - 1];
+		g_changed = true;
+		return true;
+	case GRUNT_OP_ROLL:
+		k = p_o->arg.rep;
+		if (k > m) return false;
+		s = pc + m - k;
+		temp   = g_code[pc + m - 1];
+		origin = g_origin[pc + m - 1];
+		memmove(&(g_code[s + 1]), &(g_code[s]),
+			(k - 1) * sizeof(g_code[0]));
+		memmove(&(g_origin[s + 1]), &(g_origin[s]),
+			(k - 1) * sizeof(g_origin[0]));
+		g_code[s]   = temp;
+		g_origin[s] = origin;
+		opt_kill(pc + m);
+		return true;
+	case GRUNT_OP_EQ:
+	case GRUNT_OP_AND:
+	case GRUNT_OP_OR:
+		k = p_o->arg.rep;
+		if (k > m) return false;
+		s = pc + m - k;
+		result = (p_o->op != GRUNT_OP_OR);
+		for (i = s; i < pc + m; i++) {
+			p_l = &(g_code[i]);
+			if (p_o->op == GRUNT_OP_EQ) {
+				if (p_l->op != GRUNT_OP_PUSHN) return false;
+				if (p_l->arg.lit.val.num ==
+					g_code[s].arg.lit.val.num) continue;
+				if (g_symbolic) return false;
+				result = false;
+			} else if (p_l->op != GRUNT_OP_PUSHB) {
+				return false;
+			} else if (p_o->op == GRUNT_OP_AND) {
+				result = result && p_l->arg.lit.val.b;
+			} else {
+				result = result || p_l->arg.lit.val.b;
+			}
+		}
+		break;
+	case GRUNT_OP_LT:
+	case GRUNT_OP_GT:
+	case GRUNT_OP_ADD:
+	case GRUNT_OP_SUB:
+		k = 2;
+		if (g_symbolic || (k > m)) return false;
+		s = pc + m - k;
+		if ((g_code[s].op != GRUNT_OP_PUSHN) ||
+			(g_code[s + 1].op != GRUNT_OP_PUSHN))
+			return false;
+		a = g_code[s].arg.lit.val.num;
+		b = g_code[s + 1].arg.lit.val.num;
+		if (p_o->op == GRUNT_OP_LT) {
+			result = (a < b);
+		} else if (p_o->op == GRUNT_OP_GT) {
+			result = (a > b);
+		} else {
+			/* Leave the overflow for the run to report. */
+			if ((p_o->op == GRUNT_OP_ADD) ?
+				(b > (GRUNT_NUM_MAX - a)) : (a < b))
+				return false;
+			opt_rewrite(s, GRUNT_OP_PUSHN,
+				((p_o->op == GRUNT_OP_ADD) ? a + b : a - b));
+			opt_kill(s + 1);
+			opt_kill(s + 2);
+			return true;
+		}
+		break;
+	case GRUNT_OP_NOT:
+		k = 1;
+		s = pc + m - k;
+		if (g_code[s].op != GRUNT_OP_PUSHB) return false;
+		result = !g_code[s].arg.lit.val.b;
+		break;
+	case GRUNT_OP_JMPIF:
+		s = pc + m - 1;
+		if ((g_code[s].op != GRUNT_OP_PUSHB) ||
+			g_code[s].arg.lit.val.b)
+			return false;   /* opt_reach() handles true */
+		opt_kill(s);
+		opt_kill(s + 1);
+		return true;
+	case GRUNT_OP_LOOKUP:
+		s = pc + m - 1;
+		if (g_symbolic || (g_code[s].op != GRUNT_OP_PUSHN))
+			return false;
+		last = 2 * (uint32)p_o->arg.rep;
+		for (i = 1; i <= last + 1; i++) {
+			if (g_refs[s + 1 + i]) return false;
+		}
+		for (i = 0; i < last; i += 2) {
+			if (g_code[s + 2 + i].arg.lit.val.num ==
+				g_code[s].arg.lit.val.num)
+				break;
+		}
+		if (i < last) i++;   /* the key's string, else the default */
+		opt_rewrite(s, GRUNT_OP_PUSHS,
+			g_code[s + 2 + i].arg.lit.val.str);
+		for (i = 0; i <= last + 1; i++) opt_kill(s + 1 + i);
+		return true;
+	case GRUNT_OP_SWITCH:
+		/* "PUSHB true; JMPIF" to the key's target. */
+		s = pc + m - 1;
+		if (g_symbolic || (g_code[s].op != GRUNT_OP_PUSHN))
+			return false;
+		last = p_o->arg.rep;
+		for (i = 1; i <= last; i++) {
+			if (g_refs[s + 1 + i]) return false;
+		}
+		/* Leave malformed tables unfolded. */
+		a = g_code[s].arg.lit.val.num;
+		if (!opt_target(s + 1, &dflt)) return false;
+		target = dflt;
+		if ((a < last) && !opt_target(s + 2 + a, &target))
+			return false;
+		g_refs[dflt]--;
+		g_refs[target]++;
+		opt_rewrite(s, GRUNT_OP_PUSHB, true);
+		opt_rewrite(s + 1, GRUNT_OP_JMPIF, target - (s + 1));
+		for (i = 1; i <= last; i++) opt_kill(s + 1 + i);
+		return true;
+	default:
+		return false;
+	}
+
+	/* The instructions that compute a Boolean from literals. */
+	opt_rewrite(s, GRUNT_OP_PUSHB, result);
+	for (i = s + 1; i <= pc + m; i++) opt_kill(i);
+	return true;
+
+} /* opt_fold() */
+
+
+/* opt_peephole()
+ *
+ * in:     pc - pc of an instruction
+ * out:    g_code[] - any sequence starting at pc rewritten
+ * return: number of instructions the rewritten sequence held, or 0
+ *         if we rewrote nothing.
+ */
+
+static grunt_pc_t
+opt_peephole(grunt_pc_t pc) {
+
+	grunt_instruction_t *p_i = &(g_code[pc]);
+	grunt_pc_t m = 0;   /* number of literal pushes starting at pc */
+	grunt_pc_t n, target;
+
+	if (g_dead[pc] || g_table[pc]) return 0;
+
+	if ((n = opt_chain(pc))) return n;
+
+	while (opt_plain(pc, m + 1) && opt_is_push(pc + m)) m++;
+	if (m && opt_plain(pc, m + 1) && opt_fold(pc, m)) return m + 1;
+
+	/* Jump threading: a JMPIF to a "PUSHB true; JMPIF" goes where
+	 * that one does.
+	 */
+	if (p_i->op == GRUNT_OP_JMPIF) {
+		(void)opt_target(pc, &target);
+		if (opt_plain(target, 2) &&
+			(g_code[target].op == GRUNT_OP_PUSHB) &&
+			g_code[target].arg.lit.val.b &&
+			(g_code[target + 1].op == GRUNT_OP_JMPIF)) {
+			g_refs[target]--;
+			target = (grunt_pc_t)(target + 1 +
+				g_code[target + 1].arg.lit.val.pc);
+			g_refs[target]++;
+			p_i->arg.lit.val.pc = (grunt_pc_t)(target - pc);
+			g_changed = true;
+			return 1;
+		}
+	}
+
+	if (!opt_plain(pc, 2)) return 0;
+
+	/* DUP(r), POP(q) for q >= r leaves POP(q - r) if anything. */
+	if ((p_i[0].op == GRUNT_OP_DUP) && (p_i[1].op == GRUNT_OP_POP) &&
+		(p_i[1].arg.rep >= p_i[0].arg.rep)) {
+		opt_kill(pc);
+		if (p_i[1].arg.rep == p_i[0].arg.rep) {
+			opt_kill(pc + 1);
+		} else {
+			opt_rewrite(pc + 1, GRUNT_OP_POP,
+				p_i[1].arg.rep - p_i[0].arg.rep);
+		}
+		return 2;
+	}
+
+	/* NOT pairs, and ROLL(2) pairs that inlining leaves behind,
+	 * undo themselves.
+	 */
+	if (((p_i[0].op == GRUNT_OP_NOT) && (p_i[1].op == GRUNT_OP_NOT)) ||
+		((p_i[0].op == GRUNT_OP_ROLL) && (p_i[0].arg.rep == 2) &&
+		(p_i[1].op == GRUNT_OP_ROLL) && (p_i[1].arg.rep == 2))) {
+		opt_kill(pc);
+		opt_kill(pc + 1);
+		return 2;
+	}
+
+	return 0;
+
+} /* opt_peephole() */
+
+
+/* opt_leaf()
+ *
+ * in:     entry - pc of a CALL's target
+ * out:    nothing
+ * return: the number of instructions before the RETURN of the leaf
+ *         subroutine at entry, or 0 if it is not one we inline.
+ *
+ * Nothing may go to the leaf's instructions but its first, so each
+ * copy can stand alone.  A leaf that is only a RETURN isn't worth the
+ * trouble: removing its CALLs could leave a JMPIF that goes to the
+ * very next instruction.
+ */
+
+static grunt_pc_t
+opt_leaf(grunt_pc_t entry) {
+
+	grunt_pc_t b;
+
+	for (b = 0; b <= GRUNT_OPTIMIZE_INLINE_MAX; b++) {
+		if (!opt_plain(entry, b + 1)) return 0;
+		switch (g_code[entry + b].op) {
+		case GRUNT_OP_RETURN:
+			return b;
+		case GRUNT_OP_CALL:
+		case GRUNT_OP_HALT:
+		case GRUNT_OP_JMPIF:
+		case GRUNT_OP_LOOKUP:
+		case GRUNT_OP_SWITCH:
+		case GRUNT_OP_REPEAT:
+		case GRUNT_OP_END:
+			return 0;
+		default:
+			break;
+		}
+	}
+	return 0;
+
+} /* opt_leaf() */
+
+
+/* opt_inline()
+ *
+ * in:     g_code[], g_refs[], g_table[] - the program, compacted
+ * out:    g_code[], g_origin[] - the program with leaf calls inlined
+ * return: nothing
+ *
+ * Each copy's origin is that of the leaf instruction it copies, with
+ * GRUNT_OPTIMIZE_INLINED set.  Leaves have no jumps or calls of their
+ * own, so only the program's other jumps and calls need moving.
+ */
+
+static void
+opt_inline(void) {
+
+	grunt_instruction_t *p_i;
+	grunt_pc_t old, new = 0;
+	grunt_pc_t target, k;
+	uint32 size = g_num_instructions;   /* after inlining */
+	uint32 calls = 0;                   /* CALLs to inline */
+
+	for (old = 0; old < g_num_instructions; old++) {
+		g_inline[old] = 0;
+		if ((g_code[old].op != GRUNT_OP_CALL) || g_table[old])
+			continue;
+		(void)opt_target(old, &target);
+		k = opt_leaf(target);
+		if (k && ((size + k - 1) <= g_capacity)) {
+			g_inline[old] = (uint8)k;
+			size += k - 1;
+			calls++;
+		}
+	}
+	if (!calls) return;
+
+	for (old = 0; old < g_num_instructions; old++) {
+		g_map[old] = new;
+		new += (g_inline[old] ? g_inline[old] : 1);
+	}
+	g_map[g_num_instructions] = new;
+
+	for (old = 0; old < g_num_instructions; old++) {
+		p_i = &(g_code[old]);
+		if (g_inline[old]) {
+			for (k = 0; k < g_inline[old]; k++) {
+				g_new_code[g_map[old] + k] =
+					g_code[p_i->arg.lit.val.pc + k];
+				g_new_origin[g_map[old] + k] =
+					g_origin[p_i->arg.lit.val.pc + k] |
+					GRUNT_OPTIMIZE_INLINED;
+			}
+			continue;
+		}
+		g_new_code[g_map[old]]   = *p_i;
+		g_new_origin[g_map[old]] = g_origin[old];
+		if (p_i->op == GRUNT_OP_JMPIF) {
+			(void)opt_target(old, &target);
+			g_new_code[g_map[old]].arg.lit.val.pc =
+				(grunt_pc_t)(g_map[target] - g_map[old]);
+		} else if (p_i->op == GRUNT_OP_CALL) {
+			g_new_code[g_map[old]].arg.lit.val.pc =
+				g_map[p_i->arg.lit.val.pc];
+		}
+	}
+
+	memcpy(g_code, g_new_code, new * sizeof(g_code[0]));
+	memcpy(g_origin, g_new_origin, new * sizeof(g_origin[0]));
+	g_num_instructions = new;
+	g_changed = true;
+
+} /* opt_inline() */
+
+
+/* ------------------- module exported functions -------------------- */
+
+/* grunt_optimize_program()
+ *
+ * in:     program          - Grunt program to optimize
+ *         num_instructions - number of instructions in program
+ *         num_strings      - number of strings in program's string table
+ *         p_optimized      - code[], origin[], capacity, and flags
+ * out:    p_optimized      - holds the optimized program
+ * return: 0 on success; the verifier's GRUNT_ERROR_* code if program
+ *         doesn't verify; GRUNT_ERROR_OUTOFBOUNDS if it or its
+ *         optimized form doesn't fit; or GRUNT_ERROR_INTERPRETERBUG
+ *         if a pass produced a program the verifier rejects.
+ *
+ * Leaves p_optimized untouched unless it succeeds.
+ */
+
+int
+grunt_optimize_program(const grunt_instruction_t *program,
+	grunt_pc_t num_instructions, grunt_string_t num_strings,
+	grunt_optimized_program_t *p_optimized) {
+
+	grunt_pc_t error_pc;
+	grunt_pc_t pc, n;
+	int pass;
+	int status;
+
+	if (num_instructions > GRUNT_OPTIMIZE_MAX_INSTRUCTIONS)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	if ((status = grunt_verify_program(program, num_instructions,
+		num_strings, g_types, &error_pc)))
+		return status;
+
+	memcpy(g_code, program, num_instructions * sizeof(g_code[0]));
+	for (pc = 0; pc < num_instructions; pc++) g_origin[pc] = pc;
+	memset(g_dead, 0, sizeof(g_dead));
+	g_num_instructions = num_instructions;
+	g_symbolic = ((p_optimized->flags & GRUNT_OPTIMIZE_SYMBOLIC) != 0);
+	g_capacity = ((p_optimized->max_instructions <
+		GRUNT_OPTIMIZE_MAX_INSTRUCTIONS) ?
+		p_optimized->max_instructions :
+		GRUNT_OPTIMIZE_MAX_INSTRUCTIONS);
+
+	for (pass = 0; pass < GRUNT_OPTIMIZE_MAX_PASSES; pass++) {
+
+		g_changed = false;
+
+		opt_scan();
+		opt_reach();
+		opt_compact();
+
+		opt_scan();
+		for (pc = 0; pc < g_num_instructions; pc += (n ? n : 1))
+			n = opt_peephole(pc);
+		opt_compact();
+
+		opt_scan();
+		opt_inline();
+
+		if (grunt_verify_program(g_code, g_num_instructions,
+			num_strings, g_types, &error_pc))
+			return GRUNT_ERROR_INTERPRETERBUG;
+
+		if (!g_changed) break;
+	}
+
+	if (g_num_instructions > p_optimized->max_instructions)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+
+	memcpy(p_optimized->code, g_code,
+		g_num_instructions * sizeof(g_code[0]));
+	if (p_optimized->origin) {
+		memcpy(p_optimized->origin, g_origin,
+			g_num_instructions * sizeof(g_origin[0]));
+	}
+	p_optimized->num_instructions = g_num_instructions;
+	return 0;  /* OK! */
+
+} /* grunt_optimize_program() */
@@ -21,23 +21,39 @@
 #include "grunt_output.h"
 
 
-/* grunt_number_t is a 32-bit unsigned quantity. It's maximum (and
- * thus longest) value is 4,294,967,295, which requires 10 characters
- * + 1 for a NUL terminator to express.  NOTE: If you change the size
- * of grunt_number_t, you'll need to change this constant to match.
- *
- * This constant defines an adequate size for temporary buffers to
- * hold the string version of grunt_number_t numbers.
+/* grunt_number_t is a 32-bit unsigned quantity.  Its maximum (and
+ * thus longest) value is 4,294,967,295, which takes 10 decimal digits
+ * to express.  NOTE: If you change the size of grunt_number_t, you'll
+ * need to change NUMBER_MAX_DIGITS and powers_of_ten[] to match.
  */
-#define NUMBER_BUFFER_SIZE 16       /* Need only 11, but 16 is word-aligned. */
+#define NUMBER_MAX_DIGITS 10
+
+/* powers_of_ten[i] is the smallest number with i + 2 digits. */
+static const grunt_number_t powers_of_ten[NUMBER_MAX_DIGITS - 1] = {
+	10U, 100U, 1000U, 10000U, 100000U, 1000000U, 10000000U,
+	100000000U, 1000000000U
+};
+
+/* The two-digit strings "00" through "99", back-to-back, so that
+ * grunt_output_enqueue_number() can format numbers two digits at a
+ * time.
+ */
+static const char digit_pairs[] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
 
 /* Grunt programs define a "string table": an array of constant
  * strings.  Whent hey want to enqueue one of these strings to the
  * output queue during runtime, they refer to them by their index in
- * the string table array.
+ * the string table array.  Each grunt_vm_t holds a pointer to its
+ * program's string table and the number of strings it contains.  A
+ * VM given the table's string lengths by GRUNT_SetStringLengths()
+ * also holds them, and takes each string's length from them rather
+ * than calling strlen() on every enqueue.
  */
-static const char **g_string_table;      /* Grunt program's table of strings */
-static grunt_rep_t g_num_strings;       /* number of strings in string table */
 
 /* The Grunt interpreter maintains an "output queue" which holds an
  * initially-empty NUL-terminated C string.  Grunt programs build
@@ -45,30 +61,33 @@ static grunt_rep_t g_num_strings;       /* number of strings in string table */
  * themon (appending them to) this queue.  The Grunt interpreter also
  * has an "input queue", but despite their both being queues we've
  * kept their implementations separate since the input queue is
- * dequeue-only and this output queue is enqueue-only.
+ * dequeue-only and this output queue is enqueue-only.  Each
+ * grunt_vm_t holds its own output queue of GRUNT_OUTPUT_QUEUE_SIZE
+ * chars and the index of its terminating NUL.  Each enqueue writes a
+ * new terminating NUL, so the chars beyond it may hold leftovers from
+ * earlier messages.
  */
-#define OUTPUT_QUEUE_SIZE CFE_MISSION_EVS_MAX_MESSAGE_LENGTH
-static char g_output_queue[OUTPUT_QUEUE_SIZE]; /* strings constructed here */
-static grunt_rep_t g_tail_index;     /* index of terminating NUL in buffer */
+#define OUTPUT_QUEUE_SIZE GRUNT_OUTPUT_QUEUE_SIZE
 
 
 /* ------------------- module local functions -------------------- */
 
 static void
-grunt_output_reset(void) {
+grunt_output_reset(grunt_vm_t *p_vm) {
 
-	memset(g_output_queue, '\0', OUTPUT_QUEUE_SIZE);
-	g_tail_index = 0;
+	p_vm->output_queue[0] = '\0';
+	p_vm->tail_index = 0;
 
 } /* grunt_output_reset() */
 
 
 /* grunt_output_enqueue()
  *
- * in:     string - string to append to string buffer
+ * in:     p_vm   - VM whose output queue to append to
+ *         string - string to append to string buffer
  *         length - length of string, not including terminating NUL
- * out:    g_output_queue - string (might be) appended
- *         g_tail_index     - (might be) incremented by length
+ * out:    p_vm->output_queue - string (might be) appended, with NUL
+ *         p_vm->tail_index   - (might be) incremented by length
  * return: value                    condition
  *         -------------            ---------------
  *         GRUNT_ERROR_OUTOFBOUNDS  There is not enough room for string
@@ -78,21 +97,26 @@ grunt_output_reset(void) {
  * output queue.  Otherwise, returns error and leaves output queue
  * unchanged.
  *
+ * length is a size_t rather than a grunt_rep_t: given a length it
+ * knows to be small, GCC inlines the memcpy() as a "rep movsq" that
+ * costs several times the library call on short strings.
  */
 
 static int
-grunt_output_enqueue(const char *string, grunt_rep_t length) {
+grunt_output_enqueue(grunt_vm_t *p_vm, const char *string,
+	size_t length) {
 
 	/* If appending the indicated string would exceed the length
 	 * of our output queue, report an overflow and refuse to
 	 * append.
 	 */
-	if (g_tail_index + length > (OUTPUT_QUEUE_SIZE - 1)) {
+	if (p_vm->tail_index + length > (OUTPUT_QUEUE_SIZE - 1)) {
 		return GRUNT_ERROR_OUTOFBOUNDS;
 	}
 
-	memcpy(&(g_output_queue[g_tail_index]),	string,	length);
-	g_tail_index += length;
+	memcpy(&(p_vm->output_queue[p_vm->tail_index]), string, length);
+	p_vm->tail_index += length;
+	p_vm->output_queue[p_vm->tail_index] = '\0';
 	return 0;  /* OK! */
 
 } /* grunt_output_enqueue() */
@@ -102,74 +126,214 @@ grunt_output_enqueue(const char *string, grunt_rep_t length) {
 
 
 void
-grunt_output_init(const char *string_table[], grunt_string_t num_strings) {
+grunt_output_init(grunt_vm_t *p_vm, const char *string_table[],
+	grunt_string_t num_strings) {
 
-	g_string_table = string_table;
-	g_num_strings  = num_strings;
-	grunt_output_reset();
+	p_vm->string_table   = string_table;
+	p_vm->num_strings    = num_strings;
+	p_vm->string_lengths = ((string_table == p_vm->lengths_table) ?
+		p_vm->lengths : NULL);
+	grunt_output_reset(p_vm);
 
 } /* grunt_output_init() */
 
 
 int
-grunt_output_enqueue_boolean(grunt_boolean_t tf) {
+grunt_output_enqueue_boolean(grunt_vm_t *p_vm, grunt_boolean_t tf) {
 
 	if (tf) {
-		return grunt_output_enqueue("true", 4);
+		return grunt_output_enqueue(p_vm, "true", 4);
 	} else {
-		return grunt_output_enqueue("false", 5);
+		return grunt_output_enqueue(p_vm, "false", 5);
 	}
 
 } /* grunt_output_enqueue_boolean() */
 
 
 int
-grunt_output_enqueue_number(grunt_number_t u) {
+grunt_output_enqueue_number(grunt_vm_t *p_vm, grunt_number_t u) {
 
-	char string[NUMBER_BUFFER_SIZE];  /* receives string form of u */
-	int length;       /* receives ideal length of string form of u */
+	grunt_rep_t length;  /* number of decimal digits in u */
+	char *p;             /* next char to write, working backwards */
+	unsigned int pair;   /* index of two digits in digit_pairs[] */
 
-	/* snprintf() will return the ideal length of the string
-	 * representation of the number u given sufficient space.
-	 * However, it will actually write no more than
-	 * NUMBER_BUFFER_SIZE - 1 digit characters followed by NUL.
+	/* Format u in decimal directly into the output queue, two
+	 * digits at a time from the least significant end.  This is
+	 * much cheaper than snprintf() on our target libc.  Like
+	 * grunt_output_enqueue(), leave the output queue unchanged if
+	 * u won't fit.
 	 */
-	if (-1 == (length = snprintf(string, NUMBER_BUFFER_SIZE, "%u", u)))
-		return GRUNT_ERROR_INTERPRETERBUG;
 
-	if (length > GRUNT_REP_MAX) return GRUNT_ERROR_INTERPRETERBUG;
-	
-	return grunt_output_enqueue(string, length);
+	for (length = 1; (length < NUMBER_MAX_DIGITS) &&
+		     (u >= powers_of_ten[length - 1]); length++);
+
+	if (p_vm->tail_index + length > (OUTPUT_QUEUE_SIZE - 1)) {
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	}
+
+	p_vm->tail_index += length;
+	p = &(p_vm->output_queue[p_vm->tail_index]);
+	*p = '\0';
+
+	while (u >= 100) {
+		pair = (unsigned int)(u % 100) * 2;
+		u /= 100;
+		*--p = digit_pairs[pair + 1];
+		*--p = digit_pairs[pair];
+	}
+	if (u >= 10) {
+		pair = (unsigned int)u * 2;
+		*--p = digit_pairs[pair + 1];
+		*--p = digit_pairs[pair];
+	} else {
+		*--p = (char)('0' + u);
+	}
+
+	return 0;  /* OK! */
 	
 } /* grunt_output_enqueue_number() */
 
 
 int
-grunt_output_enqueue_string(grunt_string_t string_index) {
+grunt_output_enqueue_string(grunt_vm_t *p_vm, grunt_string_t string_index) {
 
 	grunt_rep_t length;
+	size_t full_length;   /* strlen(), before narrowing to length */
 
 	/* Make sure we're trying to append a string that is in our
 	 * string table.
 	 */
-	if (!(string_index < g_num_strings)) return GRUNT_ERROR_INVALIDLITERAL;
+	if (!(string_index < p_vm->num_strings))
+		return GRUNT_ERROR_INVALIDLITERAL;
 
 	/* Get the length of the string.  Fail if string
 	 * is too long for our chosen index variable type.
 	 */
-	if (GRUNT_REP_MAX < (length = strlen(g_string_table[string_index])))
-		return GRUNT_ERROR_OUTOFBOUNDS;
+	if (p_vm->string_lengths) {
+		length = p_vm->string_lengths[string_index];
+	} else {
+		full_length = strlen(p_vm->string_table[string_index]);
+		if (full_length > GRUNT_REP_MAX)
+			return GRUNT_ERROR_OUTOFBOUNDS;
+		length = (grunt_rep_t)full_length;
+	}
 		
-	return grunt_output_enqueue(g_string_table[string_index], length);
+	return grunt_output_enqueue(p_vm, p_vm->string_table[string_index],
+		length);
 	
 } /* grunt_output_enqueue_string() */
 
 
+/* grunt_output_enqueue_value()
+ *
+ * in:     p_vm - VM whose output queue to append to
+ *         p_v  - value to append
+ * out:    p_vm->output_queue - p_v formatted as OUTPUT formats it
+ * return: GRUNT_ERROR_INVALIDARGUMENT for gt_pc values, else the
+ *         grunt_output_enqueue_*() status.
+ */
+
+static int
+grunt_output_enqueue_value(grunt_vm_t *p_vm, const grunt_value_t *p_v) {
+
+	switch (p_v->type) {
+	case gt_bool:
+		return grunt_output_enqueue_boolean(p_vm, p_v->val.b);
+	case gt_num:
+		return grunt_output_enqueue_number(p_vm, p_v->val.num);
+	case gt_str:
+		return grunt_output_enqueue_string(p_vm, p_v->val.str);
+	default:
+		/* You can't output elements of type gt_pc. */
+		return GRUNT_ERROR_INVALIDARGUMENT;
+	}
+
+} /* grunt_output_enqueue_value() */
+
+
+/* grunt_output_enqueue_format()
+ *
+ * in:     p_vm      - VM whose output queue to append to
+ *         fmt       - string table index of a FORMAT template
+ *         values    - values for the template's placeholders, as they
+ *                     lay on the arg stack below it: values[n - 1]
+ *                     fills the first placeholder, values[0] the last
+ *         n         - number of values
+ * out:    p_vm->output_queue - expanded template appended, or unchanged
+ * return: value                        condition
+ *         -------------                ---------------
+ *         GRUNT_ERROR_INVALIDLITERAL   fmt not in the string table,
+ *                                      or has other than n placeholders
+ *         GRUNT_ERROR_INVALIDARGUMENT  a value is of type gt_pc
+ *         GRUNT_ERROR_OUTOFBOUNDS      not enough room for the message
+ *         0                            Success
+ *
+ * Does FORMAT's work in one pass over the template, copying each run
+ * of text between placeholders with one grunt_output_enqueue().
+ */
+
+int
+grunt_output_enqueue_format(grunt_vm_t *p_vm, grunt_string_t fmt,
+	const grunt_value_t *values, grunt_rep_t n) {
+
+	const char *p, *p_end, *p_mark;  /* template, its end, next '%' */
+	grunt_rep_t tail = p_vm->tail_index;  /* to undo a failure */
+	int status = 0;
+
+	if (!(fmt < p_vm->num_strings))
+		return GRUNT_ERROR_INVALIDLITERAL;
+
+	p = p_vm->string_table[fmt];
+	p_end = p + (p_vm->string_lengths ? p_vm->string_lengths[fmt] :
+		strlen(p));
+
+	do {
+		/* The text up to the next placeholder, or the end. */
+		if (!(p_mark = memchr(p, '%', (size_t)(p_end - p))))
+			p_mark = p_end;
+		if ((status = grunt_output_enqueue(p_vm, p,
+			(size_t)(p_mark - p))))
+			break;
+		if (p_mark == p_end) {
+			if (n) status = GRUNT_ERROR_INVALIDLITERAL;
+			break;
+		}
+
+		/* The placeholder. */
+		if (!n) {
+			status = GRUNT_ERROR_INVALIDLITERAL;
+			break;
+		}
+		if ((status = grunt_output_enqueue_value(p_vm, &(values[--n]))))
+			break;
+		p = p_mark + 1;
+	} while (1);
+
+	if (status) {
+		p_vm->tail_index = tail;
+		p_vm->output_queue[tail] = '\0';
+	}
+	return status;
+
+} /* grunt_output_enqueue_format() */
+
+
 void
-grunt_output_flush(grunt_number_t event_type, grunt_number_t event_id) {
+grunt_output_flush(grunt_vm_t *p_vm, grunt_number_t event_type,
+	grunt_number_t event_id) {
 	
-	CFE_EVS_SendEvent(event_id, event_type, "%s", g_output_queue);
+	if (p_vm->perf_flush_id) CFE_ES_PerfLogEntry(p_vm->perf_flush_id);
+
+	if (p_vm->event_sink) {
+		p_vm->event_sink(p_vm->event_sink_arg, event_type, event_id,
+			p_vm->output_queue);
+	} else {
+		CFE_EVS_SendEvent(event_id, event_type, "%s",
+			p_vm->output_queue);
+	}
+
+	grunt_output_reset(p_vm);
 
-	grunt_output_reset();
+	if (p_vm->perf_flush_id) CFE_ES_PerfLogExit(p_vm->perf_flush_id);
 	
 } /* grunt_output_flush() */
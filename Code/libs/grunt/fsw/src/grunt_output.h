@@ -16,10 +16,12 @@
  * permissions and limitations under the License.
  */
 
-void grunt_output_init(const char **, grunt_string_t);
-int  grunt_output_enqueue_boolean(grunt_boolean_t);
-int  grunt_output_enqueue_number(grunt_number_t);
-int  grunt_output_enqueue_string(grunt_string_t);
-void grunt_output_flush(grunt_number_t, grunt_number_t);
+void grunt_output_init(grunt_vm_t *, const char **, grunt_string_t);
+int  grunt_output_enqueue_boolean(grunt_vm_t *, grunt_boolean_t);
+int  grunt_output_enqueue_number(grunt_vm_t *, grunt_number_t);
+int  grunt_output_enqueue_string(grunt_vm_t *, grunt_string_t);
+int  grunt_output_enqueue_format(grunt_vm_t *, grunt_string_t,
+	const grunt_value_t *, grunt_rep_t);
+void grunt_output_flush(grunt_vm_t *, grunt_number_t, grunt_number_t);
 
 #endif
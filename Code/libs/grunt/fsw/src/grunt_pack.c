@@ -0,0 +1,393 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module implements the loader for Grunt's packed instruction
+ * encoding described in grunt.h.  The loader translates each
+ * instruction exactly: an instruction with a bad opcode or literal
+ * packs into a word that the interpreter rejects with the same error
+ * status it would report for the original instruction.
+ *
+ * The loader also makes a peephole pass over the packed code to mark
+ * the starts of common instruction sequences with the superinstruction
+ * opcodes described in grunt.h.  For the verified stack engine, which
+ * keeps no types on its arg stack, grunt_pack_type() then writes the
+ * types the verifier proved each OUTPUT and FORMAT takes into their
+ * words' otherwise unused tags.
+ */
+
+#include "cfe.h"
+
+#include "grunt_status.h"
+#include "grunt.h"
+#include "grunt_pack.h"
+#include "grunt_verify.h"
+
+
+/* ------------------- module local functions -------------------- */
+
+/* pack_has_literal()
+ *
+ * in:     op - opcode
+ * out:    nothing
+ * return: true if instructions with opcode op take a literal
+ *         argument, false if they take a repetition count or nothing.
+ */
+
+static bool
+pack_has_literal(grunt_opcode_t op) {
+
+	switch (op) {
+	case GRUNT_OP_CALL:
+	case GRUNT_OP_JMPIF:
+	case GRUNT_OP_PUSHB:
+	case GRUNT_OP_PUSHN:
+	case GRUNT_OP_PUSHS:
+	case GRUNT_OP_EQN:     /* starts with PUSHN */
+		return true;
+	default:
+		return false;
+	}
+
+} /* pack_has_literal() */
+
+
+/* pack_literal()
+ *
+ * in:     p_lit    - literal to pack
+ *         p_packed - packed program being loaded
+ * out:    *p_tag     - literal type tag
+ *         *p_operand - 16-bit literal value or pool index
+ *         p_packed   - may gain a pool entry
+ * return: GRUNT_ERROR_OUTOFBOUNDS if the pool is full, else 0.
+ */
+
+static int
+pack_literal(const grunt_value_t *p_lit, grunt_packed_program_t *p_packed,
+	uint8 *p_tag, uint16 *p_operand) {
+
+	uint16 i;
+
+	*p_operand = 0;
+
+	switch (p_lit->type) {
+	case gt_bool:
+		*p_tag = gt_bool;
+		*p_operand = (p_lit->val.b ? 1 : 0);
+		break;
+	case gt_num:
+		*p_tag = gt_num;
+		if (p_lit->val.num <= UINT16_MAX) {
+			*p_operand = (uint16)p_lit->val.num;
+			break;
+		}
+
+		/* Share pool entries among equal literals. */
+		for (i = 0; i < p_packed->num_literals; i++) {
+			if (p_packed->pool[i] == p_lit->val.num) break;
+		}
+		if (i == p_packed->num_literals) {
+			if (!(i < p_packed->max_literals))
+				return GRUNT_ERROR_OUTOFBOUNDS;
+			p_packed->pool[p_packed->num_literals++] =
+				p_lit->val.num;
+		}
+		*p_tag |= GRUNT_PACKED_POOLED;
+		*p_operand = i;
+		break;
+	case gt_str:
+		*p_tag = gt_str;
+		*p_operand = p_lit->val.str;
+		break;
+	case gt_pc:
+		*p_tag = gt_pc;
+		*p_operand = p_lit->val.pc;
+		break;
+	default:
+		/* The interpreter rejects this literal without looking
+		 * at its value.
+		 */
+		*p_tag = GRUNT_PACKED_BADTYPE;
+		break;
+	}
+
+	return 0;  /* OK! */
+
+} /* pack_literal() */
+
+
+/* pack_is_pushn()
+ *
+ * in:     w - packed word
+ * out:    nothing
+ * return: true if w is a PUSHN with a valid number literal.
+ */
+
+static bool
+pack_is_pushn(grunt_packed_t w) {
+
+	return ((GRUNT_PACKED_OP(w) == GRUNT_OP_PUSHN) &&
+		((GRUNT_PACKED_TAG(w) & ~GRUNT_PACKED_POOLED) == gt_num));
+
+} /* pack_is_pushn() */
+
+
+/* pack_fuse()
+ *
+ * in:     p_packed - packed program
+ * out:    p_packed - superinstruction opcodes marked
+ * return: nothing
+ *
+ * Scans the program for the sequences listed in grunt.h and rewrites
+ * the opcode of each one's first word.  Sequences don't overlap, so
+ * every word after the first in a sequence keeps its plain opcode.
+ * The pass fuses only sequences whose literals and repetition counts
+ * are the ones the superinstruction describes; the interpreter still
+ * checks everything else at run time.  None of the sequences can
+ * start within a LOOKUP's or SWITCH's table, so tables keep their
+ * opcodes.
+ */
+
+static void
+pack_fuse(grunt_packed_program_t *p_packed) {
+
+	grunt_packed_t *code = p_packed->code;
+	grunt_pc_t n = p_packed->num_instructions;
+	grunt_pc_t pc = 0;
+	grunt_opcode_t op, fused;
+
+	while (pc < n) {
+
+		op = GRUNT_PACKED_OP(code[pc]);
+		fused = 0;
+
+		if (((pc + 2) < n) && pack_is_pushn(code[pc + 1])) {
+			if ((op == GRUNT_OP_DUP) &&
+				(GRUNT_PACKED_OPERAND(code[pc]) == 1) &&
+				(GRUNT_PACKED_OP(code[pc + 2]) == GRUNT_OP_EQ) &&
+				(GRUNT_PACKED_OPERAND(code[pc + 2]) == 2)) {
+				fused = GRUNT_OP_DUPEQN;
+			} else if (op == GRUNT_OP_INPUT) {
+				if (GRUNT_PACKED_OP(code[pc + 2]) == GRUNT_OP_LT)
+					fused = GRUNT_OP_INPUTLTN;
+				else if (GRUNT_PACKED_OP(code[pc + 2]) ==
+					GRUNT_OP_GT)
+					fused = GRUNT_OP_INPUTGTN;
+			}
+		}
+		if (!fused && ((pc + 1) < n)) {
+			if (pack_is_pushn(code[pc]) &&
+				(GRUNT_PACKED_OP(code[pc + 1]) == GRUNT_OP_EQ) &&
+				(GRUNT_PACKED_OPERAND(code[pc + 1]) >= 2)) {
+				fused = GRUNT_OP_EQN;
+			} else if ((op == GRUNT_OP_NOT) &&
+				(GRUNT_PACKED_OP(code[pc + 1]) == GRUNT_OP_JMPIF) &&
+				(GRUNT_PACKED_TAG(code[pc + 1]) == gt_pc) &&
+				(GRUNT_PACKED_OPERAND(code[pc + 1]) >= 2)) {
+				fused = GRUNT_OP_NOTJMPIF;
+			}
+		}
+
+		if (!fused) {
+			pc++;
+			continue;
+		}
+
+		code[pc] = ((code[pc] & ~(grunt_packed_t)0xFF) | fused);
+		pc += grunt_pack_fused_length(fused);
+	}
+
+} /* pack_fuse() */
+
+
+/* ------------------- module exported functions -------------------- */
+
+/* grunt_pack_fused_length()
+ *
+ * in:     op - opcode
+ * out:    nothing
+ * return: the number of instructions in the sequence superinstruction
+ *         op stands for, or 0 if op is not a superinstruction.
+ */
+
+grunt_pc_t
+grunt_pack_fused_length(grunt_opcode_t op) {
+
+	switch (op) {
+	case GRUNT_OP_EQN:
+	case GRUNT_OP_NOTJMPIF:
+		return 2;
+	case GRUNT_OP_DUPEQN:
+	case GRUNT_OP_INPUTLTN:
+	case GRUNT_OP_INPUTGTN:
+		return 3;
+	default:
+		return 0;
+	}
+
+} /* grunt_pack_fused_length() */
+
+
+/* grunt_pack_decode()
+ *
+ * in:     p_packed - packed program
+ *         pc       - program counter of instruction to decode
+ * out:    p_i      - the unpacked instruction
+ * return: nothing
+ *
+ * Unpacks a single instruction for the checked engines.  Callers must
+ * ensure pc < p_packed->num_instructions.  A superinstruction unpacks
+ * to its superinstruction opcode with the argument of the first
+ * instruction in its sequence.
+ */
+
+void
+grunt_pack_decode(const grunt_packed_program_t *p_packed, grunt_pc_t pc,
+	grunt_instruction_t *p_i) {
+
+	grunt_packed_t w = p_packed->code[pc];
+	uint8 tag = GRUNT_PACKED_TAG(w);
+
+	p_i->op = GRUNT_PACKED_OP(w);
+
+	if (!pack_has_literal(p_i->op)) {
+		p_i->arg.rep = GRUNT_PACKED_OPERAND(w);
+		return;
+	}
+
+	p_i->arg.lit.type = (grunt_value_type_t)(tag & ~GRUNT_PACKED_POOLED);
+	switch (p_i->arg.lit.type) {
+	case gt_bool:
+		p_i->arg.lit.val.b = (GRUNT_PACKED_OPERAND(w) != 0);
+		break;
+	case gt_num:
+		p_i->arg.lit.val.num = ((tag & GRUNT_PACKED_POOLED) ?
+			p_packed->pool[GRUNT_PACKED_OPERAND(w)] :
+			GRUNT_PACKED_OPERAND(w));
+		break;
+	case gt_str:
+		p_i->arg.lit.val.str = GRUNT_PACKED_OPERAND(w);
+		break;
+	default:
+		p_i->arg.lit.val.pc = GRUNT_PACKED_OPERAND(w);
+		break;
+	}
+
+} /* grunt_pack_decode() */
+
+
+/* grunt_pack_type()
+ *
+ * in:     p_packed  - packed verified program
+ *         top_types - the verifier's type on top of the arg stack at
+ *                     each pc, and for each FORMAT, its values' types
+ * out:    p_packed  - each OUTPUT's tag set to the type it outputs,
+ *                     each FORMAT's to its values' types
+ * return: 0, or GRUNT_ERROR_INVALIDARGUMENT if an OUTPUT or FORMAT
+ *         the verifier reached takes different types on different
+ *         paths.
+ *
+ * The checked engines never read these tags, so unreachable OUTPUTs
+ * and FORMATs keep their 0s.
+ */
+
+int
+grunt_pack_type(grunt_packed_program_t *p_packed, const uint8 *top_types) {
+
+	grunt_packed_t *code = p_packed->code;
+	grunt_pc_t pc;
+
+	for (pc = 0; pc < p_packed->num_instructions; pc++) {
+		if (((GRUNT_PACKED_OP(code[pc]) != GRUNT_OP_OUTPUT) &&
+			(GRUNT_PACKED_OP(code[pc]) != GRUNT_OP_FORMAT)) ||
+			(top_types[pc] == GT_UNSEEN))
+			continue;
+		if ((top_types[pc] == GT_ANY) ||
+			((GRUNT_PACKED_OP(code[pc]) == GRUNT_OP_OUTPUT) &&
+			(top_types[pc] > gt_str)))
+			return GRUNT_ERROR_INVALIDARGUMENT;
+		code[pc] = GRUNT_PACKED_WORD(GRUNT_PACKED_OP(code[pc]),
+			top_types[pc], GRUNT_PACKED_OPERAND(code[pc]));
+	}
+	return 0;
+
+} /* grunt_pack_type() */
+
+
+/* GRUNT_Pack()
+ *
+ * in:     program          - Grunt program to pack
+ *         num_instructions - number of instructions in program
+ *         p_packed         - code[], pool[], and their capacities
+ * out:    p_packed         - holds the packed program
+ * return: CFE_SUCCESS, or GRUNT_ERROR_OUTOFBOUNDS if the program or
+ *         its 32-bit literals don't fit in p_packed's storage.
+ *
+ * Loads a program written with the macros in grunt.h into the packed
+ * encoding for GRUNT_RunPacked(), marking superinstructions.
+ */
+
+int32
+GRUNT_Pack(const grunt_instruction_t *program, grunt_pc_t num_instructions,
+	grunt_packed_program_t *p_packed) {
+
+	const grunt_instruction_t *p_i;
+	grunt_opcode_t op;
+	grunt_pc_t pc;
+	uint8 tag;
+	uint16 operand;
+	int status;
+
+	p_packed->num_instructions = 0;
+	p_packed->num_literals     = 0;
+
+	if (num_instructions > p_packed->max_instructions)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+
+	for (pc = 0; pc < num_instructions; pc++) {
+
+		p_i = &(program[pc]);
+
+		/* Opcodes past GRUNT_OP_SUB other than LOOKUP, SWITCH,
+		 * REPEAT, END, INPUTREC, INPUTZ, FORMAT, and CLASSIFY
+		 * are all invalid, and must not pack into superinstruction
+		 * opcodes; 0 is invalid too.
+		 */
+		op = (((p_i->op > GRUNT_OP_SUB) &&
+			(p_i->op != GRUNT_OP_LOOKUP) &&
+			(p_i->op != GRUNT_OP_SWITCH) &&
+			(p_i->op != GRUNT_OP_REPEAT) &&
+			(p_i->op != GRUNT_OP_END) &&
+			(p_i->op != GRUNT_OP_INPUTREC) &&
+			(p_i->op != GRUNT_OP_INPUTZ) &&
+			(p_i->op != GRUNT_OP_FORMAT) &&
+			(p_i->op != GRUNT_OP_CLASSIFY)) ? 0 : p_i->op);
+
+		if (pack_has_literal(op)) {
+			if ((status = pack_literal(&(p_i->arg.lit), p_packed,
+				&tag, &operand)))
+				return status;
+		} else {
+			tag = 0;
+			operand = p_i->arg.rep;
+		}
+
+		p_packed->code[pc] = GRUNT_PACKED_WORD(op, tag, operand);
+	}
+
+	p_packed->num_instructions = num_instructions;
+	pack_fuse(p_packed);
+	return CFE_SUCCESS;
+
+} /* GRUNT_Pack() */
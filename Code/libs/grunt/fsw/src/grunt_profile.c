@@ -0,0 +1,128 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module keeps the execution profile described in grunt.h for
+ * builds that define GRUNT_PROFILE.  The interpreter brackets each
+ * instruction it dispatches with grunt_profile_begin() and
+ * grunt_profile_end().  Reading the clock costs more than most Grunt
+ * instructions do, so only one instruction in every
+ * GRUNT_PROFILE_SAMPLE_PERIOD is timed; the rest are only counted.
+ * The sampled tick counts include the cost of one clock read.  The
+ * build compiles this module only when it defines GRUNT_PROFILE.
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>   /* for __rdtsc() */
+#define GRUNT_PROFILE_TSC
+#endif
+
+#include "cfe.h"
+#ifndef GRUNT_PROFILE_TSC
+#include "cfe_psp.h"     /* for CFE_PSP_Get_Timebase() */
+#endif
+
+#include "grunt.h"
+#include "grunt_profile.h"
+
+
+/* ------------------- module local functions -------------------- */
+
+/* profile_clock()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: low 32 bits of a free-running tick counter.
+ */
+
+static uint32
+profile_clock(void) {
+
+#ifdef GRUNT_PROFILE_TSC
+	return (uint32)__rdtsc();
+#else
+	uint32 upper, lower;
+
+	CFE_PSP_Get_Timebase(&upper, &lower);
+	return lower;
+#endif
+
+} /* profile_clock() */
+
+
+/* --------------- functions exported to the interpreter ---------- */
+
+/* grunt_profile_begin()
+ *
+ * in:     p_vm     - VM about to dispatch an instruction
+ * out:    *p_start - tick count at the start of the instruction, if
+ *                    it is one to time
+ * return: true if the instruction is one to time, else false.
+ */
+
+bool
+grunt_profile_begin(grunt_vm_t *p_vm, uint32 *p_start) {
+
+	grunt_profile_t *p_profile = &(p_vm->profile);
+
+	if (p_profile->countdown) {
+		p_profile->countdown--;
+		return false;
+	}
+	p_profile->countdown = GRUNT_PROFILE_SAMPLE_PERIOD - 1;
+	*p_start = profile_clock();
+	return true;
+
+} /* grunt_profile_begin() */
+
+
+/* grunt_profile_end()
+ *
+ * in:     p_vm  - VM that just dispatched an instruction
+ *         pc    - program counter of the instruction
+ *         op    - opcode of the instruction
+ *         timed - grunt_profile_begin()'s return for the instruction
+ *         start - grunt_profile_begin()'s *p_start for the instruction
+ * out:    p_vm->profile - updated to count the instruction
+ * return: nothing
+ *
+ * Counts the instruction whether or not it succeeded.  Superinstructions
+ * count once, under their own opcode, at the pc of their first word.
+ */
+
+void
+grunt_profile_end(grunt_vm_t *p_vm, grunt_pc_t pc, grunt_opcode_t op,
+	bool timed, uint32 start) {
+
+	grunt_profile_t *p_profile = &(p_vm->profile);
+	uint32 ticks;       /* ticks the instruction took, if timed */
+	unsigned int b;     /* histogram bucket */
+
+	if (timed) {
+		ticks = profile_clock() - start;  /* wraps correctly */
+		for (b = 0; (ticks >> (b + 1)) &&
+			(b < GRUNT_PROFILE_NUM_BUCKETS - 1); b++);
+		p_profile->histogram[b]++;
+		p_profile->samples++;
+		if (op < GRUNT_PROFILE_NUM_OPCODES) {
+			p_profile->op_samples[op]++;
+			p_profile->op_ticks[op] += ticks;
+		}
+	}
+
+	p_profile->instructions++;
+	if (op < GRUNT_PROFILE_NUM_OPCODES) p_profile->op_count[op]++;
+	if (pc < GRUNT_PROFILE_MAX_PC) p_profile->pc_count[pc]++;
+
+} /* grunt_profile_end() */
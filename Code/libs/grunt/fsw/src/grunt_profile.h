@@ -0,0 +1,23 @@
+#ifndef _GRUNT_PROFILE_H_
+#define _GRUNT_PROFILE_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+bool grunt_profile_begin(grunt_vm_t *, uint32 *);
+void grunt_profile_end(grunt_vm_t *, grunt_pc_t, grunt_opcode_t, bool,
+	uint32);
+
+#endif
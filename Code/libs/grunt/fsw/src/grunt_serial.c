@@ -0,0 +1,395 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module implements the serialized program format described in
+ * grunt.h, which carries a Grunt program and its string table in a
+ * few bytes per instruction so that the ground can uplink a new
+ * program to a running app.  GRUNT_Serialize() writes a program in
+ * the format, and GRUNT_Deserialize() reads one back into
+ * caller-supplied storage, checking the format as strictly as the
+ * writer produces it.  Neither verifies the program itself; a loader
+ * should pass what GRUNT_Deserialize() returns to GRUNT_Verify() and
+ * refuse it if it doesn't verify.
+ */
+
+#include <string.h>
+
+#include "cfe.h"
+
+#include "grunt_status.h"
+#include "grunt.h"
+
+
+/* ------------------- module local functions -------------------- */
+
+/* serial_literal_type()
+ *
+ * in:     op - opcode
+ * out:    nothing
+ * return: the type of the literal instructions with opcode op take,
+ *         or -1 if they take a repetition count or nothing.
+ */
+
+static int
+serial_literal_type(grunt_opcode_t op) {
+
+	switch (op) {
+	case GRUNT_OP_CALL:
+	case GRUNT_OP_JMPIF:
+		return gt_pc;
+	case GRUNT_OP_PUSHB:
+		return gt_bool;
+	case GRUNT_OP_PUSHN:
+		return gt_num;
+	case GRUNT_OP_PUSHS:
+		return gt_str;
+	default:
+		return -1;
+	}
+
+} /* serial_literal_type() */
+
+
+/* serial_crc32()
+ *
+ * in:     p_data - bytes to check
+ *         size   - number of bytes at p_data
+ * out:    nothing
+ * return: the CRC-32 of the bytes, as zlib and PNG compute it.
+ *
+ * Programs are small and loaded rarely, so a bitwise loop costs
+ * less than the kilobyte a lookup table would.
+ */
+
+static uint32
+serial_crc32(const uint8 *p_data, uint32 size) {
+
+	uint32 crc = 0xFFFFFFFF;
+	uint32 i;
+	int bit;
+
+	for (i = 0; i < size; i++) {
+		crc ^= p_data[i];
+		for (bit = 0; bit < 8; bit++)
+			crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+	}
+	return ~crc;
+
+} /* serial_crc32() */
+
+
+/* serial_put()
+ *
+ * in:     byte   - byte to write
+ *         buffer - where to write it
+ *         size   - capacity of buffer
+ *         p_used - bytes of buffer already written
+ * out:    buffer[*p_used] - byte, if there's room
+ *         *p_used         - one more, if there's room
+ * return: false if buffer is full, else true.
+ */
+
+static bool
+serial_put(uint8 byte, uint8 *buffer, uint32 size, uint32 *p_used) {
+
+	if (*p_used >= size) return false;
+	buffer[(*p_used)++] = byte;
+	return true;
+
+} /* serial_put() */
+
+
+/* serial_put_varint()
+ *
+ * in:     value  - number to write
+ *         buffer - where to write it
+ *         size   - capacity of buffer
+ *         p_used - bytes of buffer already written
+ * out:    buffer, *p_used - as serial_put()
+ * return: false if buffer is full, else true.
+ *
+ * Writes value 7 bits at a time, low bits first, setting the top bit
+ * of every byte but the last.
+ */
+
+static bool
+serial_put_varint(uint32 value, uint8 *buffer, uint32 size,
+	uint32 *p_used) {
+
+	while (value > 0x7F) {
+		if (!serial_put((uint8)(0x80 | (value & 0x7F)), buffer, size,
+			p_used))
+			return false;
+		value >>= 7;
+	}
+	return serial_put((uint8)value, buffer, size, p_used);
+
+} /* serial_put_varint() */
+
+
+/* serial_get_varint()
+ *
+ * in:     buffer - serialized program
+ *         end    - offset of its CRC, where reading must stop
+ *         p_pos  - offset of the varint to read
+ * out:    *p_value - the number read
+ *         *p_pos   - offset just past it
+ * return: false if the varint runs past end, is longer than it need
+ *         be, or doesn't fit in 32 bits, else true.
+ */
+
+static bool
+serial_get_varint(const uint8 *buffer, uint32 end, uint32 *p_pos,
+	uint32 *p_value) {
+
+	uint32 value = 0;
+	int shift;
+	uint8 byte;
+
+	for (shift = 0; shift < 35; shift += 7) {
+		if (*p_pos >= end) return false;
+		byte = buffer[(*p_pos)++];
+		if ((shift == 28) && (byte > 0x0F)) return false;
+		value |= (uint32)(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			/* The writer never ends with a needless 0 group. */
+			if ((shift > 0) && (byte == 0)) return false;
+			*p_value = value;
+			return true;
+		}
+	}
+	return false;
+
+} /* serial_get_varint() */
+
+
+/* ------------------- module exported functions ------------------- */
+
+/* GRUNT_Serialize()
+ *
+ * in:     program          - Grunt program to serialize
+ *         num_instructions - number of instructions in program
+ *         string_table     - program's string table
+ *         num_strings      - number of strings in string_table
+ *         buffer           - where to write the serialized program
+ *         size             - capacity of buffer in bytes
+ * out:    buffer           - holds the serialized program
+ *         *p_used          - its length in bytes
+ * return: CFE_SUCCESS, GRUNT_ERROR_INVALIDOPCODE if an opcode doesn't
+ *         fit in the format, GRUNT_ERROR_INVALIDLITERAL if a literal's
+ *         type isn't the one its opcode takes, or
+ *         GRUNT_ERROR_OUTOFBOUNDS if a string is longer than
+ *         GRUNT_REP_MAX or the program doesn't fit in buffer.
+ *
+ * Writes program and its string table in the serialized format
+ * described in grunt.h.  Every instruction GRUNT_Verify() might
+ * accept serializes; others may not.
+ */
+
+int32
+GRUNT_Serialize(const grunt_instruction_t *program,
+	grunt_pc_t num_instructions, const char *string_table[],
+	grunt_string_t num_strings, uint8 *buffer, uint32 size,
+	uint32 *p_used) {
+
+	const grunt_instruction_t *p_i;
+	uint32 used = 0;
+	uint32 value;
+	uint32 crc;
+	size_t length;
+	grunt_pc_t pc;
+	grunt_string_t s;
+	int type;
+
+	*p_used = 0;
+
+	if (size < GRUNT_SERIAL_HEADER_SIZE) return GRUNT_ERROR_OUTOFBOUNDS;
+	buffer[used++] = GRUNT_SERIAL_MAGIC0;
+	buffer[used++] = GRUNT_SERIAL_MAGIC1;
+	buffer[used++] = GRUNT_SERIAL_VERSION;
+	buffer[used++] = 0;
+	buffer[used++] = (uint8)(num_instructions >> 8);
+	buffer[used++] = (uint8)num_instructions;
+	buffer[used++] = (uint8)(num_strings >> 8);
+	buffer[used++] = (uint8)num_strings;
+
+	for (pc = 0; pc < num_instructions; pc++) {
+		p_i = &(program[pc]);
+		if (p_i->op > GRUNT_SERIAL_OP_MASK)
+			return GRUNT_ERROR_INVALIDOPCODE;
+
+		if (0 > (type = serial_literal_type(p_i->op))) {
+			value = p_i->arg.rep;
+		} else if (p_i->arg.lit.type != (grunt_value_type_t)type) {
+			return GRUNT_ERROR_INVALIDLITERAL;
+		} else if (type == gt_bool) {
+			value = (p_i->arg.lit.val.b ? 1 : 0);
+		} else if (type == gt_num) {
+			value = p_i->arg.lit.val.num;
+		} else if (type == gt_str) {
+			value = p_i->arg.lit.val.str;
+		} else {
+			value = p_i->arg.lit.val.pc;
+		}
+
+		if (!serial_put((uint8)(p_i->op |
+			(value ? GRUNT_SERIAL_OPERAND : 0)), buffer, size,
+			&used))
+			return GRUNT_ERROR_OUTOFBOUNDS;
+		if (value && !serial_put_varint(value, buffer, size, &used))
+			return GRUNT_ERROR_OUTOFBOUNDS;
+	}
+
+	for (s = 0; s < num_strings; s++) {
+		length = strlen(string_table[s]);
+		if ((length > GRUNT_REP_MAX) ||
+			!serial_put_varint((uint32)length, buffer, size,
+			&used) || (length > size - used))
+			return GRUNT_ERROR_OUTOFBOUNDS;
+		memcpy(&(buffer[used]), string_table[s], length);
+		used += (uint32)length;
+	}
+
+	if (size - used < GRUNT_SERIAL_CRC_SIZE)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	crc = serial_crc32(buffer, used);
+	buffer[used++] = (uint8)(crc >> 24);
+	buffer[used++] = (uint8)(crc >> 16);
+	buffer[used++] = (uint8)(crc >> 8);
+	buffer[used++] = (uint8)crc;
+
+	*p_used = used;
+	return CFE_SUCCESS;
+
+} /* GRUNT_Serialize() */
+
+
+/* GRUNT_Deserialize()
+ *
+ * in:     buffer    - serialized program
+ *         size      - its length in bytes
+ *         p_program - code[], strings[], string_lengths[],
+ *                     string_space[], and their capacities
+ * out:    p_program - holds the program and its string table
+ * return: CFE_SUCCESS, GRUNT_ERROR_BADSERIAL if buffer doesn't hold
+ *         exactly one well-formed serialized program whose CRC
+ *         matches, or GRUNT_ERROR_OUTOFBOUNDS if the program doesn't
+ *         fit in p_program's storage.
+ *
+ * Reads a program GRUNT_Serialize() wrote back into the form
+ * GRUNT_Verify() and GRUNT_Run() take.  Each string in string_space[]
+ * is NUL-terminated, and string_lengths[] holds the lengths
+ * GRUNT_SetStringLengths() wants.  On failure, p_program holds no
+ * program.
+ */
+
+int32
+GRUNT_Deserialize(const uint8 *buffer, uint32 size,
+	grunt_serial_program_t *p_program) {
+
+	grunt_instruction_t *p_i;
+	uint32 end;            /* offset of the CRC */
+	uint32 pos;            /* offset of the next byte to read */
+	uint32 space = 0;      /* bytes of string_space[] used */
+	uint32 value;
+	uint32 crc;
+	grunt_pc_t num_instructions;
+	grunt_string_t num_strings;
+	grunt_pc_t pc;
+	grunt_string_t s;
+	uint8 byte;
+	int type;
+
+	p_program->num_instructions = 0;
+	p_program->num_strings      = 0;
+
+	if ((size < GRUNT_SERIAL_HEADER_SIZE + GRUNT_SERIAL_CRC_SIZE) ||
+		(buffer[0] != GRUNT_SERIAL_MAGIC0) ||
+		(buffer[1] != GRUNT_SERIAL_MAGIC1) ||
+		(buffer[2] != GRUNT_SERIAL_VERSION) ||
+		(buffer[3] != 0))
+		return GRUNT_ERROR_BADSERIAL;
+
+	end = size - GRUNT_SERIAL_CRC_SIZE;
+	crc = ((uint32)buffer[end] << 24) | ((uint32)buffer[end + 1] << 16) |
+		((uint32)buffer[end + 2] << 8) | (uint32)buffer[end + 3];
+	if (crc != serial_crc32(buffer, end)) return GRUNT_ERROR_BADSERIAL;
+
+	num_instructions = (grunt_pc_t)((buffer[4] << 8) | buffer[5]);
+	num_strings      = (grunt_string_t)((buffer[6] << 8) | buffer[7]);
+	if ((num_instructions > p_program->max_instructions) ||
+		(num_strings > p_program->max_strings))
+		return GRUNT_ERROR_OUTOFBOUNDS;
+
+	pos = GRUNT_SERIAL_HEADER_SIZE;
+	for (pc = 0; pc < num_instructions; pc++) {
+		if (pos >= end) return GRUNT_ERROR_BADSERIAL;
+		byte  = buffer[pos++];
+		value = 0;
+		if (byte & GRUNT_SERIAL_RESERVED) return GRUNT_ERROR_BADSERIAL;
+		if ((byte & GRUNT_SERIAL_OPERAND) &&
+			(!serial_get_varint(buffer, end, &pos, &value) ||
+			(value == 0)))
+			return GRUNT_ERROR_BADSERIAL;
+
+		p_i = &(p_program->code[pc]);
+		memset(p_i, 0, sizeof(*p_i));
+		p_i->op = (grunt_opcode_t)(byte & GRUNT_SERIAL_OP_MASK);
+
+		type = serial_literal_type(p_i->op);
+		if ((type == gt_bool) ? (value > 1) :
+			((type != gt_num) && (value > UINT16_MAX)))
+			return GRUNT_ERROR_BADSERIAL;
+
+		if (type < 0) {
+			p_i->arg.rep = (grunt_rep_t)value;
+			continue;
+		}
+		p_i->arg.lit.type = (grunt_value_type_t)type;
+		if (type == gt_bool) {
+			p_i->arg.lit.val.b = (value != 0);
+		} else if (type == gt_num) {
+			p_i->arg.lit.val.num = value;
+		} else if (type == gt_str) {
+			p_i->arg.lit.val.str = (grunt_string_t)value;
+		} else {
+			p_i->arg.lit.val.pc = (grunt_pc_t)value;
+		}
+	}
+
+	for (s = 0; s < num_strings; s++) {
+		if (!serial_get_varint(buffer, end, &pos, &value) ||
+			(value > GRUNT_REP_MAX) || (value > end - pos))
+			return GRUNT_ERROR_BADSERIAL;
+		if (value >= p_program->max_string_space - space)
+			return GRUNT_ERROR_OUTOFBOUNDS;
+		if (memchr(&(buffer[pos]), '\0', value))
+			return GRUNT_ERROR_BADSERIAL;
+		memcpy(&(p_program->string_space[space]), &(buffer[pos]),
+			value);
+		p_program->string_space[space + value] = '\0';
+		p_program->strings[s] = &(p_program->string_space[space]);
+		p_program->string_lengths[s] = (grunt_rep_t)value;
+		space += value + 1;
+		pos   += value;
+	}
+
+	if (pos != end) return GRUNT_ERROR_BADSERIAL;
+
+	p_program->num_instructions = num_instructions;
+	p_program->num_strings      = num_strings;
+	return CFE_SUCCESS;
+
+} /* GRUNT_Deserialize() */
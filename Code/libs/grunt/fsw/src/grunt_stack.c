@@ -22,21 +22,21 @@
 /* The Grunt virtual machine has two stacks: an argument stack to
  * which we push/pop Boolean, number, and string arguments for Grunt
  * instructions, and a control stack where we push and pop return
- * address program counter values for call/return instructions.  The
+ * address program counter values for call/return instructions, and
+ * the body program counter and run count of each loop.  The
  * argument stack starts at stack array index 0 and grows up.  The
  * control stack starts at array index GRUNT_STACK_SIZE - 1 and grows
  * down.
  *
- * g_argument_count is the number of arguments on the argument stack.
- * g_control_count is the number of program counter values on the
- * control stack.
+ * argument_count is the number of arguments on the argument stack.
+ * control_count is the number of values on the control stack.
  *
  *              Argument Stack          Control Stack
- * empty stack: g_arugment_count == 0   g_control_count == 0
- * push         g_argument_count++;     g_control_count++;
- * pop          g_argument_count--;     g_control_count--;
- * topmost:     g_argument_count - 1    GRUNT_STACK_SIZE - 1 - g_control_count
- * full:        g_argument_count + g_control_count >= GRUNT_STACK_SIZE
+ * empty stack: argument_count == 0     control_count == 0
+ * push         argument_count++;       control_count++;
+ * pop          argument_count--;       control_count--;
+ * topmost:     argument_count - 1      GRUNT_STACK_SIZE - 1 - control_count
+ * full:        argument_count + control_count >= GRUNT_STACK_SIZE
  *
  * Note that, if we want to prohibit loops, it is important to keep
  * program counter values on a separate control stack that does not
@@ -44,47 +44,61 @@
  */
 
 
-/* The unit tests assume GRUNT_STACK_SIZE is an even number. */
-#define GRUNT_STACK_SIZE (2*16)      /* max number of elements on stack */
-static grunt_value_t g_stack[GRUNT_STACK_SIZE];       /* the two stacks */
-static int g_argument_count;     /* count of elements on argument stack */
-static int g_control_count;       /* count of elements on control stack */
+/* GRUNT_STACK_SIZE (max number of elements on stack) lives in grunt.h
+ * so that native code generated from Grunt programs can honor the
+ * same limit.  The stacks and their counts live in each grunt_vm_t.
+ *
+ * Each slot keeps its type in stack_type[] and its payload in
+ * stack_val[], rather than as a padded grunt_value_t, so a push or
+ * pop moves 5 bytes rather than 8 and DUP and ROLL move 5 bytes per
+ * element.  Every value the stacks hand back is a whole
+ * grunt_value_t.
+ */
+
+/* Types allowed on each stack.  No program counter values on the arg
+ * stack; only program counter values and loop counts on the control
+ * stack.
+ */
+#define ARG_TYPES (GRUNT_TYPE_BIT(gt_bool) | GRUNT_TYPE_BIT(gt_num) | \
+	GRUNT_TYPE_BIT(gt_str))
+#define CTL_TYPES (GRUNT_TYPE_BIT(gt_pc) | GRUNT_TYPE_BIT(gt_num))
 
 
 void
-grunt_stack_init(void) {
-	g_argument_count = 0;
-	g_control_count  = 0;
+grunt_stack_init(grunt_vm_t *p_vm) {
+	p_vm->argument_count = 0;
+	p_vm->control_count  = 0;
 } /* grunt_stack_init() */
 
 
 int
-grunt_stack_arg_push(const grunt_value_t *p_arg) {
+grunt_stack_arg_push(grunt_vm_t *p_vm, const grunt_value_t *p_arg) {
 
-	/* No program counter values allowed on the arg stack. */
-	if (!((p_arg->type == gt_bool)||(p_arg->type == gt_num)||
-		(p_arg->type == gt_str))) {
+	if (!(GRUNT_TYPE_BIT(p_arg->type) & ARG_TYPES))
 		return GRUNT_ERROR_INTERPRETERBUG;
-	}
 	
-	if ((g_argument_count + g_control_count + 1) > GRUNT_STACK_SIZE) {
+	if ((p_vm->argument_count + p_vm->control_count + 1) >
+		GRUNT_STACK_SIZE) {
 		return GRUNT_ERROR_OUTOFBOUNDS;
 	}
 	
-	memcpy(&(g_stack[g_argument_count]), p_arg, sizeof(grunt_value_t));
-	g_argument_count++;
+	p_vm->stack_type[p_vm->argument_count] = (uint8)p_arg->type;
+	p_vm->stack_val[p_vm->argument_count]  = p_arg->val;
+	p_vm->argument_count++;
 	return 0;  /* OK! */
 	
 } /* grunt_stack_arg_push() */
 
 
 int
-grunt_stack_arg_pop(grunt_value_t *p_arg) {
+grunt_stack_arg_pop(grunt_vm_t *p_vm, grunt_value_t *p_arg) {
 
-	if (g_argument_count == 0) return GRUNT_ERROR_OUTOFBOUNDS;
+	if (p_vm->argument_count == 0) return GRUNT_ERROR_OUTOFBOUNDS;
 
-	g_argument_count--;
-	memcpy(p_arg, &(g_stack[g_argument_count]), sizeof(grunt_value_t));
+	p_vm->argument_count--;
+	p_arg->type =
+		(grunt_value_type_t)p_vm->stack_type[p_vm->argument_count];
+	p_arg->val  = p_vm->stack_val[p_vm->argument_count];
 	return 0;  /* OK! */
 	
 } /* grunt_stack_arg_pop() */
@@ -92,9 +106,11 @@ grunt_stack_arg_pop(grunt_value_t *p_arg) {
 
 /* grunt_stack_arg_dup()
  *
- * in:     n       - number of elements to duplicate
- * out:    g_stack - top n arg stack elements duplicated
- *         g_argument_count - incremented by n
+ * in:     p_vm    - VM whose arg stack to operate on
+ *         n       - number of elements to duplicate
+ * out:    p_vm->stack_type, stack_val - top n arg stack elements
+ *                 duplicated
+ *         p_vm->argument_count - incremented by n
  * return: value     condition
  *         -----     -------------------
  *         GRUNT_ERROR_INTERPRETERBUG - n == 0; you can't dup nothing
@@ -109,19 +125,23 @@ grunt_stack_arg_pop(grunt_value_t *p_arg) {
  */
 
 int
-grunt_stack_arg_dup(grunt_rep_t n) {
+grunt_stack_arg_dup(grunt_vm_t *p_vm, grunt_rep_t n) {
 
 	if (n == 0) return GRUNT_ERROR_INTERPRETERBUG;
 
-	if (g_argument_count < n) return GRUNT_ERROR_OUTOFBOUNDS;
+	if (p_vm->argument_count < n) return GRUNT_ERROR_OUTOFBOUNDS;
 	
-	if ((g_argument_count + g_control_count + n) > GRUNT_STACK_SIZE) {
+	if ((p_vm->argument_count + p_vm->control_count + n) >
+		GRUNT_STACK_SIZE) {
 		return GRUNT_ERROR_OUTOFBOUNDS;
 	}
 	
-	memcpy(&(g_stack[g_argument_count]), &(g_stack[g_argument_count - n]),
-	       (n * sizeof(grunt_value_t)));
-	g_argument_count += n;
+	memcpy(&(p_vm->stack_type[p_vm->argument_count]),
+	       &(p_vm->stack_type[p_vm->argument_count - n]), n);
+	memcpy(&(p_vm->stack_val[p_vm->argument_count]),
+	       &(p_vm->stack_val[p_vm->argument_count - n]),
+	       (n * sizeof(grunt_payload_t)));
+	p_vm->argument_count += n;
 	return 0;  /* OK! */
 	
 } /* grunt_stack_arg_dup() */
@@ -129,8 +149,10 @@ grunt_stack_arg_dup(grunt_rep_t n) {
 
 /* grunt_stack_arg_roll()
  *
- * in:     n       - number of elements to  roll topward
- * out:    g_stack - top n arg stack elements rolled topward by one
+ * in:     p_vm    - VM whose arg stack to operate on
+ *         n       - number of elements to  roll topward
+ * out:    p_vm->stack_type, stack_val - top n arg stack elements
+ *                 rolled topward by one
  * return: value                       condition
  *         ----------                  ---------------
  *         GRUNT_ERROR_INTERPRETERBUG  n < 2; you can't roll 0 or 1 elements
@@ -144,19 +166,26 @@ grunt_stack_arg_dup(grunt_rep_t n) {
  */
 
 int
-grunt_stack_arg_roll(grunt_rep_t n) {
+grunt_stack_arg_roll(grunt_vm_t *p_vm, grunt_rep_t n) {
 
-	grunt_value_t temp;  /* bounce topmost stack element through here */
+	uint8 temp_type;        /* bounce topmost stack element ...     */
+	grunt_payload_t temp;   /* ...through these                     */
+	int bottom;             /* index of bottommost element to roll  */
 
 	if (n < 2) return GRUNT_ERROR_INTERPRETERBUG;
 
-	if (g_argument_count < n) return GRUNT_ERROR_OUTOFBOUNDS;
+	if (p_vm->argument_count < n) return GRUNT_ERROR_OUTOFBOUNDS;
 
-	memcpy(&temp, &(g_stack[g_argument_count - 1]), sizeof(grunt_value_t));
-	memcpy(&(g_stack[g_argument_count - n + 1]),
-	       &(g_stack[g_argument_count - n]),
-	       ((n - 1) * sizeof(grunt_value_t)));
-	memcpy(&(g_stack[g_argument_count - n]), &temp, sizeof(grunt_value_t));
+	bottom = p_vm->argument_count - n;
+	temp_type = p_vm->stack_type[p_vm->argument_count - 1];
+	temp      = p_vm->stack_val[p_vm->argument_count - 1];
+	memmove(&(p_vm->stack_type[bottom + 1]),
+		&(p_vm->stack_type[bottom]), (n - 1));
+	memmove(&(p_vm->stack_val[bottom + 1]),
+		&(p_vm->stack_val[bottom]),
+		((n - 1) * sizeof(grunt_payload_t)));
+	p_vm->stack_type[bottom] = temp_type;
+	p_vm->stack_val[bottom]  = temp;
 
 	return 0;  /* OK! */
 	
@@ -164,31 +193,38 @@ grunt_stack_arg_roll(grunt_rep_t n) {
 
 
 int
-grunt_stack_ctl_push(const grunt_value_t *p_arg) {
+grunt_stack_ctl_push(grunt_vm_t *p_vm, const grunt_value_t *p_arg) {
+
+	int top;  /* index of the new topmost control stack element */
 
-	/* Only program counter values allowed on the control stack. */
-	if (!(p_arg->type == gt_pc)) return GRUNT_ERROR_INTERPRETERBUG;
+	if (!(GRUNT_TYPE_BIT(p_arg->type) & CTL_TYPES))
+		return GRUNT_ERROR_INTERPRETERBUG;
 
-	if ((g_argument_count + g_control_count + 1) > GRUNT_STACK_SIZE) {
+	if ((p_vm->argument_count + p_vm->control_count + 1) >
+		GRUNT_STACK_SIZE) {
 		return GRUNT_ERROR_OUTOFBOUNDS;
 	}
 	
-	memcpy(&(g_stack[((GRUNT_STACK_SIZE - 1) - g_control_count)]), p_arg,
-	       sizeof(grunt_value_t));
-	g_control_count++;
+	top = (GRUNT_STACK_SIZE - 1) - p_vm->control_count;
+	p_vm->stack_type[top] = (uint8)p_arg->type;
+	p_vm->stack_val[top]  = p_arg->val;
+	p_vm->control_count++;
 	return 0;  /* OK! */
 	
 } /* grunt_stack_ctl_push() */
 
 
 int
-grunt_stack_ctl_pop(grunt_value_t *p_arg) {
+grunt_stack_ctl_pop(grunt_vm_t *p_vm, grunt_value_t *p_arg) {
+
+	int top;  /* index of the topmost control stack element */
 
-	if (g_control_count == 0) return GRUNT_ERROR_OUTOFBOUNDS;
+	if (p_vm->control_count == 0) return GRUNT_ERROR_OUTOFBOUNDS;
 
-	g_control_count--;
-	memcpy(p_arg, &(g_stack[((GRUNT_STACK_SIZE - 1) - g_control_count)]),
-		sizeof(grunt_value_t));
+	p_vm->control_count--;
+	top = (GRUNT_STACK_SIZE - 1) - p_vm->control_count;
+	p_arg->type = (grunt_value_type_t)p_vm->stack_type[top];
+	p_arg->val  = p_vm->stack_val[top];
 	return 0;  /* OK! */
 	
 } /* grunt_stack_ctl_pop() */
@@ -16,13 +16,13 @@
  * permissions and limitations under the License.
  */
 
-void grunt_stack_init(void);
-int  grunt_stack_arg_push(const grunt_value_t *);
-int  grunt_stack_arg_pop(grunt_value_t *);
-int  grunt_stack_arg_dup(grunt_rep_t);
-int  grunt_stack_arg_roll(grunt_rep_t);
+void grunt_stack_init(grunt_vm_t *);
+int  grunt_stack_arg_push(grunt_vm_t *, const grunt_value_t *);
+int  grunt_stack_arg_pop(grunt_vm_t *, grunt_value_t *);
+int  grunt_stack_arg_dup(grunt_vm_t *, grunt_rep_t);
+int  grunt_stack_arg_roll(grunt_vm_t *, grunt_rep_t);
 
-int  grunt_stack_ctl_push(const grunt_value_t *);
-int  grunt_stack_ctl_pop(grunt_value_t *);
+int  grunt_stack_ctl_push(grunt_vm_t *, const grunt_value_t *);
+int  grunt_stack_ctl_pop(grunt_vm_t *, grunt_value_t *);
 
 #endif
@@ -0,0 +1,99 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module keeps the execution trace described in grunt.h for
+ * builds that define GRUNT_TRACE.  The interpreter calls
+ * grunt_trace_step() before each instruction it dispatches and
+ * grunt_trace_end() when each run stops.  Each call writes one ring
+ * slot and reads no clock, so tracing costs a few stores per
+ * instruction.  The build compiles this module only when it defines
+ * GRUNT_TRACE.
+ */
+
+#include "cfe.h"
+
+#include "grunt.h"
+#include "grunt_trace.h"
+
+
+/* --------------- functions exported to the interpreter ---------- */
+
+/* grunt_trace_step()
+ *
+ * in:     p_vm - VM about to dispatch an instruction
+ *         pc   - program counter of the instruction
+ *         op   - opcode of the instruction
+ * out:    p_vm->trace - the step recorded in its next slot
+ * return: nothing
+ *
+ * Superinstructions record one step, under their own opcode, at the
+ * pc of their first word.
+ */
+
+void
+grunt_trace_step(grunt_vm_t *p_vm, grunt_pc_t pc, grunt_opcode_t op) {
+
+	grunt_trace_t *p_trace = &(p_vm->trace);
+	grunt_trace_step_t *p_step =
+		&(p_trace->ring[p_trace->steps++ & (GRUNT_TRACE_SIZE - 1)]);
+	int top = p_vm->argument_count - 1;  /* arg stack's top slot */
+
+	p_step->pc = pc;
+	p_step->op = (uint8)op;
+	if (top < 0) {
+		p_step->type = GRUNT_TRACE_EMPTY;
+		p_step->top  = 0;
+		return;
+	}
+
+	p_step->type = p_vm->stack_type[top];
+	switch (p_step->type) {
+	case gt_bool:
+		p_step->top = p_vm->stack_val[top].b;
+		break;
+	case gt_str:
+		p_step->top = p_vm->stack_val[top].str;
+		break;
+	default:
+		p_step->top = p_vm->stack_val[top].num;
+		break;
+	}
+
+} /* grunt_trace_step() */
+
+
+/* grunt_trace_end()
+ *
+ * in:     p_vm   - VM whose run just stopped
+ *         pc     - program counter of the last instruction fetched
+ *         status - the run's GRUNT_HALT_* or GRUNT_ERROR_* status
+ * out:    p_vm->trace - a GRUNT_TRACE_END step recorded in its next
+ *                       slot
+ * return: nothing
+ */
+
+void
+grunt_trace_end(grunt_vm_t *p_vm, grunt_pc_t pc, int status) {
+
+	grunt_trace_t *p_trace = &(p_vm->trace);
+	grunt_trace_step_t *p_step =
+		&(p_trace->ring[p_trace->steps++ & (GRUNT_TRACE_SIZE - 1)]);
+
+	p_step->pc   = pc;
+	p_step->op   = 0;
+	p_step->type = GRUNT_TRACE_END;
+	p_step->top  = (uint32)status;
+
+} /* grunt_trace_end() */
@@ -0,0 +1,773 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module implements the Grunt program verifier.  The verifier
+ * performs an abstract interpretation of a Grunt program: rather than
+ * running it on real values, it runs it on the *types* of the values
+ * on the arg stack, following both the taken and not-taken paths of
+ * every JMPIF.  It analyzes each CALL target separately for each CALL
+ * that reaches it, so it knows exactly what the arg stack looks like
+ * below the callee's arguments and how deep the control stack is.  It
+ * analyzes each loop body as a routine of its own, over and over
+ * until the types the body leaves at its END stop changing.
+ *
+ * None of the following properties depend on the input data, so the
+ * verifier can prove them once for every possible run:
+ *
+ *   - every instruction on every path has a valid opcode and literal,
+ *   - every CALL and JMPIF target is forward and within the program,
+ *   - every LOOKUP's and SWITCH's table is well-formed and within the
+ *     program,
+ *   - every REPEAT has a matching END, every END reached closes the
+ *     innermost loop, no jump enters or leaves a loop body, and no
+ *     loop body RETURNs or changes the depth of the arg stack,
+ *   - every instruction finds enough arguments of the right types on
+ *     the arg stack,
+ *   - the arg and control stacks never exceed GRUNT_STACK_SIZE,
+ *   - every string the program pushes, by PUSHS or as a CLASSIFY
+ *     name, is in its string table, and
+ *   - every path ends in a HALT with a Boolean on the arg stack.
+ *
+ * The interpreter can skip its run-time checks for these properties
+ * when it runs a verified program.  It must still check properties
+ * that depend on the input data: input queue bounds, arithmetic
+ * over/underflow, and output queue overflow.  It must also check that
+ * each FORMAT's template has as many placeholders as FORMAT has
+ * values, since the verifier sees only the number of strings, not
+ * their text.
+ */
+
+#include "cfe.h"
+
+#include "grunt_status.h"
+#include "grunt.h"
+#include "grunt_input.h"
+#include "grunt_verify.h"
+#include "vs_parmclass.h"
+
+/* Abstract value types.  The verifier uses the gt_bool, gt_num, and
+ * gt_str types from grunt.h plus GT_ANY from grunt_verify.h, which
+ * describes a stack element that may have different types on
+ * different paths.
+ */
+
+/* The abstract state of the arg stack: its depth and the types of
+ * its elements, bottom first.
+ */
+typedef struct {
+	uint8 depth;
+	uint8 types[GRUNT_STACK_SIZE];
+} grunt_verify_state_t;
+
+/* States waiting for the verifier to reach the target of a JMPIF.
+ * Each routine being analyzed uses the entries above the ones its
+ * callers are using.
+ */
+#define GRUNT_VERIFY_MAX_PENDING 64
+static struct {
+	grunt_pc_t           target;
+	grunt_verify_state_t state;
+} g_pending[GRUNT_VERIFY_MAX_PENDING];
+static int g_pending_count;
+
+/* Analyzing a routine separately for each CALL that reaches it could
+ * take time exponential in the nesting depth of a pathological
+ * program.  The verifier gives up after this many steps.
+ */
+#define GRUNT_VERIFY_MAX_STEPS 65536
+static uint32 g_steps;
+
+static const grunt_instruction_t *g_program;   /* program to verify */
+static grunt_pc_t     g_num_instructions;      /* its length */
+static grunt_string_t g_num_strings;           /* its string count */
+static grunt_pc_t     g_error_pc;              /* pc of first problem */
+static uint8         *g_top_types;             /* top type at each pc */
+
+
+/* ------------------- module local functions -------------------- */
+
+/* verify_merge()
+ *
+ * in:     p_into - state to merge into
+ *         p_from - state to merge
+ * out:    p_into - types that differ between the two become GT_ANY
+ * return: GRUNT_ERROR_OUTOFBOUNDS if the stack depths differ, else 0.
+ *
+ * Merges the states of two paths that join at the same instruction.
+ */
+
+static int
+verify_merge(grunt_verify_state_t *p_into, const grunt_verify_state_t *p_from) {
+
+	int i;
+
+	if (p_into->depth != p_from->depth) return GRUNT_ERROR_OUTOFBOUNDS;
+
+	for (i = 0; i < p_into->depth; i++) {
+		if (p_into->types[i] != p_from->types[i])
+			p_into->types[i] = GT_ANY;
+	}
+
+	return 0;  /* OK! */
+
+} /* verify_merge() */
+
+
+/* verify_pop()
+ *
+ * in:     p_s  - abstract arg stack
+ *         n    - number of elements to pop
+ *         type - type the elements must have, or GT_ANY for any type
+ * out:    p_s  - n elements removed
+ * return: value        condition
+ *         ------       ---------------
+ *         GRUNT_ERROR_OUTOFBOUNDS     - fewer than n elements
+ *         GRUNT_ERROR_INVALIDARGUMENT - an element has the wrong type
+ *         0                           - success
+ */
+
+static int
+verify_pop(grunt_verify_state_t *p_s, grunt_rep_t n, uint8 type) {
+
+	grunt_rep_t i;
+
+	if (p_s->depth < n) return GRUNT_ERROR_OUTOFBOUNDS;
+
+	for (i = 0; i < n; i++) {
+		p_s->depth--;
+		if ((type != GT_ANY) && (p_s->types[p_s->depth] != type))
+			return GRUNT_ERROR_INVALIDARGUMENT;
+	}
+
+	return 0;  /* OK! */
+
+} /* verify_pop() */
+
+
+/* verify_push()
+ *
+ * in:     p_s       - abstract arg stack
+ *         ctl_depth - depth of the control stack
+ *         type      - type of element to push
+ * out:    p_s       - element added
+ * return: GRUNT_ERROR_OUTOFBOUNDS if the stacks are full, else 0.
+ */
+
+static int
+verify_push(grunt_verify_state_t *p_s, int ctl_depth, uint8 type) {
+
+	if ((p_s->depth + ctl_depth + 1) > GRUNT_STACK_SIZE)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+
+	p_s->types[p_s->depth++] = type;
+	return 0;  /* OK! */
+
+} /* verify_push() */
+
+
+/* verify_format_types()
+ *
+ * in:     p_s - abstract arg stack before a FORMAT
+ *         n   - number of values the FORMAT pops below its template
+ * out:    nothing
+ * return: the types of the values, the first value's in the low 2
+ *         bits (see GRUNT_VERIFY_FORMAT_TYPE()), or GT_ANY if any of
+ *         them may differ between paths or the stack is too shallow.
+ */
+
+static uint8
+verify_format_types(const grunt_verify_state_t *p_s, grunt_rep_t n) {
+
+	uint8 types = 0, type;
+	grunt_rep_t k;
+
+	if ((n > GRUNT_FORMAT_MAX_VALUES) || (p_s->depth < n + 1))
+		return GT_ANY;
+
+	for (k = 0; k < n; k++) {
+		type = p_s->types[p_s->depth - 2 - k];
+		if (type > gt_str) return GT_ANY;
+		types |= (uint8)(type << (2 * k));
+	}
+	return types;
+
+} /* verify_format_types() */
+
+
+/* verify_table()
+ *
+ * in:     pc   - pc of a LOOKUP
+ *         reps - its number of key/string pairs
+ * out:    nothing
+ * return: 0 if the LOOKUP's table is well-formed and the instruction
+ *         after it is within the program, else a GRUNT_ERROR_* code.
+ */
+
+static int
+verify_table(grunt_pc_t pc, grunt_rep_t reps) {
+
+	const grunt_instruction_t *p_e;
+	uint32 last = 2 * (uint32)reps;  /* index of default string */
+	uint32 i;
+
+	if (reps < 1) return GRUNT_ERROR_INVALIDLITERAL;
+	if (!((pc + last + 2) < g_num_instructions))
+		return GRUNT_ERROR_NOPROGRAM;
+
+	for (i = 0; i <= last; i++) {
+		p_e = &(g_program[pc + 1 + i]);
+		if ((i & 1) || (i == last)) {
+			if ((p_e->op != GRUNT_OP_PUSHS) ||
+				(p_e->arg.lit.type != gt_str) ||
+				!(p_e->arg.lit.val.str < g_num_strings))
+				return GRUNT_ERROR_INVALIDLITERAL;
+		} else if ((p_e->op != GRUNT_OP_PUSHN) ||
+			(p_e->arg.lit.type != gt_num)) {
+			return GRUNT_ERROR_INVALIDLITERAL;
+		}
+	}
+
+	return 0;  /* OK! */
+
+} /* verify_table() */
+
+
+/* verify_switch()
+ *
+ * in:     pc   - pc of a SWITCH
+ *         reps - its number of entries
+ * out:    nothing
+ * return: 0 if the SWITCH's table is well-formed and its targets and
+ *         the instruction after it are within the program, else a
+ *         GRUNT_ERROR_* code.
+ */
+
+static int
+verify_switch(grunt_pc_t pc, grunt_rep_t reps) {
+
+	const grunt_instruction_t *p_e;
+	uint32 entry;  /* pc of current entry */
+	uint32 i;
+
+	if (reps < 1) return GRUNT_ERROR_INVALIDLITERAL;
+	if (!((pc + (uint32)reps + 1) < g_num_instructions))
+		return GRUNT_ERROR_NOPROGRAM;
+
+	for (i = 0; i < reps; i++) {
+		entry = pc + 1 + i;
+		p_e = &(g_program[entry]);
+		if ((p_e->op != GRUNT_OP_JMPIF) ||
+			(p_e->arg.lit.type != gt_pc) ||
+			(p_e->arg.lit.val.pc < 1))
+			return GRUNT_ERROR_INVALIDLITERAL;
+		if (!((entry + p_e->arg.lit.val.pc) < g_num_instructions))
+			return GRUNT_ERROR_NOPROGRAM;
+	}
+
+	return 0;  /* OK! */
+
+} /* verify_switch() */
+
+
+static int verify_routine(grunt_pc_t, int, grunt_pc_t,
+	grunt_verify_state_t *, bool *);
+
+/* verify_loop()
+ *
+ * in:     pc        - pc of a REPEAT
+ *         ctl_depth - depth of the control stack at the REPEAT
+ *         p_state   - abstract arg stack at the REPEAT
+ * out:    p_state   - abstract arg stack after the loop, if *p_ends
+ *         p_end     - pc of the loop's END
+ *         p_ends    - true if some path through the body reaches END
+ * return: 0 if the loop verifies, else a GRUNT_ERROR_* code.
+ *
+ * Verifies the body starting from the merge of the states at the
+ * REPEAT and at the END, until that merge stops changing.  Types only
+ * ever change to GT_ANY, so this takes at most one pass per slot.
+ */
+
+static int
+verify_loop(grunt_pc_t pc, int ctl_depth, grunt_verify_state_t *p_state,
+	grunt_pc_t *p_end, bool *p_ends) {
+
+	grunt_verify_state_t body;   /* state at the END */
+	int i;
+	int status;
+
+	if (g_program[pc].arg.rep < 1) return GRUNT_ERROR_INVALIDLITERAL;
+	if ((p_state->depth + ctl_depth + 2) > GRUNT_STACK_SIZE)
+		return GRUNT_ERROR_OUTOFBOUNDS;
+	if (!(*p_end = grunt_verify_loop_end(g_program, g_num_instructions,
+		pc)))
+		return GRUNT_ERROR_NOPROGRAM;
+
+	/* JMPIFs waiting to land inside the body would enter it. */
+	for (i = 0; i < g_pending_count; i++) {
+		if ((g_pending[i].target > pc) &&
+			(g_pending[i].target <= *p_end))
+			return GRUNT_ERROR_INVALIDLITERAL;
+	}
+
+	for (;;) {
+		memcpy(&body, p_state, sizeof(body));
+		if ((status = verify_routine(pc + 1, ctl_depth + 2, *p_end,
+			&body, p_ends)))
+			return status;
+		g_error_pc = pc;
+		if (!*p_ends) return 0;  /* every path HALTs */
+		if (body.depth != p_state->depth)
+			return GRUNT_ERROR_OUTOFBOUNDS;
+		if (!memcmp(body.types, p_state->types, body.depth))
+			return 0;  /* OK! */
+		verify_merge(p_state, &body);
+	}
+
+} /* verify_loop() */
+
+
+/* verify_routine()
+ *
+ * in:     entry     - pc of first instruction of routine
+ *         ctl_depth - depth of the control stack on entry
+ *         loop_end  - if the routine is a loop body, the pc of its
+ *                     END, else 0
+ *         p_state   - abstract arg stack on entry
+ * out:    p_state   - abstract arg stack on RETURN, or at loop_end,
+ *                     if *p_returns
+ *         p_returns - true if some path through the routine RETURNs,
+ *                     or reaches loop_end
+ * return: 0 if the routine verifies, else a GRUNT_ERROR_* code.
+ *
+ * Verifies every path through the routine starting at entry.  Paths
+ * that CALL other routines continue after the CALL with the callee's
+ * RETURN state, and paths that reach a REPEAT continue after its END
+ * with the state verify_loop() finds there.  Paths end at HALT or
+ * RETURN, or in a loop body at its END; paths that end in RETURN
+ * must all agree on the depth of the arg stack they return.
+ */
+
+static int
+verify_routine(grunt_pc_t entry, int ctl_depth, grunt_pc_t loop_end,
+	grunt_verify_state_t *p_state, bool *p_returns) {
+
+	const grunt_instruction_t *p_i;
+	grunt_verify_state_t cur;      /* state at current pc */
+	grunt_verify_state_t ret;      /* merged state at RETURNs */
+	bool live = true;              /* is current pc reachable? */
+	bool callee_returns;
+	int pending_base = g_pending_count;
+	grunt_pc_t pc, end;
+	grunt_rep_t lit;
+	uint8 type;
+	int i;
+	int status;
+
+	memcpy(&cur, p_state, sizeof(cur));
+	ret.depth = 0;
+	*p_returns = false;
+
+	for (pc = entry; pc < g_num_instructions; pc++) {
+
+		/* Merge in the states of JMPIFs that land here. */
+		for (i = pending_base; i < g_pending_count; i++) {
+			if (g_pending[i].target != pc) continue;
+			if (live) {
+				if ((status = verify_merge(&cur,
+					&(g_pending[i].state)))) {
+					g_error_pc = pc;
+					return status;
+				}
+			} else {
+				memcpy(&cur, &(g_pending[i].state), sizeof(cur));
+				live = true;
+			}
+			g_pending[i--] = g_pending[--g_pending_count];
+		}
+
+		if (!live) {
+			if (g_pending_count == pending_base) break;  /* done */
+			continue;   /* unreachable in this context */
+		}
+
+		if (++g_steps > GRUNT_VERIFY_MAX_STEPS) {
+			g_error_pc = pc;
+			return GRUNT_ERROR_OUTOFBOUNDS;
+		}
+
+		g_error_pc = pc;  /* blame this instruction for any error */
+		p_i = &(g_program[pc]);
+		status = 0;
+
+		/* Record the type on top of the arg stack here, or for a
+		 * FORMAT, the types of its values.
+		 */
+		if (g_top_types) {
+			if (p_i->op == GRUNT_OP_FORMAT)
+				type = verify_format_types(&cur, p_i->arg.rep);
+			else
+				type = (cur.depth ? cur.types[cur.depth - 1] :
+					GT_ANY);
+			if (g_top_types[pc] == GT_UNSEEN)
+				g_top_types[pc] = type;
+			else if (g_top_types[pc] != type)
+				g_top_types[pc] = GT_ANY;
+		}
+
+		/* A loop body's paths all end at its END.  No END is at
+		 * pc 0, so 0 can mean no loop.
+		 */
+		if (loop_end && (pc == loop_end)) {
+			memcpy(&ret, &cur, sizeof(ret));
+			*p_returns = true;
+			live = false;
+			break;
+		}
+
+		switch (p_i->op) {
+		case GRUNT_OP_ADD:
+		case GRUNT_OP_SUB:
+			if (!(status = verify_pop(&cur, 2, gt_num)))
+				status = verify_push(&cur, ctl_depth, gt_num);
+			break;
+		case GRUNT_OP_AND:
+		case GRUNT_OP_OR:
+			if (p_i->arg.rep < 2) return GRUNT_ERROR_INVALIDLITERAL;
+			if (!(status = verify_pop(&cur, p_i->arg.rep, gt_bool)))
+				status = verify_push(&cur, ctl_depth, gt_bool);
+			break;
+		case GRUNT_OP_EQ:
+			if (p_i->arg.rep < 2) return GRUNT_ERROR_INVALIDLITERAL;
+			if (!(status = verify_pop(&cur, p_i->arg.rep, gt_num)))
+				status = verify_push(&cur, ctl_depth, gt_bool);
+			break;
+		case GRUNT_OP_GT:
+		case GRUNT_OP_LT:
+			if (!(status = verify_pop(&cur, 2, gt_num)))
+				status = verify_push(&cur, ctl_depth, gt_bool);
+			break;
+		case GRUNT_OP_NOT:
+			if (!(status = verify_pop(&cur, 1, gt_bool)))
+				status = verify_push(&cur, ctl_depth, gt_bool);
+			break;
+		case GRUNT_OP_DUP:
+			lit = p_i->arg.rep;
+			if (lit < 1) return GRUNT_ERROR_INVALIDLITERAL;
+			if ((cur.depth < lit) ||
+				((cur.depth + ctl_depth + lit) > GRUNT_STACK_SIZE))
+				return GRUNT_ERROR_OUTOFBOUNDS;
+			memcpy(&(cur.types[cur.depth]),
+				&(cur.types[cur.depth - lit]), lit);
+			cur.depth += lit;
+			break;
+		case GRUNT_OP_POP:
+			if (p_i->arg.rep < 1) return GRUNT_ERROR_INVALIDLITERAL;
+			status = verify_pop(&cur, p_i->arg.rep, GT_ANY);
+			break;
+		case GRUNT_OP_ROLL:
+			lit = p_i->arg.rep;
+			if (lit < 2) return GRUNT_ERROR_INVALIDLITERAL;
+			if (cur.depth < lit) return GRUNT_ERROR_OUTOFBOUNDS;
+			{
+				uint8 top = cur.types[cur.depth - 1];
+				memmove(&(cur.types[cur.depth - lit + 1]),
+					&(cur.types[cur.depth - lit]), lit - 1);
+				cur.types[cur.depth - lit] = top;
+			}
+			break;
+		case GRUNT_OP_PUSHB:
+			if (p_i->arg.lit.type != gt_bool)
+				return GRUNT_ERROR_INVALIDLITERAL;
+			status = verify_push(&cur, ctl_depth, gt_bool);
+			break;
+		case GRUNT_OP_PUSHN:
+			if (p_i->arg.lit.type != gt_num)
+				return GRUNT_ERROR_INVALIDLITERAL;
+			status = verify_push(&cur, ctl_depth, gt_num);
+			break;
+		case GRUNT_OP_PUSHS:
+			/* The interpreter doesn't check string indices
+			 * until OUTPUT, but we insist that every string
+			 * on the stack be valid.
+			 */
+			if ((p_i->arg.lit.type != gt_str) ||
+				!(p_i->arg.lit.val.str < g_num_strings))
+				return GRUNT_ERROR_INVALIDLITERAL;
+			status = verify_push(&cur, ctl_depth, gt_str);
+			break;
+		case GRUNT_OP_INPUT:
+			lit = p_i->arg.rep;
+			if ((lit != 4) && (lit != 2) && (lit != 1))
+				return GRUNT_ERROR_INVALIDLITERAL;
+			status = verify_push(&cur, ctl_depth, gt_num);
+			break;
+		case GRUNT_OP_INPUTREC:
+			{
+				grunt_rep_t size;
+				int fields = grunt_input_fields(p_i->arg.rep,
+					&size);
+				if (!fields) return GRUNT_ERROR_INVALIDLITERAL;
+				while (fields-- && !status)
+					status = verify_push(&cur, ctl_depth,
+						gt_num);
+			}
+			break;
+		case GRUNT_OP_INPUTZ:
+			if (p_i->arg.rep < 1) return GRUNT_ERROR_INVALIDLITERAL;
+			status = verify_push(&cur, ctl_depth, gt_bool);
+			break;
+		case GRUNT_OP_REWIND:
+			break;  /* input bounds are checked at run time */
+		case GRUNT_OP_OUTPUT:
+			/* Arg stack elements are never gt_pc values,
+			 * so OUTPUT can output any of them.
+			 */
+			status = verify_pop(&cur, 1, GT_ANY);
+			break;
+		case GRUNT_OP_FORMAT:
+			/* Any value can fill a placeholder, as with OUTPUT. */
+			if (p_i->arg.rep > GRUNT_FORMAT_MAX_VALUES)
+				return GRUNT_ERROR_INVALIDLITERAL;
+			if ((status = verify_pop(&cur, 1, gt_str))) break;
+			status = verify_pop(&cur, p_i->arg.rep, GT_ANY);
+			break;
+		case GRUNT_OP_FLUSH:
+			status = verify_pop(&cur, 2, gt_num);
+			break;
+		case GRUNT_OP_CLASSIFY:
+			/* As with PUSHS, every name must be valid. */
+			if (!(((uint32)p_i->arg.rep + VS_PARM_NUM_NAMES) <=
+				g_num_strings))
+				return GRUNT_ERROR_INVALIDLITERAL;
+			if ((status = verify_pop(&cur, 1, gt_num))) break;
+			/* Its row is max, min, name, and class. */
+			for (i = 0; (i < 4) && !status; i++)
+				status = verify_push(&cur, ctl_depth,
+					((i == 2) ? gt_str : gt_num));
+			break;
+		case GRUNT_OP_HALT:
+			if ((status = verify_pop(&cur, 1, gt_bool))) return status;
+			live = false;
+			break;
+		case GRUNT_OP_RETURN:
+			if (ctl_depth == 0) return GRUNT_ERROR_OUTOFBOUNDS;
+			if (loop_end) return GRUNT_ERROR_INVALIDARGUMENT;
+			if (*p_returns) {
+				if ((status = verify_merge(&ret, &cur)))
+					return status;
+			} else {
+				memcpy(&ret, &cur, sizeof(ret));
+				*p_returns = true;
+			}
+			live = false;
+			break;
+		case GRUNT_OP_CALL:
+			if (p_i->arg.lit.type != gt_pc)
+				return GRUNT_ERROR_INVALIDLITERAL;
+			if (p_i->arg.lit.val.pc < (pc + 1))
+				return GRUNT_ERROR_NOLOOPS;
+			if (!(p_i->arg.lit.val.pc < g_num_instructions))
+				return GRUNT_ERROR_NOPROGRAM;
+			if ((cur.depth + ctl_depth + 1) > GRUNT_STACK_SIZE)
+				return GRUNT_ERROR_OUTOFBOUNDS;
+			if ((status = verify_routine(p_i->arg.lit.val.pc,
+				ctl_depth + 1, 0, &cur, &callee_returns)))
+				return status;
+			g_error_pc = pc;
+			live = callee_returns;
+			break;
+		case GRUNT_OP_REPEAT:
+			if ((status = verify_loop(pc, ctl_depth, &cur, &end,
+				&live)))
+				return status;
+			pc = end;   /* continue after the END */
+			break;
+		case GRUNT_OP_END:
+			/* Not the END of the loop we're in, if any.  Its
+			 * slot on top of the control stack would be a
+			 * return address, or nothing at all.
+			 */
+			return ((ctl_depth == 0) ? GRUNT_ERROR_OUTOFBOUNDS :
+				GRUNT_ERROR_INVALIDARGUMENT);
+		case GRUNT_OP_JMPIF:
+			if (p_i->arg.lit.type != gt_pc)
+				return GRUNT_ERROR_INVALIDLITERAL;
+			lit = p_i->arg.lit.val.pc;
+			if (lit < 2) return GRUNT_ERROR_INVALIDLITERAL;
+			if ((lit > (GRUNT_PC_MAX - (pc + 1))) ||
+				!((pc + lit) < g_num_instructions))
+				return GRUNT_ERROR_NOPROGRAM;
+			if (loop_end && ((pc + lit) > loop_end))
+				return GRUNT_ERROR_INVALIDLITERAL;
+			if ((status = verify_pop(&cur, 1, gt_bool))) return status;
+			if (g_pending_count == GRUNT_VERIFY_MAX_PENDING)
+				return GRUNT_ERROR_OUTOFBOUNDS;
+			g_pending[g_pending_count].target = pc + lit;
+			memcpy(&(g_pending[g_pending_count].state), &cur,
+				sizeof(cur));
+			g_pending_count++;
+			break;
+		case GRUNT_OP_LOOKUP:
+			/* Like a JMPIF that is always taken, to the
+			 * instruction after the table.  The table's
+			 * instructions are reachable only by jumps and
+			 * calls into them.
+			 */
+			if ((status = verify_table(pc, p_i->arg.rep)))
+				return status;
+			if (loop_end &&
+				((pc + (2 * p_i->arg.rep) + 2) > loop_end))
+				return GRUNT_ERROR_INVALIDLITERAL;
+			if ((status = verify_pop(&cur, 1, gt_num)) ||
+				(status = verify_push(&cur, ctl_depth, gt_str)))
+				return status;
+			if (g_pending_count == GRUNT_VERIFY_MAX_PENDING)
+				return GRUNT_ERROR_OUTOFBOUNDS;
+			g_pending[g_pending_count].target =
+				pc + (2 * p_i->arg.rep) + 2;
+			memcpy(&(g_pending[g_pending_count].state), &cur,
+				sizeof(cur));
+			g_pending_count++;
+			live = false;
+			break;
+		case GRUNT_OP_SWITCH:
+			/* Like a JMPIF that is always taken, to the
+			 * target of each entry and to the instruction
+			 * after the table.  The entries themselves are
+			 * reachable only by jumps and calls into them.
+			 */
+			if ((status = verify_switch(pc, p_i->arg.rep)))
+				return status;
+			if ((status = verify_pop(&cur, 1, gt_num)))
+				return status;
+			for (i = 0; i <= p_i->arg.rep; i++) {
+				if (g_pending_count == GRUNT_VERIFY_MAX_PENDING)
+					return GRUNT_ERROR_OUTOFBOUNDS;
+				lit = pc + 1 + i;
+				if (i < p_i->arg.rep)
+					lit += g_program[lit].arg.lit.val.pc;
+				if (loop_end && (lit > loop_end))
+					return GRUNT_ERROR_INVALIDLITERAL;
+				g_pending[g_pending_count].target = lit;
+				memcpy(&(g_pending[g_pending_count].state), &cur,
+					sizeof(cur));
+				g_pending_count++;
+			}
+			live = false;
+			break;
+		default:
+			return GRUNT_ERROR_INVALIDOPCODE;
+		}
+
+		if (status) return status;
+	}
+
+	/* A path that is still live here would run off the end of the
+	 * program.
+	 */
+	if (live) {
+		g_error_pc = g_num_instructions;
+		return GRUNT_ERROR_NOPROGRAM;
+	}
+
+	g_pending_count = pending_base;
+	if (*p_returns) memcpy(p_state, &ret, sizeof(ret));
+	return 0;  /* OK! */
+
+} /* verify_routine() */
+
+
+/* ------------------- module exported functions -------------------- */
+
+/* grunt_verify_loop_end()
+ *
+ * in:     program          - Grunt program
+ *         num_instructions - number of instructions in program
+ *         pc               - pc of a REPEAT
+ * out:    nothing
+ * return: pc of the REPEAT's matching END, or 0 if it has none.
+ *
+ * Loops nest lexically: the matching END is the first one past pc
+ * that closes as many loops as have opened since pc.
+ */
+
+grunt_pc_t
+grunt_verify_loop_end(const grunt_instruction_t *program,
+	grunt_pc_t num_instructions, grunt_pc_t pc) {
+
+	uint32 open = 1;   /* loops opened and not yet closed */
+
+	while (++pc < num_instructions) {
+		if (program[pc].op == GRUNT_OP_REPEAT) {
+			open++;
+		} else if ((program[pc].op == GRUNT_OP_END) && !--open) {
+			return pc;
+		}
+	}
+
+	return 0;  /* no END */
+
+} /* grunt_verify_loop_end() */
+
+
+/* grunt_verify_program()
+ *
+ * in:     program          - Grunt program to verify
+ *         num_instructions - number of instructions in program
+ *         num_strings      - number of strings in program's string table
+ * out:    p_top_types      - if not NULL, for each instruction the
+ *                            verifier reached, the type on top of
+ *                            the arg stack on every path there, or
+ *                            GT_ANY; GT_UNSEEN for the others.  Each
+ *                            FORMAT gets the types of its values
+ *                            instead (see verify_format_types()).
+ *         p_error_pc       - pc of the first problem found, if any
+ * return: 0 if the program verifies, else a GRUNT_ERROR_* code.
+ *
+ * Verifies the properties described at the top of this file.  A
+ * program that fails verification may still run correctly for every
+ * input; the verifier is conservative.  For example, it rejects paths
+ * that join with different stack depths, and it rejects programs
+ * that push out-of-range strings they never output.
+ */
+
+int
+grunt_verify_program(const grunt_instruction_t *program,
+	grunt_pc_t num_instructions, grunt_string_t num_strings,
+	uint8 *p_top_types, grunt_pc_t *p_error_pc) {
+
+	grunt_verify_state_t state;
+	bool returns;
+	int status;
+
+	if (p_top_types) memset(p_top_types, GT_UNSEEN, num_instructions);
+
+	g_program          = program;
+	g_num_instructions = num_instructions;
+	g_num_strings      = num_strings;
+	g_pending_count    = 0;
+	g_steps            = 0;
+	g_error_pc         = 0;
+	g_top_types        = p_top_types;
+	state.depth        = 0;
+
+	/* The main routine starts with an empty control stack, so
+	 * verify_routine() rejects any path that RETURNs from it.
+	 */
+	status = verify_routine(0, 0, 0, &state, &returns);
+	*p_error_pc = g_error_pc;
+	return status;
+
+} /* grunt_verify_program() */
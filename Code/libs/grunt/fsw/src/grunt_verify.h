@@ -0,0 +1,33 @@
+#ifndef _GRUNT_VERIFY_H_
+#define _GRUNT_VERIFY_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* Abstract value types beyond the grunt_value_type_t ones. */
+#define GT_UNSEEN 0xFE   /* the verifier never reached here */
+#define GT_ANY    0xFF   /* the type differs between paths */
+
+/* The type of value k of a FORMAT, from the types the verifier
+ * records for it in place of its top type.
+ */
+#define GRUNT_VERIFY_FORMAT_TYPE(types, k) (((types) >> (2 * (k))) & 3)
+
+grunt_pc_t grunt_verify_loop_end(const grunt_instruction_t *, grunt_pc_t,
+	grunt_pc_t);
+int grunt_verify_program(const grunt_instruction_t *, grunt_pc_t,
+	grunt_string_t, uint8 *, grunt_pc_t *);
+
+#endif
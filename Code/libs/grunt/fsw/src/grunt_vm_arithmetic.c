@@ -29,37 +29,37 @@
  */
 
 int
-grunt_vm_add_sub(grunt_value_t *p_ra, grunt_value_t *p_rb, bool add_flag) {
+grunt_vm_add_sub(grunt_vm_t *p_vm, bool add_flag) {
 
 	int status;
 
 	/* Add & sub demand that the top two elements of the arg stack be
 	 * numbers.  Pop them and confirm that they are indeed numbers.
 	 */
-	if ((status = grunt_stack_arg_pop(p_rb))) return status;
-	if (p_rb->type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
-	if ((status = grunt_stack_arg_pop(p_ra))) return status;
-	if (p_ra->type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
+	if ((status = grunt_stack_arg_pop(p_vm, &(p_vm->rb)))) return status;
+	if (p_vm->rb.type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
+	if ((status = grunt_stack_arg_pop(p_vm, &(p_vm->ra)))) return status;
+	if (p_vm->ra.type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
 
 	/* Do the add/sub.  Report error on over/underflow. */
 	if (add_flag) {
 
 		/* Handle add */
-		if (p_rb->val.num > (GRUNT_NUM_MAX - p_ra->val.num))
+		if (p_vm->rb.val.num > (GRUNT_NUM_MAX - p_vm->ra.val.num))
 			return GRUNT_ERROR_OUTOFBOUNDS;  /* overflow */
-		p_ra->val.num += p_rb->val.num;
+		p_vm->ra.val.num += p_vm->rb.val.num;
 		
 	} else {
 
 		/* Handle sub */
-		if (p_ra->val.num < p_rb->val.num)
+		if (p_vm->ra.val.num < p_vm->rb.val.num)
 			return GRUNT_ERROR_OUTOFBOUNDS;  /* underflow */
-		p_ra->val.num -= p_rb->val.num;
+		p_vm->ra.val.num -= p_vm->rb.val.num;
 	       
 	}
 	
 	/* Push the result on the arg stack. */
-	return grunt_stack_arg_push(p_ra);
+	return grunt_stack_arg_push(p_vm, &(p_vm->ra));
 	
 } /* grunt_vm_add_sub() */
 
@@ -16,6 +16,6 @@
  * permissions and limitations under the License.
  */
 
-int grunt_vm_add_sub(grunt_value_t *, grunt_value_t *, bool);
+int grunt_vm_add_sub(grunt_vm_t *, bool);
 
 #endif
@@ -17,13 +17,13 @@
 
 #include "grunt_status.h"
 #include "grunt.h"
+#include "grunt_pack.h"
 #include "grunt_stack.h"
 #include "grunt_vm_control.h"
 
 
 int
-grunt_vm_call(grunt_value_t *p_ra, grunt_pc_t *p_pc,
-	const grunt_value_t *p_literal) {
+grunt_vm_call(grunt_vm_t *p_vm, const grunt_value_t *p_literal) {
 
 	int status;
 
@@ -35,23 +35,60 @@ grunt_vm_call(grunt_value_t *p_ra, grunt_pc_t *p_pc,
 	/* CALLs must be forward in the program.  This restriction
 	 * rules out loops.
 	 */
-	if (p_literal->val.pc < *p_pc) return GRUNT_ERROR_NOLOOPS;
+	if (p_literal->val.pc < p_vm->pc) return GRUNT_ERROR_NOLOOPS;
 	
 	/* Push the current program counter onto the control stack. */
-	p_ra->type   = gt_pc;
-	p_ra->val.pc = *p_pc;
-	if ((status = grunt_stack_ctl_push(p_ra))) return status;
+	p_vm->ra.type   = gt_pc;
+	p_vm->ra.val.pc = p_vm->pc;
+	if ((status = grunt_stack_ctl_push(p_vm, &(p_vm->ra)))) return status;
 
 	/* Set the program counter to the call target. */
-	*p_pc = p_literal->val.pc;
+	p_vm->pc = p_literal->val.pc;
 	
 	return 0;  /* OK! */
 	
 } /* grunt_vm_call() */
 
 
+/* grunt_vm_end()
+ *
+ * in:     p_vm - VM running an END, its pc past the END
+ * out:    p_vm - pc back at the loop body if it has runs left, else
+ *                the loop's control stack slots popped
+ * return: 0 on success, else a GRUNT_ERROR_* code.
+ *
+ * The slot on top of the control stack must be a loop's count, not a
+ * CALL's return address; otherwise this END doesn't belong to the
+ * innermost loop, or there is none.
+ */
+
 int
-grunt_vm_halt(grunt_value_t *p_ra) {
+grunt_vm_end(grunt_vm_t *p_vm) {
+
+	grunt_value_t count;
+	int status;
+
+	if ((status = grunt_stack_ctl_pop(p_vm, &count))) return status;
+	if (count.type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
+	if ((status = grunt_stack_ctl_pop(p_vm, &(p_vm->ra)))) return status;
+	if (count.val.num < 2) return 0;  /* OK, loop done! */
+
+	/* Jump back to the body.  Each jump spends one of the runs
+	 * REPEAT's literal allowed, so loops can't run forever.
+	 */
+	count.val.num--;
+	if ((status = grunt_stack_ctl_push(p_vm, &(p_vm->ra))) ||
+		(status = grunt_stack_ctl_push(p_vm, &count)))
+		return status;
+	p_vm->pc = p_vm->ra.val.pc;
+
+	return 0;  /* OK, again! */
+
+} /* grunt_vm_end() */
+
+
+int
+grunt_vm_halt(grunt_vm_t *p_vm) {
 
 	int status;
 
@@ -59,18 +96,17 @@ grunt_vm_halt(grunt_value_t *p_ra) {
 	 * Boolean.  Pop a value from the top of the stack, confirm it
 	 * is a Booelan, and return the proper status code.
 	 */
-	if ((status = grunt_stack_arg_pop(p_ra))) return status;
+	if ((status = grunt_stack_arg_pop(p_vm, &(p_vm->ra)))) return status;
 
-	if (p_ra->type != gt_bool) return GRUNT_ERROR_INVALIDARGUMENT;
+	if (p_vm->ra.type != gt_bool) return GRUNT_ERROR_INVALIDARGUMENT;
 
-	return (p_ra->val.b ? GRUNT_HALT_TRUE : GRUNT_HALT_FALSE);
+	return (p_vm->ra.val.b ? GRUNT_HALT_TRUE : GRUNT_HALT_FALSE);
 	
 } /* grunt_vm_halt() */
 
 
 int
-grunt_vm_jmpif(grunt_value_t *p_ra, grunt_pc_t *p_pc,
-	const grunt_value_t *p_literal) {
+grunt_vm_jmpif(grunt_vm_t *p_vm, const grunt_value_t *p_literal) {
 
 	int status;
 
@@ -81,34 +117,153 @@ grunt_vm_jmpif(grunt_value_t *p_ra, grunt_pc_t *p_pc,
 	if (p_literal->val.pc < 2)    return GRUNT_ERROR_INVALIDLITERAL;
 	
 	/* JMPIF expects a Boolean value at the top of the arg stack. */
-	if ((status = grunt_stack_arg_pop(p_ra))) return status;
-	if (p_ra->type != gt_bool) return GRUNT_ERROR_INVALIDARGUMENT;
+	if ((status = grunt_stack_arg_pop(p_vm, &(p_vm->ra)))) return status;
+	if (p_vm->ra.type != gt_bool) return GRUNT_ERROR_INVALIDARGUMENT;
 
 	/* If the boolean is false, we don't jump. */
-	if (!(p_ra->val.b)) return 0;  /* OK, no jump! */
+	if (!(p_vm->ra.val.b)) return 0;  /* OK, no jump! */
 
 	/* Boolean is true, jump.  Jumps are *relative* to the current
 	 * program counter.
 	 */
-	if (p_literal->val.pc > (UINT16_MAX - *p_pc))
+	if (p_literal->val.pc > (UINT16_MAX - p_vm->pc))
 		return GRUNT_ERROR_NOPROGRAM;
 	/* Undo instruction dispatch's earlier increment, adjust pc. */
-	*p_pc += (p_literal->val.pc - 1);
+	p_vm->pc += (p_literal->val.pc - 1);
 	
 	return 0;  /* OK, jump! */
 	
 } /* grunt_vm_jmpif() */
 
 
+/* grunt_vm_repeat()
+ *
+ * in:     p_vm - VM running a REPEAT, its pc at the loop body
+ *         reps - number of times to run the body
+ * out:    p_vm - body pc and count pushed onto the control stack
+ * return: 0 on success, else a GRUNT_ERROR_* code.
+ */
+
+int
+grunt_vm_repeat(grunt_vm_t *p_vm, grunt_rep_t reps) {
+
+	grunt_value_t count;
+	int status;
+
+	/* The minimum number of reps is 1. */
+	if (reps < 1) return GRUNT_ERROR_INVALIDLITERAL;
+
+	p_vm->ra.type   = gt_pc;
+	p_vm->ra.val.pc = p_vm->pc;
+	count.type      = gt_num;
+	count.val.num   = reps;
+	if ((status = grunt_stack_ctl_push(p_vm, &(p_vm->ra))) ||
+		(status = grunt_stack_ctl_push(p_vm, &count)))
+		return status;
+
+	return 0;  /* OK! */
+
+} /* grunt_vm_repeat() */
+
+
 int
-grunt_vm_return(grunt_value_t *p_ra, grunt_pc_t *p_pc) {
+grunt_vm_return(grunt_vm_t *p_vm) {
 
 	int status;
 	
-	if ((status = grunt_stack_ctl_pop(p_ra))) return status;
-	*p_pc = p_ra->val.pc;        /* reset pc to recalled return target */
+	/* RETURN from inside a loop body would find the loop's count. */
+	if ((status = grunt_stack_ctl_pop(p_vm, &(p_vm->ra)))) return status;
+	if (p_vm->ra.type != gt_pc) return GRUNT_ERROR_INVALIDARGUMENT;
+	p_vm->pc = p_vm->ra.val.pc;  /* reset pc to recalled return target */
 	return 0;  /* OK! */
 	
 } /* grunt_vm_return() */
 
 
+
+
+/* switch_entry()
+ *
+ * in:     p_table  - a SWITCH's table, or NULL
+ *         p_packed - if p_table is NULL, packed program holding it
+ *         table    - pc of first table entry
+ *         i        - index of entry in table
+ * out:    p_entry  - the entry
+ * return: nothing
+ */
+
+static void
+switch_entry(const grunt_instruction_t *p_table,
+	const grunt_packed_program_t *p_packed, grunt_pc_t table, uint32 i,
+	grunt_instruction_t *p_entry) {
+
+	if (p_table) {
+		*p_entry = p_table[i];
+	} else {
+		grunt_pack_decode(p_packed, (grunt_pc_t)(table + i), p_entry);
+	}
+
+} /* switch_entry() */
+
+
+/* grunt_vm_switch()
+ *
+ * in:     p_vm             - VM running a SWITCH, its pc at the
+ *                            SWITCH's table
+ *         p_table          - the table, or NULL to decode it from
+ *                            p_packed
+ *         p_packed         - packed program holding the SWITCH, if
+ *                            p_table is NULL
+ *         num_instructions - number of instructions in the program
+ *         reps             - number of entries in the table
+ * out:    p_vm             - key popped, pc at the chosen target
+ * return: 0 on success, else a GRUNT_ERROR_* code.
+ *
+ * Runs the SWITCH described in grunt.h.  As grunt_vm_lookup() does,
+ * we check the whole table before we touch the stack, so a bad table
+ * fails the same way whatever the key.
+ */
+
+int
+grunt_vm_switch(grunt_vm_t *p_vm, const grunt_instruction_t *p_table,
+	const grunt_packed_program_t *p_packed, grunt_pc_t num_instructions,
+	grunt_rep_t reps) {
+
+	grunt_instruction_t entry;    /* current table entry */
+	grunt_value_t key;
+	grunt_pc_t table = p_vm->pc;  /* pc of first table entry */
+	uint32 i;
+	int status;
+
+	/* The minimum number of reps is 1. */
+	if (reps < 1) return GRUNT_ERROR_INVALIDLITERAL;
+
+	if ((num_instructions < table) ||
+		((uint32)(num_instructions - table) < reps))
+		return GRUNT_ERROR_NOPROGRAM;  /* table runs off the end */
+
+	/* Every entry is a forward JMPIF whose target is a pc. */
+	for (i = 0; i < reps; i++) {
+		switch_entry(p_table, p_packed, table, i, &entry);
+		if ((entry.op != GRUNT_OP_JMPIF) ||
+			(entry.arg.lit.type != gt_pc) ||
+			(entry.arg.lit.val.pc < 1))
+			return GRUNT_ERROR_INVALIDLITERAL;
+		if (entry.arg.lit.val.pc > (UINT16_MAX - (table + i)))
+			return GRUNT_ERROR_NOPROGRAM;
+	}
+
+	if ((status = grunt_stack_arg_pop(p_vm, &key))) return status;
+	if (key.type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
+
+	if (key.val.num < reps) {
+		switch_entry(p_table, p_packed, table, key.val.num, &entry);
+		p_vm->pc = (grunt_pc_t)(table + key.val.num +
+			entry.arg.lit.val.pc);
+	} else {
+		p_vm->pc = (grunt_pc_t)(table + reps);
+	}
+
+	return 0;
+
+} /* grunt_vm_switch() */
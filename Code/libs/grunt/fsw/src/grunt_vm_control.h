@@ -16,10 +16,14 @@
  * permissions and limitations under the License.
  */
 
-int grunt_vm_call(grunt_value_t *, grunt_pc_t *, const grunt_value_t *);
-int grunt_vm_halt(grunt_value_t *);
-int grunt_vm_jmpif(grunt_value_t *, grunt_pc_t *, const grunt_value_t *);
-int grunt_vm_return(grunt_value_t *, grunt_pc_t *);
+int grunt_vm_call(grunt_vm_t *, const grunt_value_t *);
+int grunt_vm_end(grunt_vm_t *);
+int grunt_vm_halt(grunt_vm_t *);
+int grunt_vm_jmpif(grunt_vm_t *, const grunt_value_t *);
+int grunt_vm_repeat(grunt_vm_t *, grunt_rep_t);
+int grunt_vm_return(grunt_vm_t *);
+int grunt_vm_switch(grunt_vm_t *, const grunt_instruction_t *,
+	const grunt_packed_program_t *, grunt_pc_t, grunt_rep_t);
 
 
 #endif
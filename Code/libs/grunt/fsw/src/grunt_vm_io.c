@@ -20,23 +20,25 @@
 #include "grunt_stack.h"
 #include "grunt_input.h"
 #include "grunt_output.h"
+#include "grunt_vm_logic.h"
+#include "grunt_vm_stack.h"
 #include "grunt_vm_io.h"
 
 int
-grunt_vm_flush(grunt_value_t *p_ra, grunt_value_t *p_rb) {
+grunt_vm_flush(grunt_vm_t *p_vm) {
 
 	int status;
 
 	/* Pop the Event ID */
-	if ((status = grunt_stack_arg_pop(p_ra))) return status;
-	if (p_ra->type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
+	if ((status = grunt_stack_arg_pop(p_vm, &(p_vm->ra)))) return status;
+	if (p_vm->ra.type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
 
 	/* Pop Event Type */
-	if ((status = grunt_stack_arg_pop(p_rb))) return status;
-	if (p_rb->type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
+	if ((status = grunt_stack_arg_pop(p_vm, &(p_vm->rb)))) return status;
+	if (p_vm->rb.type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
 
 	/* Flush */
-	grunt_output_flush(p_ra->val.num, p_rb->val.num);
+	grunt_output_flush(p_vm, p_vm->ra.val.num, p_vm->rb.val.num);
 
 	return 0;  /* OK! */
 	
@@ -44,7 +46,7 @@ grunt_vm_flush(grunt_value_t *p_ra, grunt_value_t *p_rb) {
 
 
 int
-grunt_vm_input(grunt_value_t *p_ra, grunt_rep_t n) {
+grunt_vm_input(grunt_vm_t *p_vm, grunt_rep_t n) {
 
 	int status;
 	
@@ -55,28 +57,64 @@ grunt_vm_input(grunt_value_t *p_ra, grunt_rep_t n) {
 		return GRUNT_ERROR_INVALIDLITERAL;
 
 	/* Dequeue the next input value and push it onto the stack. */
-	if ((status = grunt_input_dequeue(p_ra, n))) return status;
-	return grunt_stack_arg_push(p_ra);
+	if ((status = grunt_input_dequeue(p_vm, &(p_vm->ra.val), n)))
+		return status;
+	p_vm->ra.type = gt_num;
+	return grunt_stack_arg_push(p_vm, &(p_vm->ra));
 	
 } /* grunt_vm_input() */
 
 
 int
-grunt_vm_output(grunt_value_t *p_ra) {
+grunt_vm_inputrec(grunt_vm_t *p_vm, grunt_rep_t layout) {
+
+	grunt_payload_t fields[GRUNT_INPUTREC_MAX_FIELDS];
+	grunt_value_t field;
+	int status, n, i;
+
+	/* Read the whole record, then push its fields in order. */
+	if ((status = grunt_input_record(p_vm, fields, &n, layout)))
+		return status;
+	field.type = gt_num;
+	for (i = 0; i < n; i++) {
+		field.val = fields[i];
+		if ((status = grunt_stack_arg_push(p_vm, &field)))
+			return status;
+	}
+	return 0;  /* OK! */
+
+} /* grunt_vm_inputrec() */
+
+
+int
+grunt_vm_inputz(grunt_vm_t *p_vm, grunt_rep_t n) {
+
+	int status;
+
+	if ((status = grunt_input_zero(p_vm, &(p_vm->ra.val), n)))
+		return status;
+	p_vm->ra.type = gt_bool;
+	return grunt_stack_arg_push(p_vm, &(p_vm->ra));
+
+} /* grunt_vm_inputz() */
+
+
+int
+grunt_vm_output(grunt_vm_t *p_vm) {
 
 	int status;
 
 	/* Pop the top element off of the stack. */
-	if ((status = grunt_stack_arg_pop(p_ra))) return status;
+	if ((status = grunt_stack_arg_pop(p_vm, &(p_vm->ra)))) return status;
 
 	/* Enqueue it on the output queue. */
-	switch (p_ra->type) {
+	switch (p_vm->ra.type) {
 	case gt_bool:
-		return grunt_output_enqueue_boolean(p_ra->val.b);
+		return grunt_output_enqueue_boolean(p_vm, p_vm->ra.val.b);
 	case gt_num:
-		return grunt_output_enqueue_number(p_ra->val.num);
+		return grunt_output_enqueue_number(p_vm, p_vm->ra.val.num);
 	case gt_str:
-		return grunt_output_enqueue_string(p_ra->val.str);
+		return grunt_output_enqueue_string(p_vm, p_vm->ra.val.str);
 	default:
 		/* You can't output elements of type gt_pc. */
 		return GRUNT_ERROR_INVALIDARGUMENT;
@@ -86,8 +124,49 @@ grunt_vm_output(grunt_value_t *p_ra) {
 
 
 int
-grunt_vm_rewind(grunt_rep_t reps) {
+grunt_vm_format(grunt_vm_t *p_vm, grunt_rep_t n) {
+
+	grunt_value_t values[GRUNT_FORMAT_MAX_VALUES];
+	int status, i;
 
-	return grunt_input_rewind(reps);
+	if (n > GRUNT_FORMAT_MAX_VALUES) return GRUNT_ERROR_INVALIDLITERAL;
+
+	/* Pop the template, then its values, the first one first. */
+	if ((status = grunt_stack_arg_pop(p_vm, &(p_vm->ra)))) return status;
+	if (p_vm->ra.type != gt_str) return GRUNT_ERROR_INVALIDARGUMENT;
+	for (i = n - 1; i >= 0; i--) {
+		if ((status = grunt_stack_arg_pop(p_vm, &(values[i]))))
+			return status;
+	}
+
+	return grunt_output_enqueue_format(p_vm, p_vm->ra.val.str, values, n);
+
+} /* grunt_vm_format() */
+
+
+int
+grunt_vm_rewind(grunt_vm_t *p_vm, grunt_rep_t reps) {
+
+	return grunt_input_rewind(p_vm, reps);
 	
 } /* grunt_vm_rewind() */
+
+
+/* INPUT(n); PUSHN literal; LT or GT: compares the next input value to
+ * a constant.  Like the superinstruction handlers in grunt_vm_logic.c,
+ * it advances p_vm->pc past each instruction before running the next.
+ */
+
+int
+grunt_vm_input_lt_gt(grunt_vm_t *p_vm, grunt_rep_t n,
+	const grunt_value_t *p_literal, bool lt_flag) {
+
+	int status;
+
+	if ((status = grunt_vm_input(p_vm, n))) return status;
+	p_vm->pc++;
+	if ((status = grunt_vm_pushn(p_vm, p_literal))) return status;
+	p_vm->pc++;
+	return grunt_vm_lt_gt(p_vm, lt_flag);
+
+} /* grunt_vm_input_lt_gt() */
@@ -16,9 +16,14 @@
  * permissions and limitations under the License.
  */
 
-int grunt_vm_flush(grunt_value_t *, grunt_value_t *);
-int grunt_vm_input(grunt_value_t *, grunt_rep_t);
-int grunt_vm_output(grunt_value_t *);
-int grunt_vm_rewind(grunt_rep_t);
+int grunt_vm_flush(grunt_vm_t *);
+int grunt_vm_format(grunt_vm_t *, grunt_rep_t);
+int grunt_vm_input(grunt_vm_t *, grunt_rep_t);
+int grunt_vm_inputrec(grunt_vm_t *, grunt_rep_t);
+int grunt_vm_inputz(grunt_vm_t *, grunt_rep_t);
+int grunt_vm_output(grunt_vm_t *);
+int grunt_vm_rewind(grunt_vm_t *, grunt_rep_t);
+int grunt_vm_input_lt_gt(grunt_vm_t *, grunt_rep_t, const grunt_value_t *,
+	bool);
 
 #endif
@@ -18,15 +18,18 @@
 #include "grunt_status.h"
 #include "grunt.h"
 #include "grunt_stack.h"
+#include "grunt_vm_control.h"
+#include "grunt_vm_stack.h"
 #include "grunt_vm_logic.h"
 
 
 /* grunt_vm_and_or()
  *
- * in:     n  - operate on the top n elements of the arg stack
+ * in:     p_vm - VM whose arg stack to operate on
+ *         n  - operate on the top n elements of the arg stack
  *         and_flag - true for logical and, false for logical or
- * out:    *p_ra    - clobbered; holds result of and/or operation
- *         *p_rb    - clobbered
+ * out:    p_vm->ra - clobbered; holds result of and/or operation
+ *         p_vm->rb - clobbered
  * return: value        condition
  *         ------       ---------------
  *         GRUNT_ERROR_INVALIDLITERAL  - need n to be at least 2
@@ -41,8 +44,7 @@
  */
 
 int
-grunt_vm_and_or(grunt_value_t *p_ra, grunt_value_t *p_rb, grunt_rep_t n,
-	bool and_flag) {
+grunt_vm_and_or(grunt_vm_t *p_vm, grunt_rep_t n, bool and_flag) {
 
 	grunt_rep_t i;
 	int status;
@@ -50,33 +52,36 @@ grunt_vm_and_or(grunt_value_t *p_ra, grunt_value_t *p_rb, grunt_rep_t n,
 	/* The minimum number of reps is 2. */
 	if (n < 2) return GRUNT_ERROR_INVALIDLITERAL;
 
-	/* Pop the first argument into p_ra and confirm it is a Boolean. */
-	if ((status = grunt_stack_arg_pop(p_ra))) return status;
-	if (p_ra->type != gt_bool) return GRUNT_ERROR_INVALIDARGUMENT;
+	/* Pop the first argument into ra and confirm it is a Boolean. */
+	if ((status = grunt_stack_arg_pop(p_vm, &(p_vm->ra)))) return status;
+	if (p_vm->ra.type != gt_bool) return GRUNT_ERROR_INVALIDARGUMENT;
 
-	/* Pop the subsequent arguments into p_rb, confirm they are
-	 * also Boolean, and logical-and/or them into p_ra.
+	/* Pop the subsequent arguments into rb, confirm they are
+	 * also Boolean, and logical-and/or them into ra.
 	 */
 	for (i = 1; i < n; i++) {
-		if ((status = grunt_stack_arg_pop(p_rb))) return status;
-		if (p_rb->type != gt_bool) return GRUNT_ERROR_INVALIDARGUMENT;
+		if ((status = grunt_stack_arg_pop(p_vm, &(p_vm->rb))))
+			return status;
+		if (p_vm->rb.type != gt_bool)
+			return GRUNT_ERROR_INVALIDARGUMENT;
 
-		p_ra->val.b = (and_flag ?
-			p_ra->val.b && p_rb->val.b :
-			p_ra->val.b || p_rb->val.b);
+		p_vm->ra.val.b = (and_flag ?
+			p_vm->ra.val.b && p_vm->rb.val.b :
+			p_vm->ra.val.b || p_vm->rb.val.b);
 	}
 
-	/* Push the value accumulated in g_ra. */
-	return grunt_stack_arg_push(p_ra);
+	/* Push the value accumulated in ra. */
+	return grunt_stack_arg_push(p_vm, &(p_vm->ra));
 	
 } /* grunt_vm_and_or() */
 
 
 /* grunt_vm_eq()
  *
- * in:     n     - operate on the top n elements of the arg stack
- * out:    *p_ra - clobbered ; will contain result of the eq operation
- *         *p_rb - clobbered
+ * in:     p_vm  - VM whose arg stack to operate on
+ *         n     - operate on the top n elements of the arg stack
+ * out:    p_vm->ra - clobbered ; will contain result of the eq operation
+ *         p_vm->rb - clobbered
  * return: value        condition
  *         ------       ---------------
  *         GRUNT_ERROR_INVALIDLITERAL  - need n to be at least 2
@@ -90,7 +95,7 @@ grunt_vm_and_or(grunt_value_t *p_ra, grunt_value_t *p_rb, grunt_rep_t n,
  */
 
 int
-grunt_vm_eq(grunt_value_t *p_ra, grunt_value_t *p_rb, grunt_rep_t n) {
+grunt_vm_eq(grunt_vm_t *p_vm, grunt_rep_t n) {
 
 	grunt_rep_t i;
 	bool equal_flag = true;  /* optimistically presume all n equal */
@@ -99,35 +104,37 @@ grunt_vm_eq(grunt_value_t *p_ra, grunt_value_t *p_rb, grunt_rep_t n) {
 	/* The minimum number of reps is 2. */
 	if (n < 2) return GRUNT_ERROR_INVALIDLITERAL;
 
-	/* Pop the first argument into g_ra and confirm it is a number. */
-	if ((status = grunt_stack_arg_pop(p_ra))) return status;
-	if (p_ra->type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
+	/* Pop the first argument into ra and confirm it is a number. */
+	if ((status = grunt_stack_arg_pop(p_vm, &(p_vm->ra)))) return status;
+	if (p_vm->ra.type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
 
-	/* Pop the subsequent arguments into p_rb, confirm they are
-	 * also numbers, and compare them to p_ra.  Keep comparing
+	/* Pop the subsequent arguments into rb, confirm they are
+	 * also numbers, and compare them to ra.  Keep comparing
 	 * even after we find a non-equal number; we need to pop all
 	 * n of our arguments.
 	 */
 	for (i = 1; i < n; i++) {
-		if ((status = grunt_stack_arg_pop(p_rb))) return status;
-		if (p_rb->type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
+		if ((status = grunt_stack_arg_pop(p_vm, &(p_vm->rb))))
+			return status;
+		if (p_vm->rb.type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
 
-		if (p_ra->val.num != p_rb->val.num) equal_flag = false;
+		if (p_vm->ra.val.num != p_vm->rb.val.num) equal_flag = false;
 	}
 
 	/* Push the result. */
-	p_ra->type = gt_bool;
-	p_ra->val.b = equal_flag;
-	return grunt_stack_arg_push(p_ra);
+	p_vm->ra.type = gt_bool;
+	p_vm->ra.val.b = equal_flag;
+	return grunt_stack_arg_push(p_vm, &(p_vm->ra));
 	
 } /* grunt_vm_eq() */
 
 
 /* grunt_vm_lt_gt()
  *
- * in:     lt_flag - true for lt, false for gt
- * out:    *g_ra   - clobbered; will contain the result of the lt/gt op
- *         *g_rb   - clobbered
+ * in:     p_vm    - VM whose arg stack to operate on
+ *         lt_flag - true for lt, false for gt
+ * out:    p_vm->ra - clobbered; will contain the result of the lt/gt op
+ *         p_vm->rb - clobbered
  * return: value        condition
  *         ------       ---------------
  *         GRUNT_ERROR_INVALIDARGUMENT - topmost 2 args must be numbers
@@ -143,7 +150,7 @@ grunt_vm_eq(grunt_value_t *p_ra, grunt_value_t *p_rb, grunt_rep_t n) {
  */
 
 int
-grunt_vm_lt_gt(grunt_value_t *p_ra, grunt_value_t *p_rb, bool lt_flag) {
+grunt_vm_lt_gt(grunt_vm_t *p_vm, bool lt_flag) {
 
 	bool result;  /* true/false result of lt or gt comparison */
 	int status;
@@ -151,25 +158,25 @@ grunt_vm_lt_gt(grunt_value_t *p_ra, grunt_value_t *p_rb, bool lt_flag) {
 	/* LT and GT demand that the top two elements of the arg stack be
 	 * numbers.  Pop them and confirm that they are indeed numbers.
 	 */
-	if ((status = grunt_stack_arg_pop(p_rb))) return status;
-	if (p_rb->type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
-	if ((status = grunt_stack_arg_pop(p_ra))) return status;
-	if (p_ra->type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
+	if ((status = grunt_stack_arg_pop(p_vm, &(p_vm->rb)))) return status;
+	if (p_vm->rb.type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
+	if ((status = grunt_stack_arg_pop(p_vm, &(p_vm->ra)))) return status;
+	if (p_vm->ra.type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
 
 	/* Do the lt/gt comparison and push the result on the arg stack. */
-	result = (lt_flag ? p_ra->val.num < p_rb->val.num :
-		p_ra->val.num > p_rb->val.num);
-	p_ra->type = gt_bool;
-	p_ra->val.b = result;
-	return grunt_stack_arg_push(p_ra);
+	result = (lt_flag ? p_vm->ra.val.num < p_vm->rb.val.num :
+		p_vm->ra.val.num > p_vm->rb.val.num);
+	p_vm->ra.type = gt_bool;
+	p_vm->ra.val.b = result;
+	return grunt_stack_arg_push(p_vm, &(p_vm->ra));
 	
 } /* grunt_vm_lt_gt() */
 
 
 /* grunt_vm_not()
  *
- * in:     nothing
- * out:    *g_ra   - clobbered; will contain the result of the not operation
+ * in:     p_vm    - VM whose arg stack to operate on
+ * out:    p_vm->ra - clobbered; will contain the result of the not operation
  * return: value        condition
  *         ------       ---------------
  *         GRUNT_ERROR_INVALIDARGUMENT - topmost arg must be a Boolean
@@ -181,20 +188,111 @@ grunt_vm_lt_gt(grunt_value_t *p_ra, grunt_value_t *p_rb, bool lt_flag) {
  */
 
 int
-grunt_vm_not(grunt_value_t *p_ra) {
+grunt_vm_not(grunt_vm_t *p_vm) {
 
 	int status;
 	
 	/* RETURN demands that the top element of the arg stack be a
 	 * Boolean.  Pop it and confirm that it is indeed a Boolean.
 	 */
-	if ((status = grunt_stack_arg_pop(p_ra))) return status;
-	if (p_ra->type != gt_bool) return GRUNT_ERROR_INVALIDARGUMENT;
+	if ((status = grunt_stack_arg_pop(p_vm, &(p_vm->ra)))) return status;
+	if (p_vm->ra.type != gt_bool) return GRUNT_ERROR_INVALIDARGUMENT;
 
 	/* NOT the boolean value and push it back on the arg stack. */
-	p_ra->val.b = !p_ra->val.b;
-	return grunt_stack_arg_push(p_ra);
+	p_vm->ra.val.b = !p_vm->ra.val.b;
+	return grunt_stack_arg_push(p_vm, &(p_vm->ra));
 	
 } /* grunt_vm_not() */
 	
 
+
+/* The superinstruction handlers below each carry out a sequence of
+ * instructions that GRUNT_Pack() fused, by running the handlers of
+ * the sequence's instructions in order.  Each advances p_vm->pc past
+ * each instruction before running the next, just as instruction
+ * dispatch would have.  So when one fails, p_vm->pc is one past the
+ * instruction that failed, and the status is the one that
+ * instruction would have reported on its own.
+ */
+
+
+/* grunt_vm_eqn()
+ *
+ * in:     p_vm      - VM to run on
+ *         p_vm->pc  - one past the PUSHN
+ *         p_literal - the PUSHN's literal
+ *         n         - the EQ's repetitions
+ * out:    p_vm->ra  - clobbered; will contain result of the eq operation
+ *         p_vm->rb  - clobbered
+ *         p_vm->pc  - one past the EQ on success
+ * return: grunt_vm_pushn() and grunt_vm_eq() error codes, or 0.
+ *
+ * PUSHN literal; EQ(n): compares the top n - 1 elements of the arg
+ * stack to a constant.
+ */
+
+int
+grunt_vm_eqn(grunt_vm_t *p_vm, const grunt_value_t *p_literal,
+	grunt_rep_t n) {
+
+	int status;
+
+	if ((status = grunt_vm_pushn(p_vm, p_literal))) return status;
+	p_vm->pc++;
+	return grunt_vm_eq(p_vm, n);
+
+} /* grunt_vm_eqn() */
+
+
+/* grunt_vm_dup_eqn()
+ *
+ * in:     p_vm      - VM to run on
+ *         p_vm->pc  - one past the DUP
+ *         p_literal - the PUSHN's literal
+ * out:    p_vm->ra  - clobbered; will contain result of the eq operation
+ *         p_vm->rb  - clobbered
+ *         p_vm->pc  - one past the EQ on success
+ * return: grunt_vm_dup(), grunt_vm_pushn(), and grunt_vm_eq() error
+ *         codes, or 0.
+ *
+ * DUP(1); PUSHN literal; EQ(2): pushes whether the top element of the
+ * arg stack equals a constant, keeping that element.
+ */
+
+int
+grunt_vm_dup_eqn(grunt_vm_t *p_vm, const grunt_value_t *p_literal) {
+
+	int status;
+
+	if ((status = grunt_vm_dup(p_vm, 1))) return status;
+	p_vm->pc++;
+	if ((status = grunt_vm_pushn(p_vm, p_literal))) return status;
+	p_vm->pc++;
+	return grunt_vm_eq(p_vm, 2);
+
+} /* grunt_vm_dup_eqn() */
+
+
+/* grunt_vm_not_jmpif()
+ *
+ * in:     p_vm      - VM to run on
+ *         p_vm->pc  - one past the NOT
+ *         p_literal - the JMPIF's literal
+ * out:    p_vm->ra  - clobbered
+ *         p_vm->pc  - one past the JMPIF, or the jump target
+ * return: grunt_vm_not() and grunt_vm_jmpif() error codes, or 0.
+ *
+ * NOT; JMPIF literal: jumps if the Boolean on top of the arg stack is
+ * false.
+ */
+
+int
+grunt_vm_not_jmpif(grunt_vm_t *p_vm, const grunt_value_t *p_literal) {
+
+	int status;
+
+	if ((status = grunt_vm_not(p_vm))) return status;
+	p_vm->pc++;
+	return grunt_vm_jmpif(p_vm, p_literal);
+
+} /* grunt_vm_not_jmpif() */
@@ -16,9 +16,12 @@
  * permissions and limitations under the License.
  */
 
-int grunt_vm_and_or(grunt_value_t *, grunt_value_t *, grunt_rep_t, bool);
-int grunt_vm_eq(grunt_value_t *, grunt_value_t *, grunt_rep_t);
-int grunt_vm_lt_gt(grunt_value_t *, grunt_value_t *, bool);
-int grunt_vm_not(grunt_value_t *);
+int grunt_vm_and_or(grunt_vm_t *, grunt_rep_t, bool);
+int grunt_vm_eq(grunt_vm_t *, grunt_rep_t);
+int grunt_vm_lt_gt(grunt_vm_t *, bool);
+int grunt_vm_not(grunt_vm_t *);
+int grunt_vm_eqn(grunt_vm_t *, const grunt_value_t *, grunt_rep_t);
+int grunt_vm_dup_eqn(grunt_vm_t *, const grunt_value_t *);
+int grunt_vm_not_jmpif(grunt_vm_t *, const grunt_value_t *);
 
 #endif
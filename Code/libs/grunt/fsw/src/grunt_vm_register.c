@@ -0,0 +1,310 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module implements the register machine core that runs the
+ * lowered form of verified Grunt programs.  See grunt_lower.h and
+ * grunt_lower.c.
+ *
+ * Like the verified stack engine, this core performs only the checks
+ * that depend on the input data: input queue bounds, arithmetic
+ * over/underflow, and output queue overflow.  It reports their failure
+ * with the same status codes and program counter values as the other
+ * engines, taking the pc from the failing instruction.
+ */
+
+#include "cfe.h"
+
+#include "grunt_status.h"
+#include "grunt.h"
+#include "grunt_input.h"
+#include "grunt_output.h"
+#include "grunt_verify.h"
+#include "grunt_lower.h"
+#include "grunt_vm_stack.h"
+#include "grunt_vm_register.h"
+
+
+/* grunt_vm_register_classify()
+ *
+ * in:     p_vm  - VM running the CLASSIFY, unused
+ *         p_d   - a CLASSIFY's registers, the key in the first
+ *         names - string number of the first parm name
+ * out:    p_d   - the key's row in the first four registers
+ * return: nothing
+ *
+ * Takes the VM first, as the JIT's helpers must.
+ */
+
+void
+grunt_vm_register_classify(grunt_vm_t *p_vm, grunt_reg_t *p_d,
+	uint32 names) {
+
+	grunt_payload_t row[4];
+
+	(void)p_vm;
+
+	grunt_classify(row, p_d[0], (grunt_rep_t)names);
+	p_d[0] = row[0].num;
+	p_d[1] = row[1].num;
+	p_d[2] = row[2].str;
+	p_d[3] = row[3].num;
+
+} /* grunt_vm_register_classify() */
+
+
+/* grunt_vm_register_format()
+ *
+ * in:     p_vm - VM whose output queue to use
+ *         p_r  - a FORMAT's registers: its values, the last one
+ *                first, then its template
+ *         imm  - the FORMAT's imm, its value count and types
+ * out:    p_vm->output_queue - expanded template appended
+ * return: grunt_output_enqueue_format()'s status.
+ *
+ * Gives the untyped registers back the types the lowering pass
+ * recorded, for this core and the JIT alike.
+ */
+
+int
+grunt_vm_register_format(grunt_vm_t *p_vm, const grunt_reg_t *p_r,
+	uint32 imm) {
+
+	grunt_value_t values[GRUNT_FORMAT_MAX_VALUES];
+	grunt_rep_t n = GRUNT_LOWER_FORMAT_N(imm);
+	uint8 types = GRUNT_LOWER_FORMAT_TYPES(imm);
+	grunt_rep_t i;
+
+	for (i = 0; i < n; i++) {
+		values[i].type = (grunt_value_type_t)
+			GRUNT_VERIFY_FORMAT_TYPE(types, n - 1 - i);
+		switch (values[i].type) {
+		case gt_bool:
+			values[i].val.b = (p_r[i] != 0);
+			break;
+		case gt_num:
+			values[i].val.num = p_r[i];
+			break;
+		default:
+			values[i].val.str = (grunt_string_t)p_r[i];
+			break;
+		}
+	}
+
+	return grunt_output_enqueue_format(p_vm, (grunt_string_t)p_r[n],
+		values, n);
+
+} /* grunt_vm_register_format() */
+
+
+/* grunt_vm_run_register()
+ *
+ * in:     p_vm       - VM whose input and output queues to use
+ *         p_lowered  - lowered Grunt program to run
+ * out:    *p_current - program counter of the Grunt instruction that
+ *                      failed, for error reporting
+ * return: GRUNT_HALT_TRUE/FALSE or a GRUNT_ERROR_* status code.
+ *
+ * Jumps within a lowered routine go only forward, except NEXT's back
+ * to its loop's body, which it takes only as many times as its LOOP
+ * allows.  The lowered call graph is the Grunt program's, which
+ * forward-only CALLs keep free of cycles, so this core inherits
+ * Grunt's termination guarantee.
+ */
+
+int
+grunt_vm_run_register(grunt_vm_t *p_vm,
+	const grunt_lowered_program_t *p_lowered, grunt_pc_t *p_current) {
+
+	grunt_reg_t file[GRUNT_LOWER_NUM_REGISTERS];  /* the registers */
+	grunt_reg_t *r = file;                        /* frame pointer */
+	struct {
+		const grunt_reg_instruction_t *p_return;
+		grunt_reg_t *r;
+		uint32 count;           /* a loop's runs left */
+	} ctl[GRUNT_STACK_SIZE];    /* the control stack */
+	int csp = 0;                /* count of elements on control stack */
+	const grunt_reg_instruction_t *code = p_lowered->code;
+	const grunt_reg_instruction_t *p_i = &(code[p_lowered->start]);
+	const grunt_reg_instruction_t *p_t;  /* a LOOKUP or SWITCH entry */
+	grunt_payload_t value;      /* bounce input values through here */
+	int status;
+
+	for (;;) {
+
+		switch (p_i->op) {
+		case GRUNT_ROP_LDI:
+			r[p_i->d] = p_i->imm;
+			break;
+		case GRUNT_ROP_MOV:
+			r[p_i->d] = r[p_i->a];
+			break;
+		case GRUNT_ROP_ADD:
+			if (r[p_i->b] > (GRUNT_NUM_MAX - r[p_i->a])) {
+				*p_current = p_i->pc;
+				return GRUNT_ERROR_OUTOFBOUNDS;  /* overflow */
+			}
+			r[p_i->d] = r[p_i->a] + r[p_i->b];
+			break;
+		case GRUNT_ROP_SUB:
+			if (r[p_i->a] < r[p_i->b]) {
+				*p_current = p_i->pc;
+				return GRUNT_ERROR_OUTOFBOUNDS;  /* underflow */
+			}
+			r[p_i->d] = r[p_i->a] - r[p_i->b];
+			break;
+		case GRUNT_ROP_AND:
+			r[p_i->d] = (r[p_i->a] && r[p_i->b]);
+			break;
+		case GRUNT_ROP_OR:
+			r[p_i->d] = (r[p_i->a] || r[p_i->b]);
+			break;
+		case GRUNT_ROP_EQ:
+			r[p_i->d] = (r[p_i->a] == r[p_i->b]);
+			break;
+		case GRUNT_ROP_LT:
+			r[p_i->d] = (r[p_i->a] < r[p_i->b]);
+			break;
+		case GRUNT_ROP_NOT:
+			r[p_i->d] = !r[p_i->a];
+			break;
+		case GRUNT_ROP_INPUT:
+			if ((status = grunt_input_dequeue(p_vm, &value,
+				(grunt_rep_t)p_i->imm))) {
+				*p_current = p_i->pc;
+				return status;
+			}
+			r[p_i->d] = value.num;
+			break;
+		case GRUNT_ROP_INPUTREC:
+			{
+				grunt_payload_t
+					fields[GRUNT_INPUTREC_MAX_FIELDS];
+				int n, k;
+				if ((status = grunt_input_record(p_vm, fields,
+					&n, (grunt_rep_t)p_i->imm))) {
+					*p_current = p_i->pc;
+					return status;
+				}
+				for (k = 0; k < n; k++)
+					r[p_i->d + k] = fields[k].num;
+			}
+			break;
+		case GRUNT_ROP_CLASSIFY:
+			grunt_vm_register_classify(p_vm, &(r[p_i->d]),
+				p_i->imm);
+			break;
+		case GRUNT_ROP_INPUTZ:
+			if ((status = grunt_input_zero(p_vm, &value,
+				(grunt_rep_t)p_i->imm))) {
+				*p_current = p_i->pc;
+				return status;
+			}
+			r[p_i->d] = value.b;
+			break;
+		case GRUNT_ROP_REWIND:
+			if ((status = grunt_input_rewind(p_vm,
+				(grunt_rep_t)p_i->imm))) {
+				*p_current = p_i->pc;
+				return status;
+			}
+			break;
+		case GRUNT_ROP_OUTB:
+			if ((status = grunt_output_enqueue_boolean(p_vm,
+				r[p_i->a] != 0))) {
+				*p_current = p_i->pc;
+				return status;
+			}
+			break;
+		case GRUNT_ROP_OUTN:
+			if ((status = grunt_output_enqueue_number(p_vm,
+				r[p_i->a]))) {
+				*p_current = p_i->pc;
+				return status;
+			}
+			break;
+		case GRUNT_ROP_OUTS:
+			if ((status = grunt_output_enqueue_string(p_vm,
+				(grunt_string_t)r[p_i->a]))) {
+				*p_current = p_i->pc;
+				return status;
+			}
+			break;
+		case GRUNT_ROP_FORMAT:
+			if ((status = grunt_vm_register_format(p_vm,
+				&(r[p_i->a]), p_i->imm))) {
+				*p_current = p_i->pc;
+				return status;
+			}
+			break;
+		case GRUNT_ROP_FLUSH:
+			grunt_output_flush(p_vm, r[p_i->a], r[p_i->b]);
+			break;
+		case GRUNT_ROP_HALT:
+			return (r[p_i->a] ? GRUNT_HALT_TRUE : GRUNT_HALT_FALSE);
+		case GRUNT_ROP_JMPIF:
+			if (r[p_i->a]) {
+				p_i = &(code[p_i->imm]);
+				continue;
+			}
+			break;
+		case GRUNT_ROP_CALL:
+			ctl[csp].p_return = p_i + 1;
+			ctl[csp].r        = r;
+			csp++;
+			r += p_i->a;
+			p_i = &(code[p_i->imm]);
+			continue;
+		case GRUNT_ROP_TAILCALL:
+			r += p_i->a;
+			p_i = &(code[p_i->imm]);
+			continue;
+		case GRUNT_ROP_RET:
+			csp--;
+			p_i = ctl[csp].p_return;
+			r   = ctl[csp].r;
+			continue;
+		case GRUNT_ROP_LOOP:
+			ctl[csp++].count = p_i->imm;
+			break;
+		case GRUNT_ROP_NEXT:
+			if (--ctl[csp - 1].count) {
+				p_i = &(code[p_i->imm]);
+				continue;
+			}
+			csp--;
+			break;
+		case GRUNT_ROP_LOOKUP:
+			p_t = p_i + 1;
+			while ((p_t->op == GRUNT_ROP_CASE) &&
+				(p_t->imm != r[p_i->a]))
+				p_t += 2;
+			if (p_t->op == GRUNT_ROP_CASE) p_t++;
+			r[p_i->d] = p_t->imm;
+			p_i = &(code[p_i->imm]);
+			continue;
+		case GRUNT_ROP_SWITCH:
+			p_t = p_i + 1 + ((r[p_i->a] < p_i->imm) ? r[p_i->a] :
+				p_i->imm);
+			p_i = &(code[p_t->imm]);
+			continue;
+		default:
+			*p_current = p_i->pc;
+			return GRUNT_ERROR_INTERPRETERBUG;  /* lowering bug */
+		}
+
+		p_i++;
+	}
+
+} /* grunt_vm_run_register() */
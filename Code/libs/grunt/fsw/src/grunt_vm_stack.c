@@ -20,22 +20,101 @@
 #include "grunt_stack.h"
 #include "grunt_input.h"
 #include "grunt_output.h"
+#include "grunt_pack.h"
 #include "grunt_vm_stack.h"
+#include "vs_parmclass.h"
+
+
+/* grunt_classify()
+ *
+ * in:     key   - number to classify
+ *         names - string number of the first parm name
+ * out:    p_row - key's row of the classification table, as the four
+ *                 values CLASSIFY pushes, bottom first
+ * return: nothing
+ *
+ * The one place every engine looks CLASSIFY's rows up.  The row's
+ * values are a number, a number, a string, and a number; the
+ * verified engines keep them as they are, without types.  p_row may
+ * overlap the slot key came from.
+ */
+
+void
+grunt_classify(grunt_payload_t *p_row, grunt_number_t key,
+	grunt_rep_t names) {
+
+	const vs_parm_class_t *p_class = VS_parm_class(key);
+
+	p_row[0].num = p_class->max;
+	p_row[1].num = p_class->min;
+	p_row[2].str = (grunt_string_t)(names + p_class->name);
+	p_row[3].num = p_class->kind;
+
+} /* grunt_classify() */
+
+
+/* grunt_classify_typed()
+ *
+ * in:     key   - number to classify
+ *         names - string number of the first parm name
+ * out:    p_row - key's row, as grunt_classify() gives it, with types
+ * return: nothing
+ */
+
+void
+grunt_classify_typed(grunt_value_t *p_row, grunt_number_t key,
+	grunt_rep_t names) {
+
+	grunt_payload_t row[4];
+	int i;
+
+	grunt_classify(row, key, names);
+	for (i = 0; i < 4; i++) {
+		p_row[i].type = ((i == 2) ? gt_str : gt_num);
+		p_row[i].val  = row[i];
+	}
+
+} /* grunt_classify_typed() */
+
+
+int
+grunt_vm_classify(grunt_vm_t *p_vm, grunt_rep_t names) {
+
+	grunt_value_t key;
+	grunt_value_t row[4];
+	int i, status;
+
+	/* The names must all have string numbers. */
+	if (names > (GRUNT_STRING_MAX - (VS_PARM_NUM_NAMES - 1)))
+		return GRUNT_ERROR_INVALIDLITERAL;
+
+	if ((status = grunt_stack_arg_pop(p_vm, &key))) return status;
+	if (key.type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
+
+	grunt_classify_typed(row, key.val.num, names);
+	for (i = 0; i < 4; i++) {
+		if ((status = grunt_stack_arg_push(p_vm, &(row[i]))))
+			return status;
+	}
+
+	return 0;  /* OK! */
+
+} /* grunt_vm_classify() */
 
 
 int
-grunt_vm_dup(grunt_rep_t reps) {
+grunt_vm_dup(grunt_vm_t *p_vm, grunt_rep_t reps) {
 
 	/* The minimum number of reps is 1. */
 	if (reps < 1) return GRUNT_ERROR_INVALIDLITERAL;
 
-	return grunt_stack_arg_dup(reps);
+	return grunt_stack_arg_dup(p_vm, reps);
 	
 } /* grunt_vm_dup() */
 
 
 int
-grunt_vm_pop(grunt_value_t *p_ra, grunt_rep_t reps) {
+grunt_vm_pop(grunt_vm_t *p_vm, grunt_rep_t reps) {
 
 	grunt_rep_t i;
 	int status;
@@ -44,7 +123,8 @@ grunt_vm_pop(grunt_value_t *p_ra, grunt_rep_t reps) {
 	if (reps < 1) return GRUNT_ERROR_INVALIDLITERAL;
 
 	for (i = 0; i < reps; i++) {
-		if ((status = grunt_stack_arg_pop(p_ra))) return status;
+		if ((status = grunt_stack_arg_pop(p_vm, &(p_vm->ra))))
+			return status;
 	}
 
 	return 0;  /* OK! */
@@ -53,44 +133,135 @@ grunt_vm_pop(grunt_value_t *p_ra, grunt_rep_t reps) {
 
 
 int
-grunt_vm_pushb(const grunt_value_t *p_literal) {
+grunt_vm_pushb(grunt_vm_t *p_vm, const grunt_value_t *p_literal) {
 
 	/* PUSHB must have a Boolean argument. */
 	if (p_literal->type != gt_bool) return GRUNT_ERROR_INVALIDLITERAL;
 
-	return grunt_stack_arg_push(p_literal);
+	return grunt_stack_arg_push(p_vm, p_literal);
 		
 } /* grunt_vm_pushb() */
 
 
 int
-grunt_vm_pushn(const grunt_value_t *p_literal) {
+grunt_vm_pushn(grunt_vm_t *p_vm, const grunt_value_t *p_literal) {
 
 	/* PUSHN must have a number argument. */
 	if (p_literal->type != gt_num) return GRUNT_ERROR_INVALIDLITERAL;
 	
-	return grunt_stack_arg_push(p_literal);
+	return grunt_stack_arg_push(p_vm, p_literal);
 		
 } /* grunt_vm_pushn() */
 
 
 int
-grunt_vm_pushs(const grunt_value_t *p_literal) {
+grunt_vm_pushs(grunt_vm_t *p_vm, const grunt_value_t *p_literal) {
 
 	/* PUSHS must have a string argument. */
 	if (p_literal->type != gt_str) return GRUNT_ERROR_INVALIDLITERAL;
 	
-	return grunt_stack_arg_push(p_literal);
+	return grunt_stack_arg_push(p_vm, p_literal);
 		
 } /* grunt_vm_pushs() */
 
 
 int
-grunt_vm_roll(grunt_rep_t reps) {
+grunt_vm_roll(grunt_vm_t *p_vm, grunt_rep_t reps) {
 
 	/* The minimum number of reps is 2. */
 	if (reps < 2) return GRUNT_ERROR_INVALIDLITERAL;
 
-	return grunt_stack_arg_roll(reps);
+	return grunt_stack_arg_roll(p_vm, reps);
 	
 } /* grunt_vm_roll() */
+
+
+/* lookup_entry()
+ *
+ * in:     p_table  - a LOOKUP's table, or NULL
+ *         p_packed - if p_table is NULL, packed program holding it
+ *         table    - pc of first table entry
+ *         i        - index of entry in table
+ * out:    p_entry  - the entry
+ * return: nothing
+ */
+
+static void
+lookup_entry(const grunt_instruction_t *p_table,
+	const grunt_packed_program_t *p_packed, grunt_pc_t table, uint32 i,
+	grunt_instruction_t *p_entry) {
+
+	if (p_table) {
+		*p_entry = p_table[i];
+	} else {
+		grunt_pack_decode(p_packed, (grunt_pc_t)(table + i), p_entry);
+	}
+
+} /* lookup_entry() */
+
+
+/* grunt_vm_lookup()
+ *
+ * in:     p_vm             - VM running a LOOKUP, its pc at the
+ *                            LOOKUP's table
+ *         p_table          - the table, or NULL to decode it from
+ *                            p_packed
+ *         p_packed         - packed program holding the LOOKUP, if
+ *                            p_table is NULL
+ *         num_instructions - number of instructions in the program
+ *         reps             - number of key/string pairs in the table
+ * out:    p_vm             - key replaced by its string, pc past the
+ *                            table
+ * return: 0 on success, else a GRUNT_ERROR_* code.
+ *
+ * Runs the LOOKUP described in grunt.h.  We check the whole table
+ * before we touch the stack, so a bad table fails the same way
+ * whatever the key.
+ */
+
+int
+grunt_vm_lookup(grunt_vm_t *p_vm, const grunt_instruction_t *p_table,
+	const grunt_packed_program_t *p_packed, grunt_pc_t num_instructions,
+	grunt_rep_t reps) {
+
+	grunt_instruction_t entry;    /* current table entry */
+	grunt_value_t key;
+	grunt_pc_t table = p_vm->pc;  /* pc of first table entry */
+	uint32 last = 2 * (uint32)reps;  /* index of default string */
+	uint32 i;
+	int status;
+
+	/* The minimum number of reps is 1. */
+	if (reps < 1) return GRUNT_ERROR_INVALIDLITERAL;
+
+	if ((num_instructions < table) ||
+		!((uint32)(num_instructions - table) > last))
+		return GRUNT_ERROR_NOPROGRAM;  /* table runs off the end */
+
+	/* Keys at even indices, strings at odd ones and at last. */
+	for (i = 0; i <= last; i++) {
+		lookup_entry(p_table, p_packed, table, i, &entry);
+		if ((i & 1) || (i == last)) {
+			if ((entry.op != GRUNT_OP_PUSHS) ||
+				(entry.arg.lit.type != gt_str))
+				return GRUNT_ERROR_INVALIDLITERAL;
+		} else if ((entry.op != GRUNT_OP_PUSHN) ||
+			(entry.arg.lit.type != gt_num)) {
+			return GRUNT_ERROR_INVALIDLITERAL;
+		}
+	}
+
+	if ((status = grunt_stack_arg_pop(p_vm, &key))) return status;
+	if (key.type != gt_num) return GRUNT_ERROR_INVALIDARGUMENT;
+
+	for (i = 0; i < last; i += 2) {
+		lookup_entry(p_table, p_packed, table, i, &entry);
+		if (entry.arg.lit.val.num == key.val.num) break;
+	}
+	lookup_entry(p_table, p_packed, table, ((i < last) ? i + 1 : last),
+		&entry);
+
+	p_vm->pc = (grunt_pc_t)(table + last + 1);
+	return grunt_stack_arg_push(p_vm, &(entry.arg.lit));
+
+} /* grunt_vm_lookup() */
@@ -16,11 +16,16 @@
  * permissions and limitations under the License.
  */
 
-int grunt_vm_dup(grunt_rep_t);
-int grunt_vm_pop(grunt_value_t *, grunt_rep_t);
-int grunt_vm_pushb(const grunt_value_t *);
-int grunt_vm_pushn(const grunt_value_t *);
-int grunt_vm_pushs(const grunt_value_t *);
-int grunt_vm_roll(grunt_rep_t);
+void grunt_classify(grunt_payload_t *, grunt_number_t, grunt_rep_t);
+void grunt_classify_typed(grunt_value_t *, grunt_number_t, grunt_rep_t);
+int grunt_vm_classify(grunt_vm_t *, grunt_rep_t);
+int grunt_vm_dup(grunt_vm_t *, grunt_rep_t);
+int grunt_vm_lookup(grunt_vm_t *, const grunt_instruction_t *,
+	const grunt_packed_program_t *, grunt_pc_t, grunt_rep_t);
+int grunt_vm_pop(grunt_vm_t *, grunt_rep_t);
+int grunt_vm_pushb(grunt_vm_t *, const grunt_value_t *);
+int grunt_vm_pushn(grunt_vm_t *, const grunt_value_t *);
+int grunt_vm_pushs(grunt_vm_t *, const grunt_value_t *);
+int grunt_vm_roll(grunt_vm_t *, grunt_rep_t);
 
 #endif
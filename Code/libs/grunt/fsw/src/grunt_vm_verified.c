@@ -0,0 +1,360 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module implements the interpreter's fast path for programs
+ * that GRUNT_Verify() has verified.  The verifier has already proven
+ * that this program's literals are well-formed, that its CALL and
+ * JMPIF targets are forward and in range, that each END closes the
+ * innermost loop, that every instruction finds arguments of the
+ * right types on the arg stack, that the stacks never overflow, and
+ * that every path HALTs.  This engine therefore skips all of those
+ * run-time checks and works directly on its own local stacks.  It
+ * runs programs in the packed encoding described in grunt.h, which
+ * GRUNT_Verify() loads them into, and runs each superinstruction
+ * GRUNT_Pack() marked as a single operation.
+ *
+ * Since every instruction's argument types are proven, the engine's
+ * arg stack holds bare grunt_payload_t values, with no type tags to
+ * write or test.  Only OUTPUT and FORMAT care which type they have,
+ * and they take it from the tags grunt_pack_type() wrote into their
+ * words from the verifier's types.  Verified programs whose OUTPUTs or
+ * FORMATs get different types on different paths run on the checked
+ * engines instead.
+ *
+ * It still performs the checks that depend on the input data: the
+ * input queue's bounds checks, the arithmetic over/underflow checks,
+ * and the output queue's overflow checks.  It reports failures of
+ * these checks with the same status codes and program counter values
+ * as the checked engines.
+ *
+ * Never run an unverified program on this engine.
+ */
+
+#include "cfe.h"
+
+#include "grunt_status.h"
+#include "grunt.h"
+#include "grunt_input.h"
+#include "grunt_output.h"
+#include "grunt_verify.h"
+#include "grunt_vm_stack.h"
+#include "grunt_vm_verified.h"
+
+
+/* verified_number()
+ *
+ * in:     p_packed - packed program
+ *         w        - a PUSHN or EQN word
+ * out:    nothing
+ * return: the word's number literal.
+ */
+
+static grunt_number_t
+verified_number(const grunt_packed_program_t *p_packed, grunt_packed_t w) {
+
+	return ((GRUNT_PACKED_TAG(w) & GRUNT_PACKED_POOLED) ?
+		p_packed->pool[GRUNT_PACKED_OPERAND(w)] :
+		GRUNT_PACKED_OPERAND(w));
+
+} /* verified_number() */
+
+
+/* verified_format()
+ *
+ * in:     p_vm  - VM whose output queue to use
+ *         w     - a FORMAT word, its tag the types of its values
+ *         p_top - the FORMAT's template, its values below it
+ * out:    p_vm->output_queue - expanded template appended
+ * return: grunt_output_enqueue_format()'s status.
+ *
+ * Gives the values back the types the verifier proved they have.
+ */
+
+static int
+verified_format(grunt_vm_t *p_vm, grunt_packed_t w,
+	const grunt_payload_t *p_top) {
+
+	grunt_value_t values[GRUNT_FORMAT_MAX_VALUES];
+	grunt_rep_t n = GRUNT_PACKED_OPERAND(w);
+	grunt_rep_t i;
+
+	for (i = 0; i < n; i++) {
+		values[i].type = (grunt_value_type_t)GRUNT_VERIFY_FORMAT_TYPE(
+			GRUNT_PACKED_TAG(w), n - 1 - i);
+		values[i].val  = p_top[(int)i - (int)n];
+	}
+
+	return grunt_output_enqueue_format(p_vm, p_top->str, values, n);
+
+} /* verified_format() */
+
+
+/* grunt_vm_run_verified()
+ *
+ * in:     p_vm       - VM whose input and output queues to use
+ *         p_packed   - verified Grunt program to run, packed
+ * out:    *p_current - program counter of the last instruction
+ *                      fetched, for error reporting
+ * return: GRUNT_HALT_TRUE/FALSE or a GRUNT_ERROR_* status code.
+ */
+
+int
+grunt_vm_run_verified(grunt_vm_t *p_vm,
+	const grunt_packed_program_t *p_packed, grunt_pc_t *p_current) {
+
+	grunt_payload_t stack[GRUNT_STACK_SIZE];  /* the arg stack */
+	grunt_pc_t      ctl[GRUNT_STACK_SIZE];    /* the control stack */
+	int sp  = 0;                /* count of elements on arg stack */
+	int csp = 0;                /* count of elements on control stack */
+	const grunt_packed_t *code = p_packed->code;
+	grunt_packed_t w;           /* current instruction */
+	grunt_pc_t pc = 0;
+	grunt_payload_t *p_top;
+	grunt_boolean_t b;
+	grunt_number_t k;
+	grunt_rep_t n, i;
+	int status;
+
+	for (;;) {
+
+		*p_current = pc;
+		w = code[pc++];
+		p_top = &(stack[sp - 1]);
+
+		switch (GRUNT_PACKED_OP(w)) {
+		case GRUNT_OP_ADD:
+			if (p_top->num > (GRUNT_NUM_MAX - p_top[-1].num))
+				return GRUNT_ERROR_OUTOFBOUNDS;  /* overflow */
+			p_top[-1].num += p_top->num;
+			sp--;
+			break;
+		case GRUNT_OP_SUB:
+			if (p_top[-1].num < p_top->num)
+				return GRUNT_ERROR_OUTOFBOUNDS;  /* underflow */
+			p_top[-1].num -= p_top->num;
+			sp--;
+			break;
+		case GRUNT_OP_AND:
+		case GRUNT_OP_OR:
+			n = GRUNT_PACKED_OPERAND(w);
+			b = p_top->b;
+			for (i = 1; i < n; i++) {
+				b = ((GRUNT_PACKED_OP(w) == GRUNT_OP_AND) ?
+					b && p_top[-i].b :
+					b || p_top[-i].b);
+			}
+			sp -= (n - 1);
+			stack[sp - 1].b = b;
+			break;
+		case GRUNT_OP_EQ:
+			n = GRUNT_PACKED_OPERAND(w);
+			b = true;
+			for (i = 1; i < n; i++) {
+				if (p_top->num != p_top[-i].num) b = false;
+			}
+			sp -= (n - 1);
+			stack[sp - 1].b = b;
+			break;
+		case GRUNT_OP_GT:
+		case GRUNT_OP_LT:
+			b = ((GRUNT_PACKED_OP(w) == GRUNT_OP_LT) ?
+				p_top[-1].num < p_top->num :
+				p_top[-1].num > p_top->num);
+			sp--;
+			stack[sp - 1].b = b;
+			break;
+		case GRUNT_OP_NOT:
+			p_top->b = !p_top->b;
+			break;
+		case GRUNT_OP_DUP:
+			n = GRUNT_PACKED_OPERAND(w);
+			memcpy(&(stack[sp]), &(stack[sp - n]),
+				(n * sizeof(grunt_payload_t)));
+			sp += n;
+			break;
+		case GRUNT_OP_POP:
+			sp -= GRUNT_PACKED_OPERAND(w);
+			break;
+		case GRUNT_OP_ROLL:
+			{
+				grunt_payload_t temp = *p_top;
+				n = GRUNT_PACKED_OPERAND(w);
+				memmove(&(stack[sp - n + 1]), &(stack[sp - n]),
+					((n - 1) * sizeof(grunt_payload_t)));
+				stack[sp - n] = temp;
+			}
+			break;
+		case GRUNT_OP_PUSHB:
+			stack[sp].b = (GRUNT_PACKED_OPERAND(w) != 0);
+			sp++;
+			break;
+		case GRUNT_OP_PUSHN:
+			stack[sp].num = verified_number(p_packed, w);
+			sp++;
+			break;
+		case GRUNT_OP_PUSHS:
+			stack[sp].str = GRUNT_PACKED_OPERAND(w);
+			sp++;
+			break;
+		case GRUNT_OP_INPUT:
+			if ((status = grunt_input_dequeue(p_vm, &(stack[sp]),
+				GRUNT_PACKED_OPERAND(w))))
+				return status;
+			sp++;
+			break;
+		case GRUNT_OP_INPUTREC:
+			{
+				int fields;
+				if ((status = grunt_input_record(p_vm,
+					&(stack[sp]), &fields,
+					GRUNT_PACKED_OPERAND(w))))
+					return status;
+				sp += fields;
+			}
+			break;
+		case GRUNT_OP_INPUTZ:
+			if ((status = grunt_input_zero(p_vm, &(stack[sp]),
+				GRUNT_PACKED_OPERAND(w))))
+				return status;
+			sp++;
+			break;
+		case GRUNT_OP_REWIND:
+			if ((status = grunt_input_rewind(p_vm,
+				GRUNT_PACKED_OPERAND(w))))
+				return status;
+			break;
+		case GRUNT_OP_OUTPUT:
+			sp--;
+			switch (GRUNT_PACKED_TAG(w)) {
+			case gt_bool:
+				status = grunt_output_enqueue_boolean(p_vm,
+					p_top->b);
+				break;
+			case gt_num:
+				status = grunt_output_enqueue_number(p_vm,
+					p_top->num);
+				break;
+			default:
+				status = grunt_output_enqueue_string(p_vm,
+					p_top->str);
+				break;
+			}
+			if (status) return status;
+			break;
+		case GRUNT_OP_FORMAT:
+			if ((status = verified_format(p_vm, w, p_top)))
+				return status;
+			sp -= GRUNT_PACKED_OPERAND(w) + 1;
+			break;
+		case GRUNT_OP_CLASSIFY:
+			/* The key's slot becomes the row's bottom. */
+			grunt_classify(p_top, p_top->num,
+				GRUNT_PACKED_OPERAND(w));
+			sp += 3;
+			break;
+		case GRUNT_OP_FLUSH:
+			grunt_output_flush(p_vm, p_top->num, p_top[-1].num);
+			sp -= 2;
+			break;
+		case GRUNT_OP_HALT:
+			return (p_top->b ? GRUNT_HALT_TRUE : GRUNT_HALT_FALSE);
+		case GRUNT_OP_JMPIF:
+			sp--;
+			if (p_top->b) pc += (GRUNT_PACKED_OPERAND(w) - 1);
+			break;
+		case GRUNT_OP_CALL:
+			ctl[csp++] = pc;
+			pc = GRUNT_PACKED_OPERAND(w);
+			break;
+		case GRUNT_OP_RETURN:
+			pc = ctl[--csp];
+			break;
+		case GRUNT_OP_REPEAT:
+			/* The body's pc, then the count of runs left. */
+			ctl[csp++] = pc;
+			ctl[csp++] = GRUNT_PACKED_OPERAND(w);
+			break;
+		case GRUNT_OP_END:
+			if (--ctl[csp - 1]) {
+				pc = ctl[csp - 2];
+			} else {
+				csp -= 2;
+			}
+			break;
+		case GRUNT_OP_LOOKUP:
+			/* Pairs of PUSHN k; PUSHS s words, then PUSHS d. */
+			n = GRUNT_PACKED_OPERAND(w);
+			k = p_top->num;
+			for (i = 0; i < n; i++, pc += 2) {
+				if (verified_number(p_packed, code[pc]) == k)
+					break;
+			}
+			p_top->str = GRUNT_PACKED_OPERAND(code[pc +
+				((i < n) ? 1 : 0)]);
+			pc += (2 * (n - i)) + 1;
+			break;
+		case GRUNT_OP_SWITCH:
+			/* n JMPIF l words; entry k jumps l past itself. */
+			n = GRUNT_PACKED_OPERAND(w);
+			k = p_top->num;
+			sp--;
+			pc += ((k < n) ?
+				(k + GRUNT_PACKED_OPERAND(code[pc + k])) : n);
+			break;
+		case GRUNT_OP_EQN:
+			/* PUSHN k; EQ(n): compare top n - 1 to k. */
+			k = verified_number(p_packed, w);
+			n = GRUNT_PACKED_OPERAND(code[pc++]);
+			b = true;
+			for (i = 0; i < (n - 1); i++) {
+				if (p_top[-i].num != k) b = false;
+			}
+			sp -= (n - 2);
+			stack[sp - 1].b = b;
+			break;
+		case GRUNT_OP_DUPEQN:
+			/* DUP(1); PUSHN k; EQ(2) */
+			stack[sp].b =
+				(p_top->num == verified_number(p_packed,
+					code[pc]));
+			sp++;
+			pc += 2;
+			break;
+		case GRUNT_OP_NOTJMPIF:
+			/* NOT; JMPIF l: jump if the top is false. */
+			w = code[pc++];
+			sp--;
+			if (!p_top->b) pc += (GRUNT_PACKED_OPERAND(w) - 1);
+			break;
+		case GRUNT_OP_INPUTLTN:
+		case GRUNT_OP_INPUTGTN:
+			/* INPUT(n); PUSHN k; LT or GT */
+			if ((status = grunt_input_dequeue(p_vm, &(stack[sp]),
+				GRUNT_PACKED_OPERAND(w))))
+				return status;
+			k = verified_number(p_packed, code[pc]);
+			stack[sp].b =
+				((GRUNT_PACKED_OP(w) == GRUNT_OP_INPUTLTN) ?
+				stack[sp].num < k :
+				stack[sp].num > k);
+			sp++;
+			pc += 2;
+			break;
+		default:
+			return GRUNT_ERROR_INTERPRETERBUG;  /* verifier bug */
+		}
+	}
+
+} /* grunt_vm_run_verified() */
@@ -0,0 +1,301 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module implements libvs_host's interface, declared in
+ * vs_host.h, and the host platform under it: the cFS calls the Grunt
+ * library and the VS validation functions make, declared by the
+ * benchmark's stub/cfe.h.  As in the benchmark's bench_stubs.c,
+ * CFE_TBL_Register() keeps the validation function it's given so that
+ * VS_host_validate() can call it just as TBL would.  Here,
+ * CFE_EVS_SendEvent() formats each event and hands it to the caller's
+ * VS_host_event_func_t instead of counting it.  No other platform
+ * service does anything the validators can see: semaphores need no
+ * locking with one caller at a time, the clock stands still, and
+ * there are no files.
+ */
+
+#include <stdarg.h>
+
+#include "cfe.h"
+
+#include "grunt.h"
+
+#include "vs_msgstruct.h"
+#include "vs_tablestruct.h"
+#include "vsc_msgstruct.h"    /* for vsc_table.h */
+#include "vsa_table.h"
+#include "vsb_table.h"
+#include "vsc_table.h"
+
+#include "vs_host.h"
+
+#define VS_HOST_NUM_APPS 3
+
+/* Each app's validation function, as its table init function
+ * registered it.  Set once VS_host_init() succeeds.
+ */
+static CFE_TBL_CallbackFuncPtr_t vs_host_validators[VS_HOST_NUM_APPS];
+static bool vs_host_initialized = false;
+
+/* The validation function CFE_TBL_Register() last registered. */
+static CFE_TBL_CallbackFuncPtr_t vs_host_registered = NULL;
+
+/* Where CFE_EVS_SendEvent() sends events during VS_host_validate(). */
+static VS_host_event_func_t vs_host_event_func = NULL;
+static void *vs_host_event_arg = NULL;
+
+/* VS_host_validate() copies each image here, into storage aligned
+ * for the table, as TBL does into its inactive buffer.
+ */
+static vs_table_t vs_host_image;
+
+
+/* ---------------- The host platform ---------------- */
+
+CFE_Status_t
+CFE_EVS_SendEvent(uint16 event_id, uint16 event_type, const char *spec,
+	...) {
+
+	char message[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH];
+	va_list args;
+
+	if (vs_host_event_func) {
+		va_start(args, spec);
+		vsnprintf(message, sizeof(message), spec, args);
+		va_end(args);
+		vs_host_event_func(vs_host_event_arg, event_id, event_type,
+			message);
+	}
+	return CFE_SUCCESS;
+
+} /* CFE_EVS_SendEvent() */
+
+
+void
+CFE_ES_PerfLogEntry(uint32 marker) {
+	(void)marker;
+} /* CFE_ES_PerfLogEntry() */
+
+
+void
+CFE_ES_PerfLogExit(uint32 marker) {
+	(void)marker;
+} /* CFE_ES_PerfLogExit() */
+
+
+void
+CFE_PSP_GetTime(OS_time_t *p_time) {
+	p_time->ticks = 0;
+} /* CFE_PSP_GetTime() */
+
+
+int32
+CFE_ES_WriteToSysLog(const char *spec, ...) {
+
+	va_list args;
+
+	va_start(args, spec);
+	vfprintf(stderr, spec, args);
+	va_end(args);
+	return CFE_SUCCESS;
+
+} /* CFE_ES_WriteToSysLog() */
+
+
+int32
+OS_MutSemCreate(osal_id_t *p_id, const char *name, uint32 options) {
+
+	(void)name;
+	(void)options;
+	*p_id = 1;
+	return OS_SUCCESS;
+
+} /* OS_MutSemCreate() */
+
+
+int32
+OS_MutSemTake(osal_id_t id) {
+	(void)id;
+	return OS_SUCCESS;
+} /* OS_MutSemTake() */
+
+
+int32
+OS_MutSemGive(osal_id_t id) {
+	(void)id;
+	return OS_SUCCESS;
+} /* OS_MutSemGive() */
+
+
+int32
+OS_OpenCreate(osal_id_t *p_id, const char *path, int32 flags,
+	int32 access) {
+
+	(void)p_id;
+	(void)path;
+	(void)flags;
+	(void)access;
+	return -1;   /* OS_ERROR */
+
+} /* OS_OpenCreate() */
+
+
+int32
+OS_read(osal_id_t id, void *p_buf, size_t len) {
+
+	(void)id;
+	(void)p_buf;
+	(void)len;
+	return -1;   /* OS_ERROR */
+
+} /* OS_read() */
+
+
+int32
+OS_close(osal_id_t id) {
+	(void)id;
+	return OS_SUCCESS;
+} /* OS_close() */
+
+
+int32
+CFE_FS_ReadHeader(CFE_FS_Header_t *p_hdr, osal_id_t id) {
+
+	(void)p_hdr;
+	(void)id;
+	return -1;   /* OS_ERROR */
+
+} /* CFE_FS_ReadHeader() */
+
+
+CFE_Status_t
+CFE_TBL_Register(CFE_TBL_Handle_t *p_handle, const char *name,
+	size_t size, uint16 options, CFE_TBL_CallbackFuncPtr_t validate) {
+
+	(void)name;
+	(void)size;
+	(void)options;
+	*p_handle = 0;
+	vs_host_registered = validate;
+	return CFE_SUCCESS;
+
+} /* CFE_TBL_Register() */
+
+
+CFE_Status_t
+CFE_TBL_Load(CFE_TBL_Handle_t handle, int source, const void *p_source) {
+
+	(void)handle;
+	(void)source;
+	(void)p_source;
+	return CFE_SUCCESS;
+
+} /* CFE_TBL_Load() */
+
+
+/* ---------------- Functions exported by this module ---------------- */
+
+/* VS_host_init()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: 0 on success, else VS_HOST_ERROR
+ *
+ * Initializes the Grunt library as ES would and each app's table as
+ * the app would, keeping the validation function each registers.
+ * Calls after the first do nothing; if the first fails, so do the
+ * validation functions it didn't get to.
+ *
+ */
+
+int
+VS_host_init(void) {
+
+	static CFE_Status_t (* const table_inits[VS_HOST_NUM_APPS])(
+		CFE_TBL_Handle_t *) = {
+		[VS_HOST_VSA] = VSA_table_init,
+		[VS_HOST_VSB] = VSB_table_init,
+		[VS_HOST_VSC] = VSC_table_init,
+	};
+	CFE_TBL_Handle_t handle;   /* the handle TBL would give the app */
+	unsigned int app;          /* indexes apps */
+
+	if (vs_host_initialized) return 0;
+	vs_host_initialized = true;
+
+	if (CFE_SUCCESS != GRUNT_Init()) return VS_HOST_ERROR;
+	for (app = 0; app < VS_HOST_NUM_APPS; app++) {
+		vs_host_registered = NULL;
+		if ((CFE_SUCCESS != table_inits[app](&handle)) ||
+			!vs_host_registered) return VS_HOST_ERROR;
+		vs_host_validators[app] = vs_host_registered;
+	}
+
+	return 0;
+
+} /* VS_host_init() */
+
+
+/* VS_host_image_size()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: the size in bytes of the table images VS_host_validate()
+ *         takes, as this build of the library lays them out.
+ *
+ */
+
+size_t
+VS_host_image_size(void) {
+
+	return sizeof(vs_table_t);
+
+} /* VS_host_image_size() */
+
+
+/* VS_host_validate()
+ *
+ * in:     app        - VS_HOST_VSA, VS_HOST_VSB, or VS_HOST_VSC
+ *         p_image    - VS_host_image_size() bytes of table image
+ *         event_func - called with each event; may be NULL
+ *         p_arg      - passed to event_func
+ * out:    nothing
+ * return: VS_HOST_VALID, VS_HOST_INVALID, or VS_HOST_ERROR
+ *
+ * Runs app's validation function on a copy of *p_image, just as TBL
+ * would run it aboard, and reports whether the app would load the
+ * image.
+ *
+ */
+
+int
+VS_host_validate(unsigned int app, const void *p_image,
+	VS_host_event_func_t event_func, void *p_arg) {
+
+	int32 result;   /* the validation function's result */
+
+	if ((app >= VS_HOST_NUM_APPS) || !vs_host_validators[app] ||
+		!p_image) return VS_HOST_ERROR;
+
+	memcpy(&vs_host_image, p_image, sizeof(vs_host_image));
+	vs_host_event_func = event_func;
+	vs_host_event_arg  = p_arg;
+	result = vs_host_validators[app](&vs_host_image);
+	vs_host_event_func = NULL;
+	vs_host_event_arg  = NULL;
+
+	return (result == CFE_SUCCESS) ? VS_HOST_VALID : VS_HOST_INVALID;
+
+} /* VS_host_validate() */
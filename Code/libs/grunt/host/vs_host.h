@@ -0,0 +1,62 @@
+#ifndef _VS_HOST_H_
+#define _VS_HOST_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* The interface of libvs_host, a host shared library of the Grunt
+ * library and the VSA, VSB, and VSC validation functions, for ground
+ * software that checks table images before uplink.  It needs no cFS
+ * headers; the library's own build supplies the cFS calls the
+ * validators make.
+ *
+ * Call VS_host_init() once, then VS_host_validate() on each image.
+ * The validators keep static state, as they do aboard, so only one
+ * thread may call into the library at a time.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define VS_HOST_API __attribute__((visibility("default")))
+#else
+#define VS_HOST_API
+#endif
+
+/* The validation functions VS_host_validate() can run. */
+#define VS_HOST_VSA 0
+#define VS_HOST_VSB 1
+#define VS_HOST_VSC 2
+
+/* VS_host_validate() results. */
+#define VS_HOST_VALID    0
+#define VS_HOST_INVALID  1
+#define VS_HOST_ERROR   (-1)   /* bad app, or not initialized */
+
+/* VS_host_validate() calls a VS_host_event_func_t with each event the
+ * validation function sends, as it sends it, along with the p_arg
+ * given to VS_host_validate().  The message is NUL-terminated and
+ * truncated as EVS would truncate it.
+ */
+typedef void (*VS_host_event_func_t)(void *p_arg, uint16_t event_id,
+	uint16_t event_type, const char *message);
+
+VS_HOST_API int VS_host_init(void);
+VS_HOST_API size_t VS_host_image_size(void);
+VS_HOST_API int VS_host_validate(unsigned int, const void *,
+	VS_host_event_func_t, void *);
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef _VS_APP_H_
+#define _VS_APP_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* The VS_APP library holds the main loop, initialization, and command
+ * handling the VSA, VSB, and VSC apps share.  Each app describes
+ * itself with a constant VS_app_config_t, keeps a VS_app_t for its
+ * runtime state, and calls VS_app_Main() from its own entry point.
+ * The library runs in the calling app's task, so the events it sends
+ * and the pipe it reads are the app's own.
+ *
+ * The library handles the NOOP, RESET_COUNTERS, and STAGE ground
+ * commands every VS app has, the DUMP_CYCLES command of apps built
+ * with VS_CYCLE_HISTOGRAM, and the SCREEN command of apps that can
+ * screen, using the command codes below, and hands any other ground
+ * command to the app's command function.
+ */
+
+#include "cfe.h"
+#include "common_types.h"
+
+#include "vs_msgstruct.h"
+#include "vs_tablestruct.h"
+
+#define VS_APP_NOOP_CC            1   /* each app's VS?_NOOP_CC */
+#define VS_APP_RESET_COUNTERS_CC  2   /* each app's VS?_RESET_COUNTERS_CC */
+#define VS_APP_DUMP_CYCLES_CC     6   /* each app's VS?_DUMP_CYCLES_CC */
+#define VS_APP_STAGE_CC           8   /* each app's VS?_STAGE_CC */
+#define VS_APP_SCREEN_CC          9   /* each app's VS?_SCREEN_CC */
+
+typedef struct {
+	const char *app_name;        /* VS?_APP_NAME */
+	const char *version_string;  /* VS?_APP_VERSION_STRING */
+	const char *pipe_name;       /* name of the app's command pipe */
+	uint16 pipe_depth;           /* max pending messages on the pipe */
+	uint16 pipe_batch;           /* most messages handled per wake-up */
+	CFE_SB_MsgId_Atom_t cmd_mid;         /* ground commands */
+	CFE_SB_MsgId_Atom_t send_hk_mid;     /* send housekeeping commands */
+	CFE_SB_MsgId_Atom_t tlm_hk_mid;      /* housekeeping telemetry */
+	bool                tbl_notify;      /* have TBL notify us? */
+	CFE_SB_MsgId_Atom_t tbl_notify_mid;  /* TBL notifications */
+	uint32 all_perf_id;          /* VS?_ALL_PERF_ID */
+	uint32 hk_perf_id;           /* VS?_HK_PERF_ID */
+
+	/* Registers the app's table and its validation function with
+	 * TBL and loads the default table, as VSA_table_init() does.
+	 */
+	CFE_Status_t (*table_init)(CFE_TBL_Handle_t *p_h_table);
+
+	/* Copy and clear the app's validation statistics. */
+	void (*get_stats)(VS_vstats_t *p_stats);
+	void (*reset_stats)(void);
+
+	/* Sends the app's cycle histogram in a VS_tlm_cycles_t
+	 * message.  NULL if the app keeps none.
+	 */
+	void (*dump_cycles)(void);
+
+	/* Decides whether a table image is valid as the app's
+	 * validation function would, stopping at the first problem and
+	 * sending no events.  NULL if the app can't screen.
+	 */
+	bool (*screen)(const vs_table_t *p_image);
+
+	/* Handles the ground commands other than NOOP and
+	 * RESET_COUNTERS, returning CFE_SUCCESS or the EID of the
+	 * error it reported.  It returns VS_MSG_BAD_CC_ERR_EID without
+	 * reporting it for command codes it doesn't know, so the
+	 * library can.  NULL if the app has no other commands.
+	 */
+	CFE_Status_t (*command)(CFE_MSG_Message_t *p_cmd_msg,
+		CFE_MSG_FcnCode_t cc);
+
+	/* Does any app-specific work on each housekeeping cycle, after
+	 * CFE_TBL_Manage() and before the housekeeping telemetry goes
+	 * out, and fills in any app-specific telemetry fields, such as
+	 * engine.  NULL if the app has none.
+	 */
+	void (*housekeeping)(VS_tlm_hk_payload_t *p_hk);
+} VS_app_config_t;
+
+/* An app's runtime state.  cFS apps traditionally keep their command
+ * counters directly in their housekeeping telemetry message, and so
+ * do these.
+ */
+typedef struct {
+	const VS_app_config_t *p_config;
+	CFE_SB_PipeId_t  cmd_pipe;    /* we read commands from this pipe */
+	CFE_TBL_Handle_t h_table;     /* handle to TBL-managed table */
+	VS_tlm_hk_t      msg_tlm_hk;  /* housekeeping telemetry message */
+
+	/* The staging pool, a ring of images STAGE commands have read
+	 * and housekeeping has yet to load, and the files they came
+	 * from.  See VS_STAGE_SLOTS in vs_msgstruct.h.
+	 */
+	vs_table_t stage_images[VS_STAGE_SLOTS];
+	char       stage_names[VS_STAGE_SLOTS][CFE_MISSION_MAX_PATH_LEN];
+	uint8      stage_first;       /* slot of the oldest staged image */
+	uint8      stage_count;       /* images staged */
+} VS_app_t;
+
+int32 VS_app_Init(void);
+void  VS_app_Main(VS_app_t *);
+
+#endif
@@ -0,0 +1,827 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * This file defines the VS_APP library's entry point and the
+ * initialization routines, command handling, and runloop the VS apps
+ * share.  Every function but VS_app_Init() runs in the task of the
+ * app whose VS_app_t it is given.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cfe.h"
+#include "common_types.h"
+#include "osapi.h"
+
+#include "vs_msgstruct.h"
+#include "vs_tablestruct.h"
+#include "vs_eventids.h"
+
+#include "vs_app.h"
+#include "vs_app_version.h"
+
+
+/* ---------------- Module local state and functions ---------------- */
+
+static void
+vs_app_reset_diagnostic_counters(VS_app_t *p_app) {
+	p_app->msg_tlm_hk.payload.ctr_cmd_ok    = 0;
+	p_app->msg_tlm_hk.payload.ctr_cmd_error = 0;
+	p_app->msg_tlm_hk.payload.ctr_batched   = 0;
+	p_app->msg_tlm_hk.payload.max_batch     = 0;
+	p_app->p_config->reset_stats();
+} /* vs_app_reset_diagnostic_counters() */
+
+
+/* vs_app_lap_us()
+ *
+ * in:     p_mark - time the phase being timed began
+ * out:    p_mark - set to the time now, when the next phase begins
+ * return: microseconds since *p_mark, at most 0xFFFFFFFF
+ *
+ * Times vs_app_init()'s phases for its startup event.
+ *
+ */
+
+static uint32
+vs_app_lap_us(OS_time_t *p_mark) {
+
+	OS_time_t now;    /* time the phase ended */
+	int64 us;         /* microseconds since *p_mark */
+
+	CFE_PSP_GetTime(&now);
+	us = OS_TimeGetTotalMicroseconds(OS_TimeSubtract(now, *p_mark));
+	*p_mark = now;
+	return (us < 0) ? 0 : ((us > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32)us);
+
+} /* vs_app_lap_us() */
+
+
+/* vs_app_init()
+ *
+ * in:     p_app - app to initialize, p_config set
+ * out:    p_app - updated to reflect initialization described below
+ * return: CFE_SUCCESS if initialization goes well, otherwise CFE
+ *         error codes.
+ *
+ * This function follows the traditional CFS App initialization
+ * pattern: it prepares the app to receive ground and housekeeping
+ * commands, initializes its table, and fills in the constant fields
+ * of its template telemetry message.
+ *
+ * Its startup event reports how many microseconds it spent in all
+ * and in each phase: registering with EVS, creating its pipe and
+ * subscribing, and initializing its table, which includes the first
+ * run of the validation function on the default table, reported on
+ * its own as VF.
+ *
+ */
+
+static CFE_Status_t
+vs_app_init(VS_app_t *p_app) {
+
+	const VS_app_config_t *p_config = p_app->p_config;
+	CFE_Status_t result;  /* holds error codes returned by functions */
+	OS_time_t mark;       /* time the current phase began */
+	uint32 evs_us, sb_us, tbl_us;  /* time each phase took */
+	VS_vstats_t stats;    /* the default table's validation time */
+
+	CFE_PSP_GetTime(&mark);
+
+	/* Initialize our housekeeping telemetry message.  This clears
+	 * the diagnostic counters in its payload area to zero.
+	 *
+	 * Note that we don't need to clear our counters by calling
+	 * our vs_app_reset_diagnostic_counters() function here because
+	 * CFE_MSG_Init() zeroes the entire message.
+	 */
+
+	CFE_MSG_Init(CFE_MSG_PTR(p_app->msg_tlm_hk.header),
+		CFE_SB_ValueToMsgId(p_config->tlm_hk_mid),
+		sizeof(VS_tlm_hk_t));
+
+	/* Register with EVS.  Specify no event filter.  Even though
+	 * we're not specifying a filter, we must specify the
+	 * CFE_EVS_EventFilter_BINARY type or the present EVS
+	 * implementation will report CFE_EVS_UNKNOWN_FILTER.
+	 */
+	if (CFE_SUCCESS != (result = CFE_EVS_Register(NULL, 0,
+		CFE_EVS_EventFilter_BINARY))) {
+		CFE_ES_WriteToSysLog("%s: CFE_EVS_Register() returned 0x%08X"
+			"; %s will shutdown.\n", p_config->app_name, result,
+			p_config->app_name);
+		return result;
+	}
+	evs_us = vs_app_lap_us(&mark);
+
+	/* Create SB pipe for receiving commands. */
+	if (CFE_SUCCESS != (result = CFE_SB_CreatePipe(&(p_app->cmd_pipe),
+		p_config->pipe_depth, p_config->pipe_name))) {
+		CFE_ES_WriteToSysLog("%s: CFE_SB_CreatePipe() returned 0x%08X"
+			"; %s will shutdown.\n", p_config->app_name, result,
+			p_config->app_name);
+		return result;
+	}
+
+	/* Subscribe to ground command messages. */
+	if (CFE_SUCCESS != (result = CFE_SB_Subscribe(
+		CFE_SB_ValueToMsgId(p_config->cmd_mid), p_app->cmd_pipe))) {
+		CFE_ES_WriteToSysLog("%s: CFE_SB_Subscribe() returned 0x%08X"
+			"; %s App will shutdown.\n", p_config->app_name,
+			result, p_config->app_name);
+		return result;
+	}
+
+	/* Subscribe to housekeeping command messages. */
+	if (CFE_SUCCESS != (result = CFE_SB_Subscribe(
+		CFE_SB_ValueToMsgId(p_config->send_hk_mid), p_app->cmd_pipe))) {
+		CFE_ES_WriteToSysLog("%s: CFE_SB_Subscribe() returned 0x%08X"
+			"; %s will shutdown.\n", p_config->app_name, result,
+			p_config->app_name);
+		return result;
+	}
+	sb_us = vs_app_lap_us(&mark);
+
+	if (CFE_SUCCESS != (result = p_config->table_init(&(p_app->h_table)))) {
+		/* No need to CFE_ES_WriteToSysLog() an error message
+		 * here; the app's table init function will already
+		 * have written a specific error message to the log.
+		 */
+		return result;
+	}
+
+	/* Have TBL tell us of validation requests and pending loads
+	 * with a message on our command pipe, so that we can manage
+	 * the table right away rather than on our next housekeeping
+	 * cycle.
+	 */
+	if (p_config->tbl_notify) {
+		if (CFE_SUCCESS != (result = CFE_SB_Subscribe(
+			CFE_SB_ValueToMsgId(p_config->tbl_notify_mid),
+			p_app->cmd_pipe))) {
+			CFE_ES_WriteToSysLog("%s: CFE_SB_Subscribe() returned "
+				"0x%08X; %s will shutdown.\n",
+				p_config->app_name, result,
+				p_config->app_name);
+			return result;
+		}
+		if (CFE_SUCCESS != (result = CFE_TBL_NotifyByMessage(
+			p_app->h_table,
+			CFE_SB_ValueToMsgId(p_config->tbl_notify_mid), 0, 0))) {
+			CFE_ES_WriteToSysLog("%s: CFE_TBL_NotifyByMessage() "
+				"returned 0x%08X; %s will shutdown.\n",
+				p_config->app_name, result,
+				p_config->app_name);
+			return result;
+		}
+	}
+	tbl_us = vs_app_lap_us(&mark);
+
+	/* Report our successfull initialization. */
+	p_config->get_stats(&stats);
+	CFE_EVS_SendEvent(VS_STARTUP_OK_INF_EID,
+		CFE_EVS_EventType_INFORMATION,
+		"%s initialized in %lu us (EVS %lu, SB %lu, TBL %lu, VF %lu)"
+		", awaiting enable",
+		p_config->version_string,
+		(unsigned long)evs_us + sb_us + tbl_us,
+		(unsigned long)evs_us, (unsigned long)sb_us,
+		(unsigned long)tbl_us, (unsigned long)(stats.last_ns / 1000));
+
+	return CFE_SUCCESS;
+
+} /* vs_app_init() */
+
+
+/* vs_app_be32()
+ *
+ * in:     big_endian - 32-bit value as stored in big-endian byte order
+ * out:    nothing
+ * return: big_endian in host byte order.
+ */
+
+static uint32
+vs_app_be32(uint32 big_endian) {
+
+	const uint8 *p = (const uint8 *)&big_endian;
+
+	return (((uint32)p[0] << 24) | ((uint32)p[1] << 16) |
+		((uint32)p[2] << 8) | (uint32)p[3]);
+
+} /* vs_app_be32() */
+
+
+/* vs_app_read_image()
+ *
+ * in:     p_app    - app whose table the file should hold
+ *         filename - table file to read
+ * out:    p_image  - set to the table image the file holds
+ * return: true if *p_image holds the file's image, false if we can't
+ *         open the file or it isn't a whole-table image of the app's
+ *         table.
+ *
+ * Reads a table file in the same format TBL loads: a cFE file header,
+ * a TBL table file header, and the table image.  VSC_table_read_image()
+ * reads VSC's golden images the same way.
+ */
+
+static bool
+vs_app_read_image(const VS_app_t *p_app, const char *filename,
+	vs_table_t *p_image) {
+
+	char table_name[CFE_MISSION_TBL_MAX_FULL_NAME_LEN];
+	CFE_FS_Header_t    fs_hdr;   /* cFE file header */
+	CFE_TBL_File_Hdr_t tbl_hdr;  /* TBL table file header */
+	osal_id_t fd;                /* open table file */
+	bool result = false;         /* presume not an image */
+
+	snprintf(table_name, sizeof(table_name), "%s.%s",
+		p_app->p_config->app_name, VS_RAW_TABLE_NAME);
+
+	if (OS_SUCCESS != OS_OpenCreate(&fd, filename, OS_FILE_FLAG_NONE,
+		OS_READ_ONLY))
+		return false;
+
+	/* CFE_FS_ReadHeader() converts the cFE file header to host
+	 * byte order for us, but TBL table file headers are always
+	 * big-endian.  We accept only images of the whole table.
+	 */
+	if (((int32)sizeof(fs_hdr) == CFE_FS_ReadHeader(&fs_hdr, fd)) &&
+		(fs_hdr.SubType == CFE_FS_SubType_TBL_IMG) &&
+		((int32)sizeof(tbl_hdr) == OS_read(fd, &tbl_hdr,
+			sizeof(tbl_hdr))) &&
+		(0 == vs_app_be32(tbl_hdr.Offset)) &&
+		(sizeof(vs_table_t) == vs_app_be32(tbl_hdr.NumBytes)) &&
+		(0 == strncmp(tbl_hdr.TableName, table_name,
+			sizeof(tbl_hdr.TableName))) &&
+		((int32)sizeof(vs_table_t) == OS_read(fd, p_image,
+			sizeof(vs_table_t)))) {
+		result = true;
+	}
+
+	OS_close(fd);
+	return result;
+
+} /* vs_app_read_image() */
+
+
+/* vs_app_stage()
+ *
+ * in:     p_app     - app receiving the command
+ *         p_cmd_msg - STAGE ground command message
+ * out:    p_app     - image added to the staging pool
+ * return: CFE_SUCCESS if the image is staged, otherwise the EID of
+ *         the error reported.
+ *
+ * Reads the table file the command names into the next free slot of
+ * the app's staging pool, for vs_app_load_staged() to load on the
+ * next housekeeping cycle.  The pool lets the ground stage the next
+ * image while TBL is still busy with the last.
+ */
+
+static CFE_Status_t
+vs_app_stage(VS_app_t *p_app, CFE_MSG_Message_t *p_cmd_msg) {
+
+	const VS_app_config_t *p_config = p_app->p_config;
+	const VS_cmd_stage_payload_t *p_payload;
+	CFE_MSG_Size_t msg_size;  /* command's length */
+	unsigned int slot;        /* pool slot to stage into */
+
+	CFE_MSG_GetSize(p_cmd_msg, &msg_size);
+	p_payload = &(((const VS_cmd_stage_t *)p_cmd_msg)->payload);
+	if ((msg_size != sizeof(VS_cmd_stage_t)) ||
+		(NULL == memchr(p_payload->filename, '\0',
+			sizeof(p_payload->filename)))) {
+		CFE_EVS_SendEvent(VS_CMD_BAD_ARG_ERR_EID,
+			CFE_EVS_EventType_ERROR,
+			"%s: malformed stage command.", p_config->app_name);
+		return VS_CMD_BAD_ARG_ERR_EID;
+	}
+
+	if (p_app->stage_count == VS_STAGE_SLOTS) {
+		CFE_EVS_SendEvent(VS_STAGE_ERR_EID, CFE_EVS_EventType_ERROR,
+			"%s: can't stage %s, staging pool full.",
+			p_config->app_name, p_payload->filename);
+		return VS_STAGE_ERR_EID;
+	}
+
+	slot = (p_app->stage_first + p_app->stage_count) % VS_STAGE_SLOTS;
+	if (!vs_app_read_image(p_app, p_payload->filename,
+		&(p_app->stage_images[slot]))) {
+		CFE_EVS_SendEvent(VS_STAGE_ERR_EID, CFE_EVS_EventType_ERROR,
+			"%s: can't stage %s, not an image of %s.%s.",
+			p_config->app_name, p_payload->filename,
+			p_config->app_name, VS_RAW_TABLE_NAME);
+		return VS_STAGE_ERR_EID;
+	}
+
+	strncpy(p_app->stage_names[slot], p_payload->filename,
+		sizeof(p_app->stage_names[slot]));
+	p_app->stage_count++;
+
+	CFE_EVS_SendEvent(VS_STAGE_INF_EID, CFE_EVS_EventType_INFORMATION,
+		"%s: staged %s.", p_config->app_name, p_payload->filename);
+	return CFE_SUCCESS;
+
+} /* vs_app_stage() */
+
+
+/* vs_app_screen()
+ *
+ * in:     p_app     - app receiving the command
+ *         p_cmd_msg - SCREEN ground command message
+ * out:    nothing
+ * return: CFE_SUCCESS if the command is well-formed, otherwise the EID
+ *         of the error reported.
+ *
+ * Reads each table file the command names and hands its image to the
+ * app's screening function, then sends a single VS_SCREEN_INF_EID
+ * event reporting which images would validate and which files
+ * couldn't be read.  Screening sends no other events, and it changes
+ * neither the app's table nor its validation statistics.
+ */
+
+static CFE_Status_t
+vs_app_screen(VS_app_t *p_app, CFE_MSG_Message_t *p_cmd_msg) {
+
+	static vs_table_t image;  /* image read; too big for the stack */
+	const VS_app_config_t *p_config = p_app->p_config;
+	const VS_cmd_screen_payload_t *p_payload;
+	CFE_MSG_Size_t msg_size;        /* command's length */
+	uint8 valid_mask = 0;           /* bit i set if file i is valid */
+	uint8 unreadable_mask = 0;      /* bit i set if can't read i */
+	unsigned int i;
+
+	CFE_MSG_GetSize(p_cmd_msg, &msg_size);
+	p_payload = &(((const VS_cmd_screen_t *)p_cmd_msg)->payload);
+	if ((msg_size != sizeof(VS_cmd_screen_t)) ||
+		(p_payload->num_images < 1) ||
+		(p_payload->num_images > VS_SCREEN_MAX_IMAGES)) {
+		CFE_EVS_SendEvent(VS_CMD_BAD_ARG_ERR_EID,
+			CFE_EVS_EventType_ERROR,
+			"%s: malformed screen command.", p_config->app_name);
+		return VS_CMD_BAD_ARG_ERR_EID;
+	}
+	for (i = 0; i < p_payload->num_images; i++) {
+		if (NULL == memchr(p_payload->filenames[i], '\0',
+			sizeof(p_payload->filenames[i]))) {
+			CFE_EVS_SendEvent(VS_CMD_BAD_ARG_ERR_EID,
+				CFE_EVS_EventType_ERROR,
+				"%s: malformed screen command.",
+				p_config->app_name);
+			return VS_CMD_BAD_ARG_ERR_EID;
+		}
+	}
+
+	for (i = 0; i < p_payload->num_images; i++) {
+		if (!vs_app_read_image(p_app, p_payload->filenames[i],
+			&image)) {
+			unreadable_mask |= (uint8)(1 << i);
+		} else if (p_config->screen(&image)) {
+			valid_mask |= (uint8)(1 << i);
+		}
+	}
+
+	CFE_EVS_SendEvent(VS_SCREEN_INF_EID, CFE_EVS_EventType_INFORMATION,
+		"%s: screened %u files: valid mask 0x%02X, "
+		"unreadable mask 0x%02X.", p_config->app_name,
+		(unsigned int)p_payload->num_images, (unsigned int)valid_mask,
+		(unsigned int)unreadable_mask);
+	return CFE_SUCCESS;
+
+} /* vs_app_screen() */
+
+
+/* vs_app_load_staged()
+ *
+ * in:     p_app - app whose staging pool to drain
+ * out:    p_app - loaded images removed from the staging pool
+ * return: nothing
+ *
+ * Loads the images waiting in the staging pool, oldest first.
+ * CFE_TBL_Load() copies each into TBL's inactive buffer, has the
+ * app's validation function validate it, and makes it active if it
+ * is valid, all before it returns.  If TBL's inactive buffer is busy
+ * with a ground load, the image waits in the pool for the next
+ * housekeeping cycle.
+ */
+
+static void
+vs_app_load_staged(VS_app_t *p_app) {
+
+	const VS_app_config_t *p_config = p_app->p_config;
+	CFE_Status_t result;  /* CFE_TBL_Load()'s result */
+	unsigned int slot;    /* oldest staged image's slot */
+
+	while (p_app->stage_count > 0) {
+
+		slot = p_app->stage_first;
+		result = CFE_TBL_Load(p_app->h_table, CFE_TBL_SRC_ADDRESS,
+			&(p_app->stage_images[slot]));
+		if (result == CFE_TBL_ERR_LOAD_IN_PROGRESS) break;
+
+		if (result == CFE_SUCCESS) {
+			CFE_EVS_SendEvent(VS_STAGE_INF_EID,
+				CFE_EVS_EventType_INFORMATION,
+				"%s: loaded staged %s.", p_config->app_name,
+				p_app->stage_names[slot]);
+		} else {
+			CFE_EVS_SendEvent(VS_STAGE_ERR_EID,
+				CFE_EVS_EventType_ERROR,
+				"%s: staged %s not loaded, status 0x%08X.",
+				p_config->app_name, p_app->stage_names[slot],
+				(unsigned int)result);
+		}
+
+		p_app->stage_first = (slot + 1) % VS_STAGE_SLOTS;
+		p_app->stage_count--;
+	}
+
+} /* vs_app_load_staged() */
+
+
+/* vs_app_process_housekeeping()
+ *
+ * in:     p_app     - app receiving the command
+ *         p_cmd_msg - housekeeping command message to process
+ * out:    nothing
+ * return: CFE_Success on success, otherwise CFE error codes.
+ *
+ * Handle housekeeping commands, including table validation.
+ *
+ * This function handles all housekeeping commands, including table
+ * validation requests from the CFE Table Service (TBL).  Table
+ * validation requests have an interesting control flow:
+ *
+ * (1) The ground station operator asks TBL to validate a table image.
+ * (2) TBL asks the app to validate the image on its next housekeeping
+ *     cycle.
+ * (3) This function receives TBL's request and uses TBL's
+ *     CFE_TBL_Manage() convenience function to handle it.
+ * (4) TBL's convenience function ultimately invokes the app's table
+ *     validation function to do the actual validation.
+ *
+ * Apps configured with tbl_notify also have TBL send a notification
+ * message in step (2), and vs_app_process_command() calls
+ * CFE_TBL_Manage() as soon as it arrives.
+ *
+ * Side effect: emits a housekeeping telemetry message.
+ */
+
+static CFE_Status_t
+vs_app_process_housekeeping(VS_app_t *p_app, CFE_MSG_Message_t *p_cmd_msg) {
+
+	/* Housekeeping command messages should have length equal to
+	 * sizeof(CFE_MSG_Message_t).  Their command code field isn't
+	 * meaningful; the SCH_LAB app I'm building against sets it to
+	 * 0.  Rather than check for these proper values, I'm
+	 * generously accepting any message with the proper
+	 * send-housekeeping MID.
+	 */
+	(void)p_cmd_msg;
+
+	/* Ask TBL to perform any requested table loads (aka
+	 * "updates") or validations.  Don't bother examining the
+	 * result.  Instead, rely on the error reporting done by
+	 * CFE_TBL_Manage() and our own validation procedure.
+	 */
+	CFE_TBL_Manage(p_app->h_table);
+
+	/* Then load any images the ground has staged meanwhile. */
+	vs_app_load_staged(p_app);
+	p_app->msg_tlm_hk.payload.staged = p_app->stage_count;
+
+	if (p_app->p_config->housekeeping)
+		p_app->p_config->housekeeping(&(p_app->msg_tlm_hk.payload));
+
+	/* Emit a housekeeping telemetry message, with the validation
+	 * statistics as of any validation we just did.  Mark the
+	 * transmit for performance monitoring, so tests can tell what
+	 * it costs from what validation costs.
+	 */
+	p_app->p_config->get_stats(&(p_app->msg_tlm_hk.payload.vstats));
+	CFE_ES_PerfLogEntry(p_app->p_config->hk_perf_id);
+	CFE_SB_TimeStampMsg(CFE_MSG_PTR(p_app->msg_tlm_hk.header));
+	CFE_SB_TransmitMsg(CFE_MSG_PTR(p_app->msg_tlm_hk.header), true);
+	CFE_ES_PerfLogExit(p_app->p_config->hk_perf_id);
+
+	return CFE_SUCCESS;
+
+} /* vs_app_process_housekeeping() */
+
+
+/* vs_app_process_ground_command()
+ *
+ * in:     p_app     - app receiving the command
+ *         p_cmd_msg - ground command message to handle
+ * out:    p_app     - may zero command processing statistics counters
+ * return: CFE_SUCCESS on success, otherwise VS_MSG_BAD_CC_ERR_EID or
+ *         the error the app's command function returned.
+ *
+ * This function handles all commands from the ground station, handing
+ * those other than NOOP, RESET_COUNTERS, STAGE, DUMP_CYCLES, and
+ * SCREEN to the app.
+ *
+ * Side effect: will emit telemetry messages specific to the type of
+ * command processed or an error telemetry message for command codes
+ * it doesn't support.
+ */
+
+static CFE_Status_t
+vs_app_process_ground_command(VS_app_t *p_app, CFE_MSG_Message_t *p_cmd_msg) {
+
+	const VS_app_config_t *p_config = p_app->p_config;
+	CFE_MSG_FcnCode_t msg_cc;  /* command code from message header */
+	CFE_Status_t result;       /* app's command function's result */
+
+	/* The NOOP and RESET_COUNTERS ground command messages have no
+	 * payloads; they should have length equal to
+	 * sizeof(CFE_MSG_Message_t).  However, I'm generously
+	 * accepting them with any length.  The app's command
+	 * function checks the length of any command it handles.
+	 */
+	CFE_MSG_GetFcnCode(p_cmd_msg, &msg_cc);
+
+	switch (msg_cc) {
+
+	case VS_APP_NOOP_CC:
+		/* Per cFS/cFE App tradition, the NOOP command causes
+		 * the app to send telemetry indicating its version.
+		 */
+		CFE_EVS_SendEvent(VS_CMD_NOOP_INF_EID,
+			CFE_EVS_EventType_INFORMATION,
+			"%s received no-op command.",
+			p_config->version_string);
+		return CFE_SUCCESS;
+
+	case VS_APP_RESET_COUNTERS_CC:
+		vs_app_reset_diagnostic_counters(p_app);
+		CFE_EVS_SendEvent(VS_CMD_RESET_INF_EID,
+			CFE_EVS_EventType_INFORMATION,
+			"%s: reset diagnostic counters.", p_config->app_name);
+		return CFE_SUCCESS;
+
+	case VS_APP_STAGE_CC:
+		return vs_app_stage(p_app, p_cmd_msg);
+
+	case VS_APP_DUMP_CYCLES_CC:
+		if (p_config->dump_cycles) {
+			p_config->dump_cycles();
+			return CFE_SUCCESS;
+		}
+		break;
+
+	case VS_APP_SCREEN_CC:
+		if (p_config->screen)
+			return vs_app_screen(p_app, p_cmd_msg);
+		break;
+
+	default:
+		break;
+	}
+
+	/* Hand the app any other command.  Built without
+	 * VS_CYCLE_HISTOGRAM or a screening function, it treats those
+	 * command codes as any other it doesn't know.
+	 */
+	result = VS_MSG_BAD_CC_ERR_EID;
+	if (p_config->command)
+		result = p_config->command(p_cmd_msg, msg_cc);
+	if (result == VS_MSG_BAD_CC_ERR_EID) {
+		CFE_EVS_SendEvent(VS_MSG_BAD_CC_ERR_EID,
+			CFE_EVS_EventType_ERROR,
+			"%s: received ground command message "
+			"with invalid command code 0x%02X.",
+			p_config->app_name, msg_cc);
+	}
+	return result;
+
+} /* vs_app_process_ground_command() */
+
+
+/* vs_app_process_command()
+ *
+ * in:     p_app     - app receiving the command
+ *         p_cmd_msg - housekeeping or ground command to handle.
+ * out:    p_app     - increments command processing statistics
+ *                     counters, potentially rolling them back to zero
+ *                     on overflow.
+ * return: nothing
+ *
+ * This function distinguishes between housekeeping and ground
+ * commands and invokes the appropriate handler function.
+ * Housekeeping commands are automatic, sent periodically by the CFE
+ * Scheduler service (SCH) per its configuration table.  Ground
+ * commands come from the human ground station operator.
+ *
+ * Side effect: will emit an error telemetry message if it sees a
+ * message that is neither a ground or housekeeping command.
+ */
+
+static void
+vs_app_process_command(VS_app_t *p_app, CFE_MSG_Message_t *p_cmd_msg) {
+
+	const VS_app_config_t *p_config = p_app->p_config;
+	CFE_SB_MsgId_t msgid_opaque;  /* MID in some opaque representation */
+	CFE_SB_MsgId_Atom_t msgid;    /* MID in integer representation */
+	CFE_Status_t result;          /* processed OK vs. error code */
+
+	/* Get the message ID from the command in p_cmd_buf and invoke
+	 * the proper handler function for that kind of message based
+	 * on what we see.
+	 *
+	 */
+	CFE_MSG_GetMsgId(p_cmd_msg, &msgid_opaque);
+	msgid = CFE_SB_MsgIdToValue(msgid_opaque);
+
+	/* TBL's notifications aren't commands.  Manage the table
+	 * without counting them, so that housekeeping telemetry reads
+	 * as it would without them.
+	 */
+	if (p_config->tbl_notify && (msgid == p_config->tbl_notify_mid)) {
+		CFE_TBL_Manage(p_app->h_table);
+		return;
+	}
+
+	if (msgid == p_config->send_hk_mid) {
+		result = vs_app_process_housekeeping(p_app, p_cmd_msg);
+	} else if (msgid == p_config->cmd_mid) {
+		result = vs_app_process_ground_command(p_app, p_cmd_msg);
+	} else {
+		result = VS_MSG_BAD_MID_ERR_EID;
+		CFE_EVS_SendEvent(result, CFE_EVS_EventType_ERROR,
+			"%s: received command message "
+			"with invalid MID 0x%03X.", p_config->app_name, msgid);
+	}
+
+	/* Update diagnostic count of messages (not) handled correctly. */
+	if (result == CFE_SUCCESS) {
+		p_app->msg_tlm_hk.payload.ctr_cmd_ok++;    /* can roll */
+	} else {
+		p_app->msg_tlm_hk.payload.ctr_cmd_error++; /* can roll */
+	}
+
+} /* vs_app_process_command() */
+
+
+/* vs_app_drain_pipe()
+ *
+ * in:     p_app - app whose pipe to drain
+ * out:    p_app - updates batch statistics counters
+ * return: nothing
+ *
+ * Called just after the main loop has handled the message that woke
+ * it, this function handles up to pipe_batch - 1 more messages
+ * already waiting on the command pipe without blocking, saving a
+ * wake-up for each.  An empty pipe ends the batch early.  So does a
+ * read error, which the main loop's next blocking read will see
+ * again and handle.
+ */
+
+static void
+vs_app_drain_pipe(VS_app_t *p_app) {
+
+	CFE_SB_Buffer_t *p_cmd_buf;  /* SB-provided command buffer */
+	unsigned int batch;          /* messages handled this wake-up */
+
+	for (batch = 1; batch < p_app->p_config->pipe_batch; batch++) {
+		if (CFE_SUCCESS != CFE_SB_ReceiveBuffer(&p_cmd_buf,
+			p_app->cmd_pipe, CFE_SB_POLL)) break;
+		vs_app_process_command(p_app, &(p_cmd_buf->Msg));
+		p_app->msg_tlm_hk.payload.ctr_batched++; /* can roll */
+	}
+
+	if ((batch > p_app->msg_tlm_hk.payload.max_batch) &&
+		(batch <= 0xFF)) {
+		p_app->msg_tlm_hk.payload.max_batch = (uint8)batch;
+	}
+
+} /* vs_app_drain_pipe() */
+
+
+/* ---------------- Functions exported by this module ---------------- */
+
+/* VS_app_Init()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: CFE_SUCCESS
+ *
+ * ES calls this library entry point once at startup, before it starts
+ * the VS apps.  The library keeps no state of its own; each app's
+ * state is in the VS_app_t it passes to VS_app_Main().
+ *
+ */
+
+int32
+VS_app_Init(void) {
+
+	/* Report our successfull initialization. */
+	OS_printf("%s initialized\n", VS_APP_VERSION_STRING);
+
+	return CFE_SUCCESS;
+
+} /* VS_app_Init() */
+
+
+/* VS_app_Main()
+ *
+ * in:     p_app - the app's state, with p_config set
+ * out:    p_app - the app's state as it runs
+ * return: nothing
+ *
+ * Each VS app's main entry point calls this function.  It initializes
+ * the app and then executes its run-loop until the CFE Executive
+ * Service (ES) tells it to quit.
+ *
+ */
+
+void
+VS_app_Main(VS_app_t *p_app) {
+
+	const VS_app_config_t *p_config = p_app->p_config;
+
+	/* This is the "run status" argument we pass to
+	 * CFE_ES_RunLoop().  We'll begin with it set to
+	 * CFE_ES_RunStatus_APP_RUN, a value that will tell ES we are
+	 * happy and healthy.  If we encounter an unrecoverable error
+	 * we will set it to ES_RunStatus_APP_ERROR.  This will tell
+	 * ES to shut us down the next time we call CFE_ES_RunLoop().
+	 */
+	CFE_ES_RunStatus_Enum_t run_status = CFE_ES_RunStatus_APP_RUN;
+	CFE_SB_Buffer_t *p_cmd_buf; /* SB-provided command buffer */
+	uint32 result;  /* holds error codes returned by functions */
+
+	/* Mark the start of app-specific processing for performance
+	 * monitoring.
+	 */
+	CFE_ES_PerfLogEntry(p_config->all_perf_id);
+
+	/* Initialize.  If anything fails, tell CFE_ES_RunLoop() to
+	 * shut us down.
+	 */
+	if (CFE_SUCCESS != vs_app_init(p_app))
+		run_status = CFE_ES_RunStatus_APP_ERROR;
+
+	/* Enter the main processing loop and process commands until
+	 * ES tells us to stop.
+	 */
+	while (CFE_ES_RunLoop(&run_status)) {
+
+		/* Mark the start of a pause in app-specific processing
+		 * while we block waiting for SB to give us a command
+		 * to process.
+		 */
+		CFE_ES_PerfLogExit(p_config->all_perf_id);
+
+		/* Block here until we get the next command. */
+		result = CFE_SB_ReceiveBuffer(&p_cmd_buf, p_app->cmd_pipe,
+			CFE_SB_PEND_FOREVER);
+
+		/* Mark the resumption of app-specific processing
+		 * now that we're done waiting for a command.
+		 */
+		CFE_ES_PerfLogEntry(p_config->all_perf_id);
+
+		/* Process command.  Errors reading from the command
+		 * pipe are unrecoverable; ask ES to shut us down if
+		 * we see one.  Any errors we find in the command
+		 * itself while attempting to process it are
+		 * recoverable and don't merit a shutdown - we'll just
+		 * ignore a malformed command and await the next one.
+		 */
+		if (result == CFE_SUCCESS) {
+			vs_app_process_command(p_app, &(p_cmd_buf->Msg));
+			if (p_config->pipe_batch > 1) vs_app_drain_pipe(p_app);
+		} else {
+			CFE_EVS_SendEvent(VS_PIPE_ERR_EID,
+				CFE_EVS_EventType_ERROR,
+				"%s: SB pipe read error; "
+				"%s will shutdown", p_config->app_name,
+				p_config->app_name);
+			run_status = CFE_ES_RunStatus_APP_ERROR;
+		}
+
+	} /* while we're in the runloop processing commands */
+
+	/* CFE_ES_RunLoop() has told us to shut down.  Mark the final
+	 * end of app-specific processing and exit.
+	 */
+	CFE_ES_PerfLogExit(p_config->all_perf_id);
+	CFE_ES_ExitApp(run_status);
+
+} /* VS_app_Main() */
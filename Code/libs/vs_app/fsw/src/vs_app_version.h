@@ -0,0 +1,43 @@
+#ifndef _VS_APP_VERSION_H_
+#define _VS_APP_VERSION_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* These macros describe the version of the lib using a combination of
+ * vM.m.r version number plus the Git repo tag of the cFS version I
+ * built against.
+ */
+
+#define VS_APP_MAJOR_VERSION  1
+#define VS_APP_MINOR_VERSION  0
+#define VS_APP_REVISION       0
+
+#define STRINGME(s) #s
+#define EXPAND_AND_STRINGME(s) STRINGME(s)
+
+#define VS_APP_BUILD_BASELINE "draco-rc5"
+
+#define VS_APP_VERSION_STRING ( \
+	"VS_APP v" \
+	EXPAND_AND_STRINGME(VS_APP_MAJOR_VERSION) \
+	"." \
+	EXPAND_AND_STRINGME(VS_APP_MINOR_VERSION) \
+	"." \
+	EXPAND_AND_STRINGME(VS_APP_REVISION) \
+	" for cFS " \
+	VS_APP_BUILD_BASELINE)
+
+#endif
@@ -0,0 +1,1350 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module writes the C source the gruntaot translator produces.
+ * Each Grunt instruction becomes a call to one of a small set of
+ * static inline helper routines defined in the generated file's
+ * preamble.  These helpers perform exactly the same stack, type, and
+ * bounds checks as the interpreter's instruction handlers, in the same
+ * order, and report the same status codes.  The checks the
+ * interpreter performs on instruction literals depend only on the
+ * program, so the translator performs them here at translation time.
+ * An instruction with a bad literal becomes generated code that
+ * reports the interpreter's error if it is ever reached.
+ */
+
+#include <stdio.h>
+
+#include "cfe.h"
+
+#include "grunt.h"
+#include "grunt_status.h"
+
+#include "emit.h"
+
+/* ----------------- module private functions and state ------------- */
+
+static const char *license[] = {
+	" * Licensed under the Apache License, Version 2.0 (the \"License\");",
+	" * you may not use this file except in compliance with the License.",
+	" * You may obtain a copy of the License at",
+	" *",
+	" *    http://www.apache.org/licenses/LICENSE-2.0",
+	" *",
+	" * Unless required by applicable law or agreed to in writing, software",
+	" * distributed under the License is distributed on an \"AS IS\" BASIS,",
+	" * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or",
+	" * implied.  See the License for the specific language governing",
+	" * permissions and limitations under the License.",
+	NULL,
+};
+
+/* The generated file provides these definitions for the generated
+ * subroutines to use.  The gn_vm_t struct holds the generated code's
+ * private arg stack and input queue.  The generated code keeps
+ * return addresses on the C stack and loop counts in local variables
+ * rather than in stack[], but it counts the slots they would take in
+ * ctl_count so that it runs out of stack space at exactly the same
+ * point the interpreter would.
+ */
+static const char *preamble[] = {
+	"#include \"cfe.h\"",
+	"",
+	"#include \"grunt.h\"",
+	"#include \"grunt_status.h\"",
+	"",
+	"typedef struct {",
+	"\tgrunt_value_t stack[GRUNT_STACK_SIZE];  /* arg stack */",
+	"\tint arg_count;           /* count of elements on arg stack */",
+	"\tint ctl_count;           /* count of control stack slots in use */",
+	"\tconst char *input;       /* the input data queue */",
+	"\tgrunt_rep_t input_size;  /* size of input data in bytes */",
+	"\tgrunt_rep_t head_index;  /* index of next char to dequeue */",
+	"\tgrunt_pc_t error_pc;     /* pc of instruction that failed */",
+	"} gn_vm_t;",
+	"",
+	"",
+	"static inline int",
+	"gn_fail(gn_vm_t *p_vm, int status, grunt_pc_t pc) {",
+	"\tp_vm->error_pc = pc;",
+	"\treturn status;",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_push(gn_vm_t *p_vm, const grunt_value_t *p_v) {",
+	"\tif ((p_vm->arg_count + p_vm->ctl_count + 1) > GRUNT_STACK_SIZE)",
+	"\t\treturn GRUNT_ERROR_OUTOFBOUNDS;",
+	"\tp_vm->stack[p_vm->arg_count++] = *p_v;",
+	"\treturn 0;",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_push_bool(gn_vm_t *p_vm, grunt_boolean_t b) {",
+	"\tgrunt_value_t v;",
+	"\tv.type = gt_bool;",
+	"\tv.val.b = b;",
+	"\treturn gn_push(p_vm, &v);",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_push_num(gn_vm_t *p_vm, grunt_number_t num) {",
+	"\tgrunt_value_t v;",
+	"\tv.type = gt_num;",
+	"\tv.val.num = num;",
+	"\treturn gn_push(p_vm, &v);",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_push_str(gn_vm_t *p_vm, grunt_string_t str) {",
+	"\tgrunt_value_t v;",
+	"\tv.type = gt_str;",
+	"\tv.val.str = str;",
+	"\treturn gn_push(p_vm, &v);",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_pop(gn_vm_t *p_vm, grunt_value_t *p_v) {",
+	"\tif (p_vm->arg_count == 0) return GRUNT_ERROR_OUTOFBOUNDS;",
+	"\t*p_v = p_vm->stack[--p_vm->arg_count];",
+	"\treturn 0;",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_pop_type(gn_vm_t *p_vm, grunt_value_t *p_v, grunt_value_type_t t) {",
+	"\tif (p_vm->arg_count == 0) return GRUNT_ERROR_OUTOFBOUNDS;",
+	"\t*p_v = p_vm->stack[--p_vm->arg_count];",
+	"\tif (p_v->type != t) return GRUNT_ERROR_INVALIDARGUMENT;",
+	"\treturn 0;",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_add_sub(gn_vm_t *p_vm, bool add_flag) {",
+	"\tgrunt_value_t a, b;",
+	"\tint status;",
+	"\tif ((status = gn_pop_type(p_vm, &b, gt_num))) return status;",
+	"\tif ((status = gn_pop_type(p_vm, &a, gt_num))) return status;",
+	"\tif (add_flag) {",
+	"\t\tif (b.val.num > (GRUNT_NUM_MAX - a.val.num))",
+	"\t\t\treturn GRUNT_ERROR_OUTOFBOUNDS;",
+	"\t\ta.val.num += b.val.num;",
+	"\t} else {",
+	"\t\tif (a.val.num < b.val.num) return GRUNT_ERROR_OUTOFBOUNDS;",
+	"\t\ta.val.num -= b.val.num;",
+	"\t}",
+	"\treturn gn_push(p_vm, &a);",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_and_or(gn_vm_t *p_vm, grunt_rep_t n, bool and_flag) {",
+	"\tgrunt_value_t a, b;",
+	"\tgrunt_rep_t i;",
+	"\tint status;",
+	"\tif ((status = gn_pop_type(p_vm, &a, gt_bool))) return status;",
+	"\tfor (i = 1; i < n; i++) {",
+	"\t\tif ((status = gn_pop_type(p_vm, &b, gt_bool))) return status;",
+	"\t\ta.val.b = (and_flag ? a.val.b && b.val.b : a.val.b || b.val.b);",
+	"\t}",
+	"\treturn gn_push(p_vm, &a);",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_eq(gn_vm_t *p_vm, grunt_rep_t n) {",
+	"\tgrunt_value_t a, b;",
+	"\tgrunt_rep_t i;",
+	"\tbool equal_flag = true;",
+	"\tint status;",
+	"\tif ((status = gn_pop_type(p_vm, &a, gt_num))) return status;",
+	"\tfor (i = 1; i < n; i++) {",
+	"\t\tif ((status = gn_pop_type(p_vm, &b, gt_num))) return status;",
+	"\t\tif (a.val.num != b.val.num) equal_flag = false;",
+	"\t}",
+	"\treturn gn_push_bool(p_vm, equal_flag);",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_lt_gt(gn_vm_t *p_vm, bool lt_flag) {",
+	"\tgrunt_value_t a, b;",
+	"\tint status;",
+	"\tif ((status = gn_pop_type(p_vm, &b, gt_num))) return status;",
+	"\tif ((status = gn_pop_type(p_vm, &a, gt_num))) return status;",
+	"\treturn gn_push_bool(p_vm, (lt_flag ? a.val.num < b.val.num :",
+	"\t\ta.val.num > b.val.num));",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_not(gn_vm_t *p_vm) {",
+	"\tgrunt_value_t a;",
+	"\tint status;",
+	"\tif ((status = gn_pop_type(p_vm, &a, gt_bool))) return status;",
+	"\treturn gn_push_bool(p_vm, !a.val.b);",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_dup(gn_vm_t *p_vm, grunt_rep_t n) {",
+	"\tif (p_vm->arg_count < n) return GRUNT_ERROR_OUTOFBOUNDS;",
+	"\tif ((p_vm->arg_count + p_vm->ctl_count + n) > GRUNT_STACK_SIZE)",
+	"\t\treturn GRUNT_ERROR_OUTOFBOUNDS;",
+	"\tmemcpy(&(p_vm->stack[p_vm->arg_count]),",
+	"\t\t&(p_vm->stack[p_vm->arg_count - n]), (n * sizeof(grunt_value_t)));",
+	"\tp_vm->arg_count += n;",
+	"\treturn 0;",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_roll(gn_vm_t *p_vm, grunt_rep_t n) {",
+	"\tgrunt_value_t temp;",
+	"\tif (p_vm->arg_count < n) return GRUNT_ERROR_OUTOFBOUNDS;",
+	"\ttemp = p_vm->stack[p_vm->arg_count - 1];",
+	"\tmemmove(&(p_vm->stack[p_vm->arg_count - n + 1]),",
+	"\t\t&(p_vm->stack[p_vm->arg_count - n]),",
+	"\t\t((n - 1) * sizeof(grunt_value_t)));",
+	"\tp_vm->stack[p_vm->arg_count - n] = temp;",
+	"\treturn 0;",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_pop_n(gn_vm_t *p_vm, grunt_rep_t n) {",
+	"\tif (p_vm->arg_count < n) {",
+	"\t\tp_vm->arg_count = 0;  /* interpreter pops what it can */",
+	"\t\treturn GRUNT_ERROR_OUTOFBOUNDS;",
+	"\t}",
+	"\tp_vm->arg_count -= n;",
+	"\treturn 0;",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_input(gn_vm_t *p_vm, grunt_rep_t n) {",
+	"\tuint32 u32;",
+	"\tuint16 u16;",
+	"\tuint8  u8;",
+	"\tif (!p_vm->input) return GRUNT_ERROR_INTERPRETERBUG;",
+	"\tif ((p_vm->head_index + n) > p_vm->input_size)",
+	"\t\treturn GRUNT_ERROR_OUTOFBOUNDS;",
+	"\tswitch (n) {",
+	"\tcase 4:",
+	"\t\tmemcpy(&u32, &(p_vm->input[p_vm->head_index]), 4);",
+	"\t\tp_vm->head_index += 4;",
+	"\t\treturn gn_push_num(p_vm, u32);",
+	"\tcase 2:",
+	"\t\tmemcpy(&u16, &(p_vm->input[p_vm->head_index]), 2);",
+	"\t\tp_vm->head_index += 2;",
+	"\t\treturn gn_push_num(p_vm, u16);",
+	"\tdefault:",
+	"\t\tmemcpy(&u8, &(p_vm->input[p_vm->head_index]), 1);",
+	"\t\tp_vm->head_index += 1;",
+	"\t\treturn gn_push_num(p_vm, u8);",
+	"\t}",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_inputrec(gn_vm_t *p_vm, grunt_rep_t layout, grunt_rep_t size) {",
+	"\tgrunt_rep_t w;",
+	"\tint status;",
+	"\tif (!p_vm->input) return GRUNT_ERROR_INTERPRETERBUG;",
+	"\tif ((p_vm->head_index + size) > p_vm->input_size)",
+	"\t\treturn GRUNT_ERROR_OUTOFBOUNDS;",
+	"\tfor (; layout; layout >>= 2) {",
+	"\t\tw = (((layout & 3) == 3) ? 4 : (layout & 3));",
+	"\t\tif ((status = gn_input(p_vm, w))) return status;",
+	"\t}",
+	"\treturn 0;",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_inputz(gn_vm_t *p_vm, grunt_rep_t n) {",
+	"\tuint8 any = 0;",
+	"\tif (!p_vm->input) return GRUNT_ERROR_INTERPRETERBUG;",
+	"\tif ((p_vm->head_index + n) > p_vm->input_size)",
+	"\t\treturn GRUNT_ERROR_OUTOFBOUNDS;",
+	"\twhile (n--) any |= (uint8)p_vm->input[p_vm->head_index++];",
+	"\treturn gn_push_bool(p_vm, (any == 0));",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_rewind(gn_vm_t *p_vm, grunt_rep_t n) {",
+	"\tif (n > p_vm->head_index) return GRUNT_ERROR_OUTOFBOUNDS;",
+	"\tp_vm->head_index = (n ? p_vm->head_index - n : 0);",
+	"\treturn 0;",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_output(gn_vm_t *p_vm) {",
+	"\tgrunt_value_t a;",
+	"\tint status;",
+	"\tif ((status = gn_pop(p_vm, &a))) return status;",
+	"\treturn GRUNT_NativeOutput(&a);",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_format(gn_vm_t *p_vm, grunt_rep_t n) {",
+	"\tgrunt_value_t t, v[GRUNT_FORMAT_MAX_VALUES];",
+	"\tint i, status;",
+	"\tif ((status = gn_pop_type(p_vm, &t, gt_str))) return status;",
+	"\tfor (i = n - 1; i >= 0; i--) {",
+	"\t\tif ((status = gn_pop(p_vm, &(v[i])))) return status;",
+	"\t}",
+	"\treturn GRUNT_NativeFormat(t.val.str, v, n);",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_classify(gn_vm_t *p_vm, grunt_rep_t names) {",
+	"\tgrunt_value_t row[4];",
+	"\tint i, status;",
+	"\tif ((status = gn_pop_type(p_vm, &(row[0]), gt_num))) return status;",
+	"\tif ((status = GRUNT_NativeClassify(row, row[0].val.num, names)))",
+	"\t\treturn status;",
+	"\tfor (i = 0; i < 4; i++) {",
+	"\t\tif ((status = gn_push(p_vm, &(row[i])))) return status;",
+	"\t}",
+	"\treturn 0;",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_flush(gn_vm_t *p_vm) {",
+	"\tgrunt_value_t a, b;",
+	"\tint status;",
+	"\tif ((status = gn_pop_type(p_vm, &a, gt_num))) return status;",
+	"\tif ((status = gn_pop_type(p_vm, &b, gt_num))) return status;",
+	"\tGRUNT_NativeFlush(a.val.num, b.val.num);",
+	"\treturn 0;",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_halt(gn_vm_t *p_vm) {",
+	"\tgrunt_value_t a;",
+	"\tint status;",
+	"\tif ((status = gn_pop_type(p_vm, &a, gt_bool))) return status;",
+	"\treturn (a.val.b ? GRUNT_HALT_TRUE : GRUNT_HALT_FALSE);",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_test(gn_vm_t *p_vm, bool *p_b) {",
+	"\tgrunt_value_t a;",
+	"\tint status;",
+	"\tif ((status = gn_pop_type(p_vm, &a, gt_bool))) return status;",
+	"\t*p_b = a.val.b;",
+	"\treturn 0;",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_call(gn_vm_t *p_vm) {",
+	"\tif ((p_vm->arg_count + p_vm->ctl_count + 1) > GRUNT_STACK_SIZE)",
+	"\t\treturn GRUNT_ERROR_OUTOFBOUNDS;",
+	"\tp_vm->ctl_count++;",
+	"\treturn 0;",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_return(gn_vm_t *p_vm) {",
+	"\tif (p_vm->ctl_count == 0) return GRUNT_ERROR_OUTOFBOUNDS;",
+	"\tp_vm->ctl_count--;",
+	"\treturn 0;",
+	"}",
+	"",
+	"",
+	"static inline int",
+	"gn_repeat(gn_vm_t *p_vm) {",
+	"\tif ((p_vm->arg_count + p_vm->ctl_count + 2) > GRUNT_STACK_SIZE)",
+	"\t\treturn GRUNT_ERROR_OUTOFBOUNDS;",
+	"\tp_vm->ctl_count += 2;",
+	"\treturn 0;",
+	"}",
+	NULL,
+};
+
+
+/* emit_lines()
+ *
+ * in:     out   - file to write to
+ *         lines - NULL-terminated array of lines to write
+ * out:    nothing
+ * return: nothing
+ */
+
+static void
+emit_lines(FILE *out, const char **lines) {
+
+	int i;
+
+	for (i = 0; lines[i]; i++) fprintf(out, "%s\n", lines[i]);
+
+} /* emit_lines() */
+
+
+/* op_name()
+ *
+ * in:     op - Grunt opcode
+ * out:    nothing
+ * return: the mnemonic for op, or "INVALID" if there is none.
+ */
+
+static const char *
+op_name(grunt_opcode_t op) {
+
+	switch (op) {
+	case GRUNT_OP_ADD:    return "ADD";
+	case GRUNT_OP_AND:    return "AND";
+	case GRUNT_OP_CALL:   return "CALL";
+	case GRUNT_OP_CLASSIFY: return "CLASSIFY";
+	case GRUNT_OP_DUP:    return "DUP";
+	case GRUNT_OP_END:    return "END";
+	case GRUNT_OP_EQ:     return "EQ";
+	case GRUNT_OP_FLUSH:  return "FLUSH";
+	case GRUNT_OP_FORMAT: return "FORMAT";
+	case GRUNT_OP_GT:     return "GT";
+	case GRUNT_OP_HALT:   return "HALT";
+	case GRUNT_OP_INPUT:  return "INPUT";
+	case GRUNT_OP_INPUTREC: return "INPUTREC";
+	case GRUNT_OP_INPUTZ: return "INPUTZ";
+	case GRUNT_OP_JMPIF:  return "JMPIF";
+	case GRUNT_OP_LOOKUP: return "LOOKUP";
+	case GRUNT_OP_LT:     return "LT";
+	case GRUNT_OP_NOT:    return "NOT";
+	case GRUNT_OP_OR:     return "OR";
+	case GRUNT_OP_OUTPUT: return "OUTPUT";
+	case GRUNT_OP_POP:    return "POP";
+	case GRUNT_OP_PUSHB:  return "PUSHB";
+	case GRUNT_OP_PUSHN:  return "PUSHN";
+	case GRUNT_OP_PUSHS:  return "PUSHS";
+	case GRUNT_OP_REPEAT: return "REPEAT";
+	case GRUNT_OP_RETURN: return "RETURN";
+	case GRUNT_OP_REWIND: return "REWIND";
+	case GRUNT_OP_ROLL:   return "ROLL";
+	case GRUNT_OP_SUB:    return "SUB";
+	case GRUNT_OP_SWITCH: return "SWITCH";
+	default:              return "INVALID";
+	}
+
+} /* op_name() */
+
+
+/* emit_comment()
+ *
+ * in:     out - file to write to
+ *         pc  - program counter of instruction p_i
+ *         p_i - instruction to describe
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes a comment naming the Grunt instruction the subsequent
+ * generated code implements.
+ */
+
+static void
+emit_comment(FILE *out, grunt_pc_t pc, const grunt_instruction_t *p_i) {
+
+	fprintf(out, "\t/* %u: %s", pc, op_name(p_i->op));
+
+	switch (p_i->op) {
+	case GRUNT_OP_AND:
+	case GRUNT_OP_DUP:
+	case GRUNT_OP_EQ:
+	case GRUNT_OP_FORMAT:
+	case GRUNT_OP_INPUT:
+	case GRUNT_OP_INPUTZ:
+	case GRUNT_OP_LOOKUP:
+	case GRUNT_OP_OR:
+	case GRUNT_OP_POP:
+	case GRUNT_OP_REPEAT:
+	case GRUNT_OP_REWIND:
+	case GRUNT_OP_ROLL:
+	case GRUNT_OP_SWITCH:
+		fprintf(out, " %u", p_i->arg.rep);
+		break;
+	case GRUNT_OP_INPUTREC:
+		fprintf(out, " 0x%04X", p_i->arg.rep);
+		break;
+	case GRUNT_OP_CLASSIFY:
+		fprintf(out, " s%u", p_i->arg.rep);
+		break;
+	case GRUNT_OP_CALL:
+	case GRUNT_OP_JMPIF:
+	case GRUNT_OP_PUSHB:
+	case GRUNT_OP_PUSHN:
+	case GRUNT_OP_PUSHS:
+		switch (p_i->arg.lit.type) {
+		case gt_bool:
+			fprintf(out, " %s", (p_i->arg.lit.val.b ? "true" : "false"));
+			break;
+		case gt_num:
+			fprintf(out, " 0x%08X", p_i->arg.lit.val.num);
+			break;
+		case gt_str:
+			fprintf(out, " s%u", p_i->arg.lit.val.str);
+			break;
+		case gt_pc:
+			fprintf(out, " %u", p_i->arg.lit.val.pc);
+			break;
+		}
+		break;
+	default:
+		break;
+	}
+
+	fprintf(out, " */\n");
+
+} /* emit_comment() */
+
+
+/* emit_try()
+ *
+ * in:     out  - file to write to
+ *         pc   - program counter of the instruction being translated
+ *         call - text of helper call that returns a Grunt status code
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes a statement that makes the indicated helper call and, if it
+ * fails, records pc as the failing instruction and returns.
+ */
+
+static void
+emit_try(FILE *out, grunt_pc_t pc, const char *call) {
+
+	fprintf(out, "\tif ((status = %s))\n", call);
+	fprintf(out, "\t\treturn gn_fail(p_vm, status, %u);\n", pc);
+
+} /* emit_try() */
+
+
+/* emit_fail()
+ *
+ * in:     out    - file to write to
+ *         pc     - program counter to report in the error message
+ *         status - Grunt status code to report
+ *         name   - name of status code, for readability
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes a statement that unconditionally reports a run-time error.
+ */
+
+static void
+emit_fail(FILE *out, grunt_pc_t pc, int status, const char *name) {
+
+	fprintf(out, "\treturn gn_fail(p_vm, %s, %u);  /* 0x%02X */\n",
+		name, pc, status);
+
+} /* emit_fail() */
+
+
+/* rep_at_least()
+ *
+ * in:     out - file to write to
+ *         pc  - program counter of the instruction being translated
+ *         rep - the instruction's repetition count
+ *         min - the smallest valid repetition count
+ * out:    nothing
+ * return: true if rep is valid, false if we emitted an error instead.
+ */
+
+static bool
+rep_at_least(FILE *out, grunt_pc_t pc, grunt_rep_t rep, grunt_rep_t min) {
+
+	if (rep >= min) return true;
+
+	emit_fail(out, pc, GRUNT_ERROR_INVALIDLITERAL,
+		"GRUNT_ERROR_INVALIDLITERAL");
+	return false;
+
+} /* rep_at_least() */
+
+
+/* lit_is()
+ *
+ * in:     out  - file to write to
+ *         pc   - program counter of the instruction being translated
+ *         p_i  - the instruction being translated
+ *         type - the literal type the instruction requires
+ * out:    nothing
+ * return: true if literal is valid, false if we emitted an error instead.
+ */
+
+static bool
+lit_is(FILE *out, grunt_pc_t pc, const grunt_instruction_t *p_i,
+	grunt_value_type_t type) {
+
+	if (p_i->arg.lit.type == type) return true;
+
+	emit_fail(out, pc, GRUNT_ERROR_INVALIDLITERAL,
+		"GRUNT_ERROR_INVALIDLITERAL");
+	return false;
+
+} /* lit_is() */
+
+
+/* layout_size()
+ *
+ * in:     layout - an INPUTREC layout
+ * out:    nothing
+ * return: the size in bytes of the record layout describes, or 0 if
+ *         it is invalid, as the interpreter decides.
+ */
+
+static uint32
+layout_size(grunt_rep_t layout) {
+
+	uint32 size = 0;
+	int i;
+
+	for (i = 0; (i < GRUNT_INPUTREC_MAX_FIELDS) &&
+		GRUNT_INPUTREC_WIDTH(layout, i); i++)
+		size += GRUNT_INPUTREC_WIDTH(layout, i);
+	if ((i < GRUNT_INPUTREC_MAX_FIELDS) && (layout >> (2 * i)))
+		return 0;
+	return size;
+
+} /* layout_size() */
+
+
+/* table_is_valid()
+ *
+ * in:     out     - file to write to
+ *         program - the Grunt program
+ *         n       - number of instructions in program
+ *         pc      - program counter of a LOOKUP
+ * out:    nothing
+ * return: true if the LOOKUP's table is valid, false if we emitted an
+ *         error instead.
+ *
+ * Makes the interpreter's checks on a LOOKUP's table, in the same
+ * order.
+ */
+
+static bool
+table_is_valid(FILE *out, const grunt_instruction_t *program,
+	grunt_pc_t n, grunt_pc_t pc) {
+
+	const grunt_instruction_t *p_e;
+	uint32 last = 2 * (uint32)program[pc].arg.rep;
+	uint32 i;
+
+	if (!rep_at_least(out, pc, program[pc].arg.rep, 1)) return false;
+
+	if (!((uint32)(n - (pc + 1)) > last)) {
+		emit_fail(out, pc, GRUNT_ERROR_NOPROGRAM,
+			"GRUNT_ERROR_NOPROGRAM");
+		return false;
+	}
+
+	for (i = 0; i <= last; i++) {
+		p_e = &(program[pc + 1 + i]);
+		if ((i & 1) || (i == last)) {
+			if ((p_e->op == GRUNT_OP_PUSHS) &&
+				(p_e->arg.lit.type == gt_str))
+				continue;
+		} else if ((p_e->op == GRUNT_OP_PUSHN) &&
+			(p_e->arg.lit.type == gt_num)) {
+			continue;
+		}
+		emit_fail(out, pc, GRUNT_ERROR_INVALIDLITERAL,
+			"GRUNT_ERROR_INVALIDLITERAL");
+		return false;
+	}
+
+	return true;
+
+} /* table_is_valid() */
+
+
+/* emit_lookup()
+ *
+ * in:     out     - file to write to
+ *         program - the Grunt program
+ *         n       - number of instructions in program
+ *         pc      - program counter of a LOOKUP with a valid table
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes a C switch that replaces the key with its string.  The
+ * interpreter takes the first matching key, so we leave out the
+ * labels of any later duplicates.
+ */
+
+static void
+emit_lookup(FILE *out, const grunt_instruction_t *program, grunt_pc_t n,
+	grunt_pc_t pc) {
+
+	const grunt_instruction_t *p_table = &(program[pc + 1]);
+	uint32 last = 2 * (uint32)program[pc].arg.rep;
+	grunt_pc_t end = (grunt_pc_t)(pc + 1 + last + 1);
+	uint32 i, j;
+
+	emit_try(out, pc, "gn_pop_type(p_vm, &key, gt_num)");
+	fprintf(out, "\tswitch (key.val.num) {\n");
+	for (i = 0; i < last; i += 2) {
+		for (j = 0; j < i; j += 2) {
+			if (p_table[j].arg.lit.val.num ==
+				p_table[i].arg.lit.val.num)
+				break;
+		}
+		if (j < i) continue;   /* an earlier key matches first */
+		fprintf(out, "\tcase 0x%08XU: key.val.str = %u; break;\n",
+			p_table[i].arg.lit.val.num,
+			p_table[i + 1].arg.lit.val.str);
+	}
+	fprintf(out, "\tdefault: key.val.str = %u; break;\n\t}\n",
+		p_table[last].arg.lit.val.str);
+	emit_try(out, pc, "gn_push_str(p_vm, key.val.str)");
+
+	if (end < n) {
+		fprintf(out, "\tgoto pc%u;\n", end);
+	} else {
+		emit_fail(out, end, GRUNT_ERROR_NOPROGRAM,
+			"GRUNT_ERROR_NOPROGRAM");
+	}
+
+} /* emit_lookup() */
+
+
+/* switch_is_valid()
+ *
+ * in:     out     - file to write to
+ *         program - the Grunt program
+ *         n       - number of instructions in program
+ *         pc      - program counter of a SWITCH
+ * out:    nothing
+ * return: true if the SWITCH's table is valid, false if we emitted an
+ *         error instead.
+ *
+ * Makes the interpreter's checks on a SWITCH's table, in the same
+ * order.
+ */
+
+static bool
+switch_is_valid(FILE *out, const grunt_instruction_t *program,
+	grunt_pc_t n, grunt_pc_t pc) {
+
+	const grunt_instruction_t *p_e;
+	uint32 reps = program[pc].arg.rep;
+	uint32 i;
+
+	if (!rep_at_least(out, pc, program[pc].arg.rep, 1)) return false;
+
+	if ((uint32)(n - (pc + 1)) < reps) {
+		emit_fail(out, pc, GRUNT_ERROR_NOPROGRAM,
+			"GRUNT_ERROR_NOPROGRAM");
+		return false;
+	}
+
+	for (i = 0; i < reps; i++) {
+		p_e = &(program[pc + 1 + i]);
+		if ((p_e->op != GRUNT_OP_JMPIF) ||
+			(p_e->arg.lit.type != gt_pc) ||
+			(p_e->arg.lit.val.pc < 1)) {
+			emit_fail(out, pc, GRUNT_ERROR_INVALIDLITERAL,
+				"GRUNT_ERROR_INVALIDLITERAL");
+			return false;
+		}
+		if (p_e->arg.lit.val.pc > (GRUNT_PC_MAX - (pc + 1 + i))) {
+			emit_fail(out, pc, GRUNT_ERROR_NOPROGRAM,
+				"GRUNT_ERROR_NOPROGRAM");
+			return false;
+		}
+	}
+
+	return true;
+
+} /* switch_is_valid() */
+
+
+/* emit_goto()
+ *
+ * in:     out    - file to write to
+ *         n      - number of instructions in program
+ *         target - program counter to continue at
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes a goto to target, or, if target is past the end of the
+ * program, the error the interpreter reports fetching it.
+ */
+
+static void
+emit_goto(FILE *out, grunt_pc_t n, grunt_pc_t target) {
+
+	if (target < n) {
+		fprintf(out, "goto pc%u;\n", target);
+	} else {
+		fprintf(out, "return gn_fail(p_vm, GRUNT_ERROR_NOPROGRAM, "
+			"%u);\n", target);
+	}
+
+} /* emit_goto() */
+
+
+/* emit_switch()
+ *
+ * in:     out     - file to write to
+ *         program - the Grunt program
+ *         n       - number of instructions in program
+ *         pc      - program counter of a SWITCH with a valid table
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes a C switch with a goto for each entry and the default, which
+ * the C compiler is free to turn into a jump table of its own.
+ */
+
+static void
+emit_switch(FILE *out, const grunt_instruction_t *program, grunt_pc_t n,
+	grunt_pc_t pc) {
+
+	const grunt_instruction_t *p_table = &(program[pc + 1]);
+	uint32 reps = program[pc].arg.rep;
+	uint32 i;
+
+	emit_try(out, pc, "gn_pop_type(p_vm, &key, gt_num)");
+	fprintf(out, "\tswitch (key.val.num) {\n");
+	for (i = 0; i < reps; i++) {
+		fprintf(out, "\tcase %uU: ", i);
+		emit_goto(out, n, (grunt_pc_t)(pc + 1 + i +
+			p_table[i].arg.lit.val.pc));
+	}
+	fprintf(out, "\tdefault: ");
+	emit_goto(out, n, (grunt_pc_t)(pc + 1 + reps));
+	fprintf(out, "\t}\n");
+
+} /* emit_switch() */
+
+
+/* open_loop()
+ *
+ * in:     program   - the Grunt program
+ *         pc        - program counter of an instruction
+ *         reachable - reachable[pc] true iff pc reachable from the
+ *                     entry of the function being generated
+ * out:    p_repeat  - the REPEAT of the innermost loop pc is in
+ * return: true if there is such a loop and the function reaches its
+ *         REPEAT.
+ *
+ * Loops nest lexically, so pc is in the loop of the first REPEAT
+ * before it that no END between them closes.  For programs the
+ * verifier accepts, that is also the innermost loop running when a
+ * run reaches pc.
+ */
+
+static bool
+open_loop(const grunt_instruction_t *program, grunt_pc_t pc,
+	const bool *reachable, grunt_pc_t *p_repeat) {
+
+	uint32 closed = 0;   /* loops closed between there and pc */
+
+	while (pc-- > 0) {
+		if (program[pc].op == GRUNT_OP_END) {
+			closed++;
+		} else if ((program[pc].op == GRUNT_OP_REPEAT) && !closed--) {
+			*p_repeat = pc;
+			return reachable[pc];
+		}
+	}
+
+	return false;
+
+} /* open_loop() */
+
+
+/* emit_instruction()
+ *
+ * in:     out       - file to write to
+ *         name      - prefix for generated identifiers
+ *         program   - the Grunt program
+ *         n         - number of instructions in program
+ *         pc        - program counter of instruction to translate
+ *         reachable - reachable[pc] true iff pc reachable from the
+ *                     entry of the function being generated
+ * out:    nothing
+ * return: true if control may fall through to pc + 1, else false.
+ *
+ * Writes the generated code for a single Grunt instruction.
+ */
+
+static bool
+emit_instruction(FILE *out, const char *name,
+	const grunt_instruction_t *program, grunt_pc_t n, grunt_pc_t pc,
+	const bool *reachable) {
+
+	const grunt_instruction_t *p_i = &(program[pc]);
+	char call[64];   /* text of helper call */
+	grunt_pc_t target;
+
+	emit_comment(out, pc, p_i);
+
+	switch (p_i->op) {
+	case GRUNT_OP_ADD:
+		emit_try(out, pc, "gn_add_sub(p_vm, true)");
+		return true;
+	case GRUNT_OP_SUB:
+		emit_try(out, pc, "gn_add_sub(p_vm, false)");
+		return true;
+	case GRUNT_OP_AND:
+	case GRUNT_OP_OR:
+		if (!rep_at_least(out, pc, p_i->arg.rep, 2)) return false;
+		snprintf(call, sizeof(call), "gn_and_or(p_vm, %u, %s)",
+			p_i->arg.rep,
+			(p_i->op == GRUNT_OP_AND ? "true" : "false"));
+		emit_try(out, pc, call);
+		return true;
+	case GRUNT_OP_EQ:
+		if (!rep_at_least(out, pc, p_i->arg.rep, 2)) return false;
+		snprintf(call, sizeof(call), "gn_eq(p_vm, %u)", p_i->arg.rep);
+		emit_try(out, pc, call);
+		return true;
+	case GRUNT_OP_GT:
+		emit_try(out, pc, "gn_lt_gt(p_vm, false)");
+		return true;
+	case GRUNT_OP_LT:
+		emit_try(out, pc, "gn_lt_gt(p_vm, true)");
+		return true;
+	case GRUNT_OP_NOT:
+		emit_try(out, pc, "gn_not(p_vm)");
+		return true;
+	case GRUNT_OP_DUP:
+		if (!rep_at_least(out, pc, p_i->arg.rep, 1)) return false;
+		snprintf(call, sizeof(call), "gn_dup(p_vm, %u)", p_i->arg.rep);
+		emit_try(out, pc, call);
+		return true;
+	case GRUNT_OP_POP:
+		if (!rep_at_least(out, pc, p_i->arg.rep, 1)) return false;
+		snprintf(call, sizeof(call), "gn_pop_n(p_vm, %u)",
+			p_i->arg.rep);
+		emit_try(out, pc, call);
+		return true;
+	case GRUNT_OP_ROLL:
+		if (!rep_at_least(out, pc, p_i->arg.rep, 2)) return false;
+		snprintf(call, sizeof(call), "gn_roll(p_vm, %u)", p_i->arg.rep);
+		emit_try(out, pc, call);
+		return true;
+	case GRUNT_OP_PUSHB:
+		if (!lit_is(out, pc, p_i, gt_bool)) return false;
+		snprintf(call, sizeof(call), "gn_push_bool(p_vm, %s)",
+			(p_i->arg.lit.val.b ? "true" : "false"));
+		emit_try(out, pc, call);
+		return true;
+	case GRUNT_OP_PUSHN:
+		if (!lit_is(out, pc, p_i, gt_num)) return false;
+		snprintf(call, sizeof(call), "gn_push_num(p_vm, 0x%08XU)",
+			p_i->arg.lit.val.num);
+		emit_try(out, pc, call);
+		return true;
+	case GRUNT_OP_PUSHS:
+		if (!lit_is(out, pc, p_i, gt_str)) return false;
+		snprintf(call, sizeof(call), "gn_push_str(p_vm, %u)",
+			p_i->arg.lit.val.str);
+		emit_try(out, pc, call);
+		return true;
+	case GRUNT_OP_INPUT:
+		if ((p_i->arg.rep != 4) && (p_i->arg.rep != 2) &&
+			(p_i->arg.rep != 1)) {
+			emit_fail(out, pc, GRUNT_ERROR_INVALIDLITERAL,
+				"GRUNT_ERROR_INVALIDLITERAL");
+			return false;
+		}
+		snprintf(call, sizeof(call), "gn_input(p_vm, %u)",
+			p_i->arg.rep);
+		emit_try(out, pc, call);
+		return true;
+	case GRUNT_OP_INPUTREC:
+		if (!layout_size(p_i->arg.rep)) {
+			emit_fail(out, pc, GRUNT_ERROR_INVALIDLITERAL,
+				"GRUNT_ERROR_INVALIDLITERAL");
+			return false;
+		}
+		snprintf(call, sizeof(call), "gn_inputrec(p_vm, 0x%04X, %u)",
+			p_i->arg.rep, layout_size(p_i->arg.rep));
+		emit_try(out, pc, call);
+		return true;
+	case GRUNT_OP_INPUTZ:
+		if (!rep_at_least(out, pc, p_i->arg.rep, 1)) return false;
+		snprintf(call, sizeof(call), "gn_inputz(p_vm, %u)",
+			p_i->arg.rep);
+		emit_try(out, pc, call);
+		return true;
+	case GRUNT_OP_REWIND:
+		snprintf(call, sizeof(call), "gn_rewind(p_vm, %u)",
+			p_i->arg.rep);
+		emit_try(out, pc, call);
+		return true;
+	case GRUNT_OP_OUTPUT:
+		emit_try(out, pc, "gn_output(p_vm)");
+		return true;
+	case GRUNT_OP_FORMAT:
+		if (p_i->arg.rep > GRUNT_FORMAT_MAX_VALUES) {
+			emit_fail(out, pc, GRUNT_ERROR_INVALIDLITERAL,
+				"GRUNT_ERROR_INVALIDLITERAL");
+			return false;
+		}
+		snprintf(call, sizeof(call), "gn_format(p_vm, %u)",
+			p_i->arg.rep);
+		emit_try(out, pc, call);
+		return true;
+	case GRUNT_OP_CLASSIFY:
+		snprintf(call, sizeof(call), "gn_classify(p_vm, %u)",
+			p_i->arg.rep);
+		emit_try(out, pc, call);
+		return true;
+	case GRUNT_OP_FLUSH:
+		emit_try(out, pc, "gn_flush(p_vm)");
+		return true;
+	case GRUNT_OP_HALT:
+		fprintf(out, "\tif ((status = gn_halt(p_vm)) > "
+			"GRUNT_HALT_FALSE)\n");
+		fprintf(out, "\t\treturn gn_fail(p_vm, status, %u);\n", pc);
+		fprintf(out, "\treturn status;\n");
+		return false;
+	case GRUNT_OP_RETURN:
+		/* The interpreter would pop a loop's count. */
+		if (open_loop(program, pc, reachable, &target)) {
+			emit_fail(out, pc, GRUNT_ERROR_INVALIDARGUMENT,
+				"GRUNT_ERROR_INVALIDARGUMENT");
+			return false;
+		}
+		emit_try(out, pc, "gn_return(p_vm)");
+		fprintf(out, "\treturn 0;\n");
+		return false;
+	case GRUNT_OP_REPEAT:
+		if (!rep_at_least(out, pc, p_i->arg.rep, 1)) return false;
+		emit_try(out, pc, "gn_repeat(p_vm)");
+		fprintf(out, "\tloop%u = %uU;\n", pc, p_i->arg.rep);
+		return true;
+	case GRUNT_OP_END:
+		/* An END outside any loop of this function finds a
+		 * return address on top of the interpreter's control
+		 * stack, or nothing.
+		 */
+		if (!open_loop(program, pc, reachable, &target)) {
+			fprintf(out, "\treturn gn_fail(p_vm, "
+				"(p_vm->ctl_count ? "
+				"GRUNT_ERROR_INVALIDARGUMENT :\n\t\t"
+				"GRUNT_ERROR_OUTOFBOUNDS), %u);\n", pc);
+			return false;
+		}
+		fprintf(out, "\tif (--loop%u) goto pc%u;\n", target,
+			target + 1);
+		fprintf(out, "\tp_vm->ctl_count -= 2;\n");
+		return true;
+	case GRUNT_OP_CALL:
+		if (!lit_is(out, pc, p_i, gt_pc)) return false;
+		target = p_i->arg.lit.val.pc;
+		if (target < (pc + 1)) {
+			emit_fail(out, pc, GRUNT_ERROR_NOLOOPS,
+				"GRUNT_ERROR_NOLOOPS");
+			return false;
+		}
+		emit_try(out, pc, "gn_call(p_vm)");
+		if (!(target < n)) {
+			emit_fail(out, target, GRUNT_ERROR_NOPROGRAM,
+				"GRUNT_ERROR_NOPROGRAM");
+			return false;
+		}
+		fprintf(out, "\tif ((status = %s_pc%u(p_vm))) return status;\n",
+			name, target);
+		return true;
+	case GRUNT_OP_JMPIF:
+		if (!lit_is(out, pc, p_i, gt_pc)) return false;
+		if (!rep_at_least(out, pc, p_i->arg.lit.val.pc, 2))
+			return false;
+		emit_try(out, pc, "gn_test(p_vm, &taken)");
+		if (p_i->arg.lit.val.pc > (GRUNT_PC_MAX - (pc + 1))) {
+			fprintf(out, "\tif (taken)\n\t");
+			emit_fail(out, pc, GRUNT_ERROR_NOPROGRAM,
+				"GRUNT_ERROR_NOPROGRAM");
+			return true;
+		}
+		target = pc + p_i->arg.lit.val.pc;
+		if (!(target < n)) {
+			fprintf(out, "\tif (taken)\n\t");
+			emit_fail(out, target, GRUNT_ERROR_NOPROGRAM,
+				"GRUNT_ERROR_NOPROGRAM");
+			return true;
+		}
+		fprintf(out, "\tif (taken) goto pc%u;\n", target);
+		return true;
+	case GRUNT_OP_LOOKUP:
+		if (table_is_valid(out, program, n, pc))
+			emit_lookup(out, program, n, pc);
+		return false;
+	case GRUNT_OP_SWITCH:
+		if (switch_is_valid(out, program, n, pc))
+			emit_switch(out, program, n, pc);
+		return false;
+	default:
+		emit_fail(out, pc, GRUNT_ERROR_INVALIDOPCODE,
+			"GRUNT_ERROR_INVALIDOPCODE");
+		return false;
+	}
+
+} /* emit_instruction() */
+
+
+/* ------------------- module exported functions -------------------- */
+
+
+/* emit_file_header()
+ *
+ * in:     out    - file to write to
+ *         source - name of the Grunt source the output comes from
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes the license and "do not edit" comment at the top of each
+ * generated file.
+ */
+
+void
+emit_file_header(FILE *out, const char *source) {
+
+	fprintf(out, "/* Copyright (c) 2024 Timothy Jon Fraser "
+		"Consulting LLC\n *\n");
+	emit_lines(out, license);
+	fprintf(out, " */\n\n");
+	fprintf(out, "/* GENERATED FILE - DO NOT EDIT.\n *\n");
+	fprintf(out, " * The gruntaot translator generated this file from "
+		"the Grunt program\n * in %s.  Edit the program and run "
+		"gruntaot again instead.\n */\n\n", source);
+
+} /* emit_file_header() */
+
+
+/* emit_preamble()
+ *
+ * in:     out  - file to write to
+ *         name - prefix for generated identifiers
+ * out:    nothing
+ * return: nothing
+ */
+
+void
+emit_preamble(FILE *out, const char *name) {
+
+	emit_lines(out, preamble);
+	fprintf(out, "\n\n");
+	fprintf(out, "#include \"%s.h\"\n\n", name);
+
+} /* emit_preamble() */
+
+
+/* emit_strings()
+ *
+ * in:     out         - file to write to
+ *         name        - prefix for generated identifiers
+ *         strings     - the Grunt program's string table
+ *         num_strings - number of strings in strings
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes a copy of the program's string table.  The generated code
+ * hands it to the output queue exactly as GRUNT_Run() would.
+ */
+
+void
+emit_strings(FILE *out, const char *name, const char *strings[],
+	grunt_string_t num_strings) {
+
+	grunt_string_t i;
+	const char *c;
+
+	fprintf(out, "static const char *%s_strings[] = {\n", name);
+	for (i = 0; i < num_strings; i++) {
+		fprintf(out, "\t\"");
+		for (c = strings[i]; *c; c++) {
+			if ((*c == '"') || (*c == '\\')) {
+				fprintf(out, "\\%c", *c);
+			} else if ((*c < ' ') || (*c > '~')) {
+				fprintf(out, "\\%03o", (unsigned char)*c);
+			} else {
+				fputc(*c, out);
+			}
+		}
+		fprintf(out, "\",  /* s%u */\n", i);
+	}
+	fprintf(out, "};\n\n\n");
+
+} /* emit_strings() */
+
+
+/* emit_prototype()
+ *
+ * in:     out   - file to write to
+ *         name  - prefix for generated identifiers
+ *         entry - program counter of a subroutine entry point
+ * out:    nothing
+ * return: nothing
+ */
+
+void
+emit_prototype(FILE *out, const char *name, grunt_pc_t entry) {
+
+	fprintf(out, "static int %s_pc%u(gn_vm_t *);\n", name, entry);
+
+} /* emit_prototype() */
+
+
+/* emit_function()
+ *
+ * in:     out       - file to write to
+ *         name      - prefix for generated identifiers
+ *         program   - the Grunt program
+ *         n         - number of instructions in program
+ *         entry     - first instruction of the function to generate
+ *         reachable - reachable[pc] true iff pc reachable from entry
+ *         labeled   - labeled[pc] true iff some jump targets pc
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes a C function that performs the Grunt instructions reachable
+ * from entry.  CALLs become calls to other generated functions and
+ * RETURNs become C returns; JMPIFs become forward gotos, LOOKUPs C
+ * switches followed by an unconditional one, and SWITCHes C switches
+ * of gotos.  Each loop counts its runs in a local variable, and its
+ * END is a backward goto to its body.  The generated function returns
+ * 0 when it reaches a RETURN and a non-zero Grunt status code when
+ * the program HALTs or fails.
+ */
+
+void
+emit_function(FILE *out, const char *name, const grunt_instruction_t *program,
+	grunt_pc_t n, grunt_pc_t entry, const bool *reachable,
+	const bool *labeled) {
+
+	grunt_pc_t pc;
+	bool has_jmpif = false;
+	bool has_key = false;     /* some LOOKUP or SWITCH? */
+	bool falls_through;
+
+	for (pc = entry; pc < n; pc++) {
+		if (reachable[pc] && (program[pc].op == GRUNT_OP_JMPIF))
+			has_jmpif = true;
+		if (reachable[pc] && ((program[pc].op == GRUNT_OP_LOOKUP) ||
+			(program[pc].op == GRUNT_OP_SWITCH)))
+			has_key = true;
+	}
+
+	fprintf(out, "static int\n%s_pc%u(gn_vm_t *p_vm) {\n\n", name, entry);
+	fprintf(out, "\tint status;\n");
+	if (has_jmpif) fprintf(out, "\tbool taken;\n");
+	if (has_key) fprintf(out, "\tgrunt_value_t key;\n");
+	for (pc = entry; pc < n; pc++) {
+		if (reachable[pc] && (program[pc].op == GRUNT_OP_REPEAT))
+			fprintf(out, "\tgrunt_number_t loop%u;\n", pc);
+	}
+	fprintf(out, "\n");
+
+	for (pc = entry; pc < n; pc++) {
+
+		if (!reachable[pc]) continue;
+
+		if (labeled[pc] && (pc != entry)) fprintf(out, "pc%u:\n", pc);
+		falls_through = emit_instruction(out, name, program, n, pc,
+			reachable);
+
+		/* The interpreter reports falling off the end of the
+		 * program at the program counter one past the end.
+		 */
+		if (falls_through && !((pc + 1) < n)) {
+			emit_fail(out, pc + 1, GRUNT_ERROR_NOPROGRAM,
+				"GRUNT_ERROR_NOPROGRAM");
+		}
+	}
+
+	fprintf(out, "\n} /* %s_pc%u() */\n\n\n", name, entry);
+
+} /* emit_function() */
+
+
+/* emit_entry()
+ *
+ * in:     out         - file to write to
+ *         name        - prefix for generated identifiers
+ *         num_strings - number of strings in the string table
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes the exported entry point.  It takes the same input arguments
+ * as GRUNT_Run() and returns the same status codes.
+ */
+
+void
+emit_entry(FILE *out, const char *name, grunt_string_t num_strings) {
+
+	fprintf(out,
+		"int32\n"
+		"%s_run(const void *p_data, grunt_rep_t data_size) {\n\n"
+		"\tgn_vm_t vm;\n"
+		"\tint status;\n\n"
+		"\tvm.arg_count  = 0;\n"
+		"\tvm.ctl_count  = 0;\n"
+		"\tvm.input      = (const char *)p_data;\n"
+		"\tvm.input_size = data_size;\n"
+		"\tvm.head_index = 0;\n"
+		"\tvm.error_pc   = 0;\n"
+		"\tGRUNT_NativeInit(%s_strings, %u);\n\n"
+		"\tstatus = %s_pc0(&vm);\n\n"
+		"\t/* A RETURN with an empty control stack fails above, so\n"
+		"\t * the main routine never returns 0.\n"
+		"\t */\n"
+		"\tif (status == 0) status = GRUNT_ERROR_INTERPRETERBUG;\n\n"
+		"\tif (!((status == GRUNT_HALT_TRUE)||"
+		"(status == GRUNT_HALT_FALSE)))\n"
+		"\t\tGRUNT_NativeError(status, vm.error_pc);\n\n"
+		"\treturn status;\n\n"
+		"} /* %s_run() */\n",
+		name, name, num_strings, name, name);
+
+} /* emit_entry() */
+
+
+/* emit_interface()
+ *
+ * in:     out  - file to write to
+ *         name - prefix for generated identifiers
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes the body of the generated header file.
+ */
+
+void
+emit_interface(FILE *out, const char *name) {
+
+	fprintf(out, "int32 %s_run(const void *, grunt_rep_t);\n", name);
+
+} /* emit_interface() */
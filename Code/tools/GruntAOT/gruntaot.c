@@ -0,0 +1,264 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* gruntaot is an ahead-of-time translator that converts a Grunt
+ * program into straight-line C.  It compiles the program in as a
+ * constant array by including the program's header file, just as the
+ * app that runs the program under the interpreter does.  It writes a
+ * .c and a .h file that together provide a single entry point
+ *
+ *   int32 <name>_run(const void *p_data, grunt_rep_t data_size);
+ *
+ * that behaves exactly as GRUNT_Run() does for that program,
+ * returning the same status codes and emitting the same events and
+ * debug messages.
+ *
+ * Each CALL target becomes a C function and each CALL becomes a C
+ * function call.  RETURN becomes a C return.  JMPIF becomes a forward
+ * goto.  A loop's END becomes a backward goto to its body, which its
+ * REPEAT's literal count bounds.  Because Grunt allows only forward
+ * CALLs and jumps, the generated functions never recurse, so the
+ * generated code inherits Grunt's termination guarantee.
+ *
+ * gruntaot pairs each END with a REPEAT by their lexical nesting.  The
+ * interpreter pairs them at run time, but for any program the
+ * verifier accepts the two pairings agree.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cfe.h"
+#include "cfe_evs_extern_typedefs.h"   /* for CFE_EVS_EventType_* enum */
+#include "vs_tablestruct.h"            /* for VS_PARM_* constants */
+#include "vs_eventids.h"               /* for VS event ID constants */
+#include "vs_parmclass.h"              /* for VS_PARM_CLASS_* constants */
+
+#include "grunt.h"
+#include "grunt_status.h"
+
+#include "emit.h"
+
+/* The Grunt program to translate.  To translate a different program,
+ * include its header instead and change these definitions to match.
+ */
+#include "vsvf.h"
+#define AOT_SOURCE           "vsvf.h"
+#define AOT_PROGRAM          vsvf_program
+#define AOT_NUM_INSTRUCTIONS VSVF_NUM_INSTRUCTIONS
+#define AOT_STRINGS          vsvf_strings
+#define AOT_NUM_STRINGS      VSVF_NUM_STRINGS
+
+#define NAME_MAX_LEN 64   /* longest prefix for generated identifiers */
+
+static bool is_entry[AOT_NUM_INSTRUCTIONS];  /* CALL targets, plus 0 */
+static bool reachable[AOT_NUM_INSTRUCTIONS]; /* reachable from an entry */
+static bool labeled[AOT_NUM_INSTRUCTIONS];   /* targets of jumps */
+
+
+/* find_reachable()
+ *
+ * in:     program - the Grunt program
+ *         n       - number of instructions in program
+ *         entry   - entry point of a generated function
+ * out:    reachable[] - true for instructions reachable from entry
+ *         labeled[]   - true for reachable JMPIF, LOOKUP, and SWITCH
+ *                       targets and loop bodies
+ *         is_entry[]  - set true for CALL targets reachable from entry
+ * return: nothing
+ *
+ * Since all Grunt control transfers go forward, a single pass in
+ * program counter order finds every instruction reachable from entry
+ * without returning through a RETURN.  A CALL continues at the next
+ * instruction once its callee RETURNs, a LOOKUP always jumps past
+ * its table, and a SWITCH jumps to one of its entries' targets or
+ * past its table.  END's jump back goes to a loop body, which its
+ * REPEAT reaches anyway.
+ */
+
+static void
+find_reachable(const grunt_instruction_t *program, grunt_pc_t n,
+	grunt_pc_t entry) {
+
+	const grunt_instruction_t *p_i;
+	grunt_pc_t pc;
+	grunt_rep_t lit;
+	uint32 end;   /* pc past a LOOKUP's or SWITCH's table */
+	uint32 i;
+
+	memset(reachable, 0, sizeof(reachable));
+	memset(labeled, 0, sizeof(labeled));
+	reachable[entry] = true;
+
+	for (pc = entry; pc < n; pc++) {
+
+		if (!reachable[pc]) continue;
+		p_i = &(program[pc]);
+
+		switch (p_i->op) {
+		case GRUNT_OP_HALT:
+		case GRUNT_OP_RETURN:
+			break;   /* no successors within this function */
+		case GRUNT_OP_CALL:
+			if ((p_i->arg.lit.type != gt_pc) ||
+				(p_i->arg.lit.val.pc < (pc + 1)) ||
+				!(p_i->arg.lit.val.pc < n))
+				break;   /* generated code reports an error */
+			is_entry[p_i->arg.lit.val.pc] = true;
+			if ((pc + 1) < n) reachable[pc + 1] = true;
+			break;
+		case GRUNT_OP_JMPIF:
+			if ((p_i->arg.lit.type != gt_pc) ||
+				(p_i->arg.lit.val.pc < 2))
+				break;   /* generated code reports an error */
+			lit = p_i->arg.lit.val.pc;
+			if ((lit <= (GRUNT_PC_MAX - (pc + 1))) &&
+				((pc + lit) < n)) {
+				reachable[pc + lit] = true;
+				labeled[pc + lit] = true;
+			}
+			if ((pc + 1) < n) reachable[pc + 1] = true;
+			break;
+		case GRUNT_OP_LOOKUP:
+			/* The generated code checks the table, and
+			 * reports an error if the end is past n.
+			 */
+			end = (uint32)pc + (2 * (uint32)p_i->arg.rep) + 2;
+			if ((p_i->arg.rep >= 1) && (end < n)) {
+				reachable[end] = true;
+				labeled[end] = true;
+			}
+			break;
+		case GRUNT_OP_SWITCH:
+			/* Likewise for a SWITCH's table and its targets. */
+			end = (uint32)pc + (uint32)p_i->arg.rep + 1;
+			if ((p_i->arg.rep < 1) || (end > n)) break;
+			for (i = pc + 1; i < end; i++) {
+				if ((program[i].op != GRUNT_OP_JMPIF) ||
+					(program[i].arg.lit.type != gt_pc) ||
+					(program[i].arg.lit.val.pc < 1))
+					break;
+				lit = program[i].arg.lit.val.pc;
+				if ((i + lit) < n) {
+					reachable[i + lit] = true;
+					labeled[i + lit] = true;
+				}
+			}
+			if (end < n) {
+				reachable[end] = true;
+				labeled[end] = true;
+			}
+			break;
+		case GRUNT_OP_REPEAT:
+			if ((pc + 1) < n) {
+				reachable[pc + 1] = true;
+				labeled[pc + 1] = true;
+			}
+			break;
+		default:
+			if ((pc + 1) < n) reachable[pc + 1] = true;
+			break;
+		}
+	}
+
+} /* find_reachable() */
+
+
+/* open_output()
+ *
+ * in:     dir    - directory to write to
+ *         name   - base name of file
+ *         suffix - file name suffix
+ * out:    nothing
+ * return: the opened file; exits on failure.
+ */
+
+static FILE *
+open_output(const char *dir, const char *name, const char *suffix) {
+
+	char path[FILENAME_MAX];
+	FILE *out;
+
+	snprintf(path, sizeof(path), "%s/%s%s", dir, name, suffix);
+	if (!(out = fopen(path, "w"))) {
+		perror(path);
+		exit(-1);
+	}
+	return out;
+
+} /* open_output() */
+
+
+int
+main(int argc, char *argv[]) {
+
+	char guard[NAME_MAX_LEN + 8];   /* include guard for header */
+	grunt_pc_t entry;
+	FILE *out;
+	size_t i;
+
+	if ((argc != 3) || (strlen(argv[1]) > NAME_MAX_LEN)) {
+		fprintf(stderr, "Usage:\n");
+		fprintf(stderr, "\tgruntaot name dir : translate %s to "
+			"dir/name.c and dir/name.h\n", AOT_SOURCE);
+		return -1;
+	}
+
+	/* Write the header declaring the generated entry point. */
+	for (i = 0; argv[1][i]; i++)
+		guard[i + 1] = (char)toupper((unsigned char)argv[1][i]);
+	guard[0] = '_';
+	strcpy(&(guard[i + 1]), "_H_");
+	out = open_output(argv[2], argv[1], ".h");
+	fprintf(out, "#ifndef %s\n#define %s\n\n", guard, guard);
+	emit_file_header(out, AOT_SOURCE);
+	emit_interface(out, argv[1]);
+	fprintf(out, "\n#endif\n");
+	fclose(out);
+
+	/* Find all of the subroutine entry points.  Entries reachable
+	 * from an entry always have larger program counter values, so
+	 * a single pass in program counter order finds them all.
+	 */
+	is_entry[0] = true;
+	for (entry = 0; entry < AOT_NUM_INSTRUCTIONS; entry++) {
+		if (is_entry[entry])
+			find_reachable(AOT_PROGRAM, AOT_NUM_INSTRUCTIONS,
+				entry);
+	}
+
+	/* Write the generated code. */
+	out = open_output(argv[2], argv[1], ".c");
+	emit_file_header(out, AOT_SOURCE);
+	emit_preamble(out, argv[1]);
+	emit_strings(out, argv[1], AOT_STRINGS, AOT_NUM_STRINGS);
+	for (entry = 0; entry < AOT_NUM_INSTRUCTIONS; entry++) {
+		if (is_entry[entry]) emit_prototype(out, argv[1], entry);
+	}
+	fprintf(out, "\n\n");
+	for (entry = 0; entry < AOT_NUM_INSTRUCTIONS; entry++) {
+		if (!is_entry[entry]) continue;
+		find_reachable(AOT_PROGRAM, AOT_NUM_INSTRUCTIONS, entry);
+		emit_function(out, argv[1], AOT_PROGRAM,
+			AOT_NUM_INSTRUCTIONS, entry, reachable, labeled);
+	}
+	emit_entry(out, argv[1], AOT_NUM_STRINGS);
+	fclose(out);
+
+	return 0;
+
+} /* main() */
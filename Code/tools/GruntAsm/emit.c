@@ -0,0 +1,350 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module writes an assembled program as a C header in the same
+ * form as a hand-written Grunt program: a string table, the record
+ * view constants, one #define giving the address of each subroutine,
+ * and an array of instructions written with grunt.h's convenience
+ * macros.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cfe.h"
+
+#include "grunt.h"
+
+#include "gruntasm.h"
+
+
+/* ----------------- module private functions and state ------------- */
+
+#define COMMENT_COLUMN        32  /* trailing instruction comments */
+#define STRING_COMMENT_COLUMN 25  /* string table index comments */
+#define LINE_MAX_COLUMN       80
+
+static const char *license[] = {
+	" * Licensed under the Apache License, Version 2.0 (the \"License\");",
+	" * you may not use this file except in compliance with the License.",
+	" * You may obtain a copy of the License at",
+	" *",
+	" *    http://www.apache.org/licenses/LICENSE-2.0",
+	" *",
+	" * Unless required by applicable law or agreed to in writing, "
+		"software",
+	" * distributed under the License is distributed on an \"AS IS\" "
+		"BASIS,",
+	" * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or",
+	" * implied.  See the License for the specific language governing",
+	" * permissions and limitations under the License.",
+	NULL
+};
+
+
+/* emit_upper()
+ *
+ * in:     out - file to write to
+ *         s   - identifier to write
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes s in upper case, for the prefix of generated macro names.
+ */
+
+static void
+emit_upper(FILE *out, const char *s) {
+
+	for (; *s; s++) fputc(toupper((unsigned char)*s), out);
+
+} /* emit_upper() */
+
+
+/* emit_prelude()
+ *
+ * in:     out       - file to write to
+ *         p_prelude - comments and blank lines to write
+ *         indent    - string to start each line with
+ * out:    nothing
+ * return: nothing
+ *
+ * Each run of consecutive comment lines in the prelude becomes one C
+ * comment, on one line if the run is one line long.  Label lines
+ * become one-line comments naming the label.
+ */
+
+static void
+emit_prelude(FILE *out, const asm_prelude_t *p_prelude,
+	const char *indent) {
+
+	const char *line, *next;
+	bool first = true;   /* first line of a comment? */
+	bool last;           /* last line of a comment? */
+	int len;
+
+	for (line = p_prelude->text; *line; line = next + 1) {
+		next = strchr(line, '\n');
+		len  = (int)(next - line);
+
+		if (line[0] == '@') {
+			fprintf(out, "%s/* %.*s */\n", indent, len - 1,
+				&(line[1]));
+		} else if (line[0] == ';') {
+			last = (next[1] != ';');
+			fprintf(out, "%s%s", indent, (first ? "/*" : " *"));
+			if (len > 1) fprintf(out, " %.*s", len - 1, &(line[1]));
+			if (last && first) {
+				fprintf(out, " */\n");
+			} else if (last) {
+				fprintf(out, "\n%s */\n", indent);
+			} else {
+				fprintf(out, "\n");
+			}
+			first = last;
+		} else {
+			fprintf(out, "\n");
+		}
+	}
+
+} /* emit_prelude() */
+
+
+/* emit_operand()
+ *
+ * in:     out     - file to write to
+ *         program - the program being written
+ *         pc      - index of the instruction whose operand to write
+ * out:    nothing
+ * return: number of characters written.
+ *
+ * Writes the instruction's operand as a convenience macro argument.
+ * Names of strings become indices into the string table and labels
+ * become JMPIF offsets.
+ */
+
+static int
+emit_operand(FILE *out, const asm_program_t *program, int pc) {
+
+	const asm_instruction_t *p_i = &(program->instructions[pc]);
+
+	switch (p_i->p_op->operand) {
+	case ao_rep:
+		return fprintf(out, "(%lu)", p_i->rep);
+	case ao_layout:
+		return fprintf(out, "(0x%04lX)", p_i->rep);
+	case ao_num:
+	case ao_bool:
+		return fprintf(out, "(%s)", p_i->operand);
+	case ao_str:
+	case ao_names:
+		return fprintf(out, "(%d)", p_i->target);
+	case ao_sub:
+		return fprintf(out, "(%s)", program->subs[p_i->target].name);
+	case ao_label:
+		return fprintf(out, "(%d)", p_i->target - pc);
+	default:
+		return 0;
+	}
+
+} /* emit_operand() */
+
+
+/* emit_instruction()
+ *
+ * in:     out     - file to write to
+ *         program - the program being written
+ *         pc      - index of the instruction to write
+ * out:    nothing
+ * return: nothing
+ */
+
+static void
+emit_instruction(FILE *out, const asm_program_t *program, int pc) {
+
+	const asm_instruction_t *p_i = &(program->instructions[pc]);
+	int width = 8;    /* columns written so far, tab included */
+	int pad;          /* spaces before the trailing comment */
+
+	emit_prelude(out, &(p_i->prelude), "\t");
+	width += fprintf(out, "\t%s", p_i->p_op->mnemonic) - 1;
+	width += emit_operand(out, program, pc);
+	width += fprintf(out, ",");
+
+	if (p_i->comment[0]) {
+		pad = ((width < COMMENT_COLUMN) ? (COMMENT_COLUMN - width) : 1);
+		if ((width + pad + (int)strlen(p_i->comment) + 6) >
+			LINE_MAX_COLUMN) {
+			pad = 1;   /* try it closer to the instruction */
+		}
+		if ((width + pad + (int)strlen(p_i->comment) + 6) >
+			LINE_MAX_COLUMN) {
+			/* Too long to fit after the instruction at all. */
+			fprintf(out, "\n\t\t/* %s */", p_i->comment);
+		} else {
+			fprintf(out, "%*s/* %s */", pad, "", p_i->comment);
+		}
+	}
+	fprintf(out, "\n");
+
+} /* emit_instruction() */
+
+
+/* ------------------- module exported functions -------------------- */
+
+
+/* emit_wcet()
+ *
+ * in:     out     - file to write to
+ *         program - a program that has assembled without errors
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes <NAME>_WCET_STEPS and, if gruntasm had a cost file,
+ * <NAME>_WCET_CYCLES.
+ */
+
+static void
+emit_wcet(FILE *out, const asm_program_t *program) {
+
+	const char *costs;    /* cost file name without its directory */
+
+	fprintf(out, "/* The most instructions one run of the program "
+		"executes");
+	if (program->costs) {
+		costs = strrchr(program->costs, '/');
+		costs = (costs ? (costs + 1) : program->costs);
+		fprintf(out, ", and the\n * most cycles it takes at the "
+			"costs in %s", costs);
+	}
+	fprintf(out, (program->costs ? ".\n */\n#define " :
+		". */\n#define "));
+	emit_upper(out, program->name);
+	fprintf(out, "_WCET_STEPS  %lu\n", program->wcet_steps);
+	if (program->costs) {
+		fprintf(out, "#define ");
+		emit_upper(out, program->name);
+		fprintf(out, "_WCET_CYCLES %lu\n", program->wcet_cycles);
+	}
+	fprintf(out, "\n");
+
+} /* emit_wcet() */
+
+
+/* emit_header()
+ *
+ * in:     out     - file to write to
+ *         program - a program that has assembled without errors
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes the program as a C header defining <name>_strings[],
+ * <name>_string_lengths[] for GRUNT_SetStringLengths(), and
+ * <name>_program[] and their sizes, and the program's worst case
+ * from report_wcet().  The header may be included a
+ * second time with GRUNT_XMACRO_EXPAND defined to get just the
+ * program's instructions.
+ */
+
+void
+emit_header(FILE *out, const asm_program_t *program) {
+
+	const asm_string_t *p_string;
+	const char *source;   /* source file name without its directory */
+	const char **p_line;
+	int i, s, pc, pad;
+
+	source = strrchr(program->source, '/');
+	source = (source ? (source + 1) : program->source);
+
+	fprintf(out, "#if !defined(_");
+	emit_upper(out, program->name);
+	fprintf(out, "_H_) || defined(GRUNT_XMACRO_EXPAND)\n");
+	fprintf(out, "#ifndef GRUNT_XMACRO_EXPAND\n#define _");
+	emit_upper(out, program->name);
+	fprintf(out, "_H_\n\n");
+	fprintf(out, "/* Copyright (c) 2024 Timothy Jon Fraser "
+		"Consulting LLC\n *\n");
+	for (p_line = license; *p_line; p_line++)
+		fprintf(out, "%s\n", *p_line);
+	fprintf(out, " */\n\n");
+	fprintf(out, "/* GENERATED FILE - DO NOT EDIT.\n *\n");
+	fprintf(out, " * The gruntasm assembler generated this file from "
+		"the Grunt assembly\n * source in %s.  Edit the source and "
+		"run gruntasm again instead.\n *\n", source);
+	fprintf(out, " * Including this file again with GRUNT_XMACRO_EXPAND "
+		"defined yields\n * only the program's instructions, for "
+		"grunt_xmacro.h to expand into\n * C statements.\n */\n");
+
+	emit_prelude(out, &(program->strings_prelude), "");
+	fprintf(out, "static const char *%s_strings[] = {\n", program->name);
+	for (i = 0; i < program->num_strings; i++) {
+		p_string = &(program->strings[i]);
+		emit_prelude(out, &(p_string->prelude), "\t");
+		pad = STRING_COMMENT_COLUMN - (int)strlen(p_string->text);
+		fprintf(out, "\t%s,%*s/* %d %s */\n", p_string->text,
+			((pad > 1) ? pad : 1), "", i, p_string->name);
+	}
+	if (!program->num_strings) {
+		fprintf(out, "\tNULL,   /* C has no empty arrays */\n");
+	}
+	fprintf(out, "};\n#define ");
+	emit_upper(out, program->name);
+	fprintf(out, "_NUM_STRINGS %d\n", program->num_strings);
+
+	fprintf(out, "\nstatic const grunt_rep_t %s_string_lengths[] = {\n",
+		program->name);
+	for (i = 0; i < program->num_strings; i++) {
+		p_string = &(program->strings[i]);
+		fprintf(out, "\t%lu,%*s/* %d %s */\n", p_string->length,
+			(int)(STRING_COMMENT_COLUMN -
+			snprintf(NULL, 0, "%lu", p_string->length)), "",
+			i, p_string->name);
+	}
+	if (!program->num_strings) {
+		fprintf(out, "\t0,      /* C has no empty arrays */\n");
+	}
+	fprintf(out, "};\n");
+
+	if (program->has_record) {
+		emit_prelude(out, &(program->record_prelude), "");
+		fprintf(out, "#define ");
+		emit_upper(out, program->name);
+		fprintf(out, "_RECORD_OFFSET %lu\n#define ",
+			program->record_offset);
+		emit_upper(out, program->name);
+		fprintf(out, "_RECORD_SIZE   %lu\n", program->record_size);
+	}
+
+	emit_prelude(out, &(program->program_prelude), "");
+	for (s = 0; s < program->num_subs; s++) {
+		fprintf(out, "#define %-24s %d\n", program->subs[s].name,
+			program->subs[s].start);
+	}
+	fprintf(out, "#define ");
+	emit_upper(out, program->name);
+	fprintf(out, "_NUM_INSTRUCTIONS %d\n\n", program->num_instructions);
+	emit_wcet(out, program);
+
+	fprintf(out, "static const grunt_instruction_t %s_program[] = {\n",
+		program->name);
+	fprintf(out, "#endif /* GRUNT_XMACRO_EXPAND */\n");
+	for (pc = 0; pc < program->num_instructions; pc++) {
+		emit_instruction(out, program, pc);
+	}
+	emit_prelude(out, &(program->tail), "\t");
+	fprintf(out, "#ifndef GRUNT_XMACRO_EXPAND\n};\n#endif\n\n#endif\n");
+
+} /* emit_header() */
@@ -0,0 +1,1157 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* gruntasm is a host-side assembler for Grunt programs.  It reads a
+ * Grunt assembly source file that names its subroutines, jump
+ * targets, and strings symbolically, and writes a C header that
+ * defines the program's string table and instruction array in the
+ * same form as a hand-written one, ready for GRUNT_Run() or the
+ * gruntaot translator.  The assembler computes every CALL address and
+ * JMPIF offset, so adding or removing instructions never requires
+ * recounting by hand.  It also prints a report of each subroutine's
+ * size and stack use.
+ *
+ * A source file looks like this:
+ *
+ *   ; Comments run from a semicolon to the end of the line.
+ *   .name   vsvf          ; prefix for generated identifiers
+ *   .record 0 12          ; optional record view of the input
+ *   .strings
+ *   S_HELLO "Hello"       ; string names are C-style identifiers
+ *   .program
+ *   .sub    MAIN          ; the first subroutine is the entry point
+ *           PUSHS S_HELLO
+ *           OUTPUT
+ *           PUSHB true
+ *           JMPIF done    ; labels are local to their subroutine
+ *           ...
+ *   done:
+ *           PUSHB true
+ *           HALT
+ *
+ * Comments and blank lines that come after the .name directive are
+ * copied into the generated header in front of whatever follows them,
+ * so the header keeps the source's documentation.  Comments before
+ * .name describe the source file itself and aren't copied.
+ *
+ * A LOOKUP's table follows it in the source as ordinary PUSHN and
+ * PUSHS instructions, and a SWITCH's as ordinary JMPIFs.  Each
+ * REPEAT pairs with the next unpaired END in its subroutine, and
+ * jumps may not enter or leave the body between them.  INPUTREC's
+ * operand lists the widths of its record's fields in bytes, in
+ * order, as in "INPUTREC 1,2,4,4".  A FORMAT right after the PUSHS
+ * of its template must take as many values as the template has '%'
+ * placeholders.  CLASSIFY names the first of the run of strings that
+ * hold its parm names, which must all be in the .strings section, in
+ * VS_PARM_NAME_* order.  With -O,
+ * gruntasm runs the program through the Grunt library's optimizer
+ * before writing it; see optimize.c.  With -b, it refuses to write a
+ * program that exceeds the given budget, as in
+ * "-b size=4096,steps=2000,stack=16"; see report.c.  With -c, it
+ * weights each instruction by its opcode's cost in the given cost
+ * file, reports the most cycles the program can take, and writes the
+ * figure into the header as <NAME>_WCET_CYCLES.  A cost file holds
+ * one mnemonic and its cost in cycles per line, in the format
+ * grunt_bench --costs writes, with comments as in assembly source.
+ * Opcodes the file leaves out cost as much as its dearest.  With -p,
+ * it reorders the program's subroutines by the execution profile in
+ * the given file, as grunt_bench --pcs writes it, so that the hot ones
+ * come first; see layout.c.
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cfe.h"
+
+#include "grunt.h"
+
+#include "gruntasm.h"
+
+
+/* The Grunt mnemonics and the kind of operand each one takes. */
+static const asm_op_t ops[] = {
+	{ "ADD",      GRUNT_OP_ADD,      ao_none   },
+	{ "AND",      GRUNT_OP_AND,      ao_rep    },
+	{ "CALL",     GRUNT_OP_CALL,     ao_sub    },
+	{ "CLASSIFY", GRUNT_OP_CLASSIFY, ao_names  },
+	{ "DUP",      GRUNT_OP_DUP,      ao_rep    },
+	{ "END",      GRUNT_OP_END,      ao_none   },
+	{ "EQ",       GRUNT_OP_EQ,       ao_rep    },
+	{ "FLUSH",    GRUNT_OP_FLUSH,    ao_none   },
+	{ "FORMAT",   GRUNT_OP_FORMAT,   ao_rep    },
+	{ "GT",       GRUNT_OP_GT,       ao_none   },
+	{ "HALT",     GRUNT_OP_HALT,     ao_none   },
+	{ "INPUT",    GRUNT_OP_INPUT,    ao_rep    },
+	{ "INPUTREC", GRUNT_OP_INPUTREC, ao_layout },
+	{ "INPUTZ",   GRUNT_OP_INPUTZ,   ao_rep    },
+	{ "JMPIF",    GRUNT_OP_JMPIF,    ao_label  },
+	{ "LOOKUP",   GRUNT_OP_LOOKUP,   ao_rep    },
+	{ "LT",       GRUNT_OP_LT,       ao_none   },
+	{ "NOT",      GRUNT_OP_NOT,      ao_none   },
+	{ "OR",       GRUNT_OP_OR,       ao_rep    },
+	{ "OUTPUT",   GRUNT_OP_OUTPUT,   ao_none   },
+	{ "POP",      GRUNT_OP_POP,      ao_rep    },
+	{ "PUSHB",    GRUNT_OP_PUSHB,    ao_bool   },
+	{ "PUSHN",    GRUNT_OP_PUSHN,    ao_num    },
+	{ "PUSHS",    GRUNT_OP_PUSHS,    ao_str    },
+	{ "REPEAT",   GRUNT_OP_REPEAT,   ao_rep    },
+	{ "RETURN",   GRUNT_OP_RETURN,   ao_none   },
+	{ "REWIND",   GRUNT_OP_REWIND,   ao_rep    },
+	{ "ROLL",     GRUNT_OP_ROLL,     ao_rep    },
+	{ "SUB",      GRUNT_OP_SUB,      ao_none   },
+	{ "SWITCH",   GRUNT_OP_SWITCH,   ao_rep    },
+	{ NULL,       0,                 ao_none   },
+};
+
+static asm_program_t program;  /* too big for the stack */
+
+static enum {
+	section_none,       /* before .strings or .program */
+	section_strings,    /* after .strings */
+	section_program,    /* after .program */
+} section = section_none;
+
+static asm_prelude_t pending;  /* comments waiting for their item */
+static bool seen_name = false; /* copying comments yet? */
+static int  line_number = 0;   /* of the line being parsed */
+static int  error_count = 0;
+static int  loop_of[ASM_MAX_INSTRUCTIONS];  /* innermost REPEAT or -1 */
+
+
+/* find_op()
+ *
+ * in:     op - a GRUNT_OP_* opcode
+ * out:    nothing
+ * return: the mnemonic for op.
+ *
+ * Callers must pass an opcode that has a mnemonic.
+ */
+
+const asm_op_t *
+find_op(grunt_opcode_t op) {
+
+	const asm_op_t *p_op;
+
+	for (p_op = ops; p_op->mnemonic && (p_op->op != op); p_op++);
+	return p_op;
+
+} /* find_op() */
+
+
+/* error()
+ *
+ * in:     line   - source line number the error is on
+ *         format - printf()-style message format, then its args
+ * out:    nothing
+ * return: nothing
+ *
+ * Reports an error in the source file.  The assembler keeps going so
+ * it can report as many errors as possible, but writes no output.
+ */
+
+static void
+error(int line, const char *format, ...) {
+
+	va_list args;
+
+	fprintf(stderr, "%s:%d: ", program.source, line);
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+	fprintf(stderr, "\n");
+	error_count++;
+
+} /* error() */
+
+
+/* append_pending()
+ *
+ * in:     line - a line to add to the pending prelude
+ * out:    pending - line appended, followed by a newline
+ * return: nothing
+ */
+
+static void
+append_pending(const char *line) {
+
+	size_t used = strlen(pending.text);
+
+	if ((used + strlen(line) + 2) > sizeof(pending.text)) {
+		error(line_number, "too many comment lines in a row");
+		return;
+	}
+	strcat(pending.text, line);
+	strcat(pending.text, "\n");
+
+} /* append_pending() */
+
+
+/* take_pending()
+ *
+ * in:     nothing
+ * out:    p_prelude - receives the pending prelude
+ *         pending   - emptied
+ * return: nothing
+ */
+
+static void
+take_pending(asm_prelude_t *p_prelude) {
+
+	*p_prelude = pending;
+	pending.text[0] = '\0';
+
+} /* take_pending() */
+
+
+/* is_name()
+ *
+ * in:     s - string to check
+ * out:    nothing
+ * return: true if s is a C-style identifier that fits in a name.
+ */
+
+static bool
+is_name(const char *s) {
+
+	size_t i;
+
+	if (!(isalpha((unsigned char)s[0]) || (s[0] == '_'))) return false;
+	for (i = 1; s[i]; i++) {
+		if (!(isalnum((unsigned char)s[i]) || (s[i] == '_')))
+			return false;
+	}
+	return (i < ASM_NAME_MAX_LEN);
+
+} /* is_name() */
+
+
+/* parse_decimal()
+ *
+ * in:     s   - string to parse
+ *         max - largest acceptable value
+ * out:    p_u - set to the value of s
+ * return: true if s is a decimal number no larger than max.
+ */
+
+static bool
+parse_decimal(const char *s, unsigned long max, unsigned long *p_u) {
+
+	char *end;
+
+	if (!isdigit((unsigned char)s[0])) return false;
+	errno = 0;
+	*p_u = strtoul(s, &end, 10);
+	return ((*end == '\0') && (errno == 0) && (*p_u <= max));
+
+} /* parse_decimal() */
+
+
+/* parse_layout()
+ *
+ * in:     s   - string to parse
+ * out:    p_u - set to the INPUTREC layout s describes
+ * return: true if s is a comma-separated list of 1 to
+ *         GRUNT_INPUTREC_MAX_FIELDS field widths, each 1, 2, or 4.
+ */
+
+static bool
+parse_layout(const char *s, unsigned long *p_u) {
+
+	int i;
+
+	*p_u = 0;
+	for (i = 0; i < GRUNT_INPUTREC_MAX_FIELDS; i++) {
+		if ((s[0] != '1') && (s[0] != '2') && (s[0] != '4'))
+			return false;
+		*p_u |= GRUNT_INPUTREC_FIELD(i, s[0] - '0');
+		if (s[1] == '\0') return true;
+		if (s[1] != ',') return false;
+		s += 2;
+	}
+	return false;
+
+} /* parse_layout() */
+
+
+/* split_comment()
+ *
+ * in:     line - source line, without its newline
+ * out:    line - truncated at its comment, trailing space trimmed
+ *         p_comment - set to the comment text, or NULL if none
+ * return: nothing
+ *
+ * Semicolons inside string literals don't start comments.  One space
+ * after the semicolon is part of the comment syntax, not its text.
+ */
+
+static void
+split_comment(char *line, const char **p_comment) {
+
+	bool in_string = false;
+	char *p;
+	size_t n;
+
+	*p_comment = NULL;
+	for (p = line; *p; p++) {
+		if (in_string && (*p == '\\') && p[1]) {
+			p++;
+		} else if (*p == '"') {
+			in_string = !in_string;
+		} else if (!in_string && (*p == ';')) {
+			*p = '\0';
+			*p_comment = ((p[1] == ' ') ? &(p[2]) : &(p[1]));
+			break;
+		}
+	}
+
+	for (n = strlen(line); n && isspace((unsigned char)line[n - 1]); n--)
+		line[n - 1] = '\0';
+
+} /* split_comment() */
+
+
+/* parse_directive()
+ *
+ * in:     words - the directive and its arguments
+ *         count - number of words
+ * out:    program - updated as the directive directs
+ * return: nothing
+ */
+
+static void
+parse_directive(char *words[], int count) {
+
+	asm_sub_t *p_sub;
+
+	if (!strcmp(words[0], ".name")) {
+		if ((count != 2) || !is_name(words[1])) {
+			error(line_number, ".name needs one name");
+			return;
+		}
+		strcpy(program.name, words[1]);
+		seen_name = true;
+		pending.text[0] = '\0';   /* comments about the source */
+	} else if (!strcmp(words[0], ".record")) {
+		if ((count != 3) ||
+			!parse_decimal(words[1], GRUNT_REP_MAX,
+				&program.record_offset) ||
+			!parse_decimal(words[2], GRUNT_REP_MAX,
+				&program.record_size) ||
+			(program.record_size == 0)) {
+			error(line_number, ".record needs an offset and a "
+				"nonzero size");
+			return;
+		}
+		program.has_record = true;
+		take_pending(&program.record_prelude);
+	} else if (!strcmp(words[0], ".strings") && (count == 1)) {
+		section = section_strings;
+		take_pending(&program.strings_prelude);
+	} else if (!strcmp(words[0], ".program") && (count == 1)) {
+		section = section_program;
+		take_pending(&program.program_prelude);
+	} else if (!strcmp(words[0], ".sub")) {
+		if (section != section_program) {
+			error(line_number, ".sub outside .program");
+			return;
+		}
+		if ((count != 2) || !is_name(words[1])) {
+			error(line_number, ".sub needs one name");
+			return;
+		}
+		if (program.num_subs == ASM_MAX_SUBS) {
+			error(line_number, "too many subroutines");
+			return;
+		}
+		if (program.num_subs) {
+			program.subs[program.num_subs - 1].end =
+				program.num_instructions;
+		}
+		p_sub = &(program.subs[program.num_subs++]);
+		strcpy(p_sub->name, words[1]);
+		p_sub->start = program.num_instructions;
+		p_sub->end   = program.num_instructions;
+		p_sub->line  = line_number;
+		/* The sub's comments go in front of its first instruction. */
+	} else {
+		error(line_number, "unknown directive %s", words[0]);
+	}
+
+} /* parse_directive() */
+
+
+/* measure_string()
+ *
+ * in:     text           - a C string literal, quotes and all
+ * out:    p_string       - length and placeholders of the string text
+ *                          denotes
+ * return: false if text holds an escape we don't understand.
+ */
+
+static bool
+measure_string(const char *text, asm_string_t *p_string) {
+
+	const char *p, *p_end = text + strlen(text) - 1;  /* closing quote */
+	int c, i;
+
+	p_string->length = 0;
+	p_string->placeholders = 0;
+	for (p = text + 1; p < p_end; p_string->length++) {
+		if (*p != '\\') {
+			c = *p++;
+		} else if (p[1] == 'x') {
+			for (p += 2, c = 0; isxdigit((unsigned char)*p); p++)
+				c = (c * 16) + (isdigit((unsigned char)*p) ?
+					(*p - '0') : (tolower(*p) - 'a' + 10));
+		} else if ((p[1] >= '0') && (p[1] <= '7')) {
+			for (p++, c = 0, i = 0; (i < 3) && (*p >= '0') &&
+				(*p <= '7'); i++, p++)
+				c = (c * 8) + (*p - '0');
+		} else if (strchr("abfnrtv\\'\"?", p[1])) {
+			c = p[1];
+			p += 2;
+		} else {
+			return false;
+		}
+		if (c == '%') p_string->placeholders++;
+	}
+	return true;
+
+} /* measure_string() */
+
+
+/* parse_string()
+ *
+ * in:     code - a .strings section line: a name and a string literal
+ * out:    program - string appended
+ * return: nothing
+ */
+
+static void
+parse_string(char *code) {
+
+	asm_string_t *p_string;
+	char *text;
+	size_t n;
+
+	for (text = code; *text && !isspace((unsigned char)*text); text++);
+	if (*text) *text++ = '\0';
+	while (isspace((unsigned char)*text)) text++;
+	n = strlen(text);
+
+	if (!is_name(code) || (n < 2) || (text[0] != '"') ||
+		(text[n - 1] != '"') || (text[n - 2] == '\\')) {
+		error(line_number, "expected a name and a string literal");
+		return;
+	}
+	if (program.num_strings == ASM_MAX_STRINGS) {
+		error(line_number, "too many strings");
+		return;
+	}
+	p_string = &(program.strings[program.num_strings]);
+	if (!measure_string(text, p_string)) {
+		error(line_number, "unknown escape in string literal");
+		return;
+	}
+	program.num_strings++;
+	strcpy(p_string->name, code);
+	strcpy(p_string->text, text);
+	take_pending(&(p_string->prelude));
+
+} /* parse_string() */
+
+
+/* parse_instruction()
+ *
+ * in:     words   - the mnemonic and its operand, if any
+ *         count   - number of words
+ *         comment - the line's trailing comment, or NULL
+ * out:    program - instruction appended
+ * return: nothing
+ *
+ * Checks the form of the operand.  resolve() checks that names refer
+ * to things that exist once the whole source has been read.
+ */
+
+static void
+parse_instruction(char *words[], int count, const char *comment) {
+
+	asm_instruction_t *p_i;
+	const asm_op_t *p_op;
+	unsigned long u;
+
+	for (p_op = ops; p_op->mnemonic; p_op++) {
+		if (!strcmp(p_op->mnemonic, words[0])) break;
+	}
+	if (!p_op->mnemonic) {
+		error(line_number, "unknown mnemonic %s", words[0]);
+		return;
+	}
+	if (count != ((p_op->operand == ao_none) ? 1 : 2)) {
+		error(line_number, "%s takes %s operand", words[0],
+			((p_op->operand == ao_none) ? "no" : "one"));
+		return;
+	}
+	if (!program.num_subs) {
+		error(line_number, "instruction before the first .sub");
+		return;
+	}
+	if (program.num_instructions == ASM_MAX_INSTRUCTIONS) {
+		error(line_number, "too many instructions");
+		return;
+	}
+
+	p_i = &(program.instructions[program.num_instructions]);
+	memset(p_i, 0, sizeof(*p_i));
+	p_i->p_op = p_op;
+	p_i->sub  = program.num_subs - 1;
+	p_i->line = line_number;
+	if (count == 2) {
+		if (strlen(words[1]) >= sizeof(p_i->operand)) {
+			error(line_number, "operand too long");
+			return;
+		}
+		strcpy(p_i->operand, words[1]);
+	}
+	if (comment) {
+		strncpy(p_i->comment, comment, sizeof(p_i->comment) - 1);
+	}
+
+	switch (p_op->operand) {
+	case ao_rep:
+		if (!parse_decimal(words[1], GRUNT_REP_MAX, &(p_i->rep))) {
+			error(line_number, "%s needs a repetition count",
+				words[0]);
+		}
+		break;
+	case ao_layout:
+		if (!parse_layout(words[1], &(p_i->rep))) {
+			error(line_number, "%s needs a list of up to %d field "
+				"widths, each 1, 2, or 4", words[0],
+				GRUNT_INPUTREC_MAX_FIELDS);
+		}
+		break;
+	case ao_num:
+		if (!is_name(words[1]) &&
+			!parse_decimal(words[1], GRUNT_NUM_MAX, &u)) {
+			error(line_number, "%s needs a number or constant name",
+				words[0]);
+		}
+		break;
+	case ao_bool:
+		if (strcmp(words[1], "true") && strcmp(words[1], "false")) {
+			error(line_number, "%s needs true or false", words[0]);
+		}
+		break;
+	case ao_str:
+	case ao_names:
+	case ao_sub:
+	case ao_label:
+		if (!is_name(words[1])) {
+			error(line_number, "%s needs a name", words[0]);
+		}
+		break;
+	default:
+		break;
+	}
+
+	take_pending(&(p_i->prelude));
+	program.num_instructions++;
+
+} /* parse_instruction() */
+
+
+/* parse_label()
+ *
+ * in:     name    - label name, without its colon
+ *         comment - the line's trailing comment, or NULL
+ * out:    program - label added for the next instruction
+ * return: nothing
+ */
+
+static void
+parse_label(const char *name, const char *comment) {
+
+	asm_label_t *p_label;
+	char line[ASM_LINE_MAX_LEN + ASM_NAME_MAX_LEN];
+	int i;
+
+	if ((section != section_program) || !program.num_subs) {
+		error(line_number, "label outside a subroutine");
+		return;
+	}
+	if (!is_name(name)) {
+		error(line_number, "bad label name %s", name);
+		return;
+	}
+	for (i = 0; i < program.num_labels; i++) {
+		if ((program.labels[i].sub == (program.num_subs - 1)) &&
+			!strcmp(program.labels[i].name, name)) {
+			error(line_number, "label %s already defined on line %d",
+				name, program.labels[i].line);
+			return;
+		}
+	}
+	if (program.num_labels == ASM_MAX_LABELS) {
+		error(line_number, "too many labels");
+		return;
+	}
+	p_label = &(program.labels[program.num_labels++]);
+	strcpy(p_label->name, name);
+	p_label->sub  = program.num_subs - 1;
+	p_label->pc   = program.num_instructions;
+	p_label->line = line_number;
+
+	/* The emitter writes "@" lines as label comments. */
+	snprintf(line, sizeof(line), "@%s:%s%s", name,
+		(comment ? "  " : ""), (comment ? comment : ""));
+	append_pending(line);
+
+} /* parse_label() */
+
+
+/* parse_line()
+ *
+ * in:     line - source line, without its newline
+ * out:    program - updated with whatever the line holds
+ * return: nothing
+ */
+
+static void
+parse_line(char *line) {
+
+	char *words[4];      /* more than any valid line has */
+	const char *comment;
+	char comment_line[ASM_LINE_MAX_LEN + 2];
+	char *p;
+	int count = 0;
+	size_t n;
+
+	split_comment(line, &comment);
+	for (p = line; isspace((unsigned char)*p); p++);
+
+	/* Lines holding only comments or nothing at all become part
+	 * of the prelude of the next item.  The emitter writes lines
+	 * beginning with ";" as comments.
+	 */
+	if (!*p) {
+		if (!seen_name) return;
+		if (comment) {
+			snprintf(comment_line, sizeof(comment_line), ";%s",
+				comment);
+			append_pending(comment_line);
+		} else {
+			append_pending("");
+		}
+		return;
+	}
+
+	if (section == section_strings && (*p != '.')) {
+		parse_string(p);
+		return;
+	}
+
+	n = strlen(p);
+	if (p[n - 1] == ':') {
+		p[n - 1] = '\0';
+		parse_label(p, comment);
+		return;
+	}
+
+	/* Everything else is a directive or instruction: words
+	 * separated by white space.
+	 */
+	while (*p && (count < 4)) {
+		words[count++] = p;
+		while (*p && !isspace((unsigned char)*p)) p++;
+		if (*p) *p++ = '\0';
+		while (isspace((unsigned char)*p)) p++;
+	}
+	if (*p) count = 4;   /* so the checks below reject it */
+
+	if (words[0][0] == '.') {
+		parse_directive(words, count);
+	} else if (section == section_program) {
+		parse_instruction(words, count, comment);
+	} else {
+		error(line_number, "instruction outside .program");
+	}
+
+} /* parse_line() */
+
+
+/* resolve_loops()
+ *
+ * in:     nothing
+ * out:    loop_of[] - pc of the REPEAT whose body holds each
+ *                     instruction, or -1
+ * return: nothing
+ *
+ * Pairs each REPEAT with the next unpaired END in its subroutine.  An
+ * END belongs to the body it closes, and the REPEAT to the body
+ * around it.  GRUNT_Verify() rejects a RETURN in a body, so the
+ * assembler does too.
+ */
+
+static void
+resolve_loops(void) {
+
+	const asm_instruction_t *p_i;
+	int open[ASM_MAX_INSTRUCTIONS];   /* REPEATs awaiting their ENDs */
+	int depth = 0;
+	int pc;
+
+	for (pc = 0; pc < program.num_instructions; pc++) {
+		p_i = &(program.instructions[pc]);
+		for (; depth && (program.instructions[open[depth - 1]].sub !=
+			p_i->sub); depth--) {
+			error(program.instructions[open[depth - 1]].line,
+				"REPEAT has no END");
+		}
+		loop_of[pc] = (depth ? open[depth - 1] : -1);
+
+		switch (p_i->p_op->op) {
+		case GRUNT_OP_REPEAT:
+			open[depth++] = pc;
+			break;
+		case GRUNT_OP_END:
+			if (depth) {
+				depth--;
+			} else {
+				error(p_i->line, "END without REPEAT");
+			}
+			break;
+		case GRUNT_OP_RETURN:
+			if (depth) error(p_i->line, "RETURN inside a loop");
+			break;
+		default:
+			break;
+		}
+	}
+	for (; depth; depth--) {
+		error(program.instructions[open[depth - 1]].line,
+			"REPEAT has no END");
+	}
+
+} /* resolve_loops() */
+
+
+/* resolve()
+ *
+ * in:     nothing
+ * out:    program - target of each name operand set
+ * return: nothing
+ *
+ * Grunt allows only forward CALLs and JMPIFs, and a JMPIF must skip
+ * at least one instruction unless it is an entry in a SWITCH's table.
+ * A JMPIF must land in the same loop body it jumps from.
+ */
+
+static void
+resolve(void) {
+
+	asm_instruction_t *p_i;
+	int pc, i;
+	int table_end = 0;   /* pc past the last SWITCH's table */
+
+	resolve_loops();
+	for (pc = 0; pc < program.num_instructions; pc++) {
+		p_i = &(program.instructions[pc]);
+		p_i->target = -1;
+		if (p_i->p_op->op == GRUNT_OP_SWITCH)
+			table_end = pc + 1 + (int)p_i->rep;
+
+		switch (p_i->p_op->operand) {
+		case ao_str:
+		case ao_names:
+			for (i = 0; i < program.num_strings; i++) {
+				if (!strcmp(program.strings[i].name,
+					p_i->operand)) p_i->target = i;
+			}
+			if (p_i->target < 0)
+				error(p_i->line, "no string %s", p_i->operand);
+			break;
+		case ao_sub:
+			for (i = 0; i < program.num_subs; i++) {
+				if (!strcmp(program.subs[i].name, p_i->operand))
+					p_i->target = i;
+			}
+			if (p_i->target < 0) {
+				error(p_i->line, "no subroutine %s",
+					p_i->operand);
+			} else if (program.subs[p_i->target].start <= pc) {
+				error(p_i->line, "CALL %s is not forward",
+					p_i->operand);
+			}
+			break;
+		case ao_label:
+			for (i = 0; i < program.num_labels; i++) {
+				if ((program.labels[i].sub == p_i->sub) &&
+					!strcmp(program.labels[i].name,
+						p_i->operand))
+					p_i->target = program.labels[i].pc;
+			}
+			if (p_i->target < 0) {
+				error(p_i->line, "no label %s in subroutine %s",
+					p_i->operand,
+					program.subs[p_i->sub].name);
+			} else if (pc < table_end) {
+				if (p_i->target < (pc + 1))
+					error(p_i->line, "SWITCH entry %s is "
+						"not forward", p_i->operand);
+			} else if (p_i->target < (pc + 2)) {
+				error(p_i->line, "JMPIF %s must skip at least "
+					"one instruction", p_i->operand);
+			}
+			if ((p_i->target >= 0) &&
+				(p_i->target < program.num_instructions) &&
+				(loop_of[p_i->target] != loop_of[pc])) {
+				error(p_i->line, "JMPIF %s enters or leaves a "
+					"loop", p_i->operand);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	for (i = 0; i < program.num_labels; i++) {
+		if (program.labels[i].pc ==
+			program.subs[program.labels[i].sub].end) {
+			error(program.labels[i].line, "label %s labels no "
+				"instruction", program.labels[i].name);
+		}
+	}
+
+	for (i = 0; i < program.num_subs; i++) {
+		if (program.subs[i].start == program.subs[i].end) {
+			error(program.subs[i].line, "subroutine %s is empty",
+				program.subs[i].name);
+		}
+	}
+
+} /* resolve() */
+
+
+/* read_costs()
+ *
+ * in:     path   - name of the cost file to read
+ * out:    cycles - cost of each opcode
+ * return: true if the file names each mnemonic at most once, with a
+ *         decimal cost, and names at least one.
+ */
+
+static bool
+read_costs(const char *path, unsigned long cycles[ASM_NUM_OPCODES]) {
+
+	char line[ASM_LINE_MAX_LEN + 2];
+	char *mnemonic, *cost;
+	const char *comment;
+	const asm_op_t *p_op;
+	unsigned long u, dearest = 0;
+	bool listed[ASM_NUM_OPCODES];
+	bool ok = true;
+	int number = 0;
+	int op;
+	FILE *in;
+
+	if (!(in = fopen(path, "r"))) {
+		perror(path);
+		return false;
+	}
+	memset(listed, 0, sizeof(listed));
+	while (ok && fgets(line, sizeof(line), in)) {
+		number++;
+		split_comment(line, &comment);
+		if (!(mnemonic = strtok(line, " \t\r\n"))) continue;
+		cost = strtok(NULL, " \t\r\n");
+		for (p_op = ops; p_op->mnemonic &&
+			strcmp(p_op->mnemonic, mnemonic); p_op++);
+		if (!p_op->mnemonic || listed[p_op->op] || !cost ||
+			strtok(NULL, " \t\r\n") ||
+			!parse_decimal(cost, ULONG_MAX, &u)) {
+			fprintf(stderr, "%s:%d: bad cost\n", path, number);
+			ok = false;
+			break;
+		}
+		listed[p_op->op] = true;
+		cycles[p_op->op] = u;
+		if (u > dearest) dearest = u;
+	}
+	fclose(in);
+	if (ok && !dearest) {
+		fprintf(stderr, "%s: no costs\n", path);
+		ok = false;
+	}
+
+	for (op = 0; op < ASM_NUM_OPCODES; op++) {
+		if (!listed[op]) cycles[op] = dearest;
+	}
+	return ok;
+
+} /* read_costs() */
+
+
+/* read_profile()
+ *
+ * in:     path   - name of the layout profile to read
+ * out:    counts - executions of each pc of the program as assembled
+ *         p_runs - number of runs the profile covers
+ * return: true if the profile is of this program and counts only its
+ *         pcs, each at most once.
+ *
+ * A profile's first line gives the instruction count of the program
+ * it profiled, the FNV-1a hash of its opcodes, and the runs profiled,
+ * such as "program 387 0x2179C910 39936"; grunt_bench --pcs writes
+ * one.  A profile of any other program, including a laid-out or
+ * optimized one, is rejected.
+ */
+
+static bool
+read_profile(const char *path, unsigned long counts[ASM_MAX_INSTRUCTIONS],
+	unsigned long *p_runs) {
+
+	char line[ASM_LINE_MAX_LEN + 2];
+	char *words[5];
+	const char *comment;
+	unsigned long hash = 2166136261UL;    /* FNV-1a offset basis */
+	unsigned long u, pc;
+	bool seen_program = false;
+	bool listed[ASM_MAX_INSTRUCTIONS];
+	bool ok = true;
+	int number = 0;
+	int count, i;
+	FILE *in;
+
+	for (i = 0; i < program.num_instructions; i++) {
+		hash = ((hash ^ program.instructions[i].p_op->op) *
+			16777619UL) & 0xFFFFFFFFUL;
+	}
+
+	if (!(in = fopen(path, "r"))) {
+		perror(path);
+		return false;
+	}
+	memset(listed, 0, sizeof(listed));
+	memset(counts, 0, ASM_MAX_INSTRUCTIONS * sizeof(counts[0]));
+	while (ok && fgets(line, sizeof(line), in)) {
+		number++;
+		split_comment(line, &comment);
+		for (count = 0; (count < 5) && (words[count] =
+			strtok(count ? NULL : line, " \t\r\n")); count++);
+		if (!count) continue;
+
+		if (!seen_program) {
+			seen_program = true;
+			if ((count != 4) || strcmp(words[0], "program") ||
+				!parse_decimal(words[1], INT_MAX, &u) ||
+				(u != (unsigned long)program.num_instructions) ||
+				(strtoul(words[2], NULL, 16) != hash) ||
+				!parse_decimal(words[3], ULONG_MAX, p_runs) ||
+				!*p_runs) {
+				fprintf(stderr, "%s:%d: not a profile of %s\n",
+					path, number, program.source);
+				ok = false;
+			}
+		} else if ((count != 2) ||
+			!parse_decimal(words[0],
+			(unsigned long)program.num_instructions - 1, &pc) ||
+			listed[pc] || !parse_decimal(words[1], ULONG_MAX, &u)) {
+			fprintf(stderr, "%s:%d: bad pc count\n", path, number);
+			ok = false;
+		} else {
+			listed[pc] = true;
+			counts[pc] = u;
+		}
+	}
+	fclose(in);
+	if (ok && !seen_program) {
+		fprintf(stderr, "%s: no program line\n", path);
+		ok = false;
+	}
+	return ok;
+
+} /* read_profile() */
+
+
+/* parse_budget()
+ *
+ * in:     s        - comma-separated list of name=value limits
+ * out:    p_budget - limits s names set
+ * return: true if s names only size, steps, cycles, and stack, each
+ *         with a decimal value.
+ */
+
+static bool
+parse_budget(char *s, asm_budget_t *p_budget) {
+
+	char *item, *value;
+	unsigned long u;
+
+	for (item = strtok(s, ","); item; item = strtok(NULL, ",")) {
+		if (!(value = strchr(item, '='))) return false;
+		*value++ = '\0';
+		if (!parse_decimal(value, ULONG_MAX, &u)) return false;
+		if (!strcmp(item, "size")) {
+			p_budget->size = u;
+		} else if (!strcmp(item, "steps")) {
+			p_budget->steps = u;
+		} else if (!strcmp(item, "cycles")) {
+			p_budget->cycles = u;
+		} else if (!strcmp(item, "stack")) {
+			p_budget->stack = u;
+		} else {
+			return false;
+		}
+	}
+	return true;
+
+} /* parse_budget() */
+
+
+int
+main(int argc, char *argv[]) {
+
+	char line[ASM_LINE_MAX_LEN + 2];
+	FILE *in, *out;
+	asm_budget_t budget = { 0, 0, 0, 0 };
+	unsigned long cycles[ASM_NUM_OPCODES];
+	static unsigned long counts[ASM_MAX_INSTRUCTIONS];
+	unsigned long runs;
+	const unsigned long *costs;
+	const char *profile = NULL;
+	bool optimize = false;
+	bool usage = false;
+	int status;
+	size_t n;
+
+	while ((argc > 1) && (argv[1][0] == '-')) {
+		if (!strcmp(argv[1], "-O")) {
+			optimize = true;
+		} else if (!strcmp(argv[1], "-b") && (argc > 2) &&
+			parse_budget(argv[2], &budget)) {
+			argc--;
+			argv++;
+		} else if (!strcmp(argv[1], "-c") && (argc > 2)) {
+			if (!read_costs(argv[2], cycles)) return -1;
+			program.costs = argv[2];
+			argc--;
+			argv++;
+		} else if (!strcmp(argv[1], "-p") && (argc > 2)) {
+			profile = argv[2];
+			argc--;
+			argv++;
+		} else {
+			usage = true;
+			break;
+		}
+		argc--;
+		argv++;
+	}
+	if (usage || (argc != 3)) {
+		fprintf(stderr, "Usage:\n");
+		fprintf(stderr, "\tgruntasm [-O] [-b budget] [-c costs] "
+			"[-p profile] source.gasm header.h :\n"
+			"\t\tassemble source.gasm into header.h, optimizing "
+			"it with -O,\n"
+			"\t\tfailing if it exceeds budget, a list such as\n"
+			"\t\tsize=4096,steps=2000,cycles=90000,stack=16, "
+			"costing its\n"
+			"\t\tinstructions by the cost file costs, and laying "
+			"out its\n"
+			"\t\tsubroutines by the execution profile profile\n");
+		return -1;
+	}
+	program.source = argv[1];
+
+	if (!(in = fopen(argv[1], "r"))) {
+		perror(argv[1]);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), in)) {
+		line_number++;
+		n = strlen(line);
+		if (n && (line[n - 1] == '\n')) {
+			line[--n] = '\0';
+		} else if (!feof(in)) {
+			error(line_number, "line too long");
+			break;
+		}
+		if (n && (line[n - 1] == '\r')) line[--n] = '\0';
+		parse_line(line);
+	}
+	fclose(in);
+	take_pending(&program.tail);
+
+	if (!program.name[0]) error(line_number, "no .name directive");
+	if (!program.num_subs) error(line_number, "no subroutines");
+	if (program.num_subs) {
+		program.subs[program.num_subs - 1].end =
+			program.num_instructions;
+	}
+	resolve();
+	costs = (program.costs ? cycles : NULL);
+	if (!error_count) error_count += report_analyze(&program, costs);
+	if (!error_count && profile) {
+		/* Lay out the program the profile was taken of, before
+		 * the optimizer changes it, and analyze it again.
+		 */
+		if (!read_profile(profile, counts, &runs)) {
+			error_count++;
+		} else {
+			layout_program(&program, counts, runs);
+			error_count += report_analyze(&program, costs);
+		}
+	}
+	if (!error_count && optimize) {
+		/* Analyze the optimized program again for the report. */
+		if ((status = optimize_program(&program))) {
+			fprintf(stderr, "%s: optimizer failed with 0x%08X\n",
+				argv[1], (unsigned int)status);
+			error_count++;
+		} else {
+			error_count += report_analyze(&program, costs);
+		}
+	}
+	if (!error_count) {
+		report_wcet(&program.wcet_steps, &program.wcet_cycles);
+		if ((error_count = report_budget(&program, &budget))) {
+			/* Show what went over before refusing the program. */
+			report_print(stdout, &program);
+		}
+	}
+	if (error_count) {
+		fprintf(stderr, "%s: %d errors; %s not written\n", argv[1],
+			error_count, argv[2]);
+		return -1;
+	}
+
+	if (!(out = fopen(argv[2], "w"))) {
+		perror(argv[2]);
+		return -1;
+	}
+	emit_header(out, &program);
+	fclose(out);
+
+	report_print(stdout, &program);
+	return 0;
+
+} /* main() */
@@ -0,0 +1,150 @@
+#ifndef _GRUNTASM_H_
+#define _GRUNTASM_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* These definitions describe a Grunt assembly source file after the
+ * gruntasm parser has read it.  The parser fills in an asm_program_t;
+ * the optimizer may rewrite it, and the stack-depth report and the
+ * header emitter read it.
+ */
+
+#define ASM_LINE_MAX_LEN   256    /* longest source line */
+#define ASM_NAME_MAX_LEN   64     /* longest name or label */
+#define ASM_TEXT_MAX_LEN   4096   /* most comment text before one item */
+#define ASM_MAX_STRINGS    256
+#define ASM_MAX_SUBS       128
+#define ASM_MAX_LABELS     512
+#define ASM_MAX_INSTRUCTIONS 1024
+#define ASM_NUM_OPCODES    64     /* more than the largest GRUNT_OP_* */
+
+/* The kinds of operand a mnemonic takes. */
+typedef enum {
+	ao_none,     /* no operand */
+	ao_rep,      /* repetition count, a decimal number */
+	ao_layout,   /* INPUTREC field widths, such as 1,2,4,4 */
+	ao_num,      /* number: a decimal number or a C constant name */
+	ao_bool,     /* true or false */
+	ao_str,      /* name of a string in the .strings section */
+	ao_names,    /* name of the first of a run of strings */
+	ao_sub,      /* name of a subroutine */
+	ao_label,    /* name of a label in the current subroutine */
+} asm_operand_t;
+
+/* One Grunt mnemonic.  The stack effect of instructions whose
+ * effect depends on their repetition count is worked out in report.c.
+ */
+typedef struct {
+	const char    *mnemonic;
+	grunt_opcode_t op;       /* GRUNT_OP_* opcode */
+	asm_operand_t  operand;
+} asm_op_t;
+
+/* Comments and blank lines that precede an item in the source.  The
+ * emitter copies them into the generated header ahead of the item.
+ */
+typedef struct {
+	char text[ASM_TEXT_MAX_LEN];   /* C comments and newlines */
+} asm_prelude_t;
+
+typedef struct {
+	const asm_op_t *p_op;
+	char  operand[ASM_NAME_MAX_LEN];     /* operand as written */
+	char  comment[ASM_LINE_MAX_LEN];     /* trailing comment, or "" */
+	unsigned long rep;    /* value of ao_rep and ao_layout operands */
+	int   target;    /* string, subroutine, or instruction index */
+	int   sub;       /* index of the subroutine holding it */
+	int   line;      /* source line number */
+	asm_prelude_t prelude;
+} asm_instruction_t;
+
+typedef struct {
+	char  name[ASM_NAME_MAX_LEN];
+	char  text[ASM_LINE_MAX_LEN];        /* C string literal */
+	unsigned long length;     /* of the string the literal denotes */
+	int   placeholders;       /* '%'s in it, for FORMAT */
+	asm_prelude_t prelude;
+} asm_string_t;
+
+typedef struct {
+	char  name[ASM_NAME_MAX_LEN];
+	int   start;     /* index of its first instruction */
+	int   end;       /* index just past its last instruction */
+	int   line;      /* source line number */
+} asm_sub_t;
+
+typedef struct {
+	char  name[ASM_NAME_MAX_LEN];
+	int   sub;       /* subroutine the label belongs to */
+	int   pc;        /* index of the instruction it labels */
+	int   line;      /* source line number */
+} asm_label_t;
+
+typedef struct {
+	const char *source;                  /* source file name */
+	char  name[ASM_NAME_MAX_LEN];        /* from the .name directive */
+	bool  has_record;                    /* saw a .record directive */
+	unsigned long record_offset;
+	unsigned long record_size;
+	asm_prelude_t strings_prelude;       /* before .strings */
+	asm_prelude_t record_prelude;        /* before .record */
+	asm_prelude_t program_prelude;       /* before .program */
+	asm_prelude_t tail;                  /* after the last item */
+	const char *costs;                   /* -c cost file, or NULL */
+	unsigned long wcet_steps;            /* from report_wcet() */
+	unsigned long wcet_cycles;
+	int num_strings;
+	int num_subs;
+	int num_labels;
+	int num_instructions;
+	asm_string_t      strings[ASM_MAX_STRINGS];
+	asm_sub_t         subs[ASM_MAX_SUBS];
+	asm_label_t       labels[ASM_MAX_LABELS];
+	asm_instruction_t instructions[ASM_MAX_INSTRUCTIONS];
+} asm_program_t;
+
+/* The mnemonic for an opcode; see gruntasm.c. */
+const asm_op_t *find_op(grunt_opcode_t);
+
+/* gruntasm -O's optimization; see optimize.c. */
+int  optimize_program(asm_program_t *);
+
+/* gruntasm -p's profile-guided layout; see layout.c. */
+void layout_program(asm_program_t *, const unsigned long *, unsigned long);
+
+/* Limits gruntasm -b checks a program against, each 0 for none.
+ * size is in bytes encoded, steps in instructions run, cycles in the
+ * units of gruntasm -c's costs, and stack in slots of either stack.
+ */
+typedef struct {
+	unsigned long size;
+	unsigned long steps;
+	unsigned long cycles;
+	unsigned long stack;
+} asm_budget_t;
+
+/* Stack-depth and worst-case cost analysis, report, and budget
+ * check; see report.c.
+ */
+int  report_analyze(const asm_program_t *, const unsigned long *);
+void report_wcet(unsigned long *, unsigned long *);
+void report_print(FILE *, const asm_program_t *);
+int  report_budget(const asm_program_t *, const asm_budget_t *);
+
+/* Header generation; see emit.c. */
+void emit_header(FILE *, const asm_program_t *);
+
+#endif
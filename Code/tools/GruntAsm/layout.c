@@ -0,0 +1,175 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module reorders an assembled program's subroutines for
+ * gruntasm -p, so that the code a profile shows running most sits
+ * together at the front of the program and the code it shows running
+ * rarely or never, such as error reporting, sits at the end.  Packed
+ * code holds one word per instruction, so hot code that is contiguous
+ * shares cache lines rather than one line per hot subroutine.
+ *
+ * Subroutines move whole.  Every JMPIF stays inside its subroutine,
+ * so moving them keeps each jump's offset; every CALL must still go
+ * forward, so a subroutine is placed only after all its callers.  The
+ * entry point stays first.  Of the subroutines whose callers are all
+ * placed, the one whose instructions ran most often on average goes
+ * next, so a large subroutine that runs one short path of many
+ * doesn't crowd out a small one that runs every time.  Ties keep
+ * source order, so subroutines the profile never saw run keep their
+ * source order at the end.  No subroutine can fall off its end into
+ * the next, since report_analyze() rejects programs that would.
+ *
+ * Instructions keep their comments and the comments and labels in
+ * front of them, so a subroutine's comments move with it.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cfe.h"
+
+#include "grunt.h"
+
+#include "gruntasm.h"
+
+#define LAYOUT_LINE_BYTES 64    /* cache line size */
+#define LAYOUT_LINE_WORDS (LAYOUT_LINE_BYTES / sizeof(grunt_packed_t))
+
+
+/* ----------------- module private functions and state ------------- */
+
+static asm_instruction_t old[ASM_MAX_INSTRUCTIONS];
+static asm_sub_t         old_subs[ASM_MAX_SUBS];
+static int new_pc[ASM_MAX_INSTRUCTIONS];   /* old pc's new pc */
+static int new_sub[ASM_MAX_SUBS];          /* old sub's new index */
+
+
+/* hot_lines()
+ *
+ * in:     counts   - executions of each pc as assembled
+ *         runs     - number of runs the profile covers
+ *         n        - number of instructions
+ *         laid_out - true to count lines after layout, by new_pc[]
+ * out:    p_last   - index of the last cache line holding hot code,
+ *                    or -1 if none does
+ * return: number of packed code's cache lines holding hot code, the
+ *         instructions that ran at least once a run on average.
+ */
+
+static int
+hot_lines(const unsigned long *counts, unsigned long runs, int n,
+	bool laid_out, int *p_last) {
+
+	bool hot[ASM_MAX_INSTRUCTIONS / LAYOUT_LINE_WORDS + 1];
+	int pc, line, lines = 0;
+
+	memset(hot, 0, sizeof(hot));
+	for (pc = 0; pc < n; pc++) {
+		if (counts[pc] >= runs)
+			hot[(laid_out ? new_pc[pc] : pc) / LAYOUT_LINE_WORDS] =
+				true;
+	}
+
+	*p_last = -1;
+	for (line = 0; line <= (n - 1) / (int)LAYOUT_LINE_WORDS; line++) {
+		if (!hot[line]) continue;
+		lines++;
+		*p_last = line;
+	}
+	return lines;
+
+} /* hot_lines() */
+
+
+/* ------------------- module exported functions -------------------- */
+
+
+/* layout_program()
+ *
+ * in:     program - a program that has assembled without errors
+ *         counts  - executions of each of its pcs
+ *         runs    - number of runs the profile covers
+ * out:    program - the program with its subroutines reordered
+ * return: nothing
+ */
+
+void
+layout_program(asm_program_t *program, const unsigned long *counts,
+	unsigned long runs) {
+
+	static double heat[ASM_MAX_SUBS];   /* executions per instruction */
+	static int callers[ASM_MAX_SUBS];          /* CALLs yet to place */
+	static bool placed[ASM_MAX_SUBS];
+	asm_instruction_t *p_i;
+	int n = program->num_instructions;
+	int s, best, pc, next = 0, i;
+	int lines_before, last_before, lines_after, last_after;
+
+	memcpy(old, program->instructions, sizeof(old));
+	memcpy(old_subs, program->subs, sizeof(old_subs));
+	memset(heat, 0, sizeof(heat));
+	memset(callers, 0, sizeof(callers));
+	memset(placed, 0, sizeof(placed));
+
+	for (pc = 0; pc < n; pc++) {
+		heat[old[pc].sub] += (double)counts[pc];
+		if (old[pc].p_op->operand == ao_sub) callers[old[pc].target]++;
+	}
+	for (s = 0; s < program->num_subs; s++)
+		heat[s] /= (double)(old_subs[s].end - old_subs[s].start);
+
+	/* CALLs go forward, so the entry point has no callers and some
+	 * subroutine is always ready.
+	 */
+	for (i = 0; i < program->num_subs; i++) {
+		for (best = -1, s = 0; s < program->num_subs; s++) {
+			if (placed[s] || callers[s]) continue;
+			if ((best < 0) || (heat[s] > heat[best])) best = s;
+		}
+		placed[best]  = true;
+		new_sub[best] = i;
+		program->subs[i] = old_subs[best];
+		program->subs[i].start = next;
+		for (pc = old_subs[best].start; pc < old_subs[best].end; pc++) {
+			new_pc[pc] = next++;
+			if (old[pc].p_op->operand == ao_sub)
+				callers[old[pc].target]--;
+		}
+		program->subs[i].end = next;
+	}
+
+	for (pc = 0; pc < n; pc++) {
+		p_i  = &(program->instructions[new_pc[pc]]);
+		*p_i = old[pc];
+		p_i->sub = new_sub[old[pc].sub];
+		if (p_i->p_op->operand == ao_sub)
+			p_i->target = new_sub[old[pc].target];
+		else if (p_i->p_op->operand == ao_label)
+			p_i->target = new_pc[old[pc].target];
+	}
+	for (i = 0; i < program->num_labels; i++) {
+		program->labels[i].pc  = new_pc[program->labels[i].pc];
+		program->labels[i].sub = new_sub[program->labels[i].sub];
+	}
+
+	lines_before = hot_lines(counts, runs, n, false, &last_before);
+	lines_after  = hot_lines(counts, runs, n, true, &last_after);
+	fprintf(stdout, "%s: laid out by profile; hot code fills %d of %d "
+		"%d-byte lines,\n\tthe last at line %d, from %d lines, the "
+		"last at line %d\n", program->source, lines_after,
+		(int)((n + LAYOUT_LINE_WORDS - 1) / LAYOUT_LINE_WORDS),
+		LAYOUT_LINE_BYTES, last_after, lines_before, last_before);
+
+} /* layout_program() */
@@ -0,0 +1,320 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module runs an assembled program through the Grunt library's
+ * optimizer for gruntasm -O.  It translates the asm_program_t into
+ * grunt_instruction_t form, has GRUNT_Optimize()'s engine rewrite it,
+ * and rebuilds the asm_program_t from the result, so the report and
+ * the emitter work on the optimized program as they would on one read
+ * from source.
+ *
+ * Many PUSHN operands are C constant names whose values only the C
+ * compiler knows, so the optimizer runs in GRUNT_OPTIMIZE_SYMBOLIC
+ * mode: each distinct operand is a distinct name.  It folds only
+ * comparisons of a name with itself, and does no arithmetic.
+ *
+ * Instructions the optimizer copies keep their operands as written and
+ * their trailing comments.  Those it rewrites get operands written
+ * from their new values and lose their comments, which described the
+ * stack as it was.  Comments and labels in front of instructions the
+ * optimizer removes move to the next instruction that remains.  The
+ * copies it inlines in place of a CALL belong to the caller's
+ * subroutine, take the CALL's comments and labels, and lose their own
+ * trailing comments, which described the callee's stack.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cfe.h"
+
+#include "grunt.h"
+#include "grunt_optimize.h"
+
+#include "gruntasm.h"
+
+
+/* ----------------- module private functions and state ------------- */
+
+static grunt_instruction_t code[ASM_MAX_INSTRUCTIONS];
+static grunt_pc_t          origin[ASM_MAX_INSTRUCTIONS];
+static asm_instruction_t   old[ASM_MAX_INSTRUCTIONS];
+static asm_sub_t           old_subs[ASM_MAX_SUBS];
+static bool moved[ASM_MAX_INSTRUCTIONS];   /* prelude placed yet? */
+
+
+/* to_grunt()
+ *
+ * in:     program - the program to translate
+ * out:    code[]  - the program as grunt_instruction_t
+ * return: nothing
+ *
+ * Each PUSHN's literal names its operand: it is the pc of the first
+ * PUSHN with the same operand text.
+ */
+
+static void
+to_grunt(const asm_program_t *program) {
+
+	const asm_instruction_t *p_a;
+	grunt_instruction_t *p_g;
+	int pc, i;
+
+	memset(code, 0, sizeof(code));
+	for (pc = 0; pc < program->num_instructions; pc++) {
+		p_a = &(program->instructions[pc]);
+		p_g = &(code[pc]);
+		p_g->op = p_a->p_op->op;
+
+		switch (p_a->p_op->operand) {
+		case ao_rep:
+		case ao_layout:
+			p_g->arg.rep = (grunt_rep_t)p_a->rep;
+			break;
+		case ao_num:
+			for (i = 0; i < pc; i++) {
+				if ((program->instructions[i].p_op->operand ==
+					ao_num) && !strcmp(p_a->operand,
+					program->instructions[i].operand))
+					break;
+			}
+			p_g->arg.lit.type    = gt_num;
+			p_g->arg.lit.val.num = (grunt_number_t)i;
+			break;
+		case ao_bool:
+			p_g->arg.lit.type  = gt_bool;
+			p_g->arg.lit.val.b = !strcmp(p_a->operand, "true");
+			break;
+		case ao_str:
+			p_g->arg.lit.type    = gt_str;
+			p_g->arg.lit.val.str = (grunt_string_t)p_a->target;
+			break;
+		case ao_names:
+			p_g->arg.rep = (grunt_rep_t)p_a->target;
+			break;
+		case ao_sub:
+			p_g->arg.lit.type   = gt_pc;
+			p_g->arg.lit.val.pc =
+				(grunt_pc_t)program->subs[p_a->target].start;
+			break;
+		case ao_label:
+			p_g->arg.lit.type   = gt_pc;
+			p_g->arg.lit.val.pc = (grunt_pc_t)(p_a->target - pc);
+			break;
+		default:
+			break;
+		}
+	}
+
+} /* to_grunt() */
+
+
+/* move_preludes()
+ *
+ * in:     through - last original pc whose prelude to move
+ *         p_into  - prelude of an instruction of the optimized program
+ * out:    p_into  - preludes of the original instructions up through
+ *                   through not yet moved, in order
+ * return: nothing
+ */
+
+static void
+move_preludes(int through, asm_prelude_t *p_into) {
+
+	size_t room;
+	int pc;
+
+	p_into->text[0] = '\0';
+	for (pc = 0; pc <= through; pc++) {
+		if (moved[pc]) continue;
+		moved[pc] = true;
+		room = sizeof(p_into->text) - strlen(p_into->text) - 1;
+		strncat(p_into->text, old[pc].prelude.text, room);
+	}
+
+} /* move_preludes() */
+
+
+/* owner()
+ *
+ * in:     pc - pc of an instruction of the optimized program
+ *         n  - number of instructions in code[]
+ * out:    nothing
+ * return: the original pc of the first instruction at or after pc that
+ *         is not an inlined copy.
+ *
+ * An inlined copy belongs where the CALL it replaced stood, before
+ * the instruction that followed that CALL.  Some instruction of the
+ * caller always follows, since a leaf always returns.
+ */
+
+static int
+owner(int pc, int n) {
+
+	while ((pc < n) && (origin[pc] & GRUNT_OPTIMIZE_INLINED)) pc++;
+	return (origin[pc] & ~GRUNT_OPTIMIZE_REWRITTEN);
+
+} /* owner() */
+
+
+/* from_grunt()
+ *
+ * in:     n       - number of instructions in code[]
+ * out:    program - instructions and subroutines rebuilt from code[]
+ *                   and origin[]
+ * return: nothing
+ */
+
+static void
+from_grunt(asm_program_t *program, int n) {
+
+	asm_instruction_t *p_a;
+	const grunt_instruction_t *p_g;
+	const asm_op_t *p_op;
+	int pc, o, s, last = -1, table_end = 0;
+
+	memcpy(old, program->instructions, sizeof(old));
+	memcpy(old_subs, program->subs, sizeof(old_subs));
+	memset(moved, true, sizeof(moved));
+
+	/* Each subroutine starts at the first instruction that came from
+	 * it or was inlined into it, and ends where the next one starts.
+	 * The optimizer drops subroutines no one calls, and their
+	 * comments with them.
+	 */
+	program->num_subs = 0;
+	for (pc = 0; pc < n; pc++) {
+		o = owner(pc, n);
+		for (s = 0; o >= old_subs[s].end; s++);
+		if (s == last) continue;
+		if (program->num_subs)
+			program->subs[program->num_subs - 1].end = pc;
+		program->subs[program->num_subs] = old_subs[s];
+		program->subs[program->num_subs].start = pc;
+		program->num_subs++;
+		for (o = old_subs[s].start; o < old_subs[s].end; o++)
+			moved[o] = false;
+		last = s;
+	}
+	program->subs[program->num_subs - 1].end = n;
+
+	for (pc = 0; pc < n; pc++) {
+		o   = (origin[pc] &
+			~(GRUNT_OPTIMIZE_REWRITTEN | GRUNT_OPTIMIZE_INLINED));
+		p_a = &(program->instructions[pc]);
+		p_g = &(code[pc]);
+
+		*p_a = old[o];
+		if (origin[pc] & GRUNT_OPTIMIZE_INLINED) {
+			move_preludes(owner(pc, n) - 1, &(p_a->prelude));
+			p_a->comment[0] = '\0';
+		} else {
+			move_preludes(o, &(p_a->prelude));
+		}
+		for (s = 0; program->subs[s].end <= pc; s++);
+		p_a->sub = s;
+
+		/* A LOOKUP's or SWITCH's table entries describe no
+		 * stack.
+		 */
+		if (pc < table_end) p_a->comment[0] = '\0';
+		if (p_g->op == GRUNT_OP_LOOKUP)
+			table_end = pc + (2 * p_g->arg.rep) + 2;
+		else if (p_g->op == GRUNT_OP_SWITCH)
+			table_end = pc + p_g->arg.rep + 1;
+
+		if (origin[pc] & GRUNT_OPTIMIZE_REWRITTEN) {
+			p_a->p_op = p_op = find_op(p_g->op);
+			p_a->comment[0] = '\0';
+			switch (p_op->operand) {
+			case ao_rep:
+				p_a->rep = p_g->arg.rep;
+				snprintf(p_a->operand, sizeof(p_a->operand),
+					"%lu", p_a->rep);
+				break;
+			case ao_layout:
+				p_a->rep = p_g->arg.rep;  /* as written */
+				break;
+			case ao_num:
+				strcpy(p_a->operand,
+					old[p_g->arg.lit.val.num].operand);
+				break;
+			case ao_bool:
+				strcpy(p_a->operand, (p_g->arg.lit.val.b ?
+					"true" : "false"));
+				break;
+			case ao_str:
+				p_a->target = p_g->arg.lit.val.str;
+				strcpy(p_a->operand,
+					program->strings[p_a->target].name);
+				break;
+			case ao_names:
+				p_a->target = p_g->arg.rep;
+				strcpy(p_a->operand,
+					program->strings[p_a->target].name);
+				break;
+			default:
+				p_a->operand[0] = '\0';
+				break;
+			}
+		}
+
+		if (p_g->op == GRUNT_OP_JMPIF) {
+			p_a->target = pc + p_g->arg.lit.val.pc;
+		} else if (p_g->op == GRUNT_OP_CALL) {
+			for (s = 0; program->subs[s].start !=
+				p_g->arg.lit.val.pc; s++);
+			p_a->target = s;
+			strcpy(p_a->operand, program->subs[s].name);
+		}
+	}
+	program->num_instructions = n;
+
+} /* from_grunt() */
+
+
+/* ------------------- module exported functions -------------------- */
+
+
+/* optimize_program()
+ *
+ * in:     program - a program that has assembled without errors
+ * out:    program - the optimized program
+ * return: 0 on success, else the GRUNT_ERROR_* code from the optimizer.
+ *
+ * Leaves the program as it was if the optimizer fails.
+ */
+
+int
+optimize_program(asm_program_t *program) {
+
+	grunt_optimized_program_t optimized = {
+		code, origin, ASM_MAX_INSTRUCTIONS, 0, GRUNT_OPTIMIZE_SYMBOLIC
+	};
+	int status;
+
+	to_grunt(program);
+	if ((status = grunt_optimize_program(code,
+		(grunt_pc_t)program->num_instructions,
+		(grunt_string_t)program->num_strings, &optimized)))
+		return status;
+
+	fprintf(stdout, "%s: optimized from %d to %d instructions\n",
+		program->source, program->num_instructions,
+		optimized.num_instructions);
+	from_grunt(program, optimized.num_instructions);
+	return 0;
+
+} /* optimize_program() */
@@ -0,0 +1,667 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module works out how each subroutine of an assembled program
+ * uses the arg and control stacks and how many instructions it can
+ * run, prints the size and stack-depth report, and checks the program
+ * against the budgets given on the command line.  It tracks only
+ * stack depths, not the types of the values on the stacks;
+ * GRUNT_Verify() checks those when the app loads the program.
+ *
+ * Grunt CALLs, JMPIFs, LOOKUPs, and SWITCHes are all forward, so each
+ * subroutine's callees come after it and the analysis can summarize
+ * subroutines in reverse order.  Within a subroutine, a single pass
+ * in program counter order sees every path into an instruction before
+ * the instruction itself.  Every path into an instruction must arrive
+ * with the same arg stack depth, as it must in any sensible
+ * hand-written Grunt program.  A REPEAT's body must leave the arg
+ * stack as deep as it found it, so every trip around the loop starts
+ * at the same depth, and each loop open around a CALL adds two slots
+ * to the control stack.
+ *
+ * The same pass finds the most instructions any path runs to reach
+ * each instruction, and the most cycles, weighting each instruction
+ * by its opcode's cost.  A loop's body runs its count of times, with the
+ * longest path through the body each time, so the count after its END
+ * is the count at its body's start plus the count times the body's
+ * longest path.  A path that HALTs inside a loop may first have gone
+ * around the loop every time but the last, so its count grows by the
+ * rest of the loop when the pass reaches the END.  Every instruction
+ * counts as one, and a CALL as one plus its callee's count.  The
+ * instruction count and the cycle count each take the worst path for
+ * itself, so the two may come from different paths.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cfe.h"
+
+#include "grunt.h"
+#include "vs_parmclass.h"
+
+#include "gruntasm.h"
+
+
+/* ----------------- module private functions and state ------------- */
+
+/* Instructions and cycles some path runs. */
+typedef struct {
+	unsigned long steps;
+	unsigned long cycles;
+} cost_t;
+
+/* What a caller needs to know about a subroutine.  Depths are
+ * relative to the arg stack depth at the CALL.
+ */
+typedef struct {
+	bool returns;   /* some path RETURNs rather than HALTs */
+	int  args;      /* values it needs from its caller's arg stack */
+	int  net;       /* change in arg stack depth when it RETURNs */
+	int  peak;      /* deepest arg stack it builds */
+	int  calls;     /* deepest control stack it builds */
+	cost_t worst;   /* most a call runs */
+} sub_info_t;
+
+static sub_info_t info[ASM_MAX_SUBS];
+static int  depth_at[ASM_MAX_INSTRUCTIONS];  /* arg stack depth before */
+static bool reached[ASM_MAX_INSTRUCTIONS];   /* some path gets here */
+static int  loop_depth[ASM_MAX_INSTRUCTIONS]; /* depth at open REPEATs */
+static cost_t cost_at[ASM_MAX_INSTRUCTIONS];    /* most run before */
+static cost_t loop_start[ASM_MAX_INSTRUCTIONS]; /* at open bodies */
+static cost_t loop_halt[ASM_MAX_INSTRUCTIONS];  /* steps 0 for none */
+static unsigned long loop_count[ASM_MAX_INSTRUCTIONS]; /* REPEAT counts */
+static const unsigned long *op_cycles;          /* by opcode, or */
+static unsigned long unit_cycles[ASM_NUM_OPCODES]; /* 1 for each */
+
+
+/* analysis_error()
+ *
+ * in:     program - the program being analyzed
+ *         p_i     - instruction with the error
+ *         message - description of the error
+ *         value   - a number the message refers to
+ * out:    nothing
+ * return: 1, for adding to an error count.
+ */
+
+static int
+analysis_error(const asm_program_t *program, const asm_instruction_t *p_i,
+	const char *message, int value) {
+
+	fprintf(stderr, "%s:%d: %s: ", program->source, p_i->line,
+		program->subs[p_i->sub].name);
+	fprintf(stderr, message, value);
+	fprintf(stderr, "\n");
+	return 1;
+
+} /* analysis_error() */
+
+
+/* encoded_size()
+ *
+ * in:     program - the program being measured
+ * out:    nothing
+ * return: bytes the generated header's <name>_program[] and
+ *         <name>_strings[] occupy, counting each string's literal.
+ */
+
+static unsigned long
+encoded_size(const asm_program_t *program) {
+
+	unsigned long size;
+	int i;
+
+	size = (unsigned long)program->num_instructions *
+		sizeof(grunt_instruction_t);
+	for (i = 0; i < program->num_strings; i++) {
+		size += sizeof(const char *) + program->strings[i].length + 1;
+	}
+	return size;
+
+} /* encoded_size() */
+
+
+/* cost_max()
+ *
+ * in:     p_max - cost to raise
+ *         p_c   - cost of another path
+ * out:    p_max - raised to p_c where p_c is higher
+ * return: nothing
+ */
+
+static void
+cost_max(cost_t *p_max, const cost_t *p_c) {
+
+	if (p_c->steps > p_max->steps)   p_max->steps  = p_c->steps;
+	if (p_c->cycles > p_max->cycles) p_max->cycles = p_c->cycles;
+
+} /* cost_max() */
+
+
+/* cost_trips()
+ *
+ * in:     p_c     - cost to add to
+ *         p_start - cost at the start of a loop's body
+ *         p_end   - cost at the end of the body's longest path
+ *         trips   - trips around the loop to add
+ * out:    p_c     - grown by trips trips
+ * return: nothing
+ */
+
+static void
+cost_trips(cost_t *p_c, const cost_t *p_start, const cost_t *p_end,
+	unsigned long trips) {
+
+	p_c->steps  += trips * (p_end->steps - p_start->steps);
+	p_c->cycles += trips * (p_end->cycles - p_start->cycles);
+
+} /* cost_trips() */
+
+
+/* reach()
+ *
+ * in:     program - the program being analyzed
+ *         p_from  - instruction control flows from
+ *         pc      - instruction control flows to
+ *         depth   - arg stack depth control arrives with
+ *         p_cost  - cost run before control arrives
+ * out:    reached[], depth_at[], cost_at[] - updated for pc
+ * return: number of errors found.
+ */
+
+static int
+reach(const asm_program_t *program, const asm_instruction_t *p_from,
+	int pc, int depth, const cost_t *p_cost) {
+
+	if (pc == program->subs[p_from->sub].end) {
+		return analysis_error(program, p_from, "control falls off "
+			"the end of the subroutine%.0d", 0);
+	}
+	if (reached[pc] && (depth_at[pc] != depth)) {
+		return analysis_error(program, &(program->instructions[pc]),
+			"paths arrive with different stack depths, one with "
+			"%d", depth);
+	}
+	if (!reached[pc]) {
+		cost_at[pc] = *p_cost;
+	} else {
+		cost_max(&(cost_at[pc]), p_cost);
+	}
+	reached[pc] = true;
+	depth_at[pc] = depth;
+	return 0;
+
+} /* reach() */
+
+
+/* analyze_switch()
+ *
+ * in:     program - the program being analyzed
+ *         p_sub   - subroutine holding the SWITCH
+ *         pc      - pc of the SWITCH
+ *         d       - arg stack depth after it pops its key
+ *         p_cost  - cost run once the SWITCH has run
+ * out:    nothing
+ * return: number of errors found.
+ *
+ * A SWITCH reaches the target of each of its entries and the
+ * instruction after its table, but not the entries themselves.
+ */
+
+static int
+analyze_switch(const asm_program_t *program, const asm_sub_t *p_sub,
+	int pc, int d, const cost_t *p_cost) {
+
+	const asm_instruction_t *p_i = &(program->instructions[pc]);
+	const asm_instruction_t *p_e;
+	int rep = (int)p_i->rep;
+	int errors = 0;
+	int e;
+
+	if (rep < 1) {
+		return analysis_error(program, p_i,
+			"SWITCH needs at least one entry%.0d", 0);
+	}
+	if ((pc + rep + 1) > p_sub->end) {
+		return analysis_error(program, p_i, "SWITCH table of %d "
+			"runs off the end of the subroutine", rep);
+	}
+
+	for (e = pc + 1; e <= (pc + rep); e++) {
+		p_e = &(program->instructions[e]);
+		if (p_e->p_op->op != GRUNT_OP_JMPIF) {
+			errors += analysis_error(program, p_e,
+				"SWITCH table entry is not a JMPIF%.0d", 0);
+			continue;
+		}
+		errors += reach(program, p_e, p_e->target, d, p_cost);
+	}
+	errors += reach(program, p_i, pc + rep + 1, d, p_cost);
+
+	return errors;
+
+} /* analyze_switch() */
+
+
+/* ends()
+ *
+ * in:     p_info - summary of the subroutine being analyzed
+ *         loops  - number of REPEATs open around the path's end
+ *         p_cost - cost the path runs
+ * out:    p_info->worst or loop_halt[] - updated
+ * return: nothing
+ *
+ * Records a path that leaves the subroutine by HALTing or RETURNing.
+ */
+
+static void
+ends(sub_info_t *p_info, int loops, const cost_t *p_cost) {
+
+	if (loops) {
+		cost_max(&(loop_halt[loops - 1]), p_cost);
+	} else {
+		cost_max(&(p_info->worst), p_cost);
+	}
+
+} /* ends() */
+
+
+/* analyze_sub()
+ *
+ * in:     program - the program being analyzed
+ *         s       - index of subroutine to analyze
+ * out:    info[s] - summary of subroutine s
+ * return: number of errors found.
+ *
+ * Callers must have analyzed each subroutine s calls first.
+ */
+
+static int
+analyze_sub(const asm_program_t *program, int s) {
+
+	const asm_sub_t *p_sub = &(program->subs[s]);
+	const asm_instruction_t *p_i;
+	const sub_info_t *p_callee;
+	sub_info_t *p_info = &(info[s]);
+	int errors = 0;
+	int pc, d, need, delta, rep;
+	int loops = 0; /* REPEATs open around pc, paired by resolve() */
+	bool falls;    /* control continues to the next instruction */
+	bool leaves;   /* control HALTs or RETURNs */
+	cost_t cost;   /* run once the instruction at pc has run */
+	cost_t trip;   /* run by a loop body's longest trip */
+
+	memset(p_info, 0, sizeof(*p_info));
+	for (pc = p_sub->start; pc < p_sub->end; pc++) reached[pc] = false;
+	reached[p_sub->start]  = true;
+	depth_at[p_sub->start] = 0;
+	cost_at[p_sub->start].steps  = 0;
+	cost_at[p_sub->start].cycles = 0;
+
+	for (pc = p_sub->start; pc < p_sub->end; pc++) {
+
+		p_i = &(program->instructions[pc]);
+		if (p_i->p_op->op == GRUNT_OP_END) loops--;
+		if (!reached[pc]) {           /* dead code */
+			if (p_i->p_op->op == GRUNT_OP_REPEAT) {
+				memset(&(loop_halt[loops++]), 0,
+					sizeof(loop_halt[0]));
+			} else if ((p_i->p_op->op == GRUNT_OP_END) &&
+				loop_halt[loops].steps) {
+				/* Every path through the body HALTs. */
+				ends(p_info, loops, &(loop_halt[loops]));
+			}
+			continue;
+		}
+		d      = depth_at[pc];
+		rep    = (int)p_i->rep;
+		falls  = true;
+		leaves = false;
+		cost.steps  = cost_at[pc].steps + 1;
+		cost.cycles = cost_at[pc].cycles + op_cycles[p_i->p_op->op];
+
+		switch (p_i->p_op->op) {
+		case GRUNT_OP_ADD:
+		case GRUNT_OP_SUB:
+		case GRUNT_OP_GT:
+		case GRUNT_OP_LT:
+			need = 2;   delta = -1;      break;
+		case GRUNT_OP_AND:
+		case GRUNT_OP_OR:
+		case GRUNT_OP_EQ:
+			need = rep; delta = 1 - rep; break;
+		case GRUNT_OP_NOT:
+			need = 1;   delta = 0;       break;
+		case GRUNT_OP_DUP:
+			need = rep; delta = rep;     break;
+		case GRUNT_OP_POP:
+			need = rep; delta = -rep;    break;
+		case GRUNT_OP_ROLL:
+			need = rep; delta = 0;       break;
+		case GRUNT_OP_PUSHB:
+		case GRUNT_OP_PUSHN:
+		case GRUNT_OP_PUSHS:
+		case GRUNT_OP_INPUT:
+		case GRUNT_OP_INPUTZ:
+			need = 0;   delta = 1;       break;
+		case GRUNT_OP_INPUTREC:
+			need = 0;
+			for (delta = 0; (delta < GRUNT_INPUTREC_MAX_FIELDS) &&
+				GRUNT_INPUTREC_WIDTH(rep, delta); delta++);
+			break;
+		case GRUNT_OP_REWIND:
+			need = 0;   delta = 0;       break;
+		case GRUNT_OP_OUTPUT:
+			need = 1;   delta = -1;      break;
+		case GRUNT_OP_FORMAT:
+			need = rep + 1; delta = -(rep + 1);
+			if (rep > GRUNT_FORMAT_MAX_VALUES) {
+				errors += analysis_error(program, p_i,
+					"FORMAT takes at most %d values",
+					GRUNT_FORMAT_MAX_VALUES);
+			} else if ((pc > p_sub->start) &&
+				(p_i[-1].p_op->op == GRUNT_OP_PUSHS) &&
+				(program->strings[p_i[-1].target].placeholders
+					!= rep)) {
+				errors += analysis_error(program, p_i,
+					"FORMAT template has %d placeholders",
+					program->strings[p_i[-1].target].
+					placeholders);
+			}
+			break;
+		case GRUNT_OP_CLASSIFY:
+			need = 1;   delta = 3;
+			if ((p_i->target + VS_PARM_NUM_NAMES) >
+				program->num_strings) {
+				errors += analysis_error(program, p_i,
+					"CLASSIFY needs %d strings from its "
+					"first name", VS_PARM_NUM_NAMES);
+			}
+			break;
+		case GRUNT_OP_FLUSH:
+			need = 2;   delta = -2;      break;
+		case GRUNT_OP_JMPIF:
+			need = 1;   delta = -1;
+			errors += reach(program, p_i, p_i->target, d - 1,
+				&cost);
+			break;
+		case GRUNT_OP_LOOKUP:
+			need = 1;   delta = 0;       falls = false;
+			if (rep < 1) {
+				errors += analysis_error(program, p_i,
+					"LOOKUP needs at least one key%.0d", 0);
+				break;
+			}
+			if ((pc + (2 * rep) + 2) > p_sub->end) {
+				errors += analysis_error(program, p_i,
+					"LOOKUP table of %d runs off the end "
+					"of the subroutine", rep);
+				break;
+			}
+			errors += reach(program, p_i, pc + (2 * rep) + 2, d,
+				&cost);
+			break;
+		case GRUNT_OP_SWITCH:
+			need = 1;   delta = -1;      falls = false;
+			errors += analyze_switch(program, p_sub, pc, d - 1,
+				&cost);
+			break;
+		case GRUNT_OP_REPEAT:
+			need = 0;   delta = 0;
+			if (rep < 1) {
+				errors += analysis_error(program, p_i,
+					"REPEAT needs a count of at least "
+					"one%.0d", 0);
+			}
+			loop_start[loops] = cost;
+			memset(&(loop_halt[loops]), 0, sizeof(loop_halt[0]));
+			loop_count[loops] = p_i->rep;
+			loop_depth[loops++] = d;
+			if ((2 * loops) > p_info->calls)
+				p_info->calls = 2 * loops;
+			break;
+		case GRUNT_OP_END:
+			need = 0;   delta = 0;
+			if (d != loop_depth[loops]) {
+				errors += analysis_error(program, p_i,
+					"loop body changes the stack depth "
+					"by %+d", d - loop_depth[loops]);
+			}
+			trip = cost;
+			if (loop_halt[loops].steps) {
+				/* Add the trips before the one that HALTs. */
+				cost_trips(&(loop_halt[loops]),
+					&(loop_start[loops]), &trip,
+					loop_count[loops] - 1);
+				ends(p_info, loops, &(loop_halt[loops]));
+			}
+			cost = loop_start[loops];
+			cost_trips(&cost, &(loop_start[loops]), &trip,
+				loop_count[loops]);
+			break;
+		case GRUNT_OP_HALT:
+			need = 1;   delta = -1;      falls = false;
+			leaves = true;
+			break;
+		case GRUNT_OP_RETURN:
+			need = 0;   delta = 0;       falls = false;
+			leaves = true;
+			if (p_info->returns && (p_info->net != d)) {
+				errors += analysis_error(program, p_i,
+					"RETURNs leave different stack "
+					"depths, one %+d", d);
+			}
+			p_info->returns = true;
+			p_info->net     = d;
+			break;
+		case GRUNT_OP_CALL:
+			p_callee = &(info[p_i->target]);
+			need  = p_callee->args;
+			delta = p_callee->net;
+			falls = p_callee->returns;
+			leaves = !falls;
+			cost.steps  += p_callee->worst.steps;
+			cost.cycles += p_callee->worst.cycles;
+			if ((d + p_callee->peak) > p_info->peak)
+				p_info->peak = d + p_callee->peak;
+			if (((2 * loops) + 1 + p_callee->calls) >
+				p_info->calls)
+				p_info->calls = (2 * loops) + 1 +
+					p_callee->calls;
+			break;
+		default:
+			need = 0;   delta = 0;       break;
+		}
+
+		if ((need - d) > p_info->args) p_info->args = need - d;
+		if ((d + delta) > p_info->peak) p_info->peak = d + delta;
+		if (leaves) ends(p_info, loops, &cost);
+		if (falls) {
+			errors += reach(program, p_i, pc + 1, d + delta,
+				&cost);
+		}
+	}
+
+	return errors;
+
+} /* analyze_sub() */
+
+
+/* ------------------- module exported functions ------------------ */
+
+
+/* report_analyze()
+ *
+ * in:     program - a program that has parsed and resolved cleanly
+ *         cycles  - cost of each opcode, or NULL for none
+ * out:    nothing
+ * return: number of errors found.
+ *
+ * Works out the stack use and worst-case cost of each subroutine and
+ * of the program as a whole.  The entry subroutine runs on an empty
+ * stack, and the whole program must fit within GRUNT_STACK_SIZE.
+ * Without costs, cycles count as instructions and the report leaves
+ * them out.
+ */
+
+int
+report_analyze(const asm_program_t *program, const unsigned long *cycles) {
+
+	const asm_instruction_t *p_main = &(program->instructions[0]);
+	int errors = 0;
+	int s;
+
+	if (!(op_cycles = cycles)) {
+		for (s = 0; s < ASM_NUM_OPCODES; s++) unit_cycles[s] = 1;
+		op_cycles = unit_cycles;
+	}
+
+	for (s = program->num_subs - 1; s >= 0; s--) {
+		errors += analyze_sub(program, s);
+	}
+	if (errors) return errors;
+
+	if (info[0].args) {
+		errors += analysis_error(program, p_main, "the entry "
+			"subroutine needs %d args but starts with none",
+			info[0].args);
+	}
+	if (info[0].returns) {
+		errors += analysis_error(program, p_main, "the entry "
+			"subroutine RETURNs rather than HALTs%.0d", 0);
+	}
+	if (info[0].peak > GRUNT_STACK_SIZE) {
+		errors += analysis_error(program, p_main, "arg stack grows "
+			"to %d", info[0].peak);
+	}
+	if (info[0].calls > GRUNT_STACK_SIZE) {
+		errors += analysis_error(program, p_main, "control stack "
+			"grows to %d", info[0].calls);
+	}
+	return errors;
+
+} /* report_analyze() */
+
+
+/* report_wcet()
+ *
+ * in:     nothing
+ * out:    p_steps  - most instructions one run of the program runs
+ *         p_cycles - most cycles one run of the program costs
+ * return: nothing
+ *
+ * Reports on the program report_analyze() last accepted.
+ */
+
+void
+report_wcet(unsigned long *p_steps, unsigned long *p_cycles) {
+
+	*p_steps  = info[0].worst.steps;
+	*p_cycles = info[0].worst.cycles;
+
+} /* report_wcet() */
+
+
+/* report_print()
+ *
+ * in:     out     - file to write the report to
+ *         program - a program report_analyze() accepted
+ * out:    nothing
+ * return: nothing
+ *
+ * For each subroutine, prints its address, its size in instructions,
+ * the number of args it takes from its caller, the change in depth it
+ * leaves behind, the deepest arg stack it builds above its args, and
+ * the deepest control stack its calls build, and the most
+ * instructions and, given costs, cycles a call to it runs.  Then
+ * prints the program's totals against the interpreter's limits.
+ */
+
+void
+report_print(FILE *out, const asm_program_t *program) {
+
+	const asm_sub_t *p_sub;
+	int s;
+
+	fprintf(out, "%s: %d instructions, %d strings, %d subroutines\n",
+		program->source, program->num_instructions,
+		program->num_strings, program->num_subs);
+	fprintf(out, "  %-24s %5s %5s %5s %5s %5s %5s %8s", "subroutine",
+		"pc", "size", "args", "net", "peak", "calls", "steps");
+	if (op_cycles != unit_cycles) fprintf(out, " %10s", "cycles");
+	fprintf(out, "\n");
+	for (s = 0; s < program->num_subs; s++) {
+		p_sub = &(program->subs[s]);
+		fprintf(out, "  %-24s %5d %5d %5d ", p_sub->name, p_sub->start,
+			(p_sub->end - p_sub->start), info[s].args);
+		if (info[s].returns) {
+			fprintf(out, "%+5d", info[s].net);
+		} else {
+			fprintf(out, "%5s", "halt");
+		}
+		fprintf(out, " %5d %5d %8lu", info[s].peak, info[s].calls,
+			info[s].worst.steps);
+		if (op_cycles != unit_cycles)
+			fprintf(out, " %10lu", info[s].worst.cycles);
+		fprintf(out, "\n");
+	}
+	fprintf(out, "  %lu bytes encoded, at most %lu instructions",
+		encoded_size(program), info[0].worst.steps);
+	if (op_cycles != unit_cycles)
+		fprintf(out, " and %lu cycles", info[0].worst.cycles);
+	fprintf(out, " run\n");
+	fprintf(out, "  peak arg stack depth %d, peak control stack depth "
+		"%d, of GRUNT_STACK_SIZE %d\n", info[0].peak, info[0].calls,
+		GRUNT_STACK_SIZE);
+
+} /* report_print() */
+
+
+/* report_budget()
+ *
+ * in:     program  - a program report_analyze() accepted
+ *         p_budget - limits to check it against, 0 for none
+ * out:    nothing
+ * return: number of limits the program exceeds.
+ *
+ * The stack limit applies to both the arg and the control stack.
+ */
+
+int
+report_budget(const asm_program_t *program, const asm_budget_t *p_budget) {
+
+	unsigned long value[5], limit[5];
+	const char *what[5] = { "encoded bytes", "instructions run",
+		"cycles run", "arg stack depth", "control stack depth" };
+	int errors = 0;
+	int i;
+
+	value[0] = encoded_size(program);  limit[0] = p_budget->size;
+	value[1] = info[0].worst.steps;    limit[1] = p_budget->steps;
+	value[2] = info[0].worst.cycles;   limit[2] = p_budget->cycles;
+	value[3] = info[0].peak;           limit[3] = p_budget->stack;
+	value[4] = info[0].calls;          limit[4] = p_budget->stack;
+
+	for (i = 0; i < 5; i++) {
+		if (limit[i] && (value[i] > limit[i])) {
+			fprintf(stderr, "%s: %s %lu over budget of %lu\n",
+				program->source, what[i], value[i], limit[i]);
+			errors++;
+		}
+	}
+	return errors;
+
+} /* report_budget() */
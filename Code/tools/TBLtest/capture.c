@@ -0,0 +1,440 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This file records a run's telemetry to a capture file and plays
+ * it back, so that changes to the tests' logic and to the perf
+ * analysis can be tried on a long run without repeating it.
+ *
+ * With --capture, tlm.c writes every telemetry message it receives to
+ * the file, stamped with the time the receiver thread received it,
+ * cmd.c writes every command it sends, stamped just before sending,
+ * and perf.c writes every ES perf log file it reads.  The file is
+ * append-only: a CAPTURE_HEADER_SIZE-byte header, then the records
+ * as they happen, each a CAPTURE_RECORD_SIZE-byte header then its
+ * bytes, all in host byte order.  Writes go through a large stdio
+ * buffer, so capturing adds few system calls to a test, and since
+ * the buffer is flushed at exit, only a run that is killed outright
+ * loses the records still in it.
+ *
+ * With --replay, there is no spacecraft.  tlm.c takes its telemetry
+ * from the file instead of the socket, cmd.c sends nothing, and
+ * perf.c takes its perf logs from the file.  A virtual clock stands
+ * in for CLOCK_MONOTONIC: it reads the capture time of the latest
+ * record replayed, and waits for telemetry that time out advance it
+ * by their timeout, so the tests' deadlines and the soak and pipeline
+ * latencies come out as they did in the run.  A message that arrived
+ * after some command was sent doesn't replay until the tests send
+ * that command, so the tests see each message when they could have
+ * in the run.  Replay the run with the options that captured it.
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdio.h>
+
+#include "cfe.h"
+
+#include "capture.h"
+
+
+/* ------------- module local definitions and functions ------------ */
+
+#define CAPTURE_MAGIC       "TBLTCAP"    /* 8 bytes with its NUL */
+#define CAPTURE_VERSION     1
+#define CAPTURE_BYTE_ORDER  0x01020304   /* as the host stores it */
+#define CAPTURE_HEADER_SIZE 16
+
+/* Each record's header holds its capture time in usecs, then a word
+ * with its capture_type_t in the top CAPTURE_TYPE_BITS bits and its
+ * length in bytes in the rest.
+ */
+#define CAPTURE_RECORD_SIZE 12
+#define CAPTURE_TYPE_BITS   8
+#define CAPTURE_LENGTH_MASK 0x00FFFFFF
+#define CAPTURE_NUM_TYPES   (CAPTURE_PERF + 1)
+
+/* Big enough that writes rarely reach the disk during a test. */
+#define CAPTURE_BUFFER_SIZE (1 << 20)
+
+/* Capture state. */
+static FILE       *out;                   /* capture file, or NULL */
+static const char *out_name;
+static char        out_buffer[CAPTURE_BUFFER_SIZE];
+static unsigned    out_records;
+
+/* Replay state.  cursor[t] is the offset in the file of the next
+ * record of type t to replay, or of some record before it.
+ */
+static bool         replaying;
+static const uint8 *in;                   /* mapped capture file */
+static size_t       in_size;
+static size_t       cursor[CAPTURE_NUM_TYPES];
+static uint64       clock_usecs;          /* the virtual clock */
+
+
+/* capture_record()
+ *
+ * in:     offset   - offset of a record in the mapped capture file
+ * out:    p_usecs  - the record's capture time
+ *         p_length - the length of the record's bytes
+ * return: the record's capture_type_t.
+ */
+
+static capture_type_t
+capture_record(size_t offset, uint64 *p_usecs, size_t *p_length) {
+
+	uint32 word;
+
+	memcpy(p_usecs, in + offset, sizeof(*p_usecs));
+	memcpy(&word, in + offset + sizeof(*p_usecs), sizeof(word));
+	*p_length = word & CAPTURE_LENGTH_MASK;
+	return (capture_type_t)(word >> (32 - CAPTURE_TYPE_BITS));
+
+} /* capture_record() */
+
+
+/* capture_find()
+ *
+ * in:     type     - kind of record wanted
+ *         cursor   - where to look from
+ * out:    cursor   - offset of the next record of type, if any
+ *         p_usecs  - its capture time
+ *         p_length - the length of its bytes
+ * return: true if the file holds another record of type.
+ */
+
+static bool
+capture_find(capture_type_t type, uint64 *p_usecs, size_t *p_length) {
+
+	size_t offset;
+
+	for (offset = cursor[type]; offset < in_size;
+		offset += CAPTURE_RECORD_SIZE + *p_length) {
+		if (capture_record(offset, p_usecs, p_length) == type) {
+			cursor[type] = offset;
+			return true;
+		}
+	}
+	cursor[type] = in_size;
+	return false;
+
+} /* capture_find() */
+
+
+/* capture_close()
+ *
+ * in:     out - capture file, or NULL
+ * out:    out - closed and set to NULL
+ * return: nothing
+ *
+ * Runs at exit, so that runs that fail still leave whole captures.
+ */
+
+static void
+capture_close(void) {
+
+	if (out == NULL) return;
+
+	if (fclose(out)) {
+		perror("Failed to write capture file");
+	} else {
+		printf("CAPTURE: wrote %u records to %s.\n", out_records,
+			out_name);
+	}
+	out = NULL;
+
+} /* capture_close() */
+
+
+/* ------------------- module exported functions ----------------------- */
+
+
+/* capture_open()
+ *
+ * in:     filename - capture file to write
+ * out:    out      - the file, open with its header written
+ * return: nothing; exits the program if it can't open the file
+ *
+ * Call before tlm_init() and cmd_init().
+ */
+
+void
+capture_open(const char *filename) {
+
+	uint8 header[CAPTURE_HEADER_SIZE];
+	uint32 word;
+
+	if ((NULL == (out = fopen(filename, "wb"))) ||
+		setvbuf(out, out_buffer, _IOFBF, sizeof(out_buffer))) {
+		perror("Failed to open capture file");
+		exit(-1);
+	}
+	out_name = filename;
+
+	memset(header, 0, sizeof(header));
+	memcpy(header, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+	word = CAPTURE_VERSION;
+	memcpy(header + 8, &word, sizeof(word));
+	word = CAPTURE_BYTE_ORDER;
+	memcpy(header + 12, &word, sizeof(word));
+	if (1 != fwrite(header, sizeof(header), 1, out)) {
+		perror("Failed to write capture file");
+		exit(-1);
+	}
+	atexit(capture_close);
+
+} /* capture_open() */
+
+
+/* capture_replay()
+ *
+ * in:     filename - capture file to replay
+ * out:    in, cursor - the file mapped, to replay from its start
+ *         clock_usecs - the first record's capture time
+ * return: nothing; exits the program if the file isn't a capture
+ *
+ * Checks every record's header, so that replaying needn't.  Call
+ * before tlm_init() and cmd_init().
+ */
+
+void
+capture_replay(const char *filename) {
+
+	unsigned counts[CAPTURE_NUM_TYPES] = { 0 };
+	uint64 usecs, first = 0, last = 0;
+	capture_type_t type;
+	struct stat st;
+	size_t offset, length;
+	uint32 word;
+	int t, fd;
+
+	if ((-1 == (fd = open(filename, O_RDONLY))) ||
+		(-1 == fstat(fd, &st))) {
+		perror("Failed to read capture file");
+		exit(-1);
+	}
+	in_size = (size_t)st.st_size;
+	if (in_size < CAPTURE_HEADER_SIZE) {
+		fprintf(stderr, "%s is not a capture file.\n", filename);
+		exit(-1);
+	}
+	in = mmap(NULL, in_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (in == MAP_FAILED) {
+		perror("Failed to map capture file");
+		exit(-1);
+	}
+	close(fd);   /* the mapping stays valid */
+
+	if (memcmp(in, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC))) {
+		fprintf(stderr, "%s is not a capture file.\n", filename);
+		exit(-1);
+	}
+	memcpy(&word, in + 8, sizeof(word));
+	if (word != CAPTURE_VERSION) {
+		fprintf(stderr, "%s is a version %u capture; we read "
+			"version %u.\n", filename, (unsigned)word,
+			CAPTURE_VERSION);
+		exit(-1);
+	}
+	memcpy(&word, in + 12, sizeof(word));
+	if (word != CAPTURE_BYTE_ORDER) {
+		fprintf(stderr, "%s was captured on a host of another "
+			"byte order.\n", filename);
+		exit(-1);
+	}
+
+	for (offset = CAPTURE_HEADER_SIZE; offset < in_size;
+		offset += CAPTURE_RECORD_SIZE + length) {
+		if (in_size - offset < CAPTURE_RECORD_SIZE) break;
+		type = capture_record(offset, &usecs, &length);
+		if ((type < CAPTURE_TLM) || (type > CAPTURE_PERF) ||
+			(in_size - offset - CAPTURE_RECORD_SIZE < length))
+			break;
+		if (!counts[CAPTURE_TLM] && !counts[CAPTURE_CMD] &&
+			!counts[CAPTURE_PERF])
+			first = usecs;
+		last = usecs;
+		counts[type]++;
+	}
+	if (offset < in_size) {
+		printf("REPLAY: %s has a damaged record at offset %lu; "
+			"replaying the records before it.\n", filename,
+			(unsigned long)offset);
+		in_size = offset;
+	}
+
+	for (t = 0; t < CAPTURE_NUM_TYPES; t++)
+		cursor[t] = CAPTURE_HEADER_SIZE;
+	clock_usecs = first;
+	replaying   = true;
+
+	printf("REPLAY: %s holds %u telemetry messages, %u commands, "
+		"and %u perf logs over %.3f s.\n", filename,
+		counts[CAPTURE_TLM], counts[CAPTURE_CMD],
+		counts[CAPTURE_PERF], (double)(last - first) / 1000000.0);
+
+} /* capture_replay() */
+
+
+/* capture_replaying()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: true if we're replaying a capture rather than testing a
+ *         spacecraft.
+ */
+
+bool
+capture_replaying(void) {
+
+	return replaying;
+
+} /* capture_replaying() */
+
+
+/* capture_now()
+ *
+ * in:     clock_usecs - the virtual clock, when replaying
+ * out:    nothing
+ * return: microseconds since some arbitrary fixed point: the
+ *         CLOCK_MONOTONIC time, or when replaying, the virtual clock.
+ *
+ * The receiver thread calls this too, so it mustn't touch state when
+ * we're not replaying.
+ */
+
+uint64
+capture_now(void) {
+
+	struct timespec now;
+
+	if (replaying) return clock_usecs;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64)now.tv_sec * 1000000) + (uint64)(now.tv_nsec / 1000);
+
+} /* capture_now() */
+
+
+/* capture_write()
+ *
+ * in:     type   - kind of record
+ *         usecs  - when it happened, by capture_now()
+ *         bytes  - the record's bytes
+ *         length - how many
+ *         out    - capture file, or NULL
+ * out:    out    - the record appended, if capturing
+ * return: nothing; exits the program if the write fails
+ */
+
+void
+capture_write(capture_type_t type, uint64 usecs, const void *bytes,
+	size_t length) {
+
+	uint8 header[CAPTURE_RECORD_SIZE];
+	uint32 word;
+
+	if (out == NULL) return;
+
+	word = ((uint32)type << (32 - CAPTURE_TYPE_BITS)) |
+		((uint32)length & CAPTURE_LENGTH_MASK);
+	memcpy(header, &usecs, sizeof(usecs));
+	memcpy(header + sizeof(usecs), &word, sizeof(word));
+	if ((length > CAPTURE_LENGTH_MASK) ||
+		(1 != fwrite(header, sizeof(header), 1, out)) ||
+		(length != fwrite(bytes, 1, length, out))) {
+		perror("Failed to write capture file");
+		out = NULL;
+		exit(-1);
+	}
+	out_records++;
+
+} /* capture_write() */
+
+
+/* capture_peek()
+ *
+ * in:     type    - kind of record
+ *         cursor  - where each type's next record is
+ * out:    p_usecs - capture time of the next record of type
+ * return: true if the capture holds another record of type.
+ */
+
+bool
+capture_peek(capture_type_t type, uint64 *p_usecs) {
+
+	size_t length;
+
+	return capture_find(type, p_usecs, &length);
+
+} /* capture_peek() */
+
+
+/* capture_next()
+ *
+ * in:     type     - kind of record
+ *         msecs    - for CAPTURE_TLM, how long to wait if the next
+ *                    message hasn't arrived by the virtual clock; 0
+ *                    means don't wait, -1 means wait forever
+ *         cursor, clock_usecs - where and when the replay is
+ * out:    p_length - length of the record's bytes
+ *         cursor   - past the record, if any
+ *         clock_usecs - advanced to the record's capture time, or by
+ *                    msecs if a wait for telemetry timed out
+ * return: the bytes of the next record of type, or NULL if there is
+ *         none, or for CAPTURE_TLM, none by the end of the wait.
+ *
+ * Exits the program if the tests would wait forever: for a message
+ * past the end of the capture, or one that arrived only after a
+ * command they haven't sent.
+ */
+
+const void *
+capture_next(capture_type_t type, int msecs, size_t *p_length) {
+
+	uint64 usecs, sent;
+	size_t length;
+	bool found;
+
+	found = capture_find(type, &usecs, p_length);
+
+	if (type == CAPTURE_TLM) {
+		if (found && capture_find(CAPTURE_CMD, &sent, &length) &&
+			(sent < usecs))
+			found = false;   /* not until we send that command */
+		if (!found && (msecs == -1)) {
+			fprintf(stderr, "REPLAY: the tests wait for telemetry "
+				"the capture doesn't hold for them.\n");
+			exit(-1);
+		}
+		if (!found || ((msecs != -1) &&
+			(usecs > clock_usecs + (uint64)msecs * 1000))) {
+			clock_usecs += (uint64)msecs * 1000;
+			return NULL;
+		}
+	} else if (!found) {
+		return NULL;
+	}
+
+	if (usecs > clock_usecs) clock_usecs = usecs;
+	cursor[type] += CAPTURE_RECORD_SIZE + *p_length;
+	return in + cursor[type] - *p_length;
+
+} /* capture_next() */
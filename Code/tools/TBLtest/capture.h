@@ -0,0 +1,34 @@
+#ifndef _CAPTURE_H_
+#define _CAPTURE_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* The kinds of record a capture file holds. */
+typedef enum {
+	CAPTURE_TLM  = 1,    /* a telemetry message, as it arrived */
+	CAPTURE_CMD  = 2,    /* a command, as we sent it */
+	CAPTURE_PERF = 3,    /* an ES perf log file, as we read it */
+} capture_type_t;
+
+void        capture_open(const char *);
+void        capture_replay(const char *);
+bool        capture_replaying(void);
+uint64      capture_now(void);
+void        capture_write(capture_type_t, uint64, const void *, size_t);
+bool        capture_peek(capture_type_t, uint64 *);
+const void *capture_next(capture_type_t, int, size_t *);
+
+#endif
@@ -18,10 +18,13 @@
  * test cFS app table validation functions.
  */
 
+#define _GNU_SOURCE                                 /* for sendmmsg() */
+
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <assert.h>
+#include <errno.h>
 #include <string.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -34,8 +37,17 @@
 #include "to_lab_msg.h"                /* for TO_LAB enable TLM msg struct */
 #include "cfe_es_msg.h"                /* for ES command message structs */
 #include "cfe_es_perf.h"               /* for ES CFE_ES_PERF_TRIGGER_START */
+#include "cfe_evs_msg.h"                /* for EVS command message structs */
+
+#include "vs_ground.h"                 /* for VS? app names, CMD_MIDs */
+#include "vs_msgstruct.h"              /* for vsc_msgstruct.h */
+#include "vsc_msgstruct.h"             /* for VSC command structs */
+#include "vsc_fcncodes.h"              /* for VSC command codes */
+#include "vsa_fcncodes.h"              /* for VSA_STAGE_CC */
+#include "vsb_fcncodes.h"              /* for VSB_STAGE_CC */
 
 #include "common_constants.h"
+#include "capture.h"
 #include "cmd.h"
 
 #define CMD_ADDR "127.0.0.1"           /* Send commands here */
@@ -46,15 +58,22 @@
  * indicates a message that is not fragmented and has sequence number
  * 0.  Nobody seems to check sequence numbers.  Be sure to convert
  * this value to network byte order (big-endian) before you put it in
- * a header.
+ * a header.  The lower CCSDS_MSG_SEQ_MASK bits hold the number.
  */
 #define CCSDS_MSG_FRAG_SEQ     0xC000
+#define CCSDS_MSG_SEQ_MASK     0x3FFF
 
 /* Pause for at least this many usecs before sending a command to
  * avoid overflowing the cFE command pipe.
  */
 #define PAUSE (1000 * 250)  /* 250 ms */
 
+/* The most commands a burst holds before cmd_send() sends them, and
+ * the longest command it can hold.
+ */
+#define CMD_BURST_MAX      16
+#define CMD_MSG_MAX_SIZE   128
+
 
 /*
  * -------- Module local state and functions --------
@@ -63,13 +82,17 @@
 static struct sockaddr_in cmd_addr;         /* send commands to here */
 static int cmdfd;                     /* socket for sending commands */
 
-/* We construct commands in this buffer; a union with a type for every
- * kind of command that we plan on sending plus a
- * CFE_MSG_CommandHeader_t type for manipulating the common primary
- * and secondary headers that begin command messages of all kinds.
+/* We construct commands in these templates, one for every kind of
+ * command that we plan on sending.  cmd_init() sets each one's
+ * CCSDS primary and command secondary headers once, so sending a
+ * command patches only its payload.  The headers barely change: the
+ * checksum is unused, since nobody checks it, and the sequence count
+ * is always 0, except in TBL validate commands.  Those number the
+ * validations we ask for, from 1, so that latency.c can correlate
+ * each with the records of it we gather and captures show which one
+ * is which.
  */
-static union {
-	CFE_MSG_CommandHeader_t        header;
+static struct {
 	CFE_TBL_LoadCmd_t              tbl_load;
 	CFE_TBL_ValidateCmd_t          tbl_validate;
 	CFE_TBL_ActivateCmd_t          tbl_activate;
@@ -78,15 +101,43 @@ static union {
 	CFE_ES_SetPerfTriggerMaskCmd_t es_trigger;
 	CFE_ES_StartPerfDataCmd_t      es_start;
 	CFE_ES_StopPerfDataCmd_t       es_stop;
+	CFE_EVS_SetEventFormatModeCmd_t evs_format;
+	VSC_cmd_engine_t               vsc_engine;
+	VSC_cmd_trace_t                vsc_trace;
+	VS_cmd_stage_t                 vsa_stage;
+	VS_cmd_stage_t                 vsb_stage;
+	VS_cmd_stage_t                 vsc_stage;
 } cmd_msg;
 
+/* Between cmd_burst_begin() and cmd_burst_end(), cmd_send() copies
+ * commands here instead of sending them, and cmd_burst_end() sends
+ * them all with one pause and one sendmmsg() call.
+ */
+static bool bursting;
+static unsigned burst_count;
+static unsigned char  burst_bufs[CMD_BURST_MAX][CMD_MSG_MAX_SIZE];
+static struct iovec   burst_iovs[CMD_BURST_MAX];
+static struct mmsghdr burst_hdrs[CMD_BURST_MAX];
+
+/* The capture_now() time we last sent a command, and the number of
+ * the latest TBL validate command.
+ */
+static uint64 sent_usecs;
+static uint16 validate_seq;
+
+/* cmd_set_throttle(false) turns the pause off, for tests that pace
+ * their own commands.
+ */
+static bool throttled = true;
+
 
 /* cmd_set_header()
  *
- * in:     mid_hbo - 16-bit message ID in host byte order
- *         len_hbo - 16-bit true message length in host byte order.
- *         command - 8-bit command code
- * out:    cmd_msg - header fields set
+ * in:     p_header - header of the command template to set
+ *         mid_hbo  - 16-bit message ID in host byte order
+ *         len_hbo  - 16-bit true message length in host byte order.
+ *         command  - 8-bit command code
+ * out:    p_header - header fields set
  * return: nothing
  *
  * Utility function for setting CCSDS and command header fields.  Note
@@ -99,22 +150,136 @@ static union {
  */
 
 static void
-cmd_set_header(unsigned short mid_hbo, unsigned short len_hbo,
-	unsigned char command) {
+cmd_set_header(CFE_MSG_CommandHeader_t *p_header, unsigned short mid_hbo,
+	unsigned short len_hbo, unsigned char command) {
 
-	*((unsigned short *)cmd_msg.header.Msg.CCSDS.Pri.StreamId) =
+	*((unsigned short *)p_header->Msg.CCSDS.Pri.StreamId) =
 		htons(mid_hbo);
-	*((unsigned short *)cmd_msg.header.Msg.CCSDS.Pri.Sequence) =
+	*((unsigned short *)p_header->Msg.CCSDS.Pri.Sequence) =
 		htons(CCSDS_MSG_FRAG_SEQ);
-	*((unsigned short *)cmd_msg.header.Msg.CCSDS.Pri.Length) =
+	*((unsigned short *)p_header->Msg.CCSDS.Pri.Length) =
 		htons(len_hbo - CCSDS_MSG_LENGTH_DELTA);
 
-	cmd_msg.header.Sec.FunctionCode = command;
-	cmd_msg.header.Sec.Checksum     = 0x00;   /* nobody checks this */
+	p_header->Sec.FunctionCode = command;
+	p_header->Sec.Checksum     = 0x00;   /* nobody checks this */
 
 } /* cmd_set_header() */
 
 
+/* cmd_pause()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: nothing
+ *
+ * By default, cFE will start emitting Message Limit Errors if the
+ * number of commands that have been sent by the ground station but
+ * not yet processed by their recipient exceeds
+ * CFE_PLATFORM_SB_DEFAULT_MSG_LIMIT.  This constant is set to only 4
+ * in the default configuration of my version of cFE - a limit that
+ * is easily exceeded by this test suite.  Rather than mess with the
+ * cFE configuration, I've decided to use the simple but wasteful
+ * throttle on the rate at wich we send commands.
+ */
+
+static void
+cmd_pause(void) {
+
+	if (!throttled) return;
+	if (-1 == usleep(PAUSE)) {
+		perror("Failed to usleep");
+		exit(-1);
+	}
+
+} /* cmd_pause() */
+
+
+/* cmd_replay()
+ *
+ * in:     msg - command message the tests would send
+ *         len - length of command message
+ * out:    nothing
+ * return: nothing
+ *
+ * Stands in for sending when replaying a capture: takes the
+ * capture's next command instead, which brings the replay's clock to
+ * the time the run sent it.  The first command that isn't the one the
+ * run sent gets a warning: the telemetry that follows answers the
+ * run's command, not the tests'.
+ */
+
+static void
+cmd_replay(const unsigned char *msg, size_t len) {
+
+	static unsigned replayed;    /* commands replayed so far */
+	static bool warned;          /* have we warned already? */
+	const void *p_sent;          /* the command the run sent */
+	size_t sent_len;
+
+	p_sent = capture_next(CAPTURE_CMD, 0, &sent_len);
+	replayed++;
+	if (warned) return;
+	if ((p_sent == NULL) || (sent_len != len) ||
+		memcmp(p_sent, msg, len)) {
+		printf("REPLAY: command %u %s the capture's; the replay "
+			"may part from the run here.\n", replayed,
+			(p_sent ? "differs from" : "is past the end of"));
+		warned = true;
+	}
+
+} /* cmd_replay() */
+
+
+/* cmd_burst_end_send()
+ *
+ * in:     cmdfd       - open socket for sending command messages
+ *         burst_bufs  - burst_count commands held in the burst
+ * out:    cmdfd       - the commands written to socket
+ *         burst_count - 0
+ * return: nothing
+ *
+ * Sends the commands held in the burst after a single pause, with as
+ * few sendmmsg() calls as the socket will take them in.
+ */
+
+static void
+cmd_burst_end_send(void) {
+
+	unsigned sent = 0;
+	uint64 now;           /* when we sent the burst */
+	unsigned i;
+	int n;
+
+	if (burst_count == 0) return;
+
+	if (capture_replaying()) {
+		for (i = 0; i < burst_count; i++)
+			cmd_replay(burst_bufs[i], burst_iovs[i].iov_len);
+		sent_usecs = capture_now();
+		burst_count = 0;
+		return;
+	}
+
+	cmd_pause();
+	sent_usecs = now = capture_now();
+	for (i = 0; i < burst_count; i++)
+		capture_write(CAPTURE_CMD, now, burst_bufs[i],
+			burst_iovs[i].iov_len);
+	while (sent < burst_count) {
+		n = sendmmsg(cmdfd, &(burst_hdrs[sent]), burst_count - sent,
+			0x00);
+		if (n == -1) {
+			if (errno == EINTR) continue;
+			perror("Failed to send commands");
+			exit(-1);
+		}
+		sent += (unsigned)n;
+	}
+	burst_count = 0;
+
+} /* cmd_burst_end_send() */
+
+
 /* cmd_send()
  *
  * in:      cmdfd - open socket for sending command messages
@@ -123,28 +288,38 @@ cmd_set_header(unsigned short mid_hbo, unsigned short len_hbo,
  * out:     cmdfd - command message written to socket
  * return:  nothing
  *
- * Sends command messages to the simulated spacecraft.
+ * Sends command messages to the simulated spacecraft, or, between
+ * cmd_burst_begin() and cmd_burst_end(), holds them to send at once.
+ * When capturing, writes each to the capture file as it goes.  Notes
+ * when it sent them for cmd_sent_usecs().
  *
  */
  
 static void
 cmd_send(const unsigned char *msg, size_t len) {
 
-	/* By default, cFE will start emitting Message Limit Errors if
-	 * the number of commands that have been sent by the ground
-	 * station but not yet processed by their recipient exceeds
-	 * CFE_PLATFORM_SB_DEFAULT_MSG_LIMIT.  This constant is set to
-	 * only 4 in the default configuration of my version of cFE -
-	 * a limit that is easily exceeded by this test suite.  Rather
-	 * than mess with the cFE configuration, I've decided to use
-	 * the simple but wasteful throttle on the rate at wich we
-	 * send commands.
+	/* In a burst, hold the command for cmd_burst_end().  If we
+	 * are given a command longer than CMD_MSG_MAX_SIZE, that's a
+	 * bug - we need to increase that constant's value.
 	 */
-	if (-1 == usleep(PAUSE)) {
-		perror("Failed to usleep");
-		exit(-1);
+	if (bursting) {
+		assert(len <= CMD_MSG_MAX_SIZE);
+		if (burst_count == CMD_BURST_MAX) cmd_burst_end_send();
+		memcpy(burst_bufs[burst_count], msg, len);
+		burst_iovs[burst_count].iov_len = len;
+		burst_count++;
+		return;
 	}
-	
+
+	if (capture_replaying()) {
+		cmd_replay(msg, len);
+		sent_usecs = capture_now();
+		return;
+	}
+
+	cmd_pause();
+	sent_usecs = capture_now();
+	capture_write(CAPTURE_CMD, sent_usecs, msg, len);
 	if (-1 == send(cmdfd, msg, len,	0x00)) {
 		perror("Failed to send command");
 		exit(-1);
@@ -175,7 +350,9 @@ cmd_send(const unsigned char *msg, size_t len) {
 
 void
 cmd_init(void) {
-	
+
+	int i;
+
 	/* Create IP/UDP socket for sending commands. For commands,
 	 * the spacecraft is the server and I am the client.
 	 */
@@ -193,9 +370,111 @@ cmd_init(void) {
 		exit(-1);
 	}
 
+	/* Build the command templates' headers.  Their payloads start
+	 * out all zeroes, so each string field already ends in the
+	 * NUL that the strncpy() calls below never overwrite.
+	 */
+	cmd_set_header(&(cmd_msg.tbl_load.CommandHeader), CFE_TBL_CMD_MID,
+		sizeof(CFE_TBL_LoadCmd_t), CFE_TBL_LOAD_CC);
+	cmd_set_header(&(cmd_msg.tbl_validate.CommandHeader), CFE_TBL_CMD_MID,
+		sizeof(CFE_TBL_ValidateCmd_t), CFE_TBL_VALIDATE_CC);
+	cmd_set_header(&(cmd_msg.tbl_activate.CommandHeader), CFE_TBL_CMD_MID,
+		sizeof(CFE_TBL_ActivateCmd_t), CFE_TBL_ACTIVATE_CC);
+	cmd_set_header(&(cmd_msg.to_tlmon.CommandHeader), TO_LAB_CMD_MID,
+		sizeof(TO_LAB_EnableOutputCmd_t), TO_LAB_OUTPUT_ENABLE_CC);
+	cmd_set_header(&(cmd_msg.es_filter.CommandHeader), CFE_ES_CMD_MID,
+		sizeof(CFE_ES_SetPerfFilterMaskCmd_t),
+		CFE_ES_SET_PERF_FILTER_MASK_CC);
+	cmd_set_header(&(cmd_msg.es_trigger.CommandHeader), CFE_ES_CMD_MID,
+		sizeof(CFE_ES_SetPerfTriggerMaskCmd_t),
+		CFE_ES_SET_PERF_TRIGGER_MASK_CC);
+	cmd_set_header(&(cmd_msg.es_start.CommandHeader), CFE_ES_CMD_MID,
+		sizeof(CFE_ES_StartPerfDataCmd_t), CFE_ES_START_PERF_DATA_CC);
+	cmd_set_header(&(cmd_msg.es_stop.CommandHeader), CFE_ES_CMD_MID,
+		sizeof(CFE_ES_StopPerfDataCmd_t), CFE_ES_STOP_PERF_DATA_CC);
+	cmd_set_header(&(cmd_msg.evs_format.CommandHeader), CFE_EVS_CMD_MID,
+		sizeof(CFE_EVS_SetEventFormatModeCmd_t),
+		CFE_EVS_SET_EVENT_FORMAT_MODE_CC);
+	cmd_set_header(&(cmd_msg.vsc_engine.header), VSC_CMD_MID,
+		sizeof(VSC_cmd_engine_t), VSC_SET_ENGINE_CC);
+	cmd_set_header(&(cmd_msg.vsc_trace.header), VSC_CMD_MID,
+		sizeof(VSC_cmd_trace_t), VSC_DUMP_TRACE_CC);
+	cmd_set_header(&(cmd_msg.vsa_stage.header), VSA_CMD_MID,
+		sizeof(VS_cmd_stage_t), VSA_STAGE_CC);
+	cmd_set_header(&(cmd_msg.vsb_stage.header), VSB_CMD_MID,
+		sizeof(VS_cmd_stage_t), VSB_STAGE_CC);
+	cmd_set_header(&(cmd_msg.vsc_stage.header), VSC_CMD_MID,
+		sizeof(VS_cmd_stage_t), VSC_STAGE_CC);
+
+	for (i = 0; i < CMD_BURST_MAX; i++) {
+		burst_iovs[i].iov_base = burst_bufs[i];
+		burst_hdrs[i].msg_hdr.msg_iov    = &(burst_iovs[i]);
+		burst_hdrs[i].msg_hdr.msg_iovlen = 1;
+	}
+
 } /* cmd_init() */
 
 
+/* cmd_set_throttle()
+ *
+ * in:     on        - pause before sending commands?
+ * out:    throttled - set to on
+ * return: nothing
+ *
+ * The stress test turns the pause off to send its bursts on its own
+ * schedule, message limit errors and all, and back on when it is
+ * done.
+ */
+
+void
+cmd_set_throttle(bool on) {
+
+	throttled = on;
+
+} /* cmd_set_throttle() */
+
+
+/* cmd_burst_begin()
+ *
+ * in:     nothing
+ * out:    bursting - set
+ * return: nothing
+ *
+ * Starts a burst: cmd_send() holds the commands sent until
+ * cmd_burst_end() rather than pausing before each one.  A burst's
+ * commands reach SB all at once, so callers must keep each burst
+ * within CFE_PLATFORM_SB_DEFAULT_MSG_LIMIT commands per message ID,
+ * the same limit the pause guards.
+ */
+
+void
+cmd_burst_begin(void) {
+
+	assert(!bursting);
+	bursting = true;
+
+} /* cmd_burst_begin() */
+
+
+/* cmd_burst_end()
+ *
+ * in:     bursting - set
+ * out:    bursting - cleared
+ * return: nothing
+ *
+ * Ends a burst, sending the commands it holds.
+ */
+
+void
+cmd_burst_end(void) {
+
+	assert(bursting);
+	cmd_burst_end_send();
+	bursting = false;
+
+} /* cmd_burst_end() */
+
+
 /* cmd_to_tlmon()
  *
  * in:     nothing
@@ -209,10 +488,6 @@ cmd_init(void) {
 void
 cmd_to_tlmon(void) {
 
-	cmd_set_header(TO_LAB_CMD_MID, sizeof(TO_LAB_EnableOutputCmd_t),
-		TO_LAB_OUTPUT_ENABLE_CC);
-	memset(cmd_msg.to_tlmon.Payload.dest_IP, 0x00,
-		sizeof(TO_LAB_EnableOutput_Payload_t));
 	strncpy(cmd_msg.to_tlmon.Payload.dest_IP, CMD_TO_TLM_ADDR,
 		(sizeof(TO_LAB_EnableOutput_Payload_t) - 1));
 	
@@ -247,11 +522,6 @@ cmd_tbl_load(const char *filename) {
 	assert(filename);
 	assert(memchr(filename, '\0', CFE_MISSION_MAX_PATH_LEN));
 
-	cmd_set_header(CFE_TBL_CMD_MID, sizeof(CFE_TBL_LoadCmd_t),
-		CFE_TBL_LOAD_CC);
-
-	memset(cmd_msg.tbl_load.Payload.LoadFilename, 0x00,
-		CFE_MISSION_MAX_PATH_LEN);
 	strncpy(cmd_msg.tbl_load.Payload.LoadFilename, filename,
 		(CFE_MISSION_MAX_PATH_LEN-1));
 	
@@ -263,19 +533,24 @@ cmd_tbl_load(const char *filename) {
 
 /* cmd_tbl_validate()
  *
- * in:     tablename - name of table to validate
- *         atflag    - CFE_TBL_Bufferselect_[IN]ACTIVE for [in]active table
- * out:    cmd_msg   - set to command message
+ * in:     tablename    - name of table to validate
+ *         atflag       - CFE_TBL_Bufferselect_[IN]ACTIVE for [in]active table
+ * out:    cmd_msg      - set to command message
+ *         validate_seq - incremented
  * return: nothing
  *
  * Send command to TBL asking it to validate the [in]active image of
- * the named table in its table Registry.
+ * the named table in its table Registry.  The command's CCSDS
+ * sequence count carries the lower bits of validate_seq.
  *
  */
 
 void
 cmd_tbl_validate(const char *tablename, unsigned short atflag) {
 
+	CFE_MSG_CommandHeader_t *p_header =
+		&(cmd_msg.tbl_validate.CommandHeader);
+
 	/* TBL's CFE_TBL_ValidateCmd_Payload_t structure allocates
 	 * CFE_MISSION_TBL_MAX_FULL_NAME_LEN bytes to store the name
 	 * of the table we want to validate and its terminating
@@ -290,13 +565,12 @@ cmd_tbl_validate(const char *tablename, unsigned short atflag) {
 	assert((atflag == CFE_TBL_BufferSelect_INACTIVE) ||
 	       (atflag == CFE_TBL_BufferSelect_ACTIVE));
 
-	cmd_set_header(CFE_TBL_CMD_MID, sizeof(CFE_TBL_ValidateCmd_t),
-		CFE_TBL_VALIDATE_CC);
+	validate_seq++;
+	*((unsigned short *)p_header->Msg.CCSDS.Pri.Sequence) =
+		htons(CCSDS_MSG_FRAG_SEQ | (validate_seq & CCSDS_MSG_SEQ_MASK));
 
 	/* TBL payload numbers are in host byte order */
 	cmd_msg.tbl_validate.Payload.ActiveTableFlag = atflag;
-	memset(cmd_msg.tbl_validate.Payload.TableName, 0x00,
-		CFE_MISSION_TBL_MAX_FULL_NAME_LEN);
 	strncpy(cmd_msg.tbl_validate.Payload.TableName, tablename,
 		(CFE_MISSION_TBL_MAX_FULL_NAME_LEN-1));
 	
@@ -330,11 +604,6 @@ cmd_tbl_activate(const char *tablename) {
 	assert(tablename);
 	assert(memchr(tablename, '\0', CFE_MISSION_TBL_MAX_FULL_NAME_LEN));
 
-	cmd_set_header(CFE_TBL_CMD_MID, sizeof(CFE_TBL_ActivateCmd_t),
-		CFE_TBL_ACTIVATE_CC);
-
-	memset(cmd_msg.tbl_activate.Payload.TableName, 0x00,
-		CFE_MISSION_TBL_MAX_FULL_NAME_LEN);
 	strncpy(cmd_msg.tbl_activate.Payload.TableName, tablename,
 		(CFE_MISSION_TBL_MAX_FULL_NAME_LEN-1));
 	
@@ -361,9 +630,6 @@ cmd_tbl_activate(const char *tablename) {
 void
 cmd_es_setperffilter(uint32 word_num, uint32 word_mask) {
 
-	cmd_set_header(CFE_ES_CMD_MID, sizeof(CFE_ES_SetPerfFilterMaskCmd_t),
-		CFE_ES_SET_PERF_FILTER_MASK_CC);
-
 	cmd_msg.es_filter.Payload.FilterMaskNum = word_num;
 	cmd_msg.es_filter.Payload.FilterMask    = word_mask;
 	
@@ -390,9 +656,6 @@ cmd_es_setperffilter(uint32 word_num, uint32 word_mask) {
 void
 cmd_es_setperftrigger(uint32 word_num, uint32 word_mask) {
 
-	cmd_set_header(CFE_ES_CMD_MID, sizeof(CFE_ES_SetPerfTriggerMaskCmd_t),
-		CFE_ES_SET_PERF_TRIGGER_MASK_CC);
-
 	cmd_msg.es_trigger.Payload.TriggerMaskNum = word_num;
 	cmd_msg.es_trigger.Payload.TriggerMask    = word_mask;
 	
@@ -417,9 +680,6 @@ cmd_es_setperftrigger(uint32 word_num, uint32 word_mask) {
 void
 cmd_es_perfstart(void) {
 
-	cmd_set_header(CFE_ES_CMD_MID, sizeof(CFE_ES_StartPerfDataCmd_t),
-		CFE_ES_START_PERF_DATA_CC);
-
 	cmd_msg.es_start.Payload.TriggerMode = CFE_ES_PERF_TRIGGER_START;
 	
 	cmd_send((const unsigned char *)&cmd_msg.es_start,
@@ -446,11 +706,6 @@ cmd_es_perfstart(void) {
 void
 cmd_es_perfstop(void) {
 
-	cmd_set_header(CFE_ES_CMD_MID, sizeof(CFE_ES_StopPerfDataCmd_t),
-		CFE_ES_STOP_PERF_DATA_CC);
-
-	memset(cmd_msg.es_stop.Payload.DataFileName, 0x00,
-		CFE_MISSION_MAX_PATH_LEN);
 	strncpy(cmd_msg.es_stop.Payload.DataFileName, PERF_FILENAME,
 		(CFE_MISSION_MAX_PATH_LEN-1));
 	
@@ -458,3 +713,135 @@ cmd_es_perfstop(void) {
 		sizeof(CFE_ES_StopPerfDataCmd_t));
 
 } /* cmd_es_perfstop() */
+
+
+/* cmd_evs_setformat()
+ *
+ * in:     format  - CFE_EVS_MsgFormat_SHORT or CFE_EVS_MsgFormat_LONG
+ * out:    cmd_msg - set to command message
+ * return: nothing
+ *
+ * Ask EVS to send all events in the given form from now on.
+ * Short-form events carry no text; tlm.c decodes the VS apps' ones
+ * built to put theirs in the event ID.
+ */
+
+void
+cmd_evs_setformat(uint8 format) {
+
+	cmd_msg.evs_format.Payload.MsgFormat = format;
+
+	cmd_send((const unsigned char *)&cmd_msg.evs_format,
+		sizeof(CFE_EVS_SetEventFormatModeCmd_t));
+
+} /* cmd_evs_setformat() */
+
+
+/* cmd_vsc_setengine()
+ *
+ * in:     engine  - VS_ENGINE_* engine number
+ * out:    cmd_msg - set to command message
+ * return: nothing
+ *
+ * Ask VSC to validate tables with the given engine from now on.  VSC
+ * reports the engine it uses in its housekeeping telemetry, and
+ * rejects engines its build doesn't have.
+ */
+
+void
+cmd_vsc_setengine(uint8 engine) {
+
+	cmd_msg.vsc_engine.payload.engine = engine;
+
+	cmd_send((const unsigned char *)&cmd_msg.vsc_engine,
+		sizeof(VSC_cmd_engine_t));
+
+} /* cmd_vsc_setengine() */
+
+
+/* cmd_vsc_dumptrace()
+ *
+ * in:     num_steps - latest trace steps to ask for, 0 for all
+ * out:    nothing
+ * return: nothing
+ *
+ * Ask VSC to send the latest steps of its Grunt trace.  Only VSC
+ * builds with the GRUNT_TRACE option answer.
+ */
+
+void
+cmd_vsc_dumptrace(uint16 num_steps) {
+
+	cmd_msg.vsc_trace.payload.num_steps = num_steps;
+
+	cmd_send((const unsigned char *)&cmd_msg.vsc_trace,
+		sizeof(VSC_cmd_trace_t));
+
+} /* cmd_vsc_dumptrace() */
+
+
+/* cmd_vs_stage()
+ *
+ * in:     app_name - name of the VS app whose table to stage an image for
+ *         filename - table image file on the spacecraft
+ * out:    cmd_msg  - set to command message
+ * return: nothing
+ *
+ * Ask a VS app to read a table image file into its staging pool.  The
+ * app loads it with CFE_TBL_Load() on its next housekeeping cycle.
+ */
+
+void
+cmd_vs_stage(const char *app_name, const char *filename) {
+
+	VS_cmd_stage_t *p_cmd;  /* the app's STAGE command template */
+
+	assert(filename);
+	assert(memchr(filename, '\0', CFE_MISSION_MAX_PATH_LEN));
+
+	if (!strcmp(app_name, VSA_APP_NAME)) {
+		p_cmd = &(cmd_msg.vsa_stage);
+	} else if (!strcmp(app_name, VSB_APP_NAME)) {
+		p_cmd = &(cmd_msg.vsb_stage);
+	} else {
+		assert(!strcmp(app_name, VSC_APP_NAME));
+		p_cmd = &(cmd_msg.vsc_stage);
+	}
+
+	strncpy(p_cmd->payload.filename, filename,
+		(CFE_MISSION_MAX_PATH_LEN-1));
+
+	cmd_send((const unsigned char *)p_cmd, sizeof(VS_cmd_stage_t));
+
+} /* cmd_vs_stage() */
+
+
+/* cmd_sent_usecs()
+ *
+ * in:     sent_usecs
+ * out:    nothing
+ * return: the capture_now() time the latest command went to the
+ *         spacecraft, or, when replaying, the time the run sent it.
+ */
+
+uint64
+cmd_sent_usecs(void) {
+
+	return sent_usecs;
+
+} /* cmd_sent_usecs() */
+
+
+/* cmd_validate_seq()
+ *
+ * in:     validate_seq
+ * out:    nothing
+ * return: the number of the latest TBL validate command, from 1.
+ */
+
+uint16
+cmd_validate_seq(void) {
+
+	return validate_seq;
+
+} /* cmd_validate_seq() */
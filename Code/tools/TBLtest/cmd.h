@@ -17,6 +17,9 @@
  */
 
 void cmd_init(void);
+void cmd_set_throttle(bool);
+void cmd_burst_begin(void);
+void cmd_burst_end(void);
 void cmd_to_tlmon(void);
 void cmd_tbl_load(const char *);
 void cmd_tbl_validate(const char *, unsigned short);
@@ -25,5 +28,11 @@ void cmd_es_setperffilter(uint32, uint32);
 void cmd_es_setperftrigger(uint32, uint32);
 void cmd_es_perfstart(void);
 void cmd_es_perfstop(void);
+void cmd_evs_setformat(uint8);
+void cmd_vsc_setengine(uint8);
+void cmd_vsc_dumptrace(uint16);
+void cmd_vs_stage(const char *, const char *);
+uint64 cmd_sent_usecs(void);
+uint16 cmd_validate_seq(void);
 
 #endif
@@ -41,20 +41,30 @@
  * that originated the message along with an app-specific event type,
  * event id, and message string.  This module's function focus on
  * supporting this particular type of message.
+ *
+ * When EVS sends short-form events (CFE_MISSION_EVS_SHORT_EVENT_MSG_MSG)
+ * instead, tlm.c gives the VS apps' short-form table validation error
+ * events back their IDs and text.  Other short-form events have no
+ * text, so these functions match them on app name, event type, and
+ * event ID alone.
  */
 
 #include <assert.h>
+#include <stdarg.h>
+#include <string.h>
 #include <stdio.h>
 
 #include "cfe.h"
 #include "cfe_evs_extern_typedefs.h"   /* for CFE_EVS_EventType_* enum */
-#include "cfe_evs_topicids.h"          /* for EVS LONG message topic ID */
+#include "cfe_evs_topicids.h"   /* for EVS LONG and SHORT message topic IDs */
 #include "to_lab_events.h"             /* for TO_LAB event IDs */
 #include "cfe_tbl_eventids.h"          /* for TBL event IDs */
 #include "vs_ground.h"                 /* for app name constants */
 #include "vs_eventids.h"               /* for common VS event ID constants */
+#include "vs_tablestruct.h"            /* for file.h's vs_table_t */
 
 #include "tlm.h"
+#include "file.h"
 #include "expect.h"
 #include "tbltest.h"
 
@@ -69,19 +79,18 @@
  */
 #define RECEIVE_LIMIT 128
 
+/* The spacecraft's apps send housekeeping telemetry every few
+ * seconds.  If no telemetry at all arrives for this long, TO_LAB has
+ * stopped sending it, and waiting any longer won't help.
+ */
+#define RECEIVE_TIMEOUT 10000   /* msecs */
+
 /* When we pretty-print to the console, we take care to keep our
  * output within a single line of this many characters.
  */
 #define CONSOLE_LINE_LENGTH 80
 
 
-/* Many of our functions use this buffer to construct error message
- * strings that they expect to see in telemetry messages from a
- * combination of constant strings and strings passed as parameters.
- */  
-static char message[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH];
-
-
 /* print_evs_long()
  *
  * in:     prefix - prefix to start console line, "WANT" or "SEEN"
@@ -122,11 +131,13 @@ print_evs_long(const char *prefix, const char *appname,
  *           0      PASS, that is, received a matching message
  *          -1      FAIL, that is, didn't receive a matching message
  *                  within in the number of messages we're allowed
- *                  to wait through.
+ *                  to wait through, or telemetry stopped arriving.
  *
  * The most general of the expect_*() functions.  Will receive
  * telemetry messages until one that matches the input parms arrives
- * (PASS), or too many non-matching messages arrive (FAIL).
+ * (PASS), or too many non-matching messages arrive or no messages
+ * arrive for RECEIVE_TIMEOUT (FAIL).  A matching message that has
+ * already arrived behind too many non-matching ones still counts.
  */
 
 static int
@@ -149,31 +160,39 @@ expect(const char *want_appname, tlm_eventtype_t want_eventtype,
 	/* Receive and print telemetry messages until
          *  (PASS) we receive a telemetry message that matches the
 	 *         conditions we want, or
-	 *  (FAIL) we receive RECEIVE_LIMIT telemetry messages.
+	 *  (FAIL) we receive RECEIVE_LIMIT telemetry messages and
+	 *         the one we want isn't among those already waiting,
+	 *         or no message arrives for RECEIVE_TIMEOUT.
 	 */
-	for (receive_count = 0; receive_count < RECEIVE_LIMIT;
-		receive_count++) {
+	for (receive_count = 0; (receive_count < RECEIVE_LIMIT) ||
+		tlm_buffered_evs(want_appname, want_eventtype,
+		want_eventid, want_message); receive_count++) {
 
-		tlm_receive();
+		if (tlm_receive_timeout(RECEIVE_TIMEOUT)) {
+			printf("SEEN: no telemetry for %d seconds.\n",
+				RECEIVE_TIMEOUT / 1000);
+			break;
+		}
 		seen_topicid = tlm_topicid();
 
-		/* If this isn't a long-form EVS message, it can't be
-		 * the message we want.  Print its topicid and move
-		 * on to the next message.
+		/* If this isn't an EVS message, it can't be the
+		 * message we want.  Print its topicid and move on to
+		 * the next message.
 		 */
-		if (seen_topicid != CFE_MISSION_EVS_LONG_EVENT_MSG_MSG) {
+		if (!tlm_is_evs()) {
 			printf("SEEN: %66s\n",
 			       tlm_topicid_to_string(seen_topicid));
 			continue;
 		}
 
-		/* We've got a long-form EVS message, retrieve the
-		 * fields we care about.
+		/* We've got an EVS message, retrieve the fields we
+		 * care about.
 		 */
 		seen_appname   = tlm_evs_appname();
 		seen_eventtype = tlm_evs_eventtype();
 		seen_eventid   = tlm_evs_eventid();
-		seen_message   = tlm_evs_message();
+		seen_message   = (tlm_evs_has_text() ? tlm_evs_message() :
+			"(short format, no text)");
 		
 		/* Pretty-print the message. */
 		print_evs_long("SEEN:", seen_appname, seen_eventtype,
@@ -182,12 +201,13 @@ expect(const char *want_appname, tlm_eventtype_t want_eventtype,
 		if ((!strcmp(tlm_evs_appname(), want_appname)) &&
 		    (tlm_evs_eventtype() == want_eventtype) &&
 		    (tlm_evs_eventid() == want_eventid) &&
-		    (!strcmp(tlm_evs_message(),	want_message))) {
+		    (!tlm_evs_has_text() ||
+		     !strcmp(tlm_evs_message(), want_message))) {
 			puts("PASS.");
 			return 0;  /* PASS */
 		}
 		
-	} /* For messages up to RECEIVE_LIMIT */
+	} /* For messages up to RECEIVE_LIMIT, or until telemetry stops */
 
 	puts("FAIL.");
 	return -1;  /* FAIL */
@@ -195,9 +215,243 @@ expect(const char *want_appname, tlm_eventtype_t want_eventtype,
 } /* expect() */
 
 
+/* expect_want()
+ *
+ * in:     p_want - the message that indicates test pass
+ * out:    nothing
+ * return: 0 (PASS) if the message arrived, else -1 (FAIL).
+ */
+
+static int
+expect_want(const expect_want_t *p_want) {
+
+	return expect(p_want->appname, p_want->eventtype, p_want->eventid,
+		p_want->message);
+
+} /* expect_want() */
+
+
 /* ------------------ module exported functions ---------------------- */
 
 
+/* expect_want_set()
+ *
+ * in:     appname, eventtype, eventid - fields of the message we want
+ *         format, ... - printf()-style message string we want
+ * out:    p_want      - describes the message we want
+ * return: nothing
+ *
+ * Fills in p_want.  The following expect_want_*() functions fill in
+ * the messages our tests commonly want, so that the expect_*()
+ * functions that wait for one message at a time and pipeline.c's
+ * functions that wait for many at once look for the same ones.
+ */
+
+void
+expect_want_set(expect_want_t *p_want, const char *appname,
+	tlm_eventtype_t eventtype, tlm_eventid_t eventid,
+	const char *format, ...) {
+
+	va_list ap;
+
+	p_want->appname   = appname;
+	p_want->eventtype = eventtype;
+	p_want->eventid   = eventid;
+
+	va_start(ap, format);
+	vsnprintf(p_want->message, CFE_MISSION_EVS_MAX_MESSAGE_LENGTH,
+		format, ap);
+	va_end(ap);
+	assert(p_want->message[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH-1] == '\0');
+
+} /* expect_want_set() */
+
+
+/* expect_want_load()
+ *
+ * in:     filename - table image file TBL should load
+ *         tbl_name - full app.tbl name of table
+ * out:    p_want   - describes TBL's load success event
+ * return: nothing
+ */
+
+void
+expect_want_load(expect_want_t *p_want, const char *filename,
+	const char *tbl_name) {
+
+	expect_want_set(p_want, TLM_NAME_TBL, CFE_EVS_EventType_INFORMATION,
+		CFE_TBL_FILE_LOADED_INF_EID,
+		"Successful load of '%s' into '%s' working buffer",
+		filename, tbl_name);
+
+} /* expect_want_load() */
+
+
+/* expect_want_activate()
+ *
+ * in:     app_name - name of app that owns the table
+ *         tbl_name - full app.tbl name of table
+ *         success  - true for TBL's activation success event, false
+ *                    for its refusal to activate an unvalidated image
+ * out:    p_want   - describes the event
+ * return: nothing
+ */
+
+void
+expect_want_activate(expect_want_t *p_want, const char *app_name,
+	const char *tbl_name, bool success) {
+
+	if (success) {
+		expect_want_set(p_want, TLM_NAME_TBL,
+			CFE_EVS_EventType_INFORMATION,
+			CFE_TBL_UPDATE_SUCCESS_INF_EID,
+			"%s Successfully Updated '%s'", app_name, tbl_name);
+	} else {
+		expect_want_set(p_want, TLM_NAME_TBL, CFE_EVS_EventType_ERROR,
+			CFE_TBL_UNVALIDATED_ERR_EID, "Cannot activate table "
+			"'%s'. Inactive image not Validated", tbl_name);
+	}
+
+} /* expect_want_activate() */
+
+
+/* expect_want_counts()
+ *
+ * in:     app_name      - name of app whose validation function ran
+ *         count_valid   - number of expected valid entries
+ *         count_invalid - number of expected invalid entries
+ *         count_unused  - number of expected unused entries
+ * out:    p_want        - describes the app's validation summary event
+ * return: nothing
+ */
+
+void
+expect_want_counts(expect_want_t *p_want, const char *app_name,
+	unsigned count_valid, unsigned count_invalid, unsigned count_unused) {
+
+	expect_want_set(p_want, app_name, CFE_EVS_EventType_INFORMATION,
+		VS_VALIDATION_INF_EID,
+		"Table image entries: %u valid, %u invalid, %u unused",
+		count_valid, count_invalid, count_unused);
+
+} /* expect_want_counts() */
+
+
+/* expect_want_verdict()
+ *
+ * in:     app_name - name of app whose validation function ran
+ *         tbl_name - full app.tbl name of validated table
+ *         valid    - true for TBL's valid verdict, false for invalid
+ * out:    p_want   - describes TBL's verdict event
+ * return: nothing
+ */
+
+void
+expect_want_verdict(expect_want_t *p_want, const char *app_name,
+	const char *tbl_name, bool valid) {
+
+	if (valid) {
+		expect_want_set(p_want, TLM_NAME_TBL,
+			CFE_EVS_EventType_INFORMATION,
+			CFE_TBL_VALIDATION_INF_EID,
+			"%s validation successful for Inactive '%s'",
+			app_name, tbl_name);
+	} else {
+		expect_want_set(p_want, TLM_NAME_TBL, CFE_EVS_EventType_ERROR,
+			CFE_TBL_VALIDATION_ERR_EID, "%s validation failed for "
+			"Inactive '%s', Status=0xFFFFFFFF", app_name, tbl_name);
+	}
+
+} /* expect_want_verdict() */
+
+
+/* expect_want_stage()
+ *
+ * in:     app_name - name of app that should stage the image
+ *         filename - table image file it should stage
+ * out:    p_want   - describes the app's staged event
+ * return: nothing
+ */
+
+void
+expect_want_stage(expect_want_t *p_want, const char *app_name,
+	const char *filename) {
+
+	expect_want_set(p_want, app_name, CFE_EVS_EventType_INFORMATION,
+		VS_STAGE_INF_EID, "%s: staged %s.", app_name, filename);
+
+} /* expect_want_stage() */
+
+
+/* expect_want_staged_load()
+ *
+ * in:     app_name - name of app that staged the image
+ *         filename - table image file it staged
+ *         valid    - true for the app's loaded event, false for its
+ *                    not-loaded event for an image that fails
+ *                    validation
+ * out:    p_want   - describes the event
+ * return: nothing
+ */
+
+void
+expect_want_staged_load(expect_want_t *p_want, const char *app_name,
+	const char *filename, bool valid) {
+
+	if (valid) {
+		expect_want_set(p_want, app_name,
+			CFE_EVS_EventType_INFORMATION, VS_STAGE_INF_EID,
+			"%s: loaded staged %s.", app_name, filename);
+	} else {
+		expect_want_set(p_want, app_name, CFE_EVS_EventType_ERROR,
+			VS_STAGE_ERR_EID, "%s: staged %s not loaded, "
+			"status 0xFFFFFFFF.", app_name, filename);
+	}
+
+} /* expect_want_staged_load() */
+
+
+/* expect_want_err()
+ *
+ * in:     app_name - name of app we expect to emit the err
+ *         eventid  - error event ID we expect to see
+ *         message  - message string we expect to see
+ * out:    p_want   - describes the error event
+ * return: nothing
+ */
+
+void
+expect_want_err(expect_want_t *p_want, const char *app_name,
+	tlm_eventid_t eventid, const char *message) {
+
+	expect_want_set(p_want, app_name, CFE_EVS_EventType_ERROR, eventid,
+		"%s", message);
+
+} /* expect_want_err() */
+
+
+/* expect_matches()
+ *
+ * in:     p_want - the message we want
+ * out:    nothing
+ * return: true if the latest received telemetry message is that one.
+ *
+ * Short-form events without text match on their other fields.
+ */
+
+bool
+expect_matches(const expect_want_t *p_want) {
+
+	return (tlm_is_evs() &&
+		(!strcmp(tlm_evs_appname(), p_want->appname)) &&
+		(tlm_evs_eventtype() == p_want->eventtype) &&
+		(tlm_evs_eventid() == p_want->eventid) &&
+		(!tlm_evs_has_text() ||
+		 !strcmp(tlm_evs_message(), p_want->message)));
+
+} /* expect_matches() */
+
+
 /* expect_tlmon_success()
  *
  * in:     nothing
@@ -223,7 +477,7 @@ expect_tlmon_success(void) {
 /* expect_load_success()
  *
  *         tbl_name      - full app.tbl name of table
- * out:    message       - overwrote with expected telemetry message
+ * out:    nothing
  * return: 0 (PASS) if command succeeded, else -1 (FAIL).
  *
  * Use this function to confirm that the cFE TLM Table Service loaded
@@ -233,13 +487,10 @@ expect_tlmon_success(void) {
 int
 expect_load_success(const char *tbl_name) {
 	
-	snprintf(message, CFE_MISSION_EVS_MAX_MESSAGE_LENGTH,
-		"Successful load of '%s' into '%s' working buffer",
-		TABLE_FILENAME, tbl_name);
-	assert(message[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH-1] == '\0');
+	expect_want_t want;
 
-	return expect(TLM_NAME_TBL, CFE_EVS_EventType_INFORMATION,
-		CFE_TBL_FILE_LOADED_INF_EID, message);
+	expect_want_load(&want, file_filename(), tbl_name);
+	return expect_want(&want);
 	
 } /* expect_load_success() */
 
@@ -248,7 +499,7 @@ expect_load_success(const char *tbl_name) {
  *
  * in:     app_name      - name of app 
  *         tbl_name      - full app.tbl name of table
- * out:    message       - overwrote with expected telemetry message
+ * out:    nothing
  * return: 0 (PASS) if command succeeded, else -1 (FAIL).
  *
  * Use this function to confirm that the cFE TLM Table Service
@@ -258,12 +509,10 @@ expect_load_success(const char *tbl_name) {
 int
 expect_activate_success(const char *app_name, const char *tbl_name) {
 
-	snprintf(message, CFE_MISSION_EVS_MAX_MESSAGE_LENGTH,
-		"%s Successfully Updated '%s'", app_name, tbl_name);
-	assert(message[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH-1] == '\0');
+	expect_want_t want;
 
-	return expect(TLM_NAME_TBL, CFE_EVS_EventType_INFORMATION,
-		CFE_TBL_UPDATE_SUCCESS_INF_EID, message);
+	expect_want_activate(&want, app_name, tbl_name, true);
+	return expect_want(&want);
 
 } /* expect_activate_success() */
 
@@ -271,7 +520,7 @@ expect_activate_success(const char *app_name, const char *tbl_name) {
 /* expect_activate_failure()
  *
  * in:     tbl_name      - full app.tbl name of table
- * out:    message       - overwrote with expected telemetry message
+ * out:    nothing
  * return: 0 (PASS) if command did *not* succeed, else -1 (FAIL).
  *
  * Use this function to confirm that the cFE TLM Table Service
@@ -281,13 +530,10 @@ expect_activate_success(const char *app_name, const char *tbl_name) {
 int
 expect_activate_failure(const char *tbl_name) {
 	
-	snprintf(message, CFE_MISSION_EVS_MAX_MESSAGE_LENGTH,
-		"Cannot activate table '%s'. "
-		"Inactive image not Validated", tbl_name);
-	assert(message[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH-1] == '\0');
+	expect_want_t want;
 
-	return expect(TLM_NAME_TBL, CFE_EVS_EventType_ERROR,
-		CFE_TBL_UNVALIDATED_ERR_EID, message);
+	expect_want_activate(&want, NULL, tbl_name, false);
+	return expect_want(&want);
 
 } /* expect_activate_failure() */
 
@@ -299,7 +545,7 @@ expect_activate_failure(const char *tbl_name) {
  *         count_valid   - number of expected valid entries
  *         count_invalid - number of expected invalid entries
  *         count_unused  - number of expected unused entries
- * out:    message       - overwrote with expected telemetry message
+ * out:    nothing
  * return: 0 (PASS) if validation found a valid image, else -1 (FAIL).
  *
  * Use this function to confirm that the cFE TLM Table Service invoked
@@ -311,25 +557,16 @@ int
 expect_validate_success(const char *app_name, const char *tbl_name,
 	unsigned count_valid, unsigned count_invalid, unsigned count_unused) {
 
+	expect_want_t want;
 
 	do { /* using do/while/break as a poor man's try/catch */
 	
-		snprintf(message, CFE_MISSION_EVS_MAX_MESSAGE_LENGTH,
-			 "Table image entries: "
-			 "%u valid, %u invalid, %u unused",
-			 count_valid, count_invalid, count_unused);
-		assert(message[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH-1] == '\0');
-		if (expect(app_name, CFE_EVS_EventType_INFORMATION,
-			VS_VALIDATION_INF_EID, message))
-			break;
+		expect_want_counts(&want, app_name, count_valid,
+			count_invalid, count_unused);
+		if (expect_want(&want)) break;
 
-		snprintf(message, CFE_MISSION_EVS_MAX_MESSAGE_LENGTH,
-			 "%s validation successful for Inactive '%s'",
-			 app_name, tbl_name);
-		assert(message[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH-1] == '\0');
-		if (expect(TLM_NAME_TBL, CFE_EVS_EventType_INFORMATION,
-			CFE_TBL_VALIDATION_INF_EID, message)) 
-			break;
+		expect_want_verdict(&want, app_name, tbl_name, true);
+		if (expect_want(&want)) break;
 
 		return 0;  /* PASS */
 
@@ -347,7 +584,7 @@ expect_validate_success(const char *app_name, const char *tbl_name,
  *         count_valid   - number of expected valid entries
  *         count_invalid - number of expected invalid entries
  *         count_unused  - number of expected unused entries
- * out:    message       - overwrote with expected telemetry message
+ * out:    nothing
  * return: 0 (PASS) if validation found a *invalid* image, else -1 (FAIL).
  *
  * Use this function to confirm that the cFE TLM Table Service invoked
@@ -359,26 +596,16 @@ int
 expect_validate_failure(const char *app_name, const char *tbl_name,
 	unsigned count_valid, unsigned count_invalid, unsigned count_unused) {
 
+	expect_want_t want;
 	
 	do { /* using do/while/break as a poor man's try/catch */
 	
-		snprintf(message, CFE_MISSION_EVS_MAX_MESSAGE_LENGTH,
-			 "Table image entries: "
-			 "%u valid, %u invalid, %u unused",
-			 count_valid, count_invalid, count_unused);
-		assert(message[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH-1] == '\0');
-		if (expect(app_name, CFE_EVS_EventType_INFORMATION,
-			VS_VALIDATION_INF_EID, message))
-			break;
+		expect_want_counts(&want, app_name, count_valid,
+			count_invalid, count_unused);
+		if (expect_want(&want)) break;
 
-		snprintf(message, CFE_MISSION_EVS_MAX_MESSAGE_LENGTH,
-			 "%s validation failed for "
-			 "Inactive '%s', Status=0xFFFFFFFF",
-			 app_name, tbl_name);
-		assert(message[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH-1] == '\0');
-		if (expect(TLM_NAME_TBL, CFE_EVS_EventType_ERROR,
-			CFE_TBL_VALIDATION_ERR_EID, message))
-			break;
+		expect_want_verdict(&want, app_name, tbl_name, false);
+		if (expect_want(&want)) break;
 
 		return 0;  /* PASS */
 
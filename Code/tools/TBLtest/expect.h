@@ -16,6 +16,30 @@
  * permissions and limitations under the License.
  */
 
+/* Describes a long-form EVS telemetry message a test wants to see. */
+typedef struct {
+	const char     *appname;
+	tlm_eventtype_t eventtype;
+	tlm_eventid_t   eventid;
+	char            message[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH];
+} expect_want_t;
+
+void expect_want_set(expect_want_t *, const char *, tlm_eventtype_t,
+	tlm_eventid_t, const char *, ...);
+void expect_want_load(expect_want_t *, const char *, const char *);
+void expect_want_activate(expect_want_t *, const char *, const char *,
+	bool);
+void expect_want_counts(expect_want_t *, const char *, unsigned, unsigned,
+	unsigned);
+void expect_want_verdict(expect_want_t *, const char *, const char *,
+	bool);
+void expect_want_stage(expect_want_t *, const char *, const char *);
+void expect_want_staged_load(expect_want_t *, const char *, const char *,
+	bool);
+void expect_want_err(expect_want_t *, const char *, tlm_eventid_t,
+	const char *);
+bool expect_matches(const expect_want_t *);
+
 int expect_tlmon_success(void);
 int expect_load_success(const char *);
 int expect_activate_success(const char *, const char *);
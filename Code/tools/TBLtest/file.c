@@ -21,7 +21,9 @@
  */
 
 #include <arpa/inet.h>    /* for htonl() */
+#include <errno.h>
 #include <string.h>
+#include <stdio.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <assert.h>
@@ -31,8 +33,15 @@
 #include "cfe_tbl_extern_typedefs.h"  /* for CFE_TBL_File_hdr_t type */
 #include "vs_tablestruct.h"           /* for vs_table_t and constants */
 
+#include "capture.h"
+#include "tbltest.h"                  /* for default table file name */
 #include "file.h"
 
+/* The test images put in-use entries as far in as the fourth. */
+#if VS_TABLE_NUM_ENTRIES < 4
+#error "Tbltest needs tables of at least 4 entries"
+#endif
+
 /* ----------------- module private functions and state ------------- */
 
 /* A VSA Parm table file consists of three parts in series: an FS file
@@ -44,6 +53,42 @@ static CFE_FS_Header_t    file_header;
 static CFE_TBL_File_Hdr_t table_header;
 static vs_table_t         table_data;
 
+/* The whole file, rendered in memory so that file_output() can write
+ * it in one call.  Only the table data changes from one image to the
+ * next, so file_init() renders the headers into image only when the
+ * table name or description changes, and file_output() copies in
+ * just the table data.
+ */
+#define IMAGE_DATA_OFFSET \
+	(sizeof(CFE_FS_Header_t) + sizeof(CFE_TBL_File_Hdr_t))
+static char image[IMAGE_DATA_OFFSET + sizeof(vs_table_t)];
+static bool image_headers;    /* are image's headers file_header's? */
+
+/* Tests write their table image to this file in the simulated
+ * spacecraft's filesystem, and host_filename is the same file as seen
+ * from the host.  Only parallel tests need anything but the default.
+ */
+#define FILENAME_MAX_LEN 64   /* OSAL's default OS_MAX_PATH_LEN */
+static char filename[FILENAME_MAX_LEN] = TABLE_FILENAME;
+static char host_filename[sizeof(PATH_TO_CF) + FILENAME_MAX_LEN] =
+	PATH_TO_CF TABLE_FILENAME;
+
+/* file_output() keeps the last file it wrote open and rewrites it in
+ * place when asked to write the same file again, as the soak and
+ * deterministic tests do for every image.  output_name is that
+ * file's host name, and output_fd its descriptor, or -1.
+ */
+static char output_name[sizeof(host_filename)];
+static int  output_fd = -1;
+
+/* If staging_dir isn't NULL, file_output() writes images to files in
+ * that directory, normally a tmpfs such as /dev/shm, and makes each
+ * host file a symbolic link to its image's file.  TBL follows the
+ * links, so images never touch the disk.
+ */
+static const char *staging_dir;
+#define STAGED_FILENAME_MAX_LEN 128
+
 /* parm_id_to_string()
  *
  * in:     id - table entry numeric parm ID to translate
@@ -56,8 +101,12 @@ static vs_table_t         table_data;
  */
 
 static const char *
-parm_id_to_string(uint8 id) {
+parm_id_to_string(vs_parm_id_t id) {
 
+#ifdef VS_PARM_WIDE_MIN
+	if (id >= VS_PARM_WIDE_DIRECTION_MIN) return "WideDir";
+	if (id >= VS_PARM_WIDE_MIN)           return "WideAni";
+#endif
 	switch (id) {
 	case VS_PARM_UNUSED:  return "Unused";
 	case VS_PARM_APE:     return "Ape";
@@ -87,10 +136,12 @@ parm_id_to_string(uint8 id) {
 static void
 print_entry(const vs_entry_t *p_entry) {
 
-	printf("      Parm: %7s Pad: 0x%02x%02x%02x "
-		"Low: 0x%08X  High: 0x%08X\n",
-		parm_id_to_string(p_entry->parm_id),
-		p_entry->pad[0], p_entry->pad[1], p_entry->pad[2],
+	unsigned int k;  /* indexes pad bytes */
+
+	printf("      Parm: %7s Pad: 0x", parm_id_to_string(p_entry->parm_id));
+	for (k = 0; k < VS_ENTRY_PAD_SIZE; k++)
+		printf("%02x", p_entry->pad[k]);
+	printf(" Low: 0x%08X  High: 0x%08X\n",
 		p_entry->bound_low, p_entry->bound_high);
 	
 } /* print_entry() */
@@ -104,6 +155,7 @@ print_entry(const vs_entry_t *p_entry) {
  * in:     tablename_s   - the full table name, for example "VSA_APP.Prm"
  *         description_s - a description of what the image is; a comment
  * out:    file_header, table_header, table_data - see below
+ *         image - headers rendered, if they changed
  * return: nothing
  *
  * Initializes file_header, table_header, and table_data to describe
@@ -122,12 +174,20 @@ file_init(const char *tablename_s, const char *description_s) {
 	assert(tablename_s);
 	assert(description_s);
 	
-	/* Clear everything to zeros. For VSA, all-zero table data is
-	 * a valid empty table.
+	/* For VSA, all-zero table data is a valid empty table.  Keep
+	 * the headers we have if they already have these strings.
 	 */
+	memset(&table_data,   '\0', sizeof(vs_table_t));
+	if (image_headers &&
+		!strncmp(table_header.TableName, tablename_s,
+			(CFE_MISSION_TBL_MAX_FULL_NAME_LEN - 1)) &&
+		!strncmp(file_header.Description, description_s,
+			(CFE_FS_HDR_DESC_MAX_LEN - 1)))
+		return;
+
+	/* Clear the headers to zeros. */
 	memset(&file_header,  '\0', sizeof(CFE_FS_Header_t));
 	memset(&table_header, '\0', sizeof(CFE_TBL_File_Hdr_t));
-	memset(&table_data,   '\0', sizeof(vs_table_t));
 
 	/* Set the numeric header values in network (that is,
 	 * big-endian) byte order.  Leave the file header spacecraft
@@ -149,6 +209,11 @@ file_init(const char *tablename_s, const char *description_s) {
 		(CFE_MISSION_TBL_MAX_FULL_NAME_LEN - 1));
 	strncpy(file_header.Description, description_s,
 		(CFE_FS_HDR_DESC_MAX_LEN - 1));
+
+	memcpy(image, &file_header, sizeof(CFE_FS_Header_t));
+	memcpy(&(image[sizeof(CFE_FS_Header_t)]), &table_header,
+		sizeof(CFE_TBL_File_Hdr_t));
+	image_headers = true;
 	
 } /* file_init() */
 
@@ -168,29 +233,96 @@ file_init(const char *tablename_s, const char *description_s) {
  */
 
 void
-file_set_entry(unsigned int entry, uint8 parm_id, uint8 pad, uint32 bound_low,
-	uint32 bound_high) {
+file_set_entry(unsigned int entry, uint32 parm_id, uint8 pad,
+	uint32 bound_low, uint32 bound_high) {
+
+	unsigned int k;  /* indexes pad bytes */
 
 	/* Attempting to set an entry outside of the range of the
 	 * table is a bug in our test program.
 	 */
 	assert((0 <= entry) && (entry < VS_TABLE_NUM_ENTRIES));
 
-	table_data.entries[entry].parm_id    = parm_id;
-	table_data.entries[entry].pad[0]     = pad;
-	table_data.entries[entry].pad[1]     = pad;
-	table_data.entries[entry].pad[2]     = pad;
+	table_data.entries[entry].parm_id    = (vs_parm_id_t)parm_id;
+	for (k = 0; k < VS_ENTRY_PAD_SIZE; k++)
+		table_data.entries[entry].pad[k] = pad;
 	table_data.entries[entry].bound_low  = bound_low; /* host byte order */
 	table_data.entries[entry].bound_high = bound_high;/* host byte order */
 	
 } /* file_set_entry() */
 
 
+/* file_set_table()
+ *
+ * in:     p_table    - a whole table image
+ * out:    table_data - a copy of p_table
+ * return: nothing
+ *
+ * Use this function to test images, such as those of a golden-image
+ * corpus, that file_set_entry() can't make.
+ */
+
+void
+file_set_table(const vs_table_t *p_table) {
+
+	memcpy(&table_data, p_table, sizeof(table_data));
+
+} /* file_set_table() */
+
+
+/* file_open()
+ *
+ * in:     filename_s  - host name of file to save table image in
+ *         staging_dir - directory to stage images in, or NULL
+ * out:    output_fd, output_name - the open file and its host name
+ * return: 0 on success, -1 on failure with errno set.
+ *
+ * Opens the file to write an image in.  When staging, that's a file
+ * in staging_dir with the same base name as filename_s, and
+ * filename_s becomes a symbolic link to it.
+ */
+
+static int
+file_open(const char *filename_s) {
+
+	char staged[STAGED_FILENAME_MAX_LEN];  /* file in staging_dir */
+	const char *base;                      /* base of filename_s */
+	const char *open_s = filename_s;       /* file to open */
+
+	if (output_fd != -1) close(output_fd);
+	output_fd = -1;
+	output_name[0] = '\0';
+
+	if (staging_dir) {
+		base = strrchr(filename_s, '/');
+		base = (base ? base + 1 : filename_s);
+		if ((size_t)snprintf(staged, sizeof(staged), "%s/%s",
+			staging_dir, base) >= sizeof(staged)) {
+			errno = ENAMETOOLONG;
+			return -1;
+		}
+		if ((-1 == unlink(filename_s)) && (errno != ENOENT))
+			return -1;
+		if (-1 == symlink(staged, filename_s)) return -1;
+		open_s = staged;
+	}
+
+	if (-1 == (output_fd = open(open_s, (O_CREAT|O_WRONLY),
+		(S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH))))
+		return -1;
+	snprintf(output_name, sizeof(output_name), "%s", filename_s);
+	return 0;
+
+} /* file_open() */
+
+
 /* file_output()
  *
  * in:     filename_s - name of file to save table image in, see below
  *         file_header, table_header, table_data - table image to output
- * out:    nothing
+ *         output_fd, output_name - last file written, if still open
+ * out:    image - table_data rendered after the headers
+ *         output_fd, output_name - the file written, left open
  *
  * Creates a .tbl CFE table image file based on the contents of
  * file_header, table_header, and table data.  Saves in the file
@@ -205,35 +337,33 @@ file_set_entry(unsigned int entry, uint8 parm_id, uint8 pad, uint32 bound_low,
  * you expect to run this program from the "build/exe/host" directory,
  * then a filename like "../cpu1/cf/VS_Prm_test.tbl" would work.
  *
+ * Every image is the same size, so rewriting a file in place leaves
+ * nothing of the image before.  When replaying a capture, there's no
+ * spacecraft to read the file, so it renders the image but doesn't
+ * write it.  Call file_remove() rather than
+ * unlink() to remove the file.
+ *
  */
 
 void
 file_output(const char *filename_s) {
 
-	int fd;  /* file descriptor to output file */
-	
 	assert(filename_s);
+	assert(image_headers);   /* call file_init() first */
+
+	memcpy(&(image[IMAGE_DATA_OFFSET]), &table_data, sizeof(vs_table_t));
+	if (capture_replaying()) return;   /* no spacecraft to read it */
 
 	/* Using do/while/break as a poor man's try/catch */
 	do {
 	
-		if (-1 == (fd = open(filename_s, (O_CREAT|O_WRONLY),
-			(S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH))))
+		if (((output_fd == -1) || strcmp(output_name, filename_s)) &&
+			file_open(filename_s))
 			break;
 
-		if (sizeof(CFE_FS_Header_t) != write(fd, &file_header,
-			sizeof(CFE_FS_Header_t)))
-			break;
-		
-		if (sizeof(CFE_TBL_File_Hdr_t) != write(fd, &table_header,
-			sizeof(CFE_TBL_File_Hdr_t)))
-			break;
-			
-		if (sizeof(vs_table_t) != write(fd, &table_data,
-			sizeof(vs_table_t)))
+		if (sizeof(image) != pwrite(output_fd, image, sizeof(image), 0))
 			break;
 		
-		close(fd);
 		return;    /* file written OK! */
 
 	} while (0);
@@ -244,6 +374,112 @@ file_output(const char *filename_s) {
 } /* file_output() */
 
 
+/* file_remove()
+ *
+ * in:     host_filename - table image file on the host
+ *         staging_dir   - directory images are staged in, or NULL
+ * out:    output_fd, output_name - closed if they were that file
+ * return: nothing
+ *
+ * Removes the current table image file, and its staged file, if any.
+ */
+
+void
+file_remove(void) {
+
+	char staged[STAGED_FILENAME_MAX_LEN];  /* file in staging_dir */
+	const char *base;                      /* base of host_filename */
+
+	if ((output_fd != -1) && !strcmp(output_name, host_filename)) {
+		close(output_fd);
+		output_fd = -1;
+		output_name[0] = '\0';
+	}
+	unlink(host_filename);
+
+	if (staging_dir) {
+		base = strrchr(host_filename, '/');
+		base = (base ? base + 1 : host_filename);
+		snprintf(staged, sizeof(staged), "%s/%s", staging_dir, base);
+		unlink(staged);
+	}
+
+} /* file_remove() */
+
+
+/* file_set_staging()
+ *
+ * in:     dir_s       - directory to stage images in, normally on a
+ *                       tmpfs such as /dev/shm, or NULL to write
+ *                       images straight to the host files
+ * out:    staging_dir - set to dir_s
+ *         output_fd, output_name - closed
+ * return: nothing
+ *
+ * The string dir_s must outlive the test run; argv strings do.
+ */
+
+void
+file_set_staging(const char *dir_s) {
+
+	if (output_fd != -1) close(output_fd);
+	output_fd = -1;
+	output_name[0] = '\0';
+	staging_dir = dir_s;
+
+} /* file_set_staging() */
+
+
+/* file_set_filename()
+ *
+ * in:     filename_s - table image file name on the spacecraft,
+ *                      such as "/cf/tbltest_Prm.tbl"
+ * out:    filename, host_filename - set to filename_s
+ * return: nothing
+ */
+
+void
+file_set_filename(const char *filename_s) {
+
+	assert(strlen(filename_s) < FILENAME_MAX_LEN);
+
+	strcpy(filename, filename_s);
+	snprintf(host_filename, sizeof(host_filename), "%s%s", PATH_TO_CF,
+		filename_s);
+
+} /* file_set_filename() */
+
+
+/* file_filename()
+ *
+ * in:     filename - table image file name on the spacecraft
+ * out:    nothing
+ * return: filename, for load commands and the events they cause.
+ */
+
+const char *
+file_filename(void) {
+
+	return filename;
+
+} /* file_filename() */
+
+
+/* file_host_filename()
+ *
+ * in:     host_filename - table image file name on the host
+ * out:    nothing
+ * return: host_filename, for file_output().
+ */
+
+const char *
+file_host_filename(void) {
+
+	return host_filename;
+
+} /* file_host_filename() */
+
+
 /* file_print()
  *
  * in:     table_data - table image data
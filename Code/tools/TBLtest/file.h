@@ -17,8 +17,14 @@
  */
 
 void file_init(const char *, const char *);
-void file_set_entry(unsigned int, uint8, uint8, uint32, uint32);
+void file_set_entry(unsigned int, uint32, uint8, uint32, uint32);
+void file_set_table(const vs_table_t *);
 void file_output(const char *);
+void file_remove(void);
+void file_set_staging(const char *);
+void file_set_filename(const char *);
+const char *file_filename(void);
+const char *file_host_filename(void);
 void file_print(void);
 
 #endif
@@ -0,0 +1,508 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This file traces each validation a test asks for from end to end,
+ * and splits its latency into the hops along the way: from the TBL
+ * validate command leaving us, through CI_LAB, SB, and TBL, to the
+ * app's next wakeup; from the wakeup through CFE_TBL_Manage() to the
+ * validation function; the validation function itself; from its
+ * return through TBL to the EVS event with TBL's verdict; and from
+ * that event through TO_LAB and UDP to our receiver thread.
+ *
+ * The times come from three clocks.  Ours, capture_now(), times the
+ * command leaving and the verdict arriving.  ES's perf log times the
+ * app's wakeup, its *_ALL_PERF_ID entry just after
+ * CFE_SB_ReceiveBuffer() returns, and the validation function's entry
+ * and exit.  The verdict's telemetry secondary header holds the
+ * spacecraft time EVS sent it at.  The clocks needn't agree, but each
+ * validation bounds the offsets between them: the app can't wake to
+ * a command before we send it, and the verdict can't leave before
+ * the validation function returns or arrive before it leaves.
+ * latency_window() sets each offset to the middle of the range a perf
+ * window's validations leave it and says how wide the range is.  The
+ * more validations a window holds, the narrower it gets.
+ *
+ * Validations run one at a time through the tests that trace them,
+ * so the validate commands of a window, the validation function's
+ * runs in its perf dump, and the verdicts pair up in order.  Each
+ * validate command's CCSDS sequence count numbers it, as does each
+ * latency line; see cmd.c.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "cfe.h"
+
+#include "vs_bench_json.h"             /* for vs_bench_result_t */
+
+#include "cmd.h"
+#include "tlm.h"
+#include "perf.h"
+#include "latency.h"
+
+
+/* ------------- module local definitions and functions ------------ */
+
+/* The hops, in order, then the total. */
+#define LATENCY_NUM_HOPS     (LATENCY_NUM_RESULTS - 1)
+#define LATENCY_TOTAL        LATENCY_NUM_HOPS
+
+static const struct {
+	const char *name;   /* for the waterfall */
+	const char *key;    /* for the per-validation lines and JSON */
+} hops[LATENCY_NUM_RESULTS] = {
+	{ "command to wakeup",     "wakeup"   },
+	{ "wakeup to validation",  "manage"   },
+	{ "validation",            "validate" },
+	{ "validation to verdict", "report"   },
+	{ "verdict to TBLtest",    "downlink" },
+	{ "total",                 "total"    },
+};
+
+/* The waterfall's bars are this many characters wide. */
+#define LATENCY_BAR_WIDTH 20
+
+/* The window's arrays start out this long and grow as needed. */
+#define LATENCY_MIN_SIZE 64
+
+/* One validation of the open perf window, as we saw it. */
+typedef struct {
+	uint16 seq;          /* its validate command's number */
+	bool   arrived;      /* did its verdict arrive? */
+	uint64 sent;         /* capture_now() the command left at */
+	uint64 received;     /* capture_now() the verdict arrived at */
+	uint64 verdict;      /* spacecraft time EVS sent the verdict at */
+} latency_record_t;
+
+/* One validation function run of the window's perf dump, in ticks. */
+typedef struct {
+	uint64 wakeup;       /* the app's *_ALL_PERF_ID entry around it */
+	uint64 entry;
+	uint64 exit;
+} latency_run_t;
+
+static bool enabled;     /* latency_set() */
+
+static latency_record_t *records;   /* the open window's validations */
+static uint32 num_records, max_records;
+static latency_run_t *runs;         /* its perf dump's runs */
+static uint32 num_runs, max_runs;
+
+/* Each hop's latency, and the total, of every validation traced over
+ * the whole run, in usecs, and their statistics, once
+ * latency_summary() computes them.
+ */
+static uint64 *latencies[LATENCY_NUM_RESULTS];
+static uint32 num_latencies, max_latencies;
+static perf_stats_t stats[LATENCY_NUM_RESULTS];
+
+
+/* latency_grow()
+ *
+ * in:     p_array - array to grow
+ *         p_max   - its length, in elements
+ *         count   - elements it must hold
+ *         size    - size of each element
+ * out:    p_array - no shorter than count elements
+ *         p_max   - its new length
+ * return: nothing; exits the program if it can't grow the array.
+ */
+
+static void
+latency_grow(void **p_array, uint32 *p_max, uint32 count, size_t size) {
+
+	void *grown;
+	uint32 max = *p_max;
+
+	if (count <= max) return;
+	while (max < count) max = (max ? (max * 2) : LATENCY_MIN_SIZE);
+	if (NULL == (grown = realloc(*p_array, max * size))) {
+		perror("Failed to store latencies.");
+		exit(-1);
+	}
+	*p_array = grown;
+	*p_max   = max;
+
+} /* latency_grow() */
+
+
+/* latency_usecs()
+ *
+ * in:     ticks            - perf log time
+ *         ticks_per_second - perf log timer's rate
+ * out:    nothing
+ * return: ticks in usecs.
+ */
+
+static int64
+latency_usecs(uint64 ticks, uint32 ticks_per_second) {
+
+	return (int64)(((ticks / ticks_per_second) * 1000000) +
+		(((ticks % ticks_per_second) * 1000000) / ticks_per_second));
+
+} /* latency_usecs() */
+
+
+/* latency_middle()
+ *
+ * in:     lo, hi - range of an offset
+ * out:    nothing
+ * return: the middle of the range.
+ */
+
+static int64
+latency_middle(int64 lo, int64 hi) {
+
+	return lo + ((hi - lo) / 2);
+
+} /* latency_middle() */
+
+
+/* latency_print_range()
+ *
+ * in:     clock - name of the clock whose offset we set
+ *         lo, hi - range of the offset
+ * out:    nothing
+ * return: nothing
+ */
+
+static void
+latency_print_range(const char *clock, int64 lo, int64 hi) {
+
+	if (lo <= hi) {
+		printf("PERF: %s offset known to within %lld usecs.\n",
+			clock, (long long)(hi - lo));
+	} else {
+		printf("PERF: %s offset bounds cross by %lld usecs; does "
+			"the clock drift?\n", clock, (long long)(lo - hi));
+	}
+
+} /* latency_print_range() */
+
+
+/* ------------------- module exported functions -------------------- */
+
+/* latency_set()
+ *
+ * in:     on      - trace each validation's latency?
+ * out:    enabled - set to on
+ * return: nothing
+ */
+
+void
+latency_set(bool on) {
+
+	enabled = on;
+
+} /* latency_set() */
+
+
+/* latency_enabled()
+ *
+ * in:     enabled
+ * out:    nothing
+ * return: true if latency_set() turned tracing on.
+ */
+
+bool
+latency_enabled(void) {
+
+	return enabled;
+
+} /* latency_enabled() */
+
+
+/* latency_sent()
+ *
+ * in:     nothing
+ * out:    records - gains a record of the validate command just sent
+ * return: nothing
+ *
+ * Call right after sending a TBL validate command.
+ */
+
+void
+latency_sent(void) {
+
+	latency_record_t *p_record;
+
+	if (!enabled) return;
+
+	latency_grow((void **)&records, &max_records, num_records + 1,
+		sizeof(records[0]));
+	p_record = &(records[num_records++]);
+	memset(p_record, 0, sizeof(*p_record));
+	p_record->seq  = cmd_validate_seq();
+	p_record->sent = cmd_sent_usecs();
+
+} /* latency_sent() */
+
+
+/* latency_arrived()
+ *
+ * in:     nothing
+ * out:    records - latest record completed
+ * return: nothing
+ *
+ * Call once the latest telemetry message received is TBL's verdict
+ * on the latest validate command latency_sent() saw.
+ */
+
+void
+latency_arrived(void) {
+
+	latency_record_t *p_record;
+
+	if (!enabled || (num_records == 0)) return;
+
+	p_record = &(records[num_records - 1]);
+	p_record->arrived  = true;
+	p_record->received = tlm_arrival_usecs();
+	p_record->verdict  = tlm_time_usecs();
+
+} /* latency_arrived() */
+
+
+/* latency_run()
+ *
+ * in:     wakeup - perf log time of the app's wakeup
+ *         entry  - and of its validation function's entry
+ *         exit   - and exit
+ * out:    runs   - gains the run
+ * return: nothing
+ *
+ * perf.c calls this for each run of the validation function it finds
+ * in a perf dump, in order.
+ */
+
+void
+latency_run(uint64 wakeup, uint64 entry, uint64 exit) {
+
+	if (!enabled) return;
+
+	latency_grow((void **)&runs, &max_runs, num_runs + 1,
+		sizeof(runs[0]));
+	runs[num_runs].wakeup = wakeup;
+	runs[num_runs].entry  = entry;
+	runs[num_runs].exit   = exit;
+	num_runs++;
+
+} /* latency_run() */
+
+
+/* latency_window()
+ *
+ * in:     ticks_per_second - perf log timer's rate
+ *         records          - the window's validations
+ *         runs             - its perf dump's runs
+ * out:    records, runs    - emptied
+ *         latencies        - the window's validations added
+ * return: nothing
+ *
+ * perf.c calls this at the end of each perf dump.  Pairs the window's
+ * validations with the dump's runs, sets the clock offsets, and
+ * prints each validation's hops.  A window whose validations and runs
+ * don't pair up, as when ES's buffer overflows, adds nothing.
+ */
+
+void
+latency_window(uint32 ticks_per_second) {
+
+	int64 p_lo = INT64_MIN, p_hi = INT64_MAX;  /* perf clock offset */
+	int64 s_lo = INT64_MIN, s_hi = INT64_MAX;  /* spacecraft's */
+	int64 p_offset, s_offset;
+	int64 t[LATENCY_NUM_HOPS + 1];   /* one validation's times, ours */
+	int64 hop;
+	const latency_record_t *p_record;
+	const latency_run_t *p_run;
+	uint32 arrived = 0;
+	uint32 max = 0;                  /* latencies[]' new length */
+	uint32 i;
+	int h;
+
+	if (!enabled || (num_records == 0)) {
+		num_records = num_runs = 0;
+		return;
+	}
+	if ((num_runs != num_records) || (ticks_per_second == 0)) {
+		printf("PERF: %u validations but %u runs in the perf log; "
+			"no latencies for this window.\n",
+			(unsigned int)num_records, (unsigned int)num_runs);
+		num_records = num_runs = 0;
+		return;
+	}
+
+	/* Bound the perf clock's offset from ours, then, given it,
+	 * the spacecraft clock's.
+	 */
+	for (i = 0; i < num_records; i++) {
+		p_record = &(records[i]);
+		p_run    = &(runs[i]);
+		if (!p_record->arrived) continue;
+		arrived++;
+		if (p_lo < (int64)p_record->sent -
+			latency_usecs(p_run->wakeup, ticks_per_second))
+			p_lo = (int64)p_record->sent -
+				latency_usecs(p_run->wakeup, ticks_per_second);
+		if (p_hi > (int64)p_record->received -
+			latency_usecs(p_run->exit, ticks_per_second))
+			p_hi = (int64)p_record->received -
+				latency_usecs(p_run->exit, ticks_per_second);
+	}
+	if (arrived == 0) {
+		num_records = num_runs = 0;
+		return;
+	}
+	p_offset = latency_middle(p_lo, p_hi);
+
+	for (i = 0; i < num_records; i++) {
+		p_record = &(records[i]);
+		p_run    = &(runs[i]);
+		if (!p_record->arrived) continue;
+		hop = latency_usecs(p_run->exit, ticks_per_second) + p_offset -
+			(int64)p_record->verdict;
+		if (s_lo < hop) s_lo = hop;
+		hop = (int64)p_record->received - (int64)p_record->verdict;
+		if (s_hi > hop) s_hi = hop;
+	}
+	s_offset = latency_middle(s_lo, s_hi);
+
+	latency_print_range("Perf log clock", p_lo, p_hi);
+	latency_print_range("Spacecraft clock", s_lo, s_hi);
+
+	/* Put each validation's times on our clock and add its hops.
+	 * A hop an offset's error makes negative counts as 0.
+	 */
+	for (h = 0; h < LATENCY_NUM_RESULTS; h++) {
+		max = max_latencies;
+		latency_grow((void **)&(latencies[h]), &max,
+			num_latencies + arrived, sizeof(latencies[h][0]));
+	}
+	max_latencies = max;
+	for (i = 0; i < num_records; i++) {
+		p_record = &(records[i]);
+		p_run    = &(runs[i]);
+		if (!p_record->arrived) continue;
+
+		t[0] = (int64)p_record->sent;
+		t[1] = latency_usecs(p_run->wakeup, ticks_per_second) +
+			p_offset;
+		t[2] = latency_usecs(p_run->entry, ticks_per_second) +
+			p_offset;
+		t[3] = latency_usecs(p_run->exit, ticks_per_second) +
+			p_offset;
+		t[4] = (int64)p_record->verdict + s_offset;
+		t[5] = (int64)p_record->received;
+
+		printf("PERF: Validation %u latency in usecs:",
+			(unsigned int)p_record->seq);
+		for (h = 0; h < LATENCY_NUM_RESULTS; h++) {
+			hop = ((h == LATENCY_TOTAL) ? (t[LATENCY_NUM_HOPS] -
+				t[0]) : (t[h + 1] - t[h]));
+			if (hop < 0) hop = 0;
+			latencies[h][num_latencies] = (uint64)hop;
+			printf(" %s %lld", hops[h].key, (long long)hop);
+		}
+		printf("\n");
+		num_latencies++;
+	}
+
+	num_records = num_runs = 0;
+
+} /* latency_window() */
+
+
+/* latency_summary()
+ *
+ * in:     latencies - every validation traced over the run
+ * out:    latencies - sorted
+ *         stats     - each hop's latency statistics
+ * return: nothing
+ *
+ * Prints the run's latency waterfall: each hop's mean, median, and
+ * 99th percentile latency and share of the total's mean, with a bar
+ * that starts where the hop before it ends.
+ */
+
+void
+latency_summary(void) {
+
+	double start = 0.0;      /* mean time before the hop began */
+	int from, to;            /* columns the hop's bar covers */
+	int h, c;
+
+	if (!enabled || (num_latencies == 0)) return;
+
+	for (h = 0; h < LATENCY_NUM_RESULTS; h++) {
+		perf_compute_stats(latencies[h], num_latencies, &(stats[h]));
+	}
+
+	printf("PERF: Latency waterfall of %u validations, in usecs:\n",
+		(unsigned int)num_latencies);
+	for (h = 0; h < LATENCY_NUM_RESULTS; h++) {
+		if (h == LATENCY_TOTAL) start = 0.0;
+		from = (int)(LATENCY_BAR_WIDTH * start /
+			stats[LATENCY_TOTAL].mean + 0.5);
+		to   = (int)(LATENCY_BAR_WIDTH * (start + stats[h].mean) /
+			stats[LATENCY_TOTAL].mean + 0.5);
+		printf("PERF:   %-22s mean %9.1f p50 %8llu p99 %8llu "
+			"%5.1f%% |", hops[h].name, stats[h].mean,
+			(unsigned long long)stats[h].median,
+			(unsigned long long)stats[h].p99,
+			100.0 * stats[h].mean / stats[LATENCY_TOTAL].mean);
+		for (c = 0; c < LATENCY_BAR_WIDTH; c++) {
+			putchar(((c >= from) && (c < to)) ? '#' :
+				(((c == from) && (stats[h].mean > 0.0)) ?
+				'.' : ' '));
+		}
+		printf("|\n");
+		start += stats[h].mean;
+	}
+
+} /* latency_summary() */
+
+
+/* latency_results()
+ *
+ * in:     stats   - from latency_summary()
+ * out:    results - each hop's result, then the total's, named
+ *                   tbltest.latency.KEY
+ * return: the number of results, 0 if latency_summary() had none.
+ */
+
+int
+latency_results(vs_bench_result_t *results) {
+
+	int h;
+
+	if (!enabled || (num_latencies == 0)) return 0;
+
+	for (h = 0; h < LATENCY_NUM_RESULTS; h++) {
+		memset(&(results[h]), 0, sizeof(results[h]));
+		snprintf(results[h].name, sizeof(results[h].name),
+			"tbltest.latency.%s", hops[h].key);
+		snprintf(results[h].unit, sizeof(results[h].unit), "us");
+		results[h].count = stats[h].count;
+		results[h].p50   = (double)stats[h].median;
+		results[h].p99   = (double)stats[h].p99;
+		results[h].mean  = stats[h].mean;
+	}
+	return LATENCY_NUM_RESULTS;
+
+} /* latency_results() */
@@ -0,0 +1,33 @@
+#ifndef _LATENCY_H_
+#define _LATENCY_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "vs_bench_json.h"             /* for vs_bench_result_t */
+
+/* The most results latency_results() writes: five hops and a total. */
+#define LATENCY_NUM_RESULTS 6
+
+void latency_set(bool);
+bool latency_enabled(void);
+void latency_sent(void);
+void latency_arrived(void);
+void latency_run(uint64, uint64, uint64);
+void latency_window(uint32);
+void latency_summary(void);
+int  latency_results(vs_bench_result_t *);
+
+#endif
@@ -0,0 +1,290 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This file runs the deterministic tests on VSA, VSB, and VSC at the
+ * same time.  Each app's tests run unchanged in a child process of
+ * their own with their own table image file and their own log file.
+ * The parent process owns the telemetry socket.  It hands each
+ * child, over a socketpair, the events about that child's app or
+ * table and a copy of everything else, so that each child's expect()
+ * calls see the same telemetry they would see running alone, give or
+ * take the other apps' housekeeping.
+ *
+ * ES has only one perf log, so the children don't touch it.  Instead,
+ * the parent logs all three apps' validation functions for the whole
+ * run and reports their durations at the end.
+ */
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdio.h>
+
+#include "cfe.h"
+#include "cfe_evs_extern_typedefs.h"   /* for CFE_EVS_EventType_* enum */
+#include "cfe_evs_topicids.h"          /* for EVS LONG message topic ID */
+#include "vs_ground.h"                 /* for app names, perf IDs */
+#include "vs_tablestruct.h"            /* for raw table name */
+
+#include "tlm.h"
+#include "file.h"
+#include "send.h"
+#include "expect.h"
+#include "perf.h"
+#include "deterministic.h"
+#include "parallel.h"
+
+
+/* ------------- module local definitions and functions ------------ */
+
+/* How often the parent checks for children that have finished. */
+#define PARALLEL_POLL_PERIOD 100   /* msecs */
+
+typedef struct {
+	const char *app_name;
+	uint32      app_perfid;
+	const char *tbl_name;
+	const char *filename;   /* table image file on the spacecraft */
+	const char *log_name;   /* the child's console output */
+	pid_t       pid;        /* child process, or 0 once it's finished */
+	int         fd;         /* parent's end of the child's socketpair */
+	int         status;     /* child's exit status */
+	unsigned    forwarded;  /* messages handed to the child */
+	unsigned    dropped;    /* messages the child couldn't take */
+} parallel_app_t;
+
+#define PARALLEL_APP(name, perfid) {                                 \
+	name, perfid, name "." VS_RAW_TABLE_NAME,                     \
+	"/cf/tbltest_" name ".tbl", "tbltest-" name ".log",           \
+	0, -1, 0, 0, 0 }
+
+static parallel_app_t apps[] = {
+	PARALLEL_APP(VSA_APP_NAME, VSA_VF_PERF_ID),
+	PARALLEL_APP(VSB_APP_NAME, VSB_VF_PERF_ID),
+	PARALLEL_APP(VSC_APP_NAME, VSC_VF_PERF_ID),
+};
+#define NUM_APPS ((int)(sizeof(apps) / sizeof(apps[0])))
+
+
+/* parallel_child()
+ *
+ * in:     p_app   - app this child tests
+ *         fd      - child's end of its socketpair with the parent
+ * out:    nothing
+ * return: never; exits with 0 if all tests passed, else 1.
+ */
+
+static void
+parallel_child(const parallel_app_t *p_app, int fd) {
+
+	int i;
+
+	/* Keep only our own end of our own socketpair. */
+	for (i = 0; i < NUM_APPS; i++) {
+		if (apps[i].fd != -1) close(apps[i].fd);
+	}
+	tlm_set_socket(fd);
+
+	if (NULL == freopen(p_app->log_name, "w", stdout)) {
+		perror("Failed to open parallel test log.");
+		exit(1);
+	}
+	file_set_filename(p_app->filename);
+	perf_disable();
+	perf_set_csv(NULL);   /* the parent writes the CSV */
+
+	exit(deterministic(p_app->app_name, p_app->app_perfid,
+		p_app->tbl_name) ? 1 : 0);
+
+} /* parallel_child() */
+
+
+/* parallel_route()
+ *
+ * in:     tlm_msg - latest received telemetry message
+ * out:    nothing
+ * return: index in apps[] of the child the message is for, or -1 if
+ *         every child should get a copy.
+ *
+ * Events an app sends go to that app's child.  TBL events go to the
+ * child whose table they name.  Everything else, housekeeping
+ * included, goes to everyone: the children accept any number of
+ * messages they don't want while waiting for one they do.
+ */
+
+static int
+parallel_route(void) {
+
+	const char *appname;
+	int i;
+
+	if (tlm_topicid() != CFE_MISSION_EVS_LONG_EVENT_MSG_MSG) return -1;
+
+	appname = tlm_evs_appname();
+	for (i = 0; i < NUM_APPS; i++) {
+		if (!strcmp(appname, apps[i].app_name)) return i;
+	}
+	if (!strcmp(appname, TLM_NAME_TBL)) {
+		for (i = 0; i < NUM_APPS; i++) {
+			if (strstr(tlm_evs_message(), apps[i].tbl_name))
+				return i;
+		}
+	}
+	return -1;
+
+} /* parallel_route() */
+
+
+/* parallel_forward()
+ *
+ * in:     p_app   - child to hand the latest telemetry message to
+ *         tlm_msg - latest received telemetry message
+ * out:    p_app   - forwarded or dropped count updated
+ * return: nothing
+ */
+
+static void
+parallel_forward(parallel_app_t *p_app) {
+
+	if (p_app->pid == 0) return;   /* finished already */
+
+	if (-1 == send(p_app->fd, tlm_bytes(), tlm_length(),
+		MSG_DONTWAIT)) {
+		p_app->dropped++;
+	} else {
+		p_app->forwarded++;
+	}
+
+} /* parallel_forward() */
+
+
+/* parallel_reap()
+ *
+ * in:     apps    - children still running
+ * out:    apps    - children that have finished marked so
+ * return: number of children still running.
+ */
+
+static int
+parallel_reap(void) {
+
+	int running = 0;
+	int i;
+
+	for (i = 0; i < NUM_APPS; i++) {
+		if (apps[i].pid == 0) continue;
+		if (apps[i].pid == waitpid(apps[i].pid, &(apps[i].status),
+			WNOHANG)) {
+			apps[i].pid = 0;
+			close(apps[i].fd);
+			apps[i].fd = -1;
+		} else {
+			running++;
+		}
+	}
+	return running;
+
+} /* parallel_reap() */
+
+
+/* ------------------- module exported functions ----------------------- */
+
+/* parallel()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: 0 if all tests for all apps passed, -1 otherwise
+ *
+ * Runs the deterministic tests for every app at once and waits for
+ * them to finish.  Each child's console output goes to its log file;
+ * the parent prints each app's verdict, how many telemetry messages
+ * it handed each child and how many the child's socket had no room
+ * for, and the validation function durations for all the apps.
+ */
+
+int
+parallel(void) {
+
+	uint32 perfids[NUM_APPS];
+	int sv[2];                   /* a socketpair */
+	int result = 0;
+	int i, to;
+
+	/* Have ES log every app's validation function, and tell
+	 * TO_LAB to turn on the telemetry output we need.
+	 */
+	for (i = 0; i < NUM_APPS; i++) perfids[i] = apps[i].app_perfid;
+	send_perfmon_ids("all VS apps", perfids, NUM_APPS);
+	send_tlmon();
+	if (expect_tlmon_success()) return -1;
+	send_perfstart();
+
+	fflush(stdout);   /* don't let the children inherit our output */
+	for (i = 0; i < NUM_APPS; i++) {
+		if (-1 == socketpair(AF_UNIX, SOCK_DGRAM, 0, sv)) {
+			perror("Failed to create parallel test socketpair.");
+			exit(-1);
+		}
+		switch (apps[i].pid = fork()) {
+		case -1:
+			perror("Failed to start parallel test.");
+			exit(-1);
+		case 0:
+			close(sv[0]);
+			parallel_child(&(apps[i]), sv[1]);
+			break;
+		default:
+			close(sv[1]);
+			apps[i].fd = sv[0];
+			printf("PARA: testing %s, log in %s.\n",
+				apps[i].app_name, apps[i].log_name);
+		}
+	}
+
+	while (parallel_reap()) {
+		if (tlm_receive_timeout(PARALLEL_POLL_PERIOD)) continue;
+		if (-1 == (to = parallel_route())) {
+			for (i = 0; i < NUM_APPS; i++)
+				parallel_forward(&(apps[i]));
+		} else {
+			parallel_forward(&(apps[to]));
+		}
+	}
+
+	for (i = 0; i < NUM_APPS; i++) {
+		if (!WIFEXITED(apps[i].status) ||
+			WEXITSTATUS(apps[i].status)) {
+			result = -1;
+		}
+		printf("PARA: %s %s; %u messages forwarded, %u dropped.\n",
+			apps[i].app_name, (WIFEXITED(apps[i].status) &&
+			!WEXITSTATUS(apps[i].status)) ? "passed" : "FAILED",
+			apps[i].forwarded, apps[i].dropped);
+	}
+
+	send_perfstop();
+	perf_print_ids(perfids, NUM_APPS);
+	if (perf_summary()) result = -1;
+
+	if (result) {
+		puts("At least one test failed.");
+	} else {
+		puts("All tests passed.");
+	}
+	return result;
+
+} /* parallel() */
@@ -14,39 +14,84 @@
  */
 
 /* This file defines functions for reading the ES performance log data
- * dump file and outputting useful statistics to the console.
+ * dump file and outputting useful statistics to the console.  Besides
+ * the durations in each dump, it keeps every duration it has seen for
+ * each perf ID over the whole test run, so that perf_summary() can
+ * report their distribution at the end of the run.
+ *
+ * The dump file can be as large as the platform's perf buffer, so
+ * rather than copying it into a buffer of that size we map it, read
+ * only the entries its metadata says ES wrote, and find the durations
+ * for every perf ID we want in one pass over them.
+ *
+ * With perf_set_phases(), it also follows every phase vs_ground.h's
+ * perf IDs mark within the apps under test, and perf_summary() breaks
+ * each app's time down into them.  With latency_set(), it follows each
+ * app's outermost phase, too, and hands latency.c the wakeup, entry,
+ * and exit times of each validation function run it finds.
  */
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/inotify.h>
+#include <arpa/inet.h>
+#include <assert.h>
+#include <poll.h>
+#include <time.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <string.h>
 #include <errno.h>
 #include <stdio.h>
+#include <math.h>
 
 #include "cfe.h"
-#include "cfe_fs_extern_typedefs.h"    /* for CFE_FS_Header_t */
+#include "cfe_fs_extern_typedefs.h"    /* for CFE_FS_Header_t, SubType */
 #include "cfe_es_perfdata_typedef.h"   /* for ES perf struct types */
 #include "cfe_platform_cfg.h"          /* for perf buffer size */
 #include "cfe_perfids.h"               /* for CFE_MISSION_ES_PERF_EXIT_BIT */
+#include "cfe_evs_extern_typedefs.h"   /* for CFE_EVS_EventType_* enum */
+#include "cfe_es_eventids.h"           /* for CFE_ES_PERF_DATAWRITTEN_EID */
 
 #include "vs_ground.h"                 /* for perf IDs */
+#include "vs_bench_json.h"             /* for vs_bench_write() */
 
 #include "common_constants.h"
+#include "capture.h"
+#include "tlm.h"
+#include "tbltest.h"
 #include "perf.h"
+#include "latency.h"
 
 
 /* Full relative path to where we expect the ES perf dump file to be. */
 #define FULL_PERF_FILENAME "../cpu1" PERF_FILENAME
 
-/* Time to sleep waiting for ES to finish perf log dumps in seconds */
-#define PERF_FILE_PAUSE 5  /* seconds */
+/* Directory holding the ES perf dump file, for watching with inotify. */
+#define PERF_DIRNAME PATH_TO_CF "/cf"
+
+/* Longest we'll wait for ES to finish a perf log dump before giving up */
+#define PERF_DUMP_TIMEOUT 40  /* seconds */
 
-/* Number of times we'll poll the ES perf log dump file before giving up */
-#define MAX_WAITS 8
+/* perf_expect_dump() watches PERF_DIRNAME with this inotify instance
+ * so that perf_wait_dump() can see ES close the dump file.  -1 when
+ * there is no watch.
+ */
+static int inotify_fd = -1;
+
+/* The perf dump file begins with these headers, then the entries. */
+#define PERF_HEADERS_SIZE \
+	(sizeof(CFE_FS_Header_t) + sizeof(CFE_ES_PerfMetaData_t))
 
-/* We'll read the performance data entries into this buffer. */
-static CFE_ES_PerfDataEntry_t entries[CFE_PLATFORM_ES_PERF_DATA_BUFFER_SIZE];
+/* perf_map_data() maps the ES perf dump file here. */
+static struct {
+	void  *p_map;                            /* whole file, or NULL */
+	size_t size;                             /* of p_map */
+	const CFE_ES_PerfMetaData_t  *p_meta;    /* within p_map */
+	const CFE_ES_PerfDataEntry_t *entries;   /* within p_map */
+	uint32 count;                            /* entries to use */
+} dump;
 
 /* ES ORs the following bits with the Perf ID its stores in the .Data
  * field of each perf log entry to distinguish log entries describing
@@ -55,162 +100,1154 @@ static CFE_ES_PerfDataEntry_t entries[CFE_PLATFORM_ES_PERF_DATA_BUFFER_SIZE];
 #define ENTRY_MASK 0x00
 #define EXIT_MASK (0x01 << CFE_MISSION_ES_PERF_EXIT_BIT)
 
+/* The durations we've seen for each perf ID over the whole test run.
+ * Each series' durations[] grows as needed.  Its nested total counts
+ * only the durations that began within a phase the perf ID's phase
+ * happens within, or all of them for an app's outermost phase.
+ */
+#define MAX_SERIES           PERF_MAX_IDS  /* perf IDs per run */
+#define MIN_SERIES_DURATIONS 256    /* initial size of durations[] */
+
+typedef struct {
+	uint32 perfid;
+	uint32 count;        /* durations in use in durations[] */
+	uint32 size;         /* durations allocated in durations[] */
+	uint64 *durations;
+	uint32 nested_count; /* durations in nested */
+	uint64 nested;       /* sum of the durations within a parent */
+} perf_series_t;
+
+/* The phases of app processing vs_ground.h's perf IDs mark, each with
+ * the perf ID of the phase it happens within, or 0 for an app's
+ * outermost phase, and the name perf_write_json() gives its results.
+ * perf_summary() prints each phase's children in this order.
+ */
+typedef struct {
+	uint32 perfid;
+	uint32 parent;
+	const char *name;
+	const char *key;
+} perf_phase_t;
+
+static const perf_phase_t phases[] = {
+	{ VSA_ALL_PERF_ID,      0,                  "VSA app",     "vsa.all" },
+	{ VSA_VF_PERF_ID,       VSA_ALL_PERF_ID,    "validation",  "vsa" },
+	{ VSA_HK_PERF_ID,       VSA_ALL_PERF_ID,    "HK transmit", "vsa.hk" },
+	{ VSB_ALL_PERF_ID,      0,                  "VSB app",     "vsb.all" },
+	{ VSB_VF_PERF_ID,       VSB_ALL_PERF_ID,    "validation",  "vsb" },
+	{ VSB_HK_PERF_ID,       VSB_ALL_PERF_ID,    "HK transmit", "vsb.hk" },
+	{ VSC_ALL_PERF_ID,      0,                  "VSC app",     "vsc.all" },
+	{ VSC_VF_PERF_ID,       VSC_ALL_PERF_ID,    "validation",  "vsc" },
+	{ VSC_VM_INIT_PERF_ID,  VSC_VF_PERF_ID,     "VM init",     "vsc.init" },
+	{ VSC_VM_RUN_PERF_ID,   VSC_VF_PERF_ID,     "execution",   "vsc.run" },
+	{ VSC_VM_FLUSH_PERF_ID, VSC_VM_RUN_PERF_ID, "event send",  "vsc.send" },
+	{ VSC_HK_PERF_ID,       VSC_ALL_PERF_ID,    "HK transmit", "vsc.hk" },
+};
+
+#define NUM_PHASES ((int)(sizeof(phases) / sizeof(phases[0])))
+
+/* When true, perf_family() adds each app's phases to the perf IDs
+ * we follow, and perf_summary() prints their breakdown.
+ */
+static bool phases_on;
+
+static perf_series_t series[MAX_SERIES];
+static int           num_series;     /* entries in use in series[] */
+
+/* When false, perf_print() and the send_perf*() functions do nothing.
+ * Tests running in parallel turn perf off because ES has only one
+ * perf log for all of them.
+ */
+static bool enabled = true;
+
+/* If not NULL, perf_summary() writes its statistics to this file. */
+static const char *csv_filename;
+
+/* If not NULL, perf_summary() writes its statistics to this file for
+ * vs_bench_compare, too.
+ */
+static const char *json_filename;
+
 
 /* --------------------- module local functions ---------------------- */
 
-/* perf_read_data()
+/* perf_dump_closed()
+ *
+ * in:     inotify_fd - inotify instance perf_expect_dump() set up
+ * out:    inotify_fd - pending events consumed
+ * return: true if ES has closed the perf dump file after writing it.
+ */
+
+static bool
+perf_dump_closed(void) {
+
+	/* inotify events are variable-length; align the buffer for them. */
+	char buffer[4096]
+		__attribute__ ((aligned(__alignof__(struct inotify_event))));
+	const struct inotify_event *p_event;
+	const char *basename = strrchr(PERF_FILENAME, '/') + 1;
+	bool closed = false;
+	ssize_t len;     /* bytes of events read() returned */
+	char *p;         /* walks through events in buffer */
+
+	while (0 < (len = read(inotify_fd, buffer, sizeof(buffer)))) {
+		for (p = buffer; p < (buffer + len);
+			p += sizeof(*p_event) + p_event->len) {
+			p_event = (const struct inotify_event *)p;
+			if ((p_event->mask & IN_CLOSE_WRITE) &&
+				p_event->len &&
+				!strcmp(p_event->name, basename)) {
+				closed = true;
+			}
+		}
+	}
+	return closed;
+
+} /* perf_dump_closed() */
+
+
+/* perf_dump_event()
  *
  * in:     nothing
- * out:    entries - buffer zeroed/filled
- * return: nothing
+ * out:    nothing
+ * return: true if the latest telemetry message is the ES event that
+ *         announces it has finished writing the perf dump file.
+ */
+
+static bool
+perf_dump_event(void) {
+
+	return (tlm_is_evs() &&
+		!strcmp(tlm_evs_appname(), TLM_NAME_ES) &&
+		(tlm_evs_eventid() == CFE_ES_PERF_DATAWRITTEN_EID));
+
+} /* perf_dump_event() */
+
+
+/* perf_replay_wait()
  *
- * Reads the ES perf log data entries from the ES perf log file.
+ * in:     nothing
+ * out:    nothing
+ * return: nothing
  *
- * The perf data file format is as follows:
- * First, a CFE file header structure of type CFE_FS_Header_t.
- * Second, an ES perf metatdata structure of type CFE_ES_PerfMetatData_t.
- * Then, CFE_PLATFORM_ES_PERF_DATA_BUFFER_SIZE CFE_ES_PerfDataEntry_t structs.
+ * perf_wait_dump() when replaying a capture.  The run stopped waiting
+ * when it read the perf log file, so replay the telemetry that had
+ * arrived by then, stopping early at the ES event as the run would.
  */
 
 static void
-perf_read_data(void) {
+perf_replay_wait(void) {
 
-	int fd;   /* file descriptor for ES perf data dump file */
+	uint64 read_at, now;          /* when the run read the file */
 
-	/* Its not clear how many entries we'll find in the log file,
-	 * so clear the entire buffer to zeroes so that unused entries
-	 * are easy to distinguish in our buffer.
-	 */
-	memset(entries, 0x00, sizeof(entries));
-
-	/* To avoid overloading the spacecraft's CPU, ES will use a
-	 * background task to dribble its performance log entry data
-	 * out to a file in chunks over time.  Our test suite needs to
-	 * wait for this background task to create the performance
-	 * data dump file and write all of ES's data to it before
-	 * attempting to read data from it.
-	 *
-	 * HACK: this sleep is simple but wasteful and is begging for
-	 * a race condition.
-	 */
-	sleep(PERF_FILE_PAUSE);
-	
-	/* Using do/while/break as poor man's try/catch */
-	do {
-	
-		if (-1 == (fd = open(FULL_PERF_FILENAME, O_RDONLY)))
-			break;
+	if (!capture_peek(CAPTURE_PERF, &read_at)) return;
 
-		/* Skip the headers; we just want the log entries. */
-		if (-1 == lseek(fd, (sizeof(CFE_FS_Header_t) +
-			sizeof(CFE_ES_PerfMetaData_t)), SEEK_SET))
-			break;
-	
-		/* Read all the log entries. */
-		if (-1 == read(fd, entries, sizeof(entries)))
+	while ((now = capture_now()) < read_at) {
+		if (tlm_receive_timeout((int)((read_at - now + 999) / 1000)))
 			break;
+		if (perf_dump_event()) break;
+	}
+	printf("PERF: ES finished writing performance log (replayed).\n");
 
-		if (-1 == close(fd))
-			break;
+} /* perf_replay_wait() */
 
-		/* If we reach here, we've successfully read the log
-		 * entries.
-		 */
+
+/* perf_wait_dump()
+ *
+ * in:     inotify_fd - inotify instance perf_expect_dump() set up, or -1
+ * out:    inotify_fd - closed and set to -1
+ * return: nothing
+ *
+ * To avoid overloading the spacecraft's CPU, ES uses a background
+ * task to dribble its performance log entry data out to a file in
+ * chunks over time.  Our test suite needs to wait for this task to
+ * finish writing before it reads the file.  When the task finishes,
+ * it sends a CFE_ES_PERF_DATAWRITTEN_EID event and closes the file.
+ * ES sends that event as a DEBUG event, which EVS filters by
+ * default, so we also watch for the close with inotify, and whichever
+ * we see first ends the wait.  Receiving telemetry here is harmless:
+ * the tests send this command only after they've seen every response
+ * they want.
+ */
+
+static void
+perf_wait_dump(void) {
+
+	struct pollfd fds[2];         /* telemetry socket and inotify */
+	struct timespec now, end;     /* CLOCK_MONOTONIC */
+	const char *how = NULL;       /* what told us the dump is done */
+	int timeout;                  /* msecs left until end */
+
+	if (capture_replaying()) {
+		perf_replay_wait();
 		return;
+	}
 
-	} while (0);
+	fds[0].fd     = tlm_socket();
+	fds[0].events = POLLIN;
+	fds[1].fd     = inotify_fd;   /* poll() ignores negative fds */
+	fds[1].events = POLLIN;
 
-	/* If we reach here, something went wrong. */
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	end.tv_sec += PERF_DUMP_TIMEOUT;
 
-	perror("Failed to read ES performance log file.");
-	exit(-1);
-	
-} /* perf_read_data() */
+	while (how == NULL) {
 
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		timeout = (int)((end.tv_sec - now.tv_sec) * 1000 +
+			(end.tv_nsec - now.tv_nsec) / 1000000);
+		if (timeout <= 0) break;
 
-/* perf_dump_data()
+		/* Don't wait on the socket for telemetry that's
+		 * already waiting in tlm's ring.
+		 */
+		if (tlm_buffered()) timeout = 0;
+		if (-1 == poll(fds, 2, timeout)) {
+			if (errno == EINTR) continue;
+			perror("Failed to wait for ES performance log file.");
+			exit(-1);
+		}
+		if (fds[1].revents & POLLIN) {
+			if (perf_dump_closed()) how = "file closed";
+		}
+		while ((how == NULL) && !tlm_receive_timeout(0)) {
+			if (perf_dump_event()) how = "ES event";
+		}
+	}
+
+	if (inotify_fd != -1) {
+		close(inotify_fd);
+		inotify_fd = -1;
+	}
+
+	if (how) {
+		printf("PERF: ES finished writing performance log (%s).\n",
+			how);
+	} else {
+		printf("PERF: gave up waiting for ES after %d seconds; "
+			"reading log as is.\n", PERF_DUMP_TIMEOUT);
+	}
+
+} /* perf_wait_dump() */
+
+
+/* perf_map_file()
+ *
+ * in:     nothing
+ * out:    dump - p_map and size set to map the ES perf log file
+ * return: nothing
+ *
+ * When capturing, writes the file to the capture file, too.
+ */
+
+static void
+perf_map_file(void) {
+
+	struct stat st;
+	int fd;              /* file descriptor for ES perf data dump file */
+
+	if ((-1 == (fd = open(FULL_PERF_FILENAME, O_RDONLY))) ||
+		(-1 == fstat(fd, &st))) {
+		perror("Failed to read ES performance log file.");
+		exit(-1);
+	}
+
+	dump.size = (size_t)st.st_size;
+	dump.p_map = mmap(NULL, dump.size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (dump.p_map == MAP_FAILED) {
+		perror("Failed to map ES performance log file.");
+		exit(-1);
+	}
+	close(fd);   /* the mapping stays valid */
+
+	capture_write(CAPTURE_PERF, capture_now(), dump.p_map, dump.size);
+
+} /* perf_map_file() */
+
+
+/* perf_map_data()
+ *
+ * in:     nothing
+ * out:    dump - maps the ES perf log file
+ * return: nothing
  *
- * in:     app_perfid - perf ID whose entries we want to dump
- *         entries    - perf data read from this buffer
+ * Waits for ES to finish writing the perf log file and maps it.  The
+ * file holds a CFE_FS_Header_t, in big-endian order whatever the
+ * processor, then a CFE_ES_PerfMetaData_t, then the log entries.  ES
+ * keeps its entries in a ring buffer, but it writes them out oldest
+ * first, starting at the ring's DataStart slot and wrapping around,
+ * so the file holds exactly DataCount entries in time order.
+ *
+ * When replaying a capture, the file is the capture's next perf log.
+ */
+
+static void
+perf_map_data(void) {
+
+	const CFE_FS_Header_t *p_header;
+	uint32 available;    /* whole entries in the file */
+
+	/* Wait for ES's background task to finish writing the file. */
+	perf_wait_dump();
+
+	if (!capture_replaying()) {
+		perf_map_file();
+	} else if (NULL == (dump.p_map = (void *)capture_next(CAPTURE_PERF,
+		0, &dump.size))) {
+		fprintf(stderr, "The capture holds no more ES performance "
+			"log files.\n");
+		exit(-1);
+	}
+	if (dump.size < PERF_HEADERS_SIZE) {
+		fprintf(stderr, "ES performance log file is too short.\n");
+		exit(-1);
+	}
+
+	p_header = (const CFE_FS_Header_t *)dump.p_map;
+	if ((ntohl(p_header->ContentType) != CFE_FS_FILE_CONTENT_ID) ||
+		(ntohl(p_header->SubType) != CFE_FS_SubType_ES_PERFDATA)) {
+		fprintf(stderr, "%s is not an ES performance log file.\n",
+			FULL_PERF_FILENAME);
+		exit(-1);
+	}
+
+	dump.p_meta = (const CFE_ES_PerfMetaData_t *)
+		((const char *)dump.p_map + sizeof(CFE_FS_Header_t));
+	dump.entries = (const CFE_ES_PerfDataEntry_t *)
+		((const char *)dump.p_map + PERF_HEADERS_SIZE);
+
+	available  = (uint32)((dump.size - PERF_HEADERS_SIZE) /
+		sizeof(CFE_ES_PerfDataEntry_t));
+	dump.count = dump.p_meta->DataCount;
+	if (dump.count > available) {
+		printf("PERF: log file holds only %u of %u entries.\n",
+			(unsigned int)available, (unsigned int)dump.count);
+		dump.count = available;
+	}
+
+} /* perf_map_data() */
+
+
+/* perf_unmap_data()
+ *
+ * in:     dump - maps the ES perf log file
+ * out:    dump - cleared, unmapped unless it's in a replayed capture
+ * return: nothing
+ */
+
+static void
+perf_unmap_data(void) {
+
+	if (!capture_replaying()) munmap(dump.p_map, dump.size);
+	memset(&dump, 0, sizeof(dump));
+
+} /* perf_unmap_data() */
+
+
+/* perf_entry_time()
+ *
+ * in:     p_entry - perf log entry
+ *         dump    - metadata of the log p_entry came from
+ * out:    nothing
+ * return: the entry's 64-bit timestamp.
+ *
+ * The lower timer word counts up to the PSP's TimerLow32Rollover
+ * before the upper word increments; the pc-linux PSP, for example,
+ * keeps seconds and nanoseconds.  A rollover of 0 means the lower
+ * word uses all 32 bits.
+ */
+
+static uint64
+perf_entry_time(const CFE_ES_PerfDataEntry_t *p_entry) {
+
+	uint32 rollover = dump.p_meta->TimerLow32Rollover;
+
+	if (rollover == 0) {
+		return ((uint64)p_entry->TimerUpper32 << 32) |
+			(uint64)p_entry->TimerLower32;
+	}
+	return (uint64)p_entry->TimerUpper32 * rollover +
+		(uint64)p_entry->TimerLower32;
+
+} /* perf_entry_time() */
+
+
+/* perf_compare()
+ *
+ * qsort() comparison function for uint64 durations.
+ */
+
+static int
+perf_compare(const void *p_a, const void *p_b) {
+
+	uint64 a = *(const uint64 *)p_a;
+	uint64 b = *(const uint64 *)p_b;
+
+	return ((a > b) - (a < b));
+
+} /* perf_compare() */
+
+
+/* perf_percentile()
+ *
+ * in:     sorted  - durations in ascending order
+ *         count   - number of durations in sorted, at least 1
+ *         percent - percentile to find, 1 to 100
+ * out:    nothing
+ * return: the nearest-rank percent'th percentile of sorted.
+ */
+
+static uint64
+perf_percentile(const uint64 *sorted, uint32 count, uint32 percent) {
+
+	uint32 rank = (uint32)(((uint64)count * percent + 99) / 100);
+
+	return sorted[(rank ? rank : 1) - 1];
+
+} /* perf_percentile() */
+
+
+/* perf_print_stats()
+ *
+ * in:     label   - what the statistics describe
+ *         p_stats - statistics to print
  * out:    nothing
  * return: nothing
+ */
+
+static void
+perf_print_stats(const char *label, const perf_stats_t *p_stats) {
+
+	printf("PERF: %s: count %u min %llu median %llu p90 %llu p99 %llu "
+		"max %llu mean %.1f stddev %.1f\n", label,
+		(unsigned int)p_stats->count,
+		(unsigned long long)p_stats->min,
+		(unsigned long long)p_stats->median,
+		(unsigned long long)p_stats->p90,
+		(unsigned long long)p_stats->p99,
+		(unsigned long long)p_stats->max,
+		p_stats->mean, p_stats->stddev);
+
+} /* perf_print_stats() */
+
+
+/* perf_find_series()
  *
- * Scans through the entries array of perf log entries looking for a
- * start entry for app_perfid.  If found, it scans until it finds the
- * corresponding stop entry, computes the duration between start and
- * stop, and outputs it to the console.  The duration, like the start
- * and stop times, is in simulated spacecraft clock ticks.
+ * in:     app_perfid - perf ID whose series we want
+ * out:    series     - may gain a new, empty entry for app_perfid
+ * return: app_perfid's series.
+ */
+
+static perf_series_t *
+perf_find_series(uint32 app_perfid) {
+
+	int i;
+
+	for (i = 0; i < num_series; i++) {
+		if (series[i].perfid == app_perfid) return &(series[i]);
+	}
+
+	/* If we ever test more apps at once, increase MAX_SERIES. */
+	assert(num_series < MAX_SERIES);
+
+	series[num_series].perfid = app_perfid;
+	return &(series[num_series++]);
+
+} /* perf_find_series() */
+
+
+/* perf_series_add()
+ *
+ * in:     p_series - series to add to
+ *         duration - duration to add
+ * out:    p_series - durations[] holds duration, grown if need be
+ * return: nothing
  */
 
 static void
-perf_dump_data(uint32 app_perfid) {
+perf_series_add(perf_series_t *p_series, uint64 duration) {
 
-	uint64 time_start; /* timestamp of CFE_ES_PerfLogEntry() log entry */
-	uint64 time_stop;  /* timestamp of CFE_ES_PerfLogExit() log entry */
-	int i;             /* index into entries array */
+	uint64 *grown;
 
-	/* Process all the perf log entries in the buffer. */
-	for (i = 0; i < CFE_PLATFORM_ES_PERF_DATA_BUFFER_SIZE; i++) {
+	if (p_series->count == p_series->size) {
+		p_series->size = (p_series->size ?
+			(p_series->size * 2) : MIN_SERIES_DURATIONS);
+		if (NULL == (grown = realloc(p_series->durations,
+			p_series->size * sizeof(grown[0])))) {
+			perror("Failed to store perf durations.");
+			exit(-1);
+		}
+		p_series->durations = grown;
+	}
+	p_series->durations[p_series->count++] = duration;
 
-		/* Advance until we find a CFE_ES_PerfLogEntry() entry
-		 * for our desired perf ID.  If we reach the end of
-		 * the buffer without finding what we want, we're
-		 * done.
-		 */
-		for(; entries[ i ].Data != (app_perfid | ENTRY_MASK);
-			i++) {
-			if (i >= CFE_PLATFORM_ES_PERF_DATA_BUFFER_SIZE) return;
+} /* perf_series_add() */
+
+
+/* perf_find_phase()
+ *
+ * in:     perfid - perf ID whose phase we want
+ * out:    nothing
+ * return: perfid's entry in phases[], or NULL if it has none.
+ */
+
+static const perf_phase_t *
+perf_find_phase(uint32 perfid) {
+
+	int i;
+
+	for (i = 0; i < NUM_PHASES; i++) {
+		if (phases[i].perfid == perfid) return &(phases[i]);
+	}
+	return NULL;
+
+} /* perf_find_phase() */
+
+
+/* perf_root()
+ *
+ * in:     perfid - perf ID whose app we want
+ * out:    nothing
+ * return: the perf ID of the outermost phase perfid's phase happens
+ *         within, or perfid itself if it has no phase.
+ */
+
+static uint32
+perf_root(uint32 perfid) {
+
+	const perf_phase_t *p_phase;
+
+	while ((NULL != (p_phase = perf_find_phase(perfid))) &&
+		p_phase->parent) {
+		perfid = p_phase->parent;
+	}
+	return perfid;
+
+} /* perf_root() */
+
+
+/* perf_lookup_series()
+ *
+ * in:     perfid - perf ID whose series we want
+ * out:    nothing
+ * return: perfid's series, or NULL if it has none.
+ */
+
+static perf_series_t *
+perf_lookup_series(uint32 perfid) {
+
+	int i;
+
+	for (i = 0; i < num_series; i++) {
+		if (series[i].perfid == perfid) return &(series[i]);
+	}
+	return NULL;
+
+} /* perf_lookup_series() */
+
+
+/* perf_shown_parent()
+ *
+ * in:     perfid - perf ID of a phase
+ * out:    nothing
+ * return: the series of the innermost phase perfid's phase happens
+ *         within that has any nested durations, or NULL if none do.
+ *
+ * Native VSC code runs no Grunt instructions for the VM to mark, for
+ * example, so its event sends show up directly within validation.
+ */
+
+static const perf_series_t *
+perf_shown_parent(uint32 perfid) {
+
+	const perf_phase_t *p_phase = perf_find_phase(perfid);
+	const perf_series_t *p_series;
+
+	while (p_phase && p_phase->parent) {
+		p_series = perf_lookup_series(p_phase->parent);
+		if (p_series && p_series->nested_count) return p_series;
+		p_phase = perf_find_phase(p_phase->parent);
+	}
+	return NULL;
+
+} /* perf_shown_parent() */
+
+
+/* perf_print_phase()
+ *
+ * in:     p_series - series of the phase to print
+ *         depth    - number of phases it's nested within
+ *         whole    - nested total of its app's outermost phase
+ * out:    nothing
+ * return: nothing
+ *
+ * Prints the phase's nested durations' count, total, mean, and share
+ * of whole, then, more deeply indented, those of each phase shown
+ * within it and of the time it spent outside them.
+ */
+
+static void
+perf_print_phase(const perf_series_t *p_series, int depth, uint64 whole) {
+
+	const perf_series_t *p_child;
+	uint64 children = 0;     /* sum of the nested totals within */
+	uint64 other;            /* time outside of them */
+	bool   any = false;      /* any phases shown within? */
+	int i;
+
+	printf("PERF: %*s%-*s count %u total %llu mean %.1f %5.1f%%\n",
+		2 * depth, "", 24 - 2 * depth,
+		perf_find_phase(p_series->perfid)->name,
+		(unsigned int)p_series->nested_count,
+		(unsigned long long)p_series->nested,
+		(double)p_series->nested / p_series->nested_count,
+		100.0 * p_series->nested / whole);
+
+	for (i = 0; i < NUM_PHASES; i++) {
+		p_child = perf_lookup_series(phases[i].perfid);
+		if ((p_child == NULL) || (p_child->nested_count == 0) ||
+			(perf_shown_parent(phases[i].perfid) != p_series))
+			continue;
+		perf_print_phase(p_child, depth + 1, whole);
+		children += p_child->nested;
+		any = true;
+	}
+
+	/* A child whose time ES logged as a little more than its
+	 * parent's leaves nothing for other.
+	 */
+	if (any) {
+		other = ((p_series->nested > children) ?
+			(p_series->nested - children) : 0);
+		printf("PERF: %*s%-*s total %llu %5.1f%%\n",
+			2 * (depth + 1), "", 24 - 2 * (depth + 1), "other",
+			(unsigned long long)other, 100.0 * other / whole);
+	}
+
+} /* perf_print_phase() */
+
+
+/* perf_print_breakdown()
+ *
+ * in:     series - the run's durations
+ * out:    nothing
+ * return: nothing
+ *
+ * Prints the nested breakdown of each app's outermost phase.
+ */
+
+static void
+perf_print_breakdown(void) {
+
+	const perf_phase_t *p_phase;
+	int i;
+
+	for (i = 0; i < num_series; i++) {
+		p_phase = perf_find_phase(series[i].perfid);
+		if ((p_phase == NULL) || (series[i].nested_count == 0) ||
+			perf_shown_parent(series[i].perfid))
+			continue;
+		printf("PERF: Breakdown of %s run, in ticks:\n",
+			p_phase->name);
+		perf_print_phase(&(series[i]), 1, series[i].nested);
+	}
+
+} /* perf_print_breakdown() */
+
+
+/* perf_dump_data()
+ *
+ * in:     perfids     - perf IDs whose entries we want to dump
+ *         num_perfids - number of perf IDs in perfids, 1 to MAX_SERIES
+ *         num_printed - number of perf IDs at the start of perfids
+ *                       whose durations to print
+ *         dump        - perf log entries from perf_map_data()
+ * out:    p_series    - series for each perf ID, in perfids order,
+ *                       with this dump's durations added
+ * return: nothing
+ *
+ * Scans once through the perf log entries.  Pairs each start entry
+ * for one of the perf IDs with the next stop entry for that perf ID,
+ * computes the duration between start and stop, records it, and
+ * outputs it to the console.  The duration, like the start and stop
+ * times, is in simulated spacecraft clock ticks.  A stop entry whose
+ * start entry ES overwrote before the dump is ignored.  A duration
+ * that began while a phase its perf ID's phase happens within was
+ * open counts toward its series' nested total, too.  With latency
+ * tracing, each duration of the first perf ID goes to latency_run(),
+ * with the time its app's outermost phase last began.
+ */
+
+static void
+perf_dump_data(const uint32 *perfids, int num_perfids, int num_printed,
+	perf_series_t **p_series) {
+
+	uint64 time_start[MAX_SERIES]; /* of each open CFE_ES_PerfLogEntry() */
+	bool   open[MAX_SERIES];       /* awaiting a CFE_ES_PerfLogExit()? */
+	bool   within[MAX_SERIES];     /* did the open one begin nested? */
+	int    parent[MAX_SERIES];     /* perfids index of phase's parent */
+	int    root = -1;              /* perfids index of perfids[0]'s app */
+	const perf_phase_t *p_phase;
+	uint64 duration;
+	uint32 data;                   /* .Data field of an entry */
+	uint32 i;                      /* index into dump.entries */
+	int    j, k;                   /* indices into perfids */
+
+	memset(open, 0, sizeof(open));
+
+	/* Find each phase's parent among perfids.  An app's outermost
+	 * phase, or a perf ID with no phase, is always nested.
+	 */
+	for (j = 0; j < num_perfids; j++) {
+		parent[j] = -1;
+		p_phase = perf_find_phase(perfids[j]);
+		for (k = 0; p_phase && p_phase->parent &&
+			(k < num_perfids); k++) {
+			if (perfids[k] == p_phase->parent) parent[j] = k;
 		}
-		
-		/* We've found a CFE_ES_PerfLogEntry() entry.
-		 * Remember its timestamp.
-		 */
-		time_start = entries[ i ].TimerUpper32 * UINT32_MAX +
-			entries[ i ].TimerLower32;
+		if ((j > 0) && (perfids[j] == perf_root(perfids[0]))) root = j;
+	}
+
+	/* Process all the perf log entries ES wrote. */
+	for (i = 0; i < dump.count; i++) {
 
-		/* Advance until we find a CFE_ES_PerfLogExit() entry
-		 * for our desired perf ID.  If we reach the end of
-		 * the buffer without finding what we want, we're
-		 * done.
+		data = dump.entries[ i ].Data;
+		for (j = 0; j < num_perfids; j++) {
+			if ((data & ~EXIT_MASK) == perfids[j]) break;
+		}
+		if (j == num_perfids) continue;   /* not one of ours */
+
+		/* Remember the timestamp of a CFE_ES_PerfLogEntry()
+		 * entry until we see the matching exit.
 		 */
-		for(; entries[ i ].Data != (app_perfid | EXIT_MASK); i++) {
-			if (i >= CFE_PLATFORM_ES_PERF_DATA_BUFFER_SIZE) return;
+		if (data == (perfids[j] | ENTRY_MASK)) {
+			if (!open[j]) {
+				time_start[j] =
+					perf_entry_time(&(dump.entries[ i ]));
+				open[j] = true;
+				p_phase = perf_find_phase(perfids[j]);
+				within[j] = !(p_phase && p_phase->parent);
+				for (k = parent[j]; (k >= 0) && !within[j];
+					k = parent[k]) {
+					within[j] = open[k];
+				}
+			}
+			continue;
 		}
 
-		/* We've found a CFE_ES_PerfLogExit() entry. Compute
-		 * its timestamp and print it to the console.
+		/* We've found a CFE_ES_PerfLogExit() entry.  If it
+		 * closes a start, compute the duration and print it to
+		 * the console.
 		 */
-		time_stop = entries[ i ].TimerUpper32 * UINT32_MAX +
-			entries[ i ].TimerLower32;
+		if (!open[j]) continue;
+		open[j]  = false;
+		duration = perf_entry_time(&(dump.entries[ i ])) -
+			time_start[j];
+
+		if (within[j]) {
+			p_series[j]->nested += duration;
+			p_series[j]->nested_count++;
+		}
+		perf_series_add(p_series[j], duration);
+		if (j == 0) {
+			latency_run(((root >= 0) && open[root]) ?
+				time_start[root] : time_start[0],
+				time_start[0], time_start[0] + duration);
+		}
+		if (j >= num_printed) continue;
 
-		printf("PERF: Verification function execution duration "
-		       "in ticks: %lu\n", time_stop - time_start);
+		printf("PERF: ");
+		if (num_printed > 1) {
+			printf("Perf ID 0x%08X: ", (unsigned int)perfids[j]);
+		}
+		printf("Verification function execution duration "
+		       "in ticks: %llu\n", (unsigned long long)duration);
 
 	} /* for all entries */
-	
+
 } /* perf_dump_data() */
 
 
+/* perf_write_json()
+ *
+ * in:     stats - statistics of each series
+ * out:    json_filename - written
+ * return: 0 on success, -1 if it couldn't write the file.
+ *
+ * Names each series' result for the phase whose perf ID it holds,
+ * naming validation function results for their app alone, so that
+ * vs_bench_compare compares VSC's to VSA's.  Latency results follow.
+ */
+
+static int
+perf_write_json(const perf_stats_t *stats) {
+
+	vs_bench_result_t results[MAX_SERIES + LATENCY_NUM_RESULTS];
+	const perf_phase_t *p_phase;
+	int i;
+
+	memset(results, 0, sizeof(results));
+	for (i = 0; i < num_series; i++) {
+		if (NULL != (p_phase = perf_find_phase(series[i].perfid))) {
+			snprintf(results[i].name, sizeof(results[i].name),
+				"tbltest.%s", p_phase->key);
+		} else {
+			snprintf(results[i].name, sizeof(results[i].name),
+				"tbltest.0x%08X",
+				(unsigned int)series[i].perfid);
+		}
+		snprintf(results[i].unit, sizeof(results[i].unit), "ticks");
+		results[i].count = stats[i].count;
+		results[i].p50   = (double)stats[i].median;
+		results[i].p99   = (double)stats[i].p99;
+		results[i].mean  = stats[i].mean;
+	}
+	return vs_bench_write(json_filename, results, num_series +
+		latency_results(&(results[num_series])));
+
+} /* perf_write_json() */
+
+
 /* ------------------- module exported functions -------------------- */
 
+/* perf_compute_stats()
+ *
+ * in:     data    - durations to describe
+ *         count   - number of durations in data
+ * out:    data    - sorted in ascending order
+ *         p_stats - the distribution of data; all zero if count is 0
+ * return: nothing
+ *
+ * Percentiles are nearest-rank; the standard deviation is the
+ * population standard deviation.
+ */
+
+void
+perf_compute_stats(uint64 *data, uint32 count, perf_stats_t *p_stats) {
+
+	double sum = 0.0;       /* of durations */
+	double squares = 0.0;   /* sum of squared deviations from mean */
+	uint32 i;
+
+	memset(p_stats, 0, sizeof(*p_stats));
+	if (count == 0) return;
+
+	qsort(data, count, sizeof(data[0]), perf_compare);
+	for (i = 0; i < count; i++) sum += (double)data[i];
+
+	p_stats->count  = count;
+	p_stats->min    = data[0];
+	p_stats->median = perf_percentile(data, count, 50);
+	p_stats->p90    = perf_percentile(data, count, 90);
+	p_stats->p99    = perf_percentile(data, count, 99);
+	p_stats->max    = data[count - 1];
+	p_stats->mean   = sum / count;
+
+	for (i = 0; i < count; i++) {
+		squares += ((double)data[i] - p_stats->mean) *
+			((double)data[i] - p_stats->mean);
+	}
+	p_stats->stddev = sqrt(squares / count);
+
+} /* perf_compute_stats() */
+
+
+/* perf_family()
+ *
+ * in:     perfids     - perf IDs a test wants measured
+ *         num_perfids - number of perf IDs in perfids, 1 to PERF_MAX_IDS
+ * out:    family      - perfids, followed by the perf IDs of every
+ *                       phase of their apps if perf_set_phases()
+ *                       turned phases on, or of their apps'
+ *                       outermost phases if latency_set() turned
+ *                       latency tracing on
+ * return: the number of perf IDs in family, at most PERF_MAX_IDS.
+ */
+
+int
+perf_family(const uint32 *perfids, int num_perfids, uint32 *family) {
+
+	int num_family = 0;
+	int i, j;
+
+	assert((num_perfids > 0) && (num_perfids <= PERF_MAX_IDS));
+	for (j = 0; j < num_perfids; j++) family[num_family++] = perfids[j];
+	if (!phases_on && !latency_enabled()) return num_family;
+
+	for (i = 0; i < NUM_PHASES; i++) {
+		if (!phases_on && phases[i].parent) continue;
+		for (j = 0; j < num_family; j++) {
+			if (family[j] == phases[i].perfid) break;
+		}
+		if (j < num_family) continue;   /* already have it */
+
+		for (j = 0; j < num_perfids; j++) {
+			if (perf_root(perfids[j]) ==
+				perf_root(phases[i].perfid))
+				break;
+		}
+		if (j == num_perfids) continue;   /* not an app under test */
+
+		/* If we ever test more phases at once, increase
+		 * PERF_MAX_IDS.
+		 */
+		assert(num_family < PERF_MAX_IDS);
+		family[num_family++] = phases[i].perfid;
+	}
+	return num_family;
+
+} /* perf_family() */
+
+
+/* perf_print_ids()
+ *
+ * in:     perfids     - PERF IDs whose data we want to print
+ *         num_perfids - number of PERF IDs in perfids, 1 to MAX_SERIES
+ * out:    nothing
+ * return: nothing
+ *
+ * Waits for the simulated spacecraft to dump all of the performance
+ * start and stop entries it has collected.  Picks out the start and
+ * stop entries corresponding to each of the PERF IDs in perfids.
+ * Prints the difference between those starts and stops to the console
+ * in terms of spacecraft clock ticks, followed by their statistics
+ * for each PERF ID with more than one, and adds them to each PERF
+ * ID's series for perf_summary().  With phases on, it quietly adds
+ * the durations of the rest of perf_family()'s perf IDs to their
+ * series, too.
+ *
+ */
+
+void
+perf_print_ids(const uint32 *perfids, int num_perfids) {
+
+	perf_series_t *p_series[MAX_SERIES]; /* each perf ID's durations */
+	uint32 family[MAX_SERIES];           /* perfids, then phases */
+	uint32 first[MAX_SERIES];            /* this dump's first in each */
+	perf_stats_t stats;                  /* of this dump's durations */
+	char label[32];                      /* "Perf ID 0x... dump" */
+	int num_family;
+	int j;
+
+	if (!enabled) return;
+
+	num_family = perf_family(perfids, num_perfids, family);
+	for (j = 0; j < num_family; j++) {
+		p_series[j] = perf_find_series(family[j]);
+		first[j]    = p_series[j]->count;
+	}
+
+	perf_map_data();
+	perf_dump_data(family, num_family, num_perfids, p_series);
+	latency_window(dump.p_meta->TimerTicksPerSecond);
+	perf_unmap_data();
+
+	for (j = 0; j < num_perfids; j++) {
+		if ((p_series[j]->count - first[j]) <= 1) continue;
+
+		/* Sorting this dump's durations in place is fine;
+		 * perf_summary() sorts the whole series anyway.
+		 */
+		perf_compute_stats(&(p_series[j]->durations[first[j]]),
+			p_series[j]->count - first[j], &stats);
+		if (num_perfids > 1) {
+			snprintf(label, sizeof(label), "Perf ID 0x%08X dump",
+				(unsigned int)perfids[j]);
+		} else {
+			snprintf(label, sizeof(label), "This dump");
+		}
+		perf_print_stats(label, &stats);
+	}
+
+} /* perf_print_ids() */
+
+
 /* perf_print()
  *
  * in:     app_perfid - PERF ID whose data we want to print
  * out:    nothing
  * return: nothing
  *
- * Tells the simulated spacecraft to dump all of the performance start
- * and stop entries it has collected.  Picks out the start and stop
- * entries corresponding to the PERF ID app_perfid.  Prints the
- * difference between those starts and stops to the console in terms
- * of spacecraft clock ticks.
- *
+ * perf_print_ids() for a single PERF ID.
  */
 
 void
 perf_print(uint32 app_perfid) {
 
-	perf_read_data();
-	perf_dump_data(app_perfid);
+	perf_print_ids(&app_perfid, 1);
 
 } /* perf_print() */
+
+
+/* perf_expect_dump()
+ *
+ * in:     nothing
+ * out:    inotify_fd - watching PERF_DIRNAME, or -1 if we can't
+ * return: nothing
+ *
+ * Call just before commanding ES to stop collecting perf data and
+ * dump it, so that perf_print() can't miss ES closing the dump file
+ * however quickly ES gets to it.  Without the watch, perf_print()
+ * waits for the ES event alone.
+ */
+
+void
+perf_expect_dump(void) {
+
+	if (inotify_fd != -1) close(inotify_fd);
+	inotify_fd = -1;
+	if (capture_replaying()) return;   /* no file to watch */
+
+	if (-1 == (inotify_fd = inotify_init1(IN_NONBLOCK))) return;
+	if (-1 == inotify_add_watch(inotify_fd, PERF_DIRNAME,
+		IN_CLOSE_WRITE)) {
+		close(inotify_fd);
+		inotify_fd = -1;
+	}
+
+} /* perf_expect_dump() */
+
+
+/* perf_disable()
+ *
+ * in:     nothing
+ * out:    enabled - false
+ * return: nothing
+ *
+ * Turns off perf commands and reporting for the rest of the run.
+ */
+
+void
+perf_disable(void) {
+
+	enabled = false;
+
+} /* perf_disable() */
+
+
+/* perf_enabled()
+ *
+ * in:     enabled
+ * out:    nothing
+ * return: true unless perf_disable() turned perf off.
+ */
+
+bool
+perf_enabled(void) {
+
+	return enabled;
+
+} /* perf_enabled() */
+
+
+/* perf_set_phases()
+ *
+ * in:     on        - follow each app's phases?
+ * out:    phases_on - set to on
+ * return: nothing
+ */
+
+void
+perf_set_phases(bool on) {
+
+	phases_on = on;
+
+} /* perf_set_phases() */
+
+
+/* perf_set_csv()
+ *
+ * in:     filename - file for perf_summary() to write CSV to, or NULL
+ * out:    nothing
+ * return: nothing
+ */
+
+void
+perf_set_csv(const char *filename) {
+
+	csv_filename = filename;
+
+} /* perf_set_csv() */
+
+
+/* perf_set_json()
+ *
+ * in:     filename - file for perf_summary() to write JSON to, or NULL
+ * out:    nothing
+ * return: nothing
+ */
+
+void
+perf_set_json(const char *filename) {
+
+	json_filename = filename;
+
+} /* perf_set_json() */
+
+
+/* perf_summary()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: 0 on success, -1 if it couldn't write the CSV or JSON file.
+ *
+ * Prints the distribution of the durations perf_print() has seen for
+ * each perf ID over the whole test run: their count, minimum, median,
+ * 90th and 99th percentiles, maximum, mean, and standard deviation,
+ * all in simulated spacecraft clock ticks.  If perf_set_csv() named a
+ * file, also writes the same statistics there as CSV, one row per
+ * perf ID, so that runs against different builds can be compared.
+ * If perf_set_json() named a file, also writes the medians, 99th
+ * percentiles, and means there for vs_bench_compare.  With phases
+ * on, it then prints each app's breakdown: how many times each
+ * phase ran within the phase it happens within, how long those runs
+ * took in all and on average, their share of the app's whole time,
+ * and the time each phase spent outside the phases within it.  With
+ * latency tracing, it ends with latency_summary()'s waterfall, and
+ * the JSON file gains a result for each hop.
+ */
+
+int
+perf_summary(void) {
+
+	perf_stats_t stats[MAX_SERIES];   /* for each series */
+	char label[32];                   /* "Perf ID 0x..." */
+	FILE *csv;
+	int i;
+
+	for (i = 0; i < num_series; i++) {
+		perf_compute_stats(series[i].durations, series[i].count,
+			&(stats[i]));
+		snprintf(label, sizeof(label), "Perf ID 0x%08X run",
+			(unsigned int)series[i].perfid);
+		perf_print_stats(label, &(stats[i]));
+	}
+	if (phases_on) perf_print_breakdown();
+	latency_summary();
+
+	if (json_filename && perf_write_json(stats)) return -1;
+	if (csv_filename == NULL) return 0;
+
+	if (NULL == (csv = fopen(csv_filename, "w"))) {
+		perror("Failed to open perf CSV file.");
+		return -1;
+	}
+	fprintf(csv, "perf_id,count,min,median,p90,p99,max,mean,stddev\n");
+	for (i = 0; i < num_series; i++) {
+		fprintf(csv, "0x%08X,%u,%llu,%llu,%llu,%llu,%llu,%.1f,%.1f\n",
+			(unsigned int)series[i].perfid,
+			(unsigned int)stats[i].count,
+			(unsigned long long)stats[i].min,
+			(unsigned long long)stats[i].median,
+			(unsigned long long)stats[i].p90,
+			(unsigned long long)stats[i].p99,
+			(unsigned long long)stats[i].max,
+			stats[i].mean, stats[i].stddev);
+	}
+	if (fclose(csv)) {
+		perror("Failed to write perf CSV file.");
+		return -1;
+	}
+	return 0;
+
+} /* perf_summary() */
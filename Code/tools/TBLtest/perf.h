@@ -16,7 +16,32 @@
  * permissions and limitations under the License.
  */
 
+/* The distribution of a set of durations. */
+typedef struct {
+	uint32 count;
+	uint64 min;
+	uint64 median;
+	uint64 p90;
+	uint64 p99;
+	uint64 max;
+	double mean;
+	double stddev;
+} perf_stats_t;
+
+/* The most perf IDs a run can follow, counting every app's phases. */
+#define PERF_MAX_IDS 16
+
+void perf_compute_stats(uint64 *, uint32, perf_stats_t *);
+void perf_expect_dump(void);
+int  perf_family(const uint32 *, int, uint32 *);
 void perf_print(uint32);
+void perf_print_ids(const uint32 *, int);
+void perf_disable(void);
+bool perf_enabled(void);
+void perf_set_phases(bool);
+void perf_set_csv(const char *);
+void perf_set_json(const char *);
+int  perf_summary(void);
 
 
 #endif
@@ -0,0 +1,742 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This file sends table load, validate, and activate commands
+ * without waiting for each one's response before sending the next.
+ * Callers queue up steps, each a command and the events that say it
+ * worked, and pipeline_run() then keeps one step in flight per table:
+ * it sends a table's next step as soon as its previous one is done
+ * and matches events to steps in whatever order they arrive.  Steps
+ * for one table run in the order they were queued, since TBL has only
+ * one inactive image per table; steps for different tables overlap.
+ *
+ * The exception is the VS apps' STAGE command, which reads an image
+ * into the app's own staging pool rather than TBL's inactive buffer.
+ * Up to VS_STAGE_SLOTS consecutive STAGE steps per table are in
+ * flight at once, so the app reads image N+1 while it loads and
+ * validates image N.  A table's in-flight steps match events oldest
+ * first, the order the app loads its staged images in.
+ *
+ * Each step gets a sequence number in the order it was queued, and
+ * the console lines about a step start with its number.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "cfe.h"
+#include "cfe_evs_extern_typedefs.h"   /* for CFE_EVS_EventType_* enum */
+#include "cfe_tbl_msg.h"               /* for CFE_TBL_BufferSelect_* */
+#include "vs_ground.h"                 /* for app names, perf IDs */
+#include "vs_tablestruct.h"            /* for common VS table constants */
+#include "vs_msgstruct.h"              /* for VS_STAGE_SLOTS */
+#include "vs_eventids.h"               /* for common VS event ID constants */
+
+#include "capture.h"
+#include "cmd.h"
+#include "tlm.h"
+#include "file.h"
+#include "send.h"
+#include "expect.h"
+#include "perf.h"
+#include "tbltest.h"
+#include "pipeline.h"
+
+
+/* ------------- module local definitions and functions ------------ */
+
+/* Longest we'll wait for all of a step's events. */
+#define PIPELINE_TIMEOUT 10     /* seconds */
+
+/* How long to wait for telemetry before checking for timeouts. */
+#define PIPELINE_POLL_PERIOD 100    /* msecs */
+
+/* The most events a single step can want.  A validation that finds
+ * every kind of error in every entry comes closest.
+ */
+#define PIPELINE_MAX_WANTS 16
+
+/* The most tables a pipeline can work on. */
+#define PIPELINE_MAX_TABLES 8
+
+/* Longest table image file name, same as file.c's. */
+#define PIPELINE_FILENAME_LEN 64
+
+/* The steps array starts this big and doubles as needed. */
+#define PIPELINE_MIN_STEPS 64
+
+/* The most steps a table can have in flight, all of them STAGEs. */
+#define PIPELINE_MAX_IN_FLIGHT VS_STAGE_SLOTS
+
+typedef enum {
+	po_load,
+	po_validate,
+	po_activate,
+	po_stage
+} pipeline_op_t;
+
+typedef enum {
+	ps_queued,   /* not sent yet */
+	ps_sent,     /* sent, waiting for events */
+	ps_done,     /* saw all the events it wanted */
+	ps_failed,   /* timed out */
+	ps_skipped   /* never sent, an earlier step on its table failed */
+} pipeline_state_t;
+
+typedef struct {
+	pipeline_op_t    op;
+	int              table;       /* index into tables[] */
+	const char      *filename;    /* file to load, for po_load/stage */
+	const char      *app_name;    /* app to stage it, for po_stage */
+	expect_want_t    wants[PIPELINE_MAX_WANTS];
+	bool             seen[PIPELINE_MAX_WANTS];
+	int              num_wants;
+	int              num_seen;
+	pipeline_state_t state;
+	uint64           sent;        /* when we sent it, usecs */
+} pipeline_step_t;
+
+typedef struct {
+	const char *tbl_name;
+	int         in_flight[PIPELINE_MAX_IN_FLIGHT];  /* its sent steps, */
+	int         num_in_flight;                     /*   oldest first  */
+	int         next;          /* its steps before this one are sent */
+	bool        failed;        /* has one of its steps failed? */
+} pipeline_table_t;
+
+static pipeline_step_t *steps;
+static int num_steps, max_steps;
+
+static pipeline_table_t tables[PIPELINE_MAX_TABLES];
+static int num_tables;
+
+static const char *op_names[] = { "LOAD ", "VALID", "ACTIV", "STAGE" };
+
+
+/* pipeline_now()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: microseconds since some arbitrary fixed point, by the
+ *         capture's virtual clock when replaying one.
+ */
+
+static uint64
+pipeline_now(void) {
+
+	return capture_now();
+
+} /* pipeline_now() */
+
+
+/* pipeline_add()
+ *
+ * in:     op       - command the step sends
+ *         tbl_name - full app.tbl name of the table it works on
+ * out:    steps    - new step queued at the end
+ *         tables   - tbl_name added if it's new
+ * return: the new step.
+ */
+
+static pipeline_step_t *
+pipeline_add(pipeline_op_t op, const char *tbl_name) {
+
+	pipeline_step_t *p_step;
+	int t;
+
+	for (t = 0; t < num_tables; t++) {
+		if (!strcmp(tables[t].tbl_name, tbl_name)) break;
+	}
+	if (t == num_tables) {
+		/* If we run out of room, that's a bug - we need to
+		 * increase PIPELINE_MAX_TABLES.
+		 */
+		assert(num_tables < PIPELINE_MAX_TABLES);
+		tables[t].tbl_name      = tbl_name;
+		tables[t].num_in_flight = 0;
+		tables[t].next          = 0;
+		tables[t].failed        = false;
+		num_tables++;
+	}
+
+	if (num_steps == max_steps) {
+		max_steps = (max_steps ? (2 * max_steps) : PIPELINE_MIN_STEPS);
+		steps = realloc(steps,
+			(size_t)max_steps * sizeof(pipeline_step_t));
+		if (steps == NULL) {
+			perror("Failed to allocate pipeline steps.");
+			exit(-1);
+		}
+	}
+
+	p_step = &(steps[num_steps++]);
+	memset(p_step, 0, sizeof(*p_step));
+	p_step->op    = op;
+	p_step->table = t;
+	p_step->state = ps_queued;
+	return p_step;
+
+} /* pipeline_add() */
+
+
+/* pipeline_want()
+ *
+ * in:     p_step - step to add a wanted event to
+ * out:    nothing
+ * return: the step's next free want.
+ */
+
+static expect_want_t *
+pipeline_want(pipeline_step_t *p_step) {
+
+	/* If we run out of room, that's a bug - we need to increase
+	 * PIPELINE_MAX_WANTS.
+	 */
+	assert(p_step->num_wants < PIPELINE_MAX_WANTS);
+	return &(p_step->wants[p_step->num_wants++]);
+
+} /* pipeline_want() */
+
+
+/* pipeline_send_next()
+ *
+ * in:     t      - index of the table whose next steps to send
+ * out:    steps  - the table's next step sent, and, if they are all
+ *                  STAGEs, the ones after it too while its app has
+ *                  free staging slots; or, if one of its steps
+ *                  failed, all its remaining steps skipped
+ *         tables - in_flight updated
+ * return: nothing
+ */
+
+static void
+pipeline_send_next(int t) {
+
+	pipeline_table_t *p_table = &(tables[t]);
+	pipeline_step_t *p_step;
+	int i;
+
+	for (i = p_table->next; i < num_steps; i++) {
+
+		p_step = &(steps[i]);
+		if ((p_step->table != t) || (p_step->state != ps_queued))
+			continue;
+
+		if (p_table->failed) {
+			p_step->state = ps_skipped;
+			continue;
+		}
+
+		/* Only STAGE steps overlap, one per staging slot. */
+		if ((p_table->num_in_flight > 0) &&
+			((p_step->op != po_stage) ||
+			(steps[p_table->in_flight[0]].op != po_stage) ||
+			(p_table->num_in_flight == PIPELINE_MAX_IN_FLIGHT)))
+			return;
+
+		printf("PIPE: #%-4d SENT %s CMD  %s %s\n", i + 1,
+			((p_step->op == po_stage) ? p_step->app_name :
+			"CFE_TBL"), op_names[p_step->op],
+			(((p_step->op == po_load) || (p_step->op == po_stage)) ?
+			p_step->filename : p_table->tbl_name));
+		switch (p_step->op) {
+		case po_load:
+			cmd_tbl_load(p_step->filename);
+			break;
+		case po_validate:
+			cmd_tbl_validate(p_table->tbl_name,
+				CFE_TBL_BufferSelect_INACTIVE);
+			break;
+		case po_activate:
+			cmd_tbl_activate(p_table->tbl_name);
+			break;
+		case po_stage:
+			cmd_vs_stage(p_step->app_name, p_step->filename);
+			break;
+		}
+		p_step->state = ps_sent;
+		p_step->sent  = pipeline_now();
+		p_table->in_flight[p_table->num_in_flight++] = i;
+		p_table->next = i + 1;
+	}
+
+} /* pipeline_send_next() */
+
+
+/* pipeline_retire()
+ *
+ * in:     t      - index of the table whose in-flight step is done
+ *         k      - index of the step in the table's in_flight[]
+ * out:    tables - the step removed from in_flight[]
+ * return: nothing
+ */
+
+static void
+pipeline_retire(int t, int k) {
+
+	pipeline_table_t *p_table = &(tables[t]);
+
+	p_table->num_in_flight--;
+	memmove(&(p_table->in_flight[k]), &(p_table->in_flight[k + 1]),
+		(size_t)(p_table->num_in_flight - k) * sizeof(int));
+
+} /* pipeline_retire() */
+
+
+/* pipeline_match()
+ *
+ * in:     tlm_msg   - latest received telemetry message
+ *         now       - current time, usecs
+ * out:    steps     - event marked seen in the step that wanted it
+ *         latencies - a finished step's latency added
+ * return: nothing
+ *
+ * If the message finishes a step, sends its table's next steps.
+ */
+
+static void
+pipeline_match(uint64 now, uint64 *latencies, uint32 *p_num_latencies) {
+
+	pipeline_step_t *p_step;
+	int t, k, i, w;
+
+	if (!tlm_is_evs()) return;
+
+	for (t = 0; t < num_tables; t++) {
+		for (k = 0; k < tables[t].num_in_flight; k++) {
+
+			i = tables[t].in_flight[k];
+			p_step = &(steps[i]);
+
+			for (w = 0; w < p_step->num_wants; w++) {
+				if (p_step->seen[w]) continue;
+				if (expect_matches(&(p_step->wants[w])))
+					break;
+			}
+			if (w == p_step->num_wants) continue;
+
+			p_step->seen[w] = true;
+			if (++(p_step->num_seen) < p_step->num_wants)
+				return;
+
+			p_step->state = ps_done;
+			latencies[(*p_num_latencies)++] = now - p_step->sent;
+			printf("PIPE: #%-4d PASS %s %s in %.3f s.\n", i + 1,
+				op_names[p_step->op], tables[t].tbl_name,
+				(double)(now - p_step->sent) / 1000000.0);
+			pipeline_retire(t, k);
+			pipeline_send_next(t);
+			return;
+		}
+	}
+
+} /* pipeline_match() */
+
+
+/* pipeline_expire()
+ *
+ * in:     now    - current time, usecs
+ * out:    steps  - steps that have waited too long marked failed,
+ *                  and the later steps on their tables skipped
+ * return: nothing
+ */
+
+static void
+pipeline_expire(uint64 now) {
+
+	pipeline_step_t *p_step;
+	int t, k, i;
+
+	for (t = 0; t < num_tables; t++) {
+
+		k = 0;
+		while (k < tables[t].num_in_flight) {
+
+			i = tables[t].in_flight[k];
+			p_step = &(steps[i]);
+			if ((now - p_step->sent) <
+				(uint64)PIPELINE_TIMEOUT * 1000000) {
+				k++;
+				continue;
+			}
+
+			p_step->state = ps_failed;
+			printf("PIPE: #%-4d FAIL %s %s: %d of %d events in "
+				"%d s.\n", i + 1, op_names[p_step->op],
+				tables[t].tbl_name, p_step->num_seen,
+				p_step->num_wants, PIPELINE_TIMEOUT);
+			tables[t].failed = true;
+			pipeline_retire(t, k);
+		}
+		if (tables[t].failed) pipeline_send_next(t);
+	}
+
+} /* pipeline_expire() */
+
+
+/* pipeline_image()
+ *
+ * in:     tbl_name - full app.tbl name of table the image is for
+ *         filename - where to put it on the spacecraft
+ *         valid    - write pipeline_test()'s valid image if true, or
+ *                    its invalid one if false
+ * out:    nothing
+ * return: nothing
+ *
+ * The valid image has 2 valid entries, and the invalid one has 1
+ * valid entry and 1 used entry after an unused one.  Both have
+ * VS_TABLE_NUM_ENTRIES - 2 unused entries.
+ */
+
+static void
+pipeline_image(const char *tbl_name, const char *filename, bool valid) {
+
+	file_set_filename(filename);
+	file_init(tbl_name, TABLE_DESCRIPTION);
+	file_set_entry(0, VS_PARM_BAT, 0x00,
+		VS_PARM_ANIMAL_MIN, VS_PARM_ANIMAL_MAX);
+	if (valid) {
+		file_set_entry(1, VS_PARM_EAST, 0x00,
+			VS_PARM_DIRECTION_MIN, VS_PARM_DIRECTION_MAX);
+	} else {
+		file_set_entry(3, VS_PARM_APE, 0x00,
+			VS_PARM_ANIMAL_MIN, VS_PARM_ANIMAL_MAX);
+	}
+	file_output(file_host_filename());
+
+} /* pipeline_image() */
+
+
+/* ------------------- module exported functions ----------------------- */
+
+
+/* pipeline_load()
+ *
+ * in:     tbl_name - full app.tbl name of table to load
+ *         filename - table image file on the spacecraft; must stay
+ *                    unchanged until pipeline_run() returns
+ * out:    nothing
+ * return: nothing
+ *
+ * Queues a load step that wants TBL's load success event.
+ */
+
+void
+pipeline_load(const char *tbl_name, const char *filename) {
+
+	pipeline_step_t *p_step = pipeline_add(po_load, tbl_name);
+
+	p_step->filename = filename;
+	expect_want_load(pipeline_want(p_step), filename, tbl_name);
+
+} /* pipeline_load() */
+
+
+/* pipeline_validate()
+ *
+ * in:     app_name      - name of app that owns the table
+ *         tbl_name      - full app.tbl name of table to validate
+ *         valid         - whether the image should be valid
+ *         count_valid   - number of expected valid entries
+ *         count_invalid - number of expected invalid entries
+ *         count_unused  - number of expected unused entries
+ * out:    nothing
+ * return: nothing
+ *
+ * Queues a validate step that wants the app's validation summary
+ * event and TBL's verdict.  Follow with pipeline_want_err() calls to
+ * have it also want the app's error events.
+ */
+
+void
+pipeline_validate(const char *app_name, const char *tbl_name, bool valid,
+	unsigned count_valid, unsigned count_invalid, unsigned count_unused) {
+
+	pipeline_step_t *p_step = pipeline_add(po_validate, tbl_name);
+
+	expect_want_counts(pipeline_want(p_step), app_name, count_valid,
+		count_invalid, count_unused);
+	expect_want_verdict(pipeline_want(p_step), app_name, tbl_name,
+		valid);
+
+} /* pipeline_validate() */
+
+
+/* pipeline_activate()
+ *
+ * in:     app_name - name of app that owns the table
+ *         tbl_name - full app.tbl name of table to activate
+ *         success  - whether TBL should activate the image, or refuse
+ *                    to because it isn't validated
+ * out:    nothing
+ * return: nothing
+ *
+ * Queues an activate step.
+ */
+
+void
+pipeline_activate(const char *app_name, const char *tbl_name,
+	bool success) {
+
+	pipeline_step_t *p_step = pipeline_add(po_activate, tbl_name);
+
+	expect_want_activate(pipeline_want(p_step), app_name, tbl_name,
+		success);
+
+} /* pipeline_activate() */
+
+
+/* pipeline_stage()
+ *
+ * in:     app_name      - name of app that owns the table
+ *         tbl_name      - full app.tbl name of table to stage for
+ *         filename      - table image file on the spacecraft; must
+ *                         stay unchanged until pipeline_run() returns
+ *         valid         - whether the image should be valid
+ *         count_valid   - number of expected valid entries
+ *         count_invalid - number of expected invalid entries
+ *         count_unused  - number of expected unused entries
+ * out:    nothing
+ * return: nothing
+ *
+ * Queues a STAGE step that wants the app's staged event, its
+ * validation summary event, and its loaded event for a valid image
+ * or its not-loaded event for an invalid one.  Follow with
+ * pipeline_want_err() calls to have it also want the app's error
+ * events.
+ */
+
+void
+pipeline_stage(const char *app_name, const char *tbl_name,
+	const char *filename, bool valid, unsigned count_valid,
+	unsigned count_invalid, unsigned count_unused) {
+
+	pipeline_step_t *p_step = pipeline_add(po_stage, tbl_name);
+
+	p_step->filename = filename;
+	p_step->app_name = app_name;
+	expect_want_stage(pipeline_want(p_step), app_name, filename);
+	expect_want_counts(pipeline_want(p_step), app_name, count_valid,
+		count_invalid, count_unused);
+	expect_want_staged_load(pipeline_want(p_step), app_name, filename,
+		valid);
+
+} /* pipeline_stage() */
+
+
+/* pipeline_want_err()
+ *
+ * in:     app_name - name of app we expect to emit the err
+ *         eventid  - error event ID we expect to see
+ *         message  - message string we expect to see
+ * out:    nothing
+ * return: nothing
+ *
+ * Adds an error event to the events the latest queued step wants.
+ */
+
+void
+pipeline_want_err(const char *app_name, tlm_eventid_t eventid,
+	const char *message) {
+
+	assert(num_steps > 0);
+	expect_want_err(pipeline_want(&(steps[num_steps - 1])), app_name,
+		eventid, message);
+
+} /* pipeline_want_err() */
+
+
+/* pipeline_run()
+ *
+ * in:     steps - queued steps
+ * out:    steps - emptied
+ * return: 0 if every step saw all the events it wanted, else -1.
+ *
+ * Runs the queued steps, one in flight per table at a time but for
+ * runs of STAGE steps, and prints how long they took.
+ */
+
+int
+pipeline_run(void) {
+
+	uint64 *latencies;        /* of finished steps, usecs */
+	uint32 num_latencies = 0;
+	perf_stats_t stats;       /* of latencies */
+	uint64 start, elapsed;
+	unsigned counts[ps_skipped + 1] = { 0 };   /* steps per state */
+	int result;
+	int t, i;
+
+	if ((latencies = malloc(((size_t)num_steps + 1) *
+		sizeof(uint64))) == NULL) {
+		perror("Failed to allocate pipeline latencies.");
+		exit(-1);
+	}
+
+	/* Send every table's first steps in one burst.  That's one
+	 * TBL command for each of the three VS apps' tables at most,
+	 * or VS_STAGE_SLOTS STAGE commands to each app, within SB's
+	 * message limit.
+	 */
+	start = pipeline_now();
+	cmd_burst_begin();
+	for (t = 0; t < num_tables; t++) pipeline_send_next(t);
+	cmd_burst_end();
+
+	for (;;) {
+		for (t = 0; t < num_tables; t++) {
+			if (tables[t].num_in_flight != 0) break;
+		}
+		if (t == num_tables) break;   /* nothing left in flight */
+
+		if (!tlm_receive_timeout(PIPELINE_POLL_PERIOD)) {
+			pipeline_match(pipeline_now(), latencies,
+				&num_latencies);
+		}
+		pipeline_expire(pipeline_now());
+	}
+	elapsed = pipeline_now() - start;
+
+	for (i = 0; i < num_steps; i++) counts[steps[i].state]++;
+	printf("PIPE: %d steps (%u passed, %u failed, %u skipped) in "
+		"%.3f s: %.1f steps/sec.\n", num_steps, counts[ps_done],
+		counts[ps_failed], counts[ps_skipped],
+		(double)elapsed / 1000000.0,
+		(elapsed ? ((double)counts[ps_done] * 1000000.0 /
+		(double)elapsed) : 0.0));
+
+	if (num_latencies) {
+		perf_compute_stats(latencies, num_latencies, &stats);
+		printf("PIPE: step latency in usecs: count %u min %llu "
+			"median %llu p90 %llu p99 %llu max %llu mean %.1f "
+			"stddev %.1f\n", (unsigned int)stats.count,
+			(unsigned long long)stats.min,
+			(unsigned long long)stats.median,
+			(unsigned long long)stats.p90,
+			(unsigned long long)stats.p99,
+			(unsigned long long)stats.max, stats.mean,
+			stats.stddev);
+	}
+	free(latencies);
+
+	result = ((counts[ps_done] == (unsigned)num_steps) ? 0 : -1);
+	num_steps  = 0;
+	num_tables = 0;
+	return result;
+
+} /* pipeline_run() */
+
+
+/* pipeline_test()
+ *
+ * in:     app_names - names of the apps whose tables to work on
+ *         num_apps  - number of apps in app_names
+ *         rounds    - number of load-validate-activate rounds per table
+ *         staged    - STAGE each round's image instead
+ * out:    nothing
+ * return: 0 if every round went as expected, else -1.
+ *
+ * A throughput test of the TBL workflow.  Queues rounds of load,
+ * validate, and activate for each app's table, alternating between a
+ * valid image TBL should activate and an invalid one it should
+ * refuse to, and runs them all through the pipeline at once.  With
+ * staged, each round is instead a single STAGE step, and the app
+ * loads and validates one image while the next waits in its pool.
+ */
+
+int
+pipeline_test(const char *const *app_names, int num_apps,
+	unsigned rounds, bool staged) {
+
+	/* Table names and the two image files of each app's table. */
+	static char tbl_names[PIPELINE_MAX_TABLES][CFE_MISSION_MAX_API_LEN];
+	static char filenames[PIPELINE_MAX_TABLES][2][PIPELINE_FILENAME_LEN];
+	uint32 perfids[PIPELINE_MAX_TABLES];
+	bool valid;
+	unsigned r;
+	int a, result;
+
+	assert(num_apps <= PIPELINE_MAX_TABLES);
+
+	puts("FILE: create a valid and an invalid image for each table.");
+	for (a = 0; a < num_apps; a++) {
+		snprintf(tbl_names[a], sizeof(tbl_names[a]), "%s.%s",
+			app_names[a], VS_RAW_TABLE_NAME);
+		snprintf(filenames[a][0], sizeof(filenames[a][0]),
+			"/cf/tbltest_%s_invalid.tbl", app_names[a]);
+		snprintf(filenames[a][1], sizeof(filenames[a][1]),
+			"/cf/tbltest_%s_valid.tbl", app_names[a]);
+		pipeline_image(tbl_names[a], filenames[a][0], false);
+		pipeline_image(tbl_names[a], filenames[a][1], true);
+	}
+
+	for (r = 0; r < rounds; r++) {
+		valid = !(r % 2);
+		for (a = 0; a < num_apps; a++) {
+			if (staged) {
+				pipeline_stage(app_names[a], tbl_names[a],
+					filenames[a][valid], valid,
+					(valid ? 2 : 1), (valid ? 0 : 1),
+					VS_TABLE_NUM_ENTRIES - 2);
+			} else {
+				pipeline_load(tbl_names[a],
+					filenames[a][valid]);
+				pipeline_validate(app_names[a], tbl_names[a],
+					valid, (valid ? 2 : 1),
+					(valid ? 0 : 1),
+					VS_TABLE_NUM_ENTRIES - 2);
+			}
+			if (!valid) {
+				pipeline_want_err(app_names[a],
+					VS_TBL_EXTRA_ERR_EID, "Table entry 4 "
+					"parm Ape follows an unused entry");
+			}
+			if (!staged) {
+				pipeline_activate(app_names[a], tbl_names[a],
+					valid);
+			}
+		}
+	}
+
+	for (a = 0; a < num_apps; a++) {
+		if (!strcmp(app_names[a], VSA_APP_NAME)) {
+			perfids[a] = VSA_VF_PERF_ID;
+		} else if (!strcmp(app_names[a], VSB_APP_NAME)) {
+			perfids[a] = VSB_VF_PERF_ID;
+		} else {
+			perfids[a] = VSC_VF_PERF_ID;
+		}
+	}
+	send_perfmon_ids("the tested apps", perfids, num_apps);
+	send_tlmon();
+	if (expect_tlmon_success()) return -1;
+
+	send_perfstart();
+	result = pipeline_run();
+	send_perfstop();
+	perf_print_ids(perfids, num_apps);
+	if (perf_summary()) result = -1;
+
+	if (result) {
+		puts("At least one test failed.");
+	} else {
+		puts("All tests passed.");
+	}
+	return result;
+
+} /* pipeline_test() */
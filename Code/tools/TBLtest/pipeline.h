@@ -0,0 +1,29 @@
+#ifndef _PIPELINE_H_
+#define _PIPELINE_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+void pipeline_load(const char *, const char *);
+void pipeline_validate(const char *, const char *, bool, unsigned, unsigned,
+	unsigned);
+void pipeline_activate(const char *, const char *, bool);
+void pipeline_stage(const char *, const char *, const char *, bool,
+	unsigned, unsigned, unsigned);
+void pipeline_want_err(const char *, tlm_eventid_t, const char *);
+int  pipeline_run(void);
+int  pipeline_test(const char *const *, int, unsigned, bool);
+
+#endif
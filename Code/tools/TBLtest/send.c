@@ -19,22 +19,29 @@
  * the user can follow along.
  */
 
+#include <assert.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "cfe.h"
 #include "cfe_tbl_msg.h"               /* for TBL command codes */
+#include "cfe_es_perfdata_typedef.h"   /* for perf mask size */
 #include "vs_ground.h"                 /* for app names and perf IDs */
+#include "vs_tablestruct.h"            /* for file.h's vs_table_t */
 
 #include "cmd.h"
+#include "file.h"
 #include "send.h"
 #include "perf.h"
 #include "tbltest.h"
 
 
-/* send_perfmon()
+/* send_perfmon_ids()
  *
- * in:     app_name   - name of app whose performance we want ES to track
- *         app_perfid - performance ID we want ES to track
+ * in:     app_names   - names of apps whose performance we want ES
+ *                       to track, for the console
+ *         perfids     - performance IDs we want ES to track
+ *         num_perfids - number of performance IDs in perfids
  * out:    nothing
  * return: nothing
  *
@@ -42,44 +49,69 @@
  * set both its perf filter mask and its perf trigger mask.  Doing so
  * requires sending multiple commands.  If ES encounters no errors, it
  * does not respond with telemetry.  This function bundles up all the
- * commands needed to make ES monitor the one perf ID we care about
- * and no others.  There is no corresponding telemetry response to
- * 'expect'.
+ * commands needed to make ES monitor the perf IDs we care about and
+ * no others, so that the entries of every other app and of cFE itself
+ * don't crowd ours out of the log.  With perf_set_phases(), the
+ * perf IDs we care about include every phase of the apps in
+ * perf_family(), and with latency_set(), their outermost phases.
+ * There is no corresponding telemetry response to 'expect'.  Does nothing if perf_disable() turned perf off.
  */
 
 void
-send_perfmon(const char *app_name, uint32 app_perfid) {
+send_perfmon_ids(const char *app_names, const uint32 *perfids,
+	int num_perfids) {
 
-	uint32 word_num = (uint32)(app_perfid / 32);
-	uint32 word_mask = 0x01 << (app_perfid % 32);
+	uint32 word_masks[CFE_ES_PERF_32BIT_WORDS_IN_MASK];
+	uint32 family[PERF_MAX_IDS];   /* perfids and their phases */
+	uint32 word_num;
+	int num_family;
+	int i;
+
+	if (!perf_enabled()) return;
+
+	num_family = perf_family(perfids, num_perfids, family);
+	memset(word_masks, 0, sizeof(word_masks));
+	for (i = 0; i < num_family; i++) {
+		word_num = (uint32)(family[i] / 32);
+		assert(word_num < CFE_ES_PERF_32BIT_WORDS_IN_MASK);
+		word_masks[word_num] |= 0x01 << (family[i] % 32);
+	}
 
 	/* Tell ES that, when we turn perf logging on, we want it to
-	 * log perf events from our app.
+	 * log perf events from our apps.
 	 */
-	printf("INIT: Tell ES we care about %s performance.\n", app_name);
-	printf("SENT:      CFE_ES  CMD  PCARE %s\n", app_name);
+	printf("INIT: Tell ES we care about %s performance.\n", app_names);
+	printf("SENT:      CFE_ES  CMD  PCARE %s\n", app_names);
 
-	/* Clear the lower three words of the ES perf filter mask mask
-	 * to turn off all the default perf logging.
+	/* Set every word of the ES perf filter and trigger masks to
+	 * our apps' bits alone, turning off all the default perf
+	 * logging, so that when we turn on logging, ES will log only
+	 * our apps' events.
 	 */
-	cmd_es_setperffilter(0, 0x00);
-	cmd_es_setperffilter(1, 0x00);
-	cmd_es_setperffilter(2, 0x00);
+	for (word_num = 0; word_num < CFE_ES_PERF_32BIT_WORDS_IN_MASK;
+		word_num++) {
+		cmd_es_setperffilter(word_num, word_masks[word_num]);
+		cmd_es_setperftrigger(word_num, word_masks[word_num]);
+	}
 
-	/* Clear the lower three words of the ES perf trigger mask to
-	 * turn off all the default perf logging.
-	 */
-	cmd_es_setperftrigger(0, 0x00);
-	cmd_es_setperftrigger(1, 0x00);
-	cmd_es_setperftrigger(2, 0x00);
+} /* send_perfmon_ids() */
+
+
+/* send_perfmon()
+ *
+ * in:     app_name   - name of app whose performance we want ES to track
+ *         app_perfid - performance ID we want ES to track
+ * out:    nothing
+ * return: nothing
+ *
+ * send_perfmon_ids() for a single app.
+ */
+
+void
+send_perfmon(const char *app_name, uint32 app_perfid) {
+
+	send_perfmon_ids(app_name, &app_perfid, 1);
 
-	/* Set our app's bit in the ES perf filter and trigger masks
-	 * so that when we turn on logging, ES will log our app's
-	 * events.
-	 */
-	cmd_es_setperffilter(word_num, word_mask);
-	cmd_es_setperftrigger(word_num, word_mask);
-	
 } /* send_perfmon() */
 
 
@@ -93,6 +125,8 @@ send_perfmon(const char *app_name, uint32 app_perfid) {
 void
 send_perfstart(void) {
 
+	if (!perf_enabled()) return;
+
 	/* Tell ES to start storing CFE_ES_PerfLogEntry/Exit() events. */
 	puts("PERF: start storing performance events.");
 	puts("SENT:      CFE_ES  CMD  PSTRT");
@@ -116,11 +150,14 @@ send_perfstart(void) {
 void
 send_perfstop(void) {
 
+	if (!perf_enabled()) return;
+
 	/* Tell ES to stop storing CFE_ES_PerfLogEntry/Exit() events
 	 * and write the events it saw out to its default file.
 	 */
 	puts("PERF: stop storing performance events.");
 	puts("SENT:      CFE_ES  CMD  PSTOP");
+	perf_expect_dump();
 	cmd_es_perfstop();
 
 } /* send_perfstop() */
@@ -142,8 +179,8 @@ send_load(void) {
 
 	/* Tell TBL to load table */
 	puts("TEST: load file into inactive image.");
-	puts("SENT:      CFE_TBL CMD  LOAD  " TABLE_FILENAME);
-	cmd_tbl_load(TABLE_FILENAME);
+	printf("SENT:      CFE_TBL CMD  LOAD  %s\n", file_filename());
+	cmd_tbl_load(file_filename());
 
 } /* send_load() */
 	
@@ -16,6 +16,7 @@
  * permissions and limitations under the License.
  */
 
+void send_perfmon_ids(const char *, const uint32 *, int);
 void send_perfmon(const char *, uint32);
 void send_perfstart(void);
 void send_perfstop(void);
@@ -0,0 +1,497 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This file defines the soak test.  Where the deterministic tests
+ * each load and validate one carefully chosen table image, the soak
+ * test loads and validates a long stream of randomized images at a
+ * target rate to find how many validations per second TBL and the
+ * app's validation function can sustain.  Each image is either valid
+ * or a valid image with one deliberate error, so the soak test knows
+ * which verdict to expect without modelling every validation rule.
+ * Given a golden-image corpus with soak_set_corpus(), the soak test
+ * instead draws its images at random from the corpus, which says
+ * what verdict each should get.
+ *
+ * The soak test prints only a progress line now and then rather than
+ * every message it sees, so that printing doesn't limit the rate.
+ */
+
+#include <time.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "cfe.h"
+#include "cfe_evs_extern_typedefs.h"   /* for CFE_EVS_EventType_* enum */
+#include "cfe_evs_topicids.h"          /* for EVS LONG message topic ID */
+#include "cfe_tbl_eventids.h"          /* for TBL event IDs */
+#include "cfe_tbl_msg.h"               /* for CFE_TBL_BufferSelect_* */
+#include "vs_tablestruct.h"            /* for common VS table constants */
+#include "vs_corpus.h"                 /* for golden-image corpus */
+
+#include "capture.h"
+#include "cmd.h"
+#include "tlm.h"
+#include "file.h"
+#include "send.h"
+#include "expect.h"
+#include "perf.h"
+#include "tbltest.h"
+#include "soak.h"
+
+
+/* ------------- module local definitions and functions ------------ */
+
+/* Longest we'll wait for TBL to respond to a load or validation. */
+#define SOAK_TIMEOUT 10         /* seconds */
+
+/* Print a progress line after every SOAK_PROGRESS validations. */
+#define SOAK_PROGRESS 100
+
+/* The ways soak_make_image() can spoil a valid image. */
+typedef enum {
+	sm_parm,     /* parm ID that isn't one of the VS_PARM_* values */
+	sm_pad,      /* padding not zeroed */
+	sm_lbnd,     /* low bound below the parm's minimum */
+	sm_hbnd,     /* high bound above the parm's maximum */
+	sm_order,    /* low bound above high bound */
+	sm_redef,    /* parm repeats an earlier entry's parm */
+	sm_extra,    /* in-use entry follows an unused entry */
+	SOAK_NUM_MUTATIONS
+} soak_mutation_t;
+
+static const uint8 parms[] = {
+	VS_PARM_APE, VS_PARM_BAT, VS_PARM_CAT, VS_PARM_DOG,
+	VS_PARM_NORTH, VS_PARM_SOUTH, VS_PARM_EAST, VS_PARM_WEST,
+};
+#define NUM_PARMS (sizeof(parms) / sizeof(parms[0]))
+
+/* Valid images define each parm at most once, so even big tables have
+ * no more in-use entries than there are named parms.
+ */
+#define MAX_IN_USE ((VS_TABLE_NUM_ENTRIES < NUM_PARMS) ? \
+	VS_TABLE_NUM_ENTRIES : NUM_PARMS)
+
+/* Totals for the whole soak run. */
+static struct {
+	unsigned sent;        /* validations commanded */
+	unsigned valid;       /* verdicts of valid */
+	unsigned invalid;     /* verdicts of invalid */
+	unsigned wrong;       /* verdicts other than the one we expected */
+	unsigned timeouts;    /* loads or validations TBL never answered */
+	unsigned late;        /* validations we started behind schedule */
+	unsigned lost;        /* EVS events missing from the sequence */
+	bool have_sequence;   /* have we seen an EVS event yet? */
+	tlm_sequence_t sequence;  /* of the latest EVS event */
+} tally;
+
+/* The corpus to draw images from, if any. */
+static const char *corpus_path = NULL;
+static vs_corpus_t corpus;
+
+/* Time from each validation command to TBL's verdict. */
+static uint64 *latencies;   /* usecs */
+static uint32  num_latencies;
+
+
+/* soak_now()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: microseconds since some arbitrary fixed point, by the
+ *         capture's virtual clock when replaying one.
+ */
+
+static uint64
+soak_now(void) {
+
+	return capture_now();
+
+} /* soak_now() */
+
+
+/* soak_random()
+ *
+ * in:     low  - smallest value wanted
+ *         high - largest value wanted, at least low
+ * out:    nothing
+ * return: a pseudo-random value from low to high inclusive.
+ *
+ * rand() may return as few as 15 bits, so build the value from two.
+ */
+
+static uint32
+soak_random(uint32 low, uint32 high) {
+
+	uint32 r = ((uint32)rand() << 15) ^ (uint32)rand();
+
+	return low + (uint32)(r % ((uint64)high - low + 1));
+
+} /* soak_random() */
+
+
+/* soak_bounds()
+ *
+ * in:     parm_id - one of the VS_PARM_* values
+ * out:    p_min   - smallest valid bound for parm_id
+ *         p_max   - largest valid bound for parm_id
+ * return: nothing
+ */
+
+static void
+soak_bounds(uint8 parm_id, uint32 *p_min, uint32 *p_max) {
+
+	if (parm_id & (VS_PARM_APE|VS_PARM_BAT|VS_PARM_CAT|VS_PARM_DOG)) {
+		*p_min = VS_PARM_ANIMAL_MIN;
+		*p_max = VS_PARM_ANIMAL_MAX;
+	} else {
+		*p_min = VS_PARM_DIRECTION_MIN;
+		*p_max = VS_PARM_DIRECTION_MAX;
+	}
+
+} /* soak_bounds() */
+
+
+/* soak_make_image()
+ *
+ * in:     tbl_name - name of test table
+ * out:    test table file - written to file_host_filename()
+ * return: true if the image is valid, false if it is invalid.
+ *
+ * Builds a valid image: a random number of in-use entries, each with
+ * a different parm and random in-bounds bounds in order, followed by
+ * unused entries.  Half the time, spoils it with one random mutation.
+ * With a corpus, copies a random corpus image instead.
+ */
+
+static bool
+soak_make_image(const char *tbl_name) {
+
+	uint32 c;            /* index of corpus image */
+	uint8  parm_id[VS_TABLE_NUM_ENTRIES];
+	uint32 low[VS_TABLE_NUM_ENTRIES], high[VS_TABLE_NUM_ENTRIES];
+	uint8  shuffled[NUM_PARMS];
+	uint32 min, max;
+	unsigned in_use;     /* leading entries in use */
+	unsigned e, j;
+	uint8  swap;
+	bool   valid = soak_random(0, 1);
+
+	if (corpus.num_images) {
+		c = soak_random(0, corpus.num_images - 1);
+		file_init(tbl_name, TABLE_DESCRIPTION);
+		file_set_table(&(corpus.images[c]));
+		file_output(file_host_filename());
+		return corpus.expect[c].valid;
+	}
+
+	/* Choose which parms the in-use entries define. */
+	memcpy(shuffled, parms, sizeof(shuffled));
+	for (j = NUM_PARMS - 1; j > 0; j--) {
+		e = soak_random(0, j);
+		swap        = shuffled[j];
+		shuffled[j] = shuffled[e];
+		shuffled[e] = swap;
+	}
+
+	/* Every mutation needs at least one in-use entry to spoil. */
+	in_use = soak_random((valid ? 0 : 1), MAX_IN_USE);
+
+	file_init(tbl_name, TABLE_DESCRIPTION);
+	for (e = 0; e < in_use; e++) {
+		parm_id[e] = shuffled[e];
+		soak_bounds(parm_id[e], &min, &max);
+		low[e]  = soak_random(min, max);
+		high[e] = soak_random(low[e], max);
+		file_set_entry(e, parm_id[e], 0x00, low[e], high[e]);
+	}
+	if (valid) {
+		file_output(file_host_filename());
+		return true;
+	}
+
+	e = soak_random(0, in_use - 1);
+	soak_bounds(parm_id[e], &min, &max);
+	switch ((soak_mutation_t)soak_random(0, SOAK_NUM_MUTATIONS - 1)) {
+	case sm_parm:
+		file_set_entry(e, (VS_PARM_DOG|VS_PARM_WEST), 0x00,
+			low[e], high[e]);
+		break;
+	case sm_pad:
+		file_set_entry(e, parm_id[e], 0xFF, low[e], high[e]);
+		break;
+	case sm_lbnd:
+		file_set_entry(e, parm_id[e], 0x00, min - 1, high[e]);
+		break;
+	case sm_hbnd:
+		file_set_entry(e, parm_id[e], 0x00, low[e], max + 1);
+		break;
+	case sm_order:
+		file_set_entry(e, parm_id[e], 0x00, max, min);
+		break;
+	case sm_redef:
+		/* Repeat entry 0's parm in a later entry. */
+		e = ((in_use > 1) ? soak_random(1, in_use - 1) : 1);
+		file_set_entry(e, parm_id[0], 0x00, low[0], high[0]);
+		break;
+	case sm_extra:
+		/* Leave a gap before the last entry, or make the first
+		 * entry unused if there's no room for a gap.
+		 */
+		if ((in_use < VS_TABLE_NUM_ENTRIES - 1) &&
+			(in_use < NUM_PARMS)) {
+			soak_bounds(shuffled[in_use], &min, &max);
+			file_set_entry(in_use + 1, shuffled[in_use], 0x00,
+				min, max);
+		} else {
+			file_set_entry(0, VS_PARM_UNUSED, 0x00, 0, 0);
+		}
+		break;
+	default:
+		break;
+	}
+
+	file_output(file_host_filename());
+	return false;
+
+} /* soak_make_image() */
+
+
+/* soak_wait()
+ *
+ * in:     tbl_name - name of test table
+ *         want_a   - TBL event ID we're waiting for
+ *         want_b   - another TBL event ID we'd accept instead
+ * out:    tally    - lost updated from EVS event sequence counts
+ * return: the ID of the event we saw, or 0 if we timed out.
+ *
+ * Receives telemetry until TBL sends one of the events we want about
+ * tbl_name or SOAK_TIMEOUT passes.  Counts gaps in the sequence of
+ * EVS events along the way; any gap means events were lost between
+ * EVS and us.
+ */
+
+static tlm_eventid_t
+soak_wait(const char *tbl_name, tlm_eventid_t want_a,
+	tlm_eventid_t want_b) {
+
+	uint64 deadline = soak_now() + (uint64)SOAK_TIMEOUT * 1000000;
+	uint64 now;
+	tlm_sequence_t sequence;
+	tlm_eventid_t eventid;
+
+	while ((now = soak_now()) < deadline) {
+
+		if (tlm_receive_timeout((int)((deadline - now) / 1000) + 1))
+			continue;
+		if (tlm_topicid() != CFE_MISSION_EVS_LONG_EVENT_MSG_MSG)
+			continue;
+
+		sequence = tlm_sequence();
+		if (tally.have_sequence) {
+			tally.lost += (unsigned)((sequence - tally.sequence -
+				1) & TLM_SEQUENCE_MASK);
+		}
+		tally.have_sequence = true;
+		tally.sequence = sequence;
+
+		eventid = tlm_evs_eventid();
+		if ((!strcmp(tlm_evs_appname(), TLM_NAME_TBL)) &&
+			((eventid == want_a) || (eventid == want_b)) &&
+			strstr(tlm_evs_message(), tbl_name)) {
+			return eventid;
+		}
+	}
+
+	return 0;
+
+} /* soak_wait() */
+
+
+/* soak_validate()
+ *
+ * in:     tbl_name - name of test table
+ * out:    tally, latencies - updated with the outcome
+ * return: nothing
+ *
+ * Loads one random image and has TBL validate it.
+ */
+
+static void
+soak_validate(const char *tbl_name) {
+
+	tlm_eventid_t verdict;
+	uint64 sent;          /* when we commanded the validation */
+	bool valid;           /* the verdict we expect */
+
+	valid = soak_make_image(tbl_name);
+	cmd_tbl_load(file_filename());
+	if (0 == soak_wait(tbl_name, CFE_TBL_FILE_LOADED_INF_EID,
+		CFE_TBL_FILE_LOADED_INF_EID)) {
+		tally.timeouts++;
+		return;
+	}
+
+	sent = soak_now();
+	cmd_tbl_validate(tbl_name, CFE_TBL_BufferSelect_INACTIVE);
+	tally.sent++;
+	verdict = soak_wait(tbl_name, CFE_TBL_VALIDATION_INF_EID,
+		CFE_TBL_VALIDATION_ERR_EID);
+	if (verdict == 0) {
+		tally.timeouts++;
+		return;
+	}
+	latencies[num_latencies++] = soak_now() - sent;
+
+	if (verdict == CFE_TBL_VALIDATION_INF_EID) {
+		tally.valid++;
+	} else {
+		tally.invalid++;
+	}
+	if ((verdict == CFE_TBL_VALIDATION_INF_EID) != valid) tally.wrong++;
+
+} /* soak_validate() */
+
+
+/* ------------------- module exported functions ----------------------- */
+
+/* soak_set_corpus()
+ *
+ * in:     path - name of a corpus file vs_corpus_gen wrote
+ * out:    corpus_path - set to path
+ * return: nothing
+ *
+ * soak() maps the corpus when it starts.
+ */
+
+void
+soak_set_corpus(const char *path) {
+
+	corpus_path = path;
+
+} /* soak_set_corpus() */
+
+
+/* soak()
+ *
+ * in:     app_name - name of app to test
+ *         tbl_name - name of test table
+ *         count    - number of validations to run
+ *         rate     - validations per second to aim for, 0 for flat out
+ *         seed     - seed for the random table images
+ * out:    nothing
+ * return: 0 if every verdict arrived and was the one expected, else -1
+ *
+ * Runs count load-validate cycles on random images, starting each
+ * cycle on a fixed schedule of rate per second or, if rate is 0, as
+ * soon as the last one finishes.  Reports the validations per second
+ * achieved, the lost events and timeouts, and the distribution of the
+ * time from each validation command to TBL's verdict.  Cycles that
+ * can't start on schedule because the previous one ran long count as
+ * late; they don't make later cycles start early.
+ */
+
+int
+soak(const char *app_name, const char *tbl_name, unsigned count,
+	double rate, unsigned seed) {
+
+	perf_stats_t stats;    /* of latencies */
+	uint64 start;          /* when the first cycle started, usecs */
+	uint64 due;            /* when the next cycle should start */
+	uint64 now, elapsed;
+	unsigned i;
+
+	printf("SOAK: %u validations of %s at %s%.1f per second, "
+		"seed %u.\n", count, app_name, ((rate > 0) ? "" : "up to "),
+		((rate > 0) ? rate : 0.0), seed);
+
+	if (corpus_path) {
+		if (vs_corpus_map(corpus_path, &corpus)) return -1;
+		if (!corpus.num_images) {
+			fprintf(stderr, "%s has no images.\n", corpus_path);
+			vs_corpus_unmap(&corpus);
+			return -1;
+		}
+		printf("SOAK: drawing images from the %u in %s.\n",
+			(unsigned)corpus.num_images, corpus_path);
+	}
+
+	/* Tell TO_LAB to turn on the telemetry output we need. */
+	send_tlmon();
+	if (expect_tlmon_success()) return -1;
+
+	if (NULL == (latencies = malloc((count + 1) * sizeof(uint64)))) {
+		perror("Failed to allocate soak latencies.");
+		return -1;
+	}
+	srand(seed);
+	memset(&tally, 0, sizeof(tally));
+	num_latencies = 0;
+
+	start = soak_now();
+	for (i = 0; i < count; i++) {
+
+		/* Wait for the cycle's start time, if we aren't past it. */
+		if (rate > 0) {
+			due = start + (uint64)(i * (1000000.0 / rate));
+			now = soak_now();
+			if ((now < due) && !capture_replaying()) {
+				usleep((useconds_t)(due - now));
+			} else if ((now - due) > (uint64)(1000000.0 / rate)) {
+				tally.late++;
+			}
+		}
+
+		soak_validate(tbl_name);
+
+		if (((i + 1) % SOAK_PROGRESS) == 0) {
+			printf("SOAK: %u of %u validations, %u timeouts, "
+				"%u lost events.\n", i + 1, count,
+				tally.timeouts, tally.lost);
+		}
+	}
+	elapsed = soak_now() - start;
+
+	printf("SOAK: %u validations (%u valid, %u invalid) in %.3f s: "
+		"%.1f validations/sec.\n", num_latencies, tally.valid,
+		tally.invalid, (double)elapsed / 1000000.0,
+		(elapsed ? (num_latencies * 1000000.0 / elapsed) : 0.0));
+	printf("SOAK: %u wrong verdicts, %u timeouts, %u lost events, "
+		"%u late starts.\n", tally.wrong, tally.timeouts, tally.lost,
+		tally.late);
+
+	perf_compute_stats(latencies, num_latencies, &stats);
+	printf("SOAK: validation latency in usecs: count %u min %llu "
+		"median %llu p90 %llu p99 %llu max %llu mean %.1f "
+		"stddev %.1f\n", (unsigned int)stats.count,
+		(unsigned long long)stats.min,
+		(unsigned long long)stats.median,
+		(unsigned long long)stats.p90,
+		(unsigned long long)stats.p99,
+		(unsigned long long)stats.max, stats.mean, stats.stddev);
+
+	free(latencies);
+	latencies = NULL;
+	vs_corpus_unmap(&corpus);
+
+	if (tally.wrong || tally.timeouts) {
+		puts("Soak test failed.");
+		return -1;
+	}
+	puts("Soak test passed.");
+	return 0;
+
+} /* soak() */
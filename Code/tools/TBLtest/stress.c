@@ -0,0 +1,573 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This file defines the stress test.  The VS apps share TBL, EVS,
+ * SB, and TO_LAB on the spacecraft, so validations on one app slow
+ * or drop the others' telemetry.  The stress test finds the rate at
+ * which each of those shared resources gives out.  It runs rounds of
+ * validations at rates that double from one level to the next, and
+ * each round commands a validation of every app's table in a single
+ * burst, so they all arrive at the same instant.
+ *
+ * TBL has one validation result slot per request, and a second
+ * request on a table whose first hasn't finished strands the first's
+ * slot.  So an app whose last validation is still pending when a
+ * round comes due sits that round out, and counts as busy.  The
+ * command throttle is off during the rounds, so SB's message limits
+ * and pipe depths are tested too.  SB's own events about overflowing
+ * pipes go through the same pipes, so the test counts overflows from
+ * SB housekeeping telemetry and uses the events it does get only to
+ * name the pipes.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "cfe.h"
+#include "cfe_mission_cfg.h"        /* for SB HK TLM topic ID */
+#include "cfe_evs_extern_typedefs.h"   /* for CFE_EVS_EventType_* enum */
+#include "cfe_evs_topicids.h"          /* for EVS LONG message topic ID */
+#include "cfe_sb_eventids.h"           /* for SB event IDs */
+#include "cfe_sb_msg.h"                /* for CFE_SB_HousekeepingTlm_t */
+#include "cfe_tbl_eventids.h"          /* for TBL event IDs */
+#include "cfe_tbl_msg.h"               /* for CFE_TBL_BufferSelect_* */
+#include "vs_tablestruct.h"            /* for common VS table constants */
+#include "vs_eventids.h"               /* for common VS event ID constants */
+
+#include "capture.h"
+#include "cmd.h"
+#include "tlm.h"
+#include "file.h"
+#include "send.h"
+#include "expect.h"
+#include "perf.h"
+#include "tbltest.h"
+#include "stress.h"
+
+
+/* ------------- module local definitions and functions ------------ */
+
+/* The first level's rate, and the last's if stress() isn't given
+ * one, in rounds per second.
+ */
+#define STRESS_MIN_RATE 1.0
+#define STRESS_MAX_RATE 128.0
+
+/* Longest we'll wait for a verdict, or for SB housekeeping. */
+#define STRESS_TIMEOUT 10       /* seconds */
+
+/* An app keeps up with a rate if it times out on no validations and
+ * sits out no more than one round in STRESS_BUSY_RATIO.
+ */
+#define STRESS_BUSY_RATIO 10
+
+/* The most apps and the most overflowing pipes the test tracks. */
+#define STRESS_MAX_APPS  8
+#define STRESS_MAX_PIPES 8
+
+/* Longest table image file name, same as file.c's. */
+#define STRESS_FILENAME_LEN 64
+
+/* What happened to one app's validations at one level. */
+typedef struct {
+	unsigned commanded;   /* validations commanded */
+	unsigned verdicts;    /* verdicts received */
+	unsigned busy;        /* rounds sat out, last one still pending */
+	unsigned timeouts;    /* validations TBL never answered */
+	unsigned wrong;       /* verdicts of invalid on our valid image */
+	unsigned lost;        /* verdicts without the app's summary event */
+} stress_tally_t;
+
+typedef struct {
+	const char    *app_name;
+	char           tbl_name[CFE_MISSION_MAX_API_LEN];
+	char           filename[STRESS_FILENAME_LEN];
+	bool           pending;    /* commanded, no verdict yet */
+	bool           summary;    /* saw its summary event since then */
+	uint64         sent;       /* when we commanded it, usecs */
+	stress_tally_t tally;      /* at the current level */
+	uint64        *latencies;  /* usecs, at the current level */
+	uint32         num_latencies;
+	double         behind;     /* first rate it fell behind at, or 0 */
+} stress_app_t;
+
+static stress_app_t apps[STRESS_MAX_APPS];
+static int num_apps;
+
+/* What happened to the shared resources at the current level. */
+static struct {
+	unsigned evs_lost;        /* EVS events missing from the sequence */
+	unsigned overflows;       /* SB pipe overflows, by housekeeping */
+	unsigned limits;          /* SB message limit errors, likewise */
+	unsigned events;          /* SB overflow and limit events seen */
+	bool     hk_fresh;        /* SB housekeeping since the rounds ended */
+} shared;
+
+/* The latest SB housekeeping counters and EVS sequence count. */
+static bool           have_hk;
+static uint16         hk_overflows, hk_limits;
+static bool           have_sequence;
+static tlm_sequence_t sequence;
+
+/* The pipes SB's events have named, and the first rate each
+ * overflowed at.
+ */
+static struct {
+	char     name[OS_MAX_API_NAME];
+	double   rate;
+	unsigned count;
+} pipes[STRESS_MAX_PIPES];
+static int num_pipes;
+
+/* First rates EVS lost events and SB pipes overflowed at, or 0. */
+static double evs_behind, sb_behind;
+
+
+/* stress_now()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: microseconds since some arbitrary fixed point, by the
+ *         capture's virtual clock when replaying one.
+ */
+
+static uint64
+stress_now(void) {
+
+	return capture_now();
+
+} /* stress_now() */
+
+
+/* stress_note_pipe()
+ *
+ * in:     message - text of an SB overflow or limit event
+ *         rate    - the current level's rate
+ * out:    pipes   - the pipe the event names counted
+ * return: nothing
+ *
+ * SB's events end ",pipe NAME,sender APP".
+ */
+
+static void
+stress_note_pipe(const char *message, double rate) {
+
+	const char *p_name = strstr(message, ",pipe ");
+	size_t len;
+	int p;
+
+	if (p_name == NULL) return;
+	p_name += strlen(",pipe ");
+	len = strcspn(p_name, ",");
+	if (len >= sizeof(pipes[0].name)) len = sizeof(pipes[0].name) - 1;
+
+	for (p = 0; p < num_pipes; p++) {
+		if ((strlen(pipes[p].name) == len) &&
+			!strncmp(pipes[p].name, p_name, len))
+			break;
+	}
+	if (p == num_pipes) {
+		if (num_pipes == STRESS_MAX_PIPES) return;
+		memcpy(pipes[p].name, p_name, len);
+		pipes[p].name[len] = '\0';
+		pipes[p].rate  = rate;
+		pipes[p].count = 0;
+		num_pipes++;
+	}
+	pipes[p].count++;
+
+} /* stress_note_pipe() */
+
+
+/* stress_handle()
+ *
+ * in:     rate    - the current level's rate
+ *         tlm_msg - latest received telemetry message
+ * out:    apps, shared - updated with what the message says
+ * return: nothing
+ */
+
+static void
+stress_handle(double rate) {
+
+	const CFE_SB_HousekeepingTlm_Payload_t *p_hk;
+	const char *appname;
+	tlm_eventid_t eventid;
+	tlm_sequence_t now;
+	stress_app_t *p_app;
+	uint64 latency;
+	int a;
+
+	if (tlm_topicid() == CFE_MISSION_SB_HK_TLM_MSG) {
+		p_hk = &(((const CFE_SB_HousekeepingTlm_t *)
+			tlm_bytes())->Payload);
+		if (have_hk) {
+			shared.overflows += (uint16)(
+				p_hk->PipeOverflowErrorCounter - hk_overflows);
+			shared.limits += (uint16)(
+				p_hk->MsgLimitErrorCounter - hk_limits);
+		}
+		have_hk = true;
+		hk_overflows = p_hk->PipeOverflowErrorCounter;
+		hk_limits    = p_hk->MsgLimitErrorCounter;
+		shared.hk_fresh = true;
+		return;
+	}
+	if (tlm_topicid() != CFE_MISSION_EVS_LONG_EVENT_MSG_MSG) return;
+
+	now = tlm_sequence();
+	if (have_sequence) {
+		shared.evs_lost += (unsigned)((now - sequence - 1) &
+			TLM_SEQUENCE_MASK);
+	}
+	have_sequence = true;
+	sequence = now;
+
+	appname = tlm_evs_appname();
+	eventid = tlm_evs_eventid();
+
+	if (!strcmp(appname, TLM_NAME_SB)) {
+		if ((eventid == CFE_SB_Q_FULL_ERR_EID) ||
+			(eventid == CFE_SB_MSGID_LIM_ERR_EID)) {
+			shared.events++;
+			stress_note_pipe(tlm_evs_message(), rate);
+		}
+		return;
+	}
+
+	for (a = 0; a < num_apps; a++) {
+		p_app = &(apps[a]);
+		if (!strcmp(appname, p_app->app_name)) {
+			if (eventid == VS_VALIDATION_INF_EID)
+				p_app->summary = true;
+			return;
+		}
+		if (strcmp(appname, TLM_NAME_TBL) ||
+			!strstr(tlm_evs_message(), p_app->tbl_name))
+			continue;
+		if (!p_app->pending ||
+			((eventid != CFE_TBL_VALIDATION_INF_EID) &&
+			(eventid != CFE_TBL_VALIDATION_ERR_EID)))
+			return;
+
+		latency = stress_now() - p_app->sent;
+		p_app->latencies[p_app->num_latencies++] = latency;
+		p_app->pending = false;
+		p_app->tally.verdicts++;
+		if (eventid != CFE_TBL_VALIDATION_INF_EID) p_app->tally.wrong++;
+		if (!p_app->summary) p_app->tally.lost++;
+		return;
+	}
+
+} /* stress_handle() */
+
+
+/* stress_pump()
+ *
+ * in:     until - when to stop, usecs
+ *         rate  - the current level's rate
+ * out:    apps, shared - updated with the telemetry received
+ * return: nothing
+ *
+ * Handles telemetry until the time comes.  A validation that has
+ * waited STRESS_TIMEOUT for its verdict times out, and its app can
+ * take part in the next round; by then TBL has long since finished
+ * with it or never got the command.
+ */
+
+static void
+stress_pump(uint64 until, double rate) {
+
+	uint64 now;
+	int a;
+
+	while ((now = stress_now()) < until) {
+		for (a = 0; a < num_apps; a++) {
+			if (apps[a].pending && ((now - apps[a].sent) >
+				(uint64)STRESS_TIMEOUT * 1000000)) {
+				apps[a].pending = false;
+				apps[a].tally.timeouts++;
+			}
+		}
+		if (tlm_receive_timeout((int)((until - now) / 1000) + 1))
+			continue;
+		stress_handle(rate);
+	}
+
+} /* stress_pump() */
+
+
+/* stress_settle()
+ *
+ * in:     rate - the current level's rate
+ * out:    apps, shared - updated with the telemetry received
+ * return: nothing
+ *
+ * Waits out the level's pending validations, and then for SB
+ * housekeeping sent after them, so its counters cover the level.
+ */
+
+static void
+stress_settle(double rate) {
+
+	uint64 deadline;
+	bool pending;
+	int a;
+
+	do {
+		stress_pump(stress_now() + 100000, rate);
+		for (pending = false, a = 0; a < num_apps; a++)
+			pending = (pending || apps[a].pending);
+	} while (pending);
+
+	deadline = stress_now() + (uint64)STRESS_TIMEOUT * 1000000;
+	shared.hk_fresh = false;
+	while (!shared.hk_fresh && (stress_now() < deadline))
+		stress_pump(stress_now() + 100000, rate);
+
+} /* stress_settle() */
+
+
+/* stress_report()
+ *
+ * in:     rate   - the level's rate
+ *         rounds - the level's rounds
+ * out:    apps   - behind set if the app fell behind at this rate
+ *         evs_behind, sb_behind - likewise
+ * return: nothing
+ */
+
+static void
+stress_report(double rate, unsigned rounds) {
+
+	const stress_tally_t *p_t;
+	perf_stats_t stats;
+	bool lost = (shared.evs_lost != 0);
+	int a;
+
+	for (a = 0; a < num_apps; a++) {
+		p_t = &(apps[a].tally);
+		printf("STRS: %.1f/s %s: %u commanded, %u busy, %u timeouts, "
+			"%u wrong, %u lost summaries.\n", rate,
+			apps[a].app_name, p_t->commanded, p_t->busy,
+			p_t->timeouts, p_t->wrong, p_t->lost);
+		if (apps[a].num_latencies) {
+			perf_compute_stats(apps[a].latencies,
+				apps[a].num_latencies, &stats);
+			printf("STRS: %.1f/s %s latency in usecs: median %llu "
+				"p90 %llu p99 %llu max %llu\n", rate,
+				apps[a].app_name,
+				(unsigned long long)stats.median,
+				(unsigned long long)stats.p90,
+				(unsigned long long)stats.p99,
+				(unsigned long long)stats.max);
+		}
+		if ((apps[a].behind == 0.0) && (p_t->timeouts ||
+			((p_t->busy * STRESS_BUSY_RATIO) > rounds)))
+			apps[a].behind = rate;
+		if (p_t->lost) lost = true;
+	}
+
+	if (shared.hk_fresh) {
+		printf("STRS: %.1f/s shared: %u EVS events lost, %u SB pipe "
+			"overflows, %u SB message limit errors.\n", rate,
+			shared.evs_lost, shared.overflows, shared.limits);
+	} else {
+		printf("STRS: %.1f/s shared: %u EVS events lost, no SB "
+			"housekeeping.\n", rate, shared.evs_lost);
+	}
+	if ((evs_behind == 0.0) && lost) evs_behind = rate;
+	if ((sb_behind == 0.0) && (shared.overflows || shared.limits ||
+		shared.events))
+		sb_behind = rate;
+
+} /* stress_report() */
+
+
+/* stress_level()
+ *
+ * in:     rate   - rounds per second
+ *         rounds - number of rounds
+ * out:    apps, shared - tallied for the level
+ * return: nothing
+ *
+ * Runs rounds rounds on a fixed schedule of rate per second.  Each
+ * round commands a validation of every app's inactive table in one
+ * burst, except those of apps still busy with the last.
+ */
+
+static void
+stress_level(double rate, unsigned rounds) {
+
+	bool commanded[STRESS_MAX_APPS];
+	uint64 start, due;
+	unsigned r;
+	int a;
+
+	memset(&shared, 0, sizeof(shared));
+	for (a = 0; a < num_apps; a++) {
+		memset(&(apps[a].tally), 0, sizeof(apps[a].tally));
+		apps[a].num_latencies = 0;
+	}
+
+	cmd_set_throttle(false);
+	start = stress_now();
+	for (r = 0; r < rounds; r++) {
+		due = start + (uint64)(r * (1000000.0 / rate));
+		stress_pump(due, rate);
+
+		cmd_burst_begin();
+		for (a = 0; a < num_apps; a++) {
+			commanded[a] = !apps[a].pending;
+			if (apps[a].pending) {
+				apps[a].tally.busy++;
+				continue;
+			}
+			cmd_tbl_validate(apps[a].tbl_name,
+				CFE_TBL_BufferSelect_INACTIVE);
+			apps[a].tally.commanded++;
+			apps[a].pending = true;
+			apps[a].summary = false;
+		}
+		cmd_burst_end();
+
+		/* Time the validations from when they went out. */
+		for (a = 0; a < num_apps; a++) {
+			if (commanded[a]) apps[a].sent = stress_now();
+		}
+	}
+	cmd_set_throttle(true);
+
+	stress_settle(rate);
+	printf("STRS: %.1f/s, %u rounds in %.3f s.\n", rate, rounds,
+		(double)(stress_now() - start) / 1000000.0);
+	stress_report(rate, rounds);
+
+} /* stress_level() */
+
+
+/* ------------------- module exported functions ----------------------- */
+
+/* stress()
+ *
+ * in:     app_names - names of the apps to stress
+ *         count     - number of apps in app_names
+ *         rounds    - number of rounds per level
+ *         max_rate  - rounds per second of the last level, 0 for
+ *                     STRESS_MAX_RATE
+ * out:    nothing
+ * return: 0 if every verdict was the one expected, else -1
+ *
+ * Loads a valid image into every app's inactive table, then runs
+ * levels of rounds of validations of them, doubling the rate from
+ * STRESS_MIN_RATE up to max_rate.  Stops early once every app has
+ * fallen behind.  Reports each level's per-app validations and
+ * latencies and its lost events and SB overflows, and then the first
+ * rate at which each app, EVS, SB, and each pipe SB named gave out.
+ */
+
+int
+stress(const char *const *app_names, int count, unsigned rounds,
+	double max_rate) {
+
+	double rate;
+	bool falling;           /* is every app behind? */
+	bool wrong = false;
+	int a, p;
+
+	assert(count <= STRESS_MAX_APPS);
+	if (max_rate <= 0.0) max_rate = STRESS_MAX_RATE;
+	printf("STRS: %u rounds per level, up to %.1f per second.\n",
+		rounds, max_rate);
+
+	send_tlmon();
+	if (expect_tlmon_success()) return -1;
+
+	memset(apps, 0, sizeof(apps));
+	num_apps = count;
+	have_hk = have_sequence = false;
+	num_pipes = 0;
+	evs_behind = sb_behind = 0.0;
+
+	/* Each table's inactive buffer holds a valid image for the
+	 * whole test: validating it leaves it loaded.
+	 */
+	for (a = 0; a < num_apps; a++) {
+		apps[a].app_name = app_names[a];
+		snprintf(apps[a].tbl_name, sizeof(apps[a].tbl_name), "%s.%s",
+			app_names[a], VS_RAW_TABLE_NAME);
+		snprintf(apps[a].filename, sizeof(apps[a].filename),
+			"/cf/tbltest_%s_stress.tbl", app_names[a]);
+		file_set_filename(apps[a].filename);
+		file_init(apps[a].tbl_name, TABLE_DESCRIPTION);
+		file_set_entry(0, VS_PARM_BAT, 0x00,
+			VS_PARM_ANIMAL_MIN, VS_PARM_ANIMAL_MAX);
+		file_set_entry(1, VS_PARM_EAST, 0x00,
+			VS_PARM_DIRECTION_MIN, VS_PARM_DIRECTION_MAX);
+		file_output(file_host_filename());
+		cmd_tbl_load(file_filename());
+		if (expect_load_success(apps[a].tbl_name)) return -1;
+
+		apps[a].latencies = malloc((rounds + 1) * sizeof(uint64));
+		if (apps[a].latencies == NULL) {
+			perror("Failed to allocate stress latencies.");
+			exit(-1);
+		}
+	}
+
+	rate = ((max_rate < STRESS_MIN_RATE) ? max_rate : STRESS_MIN_RATE);
+	for (falling = false; (rate <= max_rate) && !falling; rate *= 2) {
+		stress_level(rate, rounds);
+		for (falling = true, a = 0; a < num_apps; a++) {
+			falling = (falling && (apps[a].behind != 0.0));
+			if (apps[a].tally.wrong) wrong = true;
+		}
+	}
+
+	for (a = 0; a < num_apps; a++) {
+		if (apps[a].behind != 0.0) {
+			printf("STRS: %s falls behind at %.1f/s.\n",
+				apps[a].app_name, apps[a].behind);
+		} else {
+			printf("STRS: %s keeps up at every rate tried.\n",
+				apps[a].app_name);
+		}
+		free(apps[a].latencies);
+	}
+	if (evs_behind != 0.0) {
+		printf("STRS: EVS loses events from %.1f/s.\n", evs_behind);
+	} else {
+		puts("STRS: EVS lost no events.");
+	}
+	if (sb_behind != 0.0) {
+		printf("STRS: SB pipes overflow from %.1f/s.\n", sb_behind);
+	} else {
+		puts("STRS: SB counted no pipe overflows.");
+	}
+	for (p = 0; p < num_pipes; p++) {
+		printf("STRS: pipe %s overflows from %.1f/s, %u events.\n",
+			pipes[p].name, pipes[p].rate, pipes[p].count);
+	}
+
+	if (wrong) {
+		puts("Stress test failed.");
+		return -1;
+	}
+	puts("Stress test passed.");
+	return 0;
+
+} /* stress() */
@@ -13,6 +13,9 @@
  * permissions and limitations under the License.
  */
 
+#include <stdlib.h>
+#include <time.h>
+
 #include "cfe.h"
 #include "cfe_evs_extern_typedefs.h"   /* for CFE_EVS_EventType_* enum */
 #include "to_lab_events.h"             /* for TO_LAB event IDs */
@@ -21,44 +24,186 @@
 #include "vs_tablestruct.h"            /* for raw table name */
 
 #include "mqueue.h"
+#include "capture.h"
 #include "cmd.h"
 #include "tlm.h"
 #include "expect.h"
+#include "perf.h"
+#include "latency.h"
 #include "deterministic.h"
+#include "file.h"
+#include "soak.h"
+#include "parallel.h"
+#include "pipeline.h"
+#include "stress.h"
+#include "trace.h"
+#include "tbltest.h"
+#include "vector.h"
 
 
 int
 main(int argc, char *argv[]) {
 
+	const char *app_name = VSA_APP_NAME;   /* test VSA by default */
+	uint32 app_perfid = VSA_VF_PERF_ID;
+	const char *tbl_name = VSA_APP_NAME "." VS_RAW_TABLE_NAME;
+	const char *all_apps[] = { VSA_APP_NAME, VSB_APP_NAME, VSC_APP_NAME };
+	bool all = false;                      /* test all apps at once? */
+	unsigned soak_count = 0;               /* 0 for deterministic tests */
+	double soak_rate = 0.0;                /* validations/sec, 0 for max */
+	unsigned soak_seed = (unsigned)time(NULL);
+	unsigned rounds = 0;                   /* pipeline rounds per table */
+	bool staged = false;                   /* STAGE pipeline rounds? */
+	unsigned stress_rounds = 0;            /* stress rounds per level */
+	unsigned long engine = 0;              /* VSC engine, 0 to leave it */
+	long trace = -1;                       /* --trace steps, -1 if none */
+	const char *capture = NULL;            /* --capture file, if any */
+	const char *replay = NULL;             /* --replay file, if any */
+	bool short_events = false;             /* EVS short format? */
+	unsigned long count;                   /* --repeat, --window */
+	char *end;                             /* for checking numeric args */
+	int i;                                 /* index into argv */
+
 	/* Warn about kernel POSIX message queue depth setting. */
 	warn_pipe_depth();
-	
-	/* Initialize our command and telemetry sockets. */
-	tlm_init();
-	cmd_init();
 
-	/* If there are no command-line arguments, run tests on VSA by
-	 * default.
+	/* Each command-line argument is either a flag that tells us
+	 * which app to test, a --csv or --json option naming a file
+	 * for the perf statistics, the --phases or --latency option,
+	 * one of the soak test options, the --pipeline or --staged
+	 * option, the --stress option, one of the test vector options,
+	 * the --engine option, the --tmpfs option, the --trace option,
+	 * the --short-events option, or the --capture or --replay
+	 * option.
 	 */
-	if (argc == 1)
-		return deterministic(VSA_APP_NAME, VSA_VF_PERF_ID,
-			VSA_APP_NAME "." VS_RAW_TABLE_NAME);
+	for (i = 1; i < argc; i++) {
+		if (!strcmp("--vsa", argv[i])) {
+			app_name   = VSA_APP_NAME;
+			app_perfid = VSA_VF_PERF_ID;
+			tbl_name   = VSA_APP_NAME "." VS_RAW_TABLE_NAME;
+		} else if (!strcmp("--vsb", argv[i])) {
+			app_name   = VSB_APP_NAME;
+			app_perfid = VSB_VF_PERF_ID;
+			tbl_name   = VSB_APP_NAME "." VS_RAW_TABLE_NAME;
+		} else if (!strcmp("--vsc", argv[i])) {
+			app_name   = VSC_APP_NAME;
+			app_perfid = VSC_VF_PERF_ID;
+			tbl_name   = VSC_APP_NAME "." VS_RAW_TABLE_NAME;
+		} else if (!strcmp("--all", argv[i])) {
+			all = true;
+		} else if (!strcmp("--csv", argv[i]) && ((i + 1) < argc)) {
+			perf_set_csv(argv[++i]);
+		} else if (!strcmp("--json", argv[i]) && ((i + 1) < argc)) {
+			perf_set_json(argv[++i]);
+		} else if (!strcmp("--phases", argv[i])) {
+			perf_set_phases(true);
+		} else if (!strcmp("--latency", argv[i])) {
+			latency_set(true);
+		} else if (!strcmp("--soak", argv[i]) && ((i + 1) < argc)) {
+			soak_count = (unsigned)strtoul(argv[++i], &end, 10);
+			if (*end || (soak_count == 0)) break;
+		} else if (!strcmp("--rate", argv[i]) && ((i + 1) < argc)) {
+			soak_rate = strtod(argv[++i], &end);
+			if (*end || (soak_rate <= 0.0)) break;
+		} else if (!strcmp("--seed", argv[i]) && ((i + 1) < argc)) {
+			soak_seed = (unsigned)strtoul(argv[++i], &end, 10);
+			if (*end) break;
+		} else if (!strcmp("--corpus", argv[i]) && ((i + 1) < argc)) {
+			soak_set_corpus(argv[++i]);
+		} else if (!strcmp("--pipeline", argv[i]) &&
+			((i + 1) < argc)) {
+			rounds = (unsigned)strtoul(argv[++i], &end, 10);
+			if (*end || (rounds == 0)) break;
+		} else if (!strcmp("--staged", argv[i])) {
+			staged = true;
+		} else if (!strcmp("--stress", argv[i]) && ((i + 1) < argc)) {
+			stress_rounds = (unsigned)strtoul(argv[++i], &end, 10);
+			if (*end || (stress_rounds == 0)) break;
+		} else if (!strcmp("--vectors", argv[i]) &&
+			((i + 1) < argc)) {
+			vector_set_filename(argv[++i]);
+		} else if (!strcmp("--pipelined", argv[i])) {
+			vector_set_pipelined(true);
+		} else if (!strcmp("--repeat", argv[i]) && ((i + 1) < argc)) {
+			count = strtoul(argv[++i], &end, 10);
+			if (*end || (count == 0)) break;
+			vector_set_repeat((unsigned)count);
+		} else if (!strcmp("--window", argv[i]) && ((i + 1) < argc)) {
+			count = strtoul(argv[++i], &end, 10);
+			if (*end) break;
+			vector_set_window((unsigned)count);
+		} else if (!strcmp("--engine", argv[i]) && ((i + 1) < argc)) {
+			engine = strtoul(argv[++i], &end, 10);
+			if (*end || (engine == 0) || (engine > 0xFF)) break;
+		} else if (!strcmp("--tmpfs", argv[i]) && ((i + 1) < argc)) {
+			file_set_staging(argv[++i]);
+		} else if (!strcmp("--trace", argv[i]) && ((i + 1) < argc)) {
+			trace = (long)strtoul(argv[++i], &end, 10);
+			if (*end || (trace > 0xFFFF)) break;
+		} else if (!strcmp("--capture", argv[i]) &&
+			((i + 1) < argc)) {
+			capture = argv[++i];
+		} else if (!strcmp("--replay", argv[i]) && ((i + 1) < argc)) {
+			replay = argv[++i];
+		} else if (!strcmp("--short-events", argv[i])) {
+			short_events = true;
+		} else {
+			break;
+		}
+	}
 
-	/* If there is one command-line argument, see if it is a flag
-	 * that tells us which app to test.  If it does, test that
-	 * app.
+	/* The parallel tests' children share the parent's telemetry
+	 * and commands, so they can't capture or replay their own.
 	 */
-	if (argc == 2) {
-		if (!strcmp("--vsa", argv[1])) {
-			return deterministic(VSA_APP_NAME, VSA_VF_PERF_ID,
-				VSA_APP_NAME "." VS_RAW_TABLE_NAME);
-		} else 		if (!strcmp("--vsb", argv[1])) {
-			return deterministic(VSB_APP_NAME, VSB_VF_PERF_ID,
-				VSB_APP_NAME "." VS_RAW_TABLE_NAME);
-		} else 		if (!strcmp("--vsc", argv[1])) {
-			return deterministic(VSC_APP_NAME, VSC_VF_PERF_ID,
-				VSC_APP_NAME "." VS_RAW_TABLE_NAME);
-		}
+	if ((capture && replay) || ((capture || replay) && all)) i = 0;
+
+	/* Only the deterministic tests can tell short-format events
+	 * apart without their text.  The others match TBL's events to
+	 * tables by the table names in it.
+	 */
+	if (short_events && (all || soak_count || rounds || stress_rounds))
+		i = 0;
+
+	/* Open the capture to write or replay, then initialize our
+	 * command and telemetry sockets.
+	 */
+	if ((i == argc) && capture) capture_open(capture);
+	if ((i == argc) && replay) capture_replay(replay);
+	if (i == argc) {
+		tlm_init();
+		cmd_init();
+	}
+
+	/* Switch VSC's validation engine before any tests begin. */
+	if ((i == argc) && engine) cmd_vsc_setengine((uint8)engine);
+
+	/* Replay VSC's Grunt trace instead of testing. */
+	if ((i == argc) && (trace >= 0)) return trace_replay((unsigned)trace);
+
+	if ((i == argc) && stress_rounds && !soak_count && !rounds) {
+		return (all ? stress(all_apps, 3, stress_rounds, soak_rate) :
+			stress(&app_name, 1, stress_rounds, soak_rate));
+	}
+	if ((i == argc) && rounds && !soak_count) {
+		return (all ? pipeline_test(all_apps, 3, rounds, staged) :
+			pipeline_test(&app_name, 1, rounds, staged));
+	}
+	if ((i == argc) && all && !soak_count && !stress_rounds)
+		return parallel();
+	if ((i == argc) && soak_count && !all && !rounds && !stress_rounds)
+		return soak(app_name, tbl_name, soak_count, soak_rate,
+			soak_seed);
+	if ((i == argc) && !all && !rounds && !stress_rounds) {
+		if (!short_events)
+			return deterministic(app_name, app_perfid, tbl_name);
+
+		/* Switch EVS to short format for the tests, and
+		 * back to long afterward for the runs that follow.
+		 */
+		cmd_evs_setformat(CFE_EVS_MsgFormat_SHORT);
+		i = deterministic(app_name, app_perfid, tbl_name);
+		cmd_evs_setformat(CFE_EVS_MsgFormat_LONG);
+		return i;
 	}
 
 	/* If we wind up here there was something wrong with the
@@ -77,6 +222,54 @@ main(int argc, char *argv[]) {
 	fprintf(stderr,"\ttbltest --vsc : "
 		"test %s TLM HK MID 0x%08X Perf ID 0x%08X\n",
 		VSC_APP_NAME, VSC_TLM_HK_MID, VSC_VF_PERF_ID);
+	fprintf(stderr,"\ttbltest --all : "
+		"test all three apps at once\n");
+	fprintf(stderr,"\t--csv FILE    : "
+		"also write perf statistics to FILE as CSV\n");
+	fprintf(stderr,"\t--json FILE   : "
+		"also write them to FILE for vs_bench_compare\n");
+	fprintf(stderr,"\t--phases      : "
+		"also time and break down each app's phases\n");
+	fprintf(stderr,"\t--latency     : "
+		"also trace each validation's latency, hop by hop\n");
+	fprintf(stderr,"\t--soak N      : "
+		"instead, run N random validations as a soak test\n");
+	fprintf(stderr,"\t--rate R      : "
+		"start soak validations, or end stress rounds, at R/sec\n");
+	fprintf(stderr,"\t--seed S      : "
+		"seed soak test images with S\n");
+	fprintf(stderr,"\t--corpus FILE : "
+		"draw soak test images from corpus FILE\n");
+	fprintf(stderr,"\t--pipeline N  : "
+		"instead, run N pipelined load-validate-activate rounds\n");
+	fprintf(stderr,"\t--staged      : "
+		"make each pipeline round one app STAGE command\n");
+	fprintf(stderr,"\t--stress N    : "
+		"instead, run N simultaneous validation rounds per rate\n");
+	fprintf(stderr,"\t--vectors FILE: "
+		"run the test vectors in FILE instead of %s\n",
+		VECTOR_FILENAME);
+	fprintf(stderr,"\t--pipelined   : "
+		"run the test vectors through the pipeline\n");
+	fprintf(stderr,"\t--repeat N    : "
+		"run the test vectors N times over\n");
+	fprintf(stderr,"\t--window N    : "
+		"time N test vectors per perf dump, 0 for all ES holds\n");
+	fprintf(stderr,"\t--engine E    : "
+		"first switch %s to VS_ENGINE_* engine E\n", VSC_APP_NAME);
+	fprintf(stderr,"\t--tmpfs DIR   : "
+		"stage table images in DIR, such as /dev/shm\n");
+	fprintf(stderr,"\t--trace N     : "
+		"instead, replay %s's last N Grunt steps, 0 for all\n",
+		VSC_APP_NAME);
+	fprintf(stderr,"\t--short-events: "
+		"run the deterministic tests with EVS in short format\n");
+	fprintf(stderr,"\t--capture FILE: "
+		"write the run's telemetry and commands to FILE\n");
+	fprintf(stderr,"\t--replay FILE : "
+		"replay capture FILE instead of testing the spacecraft\n");
+	fprintf(stderr,"\t(--capture and --replay don't combine with "
+		"each other or --all)\n");
 	return -1;
 	
 } /* main() */
@@ -19,5 +19,6 @@
 #define TABLE_DESCRIPTION "TBLTest-generated test values."
 #define TABLE_FILENAME    "/cf/tbltest_Prm.tbl"
 #define PATH_TO_CF        "../cpu1"
+#define VECTOR_FILENAME   "deterministic.vec"   /* seed test vectors */
 
 #endif
@@ -18,13 +18,22 @@
  * need to test cFS app table validation functions.
  */
 
+#define _GNU_SOURCE                                 /* for recvmmsg() */
+
 #include <sys/socket.h>
+#include <sys/eventfd.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <assert.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <time.h>
+#include <unistd.h>
 #include <stdio.h>
 
 #include "cfe.h"                             /* for CCSDS_PrimaryHeader_t */
@@ -37,6 +46,7 @@
 #include "cfe_evs_topicids.h" /* for EVS LONG and SHORT message topic IDs */
 #include "cfe_evs_msgids.h"                       /* for EVS HKTLM MSG ID */ 
 #include "cfe_es_msgids.h"                        /* for ES HK TLM MSG ID */
+#include "cfe_es_eventids.h"                          /* for ES event IDs */
 #include "cfe_sb_msgids.h"                        /* for SB HK TLM MSG ID */
 #include "cfe_tbl_msgids.h"                      /* for TBL HK TLM MSG ID */
 #include "cfe_time_msgids.h"                    /* for TIME HK TLM MSG ID */
@@ -44,9 +54,11 @@
 #include "to_lab_events.h"                        /* for TO_LAB event IDs */
 #include "sample_app_msgids.h"          /* for SAMPLE_APP HK TLM topic ID */
 #include "vs_eventids.h"                       /* for common VS event IDs */
+#include "vs_parmclass.h"                    /* for VS parm name numbers */
 #include "vs_ground.h"          /* for app names, topic IDs, and perf IDs */
 
 #include "common_constants.h"
+#include "capture.h"
 #include "tlm.h"
 
 #define TLM_ADDR "127.0.0.1"  /* Send telemetry to this address */
@@ -58,6 +70,15 @@
  */
 #define TLM_MSG_MAX_SIZE 1024
 
+/* A receiver thread drains the telemetry socket into a ring of this
+ * many message buffers, as many messages per recvmmsg() call as have
+ * arrived and will fit, while the main thread parses files, sleeps
+ * in perf_read_data(), or waits on its children.  The ring holds
+ * several seconds of the telemetry of a busy test, so the socket's
+ * own buffer needn't.  It must be a power of two; see ring_head.
+ */
+#define TLM_RING_SIZE 256
+
 /* CCSDS primary headers begin with a 16-bit field in network byte
  * order.  The lower TLM_TOPICID_MASK bits of that field describe the
  * "application ID" of the app or service that sent the event
@@ -90,6 +111,25 @@
  */
 #define DEBUG_DUMP_COLUMNS 8
 
+/* The VS apps' long-format table validation error events name the
+ * entry's parm and describe the problem in these words, indexed by
+ * VS_PARM_NAME_* and VS_TBL_ERR_BIT().  tlm_decode_evs() renders the
+ * same text for their short-format events.
+ */
+static const char *tlm_vs_parm_names[VS_PARM_NUM_NAMES] = {
+	"Invalid", "Unused", "Ape", "Bat", "Cat", "Dog",
+	"North", "South", "East", "West",
+#ifdef VS_PARM_WIDE_MIN
+	"Wide animal", "Wide direction",
+#endif
+};
+
+static const char *tlm_vs_problems[8] = {
+	"not zeroed", "invalid Parm ID", "padding not zeroed",
+	"invalid low bound", "invalid high bound", "invalid bound order",
+	"follows an unused entry", "redefines earlier entry"
+};
+
 
 /*
  *  -------- Module local state and local functions ---------
@@ -98,27 +138,198 @@
 static struct sockaddr_in tlm_addr;     /* receive telemetry from here */
 static int tlmfd;                       /* socket for receiving telemetry */
 
-/* This union is the buffer into which we will read telemetry
- * messages.  These messages come in many flavors with many sizes.
- * The byte array member exists solely to make sure the buffer is
- * large enough to contain the largest telemetry message we expect to
- * receive.  The ccsds member enables us to examine the fields of the
- * CCSDS header that is common to all message flavors without doing
- * array index math.  The other cFS/cFE structure type members are
- * there so that, once our examination of the CCSDS header has
- * revealed a message's specific flavor, we can examine its
- * flavor-specific fields.
- */
-static union {
+/* This union is a buffer into which we read a telemetry message.
+ * These messages come in many flavors with many sizes.  The byte
+ * array member exists solely to make sure the buffer is large enough
+ * to contain the largest telemetry message we expect to receive.  The
+ * ccsds member enables us to examine the fields of the CCSDS header
+ * that is common to all message flavors without doing array index
+ * math.  The other cFS/cFE structure type members are there so that,
+ * once our examination of the CCSDS header has revealed a message's
+ * specific flavor, we can examine its flavor-specific fields.
+ */
+typedef union {
 	char raw_bytes[TLM_MSG_MAX_SIZE];
-	CCSDS_PrimaryHeader_t  ccsds;
-	CFE_EVS_LongEventTlm_t evs_long;
-} tlm_msg;
+	CCSDS_PrimaryHeader_t     ccsds;
+	CFE_MSG_TelemetryHeader_t header;
+	CFE_EVS_LongEventTlm_t    evs_long;
+	CFE_EVS_ShortEventTlm_t   evs_short;
+} tlm_msg_t;
+
+/* The CCSDS primary header fields of a message, decoded to host
+ * byte order once, when tlm_arrived() checks the message, so that
+ * tlm_topicid(), tlm_sequence(), tlm_length(), and the tlm_evs_*()
+ * functions' asserts are plain loads however often callers ask.  For
+ * EVS events, it also holds the event ID and text, as
+ * tlm_decode_evs() decodes them from VS apps' short-format events.
+ */
+typedef struct {
+	tlm_topicid_t  topicid;
+	tlm_sequence_t sequence;
+	tlm_length_t   length;    /* true length, in bytes */
+	tlm_eventid_t  eventid;   /* EVS events' event ID */
+	bool           has_text;  /* false for short events we can't read */
+	const char    *message;   /* EVS events' text, "" if none */
+	char           text[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH];  /* decoded */
+} tlm_view_t;
+
+/* The ring holds the messages the receiver thread has received from
+ * the socket but our callers haven't yet.  It needs no lock: only the
+ * receiver thread advances ring_tail, and only the callers' thread
+ * advances ring_head, and each publishes its index with a release
+ * store that the other reads with an acquire load.  The indexes count
+ * messages rather than slots and wrap as unsigned ints do, so
+ * messages ring_head through ring_tail - 1 are waiting, in
+ * ring[index % TLM_RING_SIZE].  tlm_msg points to the latest message
+ * our callers have received, which is always the slot just before
+ * ring_head, so the receiver never uses that slot for new messages.
+ * ring_views[] holds each slot's decoded header, and tlm_view points
+ * to tlm_msg's.  Only the callers' thread touches them.  ring_usecs[]
+ * holds the capture_now() time each slot's message arrived, for
+ * capture files and tlm_arrival_usecs().
+ *
+ * The receiver thread adds to readyfd, an eventfd, each time it adds
+ * messages, so that callers can wait for them.
+ */
+static tlm_msg_t      ring[TLM_RING_SIZE];
+static struct iovec   ring_iovs[TLM_RING_SIZE];
+static struct mmsghdr ring_hdrs[TLM_RING_SIZE];
+static atomic_uint ring_head;           /* next message for callers */
+static atomic_uint ring_tail;           /* next message to receive */
+static unsigned    ring_checked;        /* next message to sanity check */
+static tlm_msg_t *tlm_msg = &(ring[TLM_RING_SIZE - 1]);
+static tlm_view_t  ring_views[TLM_RING_SIZE];
+static tlm_view_t *tlm_view = &(ring_views[TLM_RING_SIZE - 1]);
+static uint64      ring_usecs[TLM_RING_SIZE];
+static int readyfd;                     /* readable: messages arrived */
+static pthread_t receiver;              /* the receiver thread */
+
+
+/* tlm_select()
+ *
+ * in:     slot     - ring slot to make the latest message
+ * out:    tlm_msg  - points to the slot's message
+ *         tlm_view - points to the slot's decoded header
+ * return: nothing
+ */
+
+static void
+tlm_select(unsigned slot) {
+
+	tlm_msg  = &(ring[slot]);
+	tlm_view = &(ring_views[slot]);
+
+} /* tlm_select() */
+
+
+/* tlm_decode()
+ *
+ * in:     tlm_msg  - message to decode, latest message received
+ * out:    tlm_view - set to the message's header fields in host order
+ * return: nothing
+ *
+ * CCSDS header numbers are in network order aka big-endian.  The
+ * 16-bit length field under-counts by CCSDS_MSG_LENGTH_DELTA bytes;
+ * the view holds the true length.
+ */
+
+static void
+tlm_decode(void) {
+
+	const uint8 *p_stream   = tlm_msg->ccsds.StreamId;
+	const uint8 *p_sequence = tlm_msg->ccsds.Sequence;
+	const uint8 *p_length   = tlm_msg->ccsds.Length;
+
+	tlm_view->topicid  = (tlm_topicid_t)((((unsigned)p_stream[0] << 8) |
+		p_stream[1]) & TLM_TOPICID_MASK);
+	tlm_view->sequence = (tlm_sequence_t)((((unsigned)p_sequence[0] <<
+		8) | p_sequence[1]) & TLM_SEQUENCE_MASK);
+	tlm_view->length   = (tlm_length_t)((((unsigned)p_length[0] << 8) |
+		p_length[1]) + CCSDS_MSG_LENGTH_DELTA);
+
+} /* tlm_decode() */
+
+
+/* tlm_evs_packetid()
+ *
+ * in:     tlm_msg - latest received EVS telemetry message, long or short
+ * out:    nothing
+ * return: the message's packet ID, which both forms begin with.
+ */
+
+static const CFE_EVS_PacketID_t *
+tlm_evs_packetid(void) {
+
+	if (tlm_topicid() == CFE_MISSION_EVS_SHORT_EVENT_MSG_MSG)
+		return &(tlm_msg->evs_short.Payload.PacketID);
+	return &(tlm_msg->evs_long.Payload.PacketID);
+
+} /* tlm_evs_packetid() */
+
+
+/* tlm_decode_evs()
+ *
+ * in:     tlm_msg  - message to decode, latest message received
+ * out:    tlm_view - EVS event ID and text set, if an EVS event
+ * return: nothing
+ *
+ * Short-format EVS events carry no text.  VS apps built to send
+ * short-format table validation error events put everything their
+ * text would say in the event ID instead, as vs_eventids.h describes,
+ * so this function gives those events back the ID and text the apps'
+ * long-format ones have, from either form of EVS message.  Callers
+ * see the same events whichever the apps send and EVS's format mode.
+ * Other short-format events stay as they are, with no text.
+ */
+
+static void
+tlm_decode_evs(void) {
+
+	const CFE_EVS_PacketID_t *p_id;  /* the event's packet ID */
+	tlm_eventid_t eid;               /* its VS_TBL_*_ERR_EID */
+	unsigned name;                   /* its VS_PARM_NAME_* */
+
+	if (!tlm_is_evs()) return;
+
+	p_id = tlm_evs_packetid();
+	tlm_view->eventid  = p_id->EventID;
+	tlm_view->has_text =
+		(tlm_topicid() == CFE_MISSION_EVS_LONG_EVENT_MSG_MSG);
+	tlm_view->message  = (tlm_view->has_text ?
+		(const char *)tlm_msg->evs_long.Payload.Message : "");
+
+	if (!(p_id->EventID & VS_TBL_SHORT_FLAG) ||
+		(strcmp(p_id->AppName, VSA_APP_NAME) &&
+		 strcmp(p_id->AppName, VSB_APP_NAME) &&
+		 strcmp(p_id->AppName, VSC_APP_NAME)))
+		return;
+
+	/* Entries with invalid parm IDs have no parm to name. */
+	eid  = VS_TBL_SHORT_ERR_EID(p_id->EventID);
+	name = VS_TBL_SHORT_NAME(p_id->EventID);
+	if (eid == VS_TBL_PARM_ERR_EID) {
+		snprintf(tlm_view->text, sizeof(tlm_view->text),
+			"Table entry %u %s",
+			(unsigned)VS_TBL_SHORT_ENTRY(p_id->EventID),
+			tlm_vs_problems[VS_TBL_ERR_BIT(eid)]);
+	} else {
+		snprintf(tlm_view->text, sizeof(tlm_view->text),
+			"Table entry %u parm %s %s",
+			(unsigned)VS_TBL_SHORT_ENTRY(p_id->EventID),
+			tlm_vs_parm_names[(name < VS_PARM_NUM_NAMES) ?
+				name : VS_PARM_NAME_INVALID],
+			tlm_vs_problems[VS_TBL_ERR_BIT(eid)]);
+	}
+	tlm_view->eventid  = eid;
+	tlm_view->has_text = true;
+	tlm_view->message  = tlm_view->text;
+
+} /* tlm_decode_evs() */
 
 
 /* tlm_check_msg_generic()
  *
- * in:     rec_len - number of bytes read from socket into tlm_msg
+ * in:     rec_len - number of bytes read from socket into *tlm_msg
  *         tlm_msg - message to check, latest message received
  * out:    nothing
  * return: 0 if message passes all checks, else -1.
@@ -143,7 +354,7 @@ tlm_check_msg_generic(size_t rec_len) {
 	/* Fail if the message's length field indicates a length that
 	 * doesn't match the number of bytes we received.
 	 */
-	length = tlm_length();
+	length = tlm_view->length;
 	if (length != rec_len) {
 		fprintf(stderr, "Received message with length field %u "
 			"that doesn't match bytes received %lu\n",
@@ -154,19 +365,19 @@ tlm_check_msg_generic(size_t rec_len) {
 	/* We support only CCSDS version 1 messages.  Fail if the
 	 * received bytes don't look like one.
 	 */
-	if (CHECK(tlm_msg.ccsds.StreamId[0], VER_MASK, VER_VAL)) { 
+	if (CHECK(tlm_msg->ccsds.StreamId[0], VER_MASK, VER_VAL)) { 
 		fprintf(stderr,	"Received a non-CCSDS-ver-1 message.\n");
 		return -1;
 	}
 
 	/* Fail if this isn't a telemetry message. */
-	if (CHECK(tlm_msg.ccsds.StreamId[0], TLM_MASK, TLM_VAL)) {
+	if (CHECK(tlm_msg->ccsds.StreamId[0], TLM_MASK, TLM_VAL)) {
 		fprintf(stderr, "Received a non-telemetry message.\n");
 		return -1;
 	}
 
 	/* Fail if message doesn't have a secondary header. */
-	if (CHECK(tlm_msg.ccsds.StreamId[0], HDR_MASK, HDR_VAL)) {
+	if (CHECK(tlm_msg->ccsds.StreamId[0], HDR_MASK, HDR_VAL)) {
 		fprintf(stderr, "Received message without "
 			"a secondary header.\n");
 		return -1;
@@ -175,7 +386,7 @@ tlm_check_msg_generic(size_t rec_len) {
 	/* Fail if the message's fragmentation flag says it is
 	 * incomplete.
 	 */
-	if (CHECK(tlm_msg.ccsds.Sequence[0], FRG_MASK, FRG_VAL)) {
+	if (CHECK(tlm_msg->ccsds.Sequence[0], FRG_MASK, FRG_VAL)) {
 		fprintf(stderr, "Received message "
 			"without complete flag set.\n");
 		return -1;
@@ -187,25 +398,27 @@ tlm_check_msg_generic(size_t rec_len) {
 } /* tlm_check_msg_generic() */
 
 
-/* tlm_check_msg_evs_long()
+/* tlm_check_msg_evs()
  *
  * in:     tlm_msg - message to check, latest message received
  * out:    nothing
  * return: 0 if message passes all checks, else -1.
  *
  * This function implements sanity checks on fields specific to EVS
- * long-form telemetry messages (CFE_MISSION_EVS_LONG_EVENT_MSG_MSG).
+ * long-form and short-form telemetry messages
+ * (CFE_MISSION_EVS_LONG_EVENT_MSG_MSG and
+ * CFE_MISSION_EVS_SHORT_EVENT_MSG_MSG).
  */
 
 int
-tlm_check_msg_evs_long(void) {
+tlm_check_msg_evs(void) {
 
-	const char *appname = tlm_evs_appname();
-	const char *message = tlm_evs_message();
+	const char *appname = tlm_evs_packetid()->AppName;
 	
 	/* The payloads of topic ID CFE_MISSION_EVS_LONG_EVENT_MSG_MSG
 	 * messages contain two strings that *ought* to be
-	 * NUL-terminated.  It looks like
+	 * NUL-terminated, and those of short-form messages the first.
+	 * It looks like
 	 * cFE/modules/evs/fsw/src/cfe_evs_utils.c:EVS_GenerateEventTelemetry()
 	 * takes care to make sure this NUL termination always
 	 * happens, but it can't hurt to double-check here.
@@ -214,17 +427,19 @@ tlm_check_msg_evs_long(void) {
 	if (!memchr(appname, '\0', CFE_MISSION_MAX_API_LEN))
 		return -1;
 
-	if (!memchr(message, '\0', CFE_MISSION_EVS_MAX_MESSAGE_LENGTH))
+	if ((tlm_topicid() == CFE_MISSION_EVS_LONG_EVENT_MSG_MSG) &&
+		!memchr(tlm_msg->evs_long.Payload.Message, '\0',
+			CFE_MISSION_EVS_MAX_MESSAGE_LENGTH))
 		return -1;
 
 	return 0;
 
-} /* tlm_check_msg_evs_long() */
+} /* tlm_check_msg_evs() */
 
 
 /* tlm_check_msg_generic()
  *
- * in:     rec_len - number of bytes read from socket into tlm_msg
+ * in:     rec_len - number of bytes read from socket into *tlm_msg
  *         tlm_msg - message to check, latest message received
  * out:    nothing
  * return: 0 if message passes all checks, else -1.
@@ -249,8 +464,8 @@ tlm_check_msg(size_t rec_len) {
 		if (tlm_check_msg_generic(rec_len)) break;
 
 		/* Do further flavor-specific checks as needed. */
-		if (tlm_topicid() == CFE_MISSION_EVS_LONG_EVENT_MSG_MSG) {
-			if (tlm_check_msg_evs_long()) break;
+		if (tlm_is_evs()) {
+			if (tlm_check_msg_evs()) break;
 		}
 
 		/* All checks passed. */
@@ -263,7 +478,7 @@ tlm_check_msg(size_t rec_len) {
 	 */
 	for(i = 0; i < rec_len; i++) {
 		if (!(i % DEBUG_DUMP_COLUMNS)) printf("\n");
-		printf("%02X ", tlm_msg.raw_bytes[ i ]);
+		printf("%02X ", tlm_msg->raw_bytes[ i ]);
 	}
 	printf("\n");
 
@@ -272,6 +487,254 @@ tlm_check_msg(size_t rec_len) {
 } /* tlm_check_msg() */
 	
 
+/* tlm_receiver()
+ *
+ * in:     unused - nothing
+ *         tlmfd  - socket for receiving telemetry
+ *         ring   - messages received so far
+ * out:    ring   - messages added as they arrive
+ *         readyfd - added to each time messages are added
+ * return: never; exits the program if the socket fails.
+ *
+ * The receiver thread.  Waits for telemetry to arrive and adds as
+ * many messages as have arrived and will fit in the ring in one
+ * recvmmsg() call.  While the ring is full it leaves messages in the
+ * socket's buffer until callers make room.
+ */
+
+static void *
+tlm_receiver(void *unused) {
+
+	/* How long to wait for callers to make room in a full ring. */
+	static const struct timespec full_wait = { 0, 1000000 };
+	uint64_t one = 1;        /* add this to readyfd */
+	uint64 now;              /* when messages arrived */
+	unsigned head, tail;     /* ring indexes */
+	unsigned slot, room;     /* where and how many we can add */
+	int n, i;
+
+	(void)unused;
+	for (;;) {
+
+		/* Add after the last message in the ring, as far as
+		 * the end of the array or the slot holding the
+		 * callers' latest message, whichever comes first.
+		 */
+		head = atomic_load_explicit(&ring_head, memory_order_acquire);
+		tail = atomic_load_explicit(&ring_tail, memory_order_relaxed);
+		slot = tail % TLM_RING_SIZE;
+		room = TLM_RING_SIZE - 1 - (tail - head);
+		if (room > TLM_RING_SIZE - slot) room = TLM_RING_SIZE - slot;
+		if (room == 0) {
+			nanosleep(&full_wait, NULL);
+			continue;
+		}
+
+		n = recvmmsg(tlmfd, &(ring_hdrs[slot]), room,
+			MSG_WAITFORONE, NULL);
+		if (n == -1) {
+			if (errno == EINTR) continue;
+			perror("Failed to receive telemetry from spacecraft");
+			exit(-1);
+		}
+		now = capture_now();
+
+		/* If we receive a message longer than
+		 * TLM_MSG_MAX_SIZE, then that's a bug - we need to
+		 * increase that constant's value.
+		 */
+		for (i = 0; i < n; i++) {
+			assert(!(ring_hdrs[slot + i].msg_hdr.msg_flags &
+				MSG_TRUNC));
+			ring_usecs[slot + i] = now;
+		}
+
+		atomic_store_explicit(&ring_tail, tail + (unsigned)n,
+			memory_order_release);
+		if (-1 == write(readyfd, &one, sizeof(one))) {
+			perror("Failed to signal telemetry arrival");
+			exit(-1);
+		}
+	}
+	return NULL;
+
+} /* tlm_receiver() */
+
+
+/* tlm_start()
+ *
+ * in:     tlmfd   - socket for receiving telemetry
+ * out:    readyfd - set to a new eventfd
+ *         ring    - emptied
+ *         receiver - started, receiving from tlmfd into ring, unless
+ *                    we're replaying a capture
+ * return: nothing
+ */
+
+static void
+tlm_start(void) {
+
+	int i;
+
+	if (-1 == (readyfd = eventfd(0, EFD_NONBLOCK))) {
+		perror("Failed to create telemetry eventfd");
+		exit(-1);
+	}
+
+	for (i = 0; i < TLM_RING_SIZE; i++) {
+		ring_iovs[i].iov_base = ring[i].raw_bytes;
+		ring_iovs[i].iov_len  = TLM_MSG_MAX_SIZE;
+		ring_hdrs[i].msg_hdr.msg_iov    = &(ring_iovs[i]);
+		ring_hdrs[i].msg_hdr.msg_iovlen = 1;
+	}
+	atomic_store(&ring_head, 0);
+	atomic_store(&ring_tail, 0);
+	ring_checked = 0;
+	tlm_select(TLM_RING_SIZE - 1);
+
+	if (capture_replaying()) return;   /* tlm_replay() fills the ring */
+	if ((errno = pthread_create(&receiver, NULL, tlm_receiver, NULL))) {
+		perror("Failed to start telemetry receiver thread");
+		exit(-1);
+	}
+
+} /* tlm_start() */
+
+
+/* tlm_arrived()
+ *
+ * in:     ring    - messages received so far
+ * out:    nothing
+ * return: number of messages waiting in the ring.
+ *
+ * Runs some basic sanity checks on each message that has arrived
+ * since the last call to make sure its structure meets our
+ * expectations, and forces the program to exit if anything seems
+ * surprising.  Decodes each one's header first, a whole burst in one
+ * pass, and the event ID and text of each EVS event that passes.
+ * The checks run here on the callers' thread, where tlm_msg
+ * and tlm_view are theirs to repoint.  When capturing, writes each
+ * message to the capture file first, as it arrived.
+ */
+
+static unsigned
+tlm_arrived(void) {
+
+	tlm_msg_t  *latest      = tlm_msg;   /* callers' latest message */
+	tlm_view_t *latest_view = tlm_view;  /* and its decoded header */
+	unsigned tail, slot;
+
+	tail = atomic_load_explicit(&ring_tail, memory_order_acquire);
+	for (; ring_checked != tail; ring_checked++) {
+		slot = ring_checked % TLM_RING_SIZE;
+		capture_write(CAPTURE_TLM, ring_usecs[slot],
+			ring[slot].raw_bytes, ring_hdrs[slot].msg_len);
+		tlm_select(slot);
+		tlm_decode();
+		if (tlm_check_msg(ring_hdrs[slot].msg_len)) exit(-1);
+		tlm_decode_evs();
+	}
+	tlm_msg  = latest;
+	tlm_view = latest_view;
+	return tail - atomic_load_explicit(&ring_head, memory_order_relaxed);
+
+} /* tlm_arrived() */
+
+
+/* tlm_replay()
+ *
+ * in:     msecs   - how long to wait for telemetry if none has arrived
+ *                   by the capture's virtual clock; 0 means don't
+ *                   wait, -1 means wait forever
+ *         ring    - messages replayed so far
+ * out:    ring    - messages added from the capture, as many as have
+ *                   arrived by the virtual clock and will fit
+ * return: nothing; exits the program if the capture holds a message
+ *         too long for the ring.
+ *
+ * The receiver thread's job when replaying.  Waits only if the ring
+ * is empty, as the receiver thread's callers do.
+ */
+
+static void
+tlm_replay(int msecs) {
+
+	const void *bytes;
+	unsigned head, tail, slot;
+	size_t len;
+
+	head = atomic_load_explicit(&ring_head, memory_order_relaxed);
+	tail = atomic_load_explicit(&ring_tail, memory_order_relaxed);
+	if (tail != head) msecs = 0;
+
+	for (; (tail - head) < TLM_RING_SIZE - 1; tail++, msecs = 0) {
+		if (NULL == (bytes = capture_next(CAPTURE_TLM, msecs, &len)))
+			break;
+		if (len > TLM_MSG_MAX_SIZE) {
+			fprintf(stderr, "Capture holds a %lu-byte telemetry "
+				"message.\n", (unsigned long)len);
+			exit(-1);
+		}
+		slot = tail % TLM_RING_SIZE;
+		memcpy(ring[slot].raw_bytes, bytes, len);
+		ring_hdrs[slot].msg_len = (unsigned)len;
+		ring_usecs[slot] = capture_now();
+	}
+	atomic_store_explicit(&ring_tail, tail, memory_order_release);
+
+} /* tlm_replay() */
+
+
+/* tlm_wait()
+ *
+ * in:     msecs   - how long to wait for telemetry if none has arrived;
+ *                   0 means don't wait, -1 means wait forever
+ *         ring    - messages received so far
+ * out:    readyfd - cleared if we found the ring empty
+ * return: number of messages waiting in the ring.
+ */
+
+static unsigned
+tlm_wait(int msecs) {
+
+	struct pollfd fd = { 0 };
+	uint64_t count;           /* readyfd's count, unused */
+	unsigned n;
+	int ready;
+
+	if (capture_replaying()) {
+		tlm_replay(msecs);
+		return tlm_arrived();
+	}
+
+	fd.fd     = readyfd;
+	fd.events = POLLIN;
+	for (;;) {
+		if ((n = tlm_arrived())) return n;
+
+		/* Clear readyfd and look again, so that we neither
+		 * sleep through messages that arrived in between nor
+		 * leave readyfd readable for tlm_socket() pollers
+		 * with the ring empty.
+		 */
+		if ((-1 == read(readyfd, &count, sizeof(count))) &&
+			(errno != EAGAIN)) {
+			perror("Failed to clear telemetry eventfd");
+			exit(-1);
+		}
+		if ((n = tlm_arrived()) || (msecs == 0)) return n;
+
+		if (-1 == (ready = poll(&fd, 1, msecs))) {
+			if (errno == EINTR) continue;
+			perror("Failed to wait for telemetry from spacecraft");
+			exit(-1);
+		}
+		if (ready == 0) return 0;   /* timed out */
+	}
+
+} /* tlm_wait() */
+
+
 /*
  *  -------- Functions exported by this module ---------
  */
@@ -281,10 +744,12 @@ tlm_check_msg(size_t rec_len) {
  * in:     nothing
  * out:    tlm_addr - set to address at which we will receive telemetry
  *         tlmfd   - set to port at which we will receive telemetry
+ *         receiver - started, receiving from tlmfd
  * return: nothing
  *
- * Open the socket for receiving telemetry.  For telemetry, we act as
- * the "server" and the spacecraft acts as the "client".
+ * Open the socket for receiving telemetry and start the receiver
+ * thread.  For telemetry, we act as the "server" and the spacecraft
+ * acts as the "client".  When replaying a capture, there's neither.
  *
  * Call this function before calling any of this module's other
  * functions.
@@ -293,6 +758,11 @@ tlm_check_msg(size_t rec_len) {
 void
 tlm_init(void) {
 
+	if (capture_replaying()) {
+		tlm_start();
+		return;
+	}
+
 	/* Create IP/UDP socket for receiving telemetry.  For
 	 * telemetry, I am the server and the spacecraft is the
 	 * client.
@@ -310,45 +780,181 @@ tlm_init(void) {
 		perror("Failed to bind to telemetry port");
 		exit(-1);
 	}
+	tlm_start();
 	
 } /* tlm_init() */
 
 
+/* tlm_receive_timeout()
+ *
+ * in:     msecs   - how long to wait for telemetry; 0 means don't
+ *                   wait, -1 means wait forever
+ *         ring    - messages received but not yet seen by callers
+ * out:    tlm_msg - will point to the next message, if any, and
+ *                   tlm_view to its decoded header
+ *         ring    - that message consumed
+ * return: 0 if there's a next message, -1 if msecs passed without one.
+ *
+ * Makes the next telemetry message the latest received.  Takes it
+ * from the ring, waiting up to msecs for the receiver thread to put
+ * one there if there's none there yet.
+ */
+
+int
+tlm_receive_timeout(int msecs) {
+
+	unsigned head;
+
+	if (tlm_wait(msecs) == 0) return -1;
+
+	head = atomic_load_explicit(&ring_head, memory_order_relaxed);
+	tlm_select(head % TLM_RING_SIZE);
+	atomic_store_explicit(&ring_head, head + 1, memory_order_release);
+	return 0;
+
+} /* tlm_receive_timeout() */
+
+
 /* tlm_receive()
  *
  * in:     tlmfd   - file descriptor to open socket for receiving telemetry
- * out:    tlmfd   - will read next message from socket, consuming it
- *         tlm_msg - will write message to this buffer
+ * out:    tlm_msg - will point to next message
  * return: nothing
  *
- * Receives next telemetry message and stores it.  Runs some basic
- * sanity checks on the received message to make sure its structure
- * meets our expectations and forces the program to exit if anything
- * seems surprising.
- *
+ * Receives next telemetry message, waiting for it as long as it
+ * takes.
  */
    
 void
 tlm_receive(void) {
 
-	size_t rec_len;      /* msg size according to recv() */
-	
-	/* Receive byes from spacecraft. */
-	if (-1 == (rec_len = recv(tlmfd, tlm_msg.raw_bytes, TLM_MSG_MAX_SIZE,
-		0x00))) {
-		perror("Failed to receive telemetry from spacecraft");
-		exit(-1);
+	(void)tlm_receive_timeout(-1);
+
+} /* tlm_receive() */
+
+
+/* tlm_buffered()
+ *
+ * in:     ring  - messages received but not yet seen by callers
+ * out:    nothing
+ * return: number of messages tlm_receive_timeout(0) will return
+ *         without blocking.
+ *
+ * For callers that poll() tlm_socket(): messages may be waiting in
+ * the ring even when tlm_socket() isn't readable.
+ */
+
+int
+tlm_buffered(void) {
+
+	return (int)tlm_wait(0);
+
+} /* tlm_buffered() */
+
+
+/* tlm_buffered_evs()
+ *
+ * in:     appname, eventtype, eventid, message - the fields of the
+ *         EVS message to look for
+ *         ring    - messages received but not yet seen by callers
+ * out:    nothing
+ * return: true if a matching message is waiting in the ring.
+ *
+ * Lets callers that give up after some number of messages see
+ * whether the message they want has in fact already arrived.  As
+ * expect_matches() does, it matches short-format events that carry
+ * no text on the other fields alone.
+ */
+
+bool
+tlm_buffered_evs(const char *appname, tlm_eventtype_t eventtype,
+	tlm_eventid_t eventid, const char *message) {
+
+	tlm_msg_t  *latest      = tlm_msg;   /* callers' latest message */
+	tlm_view_t *latest_view = tlm_view;  /* and its decoded header */
+	unsigned head = atomic_load_explicit(&ring_head, memory_order_relaxed);
+	unsigned count = tlm_wait(0);
+	bool found = false;
+	unsigned i;
+
+	for (i = 0; (i < count) && !found; i++) {
+		tlm_select((head + i) % TLM_RING_SIZE);
+		found = (tlm_is_evs() &&
+			(!strcmp(tlm_evs_appname(), appname)) &&
+			(tlm_evs_eventtype() == eventtype) &&
+			(tlm_evs_eventid() == eventid) &&
+			(!tlm_evs_has_text() ||
+			 !strcmp(tlm_evs_message(), message)));
 	}
+	tlm_msg  = latest;
+	tlm_view = latest_view;
+	return found;
 
-	/* If we receive a message longer than TLM_MSG_MAX_SIZE, then
-	 * that's a bug - we need to increase that constant's value.
-	 */
-	assert(rec_len <= TLM_MSG_MAX_SIZE);
-	
-	/* Check to make sure this is a message we can handle. */
-	if (tlm_check_msg(rec_len)) exit(-1);
+} /* tlm_buffered_evs() */
 
-} /* tlm_receive() */
+
+/* tlm_socket()
+ *
+ * in:     readyfd - eventfd the receiver thread adds to
+ * out:    nothing
+ * return: readyfd.
+ *
+ * For callers that need to poll() for telemetry alongside other file
+ * descriptors before calling tlm_receive().  The receiver thread
+ * drains the socket itself, so what callers poll is an eventfd that
+ * becomes readable when messages arrive.  Such callers should check
+ * tlm_buffered() first; that also clears the eventfd once the ring
+ * is empty.
+ */
+
+int
+tlm_socket(void) {
+
+	return readyfd;
+
+} /* tlm_socket() */
+
+
+/* tlm_set_socket()
+ *
+ * in:     fd      - socket to receive telemetry from instead
+ * out:    tlmfd   - closed and replaced with fd
+ *         readyfd - replaced with a new eventfd
+ *         ring    - emptied
+ *         receiver - a new receiver thread, receiving from fd
+ * return: nothing
+ *
+ * For tests that run in a child process and receive their share of
+ * the telemetry from a parent rather than straight from TO_LAB.  Call
+ * it in the child just after fork(), which leaves the child with no
+ * receiver thread, and with an eventfd it shares with its parent.
+ * The child gets new ones of its own.
+ */
+
+void
+tlm_set_socket(int fd) {
+
+	close(readyfd);
+	close(tlmfd);
+	tlmfd = fd;
+	tlm_start();
+
+} /* tlm_set_socket() */
+
+
+/* tlm_bytes()
+ *
+ * in:     tlm_msg - latest received telemetry message
+ * out:    nothing
+ * return: the message's bytes; tlm_length() says how many.
+ */
+
+const void *
+tlm_bytes(void) {
+
+	return tlm_msg->raw_bytes;
+
+} /* tlm_bytes() */
 
 
 /* tlm_topicid()
@@ -368,17 +974,32 @@ tlm_topicid_t
 tlm_topicid(void) {
 
 	/* The header has a 16-bit field whose lower TLM_TOPICID_MASK
-	 * bits contain the topic ID in network (big endian) order.
+	 * bits contain the topic ID; tlm_decode() extracted them.
 	 */
-	unsigned short topicid_no =
-		*((unsigned short *)tlm_msg.ccsds.StreamId);
-
-	/* CCSDS header numbers are in network order aka big-endian. */
-	return (ntohs(topicid_no) & TLM_TOPICID_MASK);
+	return tlm_view->topicid;
 
 } /* tlm_topicid() */
 	
 
+/* tlm_sequence()
+ *
+ * in:     tlm_msg - latest received telemetry message
+ * out:    nothing
+ * return: telemetry message sequence count.
+ *
+ * SB counts the messages it sends on each message ID.  A gap between
+ * the counts of two successive messages with the same topic ID means
+ * the messages between them were lost along the way.
+ */
+
+tlm_sequence_t
+tlm_sequence(void) {
+
+	return tlm_view->sequence;
+
+} /* tlm_sequence() */
+
+
 /* tlm_length()
  *
  * in:     tlm_msg - latest received telemetry message
@@ -392,118 +1013,190 @@ tlm_topicid(void) {
 tlm_length_t
 tlm_length(void) {
 
-	/* The header has a 16-bit length field.  Its value is in
-	 * network order (big-endian) and under-counts by
-	 * CCSDS_MSG_LENGTH_DELTA bytes.
+	/* The header's 16-bit length field under-counts by
+	 * CCSDS_MSG_LENGTH_DELTA bytes; tlm_decode() corrected it.
 	 */
-	unsigned short length_no = *((unsigned short *)tlm_msg.ccsds.Length);
+	return tlm_view->length;
 
-	/* CCSDS header numbers are in network order aka big-endian. */
-	/* Report the true length in host order. */
-	return (ntohs(length_no) + CCSDS_MSG_LENGTH_DELTA);
-	
 } /* tlm_length() */
 
 
+/* tlm_arrival_usecs()
+ *
+ * in:     tlm_msg    - latest received telemetry message
+ *         ring_usecs - when each slot's message arrived
+ * out:    nothing
+ * return: the capture_now() time the receiver thread received it.
+ */
+
+uint64
+tlm_arrival_usecs(void) {
+
+	return ring_usecs[tlm_msg - ring];
+
+} /* tlm_arrival_usecs() */
+
+
+/* tlm_time_usecs()
+ *
+ * in:     tlm_msg - latest received telemetry message
+ * out:    nothing
+ * return: the spacecraft time in its secondary header, in usecs.
+ *
+ * Apps and services stamp each message with the spacecraft time as
+ * they send it; EVS stamps each event.
+ * The cFE's default secondary header holds that time as 32 bits of
+ * seconds and the upper 16 bits of its 32-bit subseconds, both
+ * big-endian, so it resolves about 15 usecs.
+ */
+
+uint64
+tlm_time_usecs(void) {
+
+	const uint8 *p_time = tlm_msg->header.Sec.Time;
+	uint32 seconds, subsecs;
+
+	seconds = ((uint32)p_time[0] << 24) | ((uint32)p_time[1] << 16) |
+		((uint32)p_time[2] << 8) | (uint32)p_time[3];
+	subsecs = ((uint32)p_time[4] << 8) | (uint32)p_time[5];
+	return ((uint64)seconds * 1000000) +
+		(((uint64)subsecs * 1000000) >> 16);
+
+} /* tlm_time_usecs() */
+
+
+/* tlm_is_evs()
+ *
+ * in:     tlm_msg - latest received telemetry message
+ * out:    nothing
+ * return: true if the message is an EVS event, long-form or short.
+ *
+ * Callers must confirm this before calling the tlm_evs_*() functions.
+ */
+
+bool
+tlm_is_evs(void) {
+
+	return ((tlm_topicid() == CFE_MISSION_EVS_LONG_EVENT_MSG_MSG) ||
+		(tlm_topicid() == CFE_MISSION_EVS_SHORT_EVENT_MSG_MSG));
+
+} /* tlm_is_evs() */
+
+
+/* tlm_evs_has_text()
+ *
+ * in:     tlm_msg - latest received *EVS* telemetry message
+ * out:    nothing
+ * return: true if the event has message text.
+ *
+ * Long-form events always do.  Short-form ones do only if they are
+ * VS apps' table validation error events, whose text
+ * tlm_decode_evs() renders from their event IDs.  For the rest,
+ * tlm_evs_message() returns "".
+ */
+
+bool
+tlm_evs_has_text(void) {
+
+	assert(tlm_is_evs());
+	return tlm_view->has_text;
+
+} /* tlm_evs_has_text() */
+
+
 /* tlm_evs_appname()
  *
- * in:     tlm_msg - latest received *EVS long-form* telemetry message
+ * in:     tlm_msg - latest received *EVS* telemetry message
  * out:    nothing
  * return: application name string
  *
  * This function returns the application name string from EVS
- * long-form telemetry message payloads.
+ * long-form and short-form telemetry message payloads.
  */
 
 const char *
 tlm_evs_appname(void) {
 
-	CFE_EVS_LongEventTlm_Payload_t *p_payload = &tlm_msg.evs_long.Payload;
-
-	/* Callers should have already confirmed that this is a
-	 * long-form EVS telemetry messages.  Anything else is a bug.
+	/* Callers should have already confirmed that this is an EVS
+	 * telemetry message.  Anything else is a bug.
 	 */
-	assert(tlm_topicid() == CFE_MISSION_EVS_LONG_EVENT_MSG_MSG);
+	assert(tlm_is_evs());
 
 	/* Return a pointer to the AppName string. */
-	return p_payload->PacketID.AppName;
+	return tlm_evs_packetid()->AppName;
 	
 } /* tlm_evs_appname() */
 
 
 /* tlm_evs_eventid()
  *
- * in:     tlm_msg - latest received *EVS long-form* telemetry message
+ * in:     tlm_msg - latest received *EVS* telemetry message
  * out:    nothing
  * return: event ID
  *
- * This function returns the Event ID from EVS long-form telemetry
- * message payloads.
+ * This function returns the Event ID from EVS long-form and
+ * short-form telemetry message payloads, as tlm_decode_evs() decoded
+ * it.  For VS apps' short-form table validation error events, that
+ * is the VS_TBL_*_ERR_EID their long-form events would have.
  */
 
 tlm_eventid_t
 tlm_evs_eventid(void) {
 
-	CFE_EVS_LongEventTlm_Payload_t *p_payload = &tlm_msg.evs_long.Payload;
-
-	/* Callers should have already confirmed that this is a
-	 * long-form EVS telemetry messages.  Anything else is a bug.
+	/* Callers should have already confirmed that this is an EVS
+	 * telemetry message.  Anything else is a bug.
 	 */
-	assert(tlm_topicid() == CFE_MISSION_EVS_LONG_EVENT_MSG_MSG);
+	assert(tlm_is_evs());
 
-	/* CFE_EVS_PacketID_t numbers are in host byte order. */
-	return p_payload->PacketID.EventID;
+	return tlm_view->eventid;
 
 } /* tlm_evs_eventid() */
 
 
 /* tlm_evs_eventtype()
  *
- * in:     tlm_msg - latest received *EVS long-form* telemetry message
+ * in:     tlm_msg - latest received *EVS* telemetry message
  * out:    nothing
  * return: event type
  *
- * This function returns the Event Type from EVS long-form telemetry
- * message payloads.
+ * This function returns the Event Type from EVS long-form and
+ * short-form telemetry message payloads.
  */
 
 tlm_eventtype_t
 tlm_evs_eventtype(void) {
 
-	CFE_EVS_LongEventTlm_Payload_t *p_payload = &tlm_msg.evs_long.Payload;
-
-	/* Callers should have already confirmed that this is a
-	 * long-form EVS telemetry messages.  Anything else is a bug.
+	/* Callers should have already confirmed that this is an EVS
+	 * telemetry message.  Anything else is a bug.
 	 */
-	assert(tlm_topicid() == CFE_MISSION_EVS_LONG_EVENT_MSG_MSG);
+	assert(tlm_is_evs());
 
 	/* CFE_EVS_PacketID_t numbers are in host byte order. */
-	return (tlm_eventtype_t)(p_payload->PacketID.EventType);
+	return (tlm_eventtype_t)(tlm_evs_packetid()->EventType);
 
 } /* tlm_evs_eventtype() */
 
 
 /* tlm_evs_message()
  *
- * in:     tlm_msg - latest received *EVS long-form* telemetry message
+ * in:     tlm_msg - latest received *EVS* telemetry message
  * out:    nothing
  * return: message string
  *
  * This function returns the message string from EVS long-form
- * telemetry message payloads.
+ * telemetry message payloads, or the text tlm_decode_evs() rendered
+ * for a short-form one, "" if it has none.
  */
 
 const char *
 tlm_evs_message(void) {
 
-	CFE_EVS_LongEventTlm_Payload_t *p_payload = &tlm_msg.evs_long.Payload;
-
-	/* Callers should have already confirmed that this is a
-	 * long-form EVS telemetry messages.  Anything else is a bug.
+	/* Callers should have already confirmed that this is an EVS
+	 * telemetry message.  Anything else is a bug.
 	 */
-	assert(tlm_topicid() == CFE_MISSION_EVS_LONG_EVENT_MSG_MSG);
+	assert(tlm_is_evs());
 
-	return (const char *)p_payload->Message;
+	return tlm_view->message;
 
 } /* tlm_evs_message() */
 
@@ -544,10 +1237,18 @@ tlm_topicid_to_string(tlm_topicid_t topicid) {
 		return "Telemetry Output (TO, TO_LAB) housekeeping";
 	case (VSA_TLM_HK_MID & 0xFF):
 		return "V-SPELLS App Alpha (VSA) housekeeping";
+	case (VSA_TLM_REPORT_MID & 0xFF):
+		return "V-SPELLS App Alpha (VSA) validation report";
 	case (VSB_TLM_HK_MID & 0xFF):
 		return "V-SPELLS App Bravo (VSB) housekeeping";
 	case (VSC_TLM_HK_MID & 0xFF):
 		return "V-SPELLS App Charlie (VSC) housekeeping";
+	case (VSC_TLM_REPORT_MID & 0xFF):
+		return "V-SPELLS App Charlie (VSC) validation report";
+	case (VSC_TLM_PROFILE_MID & 0xFF):
+		return "V-SPELLS App Charlie (VSC) Grunt profile";
+	case (VSC_TLM_TRACE_MID & 0xFF):
+		return "V-SPELLS App Charlie (VSC) Grunt trace";
 	default:
 		return "Unknown topic ID";
 	}
@@ -572,7 +1273,11 @@ tlm_topicid_to_string(tlm_topicid_t topicid) {
 const char *
 tlm_eventid_to_string(const char *app_name, tlm_eventid_t eventid) {
 
-	if (!strcmp(app_name, TLM_NAME_TBL)) {
+	if (!strcmp(app_name, TLM_NAME_ES)) {
+		switch (eventid) {
+		case CFE_ES_PERF_DATAWRITTEN_EID: return "PDUMP";
+		}
+	} else if (!strcmp(app_name, TLM_NAME_TBL)) {
 		switch (eventid) {
 		case CFE_TBL_UPDATE_SUCCESS_INF_EID: return "ACTOK";
 		case CFE_TBL_UPDATE_ERR_EID:         return "ACTER";
@@ -599,9 +1304,12 @@ tlm_eventid_to_string(const char *app_name, tlm_eventid_t eventid) {
 		case VS_CMD_RESET_INF_EID:   return "RESET";
 		case VS_STARTUP_OK_INF_EID:  return "START";
 		case VS_VALIDATION_INF_EID:  return "VINFO";
+		case VS_ENGINE_INF_EID:      return "ENGIN";
+		case VS_STAGE_INF_EID:       return "STAGE";
 		case VS_MSG_BAD_CC_ERR_EID:  return "BADCC";
 		case VS_MSG_BAD_MID_ERR_EID: return "BADMD";
 		case VS_PIPE_ERR_EID:        return "PIPER";
+		case VS_STAGE_ERR_EID:       return "STGER";
 		case VS_TBL_ZERO_ERR_EID:    return "ZEROS";
 		case VS_TBL_PARM_ERR_EID:    return "EPARM";
 		case VS_TBL_PAD_ERR_EID:     return "PADER";
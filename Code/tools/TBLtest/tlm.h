@@ -25,20 +25,41 @@
  * run on a particular CPU defines them.  We can't include headers to
  * get these names, so here are defines for some common ones.
  */
+#define TLM_NAME_ES   "CFE_ES"     /* ES, the Executive Services service */
+#define TLM_NAME_SB   "CFE_SB"     /* SB, the Software Bus service */
 #define TLM_NAME_TBL  "CFE_TBL"    /* TBL, the Table Services service */
 #define TLM_NAME_TIME "CFE_TIME"   /* TIME, the Time Service */
 #define TLM_NAME_TO   "TO_LAB_APP" /* TO/TO_LAB, Telemetry Output Service */
 
 /* Typedefs for various kinds of telemetry ("TLM") message fields */
+/* The lower TLM_SEQUENCE_MASK bits of the CCSDS primary header's
+ * second 16-bit field count the messages sent on each message ID,
+ * wrapping at 2^14.
+ */
+#define TLM_SEQUENCE_MASK 0x3FFF
+
 typedef unsigned short tlm_topicid_t;          /* TLM msg topic or "flavor" */
 typedef unsigned short tlm_length_t;                  /* length of TLM msgs */
+typedef unsigned short tlm_sequence_t;        /* TLM msg count per topic ID */
 typedef unsigned short tlm_eventid_t;              /* app-specific event ID */
 typedef enum CFE_EVS_EventType tlm_eventtype_t;  /* INFO, ERROR, DEBUG, etc */
 
 void            tlm_init(void);
 void            tlm_receive(void);
+int             tlm_receive_timeout(int);
+int             tlm_buffered(void);
+bool            tlm_buffered_evs(const char *, tlm_eventtype_t,
+                                 tlm_eventid_t, const char *);
+int             tlm_socket(void);
+void            tlm_set_socket(int);
+const void *    tlm_bytes(void);
 tlm_topicid_t   tlm_topicid(void);
+tlm_sequence_t  tlm_sequence(void);
 tlm_length_t    tlm_length(void);
+uint64          tlm_arrival_usecs(void);
+uint64          tlm_time_usecs(void);
+bool            tlm_is_evs(void);
+bool            tlm_evs_has_text(void);
 const char *    tlm_evs_appname(void);
 tlm_eventid_t   tlm_evs_eventid(void);
 tlm_eventtype_t tlm_evs_eventtype(void);
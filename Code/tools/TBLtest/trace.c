@@ -0,0 +1,235 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This file replays the Grunt execution trace of a VSC built with
+ * the Grunt library's GRUNT_TRACE option.  It sends VSC the
+ * VSC_DUMP_TRACE_CC command, gathers the series of VSC_TLM_TRACE_MID
+ * messages VSC answers with, and prints the steps they hold, oldest
+ * first: each instruction's pc, opcode, and the arg stack's top as it
+ * began, with each run's end and status.  The runs that ended in an
+ * error give their fault paths.  It then prints the pcs that ran
+ * most often in the trace, the hot path of the validations it
+ * covers.  TO_LAB must forward VSC_TLM_TRACE_MID.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "cfe.h"
+#include "vs_ground.h"                 /* for VSC_TLM_TRACE_MID */
+#include "vs_msgstruct.h"              /* for vsc_msgstruct.h */
+#include "vsc_msgstruct.h"             /* for VSC_tlm_trace_t */
+
+#include "grunt.h"                     /* for GRUNT_OP_* opcodes */
+#include "grunt_status.h"              /* for GRUNT_HALT_* statuses */
+
+#include "cmd.h"
+#include "tlm.h"
+#include "trace.h"
+
+
+/* ------------- module local definitions and functions ------------ */
+
+/* How long we wait for each trace message before giving up. */
+#define TRACE_TIMEOUT 5000   /* msecs */
+
+/* The most steps the 255 messages a series can have may hold. */
+#define TRACE_MAX_STEPS (255 * VSC_TRACE_STEPS_PER_MSG)
+
+/* The number of hottest pcs we report. */
+#define TRACE_HOT_PCS 10
+
+static VSC_trace_step_t steps[TRACE_MAX_STEPS];  /* the dump, in order */
+static unsigned pc_count[GRUNT_PC_MAX + 1];     /* steps at each pc */
+
+static const char *op_names[] = {
+	[GRUNT_OP_ADD]    = "ADD",    [GRUNT_OP_AND]      = "AND",
+	[GRUNT_OP_CALL]   = "CALL",   [GRUNT_OP_DUP]      = "DUP",
+	[GRUNT_OP_EQ]     = "EQ",     [GRUNT_OP_FLUSH]    = "FLUSH",
+	[GRUNT_OP_GT]     = "GT",     [GRUNT_OP_HALT]     = "HALT",
+	[GRUNT_OP_JMPIF]  = "JMPIF",  [GRUNT_OP_LT]       = "LT",
+	[GRUNT_OP_NOT]    = "NOT",    [GRUNT_OP_OR]       = "OR",
+	[GRUNT_OP_OUTPUT] = "OUTPUT", [GRUNT_OP_POP]      = "POP",
+	[GRUNT_OP_PUSHB]  = "PUSHB",  [GRUNT_OP_PUSHN]    = "PUSHN",
+	[GRUNT_OP_PUSHS]  = "PUSHS",  [GRUNT_OP_INPUT]    = "INPUT",
+	[GRUNT_OP_RETURN] = "RETURN", [GRUNT_OP_REWIND]   = "REWIND",
+	[GRUNT_OP_ROLL]   = "ROLL",   [GRUNT_OP_SUB]      = "SUB",
+	[GRUNT_OP_EQN]    = "EQN",    [GRUNT_OP_DUPEQN]   = "DUPEQN",
+	[GRUNT_OP_NOTJMPIF] = "NOTJMPIF",
+	[GRUNT_OP_INPUTLTN] = "INPUTLTN",
+	[GRUNT_OP_INPUTGTN] = "INPUTGTN",
+	[GRUNT_OP_LOOKUP]   = "LOOKUP",
+	[GRUNT_OP_SWITCH]   = "SWITCH",
+	[GRUNT_OP_REPEAT]   = "REPEAT",
+	[GRUNT_OP_END]      = "END",
+	[GRUNT_OP_INPUTREC] = "INPUTREC",
+	[GRUNT_OP_INPUTZ]   = "INPUTZ",
+	[GRUNT_OP_FORMAT]   = "FORMAT",
+	[GRUNT_OP_CLASSIFY] = "CLASSIFY",
+};
+#define TRACE_NUM_OP_NAMES (sizeof(op_names) / sizeof(op_names[0]))
+
+
+/* trace_gather()
+ *
+ * in:     num_steps - steps to ask VSC for, 0 for all it keeps
+ * out:    steps     - the steps VSC sent, oldest first
+ *         *p_total  - the steps VSC's interpreter ever traced
+ * return: the number of steps in steps[], or -1 if a message of the
+ *         series never arrived.
+ */
+
+static int
+trace_gather(unsigned num_steps, uint32 *p_total) {
+
+	const VSC_tlm_trace_payload_t *p_payload;
+	uint32 first = 0;      /* first_step of the series' first message */
+	unsigned seen = 0;     /* messages of the series received */
+	unsigned num_msgs = 1; /* messages in the series */
+	unsigned n = 0;        /* steps in steps[] */
+	unsigned i;
+
+	cmd_vsc_dumptrace((uint16)num_steps);
+
+	while (seen < num_msgs) {
+		if (tlm_receive_timeout(TRACE_TIMEOUT)) {
+			fprintf(stderr, "Trace message %u of %u never "
+				"arrived; is %s built with GRUNT_TRACE, and "
+				"does TO_LAB forward VSC_TLM_TRACE_MID?\n",
+				seen + 1, num_msgs, VSC_APP_NAME);
+			return -1;
+		}
+		if ((tlm_topicid() != (VSC_TLM_TRACE_MID & 0xFF)) ||
+			(tlm_length() != sizeof(VSC_tlm_trace_t)))
+			continue;
+
+		p_payload = &(((const VSC_tlm_trace_t *)tlm_bytes())->payload);
+		if (p_payload->seq == 0) {
+			first    = p_payload->first_step;
+			num_msgs = p_payload->num_msgs;
+			*p_total = p_payload->total_steps;
+		}
+		for (i = 0; i < p_payload->num_steps; i++) {
+			n = p_payload->first_step - first + i;
+			if (n < TRACE_MAX_STEPS) steps[n] = p_payload->steps[i];
+		}
+		n = p_payload->first_step - first + p_payload->num_steps;
+		seen++;
+	}
+
+	return (int)((n < TRACE_MAX_STEPS) ? n : TRACE_MAX_STEPS);
+
+} /* trace_gather() */
+
+
+/* trace_status_to_string()
+ *
+ * in:     status - a run's Grunt status
+ * out:    nothing
+ * return: a short description of status.
+ */
+
+static const char *
+trace_status_to_string(uint32 status) {
+
+	switch (status) {
+	case GRUNT_HALT_TRUE:  return "halted true";
+	case GRUNT_HALT_FALSE: return "halted false";
+	default:               return "ERROR";
+	}
+
+} /* trace_status_to_string() */
+
+
+/* ---------------------- exported functions ----------------------- */
+
+/* trace_replay()
+ *
+ * in:     num_steps - steps to ask VSC for, 0 for all it keeps
+ * out:    nothing
+ * return: 0 on success, -1 if the trace never arrived.
+ *
+ * Asks VSC for its Grunt trace and prints it, one step per line, a
+ * line for the end of each run, and the trace's hottest pcs.
+ */
+
+int
+trace_replay(unsigned num_steps) {
+
+	const VSC_trace_step_t *p_step;
+	uint32 total = 0;      /* steps VSC ever traced */
+	unsigned runs = 0, errors = 0;
+	unsigned hot[TRACE_HOT_PCS] = { 0 };
+	unsigned i, j, h;
+	int n;
+
+	if ((n = trace_gather(num_steps, &total)) < 0) return -1;
+
+	printf("Last %d of %lu steps %s traced\n", n, (unsigned long)total,
+		VSC_APP_NAME);
+	printf("%6s %-10s %s\n", "pc", "opcode", "top");
+	memset(pc_count, 0, sizeof(pc_count));
+	for (i = 0; i < (unsigned)n; i++) {
+		p_step = &(steps[i]);
+		if (p_step->type == VSC_TRACE_END) {
+			printf("%6u %-10s 0x%08lX %s\n", (unsigned)p_step->pc,
+				"(end)", (unsigned long)p_step->top,
+				trace_status_to_string(p_step->top));
+			runs++;
+			if ((p_step->top != GRUNT_HALT_TRUE) &&
+				(p_step->top != GRUNT_HALT_FALSE))
+				errors++;
+			continue;
+		}
+
+		pc_count[p_step->pc]++;
+		printf("%6u %-10s ", (unsigned)p_step->pc,
+			(((p_step->op < TRACE_NUM_OP_NAMES) &&
+			op_names[p_step->op]) ? op_names[p_step->op] : "?"));
+		switch (p_step->type) {
+		case VSC_TRACE_EMPTY:
+			printf("-\n");
+			break;
+		case gt_bool:
+			printf("%s\n", (p_step->top ? "true" : "false"));
+			break;
+		case gt_str:
+			printf("string %lu\n", (unsigned long)p_step->top);
+			break;
+		default:
+			printf("%lu\n", (unsigned long)p_step->top);
+			break;
+		}
+	}
+	printf("%u runs ended in the trace, %u of them in errors\n\n",
+		runs, errors);
+
+	/* Pick out the hottest pcs: an insertion sort into hot[]. */
+	for (i = 0; i <= GRUNT_PC_MAX; i++) {
+		if (!pc_count[i]) continue;
+		for (j = 0; (j < TRACE_HOT_PCS) && hot[j] &&
+			(pc_count[hot[j] - 1] >= pc_count[i]); j++);
+		if (j == TRACE_HOT_PCS) continue;
+		for (h = TRACE_HOT_PCS - 1; h > j; h--) hot[h] = hot[h - 1];
+		hot[j] = i + 1;   /* 0 marks an empty slot */
+	}
+	printf("%6s %8s\n", "pc", "steps");
+	for (j = 0; (j < TRACE_HOT_PCS) && hot[j]; j++)
+		printf("%6u %8u\n", hot[j] - 1, pc_count[hot[j] - 1]);
+
+	return 0;
+
+} /* trace_replay() */
@@ -0,0 +1,806 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This file reads test vectors from a text file and runs them.  Each
+ * vector describes a table image and the commands to send about it,
+ * along with the events each command should cause.  A vector file
+ * looks like this:
+ *
+ *   # Comments start with '#'.
+ *   test pad_err create table image with nonzero padding.
+ *   entry 0 CAT 0x00 ANIMAL_MAX ANIMAL_MAX
+ *   entry 1 APE 0x42 ANIMAL_MIN ANIMAL_MAX
+ *   load
+ *   validate invalid 1 1 NUM_ENTRIES-2
+ *   err PAD Table entry 2 parm Ape padding not zeroed
+ *   end
+ *
+ * "test" names the vector and describes its image.  Each "entry"
+ * sets an entry's index, parm ID, padding byte, and low and high
+ * bounds; entries a vector doesn't set stay zeroed, that is, unused.
+ * Values are numbers, the names of VS_PARM_* constants without the
+ * VS_PARM_ prefix, or several of these joined by '|', '+', or '-',
+ * which apply from left to right.  NUM_ENTRIES is the number of
+ * entries in the table, so that counts of unused entries can hold for
+ * tables of any size.
+ *
+ * "load", "validate valid|invalid VALID INVALID UNUSED", and
+ * "activate success|failure" are steps.  A validate step wants the
+ * app's validation summary event with the given entry counts and
+ * TBL's verdict.  Each "err EID MESSAGE" line adds an error event,
+ * named by the middle of its VS_TBL_*_ERR_EID constant, to the wants
+ * of the validate step before it.
+ *
+ * Vectors run one step at a time, each step waiting for its events in
+ * order as the hand-written tests did, or all together through
+ * pipeline.c.  Run one at a time, they may share ES perf capture
+ * windows: ES stores the validations' perf entries from the first
+ * vector of a window through the last, and TBLtest reads them all in
+ * one dump, which takes seconds, at the window's end.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdio.h>
+
+#include "cfe.h"
+#include "cfe_evs_extern_typedefs.h"   /* for CFE_EVS_EventType_* enum */
+#include "cfe_platform_cfg.h"          /* for perf buffer size */
+#include "vs_tablestruct.h"            /* for common VS table constants */
+#include "vs_eventids.h"               /* for common VS event ID constants */
+
+#include "tlm.h"
+#include "file.h"
+#include "send.h"
+#include "expect.h"
+#include "perf.h"
+#include "latency.h"
+#include "pipeline.h"
+#include "tbltest.h"
+#include "vector.h"
+
+
+/* ------------- module local definitions and functions ------------ */
+
+#define VECTOR_LINE_LEN   256   /* longest line in a vector file */
+#define VECTOR_NAME_LEN   32    /* longest vector name */
+#define VECTOR_MAX_STEPS  8     /* most steps in one vector */
+#define VECTOR_MAX_ERRS   14    /* most err lines in one vector */
+#define VECTOR_MIN_COUNT  16    /* vectors array starts this big */
+#define VECTOR_FILENAME_LEN 64  /* longest image file, same as file.c's */
+
+/* Each validation puts an entry and an exit in ES's perf buffer.  In
+ * CFE_ES_PERF_TRIGGER_START mode ES stops storing when the buffer is
+ * full, so a capture window holds no more validations than this.
+ */
+#define VECTOR_WINDOW_MAX_VALIDATIONS \
+	(CFE_PLATFORM_ES_PERF_DATA_BUFFER_SIZE / 2)
+
+typedef enum {
+	vo_load,
+	vo_validate,
+	vo_activate
+} vector_op_t;
+
+typedef struct {
+	vector_op_t op;
+	bool        ok;          /* validate: valid?  activate: success? */
+	unsigned    counts[3];   /* validate: valid, invalid, unused */
+} vector_step_t;
+
+typedef struct {
+	int           step;      /* index of the validate step it's for */
+	tlm_eventid_t eventid;
+	char          message[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH];
+} vector_err_t;
+
+typedef struct {
+	char name[VECTOR_NAME_LEN];
+	char description[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH];
+	struct {
+		bool   set;
+		vs_parm_id_t parm_id;
+		uint8  pad;
+		uint32 bound_low, bound_high;
+	} entries[VS_TABLE_NUM_ENTRIES];
+	vector_step_t steps[VECTOR_MAX_STEPS];
+	int           num_steps;
+	vector_err_t  errs[VECTOR_MAX_ERRS];
+	int           num_errs;
+} vector_t;
+
+/* The names vector files may use for values and error event IDs. */
+typedef struct {
+	const char *name;
+	uint32      value;
+} vector_name_t;
+
+static const vector_name_t value_names[] = {
+	{ "UNUSED",        VS_PARM_UNUSED },
+	{ "APE",           VS_PARM_APE },
+	{ "BAT",           VS_PARM_BAT },
+	{ "CAT",           VS_PARM_CAT },
+	{ "DOG",           VS_PARM_DOG },
+	{ "NORTH",         VS_PARM_NORTH },
+	{ "SOUTH",         VS_PARM_SOUTH },
+	{ "EAST",          VS_PARM_EAST },
+	{ "WEST",          VS_PARM_WEST },
+	{ "ANIMAL_MIN",    VS_PARM_ANIMAL_MIN },
+	{ "ANIMAL_MAX",    VS_PARM_ANIMAL_MAX },
+	{ "DIRECTION_MIN", VS_PARM_DIRECTION_MIN },
+	{ "DIRECTION_MAX", VS_PARM_DIRECTION_MAX },
+	{ "NUM_ENTRIES",   VS_TABLE_NUM_ENTRIES },
+#ifdef VS_PARM_WIDE_MIN
+	{ "WIDE_MIN",      VS_PARM_WIDE_MIN },
+	{ "WIDE_DIRECTION_MIN", VS_PARM_WIDE_DIRECTION_MIN },
+#endif
+	{ NULL, 0 }
+};
+
+static const vector_name_t eid_names[] = {
+	{ "ZERO",  VS_TBL_ZERO_ERR_EID },
+	{ "PARM",  VS_TBL_PARM_ERR_EID },
+	{ "PAD",   VS_TBL_PAD_ERR_EID },
+	{ "LBND",  VS_TBL_LBND_ERR_EID },
+	{ "HBND",  VS_TBL_HBND_ERR_EID },
+	{ "ORDER", VS_TBL_ORDER_ERR_EID },
+	{ "EXTRA", VS_TBL_EXTRA_ERR_EID },
+	{ "REDEF", VS_TBL_REDEF_ERR_EID },
+	{ NULL, 0 }
+};
+
+/* Settings from the command line. */
+static const char *vector_filename = VECTOR_FILENAME;
+static bool        vector_pipelined = false;
+static unsigned    vector_repeat = 1;    /* times to run the file */
+static unsigned    vector_window = 1;    /* vectors per window, 0 max */
+
+static vector_t *vectors;
+static int num_vectors, max_vectors;
+
+
+/* vector_lookup()
+ *
+ * in:     names - table of names to look in
+ *         name  - name to look for
+ * out:    p_value - the name's value, if found
+ * return: 0 if found, else -1.
+ */
+
+static int
+vector_lookup(const vector_name_t *names, const char *name,
+	uint32 *p_value) {
+
+	for (; names->name; names++) {
+		if (!strcmp(names->name, name)) {
+			*p_value = names->value;
+			return 0;
+		}
+	}
+	return -1;
+
+} /* vector_lookup() */
+
+
+/* vector_value()
+ *
+ * in:     s       - a value from a vector file
+ * out:    p_value - its numeric value
+ * return: 0 on success, -1 if s isn't a value.
+ */
+
+static int
+vector_value(const char *s, uint32 *p_value) {
+
+	char term[VECTOR_NAME_LEN];
+	char op = '|';            /* apply first term to zero with '|' */
+	uint32 value = 0, t;
+	size_t len;
+	char *end;
+
+	for (;;) {
+		len = strcspn(s, "|+-");
+		if ((len == 0) || (len >= sizeof(term))) return -1;
+		memcpy(term, s, len);
+		term[len] = '\0';
+
+		if (vector_lookup(value_names, term, &t)) {
+			t = (uint32)strtoul(term, &end, 0);
+			if (*end) return -1;
+		}
+		switch (op) {
+		case '|': value |= t; break;
+		case '+': value += t; break;
+		case '-': value -= t; break;
+		}
+
+		if (s[len] == '\0') break;
+		op = s[len];
+		s += len + 1;
+	}
+
+	*p_value = value;
+	return 0;
+
+} /* vector_value() */
+
+
+/* vector_new()
+ *
+ * in:     vectors - vectors read so far
+ * out:    vectors - a new zeroed vector added at the end
+ * return: the new vector.
+ */
+
+static vector_t *
+vector_new(void) {
+
+	if (num_vectors == max_vectors) {
+		max_vectors = (max_vectors ? (2 * max_vectors) :
+			VECTOR_MIN_COUNT);
+		vectors = realloc(vectors,
+			(size_t)max_vectors * sizeof(vector_t));
+		if (vectors == NULL) {
+			perror("Failed to allocate test vectors.");
+			exit(-1);
+		}
+	}
+	memset(&(vectors[num_vectors]), 0, sizeof(vector_t));
+	return &(vectors[num_vectors++]);
+
+} /* vector_new() */
+
+
+/* vector_parse_line()
+ *
+ * in:     line     - a line from a vector file, comments and newline
+ *                    removed
+ *         p_vector - vector being read, or NULL between vectors
+ * out:    p_vector - updated
+ * return: NULL on success, else a description of what's wrong.
+ */
+
+static const char *
+vector_parse_line(char *line, vector_t **p_vector) {
+
+	vector_t *p_v = *p_vector;
+	vector_step_t *p_step;
+	vector_err_t *p_err;
+	char *keyword, *args[5], *rest;
+	uint32 values[4];
+	int num_args, i;
+
+	if (NULL == (keyword = strtok(line, " \t"))) return NULL;
+
+	if (!strcmp(keyword, "test")) {
+		if (p_v) return "test inside a test";
+		if (NULL == (args[0] = strtok(NULL, " \t")))
+			return "test without a name";
+		if (strlen(args[0]) >= VECTOR_NAME_LEN)
+			return "test name too long";
+		p_v = *p_vector = vector_new();
+		strcpy(p_v->name, args[0]);
+		if ((rest = strtok(NULL, "")) != NULL) {
+			rest += strspn(rest, " \t");
+			snprintf(p_v->description,
+				sizeof(p_v->description), "%s", rest);
+		}
+		return NULL;
+	}
+	if (p_v == NULL) return "expected test";
+
+	if (!strcmp(keyword, "end")) {
+		if (p_v->num_steps == 0) return "test without steps";
+		*p_vector = NULL;
+		return NULL;
+	}
+
+	if (!strcmp(keyword, "err")) {
+		if ((p_v->num_steps == 0) ||
+			(p_v->steps[p_v->num_steps - 1].op != vo_validate))
+			return "err not after validate";
+		if (p_v->num_errs == VECTOR_MAX_ERRS)
+			return "too many errs";
+		p_err = &(p_v->errs[p_v->num_errs]);
+		if ((NULL == (args[0] = strtok(NULL, " \t"))) ||
+			vector_lookup(eid_names, args[0], &(values[0])))
+			return "unknown err event ID";
+		if (NULL == (rest = strtok(NULL, "")))
+			return "err without message";
+		rest += strspn(rest, " \t");
+		p_err->step    = p_v->num_steps - 1;
+		p_err->eventid = (tlm_eventid_t)values[0];
+		snprintf(p_err->message, sizeof(p_err->message), "%s", rest);
+		p_v->num_errs++;
+		return NULL;
+	}
+
+	for (num_args = 0; num_args < 5; num_args++) {
+		if (NULL == (args[num_args] = strtok(NULL, " \t"))) break;
+	}
+	if (strtok(NULL, " \t")) return "too many fields";
+
+	if (!strcmp(keyword, "entry")) {
+		if (num_args != 5) return "entry needs 5 fields";
+		i = atoi(args[0]);
+		if ((i < 0) || (i >= VS_TABLE_NUM_ENTRIES))
+			return "entry index out of range";
+		for (num_args = 1; num_args < 5; num_args++) {
+			if (vector_value(args[num_args],
+				&(values[num_args - 1])))
+				return "bad entry value";
+		}
+		p_v->entries[i].set        = true;
+		p_v->entries[i].parm_id    = (vs_parm_id_t)values[0];
+		p_v->entries[i].pad        = (uint8)values[1];
+		p_v->entries[i].bound_low  = values[2];
+		p_v->entries[i].bound_high = values[3];
+		return NULL;
+	}
+
+	if (p_v->num_steps == VECTOR_MAX_STEPS) return "too many steps";
+	p_step = &(p_v->steps[p_v->num_steps]);
+
+	if (!strcmp(keyword, "load")) {
+		if (num_args != 0) return "load takes no fields";
+		p_step->op = vo_load;
+	} else if (!strcmp(keyword, "validate")) {
+		if (num_args != 4) return "validate needs 4 fields";
+		if (!strcmp(args[0], "valid")) {
+			p_step->ok = true;
+		} else if (strcmp(args[0], "invalid")) {
+			return "validate wants valid or invalid";
+		}
+		for (i = 0; i < 3; i++) {
+			if (vector_value(args[i + 1], &(values[i])))
+				return "bad validate count";
+			p_step->counts[i] = (unsigned)values[i];
+		}
+		p_step->op = vo_validate;
+	} else if (!strcmp(keyword, "activate")) {
+		if (num_args != 1) return "activate needs 1 field";
+		if (!strcmp(args[0], "success")) {
+			p_step->ok = true;
+		} else if (strcmp(args[0], "failure")) {
+			return "activate wants success or failure";
+		}
+		p_step->op = vo_activate;
+	} else {
+		return "unknown keyword";
+	}
+	p_v->num_steps++;
+	return NULL;
+
+} /* vector_parse_line() */
+
+
+/* vector_read()
+ *
+ * in:     filename - vector file to read
+ * out:    vectors  - the file's vectors
+ * return: 0 on success, -1 if the file can't be read or is malformed.
+ */
+
+static int
+vector_read(const char *filename) {
+
+	char line[VECTOR_LINE_LEN];
+	vector_t *p_vector = NULL;   /* vector being read */
+	const char *problem = NULL;
+	unsigned line_num = 0;
+	FILE *in;
+
+	if (NULL == (in = fopen(filename, "r"))) {
+		perror(filename);
+		return -1;
+	}
+
+	num_vectors = 0;
+	while ((problem == NULL) && fgets(line, sizeof(line), in)) {
+		line_num++;
+		if (!strchr(line, '\n') && !feof(in)) {
+			problem = "line too long";
+			break;
+		}
+		line[strcspn(line, "#\r\n")] = '\0';
+		problem = vector_parse_line(line, &p_vector);
+	}
+	if ((problem == NULL) && p_vector) problem = "missing end";
+	fclose(in);
+
+	if (problem) {
+		fprintf(stderr, "%s:%u: %s\n", filename, line_num, problem);
+		return -1;
+	}
+	return 0;
+
+} /* vector_read() */
+
+
+/* vector_image()
+ *
+ * in:     p_vector - vector whose table image to write
+ *         tbl_name - full app.tbl name of test table
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes the vector's table image to file.c's current file.
+ */
+
+static void
+vector_image(const vector_t *p_vector, const char *tbl_name) {
+
+	int i;
+
+	file_init(tbl_name, TABLE_DESCRIPTION);
+	for (i = 0; i < VS_TABLE_NUM_ENTRIES; i++) {
+		if (!p_vector->entries[i].set) continue;
+		file_set_entry((unsigned)i, p_vector->entries[i].parm_id,
+			p_vector->entries[i].pad,
+			p_vector->entries[i].bound_low,
+			p_vector->entries[i].bound_high);
+	}
+	file_output(file_host_filename());
+
+} /* vector_image() */
+
+
+/* vector_run_one()
+ *
+ * in:     p_vector   - vector to run
+ *         app_name   - name of app to test
+ *         tbl_name   - name of test table
+ * out:    nothing
+ * return: 0 on pass, -1 on fail.
+ *
+ * Runs the vector one step at a time, waiting for each event in the
+ * order the vector lists them: for validate steps, the app's error
+ * events first, then its summary, then TBL's verdict.  The caller
+ * opens and closes the perf capture window around it.
+ */
+
+static int
+vector_run_one(const vector_t *p_vector, const char *app_name,
+	const char *tbl_name) {
+
+	const vector_step_t *p_step;
+	const vector_err_t *p_err;
+	int s, e;
+
+	printf("FILE: %s\n", p_vector->description);
+	vector_image(p_vector, tbl_name);
+	file_print();
+
+	do {  /* using do/while/break as poor man's try/catch */
+
+		for (s = 0; s < p_vector->num_steps; s++) {
+			p_step = &(p_vector->steps[s]);
+
+			if (p_step->op == vo_load) {
+				send_load();
+				if (expect_load_success(tbl_name)) break;
+				continue;
+			}
+
+			if (p_step->op == vo_activate) {
+				send_activate(tbl_name);
+				if (p_step->ok ?
+					expect_activate_success(app_name,
+					tbl_name) :
+					expect_activate_failure(tbl_name))
+					break;
+				continue;
+			}
+
+			send_validate(tbl_name);
+			latency_sent();
+			for (e = 0; e < p_vector->num_errs; e++) {
+				p_err = &(p_vector->errs[e]);
+				if (p_err->step != s) continue;
+				if (expect_err(app_name, p_err->eventid,
+					p_err->message))
+					break;
+			}
+			if (e < p_vector->num_errs) break;
+			if (p_step->ok ?
+				expect_validate_success(app_name, tbl_name,
+				p_step->counts[0], p_step->counts[1],
+				p_step->counts[2]) :
+				expect_validate_failure(app_name, tbl_name,
+				p_step->counts[0], p_step->counts[1],
+				p_step->counts[2]))
+				break;
+			latency_arrived();
+		}
+		if (s < p_vector->num_steps) break;
+
+		/* If we reach here, the test as a whole passed. */
+		return 0;  /* PASS */
+
+	} while (0);
+
+	/* If we reach here, some test step failed. */
+	return -1;  /* FAIL */
+
+} /* vector_run_one() */
+
+
+/* vector_validations()
+ *
+ * in:     p_vector - vector to count
+ * out:    nothing
+ * return: the number of validate steps in p_vector.
+ */
+
+static int
+vector_validations(const vector_t *p_vector) {
+
+	int s, count = 0;
+
+	for (s = 0; s < p_vector->num_steps; s++) {
+		if (p_vector->steps[s].op == vo_validate) count++;
+	}
+	return count;
+
+} /* vector_validations() */
+
+
+/* vector_run_serial()
+ *
+ * in:     app_name   - name of app to test
+ *         app_perfid - app validation function perf ID
+ *         tbl_name   - name of test table
+ * out:    nothing
+ * return: 0 if every vector passed, else -1.
+ *
+ * Runs the vectors one at a time, vector_repeat times over, in perf
+ * capture windows of vector_window vectors each, or as many as ES's
+ * perf buffer holds if vector_window is 0.  A window also ends early
+ * when its next vector would overflow the buffer, and after a vector
+ * that fails, so that the next one starts from an empty log.  Each
+ * window's end prints the durations of the validations within it.
+ */
+
+static int
+vector_run_serial(const char *app_name, uint32 app_perfid,
+	const char *tbl_name) {
+
+	int in_window = 0;            /* vectors in the open window */
+	int validations = 0;          /* their validate steps */
+	int result = 0;
+	unsigned r;
+	int v, n;
+
+	for (r = 0; r < vector_repeat; r++) {
+		for (v = 0; v < num_vectors; v++) {
+			n = vector_validations(&(vectors[v]));
+			if (in_window && ((vector_window &&
+				((unsigned)in_window == vector_window)) ||
+				((validations + n) >
+				VECTOR_WINDOW_MAX_VALIDATIONS))) {
+				send_perfstop();
+				perf_print(app_perfid);
+				in_window = validations = 0;
+			}
+			if (in_window == 0) send_perfstart();
+			in_window++;
+			validations += n;
+
+			if (vector_run_one(&(vectors[v]), app_name,
+				tbl_name)) {
+				send_perfstop();
+				perf_print(app_perfid);
+				in_window = validations = 0;
+				result = -1;
+			}
+		}
+	}
+	if (in_window) {
+		send_perfstop();
+		perf_print(app_perfid);
+	}
+
+	return result;
+
+} /* vector_run_serial() */
+
+
+/* vector_run_pipelined()
+ *
+ * in:     app_name   - name of app to test
+ *         app_perfid - app validation function perf ID
+ *         tbl_name   - name of test table
+ * out:    nothing
+ * return: 0 if every vector passed, else -1.
+ *
+ * Writes each vector's image to a file of its own, queues all the
+ * vectors' steps on the pipeline, and runs them.  TBL works on one
+ * table at a time, so the steps still run in order, but the pipeline
+ * sends each step as soon as the one before it is done.
+ */
+
+static int
+vector_run_pipelined(const char *app_name, uint32 app_perfid,
+	const char *tbl_name) {
+
+	char (*filenames)[VECTOR_FILENAME_LEN];
+	char saved[VECTOR_FILENAME_LEN];    /* file.c's file before ours */
+	const vector_t *p_vector;
+	const vector_step_t *p_step;
+	int v, s, e, result;
+
+	filenames = malloc((size_t)num_vectors * VECTOR_FILENAME_LEN);
+	if (filenames == NULL) {
+		perror("Failed to allocate test vector file names.");
+		exit(-1);
+	}
+
+	snprintf(saved, sizeof(saved), "%s", file_filename());
+	printf("FILE: create an image for each of %d test vectors.\n",
+		num_vectors);
+	for (v = 0; v < num_vectors; v++) {
+		p_vector = &(vectors[v]);
+		snprintf(filenames[v], VECTOR_FILENAME_LEN,
+			"/cf/tbltest_%s_v%d.tbl", app_name, v + 1);
+		file_set_filename(filenames[v]);
+		vector_image(p_vector, tbl_name);
+
+		for (s = 0; s < p_vector->num_steps; s++) {
+			p_step = &(p_vector->steps[s]);
+			switch (p_step->op) {
+			case vo_load:
+				pipeline_load(tbl_name, filenames[v]);
+				break;
+			case vo_validate:
+				pipeline_validate(app_name, tbl_name,
+					p_step->ok, p_step->counts[0],
+					p_step->counts[1], p_step->counts[2]);
+				for (e = 0; e < p_vector->num_errs; e++) {
+					if (p_vector->errs[e].step != s)
+						continue;
+					pipeline_want_err(app_name,
+						p_vector->errs[e].eventid,
+						p_vector->errs[e].message);
+				}
+				break;
+			case vo_activate:
+				pipeline_activate(app_name, tbl_name,
+					p_step->ok);
+				break;
+			}
+		}
+	}
+
+	send_perfstart();
+	result = pipeline_run();
+	send_perfstop();
+	perf_print(app_perfid);
+
+	/* Clean up the image files and put file.c back as it was. */
+	for (v = 0; v < num_vectors; v++) {
+		file_set_filename(filenames[v]);
+		file_remove();
+	}
+	file_set_filename(saved);
+	free(filenames);
+
+	return result;
+
+} /* vector_run_pipelined() */
+
+
+/* ------------------- module exported functions ----------------------- */
+
+
+/* vector_set_filename()
+ *
+ * in:     filename        - vector file to run instead of the default
+ * out:    vector_filename - set to filename
+ * return: nothing
+ */
+
+void
+vector_set_filename(const char *filename) {
+
+	vector_filename = filename;
+
+} /* vector_set_filename() */
+
+
+/* vector_set_pipelined()
+ *
+ * in:     pipelined        - true to run vectors through the pipeline
+ * out:    vector_pipelined - set to pipelined
+ * return: nothing
+ */
+
+void
+vector_set_pipelined(bool pipelined) {
+
+	vector_pipelined = pipelined;
+
+} /* vector_set_pipelined() */
+
+
+/* vector_set_repeat()
+ *
+ * in:     repeat        - times to run the vector file, at least 1
+ * out:    vector_repeat - set to repeat
+ * return: nothing
+ *
+ * Applies only to vectors run one at a time.
+ */
+
+void
+vector_set_repeat(unsigned repeat) {
+
+	vector_repeat = repeat;
+
+} /* vector_set_repeat() */
+
+
+/* vector_set_window()
+ *
+ * in:     window        - vectors per perf capture window, or 0 for as
+ *                         many as ES's perf buffer holds
+ * out:    vector_window - set to window
+ * return: nothing
+ *
+ * Applies only to vectors run one at a time.  The pipeline always
+ * runs every vector in one window.
+ */
+
+void
+vector_set_window(unsigned window) {
+
+	vector_window = window;
+
+} /* vector_set_window() */
+
+
+/* vector_run()
+ *
+ * in:     app_name   - name of app to test
+ *         app_perfid - app validation function perf ID
+ *         tbl_name   - name of test table
+ * out:    nothing
+ * return: 0 if every vector passed, else -1.
+ *
+ * Reads the vector file and runs its vectors.
+ */
+
+int
+vector_run(const char *app_name, uint32 app_perfid, const char *tbl_name) {
+
+	int result;
+
+	if (vector_read(vector_filename)) return -1;
+	printf("INIT: read %d test vectors from %s.\n", num_vectors,
+		vector_filename);
+
+	if (vector_pipelined) {
+		result = vector_run_pipelined(app_name, app_perfid, tbl_name);
+	} else {
+		result = vector_run_serial(app_name, app_perfid, tbl_name);
+	}
+
+	free(vectors);
+	vectors = NULL;
+	num_vectors = max_vectors = 0;
+	return result;
+
+} /* vector_run() */
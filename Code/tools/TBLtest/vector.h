@@ -0,0 +1,25 @@
+#ifndef _VECTOR_H_
+#define _VECTOR_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+void vector_set_filename(const char *);
+void vector_set_pipelined(bool);
+void vector_set_repeat(unsigned);
+void vector_set_window(unsigned);
+int  vector_run(const char *, uint32, const char *);
+
+#endif
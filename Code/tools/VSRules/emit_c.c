@@ -0,0 +1,468 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module writes a rule spec as a C header defining a native
+ * validation function, PREFIX_rules_validate().  The function makes
+ * one pass over the table.  For each entry it picks the entry's kind
+ * and class with a switch on its parm ID, then evaluates every rule
+ * for that kind as a 0/1 value and gathers them into a mask, one bit
+ * per rule, without branching on any of them.  Only an entry with a
+ * nonzero mask goes on to send events, one for each bit, in rule
+ * order.  The redefinition rule uses the parm ID set of
+ * vs_parmset.h, so the whole pass is linear in the size of the table,
+ * and the function works for any table size or parm ID width the VS
+ * headers allow.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "vsrules.h"
+
+
+/* ----------------- module private functions and state ------------- */
+
+/* What the C expression for each field is. */
+static const char *field_exprs[VSR_NUM_FIELDS] = { "pad", "low", "high" };
+
+
+/* emit_upper()
+ *
+ * in:     out - file to write to
+ *         s   - identifier to write
+ * out:    nothing
+ * return: nothing
+ */
+
+static void
+emit_upper(FILE *out, const char *s) {
+
+	for (; *s; s++) fputc(toupper((unsigned char)*s), out);
+
+} /* emit_upper() */
+
+
+/* emit_literal()
+ *
+ * in:     out   - file to write to
+ *         s     - text to write inside a C format string literal
+ * out:    nothing
+ * return: nothing
+ *
+ * Escapes the characters C string literals and printf() formats give
+ * meaning to.
+ */
+
+static void
+emit_literal(FILE *out, const char *s) {
+
+	for (; *s; s++) {
+		if ((*s == '"') || (*s == '\\')) fputc('\\', out);
+		if (*s == '%') fputc('%', out);
+		fputc(*s, out);
+	}
+
+} /* emit_literal() */
+
+
+/* emit_event()
+ *
+ * in:     out     - file to write to
+ *         p_spec  - the spec
+ *         prefix  - prefix of generated identifiers
+ *         eid     - event ID constant
+ *         type    - event type constant
+ *         text    - event text
+ *         kind    - entry kind the event is for, or VSR_NUM_KINDS for
+ *                   the summary
+ *         indent  - tabs to start the call's line with
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes a CFE_EVS_SendEvent() call that sends text with its
+ * placeholders filled in.  Parm names known at generation time go
+ * into the format string itself.
+ */
+
+static void
+emit_event(FILE *out, const vsr_spec_t *p_spec, const char *prefix,
+	const char *eid, const char *type, const char *text,
+	vsr_kind_t kind, const char *indent) {
+
+	vsr_piece_t pieces[VSR_MAX_PIECES];
+	int num_pieces, k;
+
+	num_pieces = vsr_split(text, pieces);
+
+	fprintf(out, "%sCFE_EVS_SendEvent(%s,\n%s\t%s,\n%s\t\"", indent,
+		eid, indent, type, indent);
+	for (k = 0; k < num_pieces; k++) {
+		switch (pieces[k].placeholder) {
+		case '\0':
+			emit_literal(out, pieces[k].text);
+			break;
+		case 'P':
+			if (kind == vk_inuse) {
+				fprintf(out, "%%s");
+			} else {
+				emit_literal(out, (kind == vk_unused) ?
+					p_spec->unused_name :
+					p_spec->unknown_name);
+			}
+			break;
+		default:
+			fprintf(out, "%%u");
+			break;
+		}
+	}
+	fprintf(out, "\"");
+	for (k = 0; k < num_pieces; k++) {
+		switch (pieces[k].placeholder) {
+		case 'N':
+			fprintf(out, ",\n%s\t(i + 1)", indent);
+			break;
+		case 'P':
+			if (kind == vk_inuse) {
+				fprintf(out, ",\n%s\t%s_rules_parm_name("
+					"p_entry->parm_id)", indent, prefix);
+			}
+			break;
+		case 'V':
+			fprintf(out, ",\n%s\tnum_valid", indent);
+			break;
+		case 'I':
+			fprintf(out, ",\n%s\tnum_invalid", indent);
+			break;
+		case 'U':
+			fprintf(out, ",\n%s\tnum_unused", indent);
+			break;
+		default:
+			break;
+		}
+	}
+	fprintf(out, ");\n");
+
+} /* emit_event() */
+
+
+/* emit_cond()
+ *
+ * in:     out    - file to write to
+ *         p_rule - rule whose condition to write
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes a C expression that is 1 if the rule's condition holds for
+ * the entry at hand, else 0.
+ */
+
+static void
+emit_cond(FILE *out, const vsr_rule_t *p_rule) {
+
+	const char *f0 = field_exprs[p_rule->fields[0]];
+	const char *f1 = field_exprs[p_rule->fields[1]];
+	int f;
+
+	switch (p_rule->cond) {
+	case vc_always:
+		fprintf(out, "1");
+		break;
+	case vc_nonzero:
+		fprintf(out, "(%s%s", ((p_rule->num_fields > 1) ? "(" : ""),
+			f0);
+		for (f = 1; f < p_rule->num_fields; f++)
+			fprintf(out, " | %s", field_exprs[p_rule->fields[f]]);
+		fprintf(out, "%s != 0)", ((p_rule->num_fields > 1) ? ")" : ""));
+		break;
+	case vc_outside:
+		fprintf(out, "((%s < min) | (%s > max))", f0, f0);
+		break;
+	case vc_greater:
+		fprintf(out, "(%s > %s)", f0, f1);
+		break;
+	case vc_after_unused:
+		fprintf(out, "saw_unused");
+		break;
+	case vc_redefines:
+		fprintf(out, "redefined");
+		break;
+	}
+
+} /* emit_cond() */
+
+
+/* emit_kind()
+ *
+ * in:     out    - file to write to
+ *         p_spec - the spec
+ *         prefix - prefix of generated identifiers
+ *         kind   - kind of entry to check
+ *         indent - tabs to start each line with
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes the code that checks an entry of the given kind against its
+ * rules, sends an event for each rule that holds, and counts the
+ * entry.  Leaves the loop body by continue, except for in-use entries,
+ * whose code ends the loop body.
+ */
+
+static void
+emit_kind(FILE *out, const vsr_spec_t *p_spec, const char *prefix,
+	vsr_kind_t kind, const char *indent) {
+
+	char indent1[VSR_MAX_WORDS];  /* indent plus one more tab */
+	const vsr_rule_t *p_rule;
+	int r, bit, num_bits = 0;
+
+	snprintf(indent1, sizeof(indent1), "%s\t", indent);
+
+	for (r = 0; r < p_spec->num_rules; r++) {
+		p_rule = &(p_spec->rules[r]);
+		if (p_rule->kind != kind) continue;
+		if (p_rule->cond == vc_redefines) {
+			fprintf(out, "%sredefined = VS_parmset_mark("
+				"&%s_rules_parms_seen,\n"
+				"%s\tp_entry->parm_id);\n",
+				indent, prefix, indent);
+		}
+		num_bits++;
+	}
+
+	/* Gather every rule's result into the mask without branching. */
+	if (num_bits == 0) fprintf(out, "%scaught = 0;\n", indent);
+	for (bit = 0, r = 0; r < p_spec->num_rules; r++) {
+		p_rule = &(p_spec->rules[r]);
+		if (p_rule->kind != kind) continue;
+		fprintf(out, "%s%s((uint32)", indent,
+			(bit ? "\t| " : "caught = "));
+		emit_cond(out, p_rule);
+		fprintf(out, " << %d)%s\n", bit,
+			((bit == num_bits - 1) ? ";" : ""));
+		bit++;
+	}
+
+	/* Valid entries are counted and done with. */
+	if (kind != vk_invalid) {
+		fprintf(out, "%sif (!caught) {\n", indent);
+		if (kind == vk_unused) {
+			fprintf(out, "%s\tnum_unused++;\n", indent);
+			fprintf(out, "%s\tsaw_unused = 1;\n", indent);
+		} else {
+			fprintf(out, "%s\tnum_valid++;\n", indent);
+		}
+		fprintf(out, "%s\tcontinue;\n%s}\n", indent, indent);
+	}
+
+	for (bit = 0, r = 0; r < p_spec->num_rules; r++) {
+		p_rule = &(p_spec->rules[r]);
+		if (p_rule->kind != kind) continue;
+		fprintf(out, "%sif (caught & 0x%Xu)\n", indent, 1u << bit);
+		emit_event(out, p_spec, prefix, p_rule->eid,
+			"CFE_EVS_EventType_ERROR", p_rule->text, kind,
+			indent1);
+		bit++;
+	}
+	fprintf(out, "%snum_invalid++;\n", indent);
+	if (kind != vk_inuse) fprintf(out, "%scontinue;\n", indent);
+
+} /* emit_kind() */
+
+
+/* -------------------- module exported functions ------------------ */
+
+
+/* emit_c()
+ *
+ * in:     out    - file to write to
+ *         p_spec - the spec to write a validator for
+ *         prefix - prefix of generated identifiers
+ * out:    nothing
+ * return: nothing
+ */
+
+void
+emit_c(FILE *out, const vsr_spec_t *p_spec, const char *prefix) {
+
+	const char *source;   /* spec file name without its directory */
+	const char **p_line;
+	const vsr_class_t *p_class;
+	bool redefines = false;
+	int width;            /* widest parm ID constant, for alignment */
+	int c, p, r, w;
+
+	source = strrchr(p_spec->source, '/');
+	source = (source ? (source + 1) : p_spec->source);
+	for (r = 0; r < p_spec->num_rules; r++)
+		redefines |= (p_spec->rules[r].cond == vc_redefines);
+
+	fprintf(out, "#ifndef _");
+	emit_upper(out, prefix);
+	fprintf(out, "_RULES_H_\n#define _");
+	emit_upper(out, prefix);
+	fprintf(out, "_RULES_H_\n\n");
+	fprintf(out, "/* Copyright (c) 2024 Timothy Jon Fraser "
+		"Consulting LLC\n *\n");
+	for (p_line = vsr_license; *p_line; p_line++)
+		fprintf(out, " *%s%s\n", (**p_line ? " " : ""), *p_line);
+	fprintf(out, " */\n\n");
+	fprintf(out, "/* GENERATED FILE - DO NOT EDIT.\n *\n");
+	fprintf(out, " * The vsrules generator generated this file from "
+		"the validation rules\n * in %s.  Edit the rules and run "
+		"vsrules again instead.\n */\n\n", source);
+
+	fprintf(out, "/* This file defines %s_rules_validate(), a native "
+		"table validation\n * function that applies the rules in "
+		"%s, and the functions\n * it needs.  It makes one pass over "
+		"the table, checking every rule\n * for each entry's kind at "
+		"once and sending events only for entries\n * that break "
+		"some rule.\n */\n\n", prefix, source);
+
+	fprintf(out, "#include \"cfe.h\"\n\n");
+	fprintf(out, "#include \"vs_tablestruct.h\"\n");
+	fprintf(out, "#include \"vs_eventids.h\"\n");
+	if (redefines) fprintf(out, "#include \"vs_parmset.h\"\n");
+	fprintf(out, "\n\n");
+
+	if (redefines) {
+		fprintf(out, "/* The parms of the in-use entries seen in the "
+			"image being validated.\n * Each validation leaves it "
+			"zeroed again when it's done.\n */\n");
+		fprintf(out, "static vs_parmset_t %s_rules_parms_seen;\n\n\n",
+			prefix);
+	}
+
+	/* The parm name function. */
+	fprintf(out, "/* %s_rules_parm_name()\n *\n", prefix);
+	fprintf(out, " * in:     parm_id - numeric parm ID value\n");
+	fprintf(out, " * out:    nothing\n");
+	fprintf(out, " * return: the name event messages use for "
+		"parm_id.\n */\n\n");
+	fprintf(out, "static const char *\n%s_rules_parm_name("
+		"vs_parm_id_t parm_id) {\n\n", prefix);
+	if (p_spec->num_wides) {
+		fprintf(out, "#ifdef %s\n", p_spec->wides[0].id);
+		for (w = p_spec->num_wides - 1; w >= 0; w--) {
+			fprintf(out, "\tif (parm_id >= %s) return \"",
+				p_spec->wides[w].id);
+			emit_literal(out, p_spec->wides[w].name);
+			fprintf(out, "\";\n");
+		}
+		fprintf(out, "#endif\n\n");
+	}
+	width = (int)strlen(p_spec->unused_id) + 1;
+	for (p = 0; p < p_spec->num_parms; p++)
+		if ((int)strlen(p_spec->parms[p].id) + 1 > width)
+			width = (int)strlen(p_spec->parms[p].id) + 1;
+	fprintf(out, "\tswitch (parm_id) {\n");
+	fprintf(out, "\tcase %s:%*s return \"", p_spec->unused_id,
+		width - 1 - (int)strlen(p_spec->unused_id), "");
+	emit_literal(out, p_spec->unused_name);
+	fprintf(out, "\";\n");
+	for (p = 0; p < p_spec->num_parms; p++) {
+		fprintf(out, "\tcase %s:%*s return \"", p_spec->parms[p].id,
+			width - 1 - (int)strlen(p_spec->parms[p].id), "");
+		emit_literal(out, p_spec->parms[p].name);
+		fprintf(out, "\";\n");
+	}
+	fprintf(out, "\tdefault:%*s return \"", width - 3, "");
+	emit_literal(out, p_spec->unknown_name);
+	fprintf(out, "\";\n\t}\n\n} /* %s_rules_parm_name() */\n\n\n",
+		prefix);
+
+	/* The validation function. */
+	fprintf(out, "/* %s_rules_validate()\n *\n", prefix);
+	fprintf(out, " * in:     p_table - pointer to table image to "
+		"validate\n");
+	fprintf(out, " * out:    nothing\n");
+	fprintf(out, " * return: true if *p_table is valid, else false.\n");
+	fprintf(out, " *\n * Sends an error event for each rule each entry "
+		"breaks, then one\n * event summing up the entries.\n */\n\n");
+	fprintf(out, "static bool\n%s_rules_validate(const vs_table_t "
+		"*p_table) {\n\n", prefix);
+	fprintf(out,
+		"\tconst vs_entry_t *p_entry;  /* points to indexed table "
+		"entry */\n"
+		"\tuint32 pad, low, high;      /* the entry's fields */\n"
+		"\tuint32 min, max;            /* range of the entry's "
+		"class */\n"
+		"\tuint32 caught;              /* bit r set if rule r "
+		"holds */\n"
+		"\tuint32 saw_unused = 0;      /* 1 once a valid unused "
+		"entry is seen */\n");
+	if (redefines) {
+		fprintf(out, "\tuint32 redefined;           /* 1 if an "
+			"earlier entry had this parm */\n");
+	}
+	fprintf(out,
+		"\tunsigned int num_valid = 0, num_invalid = 0, "
+		"num_unused = 0;\n"
+		"\tunsigned int i;             /* indexes table "
+		"entries */\n"
+		"\tunsigned int k;             /* indexes pad "
+		"bytes */\n\n");
+
+	fprintf(out, "\tfor (i = 0; i < VS_TABLE_NUM_ENTRIES; i++) {\n\n");
+	fprintf(out, "\t\tp_entry = &(p_table->entries[i]);\n");
+	fprintf(out, "\t\tfor (pad = 0, k = 0; k < sizeof(p_entry->pad); "
+		"k++)\n\t\t\tpad |= p_entry->pad[k];\n");
+	fprintf(out, "\t\tlow  = p_entry->bound_low;\n");
+	fprintf(out, "\t\thigh = p_entry->bound_high;\n\n");
+
+	fprintf(out, "\t\tswitch (p_entry->parm_id) {\n");
+	fprintf(out, "\t\tcase %s:\n", p_spec->unused_id);
+	emit_kind(out, p_spec, prefix, vk_unused, "\t\t\t");
+	for (c = 0; c < p_spec->num_classes; c++) {
+		p_class = &(p_spec->classes[c]);
+		for (p = 0; p < p_spec->num_parms; p++) {
+			if (p_spec->parms[p].class == c)
+				fprintf(out, "\t\tcase %s:\n",
+					p_spec->parms[p].id);
+		}
+		fprintf(out, "\t\t\tmin = %s;\n\t\t\tmax = %s;\n"
+			"\t\t\tbreak;\n", p_class->min, p_class->max);
+	}
+	fprintf(out, "\t\tdefault:\n");
+	if (p_spec->num_wides) {
+		fprintf(out, "#ifdef %s\n", p_spec->wides[0].id);
+		for (w = p_spec->num_wides - 1; w >= 0; w--) {
+			p_class = &(p_spec->classes[p_spec->wides[w].class]);
+			fprintf(out, "\t\t\tif (p_entry->parm_id >= %s) {\n"
+				"\t\t\t\tmin = %s;\n\t\t\t\tmax = %s;\n"
+				"\t\t\t\tbreak;\n\t\t\t}\n",
+				p_spec->wides[w].id, p_class->min,
+				p_class->max);
+		}
+		fprintf(out, "#endif\n");
+	}
+	emit_kind(out, p_spec, prefix, vk_invalid, "\t\t\t");
+	fprintf(out, "\t\t}\n\n");
+
+	emit_kind(out, p_spec, prefix, vk_inuse, "\t\t");
+	fprintf(out, "\n\t} /* for all entries in table */\n\n");
+
+	if (redefines) {
+		fprintf(out, "\tVS_parmset_clear(&%s_rules_parms_seen, "
+			"p_table->entries,\n\t\tVS_TABLE_NUM_ENTRIES);\n",
+			prefix);
+	}
+	emit_event(out, p_spec, prefix, p_spec->summary_eid,
+		"CFE_EVS_EventType_INFORMATION", p_spec->summary_text,
+		VSR_NUM_KINDS, "\t");
+	fprintf(out, "\n\treturn (num_invalid == 0);\n\n");
+	fprintf(out, "} /* %s_rules_validate() */\n\n\n#endif\n", prefix);
+
+} /* emit_c() */
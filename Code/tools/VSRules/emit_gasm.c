@@ -0,0 +1,1035 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* This module writes a rule spec as Grunt assembly source for the
+ * gruntasm assembler.  Grunt has no backward jumps and no memory but
+ * its stack, so the program it writes unrolls its checks for each
+ * entry of the default table: four entries with 8-bit parm IDs, read
+ * as 12-byte records.  MAIN keeps the parm ID of each entry it has
+ * checked on the stack, for the redefinition rule, beneath the counts
+ * of valid unused and valid in-use entries.
+ *
+ * For each entry, MAIN reads all of its fields, picks the code for
+ * the entry's kind and class, and evaluates that kind's rules in
+ * order.  Each rule that holds calls the subroutine that sends its
+ * event.  The results are ORed together; an entry none of whose rules
+ * hold bumps the count for its kind.
+ *
+ * The module tracks the name of each item on the stack as it writes
+ * each instruction, both to work out the DUP and POP counts that
+ * fetch a copy of an item from deeper in the stack and to write the
+ * stack comment after each instruction.
+ */
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsrules.h"
+
+
+/* ----------------- module private definitions and state ------------ */
+
+#define GASM_NUM_ENTRIES  4     /* entries in the default table */
+#define GASM_MAX_DEPTH    64    /* deepest stack the model tracks */
+#define GASM_SYM_LEN      16    /* longest stack item name */
+#define GASM_MAX_STRINGS  256   /* gruntasm's limit */
+#define GASM_NAME_CHARS   20    /* most text characters in a string name */
+#define GASM_INS_WIDTH    24    /* column where stack comments start */
+
+/* The names of the items on the Grunt stack, bottom item first. */
+typedef struct {
+	char syms[GASM_MAX_DEPTH][GASM_SYM_LEN];
+	int  depth;
+} gasm_stack_t;
+
+/* A string for the program's .strings section. */
+typedef struct {
+	char name[VSR_NAME_MAX_LEN];
+	char text[VSR_TEXT_MAX_LEN];
+} gasm_string_t;
+
+static FILE *gasm_out;                     /* file being written */
+static const vsr_spec_t *gasm_spec;        /* spec being written */
+static char gasm_label[VSR_NAME_MAX_LEN];  /* label of next instruction */
+static bool gasm_redefines;                /* spec has redefines rule? */
+static gasm_string_t gasm_strings[GASM_MAX_STRINGS];
+static int gasm_num_strings;
+
+
+/* intern()
+ *
+ * in:     text - string the program needs
+ * out:    nothing
+ * return: the name of text's entry in gasm_strings[], which intern()
+ *         adds if it isn't there already.
+ *
+ * Names strings S_ followed by the start of their text in upper case,
+ * with a suffix if that name is taken.
+ */
+
+static const char *
+intern(const char *text) {
+
+	gasm_string_t *p_string;
+	char name[2 + GASM_NAME_CHARS + 1];
+	const char *p_char;
+	size_t n = 2;
+	int s, suffix = 1;
+
+	for (s = 0; s < gasm_num_strings; s++)
+		if (!strcmp(gasm_strings[s].text, text))
+			return gasm_strings[s].name;
+
+	if (gasm_num_strings == GASM_MAX_STRINGS) {
+		fprintf(stderr, "vsrules: more than %d strings\n",
+			GASM_MAX_STRINGS);
+		exit(-1);
+	}
+
+	strcpy(name, "S_");
+	for (p_char = text; *p_char && (n < (2 + GASM_NAME_CHARS));
+		p_char++) {
+		if (isalnum((unsigned char)*p_char)) {
+			name[n++] = toupper((unsigned char)*p_char);
+		} else if (name[n - 1] != '_') {
+			name[n++] = '_';
+		}
+	}
+	while ((n > 2) && (name[n - 1] == '_')) n--;
+	name[n] = '\0';
+
+	p_string = &(gasm_strings[gasm_num_strings++]);
+	strcpy(p_string->text, text);
+	strcpy(p_string->name, name);
+	for (s = 0; s < (gasm_num_strings - 1); s++) {
+		if (!strcmp(gasm_strings[s].name, p_string->name)) {
+			snprintf(p_string->name, sizeof(p_string->name),
+				"%s_%d", name, ++suffix);
+			s = -1;    /* check the new name from the top */
+		}
+	}
+	return p_string->name;
+
+} /* intern() */
+
+
+/* segments()
+ *
+ * in:     text     - event text
+ *         kind     - kind of entry the event is for, or VSR_NUM_KINDS
+ *                    for the summary
+ * out:    p_pieces - filled with the event's pieces
+ * return: the number of pieces
+ *
+ * Like vsr_split(), but writes the parm names it knows at generation
+ * time into the text, and joins adjacent text into one piece, so the
+ * program needs one PUSHS for each run of text.
+ */
+
+static int
+segments(const char *text, vsr_kind_t kind, vsr_piece_t *p_pieces) {
+
+	vsr_piece_t split[VSR_MAX_PIECES];
+	const char *literal;
+	size_t used;   /* length of the piece literal joins */
+	int num_split, num_pieces = 0, k;
+
+	num_split = vsr_split(text, split);
+	for (k = 0; k < num_split; k++) {
+		literal = split[k].text;
+		if ((split[k].placeholder == 'P') && (kind != vk_inuse)) {
+			literal = ((kind == vk_unused) ?
+				gasm_spec->unused_name :
+				gasm_spec->unknown_name);
+		} else if (split[k].placeholder) {
+			p_pieces[num_pieces++] = split[k];
+			continue;
+		}
+		if (!num_pieces || p_pieces[num_pieces - 1].placeholder) {
+			memset(&(p_pieces[num_pieces]), 0,
+				sizeof(p_pieces[num_pieces]));
+			num_pieces++;
+		}
+		used = strlen(p_pieces[num_pieces - 1].text);
+		snprintf(p_pieces[num_pieces - 1].text + used,
+			VSR_TEXT_MAX_LEN - used, "%s", literal);
+	}
+	return num_pieces;
+
+} /* segments() */
+
+
+/* emit_ins()
+ *
+ * in:     p_stack - names of the items on the stack after ins
+ *         ins     - instruction to write
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes ins, after the pending label if there is one, with a comment
+ * showing the stack as ins leaves it.
+ */
+
+static void
+emit_ins(const gasm_stack_t *p_stack, const char *ins) {
+
+	int d;
+
+	if (p_stack->depth > GASM_MAX_DEPTH) {
+		fprintf(stderr, "vsrules: stack model overflow at %s\n", ins);
+		exit(-1);
+	}
+	if (gasm_label[0]) {
+		fprintf(gasm_out, "%s:\n", gasm_label);
+		gasm_label[0] = '\0';
+	}
+	fprintf(gasm_out, "\t%-*s ; --", GASM_INS_WIDTH - 1, ins);
+	for (d = 0; d < p_stack->depth; d++)
+		fprintf(gasm_out, " %s", p_stack->syms[d]);
+	fprintf(gasm_out, "\n");
+
+} /* emit_ins() */
+
+
+/* emit_comment()
+ *
+ * in:     text - comment to write
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes a blank line and then text as a comment, after the pending
+ * label if there is one.
+ */
+
+static void
+emit_comment(const char *text) {
+
+	fprintf(gasm_out, "\n");
+	if (gasm_label[0]) {
+		fprintf(gasm_out, "%s:\n", gasm_label);
+		gasm_label[0] = '\0';
+	}
+	fprintf(gasm_out, "\t; %s\n", text);
+
+} /* emit_comment() */
+
+
+/* emit_plain()
+ *
+ * in:     ins - instruction to write
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes an instruction that ends the routine, so has no stack to
+ * comment on, after the pending label if there is one.
+ */
+
+static void
+emit_plain(const char *ins) {
+
+	if (gasm_label[0]) {
+		fprintf(gasm_out, "%s:\n", gasm_label);
+		gasm_label[0] = '\0';
+	}
+	fprintf(gasm_out, "\t%s\n", ins);
+
+} /* emit_plain() */
+
+
+/* op()
+ *
+ * in:     p_stack - the stack
+ *         pops    - number of items ins pops
+ *         result  - name of the item ins pushes, or NULL if none
+ *         ins     - instruction to write
+ * out:    p_stack - updated for ins
+ * return: nothing
+ */
+
+static void
+op(gasm_stack_t *p_stack, int pops, const char *result, const char *ins) {
+
+	p_stack->depth -= pops;
+	if (result) {
+		snprintf(p_stack->syms[p_stack->depth], GASM_SYM_LEN, "%s",
+			result);
+		p_stack->depth++;
+	}
+	emit_ins(p_stack, ins);
+
+} /* op() */
+
+
+/* opf()
+ *
+ * in:     p_stack - the stack
+ *         pops    - number of items the instruction pops
+ *         result  - name of the item it pushes, or NULL if none
+ *         format  - printf-style format of the instruction, then args
+ * out:    p_stack - updated for the instruction
+ * return: nothing
+ */
+
+static void
+opf(gasm_stack_t *p_stack, int pops, const char *result,
+	const char *format, ...) {
+
+	char ins[VSR_LINE_MAX_LEN];
+	va_list args;
+
+	va_start(args, format);
+	vsnprintf(ins, sizeof(ins), format, args);
+	va_end(args);
+	op(p_stack, pops, result, ins);
+
+} /* opf() */
+
+
+/* op_roll()
+ *
+ * in:     p_stack - the stack
+ *         n       - depth to move the top item down to
+ * out:    p_stack - updated for ROLL n
+ * return: nothing
+ */
+
+static void
+op_roll(gasm_stack_t *p_stack, int n) {
+
+	char top[GASM_SYM_LEN];
+	int d;
+
+	memcpy(top, p_stack->syms[p_stack->depth - 1], GASM_SYM_LEN);
+	for (d = p_stack->depth - 1; d > (p_stack->depth - n); d--)
+		memcpy(p_stack->syms[d], p_stack->syms[d - 1], GASM_SYM_LEN);
+	memcpy(p_stack->syms[p_stack->depth - n], top, GASM_SYM_LEN);
+	opf(p_stack, 0, NULL, "ROLL %d", n);
+
+} /* op_roll() */
+
+
+/* op_fetch()
+ *
+ * in:     p_stack - the stack
+ *         sym     - name of the item to copy
+ * out:    p_stack - a copy of the topmost item named sym pushed
+ * return: nothing
+ *
+ * Grunt has no instruction that copies one item from deep in the
+ * stack, so this writes DUP d, copying the top d items down to the
+ * one wanted, and then POP d-1 to drop all but that one.
+ */
+
+static void
+op_fetch(gasm_stack_t *p_stack, const char *sym) {
+
+	int d, k;
+
+	for (d = 1; d <= p_stack->depth; d++)
+		if (!strcmp(p_stack->syms[p_stack->depth - d], sym)) break;
+	if (d > p_stack->depth) {
+		fprintf(stderr, "vsrules: no %s on the stack\n", sym);
+		exit(-1);
+	}
+
+	for (k = 0; k < d; k++)
+		memcpy(p_stack->syms[p_stack->depth + k],
+			p_stack->syms[p_stack->depth - d + k], GASM_SYM_LEN);
+	p_stack->depth += d;
+	opf(p_stack, 0, NULL, "DUP %d", d);
+	if (d > 1) opf(p_stack, d - 1, NULL, "POP %d", d - 1);
+
+} /* op_fetch() */
+
+
+/* rename_depth()
+ *
+ * in:     p_stack - the stack
+ *         d       - depth of the item to rename, 1 for the top
+ *         sym     - new name for the item
+ * out:    p_stack - item renamed
+ * return: nothing
+ */
+
+static void
+rename_depth(gasm_stack_t *p_stack, int d, const char *sym) {
+
+	snprintf(p_stack->syms[p_stack->depth - d], GASM_SYM_LEN, "%s", sym);
+
+} /* rename_depth() */
+
+
+/* sub_name()
+ *
+ * in:     r - index of a rule in the spec
+ * out:    name - set to the name of the subroutine that sends rule r's
+ *                event
+ * return: nothing
+ */
+
+static void
+sub_name(int r, char *name) {
+
+	const vsr_rule_t *p_rule = &(gasm_spec->rules[r]);
+	const char *eid = p_rule->eid;
+	size_t n = strlen(eid);
+
+	if ((n > 4) && !strcmp(eid + n - 4, "_EID")) n -= 4;
+	snprintf(name, VSR_NAME_MAX_LEN, "EMIT_%.*s", (int)n, eid);
+	for (n = 0; n < (size_t)r; n++) {
+		if (!strcmp(gasm_spec->rules[n].eid, eid)) {
+			snprintf(name + strlen(name), VSR_NAME_MAX_LEN -
+				strlen(name), "_%d", r + 1);
+			break;
+		}
+	}
+
+} /* sub_name() */
+
+
+/* class_sub()
+ *
+ * in:     c - index of a class in the spec
+ * out:    name - set to the name of the subroutine that tests whether
+ *                a parm ID is of class c
+ * return: nothing
+ */
+
+static void
+class_sub(int c, char *name) {
+
+	const char *p_char = gasm_spec->classes[c].name;
+	size_t n;
+
+	strcpy(name, "IS_");
+	for (n = 3; *p_char && (n < (VSR_NAME_MAX_LEN - 1)); p_char++)
+		name[n++] = toupper((unsigned char)*p_char);
+	name[n] = '\0';
+
+} /* class_sub() */
+
+
+/* check_sub()
+ *
+ * in:     kind    - kind of entry
+ *         p_class - class of the entry if it is in use, else NULL
+ * out:    name    - set to the name of the subroutine that checks
+ *                   entries of that kind and class
+ * return: nothing
+ */
+
+static void
+check_sub(vsr_kind_t kind, const vsr_class_t *p_class, char *name) {
+
+	const char *p_char;
+	size_t n;
+
+	if (kind == vk_invalid) {
+		strcpy(name, "CHECK_INVALID");
+	} else if (kind == vk_unused) {
+		strcpy(name, "CHECK_UNUSED");
+	} else {
+		strcpy(name, "CHECK_");
+		for (p_char = p_class->name, n = 6;
+			*p_char && (n < (VSR_NAME_MAX_LEN - 1)); p_char++)
+			name[n++] = toupper((unsigned char)*p_char);
+		name[n] = '\0';
+	}
+
+} /* check_sub() */
+
+
+/* emit_cond()
+ *
+ * in:     p_stack - the stack, holding the entry's fields
+ *         p_rule  - rule whose condition to evaluate
+ *         p_class - class of the entry, for outside
+ * out:    p_stack - c, the condition's Bool value, pushed
+ * return: nothing
+ */
+
+static void
+emit_cond(gasm_stack_t *p_stack, const vsr_rule_t *p_rule,
+	const vsr_class_t *p_class) {
+
+	static const char *syms[VSR_NUM_FIELDS] = { "pa", "lo", "hi" };
+	int f, n = 0;
+
+	switch (p_rule->cond) {
+	case vc_always:
+		op(p_stack, 0, "c", "PUSHB true");
+		break;
+	case vc_nonzero:
+		for (f = 0; f < p_rule->num_fields; f++) {
+			op_fetch(p_stack, syms[p_rule->fields[f]]);
+			n++;
+			if (p_rule->fields[f] == vf_pad) {
+				op_fetch(p_stack, "pb");
+				n++;
+			}
+		}
+		op(p_stack, 0, "0", "PUSHN 0");
+		opf(p_stack, n + 1, "z", "EQ %d", n + 1);
+		op(p_stack, 1, "c", "NOT");
+		break;
+	case vc_outside:
+		op_fetch(p_stack, syms[p_rule->fields[0]]);
+		opf(p_stack, 0, "min", "PUSHN %s", p_class->min);
+		op(p_stack, 2, "lt", "LT");
+		op_fetch(p_stack, syms[p_rule->fields[0]]);
+		opf(p_stack, 0, "max", "PUSHN %s", p_class->max);
+		op(p_stack, 2, "gt", "GT");
+		op(p_stack, 2, "c", "OR 2");
+		break;
+	case vc_greater:
+		op_fetch(p_stack, syms[p_rule->fields[0]]);
+		op_fetch(p_stack, syms[p_rule->fields[1]]);
+		op(p_stack, 2, "c", "GT");
+		break;
+	case vc_after_unused:
+		op_fetch(p_stack, "u");
+		op(p_stack, 0, "0", "PUSHN 0");
+		op(p_stack, 2, "z", "EQ 2");
+		op(p_stack, 1, "c", "NOT");
+		break;
+	case vc_redefines:
+		op_fetch(p_stack, "r");
+		rename_depth(p_stack, 1, "c");
+		break;
+	}
+
+} /* emit_cond() */
+
+
+/* emit_check_sub()
+ *
+ * in:     kind    - kind of entry to check
+ *         p_class - class of the entry if it is in use, else NULL
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes a subroutine that checks an entry of the given kind and
+ * class against the rules for its kind, sending an event for each
+ * that holds, and bumps u or v if none do.
+ */
+
+static void
+emit_check_sub(vsr_kind_t kind, const vsr_class_t *p_class) {
+
+	static const char *inputs[] = { "u", "v", "p", "r", "e", "pa",
+		"pb", "lo", "hi" };
+	vsr_piece_t pieces[VSR_MAX_PIECES];
+	gasm_stack_t stack = { .depth = 0 };
+	const vsr_rule_t *p_rule;
+	char name[VSR_NAME_MAX_LEN];
+	int fields = (gasm_redefines ? 6 : 5);  /* items above p */
+	int num_pieces, num_args, a, r;
+	bool first = true;
+
+	for (a = 0; a < (int)(sizeof(inputs) / sizeof(inputs[0])); a++) {
+		if ((a == 3) && !gasm_redefines) continue;
+		strcpy(stack.syms[stack.depth++], inputs[a]);
+	}
+
+	check_sub(kind, p_class, name);
+	fprintf(gasm_out, "\n\n.sub %s\n\t; %s:\n\t;", name, name);
+	for (a = 0; a < stack.depth; a++)
+		fprintf(gasm_out, " %s", stack.syms[a]);
+	fprintf(gasm_out, " -- p u v\n\t;\n\t; Checks entry e, ");
+	if (kind == vk_invalid) {
+		fprintf(gasm_out, "whose parm ID is invalid.\n");
+	} else if (kind == vk_unused) {
+		fprintf(gasm_out, "whose parm ID is %s.\n",
+			gasm_spec->unused_id);
+	} else {
+		fprintf(gasm_out, "whose parm ID is of class %s.\n",
+			p_class->name);
+	}
+
+	for (r = 0; r < gasm_spec->num_rules; r++) {
+		p_rule = &(gasm_spec->rules[r]);
+		if (p_rule->kind != kind) continue;
+
+		emit_comment(p_rule->eid);
+		emit_cond(&stack, p_rule, p_class);
+		if (p_rule->cond != vc_always) {
+			op(&stack, 0, "c", "DUP 1");
+			op(&stack, 1, "!c", "NOT");
+			opf(&stack, 1, NULL, "JMPIF not_%d", r + 1);
+		}
+
+		/* Push the event's args, the first on top. */
+		num_pieces = segments(p_rule->text, kind, pieces);
+		for (num_args = 0, a = num_pieces - 1; a >= 0; a--) {
+			if (pieces[a].placeholder == 'N') {
+				op_fetch(&stack, "e");
+				num_args++;
+			} else if (pieces[a].placeholder == 'P') {
+				op_fetch(&stack, "p");
+				num_args++;
+			}
+		}
+		sub_name(r, name);
+		opf(&stack, num_args, NULL, "CALL %s", name);
+		if (p_rule->cond != vc_always)
+			snprintf(gasm_label, sizeof(gasm_label), "not_%d",
+				r + 1);
+
+		if (first) {
+			rename_depth(&stack, 1, "bad");
+			first = false;
+		} else {
+			op(&stack, 2, "bad", "OR 2");
+		}
+	}
+	if (first) op(&stack, 0, "bad", "PUSHB false");
+
+	emit_comment("Drop the fields and count the entry if it's valid.");
+	if (kind == vk_invalid) {
+		opf(&stack, fields + 1, NULL, "POP %d", fields + 1);
+		op_roll(&stack, 3);
+		emit_plain("RETURN");
+		return;
+	}
+	op_roll(&stack, fields + 1);
+	opf(&stack, fields, NULL, "POP %d", fields);
+	op_roll(&stack, 2);
+	op_roll(&stack, 4);
+	op(&stack, 1, NULL, "JMPIF invalid");
+	if (kind == vk_unused) {
+		op_roll(&stack, 2);
+		op(&stack, 0, "1", "PUSHN 1");
+		op(&stack, 2, "u", "ADD");
+		op_roll(&stack, 2);
+	} else {
+		op(&stack, 0, "1", "PUSHN 1");
+		op(&stack, 2, "v", "ADD");
+	}
+	emit_plain("RETURN");
+	fprintf(gasm_out, "\n");
+	strcpy(gasm_label, "invalid");
+	emit_plain("RETURN");
+
+} /* emit_check_sub() */
+
+
+/* emit_entry()
+ *
+ * in:     p_stack - the stack: p1...p(k-1) u v
+ *         k       - number of the entry to check, from 1
+ * out:    p_stack - p1...pk u v
+ * return: nothing
+ *
+ * Writes MAIN's code for entry k: it reads the entry's parm ID, sees
+ * whether an earlier entry has the same one, and calls CHECK_ENTRY.
+ */
+
+static void
+emit_entry(gasm_stack_t *p_stack, int k) {
+
+	char sym[GASM_SYM_LEN];  /* name of an earlier entry's parm ID */
+	int j;
+
+	snprintf(sym, sizeof(sym), "Entry %d.", k);
+	emit_comment(sym);
+	op(p_stack, 0, "p", "INPUT 1");
+	if (gasm_redefines) {
+		for (j = 1; j < k; j++) {
+			snprintf(sym, sizeof(sym), "p%d", j);
+			op_fetch(p_stack, "p");
+			op_fetch(p_stack, sym);
+			opf(p_stack, 2, "r", "EQ 2");
+		}
+		if (k == 1) op(p_stack, 0, "r", "PUSHB false");
+		if (k > 2) opf(p_stack, k - 1, "r", "OR %d", k - 1);
+	}
+	opf(p_stack, 0, "e", "PUSHN %d", k);
+	op(p_stack, (gasm_redefines ? 5 : 4), NULL, "CALL CHECK_ENTRY");
+	snprintf(sym, sizeof(sym), "p%d", k);
+	strcpy(p_stack->syms[p_stack->depth++], sym);
+	strcpy(p_stack->syms[p_stack->depth++], "u");
+	strcpy(p_stack->syms[p_stack->depth++], "v");
+
+} /* emit_entry() */
+
+
+/* emit_check_entry_sub()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes CHECK_ENTRY, which reads the rest of an entry and calls the
+ * subroutine that checks entries of its kind and class.
+ */
+
+static void
+emit_check_entry_sub(void) {
+
+	static const char *inputs[] = { "u", "v", "p", "r", "e" };
+	gasm_stack_t stack = { .depth = 0 };
+	gasm_stack_t fields;     /* the stack as each check starts */
+	char name[VSR_NAME_MAX_LEN];
+	char sym[GASM_SYM_LEN];
+	int a, c;
+
+	for (a = 0; a < (int)(sizeof(inputs) / sizeof(inputs[0])); a++) {
+		if ((a == 3) && !gasm_redefines) continue;
+		strcpy(stack.syms[stack.depth++], inputs[a]);
+	}
+
+	fprintf(gasm_out, "\n\n.sub CHECK_ENTRY\n\t; CHECK_ENTRY:\n\t;");
+	for (a = 0; a < stack.depth; a++)
+		fprintf(gasm_out, " %s", stack.syms[a]);
+	fprintf(gasm_out, " -- p u v\n\t;\n\t; Reads the rest of entry e, "
+		"whose parm ID is p, then checks it\n\t; with the subroutine "
+		"for its kind and class.%s\n", (gasm_redefines ? "  r is "
+		"true if\n\t; an earlier entry has parm ID p." : ""));
+	op(&stack, 0, "pa", "INPUT 1");
+	op(&stack, 0, "pb", "INPUT 2");
+	op(&stack, 0, "lo", "INPUT 4");
+	op(&stack, 0, "hi", "INPUT 4");
+	op_fetch(&stack, "p");
+	opf(&stack, 0, "U", "PUSHN %s", gasm_spec->unused_id);
+	op(&stack, 2, "unused?", "EQ 2");
+	op(&stack, 1, NULL, "JMPIF unused");
+	for (c = 0; c < gasm_spec->num_classes; c++) {
+		op_fetch(&stack, "p");
+		snprintf(sym, sizeof(sym), "%.*s?", GASM_SYM_LEN - 2,
+			gasm_spec->classes[c].name);
+		class_sub(c, name);
+		opf(&stack, 1, sym, "CALL %s", name);
+		opf(&stack, 1, NULL, "JMPIF %s", gasm_spec->classes[c].name);
+	}
+	fields = stack;
+
+	check_sub(vk_invalid, NULL, name);
+	opf(&stack, stack.depth, NULL, "CALL %s", name);
+	emit_plain("RETURN");
+
+	fprintf(gasm_out, "\n");
+	strcpy(gasm_label, "unused");
+	stack = fields;
+	check_sub(vk_unused, NULL, name);
+	opf(&stack, stack.depth, NULL, "CALL %s", name);
+	emit_plain("RETURN");
+
+	for (c = 0; c < gasm_spec->num_classes; c++) {
+		fprintf(gasm_out, "\n");
+		strcpy(gasm_label, gasm_spec->classes[c].name);
+		stack = fields;
+		check_sub(vk_inuse, &(gasm_spec->classes[c]), name);
+		opf(&stack, stack.depth, NULL, "CALL %s", name);
+		emit_plain("RETURN");
+	}
+
+} /* emit_check_entry_sub() */
+
+
+/* emit_is_class()
+ *
+ * in:     c - index of the class to write a test subroutine for
+ * out:    nothing
+ * return: nothing
+ */
+
+static void
+emit_is_class(int c) {
+
+	const vsr_class_t *p_class = &(gasm_spec->classes[c]);
+	gasm_stack_t stack = { .depth = 0 };
+	char name[VSR_NAME_MAX_LEN];
+	char sym[GASM_SYM_LEN];
+	int p, n = 0, num_members = 0;
+
+	for (p = 0; p < gasm_spec->num_parms; p++)
+		num_members += (gasm_spec->parms[p].class == c);
+
+	class_sub(c, name);
+	fprintf(gasm_out, "\n\n.sub %s\n\t; %s:\n\t; parmid -- %s?\n", name,
+		name, p_class->name);
+	strcpy(stack.syms[0], "parmid");
+	stack.depth = 1;
+	if (num_members == 0) {
+		op(&stack, 1, NULL, "POP 1");
+		op(&stack, 0, "false", "PUSHB false");
+	}
+	for (p = 0; p < gasm_spec->num_parms; p++) {
+		if (gasm_spec->parms[p].class != c) continue;
+		snprintf(sym, sizeof(sym), "%.*s?", GASM_SYM_LEN - 2,
+			gasm_spec->parms[p].name);
+		if (++n < num_members) op(&stack, 0, "parmid", "DUP 1");
+		opf(&stack, 0, "id", "PUSHN %s", gasm_spec->parms[p].id);
+		op(&stack, 2, sym, "EQ 2");
+		if (n < num_members) op_roll(&stack, 2);
+	}
+	snprintf(sym, sizeof(sym), "%.*s?", GASM_SYM_LEN - 2,
+		p_class->name);
+	if (num_members > 1) opf(&stack, num_members, sym, "OR %d",
+		num_members);
+	emit_plain("RETURN");
+
+} /* emit_is_class() */
+
+
+/* emit_event_sub()
+ *
+ * in:     name - name of the subroutine
+ *         eid  - event ID constant
+ *         type - event type constant
+ *         text - event text
+ *         kind - kind of entry the event is for, or VSR_NUM_KINDS
+ *                for the summary
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes a subroutine that sends an event.  It takes the event's
+ * args from the stack, the first on top.
+ */
+
+static void
+emit_event_sub(const char *name, const char *eid, const char *type,
+	const char *text, vsr_kind_t kind) {
+
+	vsr_piece_t pieces[VSR_MAX_PIECES];
+	gasm_stack_t stack = { .depth = 0 };
+	int num_pieces, a;
+
+	num_pieces = segments(text, kind, pieces);
+	for (a = num_pieces - 1; a >= 0; a--) {
+		if (!pieces[a].placeholder) continue;
+		snprintf(stack.syms[stack.depth++], GASM_SYM_LEN, "%c",
+			((pieces[a].placeholder == 'N') ? 'e' :
+			tolower((unsigned char)pieces[a].placeholder)));
+	}
+
+	fprintf(gasm_out, "\n\n.sub %s\n\t; %s:\n\t;", name, name);
+	for (a = 0; a < stack.depth; a++)
+		fprintf(gasm_out, " %s", stack.syms[a]);
+	fprintf(gasm_out, " --\n\t;\n\t; Sends %s: \"%s\"\n", eid, text);
+
+	for (a = 0; a < num_pieces; a++) {
+		if (!pieces[a].placeholder) {
+			opf(&stack, 0, "str", "PUSHS %s",
+				intern(pieces[a].text));
+		} else if (pieces[a].placeholder == 'P') {
+			op(&stack, 1, "ps", "CALL PARM_TO_STR");
+		}
+		op(&stack, 1, NULL, "OUTPUT");
+	}
+	opf(&stack, 0, "eid", "PUSHN %s", eid);
+	opf(&stack, 0, "etype", "PUSHN %s", type);
+	op(&stack, 2, NULL, "FLUSH");
+	emit_plain("RETURN");
+
+} /* emit_event_sub() */
+
+
+/* emit_parm_to_str()
+ *
+ * in:     nothing
+ * out:    nothing
+ * return: nothing
+ *
+ * Writes the PARM_TO_STR subroutine, which turns a parm ID into the
+ * parm's name.
+ */
+
+static void
+emit_parm_to_str(void) {
+
+	gasm_stack_t stack = { .depth = 0 };
+	char sym[GASM_SYM_LEN];
+	const char *id, *parm_name;
+	size_t n;
+	int p;
+
+	fprintf(gasm_out, "\n\n.sub PARM_TO_STR\n\t; PARM_TO_STR:\n"
+		"\t; parmid -- parmstring\n");
+	for (p = -1; p < gasm_spec->num_parms; p++) {
+		id = ((p < 0) ? gasm_spec->unused_id : gasm_spec->parms[p].id);
+		parm_name = ((p < 0) ? gasm_spec->unused_name :
+			gasm_spec->parms[p].name);
+		strcpy(sym, "not_");
+		for (n = 4; *parm_name && (n < (GASM_SYM_LEN - 1));
+			parm_name++) {
+			sym[n++] = (isalnum((unsigned char)*parm_name) ?
+				tolower((unsigned char)*parm_name) : '_');
+		}
+		sym[n] = '\0';
+		parm_name = ((p < 0) ? gasm_spec->unused_name :
+			gasm_spec->parms[p].name);
+
+		strcpy(stack.syms[0], "parmid");
+		stack.depth = 1;
+		op(&stack, 0, "parmid", "DUP 1");
+		opf(&stack, 0, "code", "PUSHN %s", id);
+		op(&stack, 2, "equal?", "EQ 2");
+		op(&stack, 1, "not-equal?", "NOT");
+		opf(&stack, 1, NULL, "JMPIF %s", sym);
+		op(&stack, 1, NULL, "POP 1");
+		opf(&stack, 0, "string", "PUSHS %s", intern(parm_name));
+		emit_plain("RETURN");
+		fprintf(gasm_out, "\n");
+		strcpy(gasm_label, sym);
+	}
+	stack.depth = 1;
+	op(&stack, 1, NULL, "POP 1");
+	opf(&stack, 0, "string", "PUSHS %s", intern(gasm_spec->unknown_name));
+	emit_plain("RETURN");
+
+} /* emit_parm_to_str() */
+
+
+/* -------------------- module exported functions ------------------ */
+
+
+/* emit_gasm()
+ *
+ * in:     out    - file to write to
+ *         p_spec - the spec to write a validation program for
+ *         prefix - name of the program
+ * out:    nothing
+ * return: nothing
+ */
+
+void
+emit_gasm(FILE *out, const vsr_spec_t *p_spec, const char *prefix) {
+
+	gasm_stack_t stack = { .depth = 0 };
+	vsr_piece_t pieces[VSR_MAX_PIECES];
+	const char *source;   /* spec file name without its directory */
+	const char **p_line;
+	char name[VSR_NAME_MAX_LEN];
+	bool parm_names = false;  /* some event names an in-use parm? */
+	int width;                /* longest string name, for alignment */
+	int num_pieces, num_args, a, c, k, p, r;
+
+	gasm_out = out;
+	gasm_spec = p_spec;
+	gasm_label[0] = '\0';
+	gasm_num_strings = 0;
+	gasm_redefines = false;
+
+	source = strrchr(p_spec->source, '/');
+	source = (source ? (source + 1) : p_spec->source);
+
+	/* Gather the program's strings, in the order it first uses
+	 * them, so PARM_TO_STR's come last.
+	 */
+	for (r = 0; r < p_spec->num_rules; r++) {
+		gasm_redefines |= (p_spec->rules[r].cond == vc_redefines);
+		num_pieces = segments(p_spec->rules[r].text,
+			p_spec->rules[r].kind, pieces);
+		for (a = 0; a < num_pieces; a++) {
+			if (!pieces[a].placeholder) intern(pieces[a].text);
+			if (pieces[a].placeholder == 'P') parm_names = true;
+		}
+	}
+	num_pieces = segments(p_spec->summary_text, VSR_NUM_KINDS, pieces);
+	for (a = 0; a < num_pieces; a++)
+		if (!pieces[a].placeholder) intern(pieces[a].text);
+	if (parm_names) {
+		intern(p_spec->unused_name);
+		for (p = 0; p < p_spec->num_parms; p++)
+			intern(p_spec->parms[p].name);
+		intern(p_spec->unknown_name);
+	}
+
+	fprintf(out, "; Copyright (c) 2024 Timothy Jon Fraser Consulting "
+		"LLC\n;\n");
+	for (p_line = vsr_license; *p_line; p_line++)
+		fprintf(out, ";%s%s\n", (**p_line ? " " : ""), *p_line);
+	fprintf(out, "\n; GENERATED FILE - DO NOT EDIT.\n;\n"
+		"; The vsrules generator generated this file from the "
+		"validation rules\n; in %s.  Edit the rules and run vsrules "
+		"again instead.  The\n; gruntasm assembler translates this "
+		"file into %s.h.\n\n", source, prefix);
+	fprintf(out, ".name %s\n\n", prefix);
+
+	fprintf(out, "; This file contains a Grunt implementation of the "
+		"V-SPELLS table\n; validation rules in %s.  The program "
+		"checks each of the\n; default table's %d entries in turn, "
+		"evaluating the rules for the\n; entry's kind in order and "
+		"sending an event for each one that holds.\n; Then it sends "
+		"a summary event and halts with true if the table is\n; "
+		"valid.\n\n", source, GASM_NUM_ENTRIES);
+
+	for (width = 0, a = 0; a < gasm_num_strings; a++)
+		if ((int)strlen(gasm_strings[a].name) > width)
+			width = (int)strlen(gasm_strings[a].name);
+	fprintf(out, ".strings\n");
+	for (a = 0; a < gasm_num_strings; a++) {
+		fprintf(out, "\t%-*s \"%s\"\n", width, gasm_strings[a].name,
+			gasm_strings[a].text);
+	}
+
+	fprintf(out, "\n; The program reads each entry's parm ID, pad, and "
+		"bounds in turn.\n.record 0 12\n\n.program\n");
+
+	fprintf(out, "\n.sub MAIN\n\t; MAIN:\n\t; -- valid?\n\t;\n"
+		"\t; The entry point of the program.  It checks each entry in "
+		"turn,\n\t; keeping the parm ID of each, p1 p2 and so on, "
+		"beneath u and v,\n\t; the counts of valid unused and valid "
+		"in-use entries so far.\n");
+	emit_comment("Start with no valid entries.");
+	op(&stack, 0, "u", "PUSHN 0");
+	op(&stack, 0, "v", "PUSHN 0");
+	for (k = 1; k <= GASM_NUM_ENTRIES; k++) emit_entry(&stack, k);
+
+	emit_comment("Count the invalid entries and send the summary "
+		"event.");
+	op_fetch(&stack, "u");
+	op_fetch(&stack, "v");
+	op(&stack, 2, "u+v", "ADD");
+	opf(&stack, 0, "n", "PUSHN %d", GASM_NUM_ENTRIES);
+	op_roll(&stack, 2);
+	op(&stack, 2, "i", "SUB");
+	for (num_args = 0, a = num_pieces - 1; a >= 0; a--) {
+		if (pieces[a].placeholder == 'V') op_fetch(&stack, "v");
+		if (pieces[a].placeholder == 'I') op_fetch(&stack, "i");
+		if (pieces[a].placeholder == 'U') op_fetch(&stack, "u");
+		num_args += (pieces[a].placeholder != '\0');
+	}
+	op(&stack, num_args, NULL, "CALL EMIT_SUMMARY");
+
+	emit_comment("The table is valid if no entry is invalid.");
+	op(&stack, 0, "0", "PUSHN 0");
+	op(&stack, 2, "valid?", "EQ 2");
+	op_roll(&stack, stack.depth);
+	opf(&stack, stack.depth - 1, NULL, "POP %d", stack.depth - 1);
+	emit_plain("HALT");
+
+	emit_check_entry_sub();
+	for (c = 0; c < p_spec->num_classes; c++) emit_is_class(c);
+	emit_check_sub(vk_invalid, NULL);
+	emit_check_sub(vk_unused, NULL);
+	for (c = 0; c < p_spec->num_classes; c++)
+		emit_check_sub(vk_inuse, &(p_spec->classes[c]));
+	for (r = 0; r < p_spec->num_rules; r++) {
+		sub_name(r, name);
+		emit_event_sub(name, p_spec->rules[r].eid,
+			"CFE_EVS_EventType_ERROR", p_spec->rules[r].text,
+			p_spec->rules[r].kind);
+	}
+	emit_event_sub("EMIT_SUMMARY", p_spec->summary_eid,
+		"CFE_EVS_EventType_INFORMATION", p_spec->summary_text,
+		VSR_NUM_KINDS);
+	if (parm_names) emit_parm_to_str();
+
+} /* emit_gasm() */
@@ -0,0 +1,641 @@
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* vsrules is a host-side generator of V-SPELLS table validation
+ * functions.  It reads a spec of the validation rules, such as
+ * apps/vs/vs_rules.spec, which describes its own syntax, and writes
+ * either a C header defining a native validation function that
+ * applies the rules, or the Grunt assembly source of a program that
+ * applies the same rules, for gruntasm to assemble.  Either way, the
+ * generated validator sends the events the spec describes, in the
+ * order it describes them, so that validators generated from one spec
+ * all agree.
+ *
+ * Usage:
+ *
+ *   vsrules c    PREFIX spec header.h   write PREFIX_rules_validate()
+ *   vsrules gasm PREFIX spec source.gasm   write Grunt program PREFIX
+ */
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsrules.h"
+
+
+/* ----------------- module private functions and state ------------- */
+
+/* One word of a directive, and whether it was quoted. */
+typedef struct {
+	char text[VSR_TEXT_MAX_LEN];
+	bool quoted;
+} vsr_word_t;
+
+static vsr_spec_t spec;               /* too big for the stack */
+static vsr_word_t words[VSR_MAX_WORDS];
+static int num_words = 0;             /* in the directive being read */
+static int directive_line = 0;        /* line the directive began on */
+static int line_number = 0;           /* of the line being read */
+static int error_count = 0;
+
+
+/* error()
+ *
+ * in:     line   - spec line number the error is on
+ *         format - printf()-style message format, then its args
+ * out:    nothing
+ * return: nothing
+ *
+ * Reports an error in the spec.  The generator keeps going so it can
+ * report as many errors as possible, but writes no output.
+ */
+
+static void
+error(int line, const char *format, ...) {
+
+	va_list args;
+
+	fprintf(stderr, "%s:%d: ", spec.source, line);
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+	fprintf(stderr, "\n");
+	error_count++;
+
+} /* error() */
+
+
+/* is_name()
+ *
+ * in:     s - string to check
+ * out:    nothing
+ * return: true if s is a C-style identifier that fits in a name.
+ */
+
+static bool
+is_name(const char *s) {
+
+	size_t i;
+
+	if (!(isalpha((unsigned char)s[0]) || (s[0] == '_'))) return false;
+	for (i = 1; s[i]; i++) {
+		if (!(isalnum((unsigned char)s[i]) || (s[i] == '_')))
+			return false;
+	}
+	return (i < VSR_NAME_MAX_LEN);
+
+} /* is_name() */
+
+
+/* find_class()
+ *
+ * in:     name - class name to look up
+ * out:    nothing
+ * return: index of the class in spec.classes[], or -1 if none.
+ */
+
+static int
+find_class(const char *name) {
+
+	int c;
+
+	for (c = 0; c < spec.num_classes; c++) {
+		if (!strcmp(spec.classes[c].name, name)) return c;
+	}
+	return -1;
+
+} /* find_class() */
+
+
+/* check_text()
+ *
+ * in:     text    - event text
+ *         allowed - the placeholder letters it may use
+ * out:    nothing
+ * return: nothing
+ *
+ * Reports event texts that won't split or that use placeholders the
+ * directive has no value for.
+ */
+
+static void
+check_text(const char *text, const char *allowed) {
+
+	vsr_piece_t pieces[VSR_MAX_PIECES];
+	int num_pieces, k;
+
+	if ((num_pieces = vsr_split(text, pieces)) < 0) {
+		error(directive_line, "event text has too many pieces");
+		return;
+	}
+	for (k = 0; k < num_pieces; k++) {
+		if (pieces[k].placeholder &&
+			!strchr(allowed, pieces[k].placeholder)) {
+			error(directive_line, "event text can't use %c here",
+				pieces[k].placeholder);
+		}
+	}
+
+} /* check_text() */
+
+
+/* parse_field()
+ *
+ * in:     word - name of an entry field
+ * out:    p_field - set to the field
+ * return: true if word names a field.
+ */
+
+static bool
+parse_field(const char *word, vsr_field_t *p_field) {
+
+	static const char *names[VSR_NUM_FIELDS] = { "pad", "low", "high" };
+	int f;
+
+	for (f = 0; f < VSR_NUM_FIELDS; f++) {
+		if (!strcmp(word, names[f])) {
+			*p_field = (vsr_field_t)f;
+			return true;
+		}
+	}
+	return false;
+
+} /* parse_field() */
+
+
+/* parse_rule()
+ *
+ * in:     words - the rule directive's words
+ * out:    spec  - rule appended
+ * return: nothing
+ */
+
+static void
+parse_rule(void) {
+
+	static const char *kinds[VSR_NUM_KINDS] =
+		{ "unused", "inuse", "invalid" };
+	vsr_rule_t *p_rule;
+	int args;                         /* words after the condition */
+	int k, r, in_kind = 0;
+
+	if ((num_words < 5) || words[1].quoted || words[2].quoted ||
+		words[3].quoted || !words[num_words - 1].quoted) {
+		error(directive_line, "rule needs a kind, an event ID, a "
+			"condition, and a quoted text");
+		return;
+	}
+	if (spec.num_rules == (VSR_MAX_RULES * VSR_NUM_KINDS)) {
+		error(directive_line, "too many rules");
+		return;
+	}
+	p_rule = &(spec.rules[spec.num_rules]);
+	memset(p_rule, 0, sizeof(*p_rule));
+	p_rule->line = directive_line;
+
+	for (k = 0; k < VSR_NUM_KINDS; k++) {
+		if (!strcmp(words[1].text, kinds[k])) break;
+	}
+	if (k == VSR_NUM_KINDS) {
+		error(directive_line, "unknown entry kind %s", words[1].text);
+		return;
+	}
+	p_rule->kind = (vsr_kind_t)k;
+	for (r = 0; r < spec.num_rules; r++)
+		in_kind += (spec.rules[r].kind == p_rule->kind);
+	if (in_kind == VSR_MAX_RULES) {
+		error(directive_line, "too many %s rules", kinds[k]);
+		return;
+	}
+
+	if (!is_name(words[2].text)) {
+		error(directive_line, "bad event ID %s", words[2].text);
+		return;
+	}
+	strcpy(p_rule->eid, words[2].text);
+
+	args = num_words - 5;
+	for (k = 0; k < args; k++) {
+		if (words[4 + k].quoted || !parse_field(words[4 + k].text,
+			&(p_rule->fields[p_rule->num_fields]))) {
+			error(directive_line, "unknown field %s",
+				words[4 + k].text);
+			return;
+		}
+		for (r = 0; r < p_rule->num_fields; r++) {
+			if (p_rule->fields[r] ==
+				p_rule->fields[p_rule->num_fields]) {
+				error(directive_line, "field %s named twice",
+					words[4 + k].text);
+				return;
+			}
+		}
+		p_rule->num_fields++;
+	}
+
+	if (!strcmp(words[3].text, "always") && (args == 0)) {
+		p_rule->cond = vc_always;
+	} else if (!strcmp(words[3].text, "nonzero") && (args > 0)) {
+		p_rule->cond = vc_nonzero;
+	} else if (!strcmp(words[3].text, "outside") && (args == 1) &&
+		(p_rule->fields[0] != vf_pad) &&
+		(p_rule->kind == vk_inuse)) {
+		p_rule->cond = vc_outside;
+	} else if (!strcmp(words[3].text, "greater") && (args == 2) &&
+		(p_rule->fields[0] != vf_pad) &&
+		(p_rule->fields[1] != vf_pad)) {
+		p_rule->cond = vc_greater;
+	} else if (!strcmp(words[3].text, "after_unused") && (args == 0)) {
+		p_rule->cond = vc_after_unused;
+	} else if (!strcmp(words[3].text, "redefines") && (args == 0) &&
+		(p_rule->kind == vk_inuse)) {
+		p_rule->cond = vc_redefines;
+	} else {
+		error(directive_line, "bad %s condition %s", words[1].text,
+			words[3].text);
+		return;
+	}
+
+	if (strlen(words[num_words - 1].text) >= sizeof(p_rule->text)) {
+		error(directive_line, "event text too long");
+		return;
+	}
+	strcpy(p_rule->text, words[num_words - 1].text);
+	check_text(p_rule->text, "NP");
+	spec.num_rules++;
+
+} /* parse_rule() */
+
+
+/* copy_name()
+ *
+ * in:     dst  - buffer of VSR_NAME_MAX_LEN or VSR_TEXT_MAX_LEN bytes
+ *         size - size of dst
+ *         p_w  - word to copy
+ *         name - true if it must be a C name, false if as printed
+ * out:    dst  - holds the word
+ * return: true if the word fits and is of the right form.
+ */
+
+static bool
+copy_name(char *dst, size_t size, const vsr_word_t *p_w, bool name) {
+
+	if (name ? (p_w->quoted || !is_name(p_w->text)) :
+		!p_w->text[0]) {
+		error(directive_line, "bad %s %s", (name ? "name" : "text"),
+			p_w->text);
+		return false;
+	}
+	if (strlen(p_w->text) >= size) {
+		error(directive_line, "%s too long", p_w->text);
+		return false;
+	}
+	strcpy(dst, p_w->text);
+	return true;
+
+} /* copy_name() */
+
+
+/* parse_directive()
+ *
+ * in:     words - the directive and its arguments
+ * out:    spec  - updated as the directive directs
+ * return: nothing
+ */
+
+static void
+parse_directive(void) {
+
+	const char *d = words[0].text;
+	vsr_class_t *p_class;
+	vsr_parm_t *p_parm;
+	vsr_wide_t *p_wide;
+	int p;
+
+	if (!num_words) return;
+
+	if (!strcmp(d, "class") && (num_words == 4)) {
+		if (spec.num_classes == VSR_MAX_CLASSES) {
+			error(directive_line, "too many classes");
+			return;
+		}
+		if (find_class(words[1].text) >= 0) {
+			error(directive_line, "class %s defined twice",
+				words[1].text);
+			return;
+		}
+		p_class = &(spec.classes[spec.num_classes]);
+		if (copy_name(p_class->name, sizeof(p_class->name),
+			&(words[1]), true) &&
+			copy_name(p_class->min, sizeof(p_class->min),
+			&(words[2]), true) &&
+			copy_name(p_class->max, sizeof(p_class->max),
+			&(words[3]), true))
+			spec.num_classes++;
+	} else if (!strcmp(d, "unused") && (num_words == 3)) {
+		if (spec.unused_id[0]) {
+			error(directive_line, "unused defined twice");
+			return;
+		}
+		if (copy_name(spec.unused_id, sizeof(spec.unused_id),
+			&(words[1]), true))
+			copy_name(spec.unused_name,
+				sizeof(spec.unused_name), &(words[2]),
+				false);
+	} else if (!strcmp(d, "parm") && (num_words == 4)) {
+		if (spec.num_parms == VSR_MAX_PARMS) {
+			error(directive_line, "too many parms");
+			return;
+		}
+		for (p = 0; p < spec.num_parms; p++) {
+			if (!strcmp(spec.parms[p].id, words[1].text)) {
+				error(directive_line, "parm %s defined twice",
+					words[1].text);
+				return;
+			}
+		}
+		if (!strcmp(spec.unused_id, words[1].text)) {
+			error(directive_line, "parm %s is the unused ID",
+				words[1].text);
+			return;
+		}
+		p_parm = &(spec.parms[spec.num_parms]);
+		if ((p_parm->class = find_class(words[3].text)) < 0) {
+			error(directive_line, "no class %s", words[3].text);
+			return;
+		}
+		if (copy_name(p_parm->id, sizeof(p_parm->id), &(words[1]),
+			true) && copy_name(p_parm->name,
+			sizeof(p_parm->name), &(words[2]), false))
+			spec.num_parms++;
+	} else if (!strcmp(d, "wide") && (num_words == 4)) {
+		if (spec.num_wides == VSR_MAX_WIDES) {
+			error(directive_line, "too many wide runs");
+			return;
+		}
+		p_wide = &(spec.wides[spec.num_wides]);
+		if ((p_wide->class = find_class(words[1].text)) < 0) {
+			error(directive_line, "no class %s", words[1].text);
+			return;
+		}
+		if (copy_name(p_wide->id, sizeof(p_wide->id), &(words[2]),
+			true) && copy_name(p_wide->name,
+			sizeof(p_wide->name), &(words[3]), false))
+			spec.num_wides++;
+	} else if (!strcmp(d, "unknown") && (num_words == 2)) {
+		if (spec.unknown_name[0]) {
+			error(directive_line, "unknown defined twice");
+			return;
+		}
+		copy_name(spec.unknown_name, sizeof(spec.unknown_name),
+			&(words[1]), false);
+	} else if (!strcmp(d, "rule")) {
+		parse_rule();
+	} else if (!strcmp(d, "summary") && (num_words == 3) &&
+		words[2].quoted) {
+		if (spec.summary_eid[0]) {
+			error(directive_line, "summary defined twice");
+			return;
+		}
+		if (copy_name(spec.summary_eid, sizeof(spec.summary_eid),
+			&(words[1]), true) && copy_name(spec.summary_text,
+			sizeof(spec.summary_text), &(words[2]), false))
+			check_text(spec.summary_text, "VIU");
+	} else {
+		error(directive_line, "bad %s directive", d);
+	}
+
+} /* parse_directive() */
+
+
+/* parse_line()
+ *
+ * in:     line - spec line, without its newline
+ * out:    words - line's words added to the directive being read, or
+ *                 the last directive parsed and a new one begun
+ * return: nothing
+ *
+ * A line that begins with a space or tab continues the directive on
+ * the lines above it.  Blank lines and comment lines don't end a
+ * directive.
+ */
+
+static void
+parse_line(char *line) {
+
+	vsr_word_t *p_w;
+	char *p = line;
+	size_t n;
+
+	while (isspace((unsigned char)*p)) p++;
+	if (!*p || (*p == '#')) return;    /* blank or comment line */
+
+	p = line;
+	if (!isspace((unsigned char)*p)) {
+		parse_directive();
+		num_words = 0;
+		directive_line = line_number;
+	}
+
+	for (;;) {
+		while (isspace((unsigned char)*p)) p++;
+		if (!*p || (*p == '#')) return;
+
+		if (num_words == VSR_MAX_WORDS) {
+			error(line_number, "too many words");
+			return;
+		}
+		if (!directive_line) {
+			error(line_number, "continuation of no directive");
+			return;
+		}
+		p_w = &(words[num_words++]);
+		n = 0;
+		if ((p_w->quoted = (*p == '"'))) {
+			for (p++; *p && (*p != '"'); p++) {
+				if (n < (sizeof(p_w->text) - 1))
+					p_w->text[n++] = *p;
+			}
+			if (*p != '"') {
+				error(line_number, "unterminated string");
+				num_words--;
+				return;
+			}
+			p++;
+		} else {
+			for (; *p && !isspace((unsigned char)*p) &&
+				(*p != '#'); p++) {
+				if (n < (sizeof(p_w->text) - 1))
+					p_w->text[n++] = *p;
+			}
+		}
+		p_w->text[n] = '\0';
+	}
+
+} /* parse_line() */
+
+
+/* check_spec()
+ *
+ * in:     spec - the whole spec, as read
+ * out:    nothing
+ * return: nothing
+ *
+ * Reports what the directives leave out.
+ */
+
+static void
+check_spec(void) {
+
+	int c, p;
+
+	if (!spec.unused_id[0]) error(line_number, "no unused directive");
+	if (!spec.unknown_name[0])
+		error(line_number, "no unknown directive");
+	if (!spec.summary_eid[0])
+		error(line_number, "no summary directive");
+	for (c = 0; c < spec.num_classes; c++) {
+		for (p = 0; p < spec.num_parms; p++) {
+			if (spec.parms[p].class == c) break;
+		}
+		if (p == spec.num_parms) {
+			error(line_number, "class %s has no parms",
+				spec.classes[c].name);
+		}
+	}
+	if (!spec.num_classes) error(line_number, "no classes");
+
+} /* check_spec() */
+
+
+/* -------------------- module exported functions ------------------ */
+
+const char *vsr_license[] = {
+	"Licensed under the Apache License, Version 2.0 (the \"License\");",
+	"you may not use this file except in compliance with the License.",
+	"You may obtain a copy of the License at",
+	"",
+	"   http://www.apache.org/licenses/LICENSE-2.0",
+	"",
+	"Unless required by applicable law or agreed to in writing, software",
+	"distributed under the License is distributed on an \"AS IS\" BASIS,",
+	"WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or",
+	"implied.  See the License for the specific language governing",
+	"permissions and limitations under the License.",
+	NULL
+};
+
+
+/* vsr_split()
+ *
+ * in:     text     - event text
+ * out:    p_pieces - filled with text's pieces, in order
+ * return: the number of pieces, or -1 if there are more than
+ *         VSR_MAX_PIECES.
+ *
+ * A placeholder is one of the letters N, P, V, I, or U standing
+ * alone as a word, so that "N" is one but the N in "Name" isn't.
+ */
+
+int
+vsr_split(const char *text, vsr_piece_t *p_pieces) {
+
+	int num_pieces = 0;
+	size_t i, n = 0;            /* n counts the current text piece */
+	bool alone;
+
+	for (i = 0; text[i]; i++) {
+		alone = strchr("NPVIU", text[i]) &&
+			((i == 0) || !isalnum((unsigned char)text[i - 1])) &&
+			!isalnum((unsigned char)text[i + 1]);
+		if (alone || !n) {
+			if (num_pieces == VSR_MAX_PIECES) return -1;
+			memset(&(p_pieces[num_pieces]), 0,
+				sizeof(p_pieces[num_pieces]));
+			num_pieces++;
+			n = 0;
+		}
+		if (alone) {
+			p_pieces[num_pieces - 1].placeholder = text[i];
+			continue;      /* n stays 0: next char starts a piece */
+		}
+		p_pieces[num_pieces - 1].text[n++] = text[i];
+	}
+	return num_pieces;
+
+} /* vsr_split() */
+
+
+int
+main(int argc, char *argv[]) {
+
+	char line[VSR_LINE_MAX_LEN + 2];
+	FILE *in, *out;
+	bool c;                   /* writing C rather than Grunt? */
+	size_t n;
+
+	if ((argc != 5) || (strcmp(argv[1], "c") &&
+		strcmp(argv[1], "gasm")) || !is_name(argv[2])) {
+		fprintf(stderr, "Usage:\n");
+		fprintf(stderr, "\tvsrules c PREFIX spec header.h : write "
+			"native validator PREFIX_rules_validate()\n");
+		fprintf(stderr, "\tvsrules gasm PREFIX spec source.gasm : "
+			"write Grunt validation program PREFIX\n");
+		return -1;
+	}
+	c = !strcmp(argv[1], "c");
+	spec.source = argv[3];
+
+	if (!(in = fopen(argv[3], "r"))) {
+		perror(argv[3]);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), in)) {
+		line_number++;
+		n = strlen(line);
+		if (n && (line[n - 1] == '\n')) {
+			line[--n] = '\0';
+		} else if (!feof(in)) {
+			error(line_number, "line too long");
+			break;
+		}
+		if (n && (line[n - 1] == '\r')) line[--n] = '\0';
+		parse_line(line);
+	}
+	fclose(in);
+	parse_directive();
+	check_spec();
+	if (error_count) {
+		fprintf(stderr, "%s: %d errors; %s not written\n", argv[3],
+			error_count, argv[4]);
+		return -1;
+	}
+
+	if (!(out = fopen(argv[4], "w"))) {
+		perror(argv[4]);
+		return -1;
+	}
+	if (c) {
+		emit_c(out, &spec, argv[2]);
+	} else {
+		emit_gasm(out, &spec, argv[2]);
+	}
+	fclose(out);
+	return 0;
+
+} /* main() */
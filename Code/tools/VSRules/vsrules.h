@@ -0,0 +1,130 @@
+#ifndef _VSRULES_H_
+#define _VSRULES_H_
+
+/* Copyright (c) 2024 Timothy Jon Fraser Consulting LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.  See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* These definitions describe a table validation rule spec after the
+ * vsrules parser has read it.  The parser fills in a vsr_spec_t; the
+ * C and Grunt emitters read it.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#define VSR_LINE_MAX_LEN   256    /* longest spec line */
+#define VSR_NAME_MAX_LEN   64     /* longest name or C constant */
+#define VSR_TEXT_MAX_LEN   128    /* longest event text */
+#define VSR_MAX_WORDS      16     /* most words in one directive */
+#define VSR_MAX_CLASSES    8
+#define VSR_MAX_PARMS      64
+#define VSR_MAX_WIDES      8
+#define VSR_MAX_RULES      32     /* per kind; a rule is a bit */
+#define VSR_MAX_PIECES     16     /* most pieces in one event text */
+
+/* The kinds of table entry, by parm ID. */
+typedef enum {
+	vk_unused,      /* the unused parm ID */
+	vk_inuse,       /* a parm ID of some class */
+	vk_invalid,     /* any other parm ID */
+	VSR_NUM_KINDS
+} vsr_kind_t;
+
+/* The conditions a rule can test. */
+typedef enum {
+	vc_always,
+	vc_nonzero,     /* any of the fields is nonzero */
+	vc_outside,     /* the field is outside its class's range */
+	vc_greater,     /* the first field is greater than the second */
+	vc_after_unused,
+	vc_redefines,
+} vsr_cond_t;
+
+/* The entry fields a condition can test. */
+typedef enum {
+	vf_pad,
+	vf_low,
+	vf_high,
+	VSR_NUM_FIELDS
+} vsr_field_t;
+
+typedef struct {
+	char name[VSR_NAME_MAX_LEN];
+	char min[VSR_NAME_MAX_LEN];
+	char max[VSR_NAME_MAX_LEN];
+} vsr_class_t;
+
+typedef struct {
+	char id[VSR_NAME_MAX_LEN];
+	char name[VSR_TEXT_MAX_LEN];
+	int  class;                     /* index into classes[] */
+} vsr_parm_t;
+
+typedef struct {
+	char id[VSR_NAME_MAX_LEN];      /* first wide parm ID of the run */
+	char name[VSR_TEXT_MAX_LEN];
+	int  class;
+} vsr_wide_t;
+
+typedef struct {
+	vsr_kind_t  kind;
+	char        eid[VSR_NAME_MAX_LEN];
+	vsr_cond_t  cond;
+	vsr_field_t fields[VSR_NUM_FIELDS];
+	int         num_fields;
+	char        text[VSR_TEXT_MAX_LEN];
+	int         line;               /* spec line number */
+} vsr_rule_t;
+
+typedef struct {
+	const char *source;             /* spec file name */
+	char unused_id[VSR_NAME_MAX_LEN];
+	char unused_name[VSR_TEXT_MAX_LEN];
+	char unknown_name[VSR_TEXT_MAX_LEN];
+	char summary_eid[VSR_NAME_MAX_LEN];
+	char summary_text[VSR_TEXT_MAX_LEN];
+	int num_classes;
+	int num_parms;
+	int num_wides;                  /* in increasing order of ID */
+	int num_rules;                  /* in event order */
+	vsr_class_t classes[VSR_MAX_CLASSES];
+	vsr_parm_t  parms[VSR_MAX_PARMS];
+	vsr_wide_t  wides[VSR_MAX_WIDES];
+	vsr_rule_t  rules[VSR_MAX_RULES * VSR_NUM_KINDS];
+} vsr_spec_t;
+
+/* One piece of an event text: either literal text or one of the
+ * placeholder letters N, P, V, I, or U.
+ */
+typedef struct {
+	char placeholder;               /* the letter, or '\0' if text */
+	char text[VSR_TEXT_MAX_LEN];
+} vsr_piece_t;
+
+/* Splits an event text into pieces; see vsrules.c. */
+int vsr_split(const char *, vsr_piece_t *);
+
+/* Native C generation; see emit_c.c. */
+void emit_c(FILE *, const vsr_spec_t *, const char *);
+
+/* Grunt assembly generation; see emit_gasm.c. */
+void emit_gasm(FILE *, const vsr_spec_t *, const char *);
+
+/* The license text both emitters copy into their output; the C
+ * emitter puts each line in a comment, the Grunt one after a ;.
+ */
+extern const char *vsr_license[];
+
+#endif